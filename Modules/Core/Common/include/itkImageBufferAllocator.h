@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferAllocator_h
+#define itkImageBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class ImageBufferAllocator
+ * \brief Allocates aligned raw memory for the pixel buffers of images.
+ *
+ * ImportImageContainer allocates its elements with new[] unless an
+ * allocator is set, either on the container itself with
+ * ImportImageContainer::SetAllocator() or for all containers created
+ * afterwards with SetGlobalDefaultAllocator(). This class returns memory
+ * aligned to GetAlignment() bytes (64 by default, the size of a cache line
+ * and of an AVX-512 register), so that vectorized kernels may assume aligned
+ * loads and stores at the start of a buffer.
+ *
+ * When UseHugePages is on, buffers of at least GetHugePageSize() bytes are
+ * aligned to the huge page size and, on Linux, advised to be backed by
+ * transparent huge pages, which reduces the number of page faults and TLB
+ * misses when a large buffer is first touched.
+ *
+ * Allocate() and Deallocate() are virtual so that other policies, such as
+ * the PooledImageBufferAllocator, can be plugged in.
+ *
+ * \sa PooledImageBufferAllocator
+ * \sa ImportImageContainer
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferAllocator : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = ImageBufferAllocator;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferAllocator, Object);
+
+  /** Return a block of at least numberOfBytes bytes, aligned to
+   * GetAlignment(). Throws a MemoryAllocationError on failure.
+   * This method is thread safe. */
+  virtual void * Allocate(SizeValueType numberOfBytes);
+
+  /** Give back a block returned by Allocate(). numberOfBytes must be the
+   * value which was passed to Allocate(). This method is thread safe. */
+  virtual void Deallocate(void * buffer, SizeValueType numberOfBytes);
+
+  /** Set/Get the alignment, in bytes, of the returned blocks. It is rounded
+   * up to a power of two which is at least the alignment of a pointer.
+   * Changing it only affects subsequent allocations. */
+  virtual void SetAlignment(SizeValueType alignment);
+  itkGetConstMacro(Alignment, SizeValueType);
+
+  /** Set/Get whether blocks of at least GetHugePageSize() bytes are aligned
+   * to huge page boundaries and advised to use transparent huge pages. */
+  virtual void SetUseHugePages(bool useHugePages);
+  itkGetConstMacro(UseHugePages, bool);
+  itkBooleanMacro(UseHugePages);
+
+  /** Set/Get the size of a huge page. Defaults to 2 MiB. */
+  virtual void SetHugePageSize(SizeValueType hugePageSize);
+  itkGetConstMacro(HugePageSize, SizeValueType);
+
+  /** Set/Get the allocator which is used by every ImportImageContainer
+   * created afterwards. nullptr, the default, means that containers
+   * allocate their elements with new[]. */
+  static void SetGlobalDefaultAllocator(Self * allocator);
+  static Pointer GetGlobalDefaultAllocator();
+
+protected:
+  ImageBufferAllocator() = default;
+  ~ImageBufferAllocator() override = default;
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The alignment which a block of the given size is allocated with. */
+  SizeValueType GetAlignmentForSize(SizeValueType numberOfBytes) const;
+
+  /** Allocate and release the memory from the operating system.
+   * Subclasses which cache blocks call these on a cache miss and when
+   * a block is evicted. */
+  void * AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment) const;
+  void DeallocateAligned(void * buffer) const;
+
+private:
+  SizeValueType m_Alignment{ 64 };
+  bool          m_UseHugePages{ false };
+  SizeValueType m_HugePageSize{ 2 * 1024 * 1024 };
+};
+} // end namespace itk
+
+#endif
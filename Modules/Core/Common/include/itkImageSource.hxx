@@ -32,6 +32,7 @@
 #include "itkOutputDataObjectIterator.h"
 #include "itkImageRegionSplitterBase.h"
 #include "itkMultiThreaderBase.h"
+#include "itkPipelineProfiler.h"
 
 #include "itkMath.h"
 
@@ -242,7 +243,11 @@ ImageSource< TOutputImage >
     this->GetMultiThreader()->template ParallelizeImageRegion<OutputImageDimension>(
         this->GetOutput()->GetRequestedRegion(),
         [this](const OutputImageRegionType & outputRegionForThread)
-          { this->DynamicThreadedGenerateData(outputRegionForThread); }, this);
+          {
+          const PipelineProfiler::ScopedEvent profilerEvent(
+            PipelineProfiler::BeginWorkUnit( this, outputRegionForThread.GetNumberOfPixels() ) );
+          this->DynamicThreadedGenerateData(outputRegionForThread);
+          }, this);
     }
 
   // Call a method that can be overridden by a subclass to perform
@@ -300,6 +305,8 @@ ImageSource< TOutputImage >
 
   if ( threadId < total )
     {
+    const PipelineProfiler::ScopedEvent profilerEvent(
+      PipelineProfiler::BeginWorkUnit( str->Filter, splitRegion.GetNumberOfPixels() ) );
     str->Filter->ThreadedGenerateData(splitRegion, threadId);
 #if defined( ITKV4_COMPATIBILITY )
     if ( str->Filter->GetAbortGenerateData() )
@@ -20,6 +20,7 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkImageBufferAllocator.h"
 #include <utility>
 
 namespace itk
@@ -36,6 +37,13 @@ namespace itk
  *
  * \tparam TElement The element type stored in the container.
  *
+ * The elements are allocated with new[], unless an ImageBufferAllocator is
+ * set with SetAllocator(). A container picks up
+ * ImageBufferAllocator::GetGlobalDefaultAllocator() when it is constructed,
+ * so setting a global default allocator, for example a
+ * PooledImageBufferAllocator, applies to the buffers of all images which
+ * are allocated afterwards.
+ *
  * \ingroup ImageObjects
  * \ingroup IOFilters
  * \ingroup ITKCommon
@@ -137,6 +145,26 @@ public:
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get the allocator of the elements. nullptr means new[]. Changing
+   * the allocator only affects subsequent allocations; the current buffer
+   * is released by the allocator it was obtained from. */
+  itkSetObjectMacro(Allocator, ImageBufferAllocator);
+  itkGetModifiableObjectMacro(Allocator, ImageBufferAllocator);
+
+  /** Take ownership of a buffer of num elements which was returned by
+   * allocator->Allocate( num * sizeof( TElement ) ). The buffer is given
+   * back to that allocator when the container releases its memory, whatever
+   * allocator is set with SetAllocator(). This is how a buffer from a
+   * special purpose allocator, such as a MemoryMappedFileAllocator, is
+   * imported. The elements are used as they are, not constructed. */
+  void ImportAllocatedBuffer(TElement *ptr, TElementIdentifier num, ImageBufferAllocator *allocator);
+
+  /** Get the allocator which the current buffer was obtained from, or
+   * nullptr when it was allocated with new[] or imported with
+   * SetImportPointer(). */
+  const ImageBufferAllocator * GetImportPointerAllocator() const
+  { return m_ImportPointerAllocator.GetPointer(); }
+
 protected:
   ImportImageContainer();
   ~ImportImageContainer() override;
@@ -178,10 +206,23 @@ protected:
   void SetImportPointer(TElement *ptr){ m_ImportPointer = ptr; }
 
 private:
+  /** Take ownership of a buffer returned by AllocateElements(). */
+  void AdoptAllocatedElements(TElement *ptr, TElementIdentifier num);
+
   TElement *         m_ImportPointer;
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  ImageBufferAllocator::Pointer m_Allocator;
+
+  /** The allocator which m_ImportPointer was obtained from, or nullptr when
+   * it was allocated with new[] or imported. */
+  ImageBufferAllocator::Pointer m_ImportPointerAllocator;
+
+  /** The allocator used by the last call to AllocateElements(), or nullptr
+   * when that call used new[] or was overridden by a subclass. */
+  mutable ImageBufferAllocator::Pointer m_AllocatedElementsAllocator;
 };
 } // end namespace itk
 
@@ -29,6 +29,8 @@
 #define itkImportImageContainer_hxx
 
 #include "itkImportImageContainer.h"
+#include "itkPipelineProfiler.h"
+#include <new>
 
 namespace itk
 {
@@ -40,6 +42,7 @@ ImportImageContainer< TElementIdentifier, TElement >
   m_ContainerManageMemory = true;
   m_Capacity = 0;
   m_Size = 0;
+  m_Allocator = ImageBufferAllocator::GetGlobalDefaultAllocator();
 }
 
 template< typename TElementIdentifier, typename TElement >
@@ -65,6 +68,7 @@ ImportImageContainer< TElementIdentifier, TElement >
     {
     if ( size > m_Capacity )
       {
+      m_AllocatedElementsAllocator = nullptr;
       TElement *temp = this->AllocateElements(size, UseDefaultConstructor);
       // only copy the portion of the data used in the old buffer
       std::copy(m_ImportPointer,
@@ -73,10 +77,7 @@ ImportImageContainer< TElementIdentifier, TElement >
 
       DeallocateManagedMemory();
 
-      m_ImportPointer = temp;
-      m_ContainerManageMemory = true;
-      m_Capacity = size;
-      m_Size = size;
+      this->AdoptAllocatedElements(temp, size);
       this->Modified();
       }
     else
@@ -87,10 +88,9 @@ ImportImageContainer< TElementIdentifier, TElement >
     }
   else
     {
-    m_ImportPointer = this->AllocateElements(size, UseDefaultConstructor);
-    m_Capacity = size;
-    m_Size = size;
-    m_ContainerManageMemory = true;
+    m_AllocatedElementsAllocator = nullptr;
+    TElement *temp = this->AllocateElements(size, UseDefaultConstructor);
+    this->AdoptAllocatedElements(temp, size);
     this->Modified();
     }
 }
@@ -109,6 +109,7 @@ ImportImageContainer< TElementIdentifier, TElement >
     if ( m_Size < m_Capacity )
       {
       const TElementIdentifier size = m_Size;
+      m_AllocatedElementsAllocator = nullptr;
       TElement *               temp = this->AllocateElements(size, false);
       std::copy(m_ImportPointer,
                 m_ImportPointer+m_Size,
@@ -116,10 +117,7 @@ ImportImageContainer< TElementIdentifier, TElement >
 
       DeallocateManagedMemory();
 
-      m_ImportPointer = temp;
-      m_ContainerManageMemory = true;
-      m_Capacity = size;
-      m_Size = size;
+      this->AdoptAllocatedElements(temp, size);
 
       this->Modified();
       }
@@ -161,6 +159,7 @@ ImportImageContainer< TElementIdentifier, TElement >
 {
   DeallocateManagedMemory();
   m_ImportPointer = ptr;
+  m_ImportPointerAllocator = nullptr;
   m_ContainerManageMemory = LetContainerManageMemory;
   m_Capacity = num;
   m_Size = num;
@@ -168,6 +167,21 @@ ImportImageContainer< TElementIdentifier, TElement >
   this->Modified();
 }
 
+template< typename TElementIdentifier, typename TElement >
+void
+ImportImageContainer< TElementIdentifier, TElement >
+::ImportAllocatedBuffer(TElement *ptr, TElementIdentifier num, ImageBufferAllocator *allocator)
+{
+  DeallocateManagedMemory();
+  m_ImportPointer = ptr;
+  m_ImportPointerAllocator = allocator;
+  m_ContainerManageMemory = true;
+  m_Capacity = num;
+  m_Size = num;
+
+  this->Modified();
+}
+
 template< typename TElementIdentifier, typename TElement >
 TElement *ImportImageContainer< TElementIdentifier, TElement >
 ::AllocateElements(ElementIdentifier size, bool UseDefaultConstructor ) const
@@ -175,6 +189,40 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
   // Encapsulate all image memory allocation here to throw an
   // exception when memory allocation fails even when the compiler
   // does not do this by default.
+  PipelineProfiler::RecordAllocation( size * sizeof( TElement ) );
+  if ( m_Allocator )
+    {
+    // The allocator provides raw memory, the elements are constructed in
+    // place. Default-initialization is a no-op for POD types.
+    auto * data = static_cast< TElement * >( m_Allocator->Allocate( size * sizeof( TElement ) ) );
+    ElementIdentifier constructed = 0;
+    try
+      {
+      for ( ; constructed < size; ++constructed )
+        {
+        if ( UseDefaultConstructor )
+          {
+          new ( data + constructed ) TElement(); //POD types initialized to 0
+          }
+        else
+          {
+          new ( data + constructed ) TElement; //Faster but uninitialized
+          }
+        }
+      }
+    catch ( ... )
+      {
+      for ( ElementIdentifier i = 0; i < constructed; ++i )
+        {
+        data[i].~TElement();
+        }
+      m_Allocator->Deallocate( data, size * sizeof( TElement ) );
+      throw;
+      }
+    m_AllocatedElementsAllocator = m_Allocator;
+    return data;
+    }
+
   TElement *data;
 
   try
@@ -210,13 +258,38 @@ void ImportImageContainer< TElementIdentifier, TElement >
   // Encapsulate all image memory deallocation here
   if ( m_ContainerManageMemory )
     {
-    delete[] m_ImportPointer;
+    if ( m_ImportPointerAllocator )
+      {
+      for ( ElementIdentifier i = 0; i < m_Capacity; ++i )
+        {
+        m_ImportPointer[i].~TElement();
+        }
+      m_ImportPointerAllocator->Deallocate( m_ImportPointer, m_Capacity * sizeof( TElement ) );
+      }
+    else
+      {
+      delete[] m_ImportPointer;
+      }
     }
   m_ImportPointer = nullptr;
+  m_ImportPointerAllocator = nullptr;
   m_Capacity = 0;
   m_Size = 0;
 }
 
+template< typename TElementIdentifier, typename TElement >
+void
+ImportImageContainer< TElementIdentifier, TElement >
+::AdoptAllocatedElements(TElement *ptr, TElementIdentifier num)
+{
+  m_ImportPointer = ptr;
+  m_ImportPointerAllocator = m_AllocatedElementsAllocator;
+  m_AllocatedElementsAllocator = nullptr;
+  m_ContainerManageMemory = true;
+  m_Capacity = num;
+  m_Size = num;
+}
+
 template< typename TElementIdentifier, typename TElement >
 void
 ImportImageContainer< TElementIdentifier, TElement >
@@ -229,6 +302,7 @@ ImportImageContainer< TElementIdentifier, TElement >
      << ( m_ContainerManageMemory ? "true" : "false" ) << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "Allocator: " << m_Allocator.GetPointer() << std::endl;
 }
 } // end namespace itk
 
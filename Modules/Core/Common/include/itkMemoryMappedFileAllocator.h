@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFileAllocator_h
+#define itkMemoryMappedFileAllocator_h
+
+#include "itkImageBufferAllocator.h"
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFileAllocator
+ * \brief Image buffer allocator which maps a range of a file into memory.
+ *
+ * Allocate(numberOfBytes) maps the bytes [GetFileOffset(),
+ * GetFileOffset() + numberOfBytes) of GetFileName() and returns the address
+ * of the first one; Deallocate() unmaps them. The pages are read from the
+ * file on first access, so a buffer handed to an ImportImageContainer with
+ * ImportImageContainer::ImportAllocatedBuffer() gives an image whose pixels
+ * are the file contents without reading or copying them up front.
+ *
+ * The mapping is private (copy-on-write): the buffer may be written to,
+ * for instance by an in-place filter, but the modified pages are copied
+ * and the file itself is never changed.
+ *
+ * The address returned by Allocate() has the alignment of the file offset
+ * within a page, which the caller must check against the alignment that
+ * the pixel type requires.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping()
+ * \sa ImageBufferAllocator
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT MemoryMappedFileAllocator : public ImageBufferAllocator
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(MemoryMappedFileAllocator);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedFileAllocator;
+  using Superclass = ImageBufferAllocator;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedFileAllocator, ImageBufferAllocator);
+
+  /** Map numberOfBytes bytes of the file, starting at GetFileOffset().
+   * Throws an ExceptionObject when the file cannot be opened or mapped,
+   * or is shorter than the requested range. Returns nullptr when
+   * numberOfBytes is zero. */
+  void * Allocate(SizeValueType numberOfBytes) override;
+
+  /** Unmap a buffer returned by Allocate(). */
+  void Deallocate(void * buffer, SizeValueType numberOfBytes) override;
+
+  /** Set/Get the name of the mapped file. */
+  itkSetStringMacro(FileName);
+  itkGetStringMacro(FileName);
+
+  /** Set/Get the position in the file of the first mapped byte. */
+  itkSetMacro(FileOffset, SizeValueType);
+  itkGetConstMacro(FileOffset, SizeValueType);
+
+protected:
+  MemoryMappedFileAllocator() = default;
+  ~MemoryMappedFileAllocator() override = default;
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The granularity which the file offset of a mapping must be a
+   * multiple of: the page size, or the allocation granularity on Windows. */
+  static SizeValueType GetMappingGranularity();
+
+  std::string   m_FileName;
+  SizeValueType m_FileOffset{ 0 };
+};
+} // end namespace itk
+
+#endif
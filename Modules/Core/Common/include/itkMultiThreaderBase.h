@@ -105,7 +105,7 @@ public:
 
   /** Currently supported types of multi-threader implementations.
    * Last will change with additional implementations. */
-  enum ThreaderType { Platform = 0, First = Platform, Pool, TBB, Last = TBB, Unknown = -1 };
+  enum ThreaderType { Platform = 0, First = Platform, Pool, TBB, WorkStealing, Last = WorkStealing, Unknown = -1 };
 
   /** Convert a threader name into its enum type. */
   static ThreaderType ThreaderTypeFromString(std::string threaderString);
@@ -124,6 +124,9 @@ public:
       case ThreaderType::TBB:
         return "TBB";
         break;
+      case ThreaderType::WorkStealing:
+        return "WorkStealing";
+        break;
       case ThreaderType::Unknown:
       default:
         return "Unknown";
@@ -135,6 +138,8 @@ public:
    *
    * The default multi-threader type is picked up from ITK_GLOBAL_DEFAULT_THREADER
    * environment variable. Example ITK_GLOBAL_DEFAULT_THREADER=TBB
+   * WorkStealing uses per-worker task queues and scales better than Pool
+   * on machines with many cores, without requiring TBB.
    * A deprecated ITK_USE_THREADPOOL environment variable is also examined,
    * but it can only choose Pool or Platform multi-threader.
    * Platform multi-threader should be avoided,
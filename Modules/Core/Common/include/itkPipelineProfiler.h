@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPipelineProfiler_h
+#define itkPipelineProfiler_h
+
+#include "itkObject.h"
+
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace itk
+{
+class ProcessObject;
+
+/** \class PipelineProfiler
+ * \brief Records where the execution time of a pipeline is spent.
+ *
+ * When enabled with PipelineProfiler::SetEnabled(true), the pipeline
+ * records an event for:
+ *
+ * - every call to ProcessObject::GenerateData() made by UpdateOutputData(),
+ *   with its wall time, the number of bytes allocated for image buffers
+ *   while it ran, and the utilization of the threads of its multithreader;
+ * - every work unit (the region given to one call of
+ *   DynamicThreadedGenerateData() or ThreadedGenerateData()) of an
+ *   ImageSource, with its thread and number of pixels;
+ * - every piece requested by a StreamingImageFilter.
+ *
+ * Filters upstream of a streaming filter show one GenerateData event per
+ * piece. The events are collected by a single instance, and can be
+ * written as a Chrome trace (viewable in chrome://tracing or Perfetto) with
+ * WriteChromeTrace(), or summarized per filter with WriteJSON().
+ *
+ * Recording is off by default; when it is off the pipeline only tests a
+ * flag per GenerateData() and per work unit.
+ *
+ * \code
+ * itk::PipelineProfiler::SetEnabled(true);
+ * writer->Update();
+ * std::ofstream trace("pipeline.json");
+ * itk::PipelineProfiler::GetInstance()->WriteChromeTrace(trace);
+ * \endcode
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineProfiler:public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(PipelineProfiler);
+
+  /** Standard class type aliases. */
+  using Self = PipelineProfiler;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PipelineProfiler, Object);
+
+  /** This is a singleton pattern New. There will only be ONE
+   * reference to a PipelineProfiler object per process. */
+  static Pointer New();
+
+  /** Return the instance which records the events of the pipeline. */
+  static Pointer GetInstance();
+
+  /** Supply a user defined profiler. */
+  static void SetInstance(PipelineProfiler *instance);
+
+  /** Set/Get whether the pipeline records events. Off by default. */
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+  static void EnabledOn() { SetEnabled(true); }
+  static void EnabledOff() { SetEnabled(false); }
+
+  /** Kind of a recorded event. */
+  enum class EventCategory : uint8_t { GenerateData, WorkUnit, StreamingPiece };
+
+  /** A recorded event. Times are in microseconds since the creation of
+   * the profiler or the last call to Clear(). */
+  struct Event
+  {
+    EventCategory Category{ EventCategory::GenerateData };
+    /** Class name of the filter, followed by its object name if set. */
+    std::string   Name;
+    const void *  Source{ nullptr };
+    /** Small integer identifying the thread which ran the event. */
+    unsigned int  Thread{ 0 };
+    double        Start{ 0.0 };
+    double        Duration{ 0.0 };
+    /** GenerateData: bytes allocated for image buffers. */
+    SizeValueType BytesAllocated{ 0 };
+    /** WorkUnit and StreamingPiece: number of pixels of the region. */
+    SizeValueType NumberOfPixels{ 0 };
+    /** StreamingPiece: index of the piece. */
+    SizeValueType Piece{ 0 };
+    /** GenerateData: number of work units, their total duration, and the
+     * maximum number of threads of the multithreader of the filter. */
+    SizeValueType NumberOfWorkUnits{ 0 };
+    double        WorkUnitsDuration{ 0.0 };
+    unsigned int  NumberOfThreads{ 0 };
+    bool          Open{ true };
+  };
+  using EventListType = std::vector< Event >;
+
+  /** Identifier of an event returned by the Begin methods. */
+  using EventIdentifier = SizeValueType;
+  static constexpr EventIdentifier InvalidEvent = std::numeric_limits< EventIdentifier >::max();
+
+  /** Called by the pipeline. These do nothing and return InvalidEvent
+   * when recording is off. */
+  static EventIdentifier BeginGenerateData(const ProcessObject *filter);
+  static EventIdentifier BeginWorkUnit(const ProcessObject *filter, SizeValueType numberOfPixels);
+  static EventIdentifier BeginStreamingPiece(const ProcessObject *filter, SizeValueType piece,
+                                             SizeValueType numberOfPixels);
+  static void EndEvent(EventIdentifier event);
+
+  /** Called when an image buffer is allocated. The bytes are attributed
+   * to the innermost GenerateData event open on the calling thread. */
+  static void RecordAllocation(SizeValueType numberOfBytes);
+
+  /** Ends an event when it goes out of scope. */
+  class ScopedEvent
+  {
+  public:
+    explicit ScopedEvent(EventIdentifier event) : m_Event(event) {}
+    ~ScopedEvent() { PipelineProfiler::EndEvent(m_Event); }
+    ScopedEvent(const ScopedEvent &) = delete;
+    ScopedEvent & operator=(const ScopedEvent &) = delete;
+  private:
+    EventIdentifier m_Event;
+  };
+
+  /** Return a copy of the recorded events. */
+  EventListType GetEvents() const;
+
+  /** Remove the recorded events and restart the clock. Must not be called
+   * while a pipeline is updating. */
+  void Clear();
+
+  /** Write the events in the Chrome trace event format. */
+  void WriteChromeTrace(std::ostream & os) const;
+
+  /** Write a JSON summary of the GenerateData events per filter, sorted
+   * by decreasing total time: number of executions, total, minimum and
+   * maximum time in seconds, bytes allocated, number of work units,
+   * thread utilization and number of streaming pieces. */
+  void WriteJSON(std::ostream & os) const;
+
+protected:
+  PipelineProfiler();
+  ~PipelineProfiler() override = default;
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  using ClockType = std::chrono::steady_clock;
+
+  double Now() const;
+
+  EventIdentifier Begin(Event && event);
+  void End(EventIdentifier event);
+
+  mutable std::mutex m_Mutex;
+  ClockType::time_point m_Epoch;
+  EventListType m_Events;
+  /** Open GenerateData event of each filter, for its work units. */
+  std::unordered_map< const void *, EventIdentifier > m_OpenGenerateData;
+
+  static Pointer m_Instance;
+};
+} // end namespace itk
+
+#endif
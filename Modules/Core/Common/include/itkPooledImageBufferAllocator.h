@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPooledImageBufferAllocator_h
+#define itkPooledImageBufferAllocator_h
+
+#include "itkImageBufferAllocator.h"
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+/** \class PooledImageBufferAllocator
+ * \brief Image buffer allocator which keeps released buffers for reuse.
+ *
+ * Blocks are grouped into size buckets: a request is rounded up to the
+ * next of four evenly spaced sizes between two consecutive powers of two,
+ * so at most 25% of a block is unused. When a block is deallocated it is
+ * kept in the free list of its bucket instead of being returned to the
+ * operating system, and the next request which falls into the same bucket
+ * reuses it. A pipeline which is run repeatedly on images of the same size
+ * therefore allocates its buffers once, and does not pay the page faults
+ * of touching fresh memory again on each run.
+ *
+ * Buffers come back to the pool when their ImportImageContainer releases
+ * its memory, which for pipeline outputs happens on
+ * DataObject::ReleaseData(), i.e. when ReleaseDataFlag is on.
+ *
+ * At most GetMaximumNumberOfCachedBytes() bytes are kept; blocks which
+ * would exceed that limit are freed immediately. To make an instance the
+ * process-wide pool, pass it to
+ * ImageBufferAllocator::SetGlobalDefaultAllocator().
+ *
+ * \sa ImageBufferAllocator
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PooledImageBufferAllocator : public ImageBufferAllocator
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(PooledImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = PooledImageBufferAllocator;
+  using Superclass = ImageBufferAllocator;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PooledImageBufferAllocator, ImageBufferAllocator);
+
+  /** Return a cached block of the matching bucket if there is one,
+   * otherwise allocate a new block of the bucket size. */
+  void * Allocate(SizeValueType numberOfBytes) override;
+
+  /** Keep the block for reuse, unless the cache is full. */
+  void Deallocate(void * buffer, SizeValueType numberOfBytes) override;
+
+  /** Changing the alignment releases the cached blocks, which may not
+   * satisfy the new alignment. */
+  void SetAlignment(SizeValueType alignment) override;
+
+  /** Changing the huge page settings releases the cached blocks, which
+   * were aligned and advised for the previous settings. */
+  void SetUseHugePages(bool useHugePages) override;
+  void SetHugePageSize(SizeValueType hugePageSize) override;
+
+  /** Set/Get the maximum number of bytes kept in the free lists. Lowering
+   * it releases cached blocks until the new limit is satisfied.
+   * Defaults to 1 GiB. */
+  void SetMaximumNumberOfCachedBytes(SizeValueType numberOfBytes);
+  SizeValueType GetMaximumNumberOfCachedBytes() const;
+
+  /** Number of bytes currently kept in the free lists. */
+  SizeValueType GetNumberOfCachedBytes() const;
+
+  /** Number of requests which were served from, respectively missed, the
+   * free lists since construction or the last ResetStatistics(). */
+  SizeValueType GetNumberOfCacheHits() const;
+  SizeValueType GetNumberOfCacheMisses() const;
+  void ResetStatistics();
+
+  /** Free all cached blocks. Blocks which are in use are not affected. */
+  void ReleaseCachedBuffers();
+
+  /** The size of the bucket into which a request of numberOfBytes falls. */
+  static SizeValueType GetBucketSize(SizeValueType numberOfBytes);
+
+protected:
+  PooledImageBufferAllocator() = default;
+  ~PooledImageBufferAllocator() override;
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Free blocks until at most maximumNumberOfBytes bytes remain cached,
+   * largest buckets first. Must be called with m_Mutex locked. */
+  void EvictCachedBuffers(SizeValueType maximumNumberOfBytes);
+
+  using FreeListMapType = std::map< SizeValueType, std::vector< void * > >;
+
+  mutable std::mutex m_Mutex;
+  FreeListMapType    m_FreeLists;
+  SizeValueType      m_NumberOfCachedBytes{ 0 };
+  SizeValueType      m_MaximumNumberOfCachedBytes{ SizeValueType( 1 ) << 30 };
+  SizeValueType      m_NumberOfCacheHits{ 0 };
+  SizeValueType      m_NumberOfCacheMisses{ 0 };
+};
+} // end namespace itk
+
+#endif
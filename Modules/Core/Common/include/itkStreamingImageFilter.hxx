@@ -20,6 +20,7 @@
 #include "itkStreamingImageFilter.h"
 #include "itkCommand.h"
 #include "itkImageAlgorithm.h"
+#include "itkPipelineProfiler.h"
 #include "itkImageRegionSplitterSlowDimension.h"
 
 namespace itk
@@ -183,6 +184,9 @@ StreamingImageFilter< TInputImage, TOutputImage >
     InputImageRegionType streamRegion = outputRegion;
     m_RegionSplitter->GetSplit(piece, numDivisions, streamRegion);
 
+    const PipelineProfiler::ScopedEvent profilerEvent(
+      PipelineProfiler::BeginStreamingPiece( this, piece, streamRegion.GetNumberOfPixels() ) );
+
     inputPtr->SetRequestedRegion(streamRegion);
     inputPtr->PropagateRequestedRegion();
     inputPtr->UpdateOutputData();
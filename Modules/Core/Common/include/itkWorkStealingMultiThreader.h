@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingMultiThreader_h
+#define itkWorkStealingMultiThreader_h
+
+#include "itkMultiThreaderBase.h"
+#include "itkWorkStealingThreadPool.h"
+
+namespace itk
+{
+/** \class WorkStealingMultiThreader
+ * \brief A class for performing multithreaded execution with a
+ * work-stealing thread pool back end
+ *
+ * This multi-threader has the same interface and splitting behavior as the
+ * PoolMultiThreader, but it dispatches work units to a
+ * WorkStealingThreadPool. Every worker of that pool has its own task
+ * queue, so many cores do not contend on a single lock, and the threads
+ * waiting for their work units help executing pending ones. It is
+ * therefore safe to call ParallelizeImageRegion or ParallelizeArray from
+ * within a functor which is itself executed by this multi-threader.
+ *
+ * Select it with
+ * MultiThreaderBase::SetGlobalDefaultThreader(MultiThreaderBase::WorkStealing)
+ * or with the environment variable ITK_GLOBAL_DEFAULT_THREADER=WorkStealing.
+ *
+ * \ingroup OSSystemObjects
+ *
+ * \ingroup ITKCommon
+ */
+
+class ITKCommon_EXPORT WorkStealingMultiThreader : public MultiThreaderBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(WorkStealingMultiThreader);
+
+  /** Standard class type aliases. */
+  using Self = WorkStealingMultiThreader;
+  using Superclass = MultiThreaderBase;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingMultiThreader, MultiThreaderBase);
+
+
+  /** Execute the SingleMethod (as define by SetSingleMethod) using
+   * m_NumberOfWorkUnits work units. As a side effect the m_NumberOfWorkUnits will be
+   * checked against the current m_GlobalMaximumNumberOfThreads and clamped if
+   * necessary. */
+  void SingleMethodExecute() override;
+
+  /** Set the SingleMethod to f() and the UserData field of the
+   * WorkUnitInfo that is passed to it will be data.
+   * This method must be of type itkThreadFunctionType and
+   * must take a single argument of type void. */
+  void SetSingleMethod(ThreadFunctionType, void *data) override;
+
+  /** Parallelize an operation over an array. If filter argument is not nullptr,
+   * this function will update its progress as each index is completed. */
+  void
+  ParallelizeArray(
+    SizeValueType firstIndex,
+    SizeValueType lastIndexPlus1,
+    ArrayThreadingFunctorType aFunc,
+    ProcessObject* filter ) override;
+
+  /** Break up region into smaller chunks, and call the function with chunks as parameters. */
+  void
+  ParallelizeImageRegion(
+    unsigned int dimension,
+    const IndexValueType index[],
+    const SizeValueType size[],
+    ThreadingFunctorType funcP,
+    ProcessObject* filter) override;
+
+  /** Set the number of threads to use. WorkStealingMultiThreader
+   * can only INCREASE its number of threads. */
+  void SetMaximumNumberOfThreads( ThreadIdType numberOfThreads ) override;
+
+  struct ThreadPoolInfoStruct :WorkUnitInfo
+    {
+    std::future< ITK_THREAD_RETURN_TYPE > Future;
+    };
+
+protected:
+  WorkStealingMultiThreader();
+  ~WorkStealingMultiThreader() override;
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  // Thread pool instance and factory
+  WorkStealingThreadPool::Pointer m_ThreadPool;
+
+  /** An array of work unit information containing a work unit id
+   *  (0, 1, 2, .. ITK_MAX_THREADS-1), work unit count, and a pointer
+   *  to void so that user data can be passed to each thread. */
+  ThreadPoolInfoStruct m_ThreadInfoArray[ITK_MAX_THREADS];
+
+  /** Friends of Multithreader.
+   * ProcessObject is a friend so that it can call PrintSelf() on its
+   * Multithreader. */
+  friend class ProcessObject;
+};
+
+}  // end namespace itk
+#endif
@@ -0,0 +1,210 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkConfigure.h"
+#include "itkIntTypes.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+namespace itk
+{
+
+/**
+ * \class WorkStealingThreadPool
+ * \brief Thread pool in which every worker owns its own task queue.
+ *
+ * Unlike ThreadPool, which feeds all of its workers from one shared queue
+ * guarded by a single mutex, each worker of this pool has a private double
+ * ended queue. A worker pushes and pops tasks at the back of its own queue
+ * (LIFO, which keeps recently produced data in cache) and, when its queue is
+ * empty, steals from the front of another worker's queue (FIFO, which
+ * takes the oldest and usually biggest pieces of work). Tasks submitted
+ * from threads which do not belong to the pool are distributed round-robin
+ * over the worker queues, so the submitting threads do not all contend on
+ * the same lock.
+ *
+ * A thread which waits for the result of a task should use WaitFor()
+ * instead of blocking on the future directly. WaitFor() executes pending
+ * tasks while the awaited one is not finished, so a task can submit nested
+ * parallel work to the same pool and wait for it without deadlocking, even
+ * when every worker is busy.
+ *
+ * The pool is a process-wide singleton which is used by the
+ * WorkStealingMultiThreader.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT WorkStealingThreadPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+
+  /** Standard class type aliases. */
+  using Self = WorkStealingThreadPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingThreadPool, Object);
+
+  /** Returns the global instance */
+  static Pointer New();
+
+  /** Returns the global singleton instance of the WorkStealingThreadPool */
+  static Pointer GetInstance();
+
+  /** Add this job to the thread pool.
+   *
+   * When called from one of the pool's workers, the job is pushed to the
+   * queue of that worker. Otherwise it is pushed to the queues in a
+   * round-robin fashion. This method returns an std::future; use WaitFor()
+   * to wait for it from within a job which runs on the pool. */
+  template< class Function, class... Arguments >
+  auto
+  AddWork( Function&& function, Arguments&&... arguments )
+    -> std::future< typename std::result_of< Function( Arguments... ) >::type >
+  {
+    using return_type = typename std::result_of< Function( Arguments... ) >::type;
+
+    auto task = std::make_shared< std::packaged_task< return_type() > >(
+      std::bind( std::forward< Function >( function ), std::forward< Arguments >( arguments )... ) );
+
+    std::future< return_type > res = task->get_future();
+    this->PushTask( [task]() { ( *task )(); } );
+    return res;
+  }
+
+  /** Block until the future is ready. While waiting, the calling thread
+   * executes pending tasks of the pool, which makes nested parallelism safe.
+   * The result is not retrieved, so exceptions are only propagated by the
+   * subsequent call to future.get(). */
+  template< typename TResult >
+  void
+  WaitFor( std::future< TResult > & future )
+  {
+    while ( future.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+      {
+      if ( !this->RunPendingTask() )
+        {
+        future.wait_for( std::chrono::microseconds( 50 ) );
+        }
+      }
+  }
+
+  /** Execute at most one pending task on the calling thread: one of its own
+   * queue when called from a worker, otherwise a stolen one.
+   * Returns whether a task was executed. */
+  bool RunPendingTask();
+
+  /** Can call this method if we want to add extra threads to the pool.
+   * The pool never grows beyond ITK_MAX_THREADS workers. */
+  void AddThreads(ThreadIdType count);
+
+  ThreadIdType GetMaximumNumberOfThreads() const
+  {
+    return m_NumberOfWorkers.load();
+  }
+
+  /** The approximate number of idle threads. */
+  int GetNumberOfCurrentlyIdleThreads() const;
+
+  /** Whether the calling thread is one of the workers of this pool. */
+  static bool IsWorkerThread();
+
+protected:
+  WorkStealingThreadPool();
+  ~WorkStealingThreadPool() override;
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  using TaskType = std::function< void() >;
+
+  /** The task queue owned by a single worker. The owner works at the back,
+   * thieves take from the front. */
+  struct WorkerQueue
+  {
+    std::mutex             m_Mutex;
+    std::deque< TaskType > m_Tasks;
+  };
+
+  /** Enqueue a task and wake up a sleeping worker, if any. */
+  void PushTask(TaskType && task);
+
+  /** Pop from the back of the given queue. */
+  bool PopTask(ThreadIdType queueIndex, TaskType & task);
+
+  /** Steal from the front of any queue, starting after the given one. */
+  bool StealTask(ThreadIdType thiefIndex, TaskType & task);
+
+  /** The continuously running thread function */
+  void ThreadExecute(ThreadIdType workerIndex);
+
+  /** One queue per potential worker, allocated once so that growing the pool
+   * never moves a queue which another thread may be accessing. */
+  std::unique_ptr< WorkerQueue[] > m_Queues;
+
+  /** Vector to hold all thread handles.
+   * Thread handles are used to delete (join) the threads. */
+  std::vector< std::thread > m_Threads;
+
+  std::atomic< ThreadIdType > m_NumberOfWorkers{ 0 };
+
+  /** Number of tasks which were pushed but not yet popped. Workers only go
+   * to sleep when this is zero. */
+  std::atomic< SizeValueType > m_NumberOfPendingTasks{ 0 };
+
+  /** Number of workers which are currently executing a task. */
+  std::atomic< int > m_NumberOfBusyWorkers{ 0 };
+
+  /** Round-robin cursor for tasks submitted from outside of the pool. */
+  std::atomic< ThreadIdType > m_NextQueue{ 0 };
+
+  /** Number of workers which wait, or are about to wait, on m_Condition.
+   * Submitting a task only takes m_SleepMutex when it is not zero. */
+  std::atomic< int > m_NumberOfSleepingWorkers{ 0 };
+
+  /** Idle workers wait on m_Condition. m_SleepMutex only protects the
+   * transition to sleep, never the task queues. */
+  std::mutex              m_SleepMutex;
+  std::condition_variable m_Condition;
+
+  /** Protects m_Threads while the pool grows. */
+  std::mutex m_ThreadsMutex;
+
+  /* Has destruction started? */
+  std::atomic< bool > m_Stopping{ false };
+};
+
+}
+#endif
@@ -0,0 +1,184 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocator.h"
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+std::mutex                         globalDefaultAllocatorLock;
+itk::ImageBufferAllocator::Pointer globalDefaultAllocator;
+
+itk::SizeValueType RoundUpToPowerOfTwo(itk::SizeValueType value)
+{
+  itk::SizeValueType result = 1;
+  while ( result < value )
+    {
+    result <<= 1;
+    }
+  return result;
+}
+}// end of anonymous namespace
+
+namespace itk
+{
+
+void
+ImageBufferAllocator
+::SetGlobalDefaultAllocator(Self * allocator)
+{
+  std::lock_guard< std::mutex > lock( globalDefaultAllocatorLock );
+  globalDefaultAllocator = allocator;
+}
+
+ImageBufferAllocator::Pointer
+ImageBufferAllocator
+::GetGlobalDefaultAllocator()
+{
+  std::lock_guard< std::mutex > lock( globalDefaultAllocatorLock );
+  return globalDefaultAllocator;
+}
+
+void
+ImageBufferAllocator
+::SetAlignment(SizeValueType alignment)
+{
+  const SizeValueType clampedAlignment =
+    RoundUpToPowerOfTwo( std::max< SizeValueType >( alignment, sizeof( void * ) ) );
+  if ( m_Alignment != clampedAlignment )
+    {
+    m_Alignment = clampedAlignment;
+    this->Modified();
+    }
+}
+
+void
+ImageBufferAllocator
+::SetUseHugePages(bool useHugePages)
+{
+  if ( m_UseHugePages != useHugePages )
+    {
+    m_UseHugePages = useHugePages;
+    this->Modified();
+    }
+}
+
+void
+ImageBufferAllocator
+::SetHugePageSize(SizeValueType hugePageSize)
+{
+  if ( m_HugePageSize != hugePageSize )
+    {
+    m_HugePageSize = hugePageSize;
+    this->Modified();
+    }
+}
+
+SizeValueType
+ImageBufferAllocator
+::GetAlignmentForSize(SizeValueType numberOfBytes) const
+{
+  if ( m_UseHugePages && numberOfBytes >= m_HugePageSize )
+    {
+    return std::max( m_Alignment, RoundUpToPowerOfTwo( m_HugePageSize ) );
+    }
+  return m_Alignment;
+}
+
+void *
+ImageBufferAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  return this->AllocateAligned( numberOfBytes, this->GetAlignmentForSize( numberOfBytes ) );
+}
+
+void
+ImageBufferAllocator
+::Deallocate(void * buffer, SizeValueType itkNotUsed(numberOfBytes))
+{
+  this->DeallocateAligned( buffer );
+}
+
+void *
+ImageBufferAllocator
+::AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment) const
+{
+  // The block returned by malloc is over-allocated so that an aligned
+  // address can be found in it, and the original address is stored in
+  // the pointer-sized slot just before the aligned one.
+  void * unaligned = nullptr;
+  if ( numberOfBytes <= NumericTraits< SizeValueType >::max() - alignment - sizeof( void * ) )
+    {
+    unaligned = std::malloc( numberOfBytes + alignment + sizeof( void * ) );
+    }
+  if ( !unaligned )
+    {
+    // We cannot construct an error string here because we may be out
+    // of memory.  Do not use the exception macro.
+    throw MemoryAllocationError(__FILE__, __LINE__,
+                                "Failed to allocate memory for image.",
+                                ITK_LOCATION);
+    }
+
+  const std::uintptr_t first = reinterpret_cast< std::uintptr_t >( unaligned ) + sizeof( void * );
+  const std::uintptr_t aligned = ( first + alignment - 1 ) & ~( static_cast< std::uintptr_t >( alignment ) - 1 );
+  void * buffer = reinterpret_cast< void * >( aligned );
+  reinterpret_cast< void ** >( buffer )[-1] = unaligned;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if ( m_UseHugePages && numberOfBytes >= m_HugePageSize )
+    {
+    // Only whole huge pages inside the block can be advised.
+    const SizeValueType length = numberOfBytes - numberOfBytes % m_HugePageSize;
+    madvise( buffer, length, MADV_HUGEPAGE ); // failure only means no huge pages
+    }
+#endif
+
+  return buffer;
+}
+
+void
+ImageBufferAllocator
+::DeallocateAligned(void * buffer) const
+{
+  if ( buffer )
+    {
+    std::free( reinterpret_cast< void ** >( buffer )[-1] );
+    }
+}
+
+void
+ImageBufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Alignment: " << m_Alignment << std::endl;
+  os << indent << "UseHugePages: " << ( m_UseHugePages ? "On" : "Off" ) << std::endl;
+  os << indent << "HugePageSize: " << m_HugePageSize << std::endl;
+}
+
+} // end namespace itk
@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFileAllocator.h"
+
+#include <cstdint>
+
+#if defined(_WIN32)
+#include "itkWindows.h"
+#include "itksys/Encoding.hxx"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace itk
+{
+
+SizeValueType
+MemoryMappedFileAllocator
+::GetMappingGranularity()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo( &systemInfo );
+  return static_cast< SizeValueType >( systemInfo.dwAllocationGranularity );
+#else
+  return static_cast< SizeValueType >( sysconf( _SC_PAGESIZE ) );
+#endif
+}
+
+void *
+MemoryMappedFileAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  if ( numberOfBytes == 0 )
+    {
+    return nullptr;
+    }
+
+  // The mapping starts at the granularity boundary below the offset, and
+  // the returned address points into it.
+  const SizeValueType delta = m_FileOffset % GetMappingGranularity();
+  const SizeValueType mappedOffset = m_FileOffset - delta;
+  const SizeValueType mappedLength = numberOfBytes + delta;
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileW( itksys::Encoding::ToWide( m_FileName ).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    itkExceptionMacro("Cannot open " << m_FileName << " for mapping");
+    }
+  LARGE_INTEGER fileLength;
+  if ( !GetFileSizeEx( file, &fileLength )
+       || static_cast< SizeValueType >( fileLength.QuadPart ) < m_FileOffset + numberOfBytes )
+    {
+    CloseHandle( file );
+    itkExceptionMacro("File " << m_FileName << " is shorter than the "
+                      << numberOfBytes << " bytes to map at offset " << m_FileOffset);
+    }
+  HANDLE mapping = CreateFileMappingW( file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+  CloseHandle( file );
+  if ( mapping == nullptr )
+    {
+    itkExceptionMacro("Cannot create a mapping of " << m_FileName);
+    }
+  const auto offset = static_cast< std::uint64_t >( mappedOffset );
+  void * base = MapViewOfFile( mapping, FILE_MAP_COPY, static_cast< DWORD >( offset >> 32 ),
+                               static_cast< DWORD >( offset & 0xFFFFFFFF ), static_cast< SIZE_T >( mappedLength ) );
+  // The view keeps the mapping object alive.
+  CloseHandle( mapping );
+  if ( base == nullptr )
+    {
+    itkExceptionMacro("Cannot map " << numberOfBytes << " bytes of " << m_FileName
+                      << " at offset " << m_FileOffset);
+    }
+#else
+  const int file = open( m_FileName.c_str(), O_RDONLY );
+  if ( file < 0 )
+    {
+    itkExceptionMacro("Cannot open " << m_FileName << " for mapping");
+    }
+  struct stat fileStatus;
+  if ( fstat( file, &fileStatus ) != 0
+       || static_cast< SizeValueType >( fileStatus.st_size ) < m_FileOffset + numberOfBytes )
+    {
+    close( file );
+    itkExceptionMacro("File " << m_FileName << " is shorter than the "
+                      << numberOfBytes << " bytes to map at offset " << m_FileOffset);
+    }
+  void * base = mmap( nullptr, static_cast< size_t >( mappedLength ), PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      file, static_cast< off_t >( mappedOffset ) );
+  // The mapping keeps a reference to the file.
+  close( file );
+  if ( base == MAP_FAILED )
+    {
+    itkExceptionMacro("Cannot map " << numberOfBytes << " bytes of " << m_FileName
+                      << " at offset " << m_FileOffset);
+    }
+#endif
+
+  return static_cast< char * >( base ) + delta;
+}
+
+void
+MemoryMappedFileAllocator
+::Deallocate(void * buffer, SizeValueType numberOfBytes)
+{
+  if ( !buffer )
+    {
+    return;
+    }
+
+  const SizeValueType  granularity = GetMappingGranularity();
+  const std::uintptr_t address = reinterpret_cast< std::uintptr_t >( buffer );
+  const std::uintptr_t base = address & ~( static_cast< std::uintptr_t >( granularity ) - 1 );
+
+#if defined(_WIN32)
+  (void)numberOfBytes;
+  UnmapViewOfFile( reinterpret_cast< void * >( base ) );
+#else
+  munmap( reinterpret_cast< void * >( base ), static_cast< size_t >( numberOfBytes + ( address - base ) ) );
+#endif
+}
+
+void
+MemoryMappedFileAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "FileOffset: " << m_FileOffset << std::endl;
+}
+
+} // end namespace itk
@@ -30,6 +30,7 @@
 #if defined( ITK_USE_PTHREADS ) || defined( ITK_USE_WIN32_THREADS )
 #define POOL_MULTI_THREADER_AVAILABLE 1
 #include "itkPoolMultiThreader.h"
+#include "itkWorkStealingMultiThreader.h"
 #endif
 #include "itkNumericTraits.h"
 #include <mutex>
@@ -291,6 +292,10 @@ MultiThreaderBase
     {
     return ThreaderType::TBB;
     }
+  else if (threaderString == "WORKSTEALING")
+    {
+    return ThreaderType::WorkStealing;
+    }
   else
     {
     return ThreaderType::Unknown;
@@ -523,6 +528,12 @@ MultiThreaderBase::Pointer MultiThreaderBase::New()
         return TBBMultiThreader::New();
 #else
         itkGenericExceptionMacro("ITK has been built without TBB support!");
+#endif
+      case ThreaderType::WorkStealing:
+#if defined(POOL_MULTI_THREADER_AVAILABLE)
+        return WorkStealingMultiThreader::New();
+#else
+        itkGenericExceptionMacro("ITK has been built without WorkStealingMultiThreader support!");
 #endif
       default:
         itkGenericExceptionMacro("MultiThreaderBase::GetGlobalDefaultThreader returned Unknown!");
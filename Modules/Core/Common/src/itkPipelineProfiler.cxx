@@ -0,0 +1,464 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineProfiler.h"
+#include "itkProcessObject.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <map>
+
+namespace itk
+{
+namespace
+{
+std::atomic< bool > profilerEnabled( false );
+std::mutex          profilerInstanceMutex;
+std::atomic< unsigned int > profilerThreadCount( 0 );
+
+/** Small integer identifying the calling thread. */
+unsigned int
+GetProfilerThreadNumber()
+{
+  thread_local unsigned int threadNumber = profilerThreadCount++;
+  return threadNumber;
+}
+
+/** GenerateData events open on the calling thread, innermost last. */
+std::vector< PipelineProfiler::EventIdentifier > &
+GetOpenGenerateDataStack()
+{
+  thread_local std::vector< PipelineProfiler::EventIdentifier > stack;
+  return stack;
+}
+
+std::string
+GetFilterName(const ProcessObject *filter)
+{
+  std::string name = filter->GetNameOfClass();
+  if ( !filter->GetObjectName().empty() )
+    {
+    name += " (" + filter->GetObjectName() + ")";
+    }
+  return name;
+}
+
+void
+WriteJSONString(std::ostream & os, const std::string & text)
+{
+  os << '"';
+  for ( const char c : text )
+    {
+    switch ( c )
+      {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if ( static_cast< unsigned char >( c ) < 0x20 )
+          {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << static_cast< int >( c ) << std::dec << std::setfill(' ');
+          }
+        else
+          {
+          os << c;
+          }
+      }
+    }
+  os << '"';
+}
+
+const char *
+GetCategoryName(PipelineProfiler::EventCategory category)
+{
+  switch ( category )
+    {
+    case PipelineProfiler::EventCategory::GenerateData:
+      return "GenerateData";
+    case PipelineProfiler::EventCategory::WorkUnit:
+      return "WorkUnit";
+    case PipelineProfiler::EventCategory::StreamingPiece:
+      return "StreamingPiece";
+    }
+  return "Unknown";
+}
+} // end anonymous namespace
+
+constexpr PipelineProfiler::EventIdentifier PipelineProfiler::InvalidEvent;
+
+PipelineProfiler::Pointer PipelineProfiler::m_Instance = nullptr;
+
+PipelineProfiler
+::PipelineProfiler() :
+  m_Epoch( ClockType::now() )
+{
+}
+
+PipelineProfiler::Pointer
+PipelineProfiler
+::New()
+{
+  return GetInstance();
+}
+
+PipelineProfiler::Pointer
+PipelineProfiler
+::GetInstance()
+{
+  std::lock_guard< std::mutex > lock( profilerInstanceMutex );
+  if ( !PipelineProfiler::m_Instance )
+    {
+    // Try the factory first
+    PipelineProfiler::m_Instance = ObjectFactory< Self >::Create();
+    // if the factory did not provide one, then create it here
+    if ( !PipelineProfiler::m_Instance )
+      {
+      PipelineProfiler::m_Instance = new PipelineProfiler;
+      // Remove extra reference from construction.
+      PipelineProfiler::m_Instance->UnRegister();
+      }
+    }
+  return PipelineProfiler::m_Instance;
+}
+
+void
+PipelineProfiler
+::SetInstance(PipelineProfiler *instance)
+{
+  std::lock_guard< std::mutex > lock( profilerInstanceMutex );
+  PipelineProfiler::m_Instance = instance;
+}
+
+void
+PipelineProfiler
+::SetEnabled(bool enabled)
+{
+  profilerEnabled = enabled;
+}
+
+bool
+PipelineProfiler
+::GetEnabled()
+{
+  return profilerEnabled;
+}
+
+double
+PipelineProfiler
+::Now() const
+{
+  return std::chrono::duration< double, std::micro >( ClockType::now() - m_Epoch ).count();
+}
+
+PipelineProfiler::EventIdentifier
+PipelineProfiler
+::Begin(Event && event)
+{
+  event.Thread = GetProfilerThreadNumber();
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  event.Start = this->Now();
+  m_Events.push_back( std::move( event ) );
+  return m_Events.size() - 1;
+}
+
+void
+PipelineProfiler
+::End(EventIdentifier eventId)
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  if ( eventId >= m_Events.size() || !m_Events[eventId].Open )
+    {
+    return;
+    }
+  Event & event = m_Events[eventId];
+  event.Duration = this->Now() - event.Start;
+  event.Open = false;
+
+  if ( event.Category == EventCategory::GenerateData )
+    {
+    auto it = m_OpenGenerateData.find( event.Source );
+    if ( it != m_OpenGenerateData.end() && it->second == eventId )
+      {
+      m_OpenGenerateData.erase( it );
+      }
+    }
+  else if ( event.Category == EventCategory::WorkUnit )
+    {
+    auto it = m_OpenGenerateData.find( event.Source );
+    if ( it != m_OpenGenerateData.end() )
+      {
+      Event & parent = m_Events[it->second];
+      ++parent.NumberOfWorkUnits;
+      parent.WorkUnitsDuration += event.Duration;
+      }
+    }
+}
+
+PipelineProfiler::EventIdentifier
+PipelineProfiler
+::BeginGenerateData(const ProcessObject *filter)
+{
+  if ( !GetEnabled() || filter == nullptr )
+    {
+    return InvalidEvent;
+    }
+  Event event;
+  event.Category = EventCategory::GenerateData;
+  event.Name = GetFilterName( filter );
+  event.Source = filter;
+  const MultiThreaderBase * multiThreader = filter->GetMultiThreader();
+  event.NumberOfThreads = multiThreader ? multiThreader->GetMaximumNumberOfThreads() : 1;
+
+  Self * profiler = GetInstance();
+  const EventIdentifier eventId = profiler->Begin( std::move( event ) );
+    {
+    std::lock_guard< std::mutex > lock( profiler->m_Mutex );
+    profiler->m_OpenGenerateData[filter] = eventId;
+    }
+  GetOpenGenerateDataStack().push_back( eventId );
+  return eventId;
+}
+
+PipelineProfiler::EventIdentifier
+PipelineProfiler
+::BeginWorkUnit(const ProcessObject *filter, SizeValueType numberOfPixels)
+{
+  if ( !GetEnabled() || filter == nullptr )
+    {
+    return InvalidEvent;
+    }
+  Event event;
+  event.Category = EventCategory::WorkUnit;
+  event.Name = GetFilterName( filter );
+  event.Source = filter;
+  event.NumberOfPixels = numberOfPixels;
+  return GetInstance()->Begin( std::move( event ) );
+}
+
+PipelineProfiler::EventIdentifier
+PipelineProfiler
+::BeginStreamingPiece(const ProcessObject *filter, SizeValueType piece, SizeValueType numberOfPixels)
+{
+  if ( !GetEnabled() || filter == nullptr )
+    {
+    return InvalidEvent;
+    }
+  Event event;
+  event.Category = EventCategory::StreamingPiece;
+  event.Name = GetFilterName( filter );
+  event.Source = filter;
+  event.Piece = piece;
+  event.NumberOfPixels = numberOfPixels;
+  return GetInstance()->Begin( std::move( event ) );
+}
+
+void
+PipelineProfiler
+::EndEvent(EventIdentifier event)
+{
+  if ( event == InvalidEvent )
+    {
+    return;
+    }
+  std::vector< EventIdentifier > & stack = GetOpenGenerateDataStack();
+  if ( !stack.empty() && stack.back() == event )
+    {
+    stack.pop_back();
+    }
+  GetInstance()->End( event );
+}
+
+void
+PipelineProfiler
+::RecordAllocation(SizeValueType numberOfBytes)
+{
+  if ( !GetEnabled() )
+    {
+    return;
+    }
+  const std::vector< EventIdentifier > & stack = GetOpenGenerateDataStack();
+  if ( stack.empty() )
+    {
+    return;
+    }
+  Self * profiler = GetInstance();
+  std::lock_guard< std::mutex > lock( profiler->m_Mutex );
+  if ( stack.back() < profiler->m_Events.size() )
+    {
+    profiler->m_Events[stack.back()].BytesAllocated += numberOfBytes;
+    }
+}
+
+PipelineProfiler::EventListType
+PipelineProfiler
+::GetEvents() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return m_Events;
+}
+
+void
+PipelineProfiler
+::Clear()
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  m_Events.clear();
+  m_OpenGenerateData.clear();
+  m_Epoch = ClockType::now();
+}
+
+void
+PipelineProfiler
+::WriteChromeTrace(std::ostream & os) const
+{
+  const EventListType events = this->GetEvents();
+
+  os << "{\"traceEvents\":[";
+  bool first = true;
+  for ( const Event & event : events )
+    {
+    os << ( first ? "\n" : ",\n" );
+    first = false;
+    os << "{\"name\":";
+    WriteJSONString( os, event.Name );
+    os << ",\"cat\":\"" << GetCategoryName( event.Category ) << "\",\"ph\":\"X\""
+       << ",\"ts\":" << event.Start << ",\"dur\":" << event.Duration
+       << ",\"pid\":1,\"tid\":" << event.Thread << ",\"args\":{";
+    switch ( event.Category )
+      {
+      case EventCategory::GenerateData:
+        os << "\"bytesAllocated\":" << event.BytesAllocated
+           << ",\"workUnits\":" << event.NumberOfWorkUnits
+           << ",\"threads\":" << event.NumberOfThreads;
+        if ( event.NumberOfWorkUnits > 0 && event.Duration > 0.0 && event.NumberOfThreads > 0 )
+          {
+          os << ",\"utilization\":" << event.WorkUnitsDuration / ( event.Duration * event.NumberOfThreads );
+          }
+        break;
+      case EventCategory::WorkUnit:
+        os << "\"pixels\":" << event.NumberOfPixels;
+        break;
+      case EventCategory::StreamingPiece:
+        os << "\"piece\":" << event.Piece << ",\"pixels\":" << event.NumberOfPixels;
+        break;
+      }
+    os << "}}";
+    }
+  os << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+}
+
+void
+PipelineProfiler
+::WriteJSON(std::ostream & os) const
+{
+  struct Summary
+  {
+    std::string   Name;
+    SizeValueType Executions{ 0 };
+    double        TotalTime{ 0.0 };
+    double        MinimumTime{ 0.0 };
+    double        MaximumTime{ 0.0 };
+    SizeValueType BytesAllocated{ 0 };
+    SizeValueType WorkUnits{ 0 };
+    double        WorkUnitsTime{ 0.0 };
+    double        ThreadedTime{ 0.0 };
+    SizeValueType StreamingPieces{ 0 };
+  };
+
+  const EventListType events = this->GetEvents();
+
+  // Filters in the order of their first event.
+  std::map< const void *, SizeValueType > index;
+  std::vector< Summary > summaries;
+  for ( const Event & event : events )
+    {
+    auto it = index.find( event.Source );
+    if ( it == index.end() )
+      {
+      it = index.emplace( event.Source, summaries.size() ).first;
+      summaries.emplace_back();
+      summaries.back().Name = event.Name;
+      }
+    Summary & summary = summaries[it->second];
+    if ( event.Category == EventCategory::GenerateData )
+      {
+      const double seconds = event.Duration * 1e-6;
+      summary.MinimumTime = summary.Executions == 0 ? seconds : std::min( summary.MinimumTime, seconds );
+      summary.MaximumTime = std::max( summary.MaximumTime, seconds );
+      ++summary.Executions;
+      summary.TotalTime += seconds;
+      summary.BytesAllocated += event.BytesAllocated;
+      summary.WorkUnits += event.NumberOfWorkUnits;
+      if ( event.NumberOfWorkUnits > 0 )
+        {
+        summary.WorkUnitsTime += event.WorkUnitsDuration * 1e-6;
+        summary.ThreadedTime += seconds * event.NumberOfThreads;
+        }
+      }
+    else if ( event.Category == EventCategory::StreamingPiece )
+      {
+      ++summary.StreamingPieces;
+      }
+    }
+  std::stable_sort( summaries.begin(), summaries.end(),
+    []( const Summary & a, const Summary & b ) { return a.TotalTime > b.TotalTime; } );
+
+  os << "{\"filters\":[";
+  bool first = true;
+  for ( const Summary & summary : summaries )
+    {
+    os << ( first ? "\n" : ",\n" );
+    first = false;
+    os << "{\"name\":";
+    WriteJSONString( os, summary.Name );
+    os << ",\"executions\":" << summary.Executions
+       << ",\"totalTime\":" << summary.TotalTime
+       << ",\"minimumTime\":" << summary.MinimumTime
+       << ",\"maximumTime\":" << summary.MaximumTime
+       << ",\"bytesAllocated\":" << summary.BytesAllocated
+       << ",\"workUnits\":" << summary.WorkUnits;
+    if ( summary.ThreadedTime > 0.0 )
+      {
+      os << ",\"utilization\":" << summary.WorkUnitsTime / summary.ThreadedTime;
+      }
+    os << ",\"streamingPieces\":" << summary.StreamingPieces << "}";
+    }
+  os << "\n]}" << std::endl;
+}
+
+void
+PipelineProfiler
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << GetEnabled() << std::endl;
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  os << indent << "NumberOfEvents: " << m_Events.size() << std::endl;
+}
+} // end namespace itk
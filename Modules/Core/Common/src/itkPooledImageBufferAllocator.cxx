@@ -0,0 +1,217 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPooledImageBufferAllocator.h"
+
+namespace itk
+{
+
+PooledImageBufferAllocator
+::~PooledImageBufferAllocator()
+{
+  this->EvictCachedBuffers( 0 );
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetBucketSize(SizeValueType numberOfBytes)
+{
+  SizeValueType powerOfTwo = 1;
+  while ( powerOfTwo < numberOfBytes )
+    {
+    powerOfTwo <<= 1;
+    }
+  if ( powerOfTwo <= 8 )
+    {
+    return powerOfTwo;
+    }
+  // Four buckets between powerOfTwo / 2 and powerOfTwo.
+  const SizeValueType step = powerOfTwo / 8;
+  return ( ( numberOfBytes + step - 1 ) / step ) * step;
+}
+
+void *
+PooledImageBufferAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  const SizeValueType bucketSize = GetBucketSize( numberOfBytes );
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    auto freeList = m_FreeLists.find( bucketSize );
+    if ( freeList != m_FreeLists.end() && !freeList->second.empty() )
+      {
+      void * buffer = freeList->second.back();
+      freeList->second.pop_back();
+      m_NumberOfCachedBytes -= bucketSize;
+      ++m_NumberOfCacheHits;
+      return buffer;
+      }
+    ++m_NumberOfCacheMisses;
+    }
+  return this->AllocateAligned( bucketSize, this->GetAlignmentForSize( bucketSize ) );
+}
+
+void
+PooledImageBufferAllocator
+::Deallocate(void * buffer, SizeValueType numberOfBytes)
+{
+  if ( !buffer )
+    {
+    return;
+    }
+  const SizeValueType bucketSize = GetBucketSize( numberOfBytes );
+    {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    if ( m_NumberOfCachedBytes + bucketSize <= m_MaximumNumberOfCachedBytes )
+      {
+      m_FreeLists[bucketSize].push_back( buffer );
+      m_NumberOfCachedBytes += bucketSize;
+      return;
+      }
+    }
+  this->DeallocateAligned( buffer );
+}
+
+void
+PooledImageBufferAllocator
+::SetAlignment(SizeValueType alignment)
+{
+  const SizeValueType oldAlignment = this->GetAlignment();
+  Superclass::SetAlignment( alignment );
+  if ( this->GetAlignment() != oldAlignment )
+    {
+    this->ReleaseCachedBuffers();
+    }
+}
+
+void
+PooledImageBufferAllocator
+::SetUseHugePages(bool useHugePages)
+{
+  const bool oldUseHugePages = this->GetUseHugePages();
+  Superclass::SetUseHugePages( useHugePages );
+  if ( this->GetUseHugePages() != oldUseHugePages )
+    {
+    this->ReleaseCachedBuffers();
+    }
+}
+
+void
+PooledImageBufferAllocator
+::SetHugePageSize(SizeValueType hugePageSize)
+{
+  const SizeValueType oldHugePageSize = this->GetHugePageSize();
+  Superclass::SetHugePageSize( hugePageSize );
+  if ( this->GetHugePageSize() != oldHugePageSize )
+    {
+    this->ReleaseCachedBuffers();
+    }
+}
+
+void
+PooledImageBufferAllocator
+::SetMaximumNumberOfCachedBytes(SizeValueType numberOfBytes)
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  if ( m_MaximumNumberOfCachedBytes != numberOfBytes )
+    {
+    m_MaximumNumberOfCachedBytes = numberOfBytes;
+    this->EvictCachedBuffers( m_MaximumNumberOfCachedBytes );
+    this->Modified();
+    }
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetMaximumNumberOfCachedBytes() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return m_MaximumNumberOfCachedBytes;
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetNumberOfCachedBytes() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return m_NumberOfCachedBytes;
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetNumberOfCacheHits() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return m_NumberOfCacheHits;
+}
+
+SizeValueType
+PooledImageBufferAllocator
+::GetNumberOfCacheMisses() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return m_NumberOfCacheMisses;
+}
+
+void
+PooledImageBufferAllocator
+::ResetStatistics()
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  m_NumberOfCacheHits = 0;
+  m_NumberOfCacheMisses = 0;
+}
+
+void
+PooledImageBufferAllocator
+::ReleaseCachedBuffers()
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  this->EvictCachedBuffers( 0 );
+}
+
+void
+PooledImageBufferAllocator
+::EvictCachedBuffers(SizeValueType maximumNumberOfBytes)
+{
+  for ( auto freeList = m_FreeLists.rbegin();
+        freeList != m_FreeLists.rend() && m_NumberOfCachedBytes > maximumNumberOfBytes;
+        ++freeList )
+    {
+    while ( !freeList->second.empty() && m_NumberOfCachedBytes > maximumNumberOfBytes )
+      {
+      this->DeallocateAligned( freeList->second.back() );
+      freeList->second.pop_back();
+      m_NumberOfCachedBytes -= freeList->first;
+      }
+    }
+}
+
+void
+PooledImageBufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  os << indent << "NumberOfCachedBytes: " << m_NumberOfCachedBytes << std::endl;
+  os << indent << "MaximumNumberOfCachedBytes: " << m_MaximumNumberOfCachedBytes << std::endl;
+  os << indent << "NumberOfCacheHits: " << m_NumberOfCacheHits << std::endl;
+  os << indent << "NumberOfCacheMisses: " << m_NumberOfCacheMisses << std::endl;
+}
+
+} // end namespace itk
@@ -26,6 +26,7 @@
  *
  *=========================================================================*/
 #include "itkProcessObject.h"
+#include "itkPipelineProfiler.h"
 #include <mutex>
 
 #include <cstdio>
@@ -1787,6 +1788,7 @@ ProcessObject
 
   try
     {
+    const PipelineProfiler::ScopedEvent profilerEvent( PipelineProfiler::BeginGenerateData( this ) );
     this->GenerateData();
     }
   catch ( ProcessAborted & )
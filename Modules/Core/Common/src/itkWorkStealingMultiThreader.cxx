@@ -0,0 +1,277 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingMultiThreader.h"
+#include "itkNumericTraits.h"
+#include "itkProcessObject.h"
+#include "itkImageSourceCommon.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+WorkStealingMultiThreader::WorkStealingMultiThreader() :
+  m_ThreadPool( WorkStealingThreadPool::GetInstance() )
+{
+  for( ThreadIdType i = 0; i < ITK_MAX_THREADS; ++i )
+    {
+    m_ThreadInfoArray[i].WorkUnitID = i;
+    }
+
+  ThreadIdType defaultThreads = std::max(1u, GetGlobalDefaultNumberOfThreads());
+#if !defined( ITKV4_COMPATIBILITY )
+  defaultThreads *= 4;
+#endif
+  m_NumberOfWorkUnits = std::min< ThreadIdType >( ITK_MAX_THREADS, defaultThreads );
+  m_MaximumNumberOfThreads = m_ThreadPool->GetMaximumNumberOfThreads();
+}
+
+WorkStealingMultiThreader::~WorkStealingMultiThreader() = default;
+
+void WorkStealingMultiThreader::SetSingleMethod(ThreadFunctionType f, void *data)
+{
+  m_SingleMethod = f;
+  m_SingleData   = data;
+}
+
+void WorkStealingMultiThreader::SetMaximumNumberOfThreads(ThreadIdType numberOfThreads)
+{
+  Superclass::SetMaximumNumberOfThreads( numberOfThreads );
+  ThreadIdType threadCount = m_ThreadPool->GetMaximumNumberOfThreads();
+  if ( threadCount < m_MaximumNumberOfThreads )
+    {
+    m_ThreadPool->AddThreads( m_MaximumNumberOfThreads - threadCount );
+    }
+  m_MaximumNumberOfThreads = m_ThreadPool->GetMaximumNumberOfThreads();
+}
+
+void WorkStealingMultiThreader::SingleMethodExecute()
+{
+  ThreadIdType threadLoop = 0;
+
+  if( !m_SingleMethod )
+    {
+    itkExceptionMacro(<< "No single method set!");
+    }
+
+  // obey the global maximum number of threads limit
+  m_NumberOfWorkUnits = std::min( this->GetGlobalMaximumNumberOfThreads(), m_NumberOfWorkUnits );
+
+  for ( threadLoop = 1; threadLoop < m_NumberOfWorkUnits; ++threadLoop )
+    {
+    m_ThreadInfoArray[threadLoop].UserData = m_SingleData;
+    m_ThreadInfoArray[threadLoop].NumberOfWorkUnits = m_NumberOfWorkUnits;
+    m_ThreadInfoArray[threadLoop].Future = m_ThreadPool->AddWork( m_SingleMethod, &m_ThreadInfoArray[threadLoop] );
+    }
+
+  // Now, the parent thread calls this->SingleMethod() itself
+  std::exception_ptr firstException;
+  try
+    {
+    m_ThreadInfoArray[0].UserData = m_SingleData;
+    m_ThreadInfoArray[0].NumberOfWorkUnits = m_NumberOfWorkUnits;
+    m_SingleMethod( (void *)( &m_ThreadInfoArray[0] ) );
+    }
+  catch( ... )
+    {
+    firstException = std::current_exception();
+    }
+
+  // The parent thread has finished SingleMethod(), so now it helps the other
+  // work units to finish. All of them are waited for, even if one of them
+  // failed, because they refer to m_ThreadInfoArray.
+  for ( threadLoop = 1; threadLoop < m_NumberOfWorkUnits; ++threadLoop )
+    {
+    m_ThreadPool->WaitFor( m_ThreadInfoArray[threadLoop].Future );
+    try
+      {
+      m_ThreadInfoArray[threadLoop].Future.get();
+      }
+    catch( ... )
+      {
+      if ( !firstException )
+        {
+        firstException = std::current_exception();
+        }
+      }
+    }
+
+  if ( !firstException )
+    {
+    return;
+    }
+
+  try
+    {
+    std::rethrow_exception( firstException );
+    }
+  catch( ProcessAborted & )
+    {
+    throw;
+    }
+  catch( std::exception & e )
+    {
+    itkExceptionMacro(<< "Exception occurred during SingleMethodExecute" << std::endl << e.what());
+    }
+  catch( ... )
+    {
+    itkExceptionMacro("Exception occurred during SingleMethodExecute");
+    }
+}
+
+void
+WorkStealingMultiThreader
+::ParallelizeArray(
+  SizeValueType firstIndex,
+  SizeValueType lastIndexPlus1,
+  ArrayThreadingFunctorType aFunc,
+  ProcessObject * filter)
+{
+  MultiThreaderBase::HandleFilterProgress(filter, 0.0f);
+
+  if ( firstIndex + 1 < lastIndexPlus1 )
+    {
+    SizeValueType chunkSize = ( lastIndexPlus1 - firstIndex ) / m_NumberOfWorkUnits;
+    if ((lastIndexPlus1 - firstIndex) % m_NumberOfWorkUnits > 0)
+      {
+      chunkSize++; // we want slightly bigger chunks to be processed first
+      }
+
+    // Futures are kept locally rather than in m_ThreadInfoArray,
+    // so that this method can be re-entered by nested parallel calls.
+    std::vector< std::future< ITK_THREAD_RETURN_TYPE > > futures;
+    futures.reserve( m_NumberOfWorkUnits );
+    for ( SizeValueType i = firstIndex; i < lastIndexPlus1; i += chunkSize )
+      {
+      futures.emplace_back( m_ThreadPool->AddWork(
+        [aFunc]( SizeValueType start, SizeValueType end)
+        {
+          for ( SizeValueType ii = start; ii < end; ii++ )
+          {
+            aFunc( ii );
+          }
+          // make this lambda have the same signature as m_SingleMethod
+          return ITK_THREAD_RETURN_DEFAULT_VALUE;
+        },
+        i,
+        std::min( i + chunkSize, lastIndexPlus1 ) ) );
+      }
+    itkAssertOrThrowMacro( futures.size() <= m_NumberOfWorkUnits,
+      "Number of work units was somehow miscounted!" );
+    //now help with and wait for all computations to finish
+    for (SizeValueType i = 0; i < futures.size(); i++)
+      {
+      m_ThreadPool->WaitFor( futures[i] );
+      futures[i].get();
+      if ( filter )
+        {
+        filter->UpdateProgress( ( i + 1 ) / float( futures.size() ) );
+        }
+      }
+    }
+  else if ( firstIndex + 1 == lastIndexPlus1 )
+    {
+    aFunc( firstIndex );
+    }
+  // else nothing needs to be executed
+
+  MultiThreaderBase::HandleFilterProgress(filter, 1.0f);
+}
+
+void
+WorkStealingMultiThreader
+::ParallelizeImageRegion(
+  unsigned int dimension,
+  const IndexValueType index[],
+  const SizeValueType size[],
+  ThreadingFunctorType funcP,
+  ProcessObject * filter)
+{
+  MultiThreaderBase::HandleFilterProgress(filter, 0.0f);
+
+  if ( m_NumberOfWorkUnits == 1 ) // no multi-threading wanted
+    {
+    funcP( index, size ); //process whole region
+    }
+  else
+    {
+    ImageIORegion region(dimension);
+    for (unsigned d = 0; d < dimension; d++)
+      {
+      region.SetIndex(d, index[d]);
+      region.SetSize(d, size[d]);
+      }
+    if ( region.GetNumberOfPixels() <= 1 )
+      {
+      funcP( index, size ); //process whole region
+      }
+    else
+      {
+      const ImageRegionSplitterBase * splitter = ImageSourceCommon::GetGlobalDefaultSplitter();
+      ThreadIdType splitCount = splitter->GetNumberOfSplits( region, m_NumberOfWorkUnits );
+      itkAssertOrThrowMacro( splitCount <= m_NumberOfWorkUnits,
+        "Split count is greater than number of work units!" );
+      std::vector< std::future< ITK_THREAD_RETURN_TYPE > > futures;
+      futures.reserve( splitCount );
+      for ( ThreadIdType i = 0; i < splitCount; i++ )
+        {
+        ImageIORegion iRegion = region;
+        ThreadIdType total = splitter->GetSplit( i, splitCount, iRegion );
+        if (i < total)
+          {
+          futures.emplace_back( m_ThreadPool->AddWork(
+            [funcP, iRegion]()
+            {
+              funcP( &iRegion.GetIndex()[0], &iRegion.GetSize()[0] );
+              // make this lambda have the same signature as m_SingleMethod
+              return ITK_THREAD_RETURN_DEFAULT_VALUE;
+            }
+            ) );
+          }
+        else
+          {
+          itkExceptionMacro( "Could not get work unit " << i
+            << " even though we checked possible number of splits beforehand!" );
+          }
+        }
+
+      // now help with and wait for all computations to finish
+      for (ThreadIdType i = 0; i < splitCount; i++)
+        {
+        m_ThreadPool->WaitFor( futures[i] );
+        futures[i].get();
+        if ( filter )
+          {
+          filter->UpdateProgress( ( i + 1 ) / float( splitCount ) );
+          }
+        }
+      }
+    }
+  MultiThreaderBase::HandleFilterProgress(filter, 1.0f);
+}
+
+void WorkStealingMultiThreader::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ThreadPool: " << m_ThreadPool.GetPointer() << std::endl;
+}
+
+}
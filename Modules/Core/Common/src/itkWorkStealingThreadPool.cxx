@@ -0,0 +1,259 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingThreadPool.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+
+namespace
+{
+std::mutex                           workStealingThreadPoolInstanceLock;
+itk::WorkStealingThreadPool::Pointer workStealingThreadPoolInstance;
+
+// Identifies the worker which runs on the current thread, if any.
+thread_local const itk::WorkStealingThreadPool * currentPool = nullptr;
+thread_local itk::ThreadIdType                   currentWorkerIndex = 0;
+}// end of anonymous namespace
+
+namespace itk
+{
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool
+::New()
+{
+  return Self::GetInstance();
+}
+
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool
+::GetInstance()
+{
+  std::unique_lock< std::mutex > mutexHolder( workStealingThreadPoolInstanceLock );
+  if( workStealingThreadPoolInstance.IsNull() )
+    {
+    workStealingThreadPoolInstance = ObjectFactory< Self >::Create();
+    if ( workStealingThreadPoolInstance.IsNull() )
+      {
+      workStealingThreadPoolInstance = new Self;
+      workStealingThreadPoolInstance->UnRegister(); // Remove extra reference
+      }
+    }
+  return workStealingThreadPoolInstance;
+}
+
+bool
+WorkStealingThreadPool
+::IsWorkerThread()
+{
+  return currentPool != nullptr;
+}
+
+WorkStealingThreadPool
+::WorkStealingThreadPool() :
+  m_Queues( new WorkerQueue[ITK_MAX_THREADS] )
+{
+  this->AddThreads( MultiThreaderBase::GetGlobalDefaultNumberOfThreads() );
+}
+
+WorkStealingThreadPool
+::~WorkStealingThreadPool()
+{
+    {
+    std::unique_lock< std::mutex > sleepHolder( m_SleepMutex );
+    m_Stopping = true;
+    }
+  m_Condition.notify_all();
+
+  for ( auto & thread : m_Threads )
+    {
+#if defined(_WIN32) && defined(ITKCommon_EXPORTS)
+    // This destructor is called during DllMain's DLL_PROCESS_DETACH,
+    // when all other threads of the process have already been terminated.
+    thread.detach();
+#else
+    thread.join();
+#endif
+    }
+}
+
+void
+WorkStealingThreadPool
+::AddThreads(ThreadIdType count)
+{
+  std::unique_lock< std::mutex > threadsHolder( m_ThreadsMutex );
+  const ThreadIdType first = m_NumberOfWorkers;
+  const ThreadIdType last = std::min< ThreadIdType >( first + count, ITK_MAX_THREADS );
+  m_Threads.reserve( last );
+  for ( ThreadIdType i = first; i < last; ++i )
+    {
+    m_Threads.emplace_back( &WorkStealingThreadPool::ThreadExecute, this, i );
+    }
+  // Queues of new workers only become visible to thieves and to the
+  // round-robin distribution once their threads exist.
+  m_NumberOfWorkers = last;
+}
+
+int
+WorkStealingThreadPool
+::GetNumberOfCurrentlyIdleThreads() const
+{
+  return int( m_NumberOfWorkers ) - m_NumberOfBusyWorkers;
+}
+
+void
+WorkStealingThreadPool
+::PushTask(TaskType && task)
+{
+  ThreadIdType queueIndex;
+  if ( currentPool == this )
+    {
+    queueIndex = currentWorkerIndex;
+    }
+  else
+    {
+    queueIndex = m_NextQueue++ % std::max< ThreadIdType >( m_NumberOfWorkers, 1 );
+    }
+
+  // The counter is incremented before the task becomes visible, so that
+  // it never drops below the number of tasks in the queues.
+  ++m_NumberOfPendingTasks;
+
+    {
+    std::unique_lock< std::mutex > queueHolder( m_Queues[queueIndex].m_Mutex );
+    m_Queues[queueIndex].m_Tasks.emplace_back( std::move( task ) );
+    }
+
+  // A worker announces itself as sleeping before it checks the pending
+  // tasks, so either it sees the task above, or it is counted here. In the
+  // latter case, taking the sleep mutex guarantees that it is already
+  // waiting and receives the notification.
+  if ( m_NumberOfSleepingWorkers > 0 )
+    {
+    std::unique_lock< std::mutex > sleepHolder( m_SleepMutex );
+    m_Condition.notify_one();
+    }
+}
+
+bool
+WorkStealingThreadPool
+::PopTask(ThreadIdType queueIndex, TaskType & task)
+{
+  WorkerQueue & queue = m_Queues[queueIndex];
+  std::unique_lock< std::mutex > queueHolder( queue.m_Mutex );
+  if ( queue.m_Tasks.empty() )
+    {
+    return false;
+    }
+  task = std::move( queue.m_Tasks.back() );
+  queue.m_Tasks.pop_back();
+  --m_NumberOfPendingTasks;
+  return true;
+}
+
+bool
+WorkStealingThreadPool
+::StealTask(ThreadIdType thiefIndex, TaskType & task)
+{
+  const ThreadIdType numberOfWorkers = m_NumberOfWorkers;
+  for ( ThreadIdType i = 1; i <= numberOfWorkers; ++i )
+    {
+    WorkerQueue & victim = m_Queues[( thiefIndex + i ) % numberOfWorkers];
+    std::unique_lock< std::mutex > queueHolder( victim.m_Mutex, std::try_to_lock );
+    if ( !queueHolder.owns_lock() || victim.m_Tasks.empty() )
+      {
+      continue;
+      }
+    task = std::move( victim.m_Tasks.front() );
+    victim.m_Tasks.pop_front();
+    --m_NumberOfPendingTasks;
+    return true;
+    }
+  return false;
+}
+
+bool
+WorkStealingThreadPool
+::RunPendingTask()
+{
+  TaskType task;
+  if ( currentPool == this )
+    {
+    if ( !this->PopTask( currentWorkerIndex, task ) && !this->StealTask( currentWorkerIndex, task ) )
+      {
+      return false;
+      }
+    }
+  else if ( !this->StealTask( m_NextQueue % std::max< ThreadIdType >( m_NumberOfWorkers, 1 ), task ) )
+    {
+    return false;
+    }
+
+  task(); //execute the task
+  return true;
+}
+
+void
+WorkStealingThreadPool
+::ThreadExecute(ThreadIdType workerIndex)
+{
+  currentPool = this;
+  currentWorkerIndex = workerIndex;
+
+  while ( true )
+    {
+    TaskType task;
+    if ( this->PopTask( workerIndex, task ) || this->StealTask( workerIndex, task ) )
+      {
+      ++m_NumberOfBusyWorkers;
+      task(); //execute the task
+      --m_NumberOfBusyWorkers;
+      continue;
+      }
+
+    std::unique_lock< std::mutex > sleepHolder( m_SleepMutex );
+    ++m_NumberOfSleepingWorkers;
+    m_Condition.wait( sleepHolder,
+      [this]
+      {
+        return m_Stopping || m_NumberOfPendingTasks > 0;
+      }
+      );
+    --m_NumberOfSleepingWorkers;
+    if ( m_Stopping && m_NumberOfPendingTasks == 0 )
+      {
+      return;
+      }
+    }
+}
+
+void
+WorkStealingThreadPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfWorkers: " << m_NumberOfWorkers << std::endl;
+  os << indent << "NumberOfPendingTasks: " << m_NumberOfPendingTasks << std::endl;
+  os << indent << "NumberOfBusyWorkers: " << m_NumberOfBusyWorkers << std::endl;
+  os << indent << "NumberOfSleepingWorkers: " << m_NumberOfSleepingWorkers << std::endl;
+}
+
+}
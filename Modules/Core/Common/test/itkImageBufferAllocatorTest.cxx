@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPooledImageBufferAllocator.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkRGBPixel.h"
+#include "itkTestingMacros.h"
+#include <cstdint>
+
+namespace
+{
+bool IsAligned(const void * pointer, itk::SizeValueType alignment)
+{
+  return reinterpret_cast< std::uintptr_t >( pointer ) % alignment == 0;
+}
+
+template< typename TImage >
+typename TImage::Pointer MakeImage(itk::SizeValueType size)
+{
+  typename TImage::Pointer image = TImage::New();
+  typename TImage::RegionType region;
+  region.SetSize( 0, size );
+  region.SetSize( 1, size );
+  image->SetRegions( region );
+  return image;
+}
+}
+
+int itkImageBufferAllocatorTest(int, char* [])
+{
+  using ImageType = itk::Image< float, 2 >;
+  using RGBImageType = itk::Image< itk::RGBPixel< unsigned char >, 2 >;
+  using VectorImageType = itk::VectorImage< short, 2 >;
+
+  // Without a global default allocator containers use new[]
+  TEST_EXPECT_TRUE( itk::ImageBufferAllocator::GetGlobalDefaultAllocator().IsNull() );
+  ImageType::Pointer legacyImage = MakeImage< ImageType >( 16 );
+  legacyImage->Allocate();
+  TEST_EXPECT_TRUE( legacyImage->GetPixelContainer()->GetAllocator() == nullptr );
+
+  // Plain aligned allocator
+  itk::ImageBufferAllocator::Pointer alignedAllocator = itk::ImageBufferAllocator::New();
+  EXERCISE_BASIC_OBJECT_METHODS( alignedAllocator, ImageBufferAllocator, Object );
+  TEST_EXPECT_EQUAL( alignedAllocator->GetAlignment(), 64u );
+  alignedAllocator->SetAlignment( 100 );
+  TEST_EXPECT_EQUAL( alignedAllocator->GetAlignment(), 128u );
+  alignedAllocator->SetAlignment( 64 );
+  for ( itk::SizeValueType numberOfBytes : { 1, 63, 64, 1000, 1 << 20 } )
+    {
+    void * buffer = alignedAllocator->Allocate( numberOfBytes );
+    TEST_EXPECT_TRUE( IsAligned( buffer, 64 ) );
+    alignedAllocator->Deallocate( buffer, numberOfBytes );
+    }
+  alignedAllocator->UseHugePagesOn();
+  void * hugeBuffer = alignedAllocator->Allocate( 3 * alignedAllocator->GetHugePageSize() );
+  TEST_EXPECT_TRUE( IsAligned( hugeBuffer, alignedAllocator->GetHugePageSize() ) );
+  alignedAllocator->Deallocate( hugeBuffer, 3 * alignedAllocator->GetHugePageSize() );
+
+  // Bucket sizes waste at most 25%
+  using PoolType = itk::PooledImageBufferAllocator;
+  for ( itk::SizeValueType numberOfBytes = 1; numberOfBytes < 100000; numberOfBytes += 37 )
+    {
+    const itk::SizeValueType bucketSize = PoolType::GetBucketSize( numberOfBytes );
+    TEST_EXPECT_TRUE( bucketSize >= numberOfBytes );
+    TEST_EXPECT_TRUE( numberOfBytes <= 8 || 4 * ( bucketSize - numberOfBytes ) <= numberOfBytes );
+    }
+
+  PoolType::Pointer pool = PoolType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( pool, PooledImageBufferAllocator, ImageBufferAllocator );
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator( pool );
+  TEST_EXPECT_TRUE( itk::ImageBufferAllocator::GetGlobalDefaultAllocator() == pool.GetPointer() );
+
+  // A released buffer is reused by the next image of the same size
+  ImageType::Pointer image = MakeImage< ImageType >( 100 );
+  image->Allocate( true );
+  TEST_EXPECT_TRUE( IsAligned( image->GetBufferPointer(), 64 ) );
+  TEST_EXPECT_EQUAL( image->GetPixel( { { 99, 99 } } ), 0.0f );
+  image->FillBuffer( 3.0f );
+  const float * firstBuffer = image->GetBufferPointer();
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCacheMisses(), 1u );
+
+  image->ReleaseData();
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCachedBytes(), PoolType::GetBucketSize( 100 * 100 * sizeof( float ) ) );
+
+  ImageType::Pointer image2 = MakeImage< ImageType >( 100 );
+  image2->Allocate( true );
+  TEST_EXPECT_TRUE( image2->GetBufferPointer() == firstBuffer );
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCacheHits(), 1u );
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCachedBytes(), 0u );
+  // Allocate(true) zero-initializes reused buffers
+  TEST_EXPECT_EQUAL( image2->GetPixel( { { 50, 50 } } ), 0.0f );
+
+  // Growing a buffer copies the old content into a buffer of the allocator
+  image2->FillBuffer( 5.0f );
+  image2->GetPixelContainer()->Reserve( 2 * 100 * 100 );
+  TEST_EXPECT_EQUAL( ( *image2->GetPixelContainer() )[100], 5.0f );
+  TEST_EXPECT_TRUE( IsAligned( image2->GetBufferPointer(), 64 ) );
+  image2 = nullptr;
+
+  // Non-POD pixels and vector images
+  RGBImageType::Pointer rgbImage = MakeImage< RGBImageType >( 33 );
+  rgbImage->Allocate( true );
+  TEST_EXPECT_TRUE( IsAligned( rgbImage->GetBufferPointer(), 64 ) );
+  TEST_EXPECT_EQUAL( rgbImage->GetPixel( { { 32, 32 } } ).GetRed(), 0 );
+  rgbImage = nullptr;
+
+  VectorImageType::Pointer vectorImage = MakeImage< VectorImageType >( 21 );
+  vectorImage->SetNumberOfComponentsPerPixel( 3 );
+  vectorImage->Allocate();
+  TEST_EXPECT_TRUE( IsAligned( vectorImage->GetBufferPointer(), 64 ) );
+  vectorImage = nullptr;
+
+  // The cache limit is respected
+  pool->SetMaximumNumberOfCachedBytes( 1000 );
+  TEST_EXPECT_TRUE( pool->GetNumberOfCachedBytes() <= 1000 );
+  ImageType::Pointer largeImage = MakeImage< ImageType >( 64 );
+  largeImage->Allocate();
+  largeImage = nullptr;
+  TEST_EXPECT_TRUE( pool->GetNumberOfCachedBytes() <= 1000 );
+
+  // Buffers cached with other huge page settings are not reused
+  ImageType::Pointer smallImage = MakeImage< ImageType >( 10 );
+  smallImage->Allocate();
+  smallImage = nullptr;
+  TEST_EXPECT_TRUE( pool->GetNumberOfCachedBytes() > 0 );
+  pool->UseHugePagesOn();
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCachedBytes(), 0u );
+  smallImage = MakeImage< ImageType >( 10 );
+  smallImage->Allocate();
+  smallImage = nullptr;
+  TEST_EXPECT_TRUE( pool->GetNumberOfCachedBytes() > 0 );
+  pool->SetHugePageSize( 2 * pool->GetHugePageSize() );
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCachedBytes(), 0u );
+  pool->UseHugePagesOff();
+
+  pool->ReleaseCachedBuffers();
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCachedBytes(), 0u );
+  pool->ResetStatistics();
+  TEST_EXPECT_EQUAL( pool->GetNumberOfCacheHits(), 0u );
+
+  // Imported buffers are still released with delete[]
+  ImageType::PixelContainer::Pointer container = ImageType::PixelContainer::New();
+  TEST_EXPECT_TRUE( container->GetAllocator() == pool.GetPointer() );
+  container->SetImportPointer( new float[10], 10, true );
+  container = nullptr;
+
+  // Containers created before the global default changes keep their allocator
+  ImageType::Pointer pooledImage = MakeImage< ImageType >( 10 );
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator( nullptr );
+  pooledImage->Allocate();
+  TEST_EXPECT_TRUE( pooledImage->GetPixelContainer()->GetAllocator() == pool.GetPointer() );
+  pooledImage = nullptr;
+  TEST_EXPECT_TRUE( pool->GetNumberOfCachedBytes() > 0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineProfiler.h"
+#include "itkAbsImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+
+#include <sstream>
+
+int itkPipelineProfilerTest(int, char* [] )
+{
+  using ImageType = itk::Image< short, 2 >;
+  using AbsType = itk::AbsImageFilter< ImageType, ImageType >;
+  using StreamerType = itk::StreamingImageFilter< ImageType, ImageType >;
+  using ProfilerType = itk::PipelineProfiler;
+
+  constexpr unsigned int numberOfStreamDivisions = 4;
+
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType size = {{ 64, 48 }};
+  image->SetRegions( size );
+  image->Allocate();
+  image->FillBuffer( -3 );
+
+  AbsType::Pointer abs = AbsType::New();
+  abs->SetInput( image );
+  abs->SetObjectName( "abs" );
+  abs->SetNumberOfWorkUnits( 3 );
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( abs->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+
+  ProfilerType::Pointer profiler = ProfilerType::GetInstance();
+  TEST_EXPECT_TRUE( ProfilerType::New() == profiler );
+  EXERCISE_BASIC_OBJECT_METHODS( profiler, PipelineProfiler, Object );
+
+  // Recording is off by default.
+  TEST_EXPECT_TRUE( !ProfilerType::GetEnabled() );
+  profiler->Clear();
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_EQUAL( profiler->GetEvents().size(), 0 );
+
+  ProfilerType::EnabledOn();
+  TEST_EXPECT_TRUE( ProfilerType::GetEnabled() );
+  abs->Modified();
+  abs->GetOutput()->ReleaseData();
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  ProfilerType::EnabledOff();
+
+  const ProfilerType::EventListType events = profiler->GetEvents();
+  unsigned int                      generateData = 0;
+  unsigned int                      pieces = 0;
+  itk::SizeValueType                workUnits = 0;
+  itk::SizeValueType                workUnitPixels = 0;
+  itk::SizeValueType                bytes = 0;
+  for ( const auto & event : events )
+    {
+    TEST_EXPECT_TRUE( !event.Open );
+    TEST_EXPECT_TRUE( event.Duration >= 0.0 );
+    switch ( event.Category )
+      {
+      case ProfilerType::EventCategory::GenerateData:
+        TEST_EXPECT_EQUAL( event.Name, std::string( "AbsImageFilter (abs)" ) );
+        TEST_EXPECT_TRUE( event.Source == abs.GetPointer() );
+        ++generateData;
+        workUnits += event.NumberOfWorkUnits;
+        bytes += event.BytesAllocated;
+        break;
+      case ProfilerType::EventCategory::WorkUnit:
+        TEST_EXPECT_TRUE( event.Source == abs.GetPointer() );
+        workUnitPixels += event.NumberOfPixels;
+        break;
+      case ProfilerType::EventCategory::StreamingPiece:
+        TEST_EXPECT_TRUE( event.Source == streamer.GetPointer() );
+        TEST_EXPECT_EQUAL( event.Piece, pieces );
+        ++pieces;
+        break;
+      }
+    }
+
+  // The filter upstream of the streamer runs once per piece and its work
+  // units cover the whole image. The output buffer is reused between pieces
+  // of equal size, so only the first allocation is guaranteed.
+  TEST_EXPECT_EQUAL( pieces, numberOfStreamDivisions );
+  TEST_EXPECT_EQUAL( generateData, numberOfStreamDivisions );
+  TEST_EXPECT_TRUE( workUnits >= numberOfStreamDivisions );
+  TEST_EXPECT_EQUAL( workUnitPixels, image->GetBufferedRegion().GetNumberOfPixels() );
+  TEST_EXPECT_TRUE( bytes >= image->GetBufferedRegion().GetNumberOfPixels() / numberOfStreamDivisions * sizeof( short ) );
+
+  std::ostringstream trace;
+  profiler->WriteChromeTrace( trace );
+  std::cout << trace.str();
+  TEST_EXPECT_TRUE( trace.str().find( "{\"traceEvents\":[" ) == 0 );
+  TEST_EXPECT_TRUE( trace.str().find( "\"cat\":\"WorkUnit\"" ) != std::string::npos );
+  TEST_EXPECT_TRUE( trace.str().find( "\"cat\":\"StreamingPiece\"" ) != std::string::npos );
+
+  std::ostringstream summary;
+  profiler->WriteJSON( summary );
+  std::cout << summary.str();
+  TEST_EXPECT_TRUE( summary.str().find( "\"name\":\"AbsImageFilter (abs)\",\"executions\":4" ) != std::string::npos );
+  TEST_EXPECT_TRUE( summary.str().find( "\"streamingPieces\":4" ) != std::string::npos );
+
+  // Nothing is recorded once disabled.
+  abs->Modified();
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_EQUAL( profiler->GetEvents().size(), events.size() );
+
+  profiler->Clear();
+  TEST_EXPECT_EQUAL( profiler->GetEvents().size(), 0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
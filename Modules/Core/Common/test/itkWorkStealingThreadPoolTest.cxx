@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingMultiThreader.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+#include <atomic>
+#include <vector>
+
+// Every outer work item starts a nested parallel loop on the same pool. With
+// a pool which blocks waiting threads this deadlocks as soon as all workers
+// wait for nested work, so the test completing is the main check.
+int itkWorkStealingThreadPoolTest(int argc, char* argv[])
+{
+  unsigned int numberOfWorkUnits = 8;
+  if( argc > 1 )
+    {
+    numberOfWorkUnits = static_cast< unsigned int >( std::stoi( argv[1] ) );
+    }
+
+  itk::WorkStealingMultiThreader::Pointer threader = itk::WorkStealingMultiThreader::New();
+  EXERCISE_BASIC_OBJECT_METHODS( threader, WorkStealingMultiThreader, MultiThreaderBase );
+  threader->SetNumberOfWorkUnits( numberOfWorkUnits );
+
+  itk::WorkStealingThreadPool::Pointer pool = itk::WorkStealingThreadPool::GetInstance();
+  TEST_EXPECT_TRUE( pool == itk::WorkStealingThreadPool::New() );
+  TEST_EXPECT_TRUE( pool->GetMaximumNumberOfThreads() >= 1 );
+  TEST_EXPECT_TRUE( !itk::WorkStealingThreadPool::IsWorkerThread() );
+
+  constexpr itk::SizeValueType outerSize = 64;
+  constexpr itk::SizeValueType innerSize = 257;
+  std::vector< std::atomic< itk::SizeValueType > > sums( outerSize );
+  for ( auto & sum : sums )
+    {
+    sum = 0;
+    }
+
+  itk::TimeProbe timeProbe;
+  timeProbe.Start();
+  threader->ParallelizeArray( 0, outerSize,
+    [&sums, numberOfWorkUnits]( itk::SizeValueType i )
+    {
+      itk::WorkStealingMultiThreader::Pointer nestedThreader = itk::WorkStealingMultiThreader::New();
+      nestedThreader->SetNumberOfWorkUnits( numberOfWorkUnits );
+      nestedThreader->ParallelizeArray( 0, innerSize,
+        [&sums, i]( itk::SizeValueType j )
+        {
+          sums[i] += j;
+        },
+        nullptr );
+    },
+    nullptr );
+  timeProbe.Stop();
+  std::cout << "Nested ParallelizeArray: " << timeProbe.GetMean() << timeProbe.GetUnit() << std::endl;
+
+  const itk::SizeValueType expectedSum = innerSize * ( innerSize - 1 ) / 2;
+  for ( itk::SizeValueType i = 0; i < outerSize; ++i )
+    {
+    if ( sums[i] != expectedSum )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Error in nested sum " << i << ": expected " << expectedSum
+                << ", but got " << sums[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Nested region parallelism
+  using RegionType = itk::ImageRegion< 2 >;
+  RegionType::SizeType regionSize = { { 31, 17 } };
+  RegionType region( regionSize );
+  std::atomic< itk::SizeValueType > pixelCount( 0 );
+  itk::MultiThreaderBase * baseThreader = threader;
+  baseThreader->ParallelizeImageRegion< 2 >( region,
+    [&pixelCount, numberOfWorkUnits]( const RegionType & outerRegion )
+    {
+      itk::MultiThreaderBase::Pointer nestedThreader = itk::WorkStealingMultiThreader::New().GetPointer();
+      nestedThreader->SetNumberOfWorkUnits( numberOfWorkUnits );
+      nestedThreader->ParallelizeImageRegion< 2 >( outerRegion,
+        [&pixelCount]( const RegionType & innerRegion )
+        {
+          pixelCount += innerRegion.GetNumberOfPixels();
+        },
+        nullptr );
+    },
+    nullptr );
+  TEST_EXPECT_EQUAL( pixelCount.load(), region.GetNumberOfPixels() );
+
+  // Exceptions thrown by a work unit are propagated to the calling thread
+  TRY_EXPECT_EXCEPTION( threader->ParallelizeArray( 0, outerSize,
+    []( itk::SizeValueType i )
+    {
+      if ( i == outerSize / 2 )
+        {
+        itkGenericExceptionMacro( "Work item " << i << " failed" );
+        }
+    },
+    nullptr ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
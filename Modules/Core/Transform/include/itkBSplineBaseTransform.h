@@ -19,6 +19,7 @@
 #define itkBSplineBaseTransform_h
 
 #include <iostream>
+#include <vector>
 #include "itkTransform.h"
 #include "itkImage.h"
 #include "itkBSplineInterpolationWeightFunction.h"
@@ -279,6 +280,30 @@ public:
 
   void ComputeJacobianWithRespectToParameters( const InputPointType &, JacobianType & ) const override = 0;
 
+  /** Mapped points and sparse Jacobians with respect to the parameters of a
+   * block of points, stored as structure of arrays. With \c W the number of
+   * weights, the Jacobian of point \c i is nonzero only in the columns
+   * ParameterIndices[i*W+k] + d * GetNumberOfParametersPerDimension(), where
+   * row \c d equals Weights[i*W+k]. Points whose support is not inside the
+   * grid are mapped to themselves, have Inside[i] == 0 and a zero Jacobian.
+   * The containers are reused between calls. */
+  struct SparseJacobianBlockType
+    {
+    unsigned int                                       NumberOfWeights{ 0 };
+    std::vector< OutputPointType >                     OutputPoints;
+    std::vector< unsigned char >                       Inside;
+    std::vector< typename WeightsType::ValueType >     Weights;
+    std::vector< typename ParameterIndexArrayType::ValueType > ParameterIndices;
+    };
+
+  /** Transform a block of points and compute their sparse Jacobians with
+   * respect to the parameters in one call. The interpolation weights of
+   * each point are computed once and shared between the mapped point and
+   * the Jacobian. The results are identical to those of TransformPoint and
+   * ComputeJacobianWithRespectToParameters. This method is thread safe. */
+  void TransformPointsAndJacobians( const InputPointType * inputPoints, SizeValueType numberOfPoints,
+                                    SparseJacobianBlockType & block ) const;
+
   void ComputeJacobianWithRespectToPosition( const InputPointType &, JacobianPositionType & ) const override
   {
     itkExceptionMacro( << "ComputeJacobianWithRespectToPosition not yet implemented "
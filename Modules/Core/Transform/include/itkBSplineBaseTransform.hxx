@@ -21,6 +21,7 @@
 #include "itkBSplineBaseTransform.h"
 
 #include "itkContinuousIndex.h"
+#include <algorithm>
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 
@@ -344,5 +345,104 @@ BSplineBaseTransform<TParametersValueType, NDimensions, VSplineOrder>
   return outputPoint;
 }
 
+template<typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineBaseTransform<TParametersValueType, NDimensions, VSplineOrder>
+::TransformPointsAndJacobians( const InputPointType * inputPoints, SizeValueType numberOfPoints,
+                               SparseJacobianBlockType & block ) const
+{
+  const unsigned int numberOfWeights = this->m_WeightsFunction->GetNumberOfWeights();
+
+  block.NumberOfWeights = numberOfWeights;
+  block.OutputPoints.resize( numberOfPoints );
+  block.Inside.resize( numberOfPoints );
+  block.Weights.resize( numberOfPoints * numberOfWeights );
+  block.ParameterIndices.resize( numberOfPoints * numberOfWeights );
+
+  const ImageType * coefficientImage = this->m_CoefficientImages[0];
+  if( !coefficientImage->GetBufferPointer() )
+    {
+    itkWarningMacro( "B-spline coefficients have not been set" );
+    std::copy( inputPoints, inputPoints + numberOfPoints, block.OutputPoints.begin() );
+    std::fill( block.Inside.begin(), block.Inside.end(), 0 );
+    return;
+    }
+
+  // Offsets of the support region, relative to its first coefficient, in
+  // the order used by the weights function.
+  const RegionType & gridRegion = coefficientImage->GetLargestPossibleRegion();
+  const typename ImageType::OffsetValueType * offsetTable = coefficientImage->GetOffsetTable();
+  std::vector< OffsetValueType > supportOffsets( numberOfWeights );
+    {
+    SizeType supportSize;
+    supportSize.Fill( SplineOrder + 1 );
+    IndexType supportIndex;
+    for( unsigned int k = 0; k < numberOfWeights; ++k )
+      {
+      OffsetValueType offset = 0;
+      OffsetValueType remainder = k;
+      for( unsigned int d = 0; d < SpaceDimension; ++d )
+        {
+        supportIndex[d] = remainder % supportSize[d];
+        remainder /= supportSize[d];
+        offset += supportIndex[d] * offsetTable[d];
+        }
+      supportOffsets[k] = offset;
+      }
+    }
+
+  const ParametersValueType * coefficients[SpaceDimension];
+  for( unsigned int d = 0; d < SpaceDimension; ++d )
+    {
+    coefficients[d] = this->m_CoefficientImages[d]->GetBufferPointer();
+    }
+
+  WeightsType weights;
+  for( SizeValueType i = 0; i < numberOfPoints; ++i )
+    {
+    const InputPointType & point = inputPoints[i];
+    OutputPointType &      outputPoint = block.OutputPoints[i];
+
+    ContinuousIndexType index;
+    coefficientImage->TransformPhysicalPointToContinuousIndex( point, index );
+
+    // NOTE: if the support region does not lie totally within the grid
+    // we assume zero displacement and return the input point
+    if( !this->InsideValidRegion( index ) )
+      {
+      outputPoint = point;
+      block.Inside[i] = 0;
+      continue;
+      }
+    block.Inside[i] = 1;
+
+    // Compute the interpolation weights directly into the block.
+    weights.SetData( &block.Weights[i * numberOfWeights], numberOfWeights, false );
+    IndexType supportIndex;
+    this->m_WeightsFunction->Evaluate( index, weights, supportIndex );
+
+    OffsetValueType supportStart = 0;
+    for( unsigned int d = 0; d < SpaceDimension; ++d )
+      {
+      supportStart += ( supportIndex[d] - gridRegion.GetIndex()[d] ) * offsetTable[d];
+      }
+
+    outputPoint.Fill( NumericTraits<ScalarType>::ZeroValue() );
+    for( unsigned int k = 0; k < numberOfWeights; ++k )
+      {
+      const OffsetValueType coefficientIndex = supportStart + supportOffsets[k];
+      for( unsigned int d = 0; d < SpaceDimension; ++d )
+        {
+        outputPoint[d] += static_cast<ScalarType>( weights[k] * coefficients[d][coefficientIndex] );
+        }
+      block.ParameterIndices[i * numberOfWeights + k] = coefficientIndex;
+      }
+    for( unsigned int d = 0; d < SpaceDimension; ++d )
+      {
+      outputPoint[d] += point[d];
+      }
+    }
+}
+
 } // namespace
 #endif
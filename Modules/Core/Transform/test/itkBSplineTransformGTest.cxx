@@ -18,8 +18,10 @@
 
 #include "itkGTest.h"
 #include "itkBSplineTransform.h"
+#include "itkBSplineDeformableTransform.h"
 
 #include "itkImageRegionConstIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 
 namespace {
 
@@ -78,6 +80,99 @@ void bspline_eq( const itk::BSplineTransform<TParametersValueType, NDimensions,
     }
 }
 
+
+// Method which checks that TransformPointsAndJacobians gives exactly the
+// mapped points and Jacobians of TransformPoint and
+// ComputeJacobianWithRespectToParameters, for points inside and outside
+// the grid.
+template<typename TBSplineTransform>
+void bspline_block_eq( const TBSplineTransform * bspline, const std::string & description = "" )
+{
+  using InputPointType = typename TBSplineTransform::InputPointType;
+  using JacobianType = typename TBSplineTransform::JacobianType;
+  constexpr unsigned int Dimension = TBSplineTransform::SpaceDimension;
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 42 );
+
+  const auto coefficientImage = bspline->GetCoefficientImages()[0];
+  const auto gridSize = coefficientImage->GetLargestPossibleRegion().GetSize();
+
+  std::vector<InputPointType> points( 200 );
+  for( auto & point : points )
+    {
+    itk::ContinuousIndex<double, Dimension> index;
+    for( unsigned int d = 0; d < Dimension; ++d )
+      {
+      // Include some points outside of the valid region.
+      index[d] = generator->GetUniformVariate( -1.0, gridSize[d] );
+      }
+    coefficientImage->TransformContinuousIndexToPhysicalPoint( index, point );
+    }
+
+  typename TBSplineTransform::SparseJacobianBlockType block;
+  bspline->TransformPointsAndJacobians( points.data(), points.size(), block );
+
+  const unsigned int numberOfWeights = bspline->GetNumberOfWeights();
+  ASSERT_EQ( block.NumberOfWeights, numberOfWeights ) << description;
+  ASSERT_EQ( block.OutputPoints.size(), points.size() ) << description;
+
+  unsigned int numberOfInsidePoints = 0;
+  JacobianType jacobian;
+  for( size_t i = 0; i < points.size(); ++i )
+    {
+    EXPECT_EQ( block.OutputPoints[i], bspline->TransformPoint( points[i] ) ) << description << " point " << i;
+
+    bspline->ComputeJacobianWithRespectToParameters( points[i], jacobian );
+    JacobianType sparseJacobian( Dimension, bspline->GetNumberOfParameters() );
+    sparseJacobian.Fill( 0.0 );
+    if( block.Inside[i] )
+      {
+      ++numberOfInsidePoints;
+      for( unsigned int k = 0; k < numberOfWeights; ++k )
+        {
+        for( unsigned int d = 0; d < Dimension; ++d )
+          {
+          sparseJacobian( d, block.ParameterIndices[i * numberOfWeights + k]
+                          + d * bspline->GetNumberOfParametersPerDimension() ) = block.Weights[i * numberOfWeights + k];
+          }
+        }
+      }
+    EXPECT_EQ( sparseJacobian, jacobian ) << description << " point " << i;
+    }
+  EXPECT_GT( numberOfInsidePoints, 0u ) << description;
+  EXPECT_LT( numberOfInsidePoints, points.size() ) << description;
+}
+
+
+template<typename TBSplineTransform>
+typename TBSplineTransform::Pointer make_random_bspline( typename TBSplineTransform::MeshSizeType meshSize )
+{
+  typename TBSplineTransform::Pointer bspline = TBSplineTransform::New();
+  typename TBSplineTransform::PhysicalDimensionsType dimensions;
+  typename TBSplineTransform::OriginType origin;
+  for( unsigned int d = 0; d < TBSplineTransform::SpaceDimension; ++d )
+    {
+    dimensions[d] = 10.0 + d;
+    origin[d] = -2.0 * d;
+    }
+  bspline->SetTransformDomainOrigin( origin );
+  bspline->SetTransformDomainPhysicalDimensions( dimensions );
+  bspline->SetTransformDomainMeshSize( meshSize );
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 7 );
+  typename TBSplineTransform::ParametersType parameters( bspline->GetNumberOfParameters() );
+  for( unsigned int p = 0; p < parameters.Size(); ++p )
+    {
+    parameters[p] = generator->GetUniformVariate( -1.0, 1.0 );
+    }
+  bspline->SetParametersByValue( parameters );
+  return bspline;
+}
+
 }
 
 TEST(ITKBSplineTransform, Construction) {
@@ -176,3 +271,38 @@ TEST(ITKBSplineTransform, Copying_Clone) {
   bspline2 = bspline1->Clone();
   bspline_eq(bspline1.GetPointer(), bspline2.GetPointer(), "Clone");
 }
+
+TEST(ITKBSplineTransform, TransformPointsAndJacobians) {
+
+  using BSpline2DType = itk::BSplineTransform<double, 2, 3>;
+  BSpline2DType::MeshSizeType meshSize2D;
+  meshSize2D[0] = 5;
+  meshSize2D[1] = 4;
+  const BSpline2DType::Pointer bspline2D = make_random_bspline<BSpline2DType>( meshSize2D );
+  bspline_block_eq( bspline2D.GetPointer(), "2D cubic" );
+
+  using BSpline3DType = itk::BSplineTransform<float, 3, 2>;
+  BSpline3DType::MeshSizeType meshSize3D;
+  meshSize3D.Fill( 3 );
+  const BSpline3DType::Pointer bspline3D = make_random_bspline<BSpline3DType>( meshSize3D );
+  bspline_block_eq( bspline3D.GetPointer(), "3D quadratic" );
+
+  // BSplineDeformableTransform is defined directly on its coefficient grid.
+  using DeformableType = itk::BSplineDeformableTransform<double, 3, 3>;
+  DeformableType::Pointer deformable = DeformableType::New();
+  DeformableType::RegionType::SizeType gridSize;
+  gridSize[0] = 7;
+  gridSize[1] = 6;
+  gridSize[2] = 8;
+  deformable->SetGridRegion( DeformableType::RegionType( gridSize ) );
+  DeformableType::SpacingType gridSpacing;
+  gridSpacing.Fill( 1.5 );
+  deformable->SetGridSpacing( gridSpacing );
+  DeformableType::ParametersType parameters( deformable->GetNumberOfParameters() );
+  for( unsigned int p = 0; p < parameters.Size(); ++p )
+    {
+    parameters[p] = std::sin( 0.1 * p );
+    }
+  deformable->SetParametersByValue( parameters );
+  bspline_block_eq( deformable.GetPointer(), "3D deformable" );
+}
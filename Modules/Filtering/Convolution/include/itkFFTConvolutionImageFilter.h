@@ -20,6 +20,7 @@
 
 #include "itkConvolutionImageFilterBase.h"
 
+#include "itkFFTKernelSpectrumCache.h"
 #include "itkProgressAccumulator.h"
 #include "itkHalfHermitianToRealInverseFFTImageFilter.h"
 #include "itkRealToHalfHermitianForwardFFTImageFilter.h"
@@ -36,6 +37,17 @@ namespace itk
  * convolution theorem to accelerate the convolution computation when
  * the kernel is large.
  *
+ * By default the padded input and kernel are transformed as a whole,
+ * which needs complex buffers several times the size of the input.
+ * When a BlockSize is set, the output is instead computed block by
+ * block with the overlap-save method: each block of the input,
+ * extended by the kernel support, is transformed with an FFT size that
+ * only depends on the block and kernel sizes, multiplied with a kernel
+ * spectrum computed once, and transformed back. The blocks are
+ * processed in parallel, only the input region needed for the output
+ * requested region is requested, so the filter streams, and the peak
+ * memory is bounded by the block size rather than the image size.
+ *
  * \warning This filter ignores the spacing, origin, and orientation
  * of the kernel image and treats them as identical to those in the
  * input image.
@@ -105,6 +117,25 @@ public:
   itkSetMacro(SizeGreatestPrimeFactor, SizeValueType);
   itkGetMacro(SizeGreatestPrimeFactor, SizeValueType);
 
+  /** Set/Get the size of the output blocks convolved independently.
+   * A zero component makes the blocks span the whole output requested
+   * region along that dimension. Blocks are enlarged to fill the FFT
+   * size they require. Defaults to zero in all dimensions, i.e. the
+   * whole image is transformed at once. */
+  itkSetMacro(BlockSize, OutputSizeType);
+  itkGetConstReferenceMacro(BlockSize, OutputSizeType);
+
+  /** Type of the process wide cache of transformed kernels. */
+  using KernelSpectrumCacheType = FFTKernelSpectrumCache< InternalComplexImageType >;
+
+  /** Set/Get whether the padded and transformed kernel is looked up in,
+   * and added to, the KernelSpectrumCacheType instance. When the same
+   * kernel is applied to many images, it is then transformed once per
+   * padded size instead of on every update. Defaults to off. */
+  itkSetMacro(UseKernelSpectrumCache, bool);
+  itkGetConstMacro(UseKernelSpectrumCache, bool);
+  itkBooleanMacro(UseKernelSpectrumCache);
+
 protected:
   FFTConvolutionImageFilter();
   ~FFTConvolutionImageFilter() override = default;
@@ -128,6 +159,22 @@ protected:
   /** This filter uses a minipipeline to compute the output. */
   void GenerateData() override;
 
+  /** Compute the output requested region block by block with the
+   * overlap-save method. */
+  void GenerateDataInBlocks();
+
+  /** Return whether the filter computes its output block by block,
+   * i.e. whether a BlockSize is set and the filter supports it. */
+  bool GetProcessInBlocks() const;
+
+  /** Return whether the filter can compute its output block by block.
+   * Subclasses that need the whole image in the Fourier domain, like
+   * the deconvolution filters, return false. */
+  virtual bool CanProcessInBlocks() const
+    {
+    return true;
+    }
+
   /** Prepare the input images for operations in the Fourier
    * domain. This includes resizing the input and kernel images,
    * normalizing the kernel if requested, shifting the kernel, and
@@ -161,6 +208,15 @@ protected:
                      InternalComplexImagePointerType & preparedKernel,
                      ProgressAccumulator * progress, float progressWeight);
 
+  /** Normalize the kernel if requested, pad it with zeros to padSize,
+   * shift its center to the origin and take its Fourier transform. The
+   * result comes from the kernel spectrum cache if it is used, and must
+   * not be modified. */
+  void TransformKernel(const KernelImageType * kernel,
+                       const InputSizeType & padSize,
+                       InternalComplexImagePointerType & transformedKernel,
+                       ProgressAccumulator * progress, float progressWeight);
+
   /** Produce output from the final Fourier domain image. */
   void ProduceOutput(InternalComplexImageType * paddedOutput,
                      ProgressAccumulator * progress,
@@ -188,7 +244,9 @@ protected:
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
-  SizeValueType m_SizeGreatestPrimeFactor;
+  SizeValueType  m_SizeGreatestPrimeFactor;
+  OutputSizeType m_BlockSize;
+  bool           m_UseKernelSpectrumCache{ false };
 };
 }
 
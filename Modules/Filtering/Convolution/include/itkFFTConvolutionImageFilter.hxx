@@ -27,10 +27,18 @@
 #include "itkCyclicShiftImageFilter.h"
 #include "itkExtractImageFilter.h"
 #include "itkImageBase.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkNormalizeToConstantImageFilter.h"
+#include "itkPlatformMultiThreader.h"
 #include "itkMath.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+
 namespace itk
 {
 
@@ -39,6 +47,26 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 ::FFTConvolutionImageFilter()
 {
   m_SizeGreatestPrimeFactor = FFTFilterType::New()->GetSizeGreatestPrimeFactor();
+  m_BlockSize.Fill( 0 );
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+bool
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GetProcessInBlocks() const
+{
+  if ( !this->CanProcessInBlocks() )
+    {
+    return false;
+    }
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    if ( m_BlockSize[i] > 0 )
+      {
+      return true;
+      }
+    }
+  return false;
 }
 
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
@@ -46,6 +74,32 @@ void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
 ::GenerateInputRequestedRegion()
 {
+  if ( this->GetInput() && this->GetKernelImage() && this->GetProcessInBlocks() )
+    {
+    // Only the output requested region extended by the kernel support
+    // is needed. The boundary condition decides which part of that
+    // region must be read from the input.
+    typename InputImageType::Pointer imagePtr =
+      const_cast< InputImageType * >( this->GetInput() );
+    const OutputRegionType outputRegion = this->GetOutput()->GetRequestedRegion();
+    const KernelSizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+
+    InputRegionType inputRegion;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+      const SizeValueType lowerRadius = kernelSize[i] - 1 - kernelSize[i] / 2;
+      inputRegion.SetIndex( i, outputRegion.GetIndex( i ) - static_cast< IndexValueType >( lowerRadius ) );
+      inputRegion.SetSize( i, outputRegion.GetSize( i ) + kernelSize[i] - 1 );
+      }
+    imagePtr->SetRequestedRegion( this->GetBoundaryCondition()->
+      GetInputRequestedRegion( imagePtr->GetLargestPossibleRegion(), inputRegion ) );
+
+    typename KernelImageType::Pointer kernelPtr =
+      const_cast< KernelImageType * >( this->GetKernelImage() );
+    kernelPtr->SetRequestedRegionToLargestPossibleRegion();
+    return;
+    }
+
   // Request the largest possible region for both input images.
   if ( this->GetInput() )
     {
@@ -69,6 +123,12 @@ void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
 ::GenerateData()
 {
+  if ( this->GetProcessInBlocks() )
+    {
+    this->GenerateDataInBlocks();
+    return;
+    }
+
   // Create a process accumulator for tracking the progress of this minipipeline
   ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter( this );
@@ -98,6 +158,207 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
   this->ProduceOutput( multiplyFilter->GetOutput(), progress, 0.2 );
 }
 
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GenerateDataInBlocks()
+{
+  this->AllocateOutputs();
+
+  const InputImageType * input = this->GetInput();
+  const KernelImageType * kernel = this->GetKernelImage();
+  OutputImageType * output = this->GetOutput();
+  const OutputRegionType outputRegion = output->GetRequestedRegion();
+  const InputRegionType inputLargestRegion = input->GetLargestPossibleRegion();
+  const KernelSizeType kernelSize = kernel->GetLargestPossibleRegion().GetSize();
+  if ( outputRegion.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  // Smallest FFT size, not below the given size, whose prime factors
+  // are supported by the FFT implementation.
+  auto fftSizeFor = [this]( SizeValueType size )
+    {
+    if ( m_SizeGreatestPrimeFactor > 1 )
+      {
+      while ( Math::GreatestPrimeFactor( size ) > m_SizeGreatestPrimeFactor )
+        {
+        size++;
+        }
+      }
+    return size;
+    };
+
+  // A block and the kernel support must fit in the FFT size without
+  // wrapping around. The blocks are enlarged to use the whole FFT.
+  OutputSizeType blockSize;
+  InputSizeType fftSize;
+  InputSizeType lowerRadius;
+  OutputSizeType blocksPerDimension;
+  SizeValueType numberOfBlocks = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    const SizeValueType regionSize = outputRegion.GetSize( i );
+    blockSize[i] = ( m_BlockSize[i] > 0 ) ? std::min( m_BlockSize[i], regionSize ) : regionSize;
+    fftSize[i] = fftSizeFor( blockSize[i] + kernelSize[i] - 1 );
+    blockSize[i] = fftSize[i] - kernelSize[i] + 1;
+    if ( blockSize[i] >= regionSize )
+      {
+      blockSize[i] = regionSize;
+      fftSize[i] = fftSizeFor( blockSize[i] + kernelSize[i] - 1 );
+      }
+    lowerRadius[i] = kernelSize[i] - 1 - kernelSize[i] / 2;
+    blocksPerDimension[i] = ( regionSize + blockSize[i] - 1 ) / blockSize[i];
+    numberOfBlocks *= blocksPerDimension[i];
+    }
+
+  // The kernel spectrum is shared by all the blocks.
+  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+  InternalComplexImagePointerType kernelSpectrum;
+  this->TransformKernel( kernel, fftSize, kernelSpectrum, progress, 0.1f );
+  const InternalComplexType * kernelBuffer = kernelSpectrum->GetBufferPointer();
+
+  // The blocks are distributed over platform threads so that the pool
+  // stays available to the FFT filters. The work units are split
+  // between the blocks and the FFTs of each block.
+  const auto numberOfThreads = static_cast< ThreadIdType >(
+    std::max< SizeValueType >( 1, std::min< SizeValueType >( this->GetNumberOfWorkUnits(), numberOfBlocks ) ) );
+  const ThreadIdType fftWorkUnits = std::max< ThreadIdType >( 1, this->GetNumberOfWorkUnits() / numberOfThreads );
+  const BoundaryConditionPointerType boundaryCondition = this->GetBoundaryCondition();
+  std::atomic< SizeValueType > nextBlock( 0 );
+  std::atomic< SizeValueType > completedBlocks( 0 );
+  std::exception_ptr exception;
+  std::mutex exceptionMutex;
+
+  auto convolveBlocks = [&]( SizeValueType threadId )
+    {
+    try
+      {
+      typename InternalImageType::RegionType fftRegion;
+      fftRegion.SetSize( fftSize );
+      InternalImagePointerType blockImage = InternalImageType::New();
+      blockImage->SetRegions( fftRegion );
+      blockImage->Allocate();
+
+      typename FFTFilterType::Pointer fftFilter = FFTFilterType::New();
+      fftFilter->SetNumberOfWorkUnits( fftWorkUnits );
+      fftFilter->SetInput( blockImage );
+
+      typename IFFTFilterType::Pointer ifftFilter = IFFTFilterType::New();
+      ifftFilter->SetActualXDimensionIsOdd( fftSize[0] % 2 != 0 );
+      ifftFilter->SetNumberOfWorkUnits( fftWorkUnits );
+      ifftFilter->SetInput( fftFilter->GetOutput() );
+
+      for ( SizeValueType block = nextBlock++; block < numberOfBlocks; block = nextBlock++ )
+        {
+        // Output region of the block and input region it depends on.
+        OutputRegionType blockRegion;
+        InputRegionType extendedRegion;
+        SizeValueType remainder = block;
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+          const SizeValueType position = ( remainder % blocksPerDimension[i] ) * blockSize[i];
+          remainder /= blocksPerDimension[i];
+          blockRegion.SetIndex( i, outputRegion.GetIndex( i ) + static_cast< IndexValueType >( position ) );
+          blockRegion.SetSize( i, std::min( blockSize[i], outputRegion.GetSize( i ) - position ) );
+          extendedRegion.SetIndex( i, blockRegion.GetIndex( i ) - static_cast< IndexValueType >( lowerRadius[i] ) );
+          extendedRegion.SetSize( i, blockRegion.GetSize( i ) + kernelSize[i] - 1 );
+          }
+
+        // Copy the extended region to the start of the FFT buffer, the
+        // rest of the buffer is zero.
+        blockImage->FillBuffer( NumericTraits< TInternalPrecision >::ZeroValue() );
+        InputRegionType insideRegion = extendedRegion;
+        if ( insideRegion.Crop( inputLargestRegion ) )
+          {
+          typename InternalImageType::RegionType bufferRegion( insideRegion.GetSize() );
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+            {
+            bufferRegion.SetIndex( i, insideRegion.GetIndex( i ) - extendedRegion.GetIndex( i ) );
+            }
+          ImageRegionConstIterator< InputImageType > inIt( input, insideRegion );
+          ImageRegionIterator< InternalImageType > bufferIt( blockImage, bufferRegion );
+          for ( ; !inIt.IsAtEnd(); ++inIt, ++bufferIt )
+            {
+            bufferIt.Set( static_cast< TInternalPrecision >( inIt.Get() ) );
+            }
+          }
+        if ( !inputLargestRegion.IsInside( extendedRegion ) )
+          {
+          typename InternalImageType::RegionType bufferRegion( extendedRegion.GetSize() );
+          ImageRegionIteratorWithIndex< InternalImageType > bufferIt( blockImage, bufferRegion );
+          for ( ; !bufferIt.IsAtEnd(); ++bufferIt )
+            {
+            const InputIndexType index = extendedRegion.GetIndex() + ( bufferIt.GetIndex() - bufferRegion.GetIndex() );
+            if ( !inputLargestRegion.IsInside( index ) )
+              {
+              bufferIt.Set( static_cast< TInternalPrecision >( boundaryCondition->GetPixel( index, input ) ) );
+              }
+            }
+          }
+        blockImage->Modified();
+
+        // Multiply with the kernel spectrum and transform back.
+        fftFilter->Update();
+        InternalComplexImageType * blockSpectrum = fftFilter->GetOutput();
+        InternalComplexType * spectrumBuffer = blockSpectrum->GetBufferPointer();
+        const SizeValueType numberOfFrequencies = blockSpectrum->GetBufferedRegion().GetNumberOfPixels();
+        for ( SizeValueType j = 0; j < numberOfFrequencies; ++j )
+          {
+          spectrumBuffer[j] *= kernelBuffer[j];
+          }
+        ifftFilter->Update();
+
+        // The block output starts at the lower kernel radius.
+        const InternalImageType * blockOutput = ifftFilter->GetOutput();
+        typename InternalImageType::RegionType validRegion( blockRegion.GetSize() );
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+          validRegion.SetIndex( i, blockOutput->GetLargestPossibleRegion().GetIndex( i )
+                                   + static_cast< IndexValueType >( lowerRadius[i] ) );
+          }
+        ImageRegionConstIterator< InternalImageType > validIt( blockOutput, validRegion );
+        ImageRegionIterator< OutputImageType > outIt( output, blockRegion );
+        for ( ; !outIt.IsAtEnd(); ++validIt, ++outIt )
+          {
+          outIt.Set( static_cast< OutputPixelType >( validIt.Get() ) );
+          }
+
+        const SizeValueType completed = ++completedBlocks;
+        if ( threadId == 0 )
+          {
+          this->UpdateProgress( 0.1f + 0.9f * static_cast< float >( completed ) / numberOfBlocks );
+          }
+        }
+      }
+    catch ( ... )
+      {
+      std::lock_guard< std::mutex > lock( exceptionMutex );
+      if ( !exception )
+        {
+        exception = std::current_exception();
+        }
+      }
+    };
+
+  if ( numberOfThreads == 1 )
+    {
+    convolveBlocks( 0 );
+    }
+  else
+    {
+    PlatformMultiThreader::Pointer threader = PlatformMultiThreader::New();
+    threader->SetNumberOfWorkUnits( numberOfThreads );
+    threader->ParallelizeArray( 0, numberOfThreads, convolveBlocks, nullptr );
+    }
+  if ( exception )
+    {
+    std::rethrow_exception( exception );
+    }
+}
+
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
 void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
@@ -205,10 +466,59 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
                 InternalComplexImagePointerType & preparedKernel,
                 ProgressAccumulator * progress, float progressWeight)
 {
+  InternalComplexImagePointerType transformedKernel;
+  this->TransformKernel( kernel, this->GetPadSize(), transformedKernel,
+                         progress, 0.999f * progressWeight );
+
+  using InfoFilterType = ChangeInformationImageFilter< InternalComplexImageType >;
+  typename InfoFilterType::Pointer kernelInfoFilter = InfoFilterType::New();
+  kernelInfoFilter->ChangeRegionOn();
+
+  using InfoOffsetValueType = typename InfoFilterType::OutputImageOffsetValueType;
+  const InputSizeType & inputLowerBound = this->GetPadLowerBound();
+  const InputIndexType & inputIndex = this->GetInput()->GetLargestPossibleRegion().GetIndex();
+  const KernelIndexType & kernelIndex = kernel->GetLargestPossibleRegion().GetIndex();
+  InfoOffsetValueType kernelOffset[ImageDimension];
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    kernelOffset[i] = static_cast< InfoOffsetValueType >( inputIndex[i] - inputLowerBound[i] - kernelIndex[i] );
+    }
+  kernelInfoFilter->SetOutputOffset( kernelOffset );
+  kernelInfoFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  kernelInfoFilter->SetInput( transformedKernel );
+  progress->RegisterInternalFilter( kernelInfoFilter, 0.001f * progressWeight );
+  kernelInfoFilter->Update();
+
+  preparedKernel = kernelInfoFilter->GetOutput();
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::TransformKernel(const KernelImageType * kernel,
+                  const InputSizeType & padSize,
+                  InternalComplexImagePointerType & transformedKernel,
+                  ProgressAccumulator * progress, float progressWeight)
+{
+  const ModifiedTimeType kernelMTime = kernel->GetMTime();
+  typename InternalComplexImageType::SizeType spectrumPadSize;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+    spectrumPadSize[i] = padSize[i];
+    }
+  if ( m_UseKernelSpectrumCache )
+    {
+    transformedKernel = KernelSpectrumCacheType::GetInstance()->
+      Find( kernel, kernelMTime, spectrumPadSize, this->GetNormalize() );
+    if ( transformedKernel )
+      {
+      return;
+      }
+    }
+
   KernelRegionType kernelRegion = kernel->GetLargestPossibleRegion();
   KernelSizeType kernelSize = kernelRegion.GetSize();
 
-  InputSizeType padSize = this->GetPadSize();
   typename KernelImageType::SizeType kernelUpperBound;
   for (unsigned int i = 0; i < ImageDimension; ++i)
     {
@@ -276,29 +586,17 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
   typename FFTFilterType::Pointer kernelFFTFilter = FFTFilterType::New();
   kernelFFTFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
   kernelFFTFilter->SetInput( kernelShifter->GetOutput() );
-  progress->RegisterInternalFilter( kernelFFTFilter, 0.699f * progressWeight );
+  progress->RegisterInternalFilter( kernelFFTFilter, 0.7f * progressWeight );
   kernelFFTFilter->Update();
 
-  using InfoFilterType = ChangeInformationImageFilter< InternalComplexImageType >;
-  typename InfoFilterType::Pointer kernelInfoFilter = InfoFilterType::New();
-  kernelInfoFilter->ChangeRegionOn();
+  transformedKernel = kernelFFTFilter->GetOutput();
+  transformedKernel->DisconnectPipeline();
 
-  using InfoOffsetValueType = typename InfoFilterType::OutputImageOffsetValueType;
-  const InputSizeType & inputLowerBound = this->GetPadLowerBound();
-  const InputIndexType & inputIndex = this->GetInput()->GetLargestPossibleRegion().GetIndex();
-  const KernelIndexType & kernelIndex = kernel->GetLargestPossibleRegion().GetIndex();
-  InfoOffsetValueType kernelOffset[ImageDimension];
-  for (unsigned int i = 0; i < ImageDimension; ++i)
+  if ( m_UseKernelSpectrumCache )
     {
-    kernelOffset[i] = static_cast< InfoOffsetValueType >( inputIndex[i] - inputLowerBound[i] - kernelIndex[i] );
+    KernelSpectrumCacheType::GetInstance()->
+      Insert( kernel, kernelMTime, spectrumPadSize, this->GetNormalize(), transformedKernel );
     }
-  kernelInfoFilter->SetOutputOffset( kernelOffset );
-  kernelInfoFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
-  kernelInfoFilter->SetInput( kernelFFTFilter->GetOutput() );
-  progress->RegisterInternalFilter( kernelInfoFilter, 0.001f * progressWeight );
-  kernelInfoFilter->Update();
-
-  preparedKernel = kernelInfoFilter->GetOutput();
 }
 
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
@@ -425,6 +723,8 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "SizeGreatestPrimeFactor: " << m_SizeGreatestPrimeFactor << std::endl;
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
+  os << indent << "UseKernelSpectrumCache: " << m_UseKernelSpectrumCache << std::endl;
 }
 
 }
@@ -0,0 +1,129 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTKernelSpectrumCache_h
+#define itkFFTKernelSpectrumCache_h
+
+#include "itkObject.h"
+
+#include <list>
+#include <mutex>
+
+namespace itk
+{
+/** \class FFTKernelSpectrumCache
+ * \brief Process wide cache of the Fourier transforms of padded kernels.
+ *
+ * FFTConvolutionImageFilter and the deconvolution filters derived from
+ * it pad, shift and transform their kernel image on every update. When
+ * their UseKernelSpectrumCache flag is on, the transformed kernel is
+ * looked up in this cache first, so a kernel applied to many images is
+ * transformed only once per padded size.
+ *
+ * An entry is identified by the kernel image object, its modification
+ * time, the padded size and whether the kernel was normalized. The
+ * precision is part of the type of the cache, as there is one cache
+ * per complex image type. Entries of modified kernels are replaced,
+ * and the least recently used entries are evicted when the cached
+ * spectra exceed MaximumNumberOfBytes.
+ *
+ * The cached spectra are shared by all the filters that find them and
+ * must not be modified. The cache is thread safe.
+ *
+ * \ingroup ITKConvolution
+ * \sa FFTConvolutionImageFilter
+ */
+template< typename TComplexImage >
+class ITK_TEMPLATE_EXPORT FFTKernelSpectrumCache : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(FFTKernelSpectrumCache);
+
+  /** Standard class type aliases. */
+  using Self = FFTKernelSpectrumCache;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FFTKernelSpectrumCache, Object);
+
+  using ComplexImageType = TComplexImage;
+  using ComplexImagePointer = typename ComplexImageType::Pointer;
+  using SizeType = typename ComplexImageType::SizeType;
+
+  /** Return the instance shared by all the filters using this type of
+   * spectrum. */
+  static Pointer GetInstance();
+
+  /** Return the cached spectrum of the kernel padded to padSize, or
+   * nullptr if there is none for the current modification time of the
+   * kernel. */
+  ComplexImagePointer Find( const Object * kernel, ModifiedTimeType kernelMTime,
+                            const SizeType & padSize, bool normalize );
+
+  /** Add the spectrum of the kernel padded to padSize. It replaces the
+   * spectra computed from older versions of the kernel. */
+  void Insert( const Object * kernel, ModifiedTimeType kernelMTime,
+               const SizeType & padSize, bool normalize, ComplexImageType * spectrum );
+
+  /** Remove all the cached spectra. */
+  void Clear();
+
+  /** Set/Get the maximum memory used by the cached spectra. Spectra
+   * larger than this are not cached. Defaults to 512 MiB. */
+  void SetMaximumNumberOfBytes( SizeValueType maximumNumberOfBytes );
+  SizeValueType GetMaximumNumberOfBytes() const;
+
+  /** Get the number of cached spectra and the memory they use. */
+  SizeValueType GetNumberOfEntries() const;
+  SizeValueType GetNumberOfBytes() const;
+
+protected:
+  FFTKernelSpectrumCache();
+  ~FFTKernelSpectrumCache() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  struct Entry
+  {
+    const Object *      m_Kernel;
+    ModifiedTimeType    m_KernelMTime;
+    SizeType            m_PadSize;
+    bool                m_Normalize;
+    ComplexImagePointer m_Spectrum;
+    SizeValueType       m_NumberOfBytes;
+  };
+
+  /** Evict the least recently used entries until the cached spectra
+   * fit. Expects m_Mutex to be locked. */
+  void Shrink();
+
+  /** Most recently used first. */
+  std::list< Entry >  m_Entries;
+  SizeValueType       m_MaximumNumberOfBytes;
+  SizeValueType       m_NumberOfBytes{ 0 };
+  mutable std::mutex  m_Mutex;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFFTKernelSpectrumCache.hxx"
+#endif
+
+#endif
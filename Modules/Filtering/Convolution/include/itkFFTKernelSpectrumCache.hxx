@@ -0,0 +1,171 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTKernelSpectrumCache_hxx
+#define itkFFTKernelSpectrumCache_hxx
+
+#include "itkFFTKernelSpectrumCache.h"
+
+namespace itk
+{
+
+template< typename TComplexImage >
+FFTKernelSpectrumCache< TComplexImage >
+::FFTKernelSpectrumCache() :
+  m_MaximumNumberOfBytes( 512 * 1024 * 1024 )
+{
+}
+
+template< typename TComplexImage >
+typename FFTKernelSpectrumCache< TComplexImage >::Pointer
+FFTKernelSpectrumCache< TComplexImage >
+::GetInstance()
+{
+  static Pointer instance = []()
+    {
+    Pointer cache = new Self;
+    // Remove extra reference from construction.
+    cache->UnRegister();
+    return cache;
+    }();
+  return instance;
+}
+
+template< typename TComplexImage >
+typename FFTKernelSpectrumCache< TComplexImage >::ComplexImagePointer
+FFTKernelSpectrumCache< TComplexImage >
+::Find( const Object * kernel, ModifiedTimeType kernelMTime,
+        const SizeType & padSize, bool normalize )
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  for ( auto it = m_Entries.begin(); it != m_Entries.end(); ++it )
+    {
+    if ( it->m_Kernel == kernel && it->m_KernelMTime == kernelMTime
+         && it->m_PadSize == padSize && it->m_Normalize == normalize )
+      {
+      m_Entries.splice( m_Entries.begin(), m_Entries, it );
+      return m_Entries.front().m_Spectrum;
+      }
+    }
+  return nullptr;
+}
+
+template< typename TComplexImage >
+void
+FFTKernelSpectrumCache< TComplexImage >
+::Insert( const Object * kernel, ModifiedTimeType kernelMTime,
+          const SizeType & padSize, bool normalize, ComplexImageType * spectrum )
+{
+  const SizeValueType numberOfBytes = spectrum->GetBufferedRegion().GetNumberOfPixels()
+                                      * sizeof( typename ComplexImageType::PixelType );
+
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  for ( auto it = m_Entries.begin(); it != m_Entries.end(); )
+    {
+    if ( it->m_Kernel == kernel && it->m_PadSize == padSize && it->m_Normalize == normalize )
+      {
+      m_NumberOfBytes -= it->m_NumberOfBytes;
+      it = m_Entries.erase( it );
+      }
+    else
+      {
+      ++it;
+      }
+    }
+  if ( numberOfBytes > m_MaximumNumberOfBytes )
+    {
+    return;
+    }
+  m_Entries.push_front( Entry{ kernel, kernelMTime, padSize, normalize, spectrum, numberOfBytes } );
+  m_NumberOfBytes += numberOfBytes;
+  this->Shrink();
+}
+
+template< typename TComplexImage >
+void
+FFTKernelSpectrumCache< TComplexImage >
+::Clear()
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  m_Entries.clear();
+  m_NumberOfBytes = 0;
+}
+
+template< typename TComplexImage >
+void
+FFTKernelSpectrumCache< TComplexImage >
+::SetMaximumNumberOfBytes( SizeValueType maximumNumberOfBytes )
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  m_MaximumNumberOfBytes = maximumNumberOfBytes;
+  this->Shrink();
+}
+
+template< typename TComplexImage >
+SizeValueType
+FFTKernelSpectrumCache< TComplexImage >
+::GetMaximumNumberOfBytes() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return m_MaximumNumberOfBytes;
+}
+
+template< typename TComplexImage >
+SizeValueType
+FFTKernelSpectrumCache< TComplexImage >
+::GetNumberOfEntries() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return static_cast< SizeValueType >( m_Entries.size() );
+}
+
+template< typename TComplexImage >
+SizeValueType
+FFTKernelSpectrumCache< TComplexImage >
+::GetNumberOfBytes() const
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  return m_NumberOfBytes;
+}
+
+template< typename TComplexImage >
+void
+FFTKernelSpectrumCache< TComplexImage >
+::Shrink()
+{
+  while ( m_NumberOfBytes > m_MaximumNumberOfBytes )
+    {
+    m_NumberOfBytes -= m_Entries.back().m_NumberOfBytes;
+    m_Entries.pop_back();
+    }
+}
+
+template< typename TComplexImage >
+void
+FFTKernelSpectrumCache< TComplexImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  os << indent << "MaximumNumberOfBytes: " << m_MaximumNumberOfBytes << std::endl;
+  os << indent << "NumberOfBytes: " << m_NumberOfBytes << std::endl;
+  os << indent << "NumberOfEntries: " << m_Entries.size() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkConstantBoundaryCondition.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image< double, Dimension >;
+using ConvolutionFilterType = itk::FFTConvolutionImageFilter< ImageType >;
+
+ImageType::Pointer
+CreateRandomImage( const ImageType::IndexType & index, const ImageType::SizeType & size )
+{
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( static_cast< GeneratorType::IntegerType >( size[0] * 31 + size[1] ) );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( ImageType::RegionType( index, size ) );
+  image->Allocate();
+  for ( itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    it.Set( generator->GetUniformVariate( 0.0, 1.0 ) );
+    }
+  return image;
+}
+
+// Compare the block by block output with the whole image output.
+bool
+CompareWithWholeImage( ConvolutionFilterType * convolver,
+                       const ImageType * input,
+                       const ImageType * kernel,
+                       const ConvolutionFilterType::OutputSizeType & blockSize,
+                       itk::ThreadIdType numberOfWorkUnits,
+                       unsigned int numberOfStreamDivisions,
+                       const char * description )
+{
+  convolver->SetInput( input );
+  convolver->SetKernelImage( kernel );
+  convolver->SetNumberOfWorkUnits( numberOfWorkUnits );
+
+  ConvolutionFilterType::OutputSizeType wholeImage;
+  wholeImage.Fill( 0 );
+  convolver->SetBlockSize( wholeImage );
+  convolver->UpdateLargestPossibleRegion();
+  ImageType::Pointer expected = convolver->GetOutput();
+  expected->DisconnectPipeline();
+
+  convolver->SetBlockSize( blockSize );
+  using StreamerType = itk::StreamingImageFilter< ImageType, ImageType >;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( convolver->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  streamer->UpdateLargestPossibleRegion();
+  const ImageType * blocks = streamer->GetOutput();
+
+  if ( blocks->GetLargestPossibleRegion() != expected->GetLargestPossibleRegion()
+       || blocks->GetBufferedRegion() != expected->GetBufferedRegion() )
+    {
+    std::cerr << description << ": output regions differ." << std::endl;
+    return false;
+    }
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIterator< ImageType > expectedIt( expected, expected->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< ImageType > blocksIt( blocks, expected->GetBufferedRegion() );
+  for ( ; !expectedIt.IsAtEnd(); ++expectedIt, ++blocksIt )
+    {
+    maximumDifference = std::max( maximumDifference, itk::Math::abs( expectedIt.Get() - blocksIt.Get() ) );
+    }
+  std::cout << description << ": maximum difference " << maximumDifference << std::endl;
+  if ( maximumDifference > 1e-9 )
+    {
+    std::cerr << description << ": the block by block output differs from the whole image output." << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkFFTConvolutionImageFilterBlockTest(int, char * [])
+{
+  ImageType::IndexType inputIndex = {{ 3, -2 }};
+  ImageType::SizeType inputSize = {{ 83, 61 }};
+  ImageType::Pointer input = CreateRandomImage( inputIndex, inputSize );
+
+  ImageType::IndexType kernelIndex = {{ 0, 0 }};
+  ImageType::SizeType kernelSize = {{ 7, 4 }};
+  ImageType::Pointer kernel = CreateRandomImage( kernelIndex, kernelSize );
+
+  ConvolutionFilterType::Pointer convolver = ConvolutionFilterType::New();
+  ConvolutionFilterType::OutputSizeType blockSize = {{ 16, 16 }};
+  convolver->SetBlockSize( blockSize );
+  TEST_SET_GET_VALUE( blockSize, convolver->GetBlockSize() );
+
+  bool pass = true;
+  pass &= CompareWithWholeImage( convolver, input, kernel, blockSize, 3, 1, "Same region" );
+  pass &= CompareWithWholeImage( convolver, input, kernel, blockSize, 1, 5, "Same region, streamed" );
+
+  convolver->NormalizeOn();
+  ConvolutionFilterType::OutputSizeType slabSize = {{ 0, 10 }};
+  pass &= CompareWithWholeImage( convolver, input, kernel, slabSize, 2, 3, "Normalized kernel, slabs" );
+  convolver->NormalizeOff();
+
+  itk::ConstantBoundaryCondition< ImageType > constantBoundaryCondition;
+  constantBoundaryCondition.SetConstant( 2.0 );
+  convolver->SetBoundaryCondition( &constantBoundaryCondition );
+  pass &= CompareWithWholeImage( convolver, input, kernel, blockSize, 4, 2, "Constant boundary condition" );
+
+  convolver->SetOutputRegionModeToValid();
+  pass &= CompareWithWholeImage( convolver, input, kernel, blockSize, 3, 4, "Valid region" );
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image< float, Dimension >;
+using ConvolutionFilterType = itk::FFTConvolutionImageFilter< ImageType >;
+using CacheType = ConvolutionFilterType::KernelSpectrumCacheType;
+
+ImageType::Pointer
+CreateImage( const ImageType::SizeType & size )
+{
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  float value = 0.0f;
+  for ( itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    value += 1.0f;
+    it.Set( std::fmod( value * 0.37f, 5.0f ) );
+    }
+  return image;
+}
+
+ImageType::Pointer
+Convolve( const ImageType * input, const ImageType * kernel, bool useCache, bool normalize )
+{
+  ConvolutionFilterType::Pointer convolver = ConvolutionFilterType::New();
+  convolver->SetInput( input );
+  convolver->SetKernelImage( kernel );
+  convolver->SetNormalize( normalize );
+  convolver->SetUseKernelSpectrumCache( useCache );
+  convolver->Update();
+  ImageType::Pointer output = convolver->GetOutput();
+  output->DisconnectPipeline();
+  return output;
+}
+
+// Same rounding as FFTConvolutionImageFilter::GetPadSize(), whose greatest
+// prime factor depends on the FFT backend.
+CacheType::SizeType
+PadSize( const ImageType * input, const ImageType * kernel, itk::SizeValueType sizeGreatestPrimeFactor )
+{
+  CacheType::SizeType padSize;
+  for ( unsigned int i = 0; i < Dimension; ++i )
+    {
+    padSize[i] = input->GetLargestPossibleRegion().GetSize( i ) + kernel->GetLargestPossibleRegion().GetSize( i );
+    if ( sizeGreatestPrimeFactor > 1 )
+      {
+      while ( itk::Math::GreatestPrimeFactor( padSize[i] ) > sizeGreatestPrimeFactor )
+        {
+        padSize[i]++;
+        }
+      }
+    }
+  return padSize;
+}
+
+bool
+SameImages( const ImageType * image1, const ImageType * image2 )
+{
+  itk::ImageRegionConstIterator< ImageType > it1( image1, image1->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< ImageType > it2( image2, image2->GetBufferedRegion() );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if ( itk::Math::NotExactlyEquals( it1.Get(), it2.Get() ) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkFFTKernelSpectrumCacheTest(int, char * [])
+{
+  CacheType::Pointer cache = CacheType::GetInstance();
+  EXERCISE_BASIC_OBJECT_METHODS( cache, FFTKernelSpectrumCache, Object );
+  if ( cache != CacheType::GetInstance() )
+    {
+    std::cerr << "GetInstance() must return the same cache." << std::endl;
+    return EXIT_FAILURE;
+    }
+  cache->Clear();
+
+  ImageType::SizeType inputSize = {{ 40, 30 }};
+  ImageType::SizeType kernelSize = {{ 5, 3 }};
+  ImageType::Pointer input = CreateImage( inputSize );
+  ImageType::Pointer kernel = CreateImage( kernelSize );
+
+  // Without the cache nothing is stored.
+  ImageType::Pointer expected = Convolve( input, kernel, false, true );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 0 );
+
+  // The first filter adds the spectrum, the second one reuses it.
+  ImageType::Pointer output = Convolve( input, kernel, true, true );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 1 );
+  TEST_EXPECT_TRUE( SameImages( expected, output ) );
+  const itk::SizeValueType numberOfBytes = cache->GetNumberOfBytes();
+  TEST_EXPECT_TRUE( numberOfBytes > 0 );
+
+  ConvolutionFilterType::Pointer convolver = ConvolutionFilterType::New();
+  // 40 + 5 and 30 + 3, rounded up to the greatest prime factor of the
+  // FFT backend.
+  const CacheType::SizeType padSize = PadSize( input, kernel, convolver->GetSizeGreatestPrimeFactor() );
+  CacheType::ComplexImagePointer spectrum = cache->Find( kernel, kernel->GetMTime(), padSize, true );
+  TEST_EXPECT_TRUE( spectrum.IsNotNull() );
+
+  convolver->SetInput( input );
+  convolver->SetKernelImage( kernel );
+  convolver->NormalizeOn();
+  convolver->UseKernelSpectrumCacheOn();
+  TEST_SET_GET_BOOLEAN( convolver, UseKernelSpectrumCache, true );
+  convolver->Update();
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 1 );
+  TEST_EXPECT_TRUE( SameImages( expected, convolver->GetOutput() ) );
+  TEST_EXPECT_TRUE( cache->Find( kernel, kernel->GetMTime(), padSize, true ) == spectrum );
+
+  // Normalization and the padded size are part of the key.
+  output = Convolve( input, kernel, true, false );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 2 );
+  TEST_EXPECT_TRUE( SameImages( Convolve( input, kernel, false, false ), output ) );
+
+  ImageType::SizeType otherInputSize = {{ 23, 17 }};
+  ImageType::Pointer otherInput = CreateImage( otherInputSize );
+  output = Convolve( otherInput, kernel, true, true );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 3 );
+  TEST_EXPECT_TRUE( SameImages( Convolve( otherInput, kernel, false, true ), output ) );
+
+  // A modified kernel replaces its stale spectrum.
+  ImageType::IndexType center = {{ 2, 1 }};
+  kernel->SetPixel( center, 10.0f );
+  kernel->Modified();
+  output = Convolve( input, kernel, true, true );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 3 );
+  expected = Convolve( input, kernel, false, true );
+  TEST_EXPECT_TRUE( SameImages( expected, output ) );
+
+  // Least recently used spectra are evicted to fit the maximum size.
+  cache->SetMaximumNumberOfBytes( numberOfBytes );
+  TEST_EXPECT_EQUAL( cache->GetMaximumNumberOfBytes(), numberOfBytes );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 1 );
+  TEST_EXPECT_TRUE( cache->GetNumberOfBytes() <= numberOfBytes );
+  output = Convolve( input, kernel, true, true );
+  TEST_EXPECT_TRUE( SameImages( expected, output ) );
+
+  // Spectra larger than the maximum size are not cached.
+  cache->SetMaximumNumberOfBytes( 0 );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 0 );
+  output = Convolve( input, kernel, true, true );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfEntries(), 0 );
+  TEST_EXPECT_TRUE( SameImages( expected, output ) );
+
+  cache->SetMaximumNumberOfBytes( 512 * 1024 * 1024 );
+  cache->Clear();
+  TEST_EXPECT_EQUAL( cache->GetNumberOfBytes(), 0 );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -111,6 +111,12 @@ protected:
   /** This filter uses a minipipeline to compute the output. */
   void GenerateData() override;
 
+  /** Deconvolution needs the whole image in the Fourier domain. */
+  bool CanProcessInBlocks() const override
+    {
+    return false;
+    }
+
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
@@ -127,6 +127,12 @@ protected:
    * ThreadedGenerateData is not overridden. */
   void GenerateData() override;
 
+  /** Deconvolution needs the whole image in the Fourier domain. */
+  bool CanProcessInBlocks() const override
+    {
+    return false;
+    }
+
   /** Discrete Fourier transform of the padded kernel. */
   InternalComplexImagePointerType m_TransferFunction;
 
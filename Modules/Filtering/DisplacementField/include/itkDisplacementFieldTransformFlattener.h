@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementFieldTransformFlattener_h
+#define itkDisplacementFieldTransformFlattener_h
+
+#include "itkDisplacementFieldTransform.h"
+#include "itkTransformToDisplacementFieldFilter.h"
+
+namespace itk
+{
+/** \class DisplacementFieldTransformFlattener
+ * \brief Bake an arbitrary transform into a single DisplacementFieldTransform.
+ *
+ * Transforming many points through a CompositeTransform made of linear,
+ * displacement field and BSpline transforms evaluates every sub-transform
+ * in turn for each point. This class samples the transform once, in
+ * parallel, on the grid of a reference image and wraps the resulting
+ * field into a DisplacementFieldTransform, so that each subsequent point
+ * costs a single field interpolation.
+ *
+ * The flattened transform is an approximation of the original one
+ * between grid points. When EstimateApproximationError is on, or when a
+ * positive MaximumApproximationErrorTolerance is set, the error is
+ * measured at the center of every grid cell (see
+ * TransformToDisplacementFieldFilter::SetEstimateApproximationError).
+ * Flatten() throws an exception if the maximum error exceeds the
+ * tolerance, in which case a finer grid should be used.
+ *
+ * Outside of the reference grid the flattened transform behaves like a
+ * DisplacementFieldTransform, i.e. it does not reproduce the original
+ * transform.
+ *
+ * \sa TransformToDisplacementFieldFilter
+ * \ingroup ITKDisplacementField
+ */
+template< typename TParametersValueType, unsigned int NDimensions >
+class ITK_TEMPLATE_EXPORT DisplacementFieldTransformFlattener:
+  public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(DisplacementFieldTransformFlattener);
+
+  /** Standard class type aliases. */
+  using Self = DisplacementFieldTransformFlattener;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(DisplacementFieldTransformFlattener, Object);
+
+  static constexpr unsigned int Dimension = NDimensions;
+
+  using TransformType = Transform< TParametersValueType, NDimensions, NDimensions >;
+  using DisplacementFieldTransformType = DisplacementFieldTransform< TParametersValueType, NDimensions >;
+  using DisplacementFieldTransformPointer = typename DisplacementFieldTransformType::Pointer;
+  using DisplacementFieldType = typename DisplacementFieldTransformType::DisplacementFieldType;
+  using ReferenceImageType = ImageBase< NDimensions >;
+  using FieldGeneratorType = TransformToDisplacementFieldFilter< DisplacementFieldType, TParametersValueType >;
+
+  /** Set/Get the transform to flatten. */
+  itkSetConstObjectMacro(Transform, TransformType);
+  itkGetConstObjectMacro(Transform, TransformType);
+
+  /** Set/Get the image defining the grid on which the transform is
+   * sampled. */
+  itkSetConstObjectMacro(ReferenceImage, ReferenceImageType);
+  itkGetConstObjectMacro(ReferenceImage, ReferenceImageType);
+
+  /** Turn on/off the estimation of the approximation error. Off by
+   * default. */
+  itkSetMacro(EstimateApproximationError, bool);
+  itkGetConstMacro(EstimateApproximationError, bool);
+  itkBooleanMacro(EstimateApproximationError);
+
+  /** Set/Get the largest acceptable approximation error, in physical
+   * units. A positive tolerance implies EstimateApproximationError.
+   * Default is 0, i.e. no check. */
+  itkSetMacro(MaximumApproximationErrorTolerance, double);
+  itkGetConstMacro(MaximumApproximationErrorTolerance, double);
+
+  /** Set/Get the number of work units used to sample the transform.
+   * Defaults to the global default number of threads. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
+  /** Sample the transform on the reference grid and build the
+   * displacement field transform. */
+  virtual void Flatten();
+
+  /** Get the flattened transform. Valid after Flatten(). */
+  itkGetModifiableObjectMacro(DisplacementFieldTransform, DisplacementFieldTransformType);
+
+  /** Get the maximum and mean approximation errors measured by the last
+   * call to Flatten(). */
+  itkGetConstMacro(MaximumApproximationError, double);
+  itkGetConstMacro(MeanApproximationError, double);
+
+protected:
+  DisplacementFieldTransformFlattener();
+  ~DisplacementFieldTransformFlattener() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  typename TransformType::ConstPointer      m_Transform;
+  typename ReferenceImageType::ConstPointer m_ReferenceImage;
+  DisplacementFieldTransformPointer         m_DisplacementFieldTransform;
+
+  bool         m_EstimateApproximationError{ false };
+  double       m_MaximumApproximationErrorTolerance{ 0.0 };
+  ThreadIdType m_NumberOfWorkUnits;
+
+  double       m_MaximumApproximationError{ 0.0 };
+  double       m_MeanApproximationError{ 0.0 };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkDisplacementFieldTransformFlattener.hxx"
+#endif
+
+#endif
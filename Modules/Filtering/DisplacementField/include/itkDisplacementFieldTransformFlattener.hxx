@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementFieldTransformFlattener_hxx
+#define itkDisplacementFieldTransformFlattener_hxx
+
+#include "itkDisplacementFieldTransformFlattener.h"
+#include "itkMultiThreaderBase.h"
+
+namespace itk
+{
+
+template< typename TParametersValueType, unsigned int NDimensions >
+DisplacementFieldTransformFlattener< TParametersValueType, NDimensions >
+::DisplacementFieldTransformFlattener() :
+  m_NumberOfWorkUnits( MultiThreaderBase::GetGlobalDefaultNumberOfThreads() )
+{
+}
+
+
+template< typename TParametersValueType, unsigned int NDimensions >
+void
+DisplacementFieldTransformFlattener< TParametersValueType, NDimensions >
+::Flatten()
+{
+  if ( this->m_Transform.IsNull() )
+    {
+    itkExceptionMacro( "Transform is not set." );
+    }
+  if ( this->m_ReferenceImage.IsNull() )
+    {
+    itkExceptionMacro( "ReferenceImage is not set." );
+    }
+
+  const bool checkTolerance = this->m_MaximumApproximationErrorTolerance > 0.0;
+
+  typename FieldGeneratorType::Pointer fieldGenerator = FieldGeneratorType::New();
+  fieldGenerator->SetTransform( this->m_Transform );
+  fieldGenerator->SetReferenceImage( this->m_ReferenceImage );
+  fieldGenerator->UseReferenceImageOn();
+  fieldGenerator->SetNumberOfWorkUnits( this->m_NumberOfWorkUnits );
+  fieldGenerator->SetEstimateApproximationError( this->m_EstimateApproximationError || checkTolerance );
+  fieldGenerator->Update();
+
+  this->m_MaximumApproximationError = fieldGenerator->GetMaximumApproximationError();
+  this->m_MeanApproximationError = fieldGenerator->GetMeanApproximationError();
+
+  typename DisplacementFieldType::Pointer field = fieldGenerator->GetOutput();
+  field->DisconnectPipeline();
+
+  this->m_DisplacementFieldTransform = DisplacementFieldTransformType::New();
+  this->m_DisplacementFieldTransform->SetDisplacementField( field );
+
+  if ( checkTolerance && this->m_MaximumApproximationError > this->m_MaximumApproximationErrorTolerance )
+    {
+    itkExceptionMacro( "Maximum approximation error " << this->m_MaximumApproximationError
+                       << " exceeds the tolerance " << this->m_MaximumApproximationErrorTolerance
+                       << ". Use a finer reference grid." );
+    }
+}
+
+
+template< typename TParametersValueType, unsigned int NDimensions >
+void
+DisplacementFieldTransformFlattener< TParametersValueType, NDimensions >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro( Transform );
+  itkPrintSelfObjectMacro( ReferenceImage );
+  itkPrintSelfObjectMacro( DisplacementFieldTransform );
+
+  os << indent << "EstimateApproximationError: "
+     << ( this->m_EstimateApproximationError ? "On" : "Off" ) << std::endl;
+  os << indent << "MaximumApproximationErrorTolerance: "
+     << this->m_MaximumApproximationErrorTolerance << std::endl;
+  os << indent << "NumberOfWorkUnits: " << this->m_NumberOfWorkUnits << std::endl;
+  os << indent << "MaximumApproximationError: " << this->m_MaximumApproximationError << std::endl;
+  os << indent << "MeanApproximationError: " << this->m_MeanApproximationError << std::endl;
+}
+
+} // end namespace itk
+
+#endif
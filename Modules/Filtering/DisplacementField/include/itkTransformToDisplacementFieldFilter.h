@@ -22,6 +22,8 @@
 #include "itkTransform.h"
 #include "itkImageSource.h"
 
+#include <mutex>
+
 namespace itk
 {
 /** \class TransformToDisplacementFieldFilter
@@ -148,6 +150,23 @@ public:
   itkBooleanMacro(UseReferenceImage);
   itkGetConstMacro(UseReferenceImage, bool);
 
+  /** Turn on/off the estimation of the error made when the generated
+   * field is linearly interpolated in place of the transform. The
+   * transform is evaluated at the center of every grid cell and
+   * compared with the average of the displacements at the cell
+   * corners, which is what a DisplacementFieldTransform with its
+   * default linear interpolator returns there. Off by default. */
+  itkSetMacro(EstimateApproximationError, bool);
+  itkBooleanMacro(EstimateApproximationError);
+  itkGetConstMacro(EstimateApproximationError, bool);
+
+  /** Get the maximum and the mean Euclidean distance between the
+   * transform and the interpolated field at the cell centers, as
+   * measured during the last update. Both are zero when
+   * EstimateApproximationError is off. */
+  itkGetConstMacro(MaximumApproximationError, double);
+  itkGetConstMacro(MeanApproximationError, double);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   static constexpr unsigned int PixelDimension = PixelType::Dimension;
@@ -166,6 +185,9 @@ protected:
   /** TransformToDisplacementFieldFilter is implemented as a multithreaded filter. */
   void DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
 
+  void BeforeThreadedGenerateData() override;
+  void AfterThreadedGenerateData() override;
+
 
   /** Default implementation for resampling that works for any
    * transformation type.
@@ -177,6 +199,10 @@ protected:
    */
   void LinearThreadedGenerateData( const OutputImageRegionType & outputRegionForThread );
 
+  /** Accumulate the approximation error of the cells whose lower corner
+   * lies in the given region. */
+  void EstimateApproximationErrorForRegion( const OutputImageRegionType & cellRegion );
+
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
@@ -188,6 +214,13 @@ private:
   DirectionType        m_OutputDirection; // output image direction cosines
   bool                 m_UseReferenceImage{ false };
 
+  bool                 m_EstimateApproximationError{ false };
+  double               m_MaximumApproximationError{ 0.0 };
+  double               m_MeanApproximationError{ 0.0 };
+  double               m_ApproximationErrorSum{ 0.0 };
+  SizeValueType        m_NumberOfApproximationErrorCells{ 0 };
+  std::mutex           m_ApproximationErrorMutex;
+
 };
 } // end namespace itk
 
@@ -24,6 +24,10 @@
 #include "itkProgressReporter.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageScanlineIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkContinuousIndex.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -70,6 +74,10 @@ TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
     {
     os << "Off" << std::endl;
     }
+  os << indent << "EstimateApproximationError: "
+     << ( this->m_EstimateApproximationError ? "On" : "Off" ) << std::endl;
+  os << indent << "MaximumApproximationError: " << this->m_MaximumApproximationError << std::endl;
+  os << indent << "MeanApproximationError: " << this->m_MeanApproximationError << std::endl;
 }
 
 
@@ -157,6 +165,128 @@ TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
 }
 
 
+template< typename TOutputImage, typename TParametersValueType>
+void
+TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
+::BeforeThreadedGenerateData()
+{
+  this->m_MaximumApproximationError = 0.0;
+  this->m_MeanApproximationError = 0.0;
+  this->m_ApproximationErrorSum = 0.0;
+  this->m_NumberOfApproximationErrorCells = 0;
+}
+
+
+template< typename TOutputImage, typename TParametersValueType>
+void
+TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
+::AfterThreadedGenerateData()
+{
+  if ( !this->m_EstimateApproximationError )
+    {
+    return;
+    }
+
+  // The error is estimated once the whole field is available, since a
+  // cell may span the regions of several work units. A cell is
+  // identified by its lower corner.
+  const OutputImageRegionType bufferedRegion = this->GetOutput()->GetBufferedRegion();
+  OutputImageRegionType       cellRegion = bufferedRegion;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( bufferedRegion.GetSize(d) < 2 )
+      {
+      return;
+      }
+    cellRegion.SetSize( d, bufferedRegion.GetSize(d) - 1 );
+    }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    cellRegion,
+    [this](const OutputImageRegionType & lambdaRegion)
+      {
+      this->EstimateApproximationErrorForRegion(lambdaRegion);
+      },
+    nullptr);
+
+  if ( this->m_NumberOfApproximationErrorCells > 0 )
+    {
+    this->m_MeanApproximationError = this->m_ApproximationErrorSum
+      / static_cast< double >( this->m_NumberOfApproximationErrorCells );
+    }
+}
+
+
+template< typename TOutputImage, typename TParametersValueType>
+void
+TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
+::EstimateApproximationErrorForRegion( const OutputImageRegionType & cellRegion )
+{
+  const OutputImageType * output = this->GetOutput();
+  const TransformType * transform = this->GetInput()->Get();
+
+  constexpr unsigned int NumberOfCorners = 1u << ImageDimension;
+
+  double        maximumError = 0.0;
+  double        errorSum = 0.0;
+  SizeValueType numberOfCells = 0;
+
+  using CellIteratorType = ImageScanlineConstIterator< TOutputImage >;
+  CellIteratorType cellIt( output, cellRegion );
+
+  ContinuousIndex< SpacePrecisionType, ImageDimension > centerIndex;
+  PointType                                             center;
+
+  while ( !cellIt.IsAtEnd() )
+    {
+    while ( !cellIt.IsAtEndOfLine() )
+      {
+      const IndexType lowerCorner = cellIt.GetIndex();
+
+      // The multilinear interpolant at the cell center is the average
+      // of the corner displacements.
+      typename PointType::VectorType interpolated;
+      interpolated.Fill( 0.0 );
+      for ( unsigned int corner = 0; corner < NumberOfCorners; ++corner )
+        {
+        IndexType cornerIndex = lowerCorner;
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          cornerIndex[d] += ( corner >> d ) & 1u;
+          }
+        const PixelType & displacement = output->GetPixel( cornerIndex );
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          interpolated[d] += displacement[d];
+          }
+        }
+      interpolated /= static_cast< double >( NumberOfCorners );
+
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        centerIndex[d] = lowerCorner[d] + 0.5;
+        }
+      output->TransformContinuousIndexToPhysicalPoint( centerIndex, center );
+      const typename PointType::VectorType exact = transform->TransformPoint( center ) - center;
+
+      const double error = ( exact - interpolated ).GetNorm();
+      maximumError = std::max( maximumError, error );
+      errorSum += error;
+      ++numberOfCells;
+
+      ++cellIt;
+      }
+    cellIt.NextLine();
+    }
+
+  std::lock_guard< std::mutex > lock( this->m_ApproximationErrorMutex );
+  this->m_MaximumApproximationError = std::max( this->m_MaximumApproximationError, maximumError );
+  this->m_ApproximationErrorSum += errorSum;
+  this->m_NumberOfApproximationErrorCells += numberOfCells;
+}
+
+
 template< typename TOutputImage, typename TParametersValueType>
 void
 TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
@@ -197,14 +327,31 @@ TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
   PointType transformedPoint;    // Coordinates of transformed pixel
   PixelType displacement;         // the difference
 
+  // Physical offset between two consecutive pixels of a scanline, so
+  // that only the first point of each line goes through the
+  // index-to-physical-point mapping.
+  IndexType nextIndex = outputRegionForThread.GetIndex();
+  PointType firstPoint;
+  output->TransformIndexToPhysicalPoint( nextIndex, firstPoint );
+  ++nextIndex[0];
+  output->TransformIndexToPhysicalPoint( nextIndex, outputPoint );
+  const typename PointType::VectorType scanlineStep = outputPoint - firstPoint;
+
   // Walk the output region
   outIt.GoToBegin();
   while ( !outIt.IsAtEnd() )
     {
+    PointType lineStart;
+    output->TransformIndexToPhysicalPoint( outIt.GetIndex(), lineStart );
+
+    SizeValueType offset = 0;
     while ( !outIt.IsAtEndOfLine() )
       {
-      // Determine the index of the current output pixel
-      output->TransformIndexToPhysicalPoint( outIt.GetIndex(), outputPoint );
+      // Determine the physical point of the current output pixel
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        outputPoint[d] = lineStart[d] + offset * scanlineStep[d];
+        }
 
       // Compute corresponding input pixel position
       transformedPoint = transform->TransformPoint( outputPoint );
@@ -212,6 +359,7 @@ TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
       displacement = transformedPoint - outputPoint;
       outIt.Set( displacement );
       ++outIt;
+      ++offset;
       }
     outIt.NextLine();
     }
@@ -0,0 +1,227 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDisplacementFieldTransformFlattener.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+
+using ParametersValueType = double;
+using FlattenerType = itk::DisplacementFieldTransformFlattener< ParametersValueType, Dimension >;
+using CompositeTransformType = itk::CompositeTransform< ParametersValueType, Dimension >;
+using AffineTransformType = itk::AffineTransform< ParametersValueType, Dimension >;
+using DisplacementTransformType = itk::DisplacementFieldTransform< ParametersValueType, Dimension >;
+using BSplineTransformType = itk::BSplineTransform< ParametersValueType, Dimension, 3 >;
+using FieldType = DisplacementTransformType::DisplacementFieldType;
+using ReferenceImageType = itk::Image< unsigned char, Dimension >;
+
+ReferenceImageType::Pointer
+MakeGrid( double spacing )
+{
+  ReferenceImageType::SizeType size;
+  size.Fill( itk::Math::Round< itk::SizeValueType >( 63.0 / spacing ) + 1 );
+
+  ReferenceImageType::SpacingType spacings;
+  spacings.Fill( spacing );
+
+  ReferenceImageType::PointType origin;
+  origin.Fill( 0.0 );
+
+  ReferenceImageType::Pointer grid = ReferenceImageType::New();
+  grid->SetRegions( size );
+  grid->SetSpacing( spacings );
+  grid->SetOrigin( origin );
+  return grid;
+}
+
+// Largest distance between the two transforms at random points of the
+// [8, 56]^2 square, which is inside every sampling grid.
+double
+MaximumDistance( const CompositeTransformType * composite,
+                 const DisplacementTransformType * flattened )
+{
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  double maximumDistance = 0.0;
+  for ( unsigned int i = 0; i < 2000; ++i )
+    {
+    CompositeTransformType::InputPointType point;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      point[d] = generator->GetUniformVariate( 8.0, 56.0 );
+      }
+    maximumDistance = std::max( maximumDistance,
+      composite->TransformPoint( point ).EuclideanDistanceTo( flattened->TransformPoint( point ) ) );
+    }
+  return maximumDistance;
+}
+}
+
+int itkDisplacementFieldTransformFlattenerTest( int, char *[] )
+{
+  // Affine followed by a smooth displacement field and a BSpline, the
+  // latter being applied first by the composite transform.
+  AffineTransformType::Pointer affine = AffineTransformType::New();
+  AffineTransformType::OutputVectorType translation;
+  translation[0] = 1.5;
+  translation[1] = -0.75;
+  affine->Translate( translation );
+  affine->Rotate2D( 0.1 );
+
+  // The sub-transforms are defined well beyond the sampling grid so that
+  // the composite transform is smooth on all of it.
+  FieldType::SizeType fieldSize;
+  fieldSize.Fill( 128 );
+  FieldType::PointType fieldOrigin;
+  fieldOrigin.Fill( -32.0 );
+  FieldType::Pointer field = FieldType::New();
+  field->SetRegions( fieldSize );
+  field->SetOrigin( fieldOrigin );
+  field->Allocate();
+  itk::ImageRegionIteratorWithIndex< FieldType > fieldIt( field, field->GetLargestPossibleRegion() );
+  for ( ; !fieldIt.IsAtEnd(); ++fieldIt )
+    {
+    const FieldType::IndexType index = fieldIt.GetIndex();
+    FieldType::PixelType displacement;
+    displacement[0] = 2.0 * std::sin( index[1] / 10.0 );
+    displacement[1] = 1.5 * std::cos( index[0] / 12.0 );
+    fieldIt.Set( displacement );
+    }
+  DisplacementTransformType::Pointer displacementTransform = DisplacementTransformType::New();
+  displacementTransform->SetDisplacementField( field );
+
+  BSplineTransformType::Pointer bspline = BSplineTransformType::New();
+  BSplineTransformType::PhysicalDimensionsType physicalDimensions;
+  physicalDimensions.Fill( 96.0 );
+  BSplineTransformType::MeshSizeType meshSize;
+  meshSize.Fill( 6 );
+  BSplineTransformType::OriginType bsplineOrigin;
+  bsplineOrigin.Fill( -16.0 );
+  BSplineTransformType::DirectionType bsplineDirection;
+  bsplineDirection.SetIdentity();
+  bspline->SetTransformDomainOrigin( bsplineOrigin );
+  bspline->SetTransformDomainPhysicalDimensions( physicalDimensions );
+  bspline->SetTransformDomainMeshSize( meshSize );
+  bspline->SetTransformDomainDirection( bsplineDirection );
+  BSplineTransformType::ParametersType bsplineParameters( bspline->GetNumberOfParameters() );
+  for ( unsigned int i = 0; i < bsplineParameters.Size(); ++i )
+    {
+    bsplineParameters[i] = 2.0 * std::sin( 0.7 * i );
+    }
+  bspline->SetParameters( bsplineParameters );
+
+  CompositeTransformType::Pointer composite = CompositeTransformType::New();
+  composite->AddTransform( affine );
+  composite->AddTransform( displacementTransform );
+  composite->AddTransform( bspline );
+
+  FlattenerType::Pointer flattener = FlattenerType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( flattener, DisplacementFieldTransformFlattener, Object );
+
+  TRY_EXPECT_EXCEPTION( flattener->Flatten() );
+
+  flattener->SetTransform( composite );
+  flattener->SetReferenceImage( MakeGrid( 4.0 ) );
+  flattener->EstimateApproximationErrorOn();
+  TEST_SET_GET_BOOLEAN( flattener, EstimateApproximationError, true );
+  TRY_EXPECT_NO_EXCEPTION( flattener->Flatten() );
+
+  const double coarseMaximumError = flattener->GetMaximumApproximationError();
+  const double coarseMeanError = flattener->GetMeanApproximationError();
+  const double coarseDistance = MaximumDistance( composite, flattener->GetDisplacementFieldTransform() );
+  std::cout << "Coarse grid: maximum error " << coarseMaximumError << ", mean error " << coarseMeanError
+            << ", measured distance " << coarseDistance << std::endl;
+
+  if ( !( coarseMaximumError > 0.0 ) || coarseMeanError > coarseMaximumError )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Inconsistent approximation error estimates." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The cell centers are where multilinear interpolation is the least
+  // accurate, so the estimate must be of the order of the true error.
+  if ( coarseDistance > 2.0 * coarseMaximumError )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Approximation error underestimated." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  flattener->SetReferenceImage( MakeGrid( 0.5 ) );
+  flattener->SetNumberOfWorkUnits( 3 );
+  TRY_EXPECT_NO_EXCEPTION( flattener->Flatten() );
+
+  const double fineMaximumError = flattener->GetMaximumApproximationError();
+  const double fineDistance = MaximumDistance( composite, flattener->GetDisplacementFieldTransform() );
+  std::cout << "Fine grid: maximum error " << fineMaximumError
+            << ", measured distance " << fineDistance << std::endl;
+
+  if ( fineMaximumError > 0.25 * coarseMaximumError || fineDistance > 0.25 * coarseDistance )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Refining the grid did not reduce the approximation error." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The grid of the flattened transform is the reference grid.
+  const FieldType * flattenedField = flattener->GetDisplacementFieldTransform()->GetDisplacementField();
+  if ( flattenedField->GetLargestPossibleRegion() != MakeGrid( 0.5 )->GetLargestPossibleRegion()
+       || flattenedField->GetSpacing() != MakeGrid( 0.5 )->GetSpacing() )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Flattened field is not defined on the reference grid." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // An error bound that cannot be met.
+  flattener->SetMaximumApproximationErrorTolerance( 0.1 * fineMaximumError );
+  TEST_SET_GET_VALUE( 0.1 * fineMaximumError, flattener->GetMaximumApproximationErrorTolerance() );
+  flattener->EstimateApproximationErrorOff();
+  TRY_EXPECT_EXCEPTION( flattener->Flatten() );
+
+  flattener->SetMaximumApproximationErrorTolerance( 2.0 * fineMaximumError );
+  TRY_EXPECT_NO_EXCEPTION( flattener->Flatten() );
+
+  // A linear transform is represented exactly.
+  CompositeTransformType::Pointer linear = CompositeTransformType::New();
+  linear->AddTransform( affine );
+  flattener->SetTransform( linear );
+  flattener->SetReferenceImage( MakeGrid( 4.0 ) );
+  flattener->SetMaximumApproximationErrorTolerance( 1e-8 );
+  TRY_EXPECT_NO_EXCEPTION( flattener->Flatten() );
+  if ( MaximumDistance( linear, flattener->GetDisplacementFieldTransform() ) > 1e-8 )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Flattened linear transform is not exact." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
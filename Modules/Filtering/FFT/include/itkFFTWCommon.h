@@ -33,7 +33,10 @@
 
 #endif
 
+#include <memory>
 #include <mutex>
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
@@ -61,6 +64,81 @@ protected:
   ~Proxy() {};
 };
 
+#if defined( ITK_USE_FFTWF ) || defined( ITK_USE_FFTWD )
+
+/** Kinds of transforms planned by Proxy, used to identify cached plans. */
+enum PlanKindType
+{
+  PLAN_DFT = 0,
+  PLAN_DFT_R2C = 1,
+  PLAN_DFT_C2R = 2,
+  PLAN_MANY_DFT = 3
+};
+
+/** Build the key of a plan. The plan can be executed on other arrays with
+ * the same layout and alignment than the ones it has been created with. */
+template< typename TProxy >
+std::vector< int >
+MakePlanKey(PlanKindType kind,
+            int rank,
+            const int *n,
+            int howmany,
+            const void *in,
+            int istride,
+            int idist,
+            const void *out,
+            int ostride,
+            int odist,
+            int sign,
+            unsigned flags,
+            int threads)
+{
+  std::vector< int > key;
+  key.reserve( rank + 14 );
+  key.push_back( static_cast< int >( sizeof( typename TProxy::PixelType ) ) );
+  key.push_back( kind );
+  key.push_back( rank );
+  key.insert( key.end(), n, n + rank );
+  key.push_back( howmany );
+  key.push_back( istride );
+  key.push_back( idist );
+  key.push_back( ostride );
+  key.push_back( odist );
+  key.push_back( sign );
+  key.push_back( static_cast< int >( flags ) );
+  key.push_back( threads );
+  key.push_back( TProxy::AlignmentOf( in ) );
+  key.push_back( TProxy::AlignmentOf( out ) );
+  key.push_back( in == out );
+  return key;
+}
+
+/** Return the cached plan with that key, or create it with createPlan()
+ * and cache it. When the cache is disabled, or not available with
+ * cuFFTW, a new plan is returned every time. */
+template< typename TProxy, typename TPlanCreator >
+typename TProxy::PlanPointer
+GetCachedPlan(const std::vector< int > & key, TPlanCreator createPlan)
+{
+  using PlanPointer = typename TProxy::PlanPointer;
+#ifndef ITK_USE_CUFFTW
+  if( FFTWGlobalConfiguration::GetPlanCacheSize() > 0 )
+    {
+    FFTWGlobalConfiguration::CachedPlanPointer plan = FFTWGlobalConfiguration::FindPlan( key );
+    if( !plan )
+      {
+      plan = FFTWGlobalConfiguration::InsertPlan( key, TProxy::MakePlanPointer( createPlan() ) );
+      }
+    return std::static_pointer_cast< typename PlanPointer::element_type >( plan );
+    }
+#else
+  (void)key;
+#endif
+  return TProxy::MakePlanPointer( createPlan() );
+}
+
+#endif
+
 #if defined( ITK_USE_FFTWF )
 
 template< >
@@ -374,6 +452,172 @@ public:
   }
 
 
+  static PlanType Plan_many_dft(int rank,
+                                const int *n,
+                                int howmany,
+                                ComplexType *in,
+                                int istride,
+                                int idist,
+                                ComplexType *out,
+                                int ostride,
+                                int odist,
+                                int sign,
+                                unsigned flags,
+                                int threads=1,
+                                bool canDestroyInput=false)
+  {
+#ifndef ITK_USE_CUFFTW
+    std::lock_guard< FFTWGlobalConfiguration::MutexType > lock( FFTWGlobalConfiguration::GetLockMutex() );
+    fftwf_plan_with_nthreads(threads);
+#else
+    (void)threads;
+#endif
+    // don't add FFTW_WISDOM_ONLY if the plan rigor is FFTW_ESTIMATE
+    // because FFTW_ESTIMATE guarantee to not destroy the input
+    unsigned roflags = flags;
+    if( ! (flags & FFTW_ESTIMATE) )
+      {
+      roflags = flags | FFTW_WISDOM_ONLY;
+      }
+    PlanType plan = fftwf_plan_many_dft(rank,n,howmany,in,nullptr,istride,idist,out,nullptr,ostride,odist,sign,roflags);
+    if( plan == nullptr )
+      {
+      // no wisdom available for that plan
+      if( canDestroyInput )
+        {
+        // just create the plan
+        plan = fftwf_plan_many_dft(rank,n,howmany,in,nullptr,istride,idist,out,nullptr,ostride,odist,sign,flags);
+        }
+      else
+        {
+        // lets create a plan with a fake input to generate the wisdom
+        int total = 1;
+        for( int i=0; i<rank; i++ )
+          {
+          total *= n[i];
+          }
+        auto * din = new ComplexType[( howmany - 1 ) * idist + ( total - 1 ) * istride + 1];
+        fftwf_plan_many_dft(rank,n,howmany,din,nullptr,istride,idist,out,nullptr,ostride,odist,sign,flags);
+        delete[] din;
+        // and then create the final plan - this time it shouldn't fail
+        plan = fftwf_plan_many_dft(rank,n,howmany,in,nullptr,istride,idist,out,nullptr,ostride,odist,sign,roflags);
+        }
+#ifndef ITK_USE_CUFFTW
+      FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+#endif
+      }
+    itkAssertOrThrowMacro( plan != nullptr , "PLAN_CREATION_FAILED ");
+    return plan;
+  }
+
+  /** A plan shared with the plan cache, destroyed when it is released by
+   * the cache and all its users. */
+  using PlanPointer = std::shared_ptr< std::remove_pointer< PlanType >::type >;
+
+  static PlanPointer MakePlanPointer(PlanType plan)
+  {
+#ifndef ITK_USE_CUFFTW
+    // FFTWGlobalConfiguration may release the plan from its destructor,
+    // when GetLockMutex() can't be called anymore.
+    FFTWGlobalConfiguration::MutexType * mutex = &FFTWGlobalConfiguration::GetLockMutex();
+    return PlanPointer( plan, [mutex](PlanType p)
+      {
+      std::lock_guard< FFTWGlobalConfiguration::MutexType > lock( *mutex );
+      fftwf_destroy_plan(p);
+      } );
+#else
+    return PlanPointer( plan, [](PlanType p) { fftwf_destroy_plan(p); } );
+#endif
+  }
+
+  static int AlignmentOf(const void *p)
+  {
+#ifndef ITK_USE_CUFFTW
+    return fftwf_alignment_of( reinterpret_cast< PixelType * >( const_cast< void * >( p ) ) );
+#else
+    (void)p;
+    return 0;
+#endif
+  }
+
+  /** Return a plan from the plan cache of FFTWGlobalConfiguration. The
+   * arguments are the ones of the matching Plan_* method. The plan must be
+   * executed with the matching Execute_* method, which can be used on
+   * other arrays with the same layout and alignment. */
+  static PlanPointer CachedPlan_dft_r2c(int rank,
+                                        const int *n,
+                                        PixelType *in,
+                                        ComplexType *out,
+                                        unsigned flags,
+                                        int threads=1,
+                                        bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_DFT_R2C, rank, n, 1, in, 1, 0, out, 1, 0, 0, flags, threads ),
+      [&]() { return Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput); } );
+  }
+
+  static PlanPointer CachedPlan_dft_c2r(int rank,
+                                        const int *n,
+                                        ComplexType *in,
+                                        PixelType *out,
+                                        unsigned flags,
+                                        int threads=1,
+                                        bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_DFT_C2R, rank, n, 1, in, 1, 0, out, 1, 0, 0, flags, threads ),
+      [&]() { return Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput); } );
+  }
+
+  static PlanPointer CachedPlan_dft(int rank,
+                                    const int *n,
+                                    ComplexType *in,
+                                    ComplexType *out,
+                                    int sign,
+                                    unsigned flags,
+                                    int threads=1,
+                                    bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_DFT, rank, n, 1, in, 1, 0, out, 1, 0, sign, flags, threads ),
+      [&]() { return Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput); } );
+  }
+
+  static PlanPointer CachedPlan_many_dft(int rank,
+                                         const int *n,
+                                         int howmany,
+                                         ComplexType *in,
+                                         int istride,
+                                         int idist,
+                                         ComplexType *out,
+                                         int ostride,
+                                         int odist,
+                                         int sign,
+                                         unsigned flags,
+                                         int threads=1,
+                                         bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_MANY_DFT, rank, n, howmany, in, istride, idist, out, ostride, odist,
+                           sign, flags, threads ),
+      [&]() { return Plan_many_dft(rank, n, howmany, in, istride, idist, out, ostride, odist,
+                                   sign, flags, threads, canDestroyInput); } );
+  }
+
+  static void Execute_dft(const PlanPointer & p, ComplexType *in, ComplexType *out)
+  {
+    fftwf_execute_dft(p.get(), in, out);
+  }
+  static void Execute_dft_r2c(const PlanPointer & p, PixelType *in, ComplexType *out)
+  {
+    fftwf_execute_dft_r2c(p.get(), in, out);
+  }
+  static void Execute_dft_c2r(const PlanPointer & p, ComplexType *in, PixelType *out)
+  {
+    fftwf_execute_dft_c2r(p.get(), in, out);
+  }
+
   static void Execute(PlanType p)
   {
     fftwf_execute(p);
@@ -701,6 +945,172 @@ public:
   }
 
 
+  static PlanType Plan_many_dft(int rank,
+                                const int *n,
+                                int howmany,
+                                ComplexType *in,
+                                int istride,
+                                int idist,
+                                ComplexType *out,
+                                int ostride,
+                                int odist,
+                                int sign,
+                                unsigned flags,
+                                int threads=1,
+                                bool canDestroyInput=false)
+  {
+#ifndef ITK_USE_CUFFTW
+    std::lock_guard< FFTWGlobalConfiguration::MutexType > lock( FFTWGlobalConfiguration::GetLockMutex() );
+    fftw_plan_with_nthreads(threads);
+#else
+    (void)threads;
+#endif
+    // don't add FFTW_WISDOM_ONLY if the plan rigor is FFTW_ESTIMATE
+    // because FFTW_ESTIMATE guarantee to not destroy the input
+    unsigned roflags = flags;
+    if( ! (flags & FFTW_ESTIMATE) )
+      {
+      roflags = flags | FFTW_WISDOM_ONLY;
+      }
+    PlanType plan = fftw_plan_many_dft(rank,n,howmany,in,nullptr,istride,idist,out,nullptr,ostride,odist,sign,roflags);
+    if( plan == nullptr )
+      {
+      // no wisdom available for that plan
+      if( canDestroyInput )
+        {
+        // just create the plan
+        plan = fftw_plan_many_dft(rank,n,howmany,in,nullptr,istride,idist,out,nullptr,ostride,odist,sign,flags);
+        }
+      else
+        {
+        // lets create a plan with a fake input to generate the wisdom
+        int total = 1;
+        for( int i=0; i<rank; i++ )
+          {
+          total *= n[i];
+          }
+        auto * din = new ComplexType[( howmany - 1 ) * idist + ( total - 1 ) * istride + 1];
+        fftw_plan_many_dft(rank,n,howmany,din,nullptr,istride,idist,out,nullptr,ostride,odist,sign,flags);
+        delete[] din;
+        // and then create the final plan - this time it shouldn't fail
+        plan = fftw_plan_many_dft(rank,n,howmany,in,nullptr,istride,idist,out,nullptr,ostride,odist,sign,roflags);
+        }
+#ifndef ITK_USE_CUFFTW
+      FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+#endif
+      }
+    itkAssertOrThrowMacro( plan != nullptr , "PLAN_CREATION_FAILED ");
+    return plan;
+  }
+
+  /** A plan shared with the plan cache, destroyed when it is released by
+   * the cache and all its users. */
+  using PlanPointer = std::shared_ptr< std::remove_pointer< PlanType >::type >;
+
+  static PlanPointer MakePlanPointer(PlanType plan)
+  {
+#ifndef ITK_USE_CUFFTW
+    // FFTWGlobalConfiguration may release the plan from its destructor,
+    // when GetLockMutex() can't be called anymore.
+    FFTWGlobalConfiguration::MutexType * mutex = &FFTWGlobalConfiguration::GetLockMutex();
+    return PlanPointer( plan, [mutex](PlanType p)
+      {
+      std::lock_guard< FFTWGlobalConfiguration::MutexType > lock( *mutex );
+      fftw_destroy_plan(p);
+      } );
+#else
+    return PlanPointer( plan, [](PlanType p) { fftw_destroy_plan(p); } );
+#endif
+  }
+
+  static int AlignmentOf(const void *p)
+  {
+#ifndef ITK_USE_CUFFTW
+    return fftw_alignment_of( reinterpret_cast< PixelType * >( const_cast< void * >( p ) ) );
+#else
+    (void)p;
+    return 0;
+#endif
+  }
+
+  /** Return a plan from the plan cache of FFTWGlobalConfiguration. The
+   * arguments are the ones of the matching Plan_* method. The plan must be
+   * executed with the matching Execute_* method, which can be used on
+   * other arrays with the same layout and alignment. */
+  static PlanPointer CachedPlan_dft_r2c(int rank,
+                                        const int *n,
+                                        PixelType *in,
+                                        ComplexType *out,
+                                        unsigned flags,
+                                        int threads=1,
+                                        bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_DFT_R2C, rank, n, 1, in, 1, 0, out, 1, 0, 0, flags, threads ),
+      [&]() { return Plan_dft_r2c(rank, n, in, out, flags, threads, canDestroyInput); } );
+  }
+
+  static PlanPointer CachedPlan_dft_c2r(int rank,
+                                        const int *n,
+                                        ComplexType *in,
+                                        PixelType *out,
+                                        unsigned flags,
+                                        int threads=1,
+                                        bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_DFT_C2R, rank, n, 1, in, 1, 0, out, 1, 0, 0, flags, threads ),
+      [&]() { return Plan_dft_c2r(rank, n, in, out, flags, threads, canDestroyInput); } );
+  }
+
+  static PlanPointer CachedPlan_dft(int rank,
+                                    const int *n,
+                                    ComplexType *in,
+                                    ComplexType *out,
+                                    int sign,
+                                    unsigned flags,
+                                    int threads=1,
+                                    bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_DFT, rank, n, 1, in, 1, 0, out, 1, 0, sign, flags, threads ),
+      [&]() { return Plan_dft(rank, n, in, out, sign, flags, threads, canDestroyInput); } );
+  }
+
+  static PlanPointer CachedPlan_many_dft(int rank,
+                                         const int *n,
+                                         int howmany,
+                                         ComplexType *in,
+                                         int istride,
+                                         int idist,
+                                         ComplexType *out,
+                                         int ostride,
+                                         int odist,
+                                         int sign,
+                                         unsigned flags,
+                                         int threads=1,
+                                         bool canDestroyInput=false)
+  {
+    return GetCachedPlan< Self >(
+      MakePlanKey< Self >( PLAN_MANY_DFT, rank, n, howmany, in, istride, idist, out, ostride, odist,
+                           sign, flags, threads ),
+      [&]() { return Plan_many_dft(rank, n, howmany, in, istride, idist, out, ostride, odist,
+                                   sign, flags, threads, canDestroyInput); } );
+  }
+
+  static void Execute_dft(const PlanPointer & p, ComplexType *in, ComplexType *out)
+  {
+    fftw_execute_dft(p.get(), in, out);
+  }
+  static void Execute_dft_r2c(const PlanPointer & p, PixelType *in, ComplexType *out)
+  {
+    fftw_execute_dft_r2c(p.get(), in, out);
+  }
+  static void Execute_dft_c2r(const PlanPointer & p, ComplexType *in, PixelType *out)
+  {
+    fftw_execute_dft_c2r(p.get(), in, out);
+  }
+
   static void Execute(PlanType p)
   {
     fftw_execute(p);
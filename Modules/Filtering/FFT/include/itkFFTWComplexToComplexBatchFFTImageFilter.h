@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTWComplexToComplexBatchFFTImageFilter_h
+#define itkFFTWComplexToComplexBatchFFTImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkFFTWCommon.h"
+
+namespace itk
+{
+/** \class FFTWComplexToComplexBatchFFTImageFilter
+ *
+ * \brief Compute many complex to complex Fourier transforms of the same
+ * size with a single FFTW plan.
+ *
+ * The first NumberOfTransformDimensions dimensions of the image are
+ * transformed, and the remaining ones index a stack of images of the same
+ * size: a 3D image with NumberOfTransformDimensions set to 2 is a stack of
+ * 2D images whose Fourier transforms are all computed at once. When the
+ * image is a VectorImage, every component is transformed independently.
+ *
+ * All the transforms are computed with a single fftw_plan_many_dft plan
+ * taken from the plan cache of FFTWGlobalConfiguration, which is much
+ * faster than transforming many small images one at a time with
+ * FFTWComplexToComplexFFTImageFilter. The inverse transform is normalized
+ * by the number of pixels of a transformed image.
+ *
+ * TImage is either an Image or a VectorImage of std::complex pixels.
+ *
+ * \ingroup FourierTransform
+ * \ingroup MultiThreaded
+ * \ingroup ITKFFT
+ *
+ * \sa FFTWComplexToComplexFFTImageFilter
+ * \sa FFTWGlobalConfiguration
+ */
+template< typename TImage >
+class ITK_TEMPLATE_EXPORT FFTWComplexToComplexBatchFFTImageFilter:
+  public ImageToImageFilter< TImage, TImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(FFTWComplexToComplexBatchFFTImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = FFTWComplexToComplexBatchFFTImageFilter;
+  using Superclass = ImageToImageFilter< TImage, TImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using ImageType = TImage;
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+  using InternalPixelType = typename ImageType::InternalPixelType;
+  using RealType = typename InternalPixelType::value_type;
+
+  using FFTWProxyType = typename fftw::Proxy< RealType >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FFTWComplexToComplexBatchFFTImageFilter, ImageToImageFilter);
+
+  static constexpr unsigned int ImageDimension = ImageType::ImageDimension;
+
+  /** Transform Direction */
+  enum TransformDirectionType {
+    FORWARD = 1,
+    INVERSE = 2
+    };
+
+  /** Set/Get the direction in which the transforms will be applied. */
+  itkSetMacro(TransformDirection, TransformDirectionType);
+  itkGetConstMacro(TransformDirection, TransformDirectionType);
+
+  /** Set/Get the number of dimensions of the transformed images. The
+   * remaining, slowest varying, dimensions index the stack of transformed
+   * images. Defaults to ImageDimension. */
+  itkSetClampMacro(NumberOfTransformDimensions, unsigned int, 1, ImageDimension);
+  itkGetConstMacro(NumberOfTransformDimensions, unsigned int);
+
+  /**
+   * Set/Get the behavior of wisdom plan creation. The default is
+   * provided by FFTWGlobalConfiguration::GetPlanRigor().
+   *
+   * The parameter is one of the FFTW planner rigor flags FFTW_ESTIMATE, FFTW_MEASURE,
+   * FFTW_PATIENT, FFTW_EXHAUSTIVE provided by FFTWGlobalConfiguration.
+   *
+   * This is not used when ITK_USE_CUFFTW is enabled.
+   *
+   * /sa FFTWGlobalConfiguration
+   */
+  virtual void SetPlanRigor( const int & value )
+  {
+#ifndef ITK_USE_CUFFTW
+    // use that method to check the value
+    FFTWGlobalConfiguration::GetPlanRigorName( value );
+#endif
+    if( m_PlanRigor != value )
+      {
+      m_PlanRigor = value;
+      this->Modified();
+      }
+  }
+  itkGetConstReferenceMacro( PlanRigor, int );
+  void SetPlanRigor( const std::string & name )
+  {
+#ifndef ITK_USE_CUFFTW
+    this->SetPlanRigor( FFTWGlobalConfiguration::GetPlanRigorValue( name ) );
+#endif
+  }
+
+protected:
+  FFTWComplexToComplexBatchFFTImageFilter();
+  ~FFTWComplexToComplexBatchFFTImageFilter() override {}
+
+  void GenerateInputRequestedRegion() override;
+
+  void EnlargeOutputRequestedRegion(DataObject *output) override;
+
+  void UpdateOutputData(DataObject *output) override;
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  TransformDirectionType m_TransformDirection;
+
+  unsigned int m_NumberOfTransformDimensions;
+
+  bool m_CanUseDestructiveAlgorithm;
+
+  int m_PlanRigor;
+};
+
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFFTWComplexToComplexBatchFFTImageFilter.hxx"
+#endif
+
+#endif //itkFFTWComplexToComplexBatchFFTImageFilter_h
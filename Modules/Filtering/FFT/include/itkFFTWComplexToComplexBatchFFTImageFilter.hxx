@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFFTWComplexToComplexBatchFFTImageFilter_hxx
+#define itkFFTWComplexToComplexBatchFFTImageFilter_hxx
+
+#include "itkFFTWComplexToComplexBatchFFTImageFilter.h"
+#include "itkProgressReporter.h"
+
+#include <type_traits>
+
+namespace itk
+{
+
+template< typename TImage >
+FFTWComplexToComplexBatchFFTImageFilter< TImage >
+::FFTWComplexToComplexBatchFFTImageFilter() :
+  m_TransformDirection( FORWARD ),
+  m_NumberOfTransformDimensions( ImageDimension ),
+  m_CanUseDestructiveAlgorithm( false ),
+#ifndef ITK_USE_CUFFTW
+  m_PlanRigor( FFTWGlobalConfiguration::GetPlanRigor() )
+#else
+  m_PlanRigor( FFTW_ESTIMATE )
+#endif
+{
+}
+
+template< typename TImage >
+void
+FFTWComplexToComplexBatchFFTImageFilter< TImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  auto * input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TImage >
+void
+FFTWComplexToComplexBatchFFTImageFilter< TImage >
+::EnlargeOutputRequestedRegion(DataObject * output)
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TImage >
+void
+FFTWComplexToComplexBatchFFTImageFilter< TImage >
+::GenerateData()
+{
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+
+  // we don't have a nice progress to report, but at least this simple line
+  // reports the beginning and the end of the process
+  ProgressReporter progress(this, 0, 1);
+
+  this->AllocateOutputs();
+
+  const typename InputImageType::SizeType & size = input->GetLargestPossibleRegion().GetSize();
+  // the complex pixels of an Image are reported as two components
+  const int numberOfComponents = std::is_same< typename ImageType::PixelType, InternalPixelType >::value
+                                 ? 1 : static_cast< int >( input->GetNumberOfComponentsPerPixel() );
+
+  // fftw expects the sizes of the transformed dimensions with the fastest
+  // varying one last
+  const auto rank = static_cast< int >( m_NumberOfTransformDimensions );
+  int sizes[ImageDimension];
+  int transformSize = 1;
+  for ( int i = 0; i < rank; ++i )
+    {
+    sizes[( rank - 1 ) - i] = static_cast< int >( size[i] );
+    transformSize *= sizes[( rank - 1 ) - i];
+    }
+  SizeValueType numberOfImages = 1;
+  for ( unsigned int i = m_NumberOfTransformDimensions; i < ImageDimension; ++i )
+    {
+    numberOfImages *= size[i];
+    }
+
+  const int sign = ( m_TransformDirection == FORWARD ) ? FFTW_FORWARD : FFTW_BACKWARD;
+  unsigned flags = m_PlanRigor;
+  if ( !m_CanUseDestructiveAlgorithm )
+    {
+    // if the input is about to be destroyed, there is no need to force fftw
+    // to use an non destructive algorithm. If it is not released however,
+    // we must be careful to not destroy it.
+    flags = flags | FFTW_PRESERVE_INPUT;
+    }
+
+  using ComplexType = typename FFTWProxyType::ComplexType;
+  auto * in = reinterpret_cast< ComplexType * >( const_cast< InternalPixelType * >( input->GetBufferPointer() ) );
+  auto * out = reinterpret_cast< ComplexType * >( output->GetBufferPointer() );
+  const auto threads = static_cast< int >( this->GetNumberOfWorkUnits() );
+
+  if ( numberOfComponents == 1 )
+    {
+    // the images of the stack are contiguous: a single plan transforms
+    // all of them
+    typename FFTWProxyType::PlanPointer plan =
+      FFTWProxyType::CachedPlan_many_dft( rank, sizes, static_cast< int >( numberOfImages ),
+                                          in, 1, transformSize,
+                                          out, 1, transformSize,
+                                          sign, flags, threads );
+    FFTWProxyType::Execute_dft( plan, in, out );
+    }
+  else
+    {
+    // the components are interleaved: a plan transforms all the components
+    // of an image. It is looked up for each image of the stack as their
+    // alignment may differ.
+    const SizeValueType imageOffset = static_cast< SizeValueType >( transformSize ) * numberOfComponents;
+    for ( SizeValueType image = 0; image < numberOfImages; ++image )
+      {
+      ComplexType * imageIn = in + image * imageOffset;
+      ComplexType * imageOut = out + image * imageOffset;
+      typename FFTWProxyType::PlanPointer plan =
+        FFTWProxyType::CachedPlan_many_dft( rank, sizes, numberOfComponents,
+                                            imageIn, numberOfComponents, 1,
+                                            imageOut, numberOfComponents, 1,
+                                            sign, flags, threads );
+      FFTWProxyType::Execute_dft( plan, imageIn, imageOut );
+      }
+    }
+
+  // normalize the output of the backward transform
+  if ( m_TransformDirection == INVERSE )
+    {
+    InternalPixelType * buffer = output->GetBufferPointer();
+    const RealType scale = RealType( 1 ) / static_cast< RealType >( transformSize );
+    const SizeValueType numberOfValues = numberOfImages * transformSize * numberOfComponents;
+    this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+    this->GetMultiThreader()->ParallelizeArray( 0, numberOfValues,
+      [buffer, scale]( SizeValueType i )
+        {
+        buffer[i] *= scale;
+        },
+      nullptr );
+    }
+}
+
+template< typename TImage >
+void
+FFTWComplexToComplexBatchFFTImageFilter< TImage >
+::UpdateOutputData(DataObject * output)
+{
+  // we need to catch that information now, because it is changed later
+  // during the pipeline execution, and thus can't be grabbed in
+  // GenerateData().
+  m_CanUseDestructiveAlgorithm = this->GetInput()->GetReleaseDataFlag();
+  Superclass::UpdateOutputData( output );
+}
+
+template< typename TImage >
+void
+FFTWComplexToComplexBatchFFTImageFilter< TImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "TransformDirection: " << ( m_TransformDirection == FORWARD ? "FORWARD" : "INVERSE" ) << std::endl;
+  os << indent << "NumberOfTransformDimensions: " << m_NumberOfTransformDimensions << std::endl;
+#ifndef ITK_USE_CUFFTW
+  os << indent << "PlanRigor: " << FFTWGlobalConfiguration::GetPlanRigorName(m_PlanRigor) << " (" << m_PlanRigor << ")" << std::endl;
+#endif
+}
+
+} // end namespace itk
+
+#endif // itkFFTWComplexToComplexBatchFFTImageFilter_hxx
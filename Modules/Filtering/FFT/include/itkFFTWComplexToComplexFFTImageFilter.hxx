@@ -79,7 +79,6 @@ FFTWComplexToComplexFFTImageFilter< TImage >
     transformDirection = -1;
     }
 
-  typename FFTWProxyType::PlanType plan;
   auto * in = (typename FFTWProxyType::ComplexType*) input->GetBufferPointer();
   auto * out = (typename FFTWProxyType::ComplexType*) output->GetBufferPointer();
   int flags = m_PlanRigor;
@@ -97,15 +96,15 @@ FFTWComplexToComplexFFTImageFilter< TImage >
     sizes[(ImageDimension - 1) - i] = inputSize[i];
     }
 
-  plan = FFTWProxyType::Plan_dft(ImageDimension,sizes,
-                                    in,
-                                    out,
-                                    transformDirection,
-                                    flags,
-                                    this->GetNumberOfWorkUnits());
+  typename FFTWProxyType::PlanPointer plan =
+    FFTWProxyType::CachedPlan_dft(ImageDimension,sizes,
+                                  in,
+                                  out,
+                                  transformDirection,
+                                  flags,
+                                  this->GetNumberOfWorkUnits());
 
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  FFTWProxyType::Execute_dft(plan, in, out);
 }
 
 
@@ -24,7 +24,10 @@
 #if defined(ITK_USE_FFTWF) || defined(ITK_USE_FFTWD)
 
 #include "ITKFFTExport.h"
+#include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "itksys/SystemTools.hxx"
 #include "itksys/SystemInformation.hxx"
@@ -54,6 +57,9 @@
 //                             file to be generated.  If this is
 //                             set, then ITK_FFTW_WISDOM_CACHE_BASE
 //                             is ignored.
+//ITK_FFTW_PLAN_CACHE_SIZE - Defines the maximum number of plans kept
+//                           for reuse by the FFTW filters (32 by
+//                           default, 0 disables the plan cache).
 //
 // The above behaviors can also be controlled by the application.
 //
@@ -290,6 +296,46 @@ public:
   static bool ImportDefaultWisdomFile();
   static bool ExportDefaultWisdomFile();
 
+  /** Key identifying a cached plan: the precision, the kind of transform,
+   * the sizes, the layout of the arrays, the direction, the planner flags,
+   * the number of threads and the alignment of the arrays. */
+  using PlanKeyType = std::vector< int >;
+
+  /** A cached plan of any precision. It is destroyed once it has been
+   * evicted from the cache and released by all its users. */
+  using CachedPlanPointer = std::shared_ptr< void >;
+
+  /**
+   * \brief Set/Get the maximum number of plans kept for reuse.
+   *
+   * Creating a plan is often much more expensive than executing it,
+   * especially for small images and plan rigors other than FFTW_ESTIMATE.
+   * The FFTW filters look their plan up in a process wide cache and
+   * execute it on their own buffers, so a plan is created only once for
+   * the images of the same size and memory layout. The least recently
+   * used plans are destroyed when the cache is full. A size of 0 disables
+   * the cache. If the environmental variable "ITK_FFTW_PLAN_CACHE_SIZE",
+   * is set, then it overrides the default size of 32.
+   */
+  static void SetPlanCacheSize( const SizeValueType & v );
+  static SizeValueType GetPlanCacheSize();
+
+  /** Get the number of plans currently cached. */
+  static SizeValueType GetNumberOfCachedPlans();
+
+  /** Release all the cached plans. */
+  static void ClearPlanCache();
+
+  /** Return the cached plan with that key, or a null pointer. This is
+   * used by fftw::Proxy and should not be called directly. */
+  static CachedPlanPointer FindPlan( const PlanKeyType & key );
+
+  /** Add a plan to the cache and return the plan cached for that key,
+   * which is an older one if another thread has cached the same plan
+   * concurrently. This is used by fftw::Proxy and should not be called
+   * directly. */
+  static CachedPlanPointer InsertPlan( const PlanKeyType & key, const CachedPlanPointer & plan );
+
 private:
   FFTWGlobalConfiguration(); //This will process env variables
   ~FFTWGlobalConfiguration() override; //This will write cache file if requested.
@@ -312,6 +358,10 @@ private:
   bool                          m_WriteWisdomCache;
   bool                          m_ReadWisdomCache;
   std::string                   m_WisdomCacheBase;
+  //Most recently used plans first.
+  std::list< std::pair< PlanKeyType, CachedPlanPointer > > m_CachedPlans;
+  SizeValueType                 m_PlanCacheSize;
+  std::mutex                    m_PlanCacheLock;
   //m_WriteWisdomCache Controls the behavior of default
   //wisdom file creation policies.
   WisdomFilenameGeneratorBase * m_WisdomFilenameGenerator;
@@ -90,16 +90,16 @@ FFTWHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
     in = new typename FFTWProxyType::ComplexType[totalInputSize];
     }
   OutputPixelType * out = outputPtr->GetBufferPointer();
-  typename FFTWProxyType::PlanType plan;
 
   int sizes[ImageDimension];
   for( unsigned int i = 0; i < ImageDimension; i++ )
     {
     sizes[(ImageDimension - 1) - i] = outputSize[i];
     }
-  plan = FFTWProxyType::Plan_dft_c2r( ImageDimension, sizes, in, out, m_PlanRigor,
-                                      MultiThreaderBase::GetGlobalDefaultNumberOfThreads(),
-                                      !m_CanUseDestructiveAlgorithm );
+  typename FFTWProxyType::PlanPointer plan =
+    FFTWProxyType::CachedPlan_dft_c2r( ImageDimension, sizes, in, out, m_PlanRigor,
+                                       MultiThreaderBase::GetGlobalDefaultNumberOfThreads(),
+                                       !m_CanUseDestructiveAlgorithm );
   if( !m_CanUseDestructiveAlgorithm )
     {
     // complex<double> and double[2] types are compatible memory layouts.
@@ -109,10 +109,9 @@ FFTWHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
                inputPtr->GetBufferPointer()+totalInputSize,
                reinterpret_cast< typename InputImageType::PixelType * > (in) );
     }
-  FFTWProxyType::Execute( plan );
+  FFTWProxyType::Execute_dft_c2r( plan, in, out );
 
   // Some cleanup.
-  FFTWProxyType::DestroyPlan( plan );
   if( !m_CanUseDestructiveAlgorithm )
     {
     delete[] in;
@@ -78,7 +78,6 @@ FFTWRealToHalfHermitianForwardFFTImageFilter< TInputImage, TOutputImage >
     totalOutputSize *= outputSize[i];
     }
 
-  typename FFTWProxyType::PlanType plan;
   auto * in = const_cast<InputPixelType*>(inputPtr->GetBufferPointer());
   auto * out = (typename FFTWProxyType::ComplexType*) outputPtr->GetBufferPointer();
   int flags = m_PlanRigor;
@@ -95,10 +94,10 @@ FFTWRealToHalfHermitianForwardFFTImageFilter< TInputImage, TOutputImage >
     sizes[(ImageDimension - 1) - i] = inputSize[i];
     }
 
-  plan = FFTWProxyType::Plan_dft_r2c(ImageDimension, sizes, in, out, flags,
-                                     MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  typename FFTWProxyType::PlanPointer plan =
+    FFTWProxyType::CachedPlan_dft_r2c(ImageDimension, sizes, in, out, flags,
+                                      MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+  FFTWProxyType::Execute_dft_r2c(plan, in, out);
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -0,0 +1,82 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeComplexToComplexFFTImageFilter_h
+#define itkNativeComplexToComplexFFTImageFilter_h
+
+#include "itkComplexToComplexFFTImageFilter.h"
+
+namespace itk
+{
+/** \class NativeComplexToComplexFFTImageFilter
+ *
+ * \brief Complex to complex Fast Fourier Transform implemented in ITK.
+ *
+ * This filter transforms complex images of any size with the
+ * multithreaded transforms of NativeFFTCommon. The inverse transform is
+ * normalized.
+ *
+ * \ingroup FourierTransform
+ * \ingroup MultiThreaded
+ * \ingroup ITKFFT
+ *
+ * \sa ComplexToComplexFFTImageFilter
+ * \sa NativeFFTCommon
+ * \sa NativeFFTImageFilterFactory
+ */
+template< typename TImage >
+class ITK_TEMPLATE_EXPORT NativeComplexToComplexFFTImageFilter:
+  public ComplexToComplexFFTImageFilter< TImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(NativeComplexToComplexFFTImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = NativeComplexToComplexFFTImageFilter;
+  using Superclass = ComplexToComplexFFTImageFilter< TImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using ImageType = TImage;
+  using PixelType = typename ImageType::PixelType;
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(NativeComplexToComplexFFTImageFilter,
+               ComplexToComplexFFTImageFilter);
+
+  static constexpr unsigned int ImageDimension = ImageType::ImageDimension;
+
+protected:
+  NativeComplexToComplexFFTImageFilter() = default;
+  ~NativeComplexToComplexFFTImageFilter() override = default;
+
+  void GenerateData() override;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkNativeComplexToComplexFFTImageFilter.hxx"
+#endif
+
+#endif //itkNativeComplexToComplexFFTImageFilter_h
@@ -0,0 +1,70 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeComplexToComplexFFTImageFilter_hxx
+#define itkNativeComplexToComplexFFTImageFilter_hxx
+
+#include "itkNativeComplexToComplexFFTImageFilter.h"
+#include "itkImageAlgorithm.h"
+#include "itkNativeFFTCommon.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+
+template< typename TImage >
+void
+NativeComplexToComplexFFTImageFilter< TImage >
+::GenerateData()
+{
+  // Get pointers to the input and output.
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
+
+  if ( !input || !output )
+    {
+    return;
+    }
+
+  // We don't have a nice progress to report, but at least this simple line
+  // reports the beginning and the end of the process.
+  ProgressReporter progress( this, 0, 1 );
+
+  // Allocate output buffer memory.
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->Allocate();
+
+  // Copy the input to the output, and work in place on the output.
+  const typename ImageType::RegionType bufferedRegion = input->GetBufferedRegion();
+  ImageAlgorithm::Copy< ImageType, ImageType >( input, output, bufferedRegion, bufferedRegion );
+
+  using RealType = typename PixelType::value_type;
+  int sign = NativeFFTCommon::FORWARD;
+  RealType scale = RealType( 1 );
+  if ( this->GetTransformDirection() == Superclass::INVERSE )
+    {
+    sign = NativeFFTCommon::BACKWARD;
+    scale = RealType( 1 ) / static_cast< RealType >( bufferedRegion.GetNumberOfPixels() );
+    }
+  NativeFFTCommon::ComplexToComplex( output->GetBufferPointer(), bufferedRegion.GetSize().GetSize(),
+                                     ImageDimension, sign, scale,
+                                     this->GetMultiThreader(), this->GetNumberOfWorkUnits() );
+}
+
+} // end namespace itk
+
+#endif // itkNativeComplexToComplexFFTImageFilter_hxx
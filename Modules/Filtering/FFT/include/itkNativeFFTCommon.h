@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeFFTCommon_h
+#define itkNativeFFTCommon_h
+
+#include "itkIntTypes.h"
+#include "itkMultiThreaderBase.h"
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace itk
+{
+
+/** \class NativeFFTCommon
+ * \brief Fast Fourier transforms implemented in ITK, without external
+ * dependency.
+ *
+ * This is the engine of the Native*FFTImageFilter classes, a permissively
+ * licensed alternative to FFTW that is faster than the Vnl filters:
+ *
+ * - images of any size are supported. Sizes whose prime factors are 2, 3
+ *   and 5 are transformed with a mixed radix Stockham algorithm; other
+ *   prime factors use a generic radix or, when it is cheaper, Bluestein's
+ *   algorithm.
+ * - the lines of the image are transformed several at a time, with their
+ *   values interleaved in split real and imaginary buffers, so that the
+ *   butterflies are vectorized by the compiler across the lines.
+ * - real images are transformed two lines at a time, as the real and
+ *   imaginary parts of a complex line.
+ * - the batches of lines are distributed over the work units of a
+ *   multi-threader.
+ *
+ * The transforms are not normalized, unless a scale factor is given.
+ *
+ * \ingroup FourierTransform
+ * \ingroup ITKFFT
+ */
+struct NativeFFTCommon
+{
+  /** Sizes whose prime factors are not greater than this one are
+   * transformed with the fastest code. */
+  static constexpr SizeValueType GREATEST_PRIME_FACTOR = 5;
+
+  /** Sign of the exponent of the forward and backward transforms. */
+  static constexpr int FORWARD = -1;
+  static constexpr int BACKWARD = 1;
+
+  /** \class Plan
+   * \brief One dimensional complex transform of a given size.
+   *
+   * A plan transforms several signals at once. The values of the signals
+   * are interleaved: value k of signal l is at index k * lanes + l of
+   * the real and imaginary buffers. A plan can be shared by several
+   * threads.
+   *
+   * \ingroup ITKFFT
+   */
+  template< typename TReal >
+  class Plan
+  {
+  public:
+    using RealType = TReal;
+
+    explicit Plan( SizeValueType size );
+
+    SizeValueType GetSize() const
+    {
+      return m_Size;
+    }
+
+    /** Number of values of the work buffer of Transform(). */
+    SizeValueType GetWorkSize( SizeValueType lanes ) const;
+
+    /** Transform in place the interleaved signals. sign is FORWARD or
+     * BACKWARD. */
+    void Transform( RealType * re, RealType * im, SizeValueType lanes, int sign, RealType * work ) const;
+
+  private:
+    struct Stage
+    {
+      SizeValueType m_Radix;
+      SizeValueType m_Length;
+      /** Twiddle factors of the forward transform, radix - 1 per
+       * butterfly. */
+      std::vector< RealType > m_TwiddleRe;
+      std::vector< RealType > m_TwiddleIm;
+      /** Roots of unity of the generic radix butterfly. */
+      std::vector< RealType > m_RootRe;
+      std::vector< RealType > m_RootIm;
+    };
+
+    void TransformStockham( RealType * re, RealType * im, SizeValueType lanes, int sign, RealType * work ) const;
+
+    void TransformBluestein( RealType * re, RealType * im, SizeValueType lanes, int sign, RealType * work ) const;
+
+    static void Pass( const Stage & stage, SizeValueType stride, int sign,
+                      const RealType * xRe, const RealType * xIm, RealType * yRe, RealType * yIm );
+
+    SizeValueType        m_Size;
+    std::vector< Stage > m_Stages;
+
+    /** Bluestein's algorithm computes the transform as a convolution of
+     * size m_BluesteinSize. */
+    std::unique_ptr< Plan >  m_BluesteinPlan;
+    SizeValueType            m_BluesteinSize{ 0 };
+    std::vector< RealType >  m_ChirpRe;
+    std::vector< RealType >  m_ChirpIm;
+    std::vector< RealType >  m_ChirpSpectrumRe;
+    std::vector< RealType >  m_ChirpSpectrumIm;
+  };
+
+  /** Transform in place a complex image buffer whose size along each
+   * dimension is given by size, with the first dimension varying the
+   * fastest. The result is multiplied by scale. */
+  template< typename TReal >
+  static void ComplexToComplex( std::complex< TReal > * data, const SizeValueType * size, unsigned int dimension,
+                                int sign, TReal scale,
+                                MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits );
+
+  /** Forward transform of a real image. The output has size[0] / 2 + 1
+   * values along the first dimension. */
+  template< typename TReal >
+  static void RealToHalfHermitian( const TReal * input, std::complex< TReal > * output,
+                                   const SizeValueType * size, unsigned int dimension,
+                                   MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits );
+
+  /** Backward transform of the half of a Hermitian image, multiplied by
+   * scale. size is the size of the real output. The input is
+   * overwritten. */
+  template< typename TReal >
+  static void HalfHermitianToReal( std::complex< TReal > * input, TReal * output,
+                                   const SizeValueType * size, unsigned int dimension, TReal scale,
+                                   MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits );
+
+  /** Number of signals transformed at once: the width of a 256 bits
+   * vector register. */
+  template< typename TReal >
+  static constexpr SizeValueType GetNumberOfLanes()
+  {
+    return 32 / sizeof( TReal );
+  }
+
+private:
+  /** Transform in place the lines along dimension d of a complex
+   * buffer. */
+  template< typename TReal >
+  static void TransformLines( std::complex< TReal > * data, const SizeValueType * size, unsigned int dimension,
+                              unsigned int d, int sign, TReal scale,
+                              MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits );
+
+  /** Run process( firstBatch, endBatch ) over numberOfBatches batches
+   * split among the work units. */
+  template< typename TFunction >
+  static void ParallelizeBatches( SizeValueType numberOfBatches, MultiThreaderBase * multiThreader,
+                                  ThreadIdType numberOfWorkUnits, TFunction process );
+};
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkNativeFFTCommon.hxx"
+#endif
+
+#endif // itkNativeFFTCommon_h
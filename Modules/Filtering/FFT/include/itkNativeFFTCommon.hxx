@@ -0,0 +1,789 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeFFTCommon_hxx
+#define itkNativeFFTCommon_hxx
+
+#include "itkNativeFFTCommon.h"
+#include "itkMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+template< typename TReal >
+NativeFFTCommon::Plan< TReal >
+::Plan( SizeValueType size ) :
+  m_Size( size )
+{
+  // Radix 4 first, as its butterfly is the cheapest per value, then the
+  // remaining prime factors in increasing order.
+  std::vector< SizeValueType > factors;
+  SizeValueType remaining = size;
+  while ( remaining % 4 == 0 )
+    {
+    factors.push_back( 4 );
+    remaining /= 4;
+    }
+  for ( SizeValueType factor = 2; factor * factor <= remaining; factor += ( factor == 2 ? 1 : 2 ) )
+    {
+    while ( remaining % factor == 0 )
+      {
+      factors.push_back( factor );
+      remaining /= factor;
+      }
+    }
+  if ( remaining > 1 )
+    {
+    factors.push_back( remaining );
+    }
+
+  // The generic radix butterfly costs radix squared operations per
+  // radix values, Bluestein's algorithm two transforms of a size with
+  // small prime factors that is at least twice as large.
+  double directCost = 0.0;
+  SizeValueType greatestFactor = 1;
+  for ( SizeValueType factor : factors )
+    {
+    directCost += static_cast< double >( factor <= GREATEST_PRIME_FACTOR ? factor : 2 * factor );
+    greatestFactor = std::max( greatestFactor, factor );
+    }
+  directCost *= static_cast< double >( size );
+
+  if ( greatestFactor > GREATEST_PRIME_FACTOR )
+    {
+    SizeValueType bluesteinSize = 2 * size - 1;
+    for ( ;; ++bluesteinSize )
+      {
+      SizeValueType reduced = bluesteinSize;
+      for ( SizeValueType factor : { 2, 3, 5 } )
+        {
+        while ( reduced % factor == 0 )
+          {
+          reduced /= factor;
+          }
+        }
+      if ( reduced == 1 )
+        {
+        break;
+        }
+      }
+    double bluesteinFactorSum = 0.0;
+    SizeValueType reduced = bluesteinSize;
+    for ( SizeValueType factor : { 2, 3, 5 } )
+      {
+      while ( reduced % factor == 0 )
+        {
+        bluesteinFactorSum += static_cast< double >( factor );
+        reduced /= factor;
+        }
+      }
+    const double bluesteinCost = static_cast< double >( bluesteinSize ) * ( 2.0 * bluesteinFactorSum + 6.0 );
+    if ( bluesteinCost < directCost )
+      {
+      m_BluesteinSize = bluesteinSize;
+      }
+    }
+
+  if ( m_BluesteinSize > 0 )
+    {
+    m_BluesteinPlan.reset( new Plan( m_BluesteinSize ) );
+
+    // chirp[k] = exp( -i pi k^2 / n ), with k^2 reduced modulo 2n to keep
+    // the angles accurate.
+    m_ChirpRe.resize( size );
+    m_ChirpIm.resize( size );
+    for ( SizeValueType k = 0; k < size; ++k )
+      {
+      const SizeValueType k2 = ( ( k % ( 2 * size ) ) * ( k % ( 2 * size ) ) ) % ( 2 * size );
+      const double angle = -Math::pi * static_cast< double >( k2 ) / static_cast< double >( size );
+      m_ChirpRe[k] = static_cast< RealType >( std::cos( angle ) );
+      m_ChirpIm[k] = static_cast< RealType >( std::sin( angle ) );
+      }
+
+    // The convolution kernel is the conjugate chirp, wrapped around. Its
+    // transform includes the normalization of the backward transform.
+    m_ChirpSpectrumRe.assign( m_BluesteinSize, RealType( 0 ) );
+    m_ChirpSpectrumIm.assign( m_BluesteinSize, RealType( 0 ) );
+    for ( SizeValueType k = 0; k < size; ++k )
+      {
+      m_ChirpSpectrumRe[k] = m_ChirpRe[k];
+      m_ChirpSpectrumIm[k] = -m_ChirpIm[k];
+      if ( k > 0 )
+        {
+        m_ChirpSpectrumRe[m_BluesteinSize - k] = m_ChirpRe[k];
+        m_ChirpSpectrumIm[m_BluesteinSize - k] = -m_ChirpIm[k];
+        }
+      }
+    std::vector< RealType > work( m_BluesteinPlan->GetWorkSize( 1 ) );
+    m_BluesteinPlan->Transform( m_ChirpSpectrumRe.data(), m_ChirpSpectrumIm.data(), 1, FORWARD, work.data() );
+    const RealType normalization = RealType( 1 ) / static_cast< RealType >( m_BluesteinSize );
+    for ( SizeValueType k = 0; k < m_BluesteinSize; ++k )
+      {
+      m_ChirpSpectrumRe[k] *= normalization;
+      m_ChirpSpectrumIm[k] *= normalization;
+      }
+    return;
+    }
+
+  SizeValueType length = size;
+  for ( SizeValueType radix : factors )
+    {
+    Stage stage;
+    stage.m_Radix = radix;
+    stage.m_Length = length;
+    const SizeValueType numberOfButterflies = length / radix;
+    stage.m_TwiddleRe.resize( numberOfButterflies * ( radix - 1 ) );
+    stage.m_TwiddleIm.resize( numberOfButterflies * ( radix - 1 ) );
+    for ( SizeValueType p = 0; p < numberOfButterflies; ++p )
+      {
+      for ( SizeValueType u = 1; u < radix; ++u )
+        {
+        const double angle = -2.0 * Math::pi * static_cast< double >( ( p * u ) % length )
+                             / static_cast< double >( length );
+        stage.m_TwiddleRe[p * ( radix - 1 ) + u - 1] = static_cast< RealType >( std::cos( angle ) );
+        stage.m_TwiddleIm[p * ( radix - 1 ) + u - 1] = static_cast< RealType >( std::sin( angle ) );
+        }
+      }
+    if ( radix > GREATEST_PRIME_FACTOR )
+      {
+      stage.m_RootRe.resize( radix );
+      stage.m_RootIm.resize( radix );
+      for ( SizeValueType j = 0; j < radix; ++j )
+        {
+        const double angle = -2.0 * Math::pi * static_cast< double >( j ) / static_cast< double >( radix );
+        stage.m_RootRe[j] = static_cast< RealType >( std::cos( angle ) );
+        stage.m_RootIm[j] = static_cast< RealType >( std::sin( angle ) );
+        }
+      }
+    m_Stages.push_back( std::move( stage ) );
+    length /= radix;
+    }
+}
+
+template< typename TReal >
+SizeValueType
+NativeFFTCommon::Plan< TReal >
+::GetWorkSize( SizeValueType lanes ) const
+{
+  if ( m_BluesteinPlan )
+    {
+    return 2 * m_BluesteinSize * lanes + m_BluesteinPlan->GetWorkSize( lanes );
+    }
+  return 2 * m_Size * lanes;
+}
+
+template< typename TReal >
+void
+NativeFFTCommon::Plan< TReal >
+::Transform( RealType * re, RealType * im, SizeValueType lanes, int sign, RealType * work ) const
+{
+  if ( m_BluesteinPlan )
+    {
+    this->TransformBluestein( re, im, lanes, sign, work );
+    }
+  else
+    {
+    this->TransformStockham( re, im, lanes, sign, work );
+    }
+}
+
+template< typename TReal >
+void
+NativeFFTCommon::Plan< TReal >
+::TransformStockham( RealType * re, RealType * im, SizeValueType lanes, int sign, RealType * work ) const
+{
+  // Each pass reads one buffer and writes the other one, in natural order
+  // after the last pass.
+  RealType * xRe = re;
+  RealType * xIm = im;
+  RealType * yRe = work;
+  RealType * yIm = work + m_Size * lanes;
+  SizeValueType stride = lanes;
+  for ( const Stage & stage : m_Stages )
+    {
+    Pass( stage, stride, sign, xRe, xIm, yRe, yIm );
+    std::swap( xRe, yRe );
+    std::swap( xIm, yIm );
+    stride *= stage.m_Radix;
+    }
+  if ( xRe != re )
+    {
+    std::copy( xRe, xRe + m_Size * lanes, re );
+    std::copy( xIm, xIm + m_Size * lanes, im );
+    }
+}
+
+template< typename TReal >
+void
+NativeFFTCommon::Plan< TReal >
+::Pass( const Stage & stage, SizeValueType stride, int sign,
+        const RealType * xRe, const RealType * xIm, RealType * yRe, RealType * yIm )
+{
+  // Decimation in frequency butterflies: the values t * m + p, scaled by
+  // stride, are combined into the values r * p + u.
+  const SizeValueType r = stage.m_Radix;
+  const SizeValueType m = stage.m_Length / r;
+  const SizeValueType s = stride;
+  const auto sg = static_cast< RealType >( sign );
+
+  for ( SizeValueType p = 0; p < m; ++p )
+    {
+    const RealType * twRe = stage.m_TwiddleRe.data() + p * ( r - 1 );
+    const RealType * twIm = stage.m_TwiddleIm.data() + p * ( r - 1 );
+    const RealType * x0Re = xRe + s * p;
+    const RealType * x0Im = xIm + s * p;
+    RealType * y0Re = yRe + s * r * p;
+    RealType * y0Im = yIm + s * r * p;
+    const SizeValueType ms = m * s;
+
+    switch ( r )
+      {
+      case 2:
+        {
+        const RealType w1r = twRe[0];
+        const RealType w1i = -sg * twIm[0];
+        for ( SizeValueType q = 0; q < s; ++q )
+          {
+          const RealType a0r = x0Re[q];
+          const RealType a0i = x0Im[q];
+          const RealType a1r = x0Re[q + ms];
+          const RealType a1i = x0Im[q + ms];
+          const RealType b1r = a0r - a1r;
+          const RealType b1i = a0i - a1i;
+          y0Re[q] = a0r + a1r;
+          y0Im[q] = a0i + a1i;
+          y0Re[q + s] = b1r * w1r - b1i * w1i;
+          y0Im[q + s] = b1r * w1i + b1i * w1r;
+          }
+        break;
+        }
+      case 3:
+        {
+        const RealType w1r = twRe[0];
+        const RealType w1i = -sg * twIm[0];
+        const RealType w2r = twRe[1];
+        const RealType w2i = -sg * twIm[1];
+        const RealType c = RealType( -0.5 );
+        const RealType sn = sg * static_cast< RealType >( 0.86602540378443864676 );
+        for ( SizeValueType q = 0; q < s; ++q )
+          {
+          const RealType a0r = x0Re[q];
+          const RealType a0i = x0Im[q];
+          const RealType a1r = x0Re[q + ms];
+          const RealType a1i = x0Im[q + ms];
+          const RealType a2r = x0Re[q + 2 * ms];
+          const RealType a2i = x0Im[q + 2 * ms];
+          const RealType t1r = a1r + a2r;
+          const RealType t1i = a1i + a2i;
+          const RealType t2r = a0r + c * t1r;
+          const RealType t2i = a0i + c * t1i;
+          const RealType t3r = sn * ( a1r - a2r );
+          const RealType t3i = sn * ( a1i - a2i );
+          const RealType b1r = t2r - t3i;
+          const RealType b1i = t2i + t3r;
+          const RealType b2r = t2r + t3i;
+          const RealType b2i = t2i - t3r;
+          y0Re[q] = a0r + t1r;
+          y0Im[q] = a0i + t1i;
+          y0Re[q + s] = b1r * w1r - b1i * w1i;
+          y0Im[q + s] = b1r * w1i + b1i * w1r;
+          y0Re[q + 2 * s] = b2r * w2r - b2i * w2i;
+          y0Im[q + 2 * s] = b2r * w2i + b2i * w2r;
+          }
+        break;
+        }
+      case 4:
+        {
+        const RealType w1r = twRe[0];
+        const RealType w1i = -sg * twIm[0];
+        const RealType w2r = twRe[1];
+        const RealType w2i = -sg * twIm[1];
+        const RealType w3r = twRe[2];
+        const RealType w3i = -sg * twIm[2];
+        for ( SizeValueType q = 0; q < s; ++q )
+          {
+          const RealType a0r = x0Re[q];
+          const RealType a0i = x0Im[q];
+          const RealType a1r = x0Re[q + ms];
+          const RealType a1i = x0Im[q + ms];
+          const RealType a2r = x0Re[q + 2 * ms];
+          const RealType a2i = x0Im[q + 2 * ms];
+          const RealType a3r = x0Re[q + 3 * ms];
+          const RealType a3i = x0Im[q + 3 * ms];
+          const RealType t0r = a0r + a2r;
+          const RealType t0i = a0i + a2i;
+          const RealType t1r = a0r - a2r;
+          const RealType t1i = a0i - a2i;
+          const RealType t2r = a1r + a3r;
+          const RealType t2i = a1i + a3i;
+          // ( a1 - a3 ) times the fourth root of unity i * sign
+          const RealType t3r = -sg * ( a1i - a3i );
+          const RealType t3i = sg * ( a1r - a3r );
+          const RealType b1r = t1r + t3r;
+          const RealType b1i = t1i + t3i;
+          const RealType b2r = t0r - t2r;
+          const RealType b2i = t0i - t2i;
+          const RealType b3r = t1r - t3r;
+          const RealType b3i = t1i - t3i;
+          y0Re[q] = t0r + t2r;
+          y0Im[q] = t0i + t2i;
+          y0Re[q + s] = b1r * w1r - b1i * w1i;
+          y0Im[q + s] = b1r * w1i + b1i * w1r;
+          y0Re[q + 2 * s] = b2r * w2r - b2i * w2i;
+          y0Im[q + 2 * s] = b2r * w2i + b2i * w2r;
+          y0Re[q + 3 * s] = b3r * w3r - b3i * w3i;
+          y0Im[q + 3 * s] = b3r * w3i + b3i * w3r;
+          }
+        break;
+        }
+      case 5:
+        {
+        const RealType w1r = twRe[0];
+        const RealType w1i = -sg * twIm[0];
+        const RealType w2r = twRe[1];
+        const RealType w2i = -sg * twIm[1];
+        const RealType w3r = twRe[2];
+        const RealType w3i = -sg * twIm[2];
+        const RealType w4r = twRe[3];
+        const RealType w4i = -sg * twIm[3];
+        const RealType c1 = static_cast< RealType >( 0.30901699437494742410 );
+        const RealType c2 = static_cast< RealType >( -0.80901699437494742410 );
+        const RealType s1 = sg * static_cast< RealType >( 0.95105651629515357212 );
+        const RealType s2 = sg * static_cast< RealType >( 0.58778525229247312917 );
+        for ( SizeValueType q = 0; q < s; ++q )
+          {
+          const RealType a0r = x0Re[q];
+          const RealType a0i = x0Im[q];
+          const RealType a1r = x0Re[q + ms];
+          const RealType a1i = x0Im[q + ms];
+          const RealType a2r = x0Re[q + 2 * ms];
+          const RealType a2i = x0Im[q + 2 * ms];
+          const RealType a3r = x0Re[q + 3 * ms];
+          const RealType a3i = x0Im[q + 3 * ms];
+          const RealType a4r = x0Re[q + 4 * ms];
+          const RealType a4i = x0Im[q + 4 * ms];
+          const RealType s14r = a1r + a4r;
+          const RealType s14i = a1i + a4i;
+          const RealType d14r = a1r - a4r;
+          const RealType d14i = a1i - a4i;
+          const RealType s23r = a2r + a3r;
+          const RealType s23i = a2i + a3i;
+          const RealType d23r = a2r - a3r;
+          const RealType d23i = a2i - a3i;
+          const RealType c1r = a0r + c1 * s14r + c2 * s23r;
+          const RealType c1i = a0i + c1 * s14i + c2 * s23i;
+          const RealType c2r = a0r + c2 * s14r + c1 * s23r;
+          const RealType c2i = a0i + c2 * s14i + c1 * s23i;
+          const RealType e1r = s1 * d14r + s2 * d23r;
+          const RealType e1i = s1 * d14i + s2 * d23i;
+          const RealType e2r = s2 * d14r - s1 * d23r;
+          const RealType e2i = s2 * d14i - s1 * d23i;
+          const RealType b1r = c1r - e1i;
+          const RealType b1i = c1i + e1r;
+          const RealType b4r = c1r + e1i;
+          const RealType b4i = c1i - e1r;
+          const RealType b2r = c2r - e2i;
+          const RealType b2i = c2i + e2r;
+          const RealType b3r = c2r + e2i;
+          const RealType b3i = c2i - e2r;
+          y0Re[q] = a0r + s14r + s23r;
+          y0Im[q] = a0i + s14i + s23i;
+          y0Re[q + s] = b1r * w1r - b1i * w1i;
+          y0Im[q + s] = b1r * w1i + b1i * w1r;
+          y0Re[q + 2 * s] = b2r * w2r - b2i * w2i;
+          y0Im[q + 2 * s] = b2r * w2i + b2i * w2r;
+          y0Re[q + 3 * s] = b3r * w3r - b3i * w3i;
+          y0Im[q + 3 * s] = b3r * w3i + b3i * w3r;
+          y0Re[q + 4 * s] = b4r * w4r - b4i * w4i;
+          y0Im[q + 4 * s] = b4r * w4i + b4i * w4r;
+          }
+        break;
+        }
+      default:
+        {
+        // Generic odd prime radix.
+        for ( SizeValueType u = 0; u < r; ++u )
+          {
+          const RealType wr = u == 0 ? RealType( 1 ) : twRe[u - 1];
+          const RealType wi = u == 0 ? RealType( 0 ) : -sg * twIm[u - 1];
+          for ( SizeValueType q = 0; q < s; ++q )
+            {
+            RealType br = x0Re[q];
+            RealType bi = x0Im[q];
+            for ( SizeValueType t = 1; t < r; ++t )
+              {
+              const SizeValueType j = ( t * u ) % r;
+              const RealType rootr = stage.m_RootRe[j];
+              const RealType rooti = -sg * stage.m_RootIm[j];
+              const RealType ar = x0Re[q + t * ms];
+              const RealType ai = x0Im[q + t * ms];
+              br += ar * rootr - ai * rooti;
+              bi += ar * rooti + ai * rootr;
+              }
+            y0Re[q + u * s] = br * wr - bi * wi;
+            y0Im[q + u * s] = br * wi + bi * wr;
+            }
+          }
+        break;
+        }
+      }
+    }
+}
+
+template< typename TReal >
+void
+NativeFFTCommon::Plan< TReal >
+::TransformBluestein( RealType * re, RealType * im, SizeValueType lanes, int sign, RealType * work ) const
+{
+  // The backward transform is the conjugate of the forward transform of
+  // the conjugate signal.
+  const RealType conjugate = sign == FORWARD ? RealType( 1 ) : RealType( -1 );
+  const SizeValueType n = m_Size;
+  const SizeValueType bn = m_BluesteinSize;
+  RealType * aRe = work;
+  RealType * aIm = work + bn * lanes;
+  RealType * planWork = work + 2 * bn * lanes;
+
+  for ( SizeValueType k = 0; k < n; ++k )
+    {
+    const RealType cr = m_ChirpRe[k];
+    const RealType ci = m_ChirpIm[k];
+    for ( SizeValueType l = 0; l < lanes; ++l )
+      {
+      const RealType xr = re[k * lanes + l];
+      const RealType xi = conjugate * im[k * lanes + l];
+      aRe[k * lanes + l] = xr * cr - xi * ci;
+      aIm[k * lanes + l] = xr * ci + xi * cr;
+      }
+    }
+  std::fill( aRe + n * lanes, aRe + bn * lanes, RealType( 0 ) );
+  std::fill( aIm + n * lanes, aIm + bn * lanes, RealType( 0 ) );
+
+  m_BluesteinPlan->Transform( aRe, aIm, lanes, FORWARD, planWork );
+  for ( SizeValueType k = 0; k < bn; ++k )
+    {
+    const RealType hr = m_ChirpSpectrumRe[k];
+    const RealType hi = m_ChirpSpectrumIm[k];
+    for ( SizeValueType l = 0; l < lanes; ++l )
+      {
+      const RealType ar = aRe[k * lanes + l];
+      const RealType ai = aIm[k * lanes + l];
+      aRe[k * lanes + l] = ar * hr - ai * hi;
+      aIm[k * lanes + l] = ar * hi + ai * hr;
+      }
+    }
+  m_BluesteinPlan->Transform( aRe, aIm, lanes, BACKWARD, planWork );
+
+  for ( SizeValueType k = 0; k < n; ++k )
+    {
+    const RealType cr = m_ChirpRe[k];
+    const RealType ci = m_ChirpIm[k];
+    for ( SizeValueType l = 0; l < lanes; ++l )
+      {
+      const RealType ar = aRe[k * lanes + l];
+      const RealType ai = aIm[k * lanes + l];
+      re[k * lanes + l] = ar * cr - ai * ci;
+      im[k * lanes + l] = conjugate * ( ar * ci + ai * cr );
+      }
+    }
+}
+
+template< typename TFunction >
+void
+NativeFFTCommon
+::ParallelizeBatches( SizeValueType numberOfBatches, MultiThreaderBase * multiThreader,
+                      ThreadIdType numberOfWorkUnits, TFunction process )
+{
+  const SizeValueType numberOfChunks =
+    std::min( static_cast< SizeValueType >( std::max( numberOfWorkUnits, ThreadIdType( 1 ) ) ), numberOfBatches );
+  if ( multiThreader == nullptr || numberOfChunks <= 1 )
+    {
+    process( 0, numberOfBatches );
+    return;
+    }
+  multiThreader->SetNumberOfWorkUnits( static_cast< ThreadIdType >( numberOfChunks ) );
+  multiThreader->ParallelizeArray( 0, numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+      process( chunk * numberOfBatches / numberOfChunks, ( chunk + 1 ) * numberOfBatches / numberOfChunks );
+      },
+    nullptr );
+}
+
+template< typename TReal >
+void
+NativeFFTCommon
+::TransformLines( std::complex< TReal > * data, const SizeValueType * size, unsigned int dimension,
+                  unsigned int d, int sign, TReal scale,
+                  MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits )
+{
+  const SizeValueType n = size[d];
+  SizeValueType stride = 1;
+  SizeValueType numberOfLines = 1;
+  for ( unsigned int i = 0; i < dimension; ++i )
+    {
+    if ( i < d )
+      {
+      stride *= size[i];
+      }
+    if ( i != d )
+      {
+      numberOfLines *= size[i];
+      }
+    }
+  if ( n == 1 && scale == TReal( 1 ) )
+    {
+    return;
+    }
+
+  const Plan< TReal > plan( n );
+  constexpr SizeValueType maximumLanes = GetNumberOfLanes< TReal >();
+  const SizeValueType numberOfBatches = ( numberOfLines + maximumLanes - 1 ) / maximumLanes;
+
+  ParallelizeBatches( numberOfBatches, multiThreader, numberOfWorkUnits,
+    [&]( SizeValueType firstBatch, SizeValueType endBatch )
+      {
+      std::vector< TReal > re( n * maximumLanes );
+      std::vector< TReal > im( n * maximumLanes );
+      std::vector< TReal > work( plan.GetWorkSize( maximumLanes ) );
+      SizeValueType bases[maximumLanes];
+      for ( SizeValueType batch = firstBatch; batch < endBatch; ++batch )
+        {
+        const SizeValueType firstLine = batch * maximumLanes;
+        const SizeValueType lanes = std::min( maximumLanes, numberOfLines - firstLine );
+        for ( SizeValueType l = 0; l < lanes; ++l )
+          {
+          const SizeValueType line = firstLine + l;
+          bases[l] = line % stride + ( line / stride ) * stride * n;
+          }
+        for ( SizeValueType k = 0; k < n; ++k )
+          {
+          for ( SizeValueType l = 0; l < lanes; ++l )
+            {
+            const std::complex< TReal > & value = data[bases[l] + k * stride];
+            re[k * lanes + l] = value.real();
+            im[k * lanes + l] = value.imag();
+            }
+          }
+        plan.Transform( re.data(), im.data(), lanes, sign, work.data() );
+        for ( SizeValueType k = 0; k < n; ++k )
+          {
+          for ( SizeValueType l = 0; l < lanes; ++l )
+            {
+            data[bases[l] + k * stride] = std::complex< TReal >( scale * re[k * lanes + l], scale * im[k * lanes + l] );
+            }
+          }
+        }
+      } );
+}
+
+template< typename TReal >
+void
+NativeFFTCommon
+::ComplexToComplex( std::complex< TReal > * data, const SizeValueType * size, unsigned int dimension,
+                    int sign, TReal scale,
+                    MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits )
+{
+  for ( unsigned int d = 0; d < dimension; ++d )
+    {
+    TransformLines( data, size, dimension, d, sign, d + 1 == dimension ? scale : TReal( 1 ),
+                    multiThreader, numberOfWorkUnits );
+    }
+}
+
+template< typename TReal >
+void
+NativeFFTCommon
+::RealToHalfHermitian( const TReal * input, std::complex< TReal > * output,
+                       const SizeValueType * size, unsigned int dimension,
+                       MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits )
+{
+  const SizeValueType n = size[0];
+  const SizeValueType halfN = n / 2 + 1;
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int i = 1; i < dimension; ++i )
+    {
+    numberOfRows *= size[i];
+    }
+
+  // Two real rows are transformed as the real and imaginary parts of a
+  // complex row: Z = X + iY, X[k] = ( Z[k] + conj( Z[n-k] ) ) / 2 and
+  // Y[k] = -i ( Z[k] - conj( Z[n-k] ) ) / 2.
+  const Plan< TReal > plan( n );
+  constexpr SizeValueType maximumLanes = GetNumberOfLanes< TReal >();
+  const SizeValueType numberOfPairs = ( numberOfRows + 1 ) / 2;
+  const SizeValueType numberOfBatches = ( numberOfPairs + maximumLanes - 1 ) / maximumLanes;
+
+  ParallelizeBatches( numberOfBatches, multiThreader, numberOfWorkUnits,
+    [&]( SizeValueType firstBatch, SizeValueType endBatch )
+      {
+      std::vector< TReal > re( n * maximumLanes );
+      std::vector< TReal > im( n * maximumLanes );
+      std::vector< TReal > work( plan.GetWorkSize( maximumLanes ) );
+      for ( SizeValueType batch = firstBatch; batch < endBatch; ++batch )
+        {
+        const SizeValueType firstPair = batch * maximumLanes;
+        const SizeValueType lanes = std::min( maximumLanes, numberOfPairs - firstPair );
+        for ( SizeValueType l = 0; l < lanes; ++l )
+          {
+          const SizeValueType row = 2 * ( firstPair + l );
+          const TReal * x = input + row * n;
+          for ( SizeValueType k = 0; k < n; ++k )
+            {
+            re[k * lanes + l] = x[k];
+            }
+          if ( row + 1 < numberOfRows )
+            {
+            const TReal * y = x + n;
+            for ( SizeValueType k = 0; k < n; ++k )
+              {
+              im[k * lanes + l] = y[k];
+              }
+            }
+          else
+            {
+            for ( SizeValueType k = 0; k < n; ++k )
+              {
+              im[k * lanes + l] = TReal( 0 );
+              }
+            }
+          }
+        plan.Transform( re.data(), im.data(), lanes, FORWARD, work.data() );
+        for ( SizeValueType l = 0; l < lanes; ++l )
+          {
+          const SizeValueType row = 2 * ( firstPair + l );
+          std::complex< TReal > * x = output + row * halfN;
+          std::complex< TReal > * y = x + halfN;
+          const bool hasY = row + 1 < numberOfRows;
+          for ( SizeValueType k = 0; k < halfN; ++k )
+            {
+            const SizeValueType mirror = ( n - k ) % n;
+            const TReal zr = re[k * lanes + l];
+            const TReal zi = im[k * lanes + l];
+            const TReal cr = re[mirror * lanes + l];
+            const TReal ci = -im[mirror * lanes + l];
+            x[k] = std::complex< TReal >( TReal( 0.5 ) * ( zr + cr ), TReal( 0.5 ) * ( zi + ci ) );
+            if ( hasY )
+              {
+              y[k] = std::complex< TReal >( TReal( 0.5 ) * ( zi - ci ), TReal( -0.5 ) * ( zr - cr ) );
+              }
+            }
+          }
+        }
+      } );
+
+  std::vector< SizeValueType > halfSize( size, size + dimension );
+  halfSize[0] = halfN;
+  for ( unsigned int d = 1; d < dimension; ++d )
+    {
+    TransformLines( output, halfSize.data(), dimension, d, FORWARD, TReal( 1 ), multiThreader, numberOfWorkUnits );
+    }
+}
+
+template< typename TReal >
+void
+NativeFFTCommon
+::HalfHermitianToReal( std::complex< TReal > * input, TReal * output,
+                       const SizeValueType * size, unsigned int dimension, TReal scale,
+                       MultiThreaderBase * multiThreader, ThreadIdType numberOfWorkUnits )
+{
+  const SizeValueType n = size[0];
+  const SizeValueType halfN = n / 2 + 1;
+  std::vector< SizeValueType > halfSize( size, size + dimension );
+  halfSize[0] = halfN;
+  for ( unsigned int d = 1; d < dimension; ++d )
+    {
+    TransformLines( input, halfSize.data(), dimension, d, BACKWARD, TReal( 1 ), multiThreader, numberOfWorkUnits );
+    }
+
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int i = 1; i < dimension; ++i )
+    {
+    numberOfRows *= size[i];
+    }
+
+  // Two Hermitian rows X and Y are transformed together as Z = X + iY,
+  // whose backward transform is x + iy. As in a complex to real transform,
+  // the imaginary parts of the values that are their own conjugate are
+  // ignored.
+  const Plan< TReal > plan( n );
+  constexpr SizeValueType maximumLanes = GetNumberOfLanes< TReal >();
+  const SizeValueType numberOfPairs = ( numberOfRows + 1 ) / 2;
+  const SizeValueType numberOfBatches = ( numberOfPairs + maximumLanes - 1 ) / maximumLanes;
+
+  ParallelizeBatches( numberOfBatches, multiThreader, numberOfWorkUnits,
+    [&]( SizeValueType firstBatch, SizeValueType endBatch )
+      {
+      std::vector< TReal > re( n * maximumLanes );
+      std::vector< TReal > im( n * maximumLanes );
+      std::vector< TReal > work( plan.GetWorkSize( maximumLanes ) );
+      for ( SizeValueType batch = firstBatch; batch < endBatch; ++batch )
+        {
+        const SizeValueType firstPair = batch * maximumLanes;
+        const SizeValueType lanes = std::min( maximumLanes, numberOfPairs - firstPair );
+        for ( SizeValueType l = 0; l < lanes; ++l )
+          {
+          const SizeValueType row = 2 * ( firstPair + l );
+          const std::complex< TReal > * x = input + row * halfN;
+          const std::complex< TReal > * y = x + halfN;
+          const bool hasY = row + 1 < numberOfRows;
+          for ( SizeValueType k = 0; k < n; ++k )
+            {
+            const bool mirrored = k >= halfN;
+            const SizeValueType j = mirrored ? n - k : k;
+            const bool selfConjugate = k == 0 || 2 * k == n;
+            TReal xr = x[j].real();
+            TReal xi = selfConjugate ? TReal( 0 ) : x[j].imag();
+            TReal yr = hasY ? y[j].real() : TReal( 0 );
+            TReal yi = ( hasY && !selfConjugate ) ? y[j].imag() : TReal( 0 );
+            if ( mirrored )
+              {
+              xi = -xi;
+              yi = -yi;
+              }
+            re[k * lanes + l] = xr - yi;
+            im[k * lanes + l] = xi + yr;
+            }
+          }
+        plan.Transform( re.data(), im.data(), lanes, BACKWARD, work.data() );
+        for ( SizeValueType l = 0; l < lanes; ++l )
+          {
+          const SizeValueType row = 2 * ( firstPair + l );
+          TReal * x = output + row * n;
+          for ( SizeValueType k = 0; k < n; ++k )
+            {
+            x[k] = scale * re[k * lanes + l];
+            }
+          if ( row + 1 < numberOfRows )
+            {
+            TReal * y = x + n;
+            for ( SizeValueType k = 0; k < n; ++k )
+              {
+              y[k] = scale * im[k * lanes + l];
+              }
+            }
+          }
+        }
+      } );
+}
+
+} // namespace itk
+
+#endif // itkNativeFFTCommon_hxx
@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeFFTImageFilterFactory_h
+#define itkNativeFFTImageFilterFactory_h
+
+#include "itkObjectFactoryBase.h"
+#include "itkVersion.h"
+
+#include "itkNativeComplexToComplexFFTImageFilter.h"
+#include "itkNativeForwardFFTImageFilter.h"
+#include "itkNativeHalfHermitianToRealInverseFFTImageFilter.h"
+#include "itkNativeInverseFFTImageFilter.h"
+#include "itkNativeRealToHalfHermitianForwardFFTImageFilter.h"
+
+namespace itk
+{
+/** \class NativeFFTImageFilterFactory
+ *
+ * \brief Object factory that makes the FFT filters use the Native*
+ * implementations.
+ *
+ * ForwardFFTImageFilter::New() and the New() methods of the other
+ * abstract FFT filters return the FFTW implementation when FFTW is
+ * enabled, and the Vnl implementation otherwise. Once this factory is
+ * registered, they return the Native* filters, for float and double
+ * pixels, in dimensions 1 to 4:
+ *
+ * \code
+ * itk::NativeFFTImageFilterFactory::RegisterOneFactory();
+ * \endcode
+ *
+ * \ingroup FourierTransform
+ * \ingroup ITKFFT
+ *
+ * \sa NativeFFTCommon
+ */
+class NativeFFTImageFilterFactory : public ObjectFactoryBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(NativeFFTImageFilterFactory);
+
+  using Self = NativeFFTImageFilterFactory;
+  using Superclass = ObjectFactoryBase;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Class methods used to interface with the registered factories. */
+  const char* GetITKSourceVersion() const override
+    {
+    return ITK_SOURCE_VERSION;
+    }
+  const char* GetDescription() const override
+    {
+    return "A Factory for the Native FFT image filters";
+    }
+
+  /** Method for class instantiation. */
+  itkFactorylessNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(NativeFFTImageFilterFactory, itk::ObjectFactoryBase);
+
+  /** Register one factory of this type  */
+  static void RegisterOneFactory()
+  {
+    NativeFFTImageFilterFactory::Pointer factory = NativeFFTImageFilterFactory::New();
+
+    ObjectFactoryBase::RegisterFactory(factory);
+  }
+
+private:
+#define OverrideNativeFFTTypeMacro(pt,dm) \
+    { \
+    using RealImageType = Image<pt,dm>; \
+    using ComplexImageType = Image<std::complex<pt>,dm>; \
+    this->RegisterOverride( \
+      typeid(ForwardFFTImageFilter<RealImageType,ComplexImageType>).name(), \
+      typeid(NativeForwardFFTImageFilter<RealImageType,ComplexImageType>).name(), \
+      "Native Forward FFT Image Filter Override", \
+      true, \
+      CreateObjectFunction<NativeForwardFFTImageFilter<RealImageType,ComplexImageType> >::New() ); \
+    this->RegisterOverride( \
+      typeid(InverseFFTImageFilter<ComplexImageType,RealImageType>).name(), \
+      typeid(NativeInverseFFTImageFilter<ComplexImageType,RealImageType>).name(), \
+      "Native Inverse FFT Image Filter Override", \
+      true, \
+      CreateObjectFunction<NativeInverseFFTImageFilter<ComplexImageType,RealImageType> >::New() ); \
+    this->RegisterOverride( \
+      typeid(RealToHalfHermitianForwardFFTImageFilter<RealImageType,ComplexImageType>).name(), \
+      typeid(NativeRealToHalfHermitianForwardFFTImageFilter<RealImageType,ComplexImageType>).name(), \
+      "Native Real To Half Hermitian Forward FFT Image Filter Override", \
+      true, \
+      CreateObjectFunction<NativeRealToHalfHermitianForwardFFTImageFilter<RealImageType,ComplexImageType> >::New() ); \
+    this->RegisterOverride( \
+      typeid(HalfHermitianToRealInverseFFTImageFilter<ComplexImageType,RealImageType>).name(), \
+      typeid(NativeHalfHermitianToRealInverseFFTImageFilter<ComplexImageType,RealImageType>).name(), \
+      "Native Half Hermitian To Real Inverse FFT Image Filter Override", \
+      true, \
+      CreateObjectFunction<NativeHalfHermitianToRealInverseFFTImageFilter<ComplexImageType,RealImageType> >::New() ); \
+    this->RegisterOverride( \
+      typeid(ComplexToComplexFFTImageFilter<ComplexImageType>).name(), \
+      typeid(NativeComplexToComplexFFTImageFilter<ComplexImageType>).name(), \
+      "Native Complex To Complex FFT Image Filter Override", \
+      true, \
+      CreateObjectFunction<NativeComplexToComplexFFTImageFilter<ComplexImageType> >::New() ); \
+    }
+
+  NativeFFTImageFilterFactory()
+  {
+    OverrideNativeFFTTypeMacro(float, 1);
+    OverrideNativeFFTTypeMacro(double, 1);
+
+    OverrideNativeFFTTypeMacro(float, 2);
+    OverrideNativeFFTTypeMacro(double, 2);
+
+    OverrideNativeFFTTypeMacro(float, 3);
+    OverrideNativeFFTTypeMacro(double, 3);
+
+    OverrideNativeFFTTypeMacro(float, 4);
+    OverrideNativeFFTTypeMacro(double, 4);
+  }
+
+#undef OverrideNativeFFTTypeMacro
+};
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,94 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeForwardFFTImageFilter_h
+#define itkNativeForwardFFTImageFilter_h
+
+#include "itkForwardFFTImageFilter.h"
+
+namespace itk
+{
+/** \class NativeForwardFFTImageFilter
+ *
+ * \brief Forward Fast Fourier Transform implemented in ITK.
+ *
+ * This filter computes the forward Fourier transform of an image of any
+ * size, with the multithreaded transforms of NativeFFTCommon. It is
+ * faster than VnlForwardFFTImageFilter and does not require FFTW.
+ *
+ * \ingroup FourierTransform
+ * \ingroup MultiThreaded
+ * \ingroup ITKFFT
+ *
+ * \sa ForwardFFTImageFilter
+ * \sa NativeFFTCommon
+ * \sa NativeFFTImageFilterFactory
+ */
+template< typename TInputImage, typename TOutputImage=Image< std::complex<typename TInputImage::PixelType>, TInputImage::ImageDimension> >
+class ITK_TEMPLATE_EXPORT NativeForwardFFTImageFilter:
+  public ForwardFFTImageFilter< TInputImage, TOutputImage >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(NativeForwardFFTImageFilter);
+
+  /** Standard class type aliases. */
+  using InputImageType = TInputImage;
+  using InputPixelType = typename InputImageType::PixelType;
+  using InputSizeType = typename InputImageType::SizeType;
+  using OutputImageType = TOutputImage;
+  using OutputPixelType = typename OutputImageType::PixelType;
+
+  using Self = NativeForwardFFTImageFilter;
+  using Superclass = ForwardFFTImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(NativeForwardFFTImageFilter,
+               ForwardFFTImageFilter);
+
+  /** Extract the dimensionality of the images. They are assumed to be
+   * the same. */
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+  static constexpr unsigned int InputImageDimension = TInputImage::ImageDimension;
+  static constexpr unsigned int OutputImageDimension = TOutputImage::ImageDimension;
+
+  SizeValueType GetSizeGreatestPrimeFactor() const override;
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( ImageDimensionsMatchCheck,
+                   ( Concept::SameDimension< InputImageDimension, OutputImageDimension > ) );
+  // End concept checking
+#endif
+
+protected:
+  NativeForwardFFTImageFilter() = default;
+  ~NativeForwardFFTImageFilter() override = default;
+
+  void GenerateData() override;
+};
+}
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkNativeForwardFFTImageFilter.hxx"
+#endif
+
+#endif
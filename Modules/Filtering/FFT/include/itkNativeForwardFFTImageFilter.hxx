@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeForwardFFTImageFilter_hxx
+#define itkNativeForwardFFTImageFilter_hxx
+
+#include "itkHalfToFullHermitianImageFilter.h"
+#include "itkNativeFFTCommon.h"
+#include "itkNativeForwardFFTImageFilter.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+void
+NativeForwardFFTImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  // Get pointers to the input and output.
+  typename InputImageType::ConstPointer inputPtr = this->GetInput();
+  typename OutputImageType::Pointer outputPtr = this->GetOutput();
+
+  if ( !inputPtr || !outputPtr )
+    {
+    return;
+    }
+
+  // We don't have a nice progress to report, but at least this simple line
+  // reports the beginning and the end of the process.
+  ProgressReporter progress( this, 0, 1 );
+
+  const InputSizeType inputSize = inputPtr->GetLargestPossibleRegion().GetSize();
+
+  // Compute the non redundant half of the transform, then expand it.
+  typename OutputImageType::SizeType halfSize = inputSize;
+  halfSize[0] = inputSize[0] / 2 + 1;
+  typename OutputImageType::RegionType halfRegion( outputPtr->GetLargestPossibleRegion() );
+  halfRegion.SetSize( halfSize );
+
+  typename OutputImageType::Pointer halfOutput = OutputImageType::New();
+  // The information is copied to the half image so that it will then
+  // be copied to the final output of this filter.
+  halfOutput->CopyInformation( inputPtr );
+  halfOutput->SetRegions( halfRegion );
+  halfOutput->Allocate();
+
+  NativeFFTCommon::RealToHalfHermitian( inputPtr->GetBufferPointer(), halfOutput->GetBufferPointer(),
+                                        inputSize.GetSize(), ImageDimension,
+                                        this->GetMultiThreader(), this->GetNumberOfWorkUnits() );
+
+  using HalfToFullFilterType = HalfToFullHermitianImageFilter< OutputImageType >;
+  typename HalfToFullFilterType::Pointer halfToFullFilter = HalfToFullFilterType::New();
+  halfToFullFilter->SetActualXDimensionIsOdd( inputSize[0] % 2 != 0 );
+  halfToFullFilter->SetInput( halfOutput );
+  halfToFullFilter->GraftOutput( this->GetOutput() );
+  halfToFullFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  halfToFullFilter->UpdateLargestPossibleRegion();
+  this->GraftOutput( halfToFullFilter->GetOutput() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+SizeValueType
+NativeForwardFFTImageFilter< TInputImage, TOutputImage >
+::GetSizeGreatestPrimeFactor() const
+{
+  return NativeFFTCommon::GREATEST_PRIME_FACTOR;
+}
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkNativeHalfHermitianToRealInverseFFTImageFilter_hxx
+#define itkNativeHalfHermitianToRealInverseFFTImageFilter_hxx
+
+#include "itkNativeFFTCommon.h"
+#include "itkNativeHalfHermitianToRealInverseFFTImageFilter.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage >
+void
+NativeHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  // Get pointers to the input and output.
+  typename InputImageType::ConstPointer inputPtr = this->GetInput();
+  typename OutputImageType::Pointer outputPtr = this->GetOutput();
+
+  if ( !inputPtr || !outputPtr )
+    {
+    return;
+    }
+
+  // We don't have a nice progress to report, but at least this simple line
+  // reports the beginning and the end of the process.
+  ProgressReporter progress( this, 0, 1 );
+
+  // Allocate output buffer memory.
+  outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
+  outputPtr->Allocate();
+
+  const OutputSizeType outputSize = outputPtr->GetLargestPossibleRegion().GetSize();
+
+  // The transform overwrites its input, so it works on a copy.
+  const SizeValueType numberOfInputPixels = inputPtr->GetLargestPossibleRegion().GetNumberOfPixels();
+  std::vector< InputPixelType > buffer( inputPtr->GetBufferPointer(),
+                                        inputPtr->GetBufferPointer() + numberOfInputPixels );
+
+  const OutputPixelType scale = OutputPixelType( 1 ) /
+    static_cast< OutputPixelType >( outputPtr->GetLargestPossibleRegion().GetNumberOfPixels() );
+  NativeFFTCommon::HalfHermitianToReal( buffer.data(), outputPtr->GetBufferPointer(),
+                                        outputSize.GetSize(), ImageDimension, scale,
+                                        this->GetMultiThreader(), this->GetNumberOfWorkUnits() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+SizeValueType
+NativeHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
+::GetSizeGreatestPrimeFactor() const
+{
+  return NativeFFTCommon::GREATEST_PRIME_FACTOR;
+}
+
+}
+
+#endif
@@ -33,6 +33,8 @@
 #endif
 
 # include "itkObjectFactory.h"
+#include <iterator>
+#include <sstream>
 
 namespace itk
 {
@@ -412,7 +414,8 @@ FFTWGlobalConfiguration
   m_PlanRigor(0),
   m_WriteWisdomCache(false),
   m_ReadWisdomCache(true),
-  m_WisdomCacheBase("")
+  m_WisdomCacheBase(""),
+  m_PlanCacheSize(32)
 {
     {//Configure default method for creating WISDOM_CACHE files
     std::string manualCacheFilename="";
@@ -514,6 +517,23 @@ FFTWGlobalConfiguration
       }
     }
 
+    {
+    std::string planCacheSizeString;
+    if( itksys::SystemTools::GetEnv("ITK_FFTW_PLAN_CACHE_SIZE", planCacheSizeString) )
+      {
+      std::istringstream planCacheSizeStream( planCacheSizeString );
+      SizeValueType planCacheSize;
+      if( planCacheSizeStream >> planCacheSize )
+        {
+        this->m_PlanCacheSize = planCacheSize;
+        }
+      else
+        {
+        itkWarningMacro( "Warning: Invalid FFTW plan cache size: " << planCacheSizeString );
+        }
+      }
+    }
+
   if( this->m_ReadWisdomCache )
     {
     std::string cachePath = m_WisdomFilenameGenerator->GenerateWisdomFilename(m_WisdomCacheBase);
@@ -550,6 +570,9 @@ FFTWGlobalConfiguration
       }
 #endif
     }
+  // The plans must be destroyed before the cleanup of FFTW. Those
+  // still used elsewhere can't be executed anymore anyway.
+  this->m_CachedPlans.clear();
 #if defined(ITK_USE_FFTWF)
 #if !defined(_WIN32) || defined(ITK_STATIC)
   // Cannot be called with shared libs on Windows because FFTW does not check
@@ -883,6 +906,97 @@ FFTWGlobalConfiguration
   return GetInstance()->m_WisdomCacheBase;
 }
 
+void
+FFTWGlobalConfiguration
+::SetPlanCacheSize( const SizeValueType & v )
+{
+  std::list< std::pair< PlanKeyType, CachedPlanPointer > > evictedPlans;
+  Pointer instance = GetInstance();
+    {
+    std::lock_guard< std::mutex > lock( instance->m_PlanCacheLock );
+    instance->m_PlanCacheSize = v;
+    while( instance->m_CachedPlans.size() > v )
+      {
+      evictedPlans.splice( evictedPlans.end(), instance->m_CachedPlans, std::prev( instance->m_CachedPlans.end() ) );
+      }
+    }
+  // The evicted plans are destroyed here, once the cache is unlocked.
+}
+
+SizeValueType
+FFTWGlobalConfiguration
+::GetPlanCacheSize()
+{
+  Pointer instance = GetInstance();
+  std::lock_guard< std::mutex > lock( instance->m_PlanCacheLock );
+  return instance->m_PlanCacheSize;
+}
+
+SizeValueType
+FFTWGlobalConfiguration
+::GetNumberOfCachedPlans()
+{
+  Pointer instance = GetInstance();
+  std::lock_guard< std::mutex > lock( instance->m_PlanCacheLock );
+  return static_cast< SizeValueType >( instance->m_CachedPlans.size() );
+}
+
+void
+FFTWGlobalConfiguration
+::ClearPlanCache()
+{
+  std::list< std::pair< PlanKeyType, CachedPlanPointer > > evictedPlans;
+  Pointer instance = GetInstance();
+    {
+    std::lock_guard< std::mutex > lock( instance->m_PlanCacheLock );
+    evictedPlans.swap( instance->m_CachedPlans );
+    }
+}
+
+FFTWGlobalConfiguration::CachedPlanPointer
+FFTWGlobalConfiguration
+::FindPlan( const PlanKeyType & key )
+{
+  Pointer instance = GetInstance();
+  std::lock_guard< std::mutex > lock( instance->m_PlanCacheLock );
+  for( auto it = instance->m_CachedPlans.begin(); it != instance->m_CachedPlans.end(); ++it )
+    {
+    if( it->first == key )
+      {
+      instance->m_CachedPlans.splice( instance->m_CachedPlans.begin(), instance->m_CachedPlans, it );
+      return instance->m_CachedPlans.front().second;
+      }
+    }
+  return nullptr;
+}
+
+FFTWGlobalConfiguration::CachedPlanPointer
+FFTWGlobalConfiguration
+::InsertPlan( const PlanKeyType & key, const CachedPlanPointer & plan )
+{
+  std::list< std::pair< PlanKeyType, CachedPlanPointer > > evictedPlans;
+  Pointer instance = GetInstance();
+  std::lock_guard< std::mutex > lock( instance->m_PlanCacheLock );
+  for( auto it = instance->m_CachedPlans.begin(); it != instance->m_CachedPlans.end(); ++it )
+    {
+    if( it->first == key )
+      {
+      instance->m_CachedPlans.splice( instance->m_CachedPlans.begin(), instance->m_CachedPlans, it );
+      return instance->m_CachedPlans.front().second;
+      }
+    }
+  if( instance->m_PlanCacheSize == 0 )
+    {
+    return plan;
+    }
+  instance->m_CachedPlans.emplace_front( key, plan );
+  while( instance->m_CachedPlans.size() > instance->m_PlanCacheSize )
+    {
+    evictedPlans.splice( evictedPlans.end(), instance->m_CachedPlans, std::prev( instance->m_CachedPlans.end() ) );
+    }
+  return plan;
+}
+
 }//end namespace itk
 
 #endif
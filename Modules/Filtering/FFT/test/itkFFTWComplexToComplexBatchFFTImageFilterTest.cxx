@@ -0,0 +1,222 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTWComplexToComplexBatchFFTImageFilter.h"
+#include "itkFFTWRealToHalfHermitianForwardFFTImageFilter.h"
+#include "itkVnlComplexToComplexFFTImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template< typename TRealType >
+bool
+CloseTo( const std::complex< TRealType > & value, const std::complex< TRealType > & expected, TRealType tolerance )
+{
+  return std::abs( value - expected ) <= tolerance * ( 1 + std::abs( expected ) );
+}
+
+// Transform a 2D image with the Vnl filter as reference.
+template< typename TComplexImage2D >
+typename TComplexImage2D::Pointer
+ReferenceTransform( const typename TComplexImage2D::PixelType * values, unsigned int stride,
+                    const typename TComplexImage2D::SizeType & size, bool inverse )
+{
+  typename TComplexImage2D::Pointer image = TComplexImage2D::New();
+  image->SetRegions( size );
+  image->Allocate();
+  for ( itk::SizeValueType i = 0; i < size[0] * size[1]; ++i )
+    {
+    image->GetBufferPointer()[i] = values[i * stride];
+    }
+  using ReferenceFilterType = itk::VnlComplexToComplexFFTImageFilter< TComplexImage2D >;
+  typename ReferenceFilterType::Pointer reference = ReferenceFilterType::New();
+  reference->SetInput( image );
+  reference->SetTransformDirection( inverse ? ReferenceFilterType::INVERSE : ReferenceFilterType::FORWARD );
+  reference->Update();
+  return reference->GetOutput();
+}
+
+template< typename TRealType >
+int
+BatchTest( TRealType tolerance )
+{
+  using ComplexType = std::complex< TRealType >;
+  using ImageType2D = itk::Image< ComplexType, 2 >;
+  using StackType = itk::Image< ComplexType, 3 >;
+  using VectorImageType = itk::VectorImage< ComplexType, 2 >;
+
+  itk::FFTWGlobalConfiguration::ClearPlanCache();
+  itk::FFTWGlobalConfiguration::SetPlanCacheSize( 32 );
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetPlanCacheSize(), 32 );
+
+  // A stack of 7 images of size 10x6.
+  typename StackType::SizeType stackSize = {{ 10, 6, 7 }};
+  typename StackType::Pointer stack = StackType::New();
+  stack->SetRegions( stackSize );
+  stack->Allocate();
+  TRealType value = 0;
+  for ( itk::ImageRegionIterator< StackType > it( stack, stack->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    value += 1;
+    it.Set( ComplexType( std::fmod( value * TRealType( 0.37 ), TRealType( 5 ) ), std::fmod( value, TRealType( 3 ) ) ) );
+    }
+
+  using StackFilterType = itk::FFTWComplexToComplexBatchFFTImageFilter< StackType >;
+  typename StackFilterType::Pointer stackFilter = StackFilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( stackFilter, FFTWComplexToComplexBatchFFTImageFilter, ImageToImageFilter );
+  TEST_EXPECT_EQUAL( stackFilter->GetNumberOfTransformDimensions(), 3 );
+  stackFilter->SetNumberOfTransformDimensions( 2 );
+  TEST_EXPECT_EQUAL( stackFilter->GetNumberOfTransformDimensions(), 2 );
+  stackFilter->SetInput( stack );
+  stackFilter->Update();
+
+  const itk::SizeValueType numberOfPixels2D = stackSize[0] * stackSize[1];
+  typename ImageType2D::SizeType size2D = {{ stackSize[0], stackSize[1] }};
+  for ( itk::SizeValueType slice = 0; slice < stackSize[2]; ++slice )
+    {
+    typename ImageType2D::Pointer expected =
+      ReferenceTransform< ImageType2D >( stack->GetBufferPointer() + slice * numberOfPixels2D, 1, size2D, false );
+    for ( itk::SizeValueType i = 0; i < numberOfPixels2D; ++i )
+      {
+      if ( !CloseTo( stackFilter->GetOutput()->GetBufferPointer()[slice * numberOfPixels2D + i],
+                     expected->GetBufferPointer()[i], tolerance ) )
+        {
+        std::cerr << "Transform of slice " << slice << " differs at " << i << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  const itk::SizeValueType numberOfCachedPlans = itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans();
+  TEST_EXPECT_EQUAL( numberOfCachedPlans, 1 );
+
+  // The inverse transform restores the stack.
+  typename StackFilterType::Pointer inverseStackFilter = StackFilterType::New();
+  inverseStackFilter->SetInput( stackFilter->GetOutput() );
+  inverseStackFilter->SetNumberOfTransformDimensions( 2 );
+  inverseStackFilter->SetTransformDirection( StackFilterType::INVERSE );
+  TEST_EXPECT_EQUAL( inverseStackFilter->GetTransformDirection(), StackFilterType::INVERSE );
+  inverseStackFilter->Update();
+  for ( itk::SizeValueType i = 0; i < stack->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    if ( !CloseTo( inverseStackFilter->GetOutput()->GetBufferPointer()[i], stack->GetBufferPointer()[i], tolerance ) )
+      {
+      std::cerr << "Inverse transform of the stack differs at " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Running the filter again reuses its plan.
+  stackFilter->Modified();
+  stackFilter->Update();
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans(), numberOfCachedPlans + 1 );
+
+  // A vector image with 3 components of size 10x6.
+  constexpr unsigned int numberOfComponents = 3;
+  typename VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( size2D );
+  vectorImage->SetNumberOfComponentsPerPixel( numberOfComponents );
+  vectorImage->Allocate();
+  std::copy( stack->GetBufferPointer(), stack->GetBufferPointer() + numberOfPixels2D * numberOfComponents,
+             vectorImage->GetBufferPointer() );
+
+  using VectorFilterType = itk::FFTWComplexToComplexBatchFFTImageFilter< VectorImageType >;
+  typename VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+  vectorFilter->SetInput( vectorImage );
+  vectorFilter->Update();
+  TEST_EXPECT_EQUAL( vectorFilter->GetOutput()->GetNumberOfComponentsPerPixel(), numberOfComponents );
+  for ( unsigned int component = 0; component < numberOfComponents; ++component )
+    {
+    typename ImageType2D::Pointer expected =
+      ReferenceTransform< ImageType2D >( vectorImage->GetBufferPointer() + component, numberOfComponents, size2D, false );
+    for ( itk::SizeValueType i = 0; i < numberOfPixels2D; ++i )
+      {
+      if ( !CloseTo( vectorFilter->GetOutput()->GetBufferPointer()[i * numberOfComponents + component],
+                     expected->GetBufferPointer()[i], tolerance ) )
+        {
+        std::cerr << "Transform of component " << component << " differs at " << i << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // The cached plans of the other FFTW filters give the same results.
+  using RealImageType = itk::Image< TRealType, 2 >;
+  typename RealImageType::Pointer realImage = RealImageType::New();
+  realImage->SetRegions( size2D );
+  realImage->Allocate();
+  for ( itk::SizeValueType i = 0; i < numberOfPixels2D; ++i )
+    {
+    realImage->GetBufferPointer()[i] = stack->GetBufferPointer()[i].real();
+    }
+  using RealToHalfHermitianFilterType = itk::FFTWRealToHalfHermitianForwardFFTImageFilter< RealImageType >;
+  typename RealToHalfHermitianFilterType::Pointer realFilter = RealToHalfHermitianFilterType::New();
+  realFilter->SetInput( realImage );
+  realFilter->Update();
+  typename RealToHalfHermitianFilterType::OutputImageType::Pointer firstOutput = realFilter->GetOutput();
+  firstOutput->DisconnectPipeline();
+  const itk::SizeValueType numberOfPlansWithRealFilter = itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans();
+  realFilter->Modified();
+  realFilter->Update();
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans(), numberOfPlansWithRealFilter );
+  for ( itk::SizeValueType i = 0; i < firstOutput->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    if ( firstOutput->GetBufferPointer()[i] != realFilter->GetOutput()->GetBufferPointer()[i] )
+      {
+      std::cerr << "The cached plan gives a different result at " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The least recently used plans are released.
+  itk::FFTWGlobalConfiguration::SetPlanCacheSize( 1 );
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans(), 1 );
+  itk::FFTWGlobalConfiguration::SetPlanCacheSize( 0 );
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans(), 0 );
+  stackFilter->Modified();
+  stackFilter->Update();
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans(), 0 );
+  itk::FFTWGlobalConfiguration::SetPlanCacheSize( 32 );
+  stackFilter->Modified();
+  stackFilter->Update();
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans(), 1 );
+  itk::FFTWGlobalConfiguration::ClearPlanCache();
+  TEST_EXPECT_EQUAL( itk::FFTWGlobalConfiguration::GetNumberOfCachedPlans(), 0 );
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkFFTWComplexToComplexBatchFFTImageFilterTest( int, char * [] )
+{
+#if defined( ITK_USE_FFTWD )
+  if ( BatchTest< double >( 1e-9 ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+#endif
+#if defined( ITK_USE_FFTWF )
+  if ( BatchTest< float >( 1e-4f ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+#endif
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
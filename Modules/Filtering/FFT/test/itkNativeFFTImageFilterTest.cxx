@@ -0,0 +1,249 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNativeFFTImageFilterFactory.h"
+#include "itkVnlForwardFFTImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr itk::ThreadIdType NumberOfWorkUnits = 3;
+
+template< typename TImage >
+typename TImage::Pointer
+CreateRandomImage( const typename TImage::SizeType & size )
+{
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  typename TImage::Pointer image = TImage::New();
+  typename TImage::IndexType index;
+  index.Fill( 3 );
+  image->SetRegions( typename TImage::RegionType( index, size ) );
+  image->Allocate();
+  for ( itk::ImageRegionIterator< TImage > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    it.Set( generator->GetUniformVariate( -1.0, 1.0 ) );
+    }
+  return image;
+}
+
+// Discrete Fourier transform computed from its definition.
+template< typename TRealImage, typename TComplexImage >
+typename TComplexImage::Pointer
+ComputeDFT( const TRealImage * input )
+{
+  constexpr unsigned int Dimension = TRealImage::ImageDimension;
+  const typename TRealImage::RegionType region = input->GetLargestPossibleRegion();
+  typename TComplexImage::Pointer output = TComplexImage::New();
+  output->SetRegions( region );
+  output->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< TComplexImage > oIt( output, region ); !oIt.IsAtEnd(); ++oIt )
+    {
+    std::complex< double > sum = 0.0;
+    for ( itk::ImageRegionConstIteratorWithIndex< TRealImage > iIt( input, region ); !iIt.IsAtEnd(); ++iIt )
+      {
+      double phase = 0.0;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        const auto k = static_cast< double >( oIt.GetIndex()[d] - region.GetIndex()[d] );
+        const auto j = static_cast< double >( iIt.GetIndex()[d] - region.GetIndex()[d] );
+        phase += k * j / static_cast< double >( region.GetSize()[d] );
+        }
+      sum += static_cast< double >( iIt.Get() ) * std::polar( 1.0, -2.0 * itk::Math::pi * phase );
+      }
+    oIt.Set( typename TComplexImage::PixelType( sum ) );
+    }
+  return output;
+}
+
+template< typename TImage1, typename TImage2 >
+double
+MaximumDifference( const TImage1 * image1, const TImage2 * image2 )
+{
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIterator< TImage1 > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage2 > it2( image2, image2->GetLargestPossibleRegion() );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    maximumDifference = std::max( maximumDifference, static_cast< double >( std::abs( it1.Get() - it2.Get() ) ) );
+    }
+  return maximumDifference;
+}
+
+template< typename TPixel, unsigned int VDimension >
+bool
+TestSize( const itk::Size< VDimension > & size, double tolerance )
+{
+  using RealImageType = itk::Image< TPixel, VDimension >;
+  using ComplexImageType = itk::Image< std::complex< TPixel >, VDimension >;
+
+  typename RealImageType::Pointer input = CreateRandomImage< RealImageType >( size );
+  const double numberOfPixels = static_cast< double >( input->GetLargestPossibleRegion().GetNumberOfPixels() );
+  bool pass = true;
+  auto check = [&]( const char * description, double difference, double scale )
+    {
+    std::cout << size << " " << description << ": maximum difference " << difference << std::endl;
+    if ( difference > tolerance * scale )
+      {
+      std::cerr << size << " " << description << ": difference " << difference
+                << " exceeds " << tolerance * scale << std::endl;
+      pass = false;
+      }
+    };
+
+  // Forward transform, compared with Vnl when it supports the size, and
+  // with the definition otherwise.
+  using ForwardFilterType = itk::NativeForwardFFTImageFilter< RealImageType, ComplexImageType >;
+  typename ForwardFilterType::Pointer forward = ForwardFilterType::New();
+  forward->SetInput( input );
+  forward->SetNumberOfWorkUnits( NumberOfWorkUnits );
+  forward->Update();
+  typename ComplexImageType::Pointer expected;
+  bool vnlSize = true;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    vnlSize &= itk::VnlFFTCommon::IsDimensionSizeLegal( size[d] );
+    }
+  if ( vnlSize )
+    {
+    using VnlFilterType = itk::VnlForwardFFTImageFilter< RealImageType, ComplexImageType >;
+    typename VnlFilterType::Pointer vnl = VnlFilterType::New();
+    vnl->SetInput( input );
+    vnl->Update();
+    expected = vnl->GetOutput();
+    }
+  else
+    {
+    expected = ComputeDFT< RealImageType, ComplexImageType >( input );
+    }
+  if ( forward->GetOutput()->GetLargestPossibleRegion() != input->GetLargestPossibleRegion() )
+    {
+    std::cerr << size << " forward: wrong output region." << std::endl;
+    return false;
+    }
+  check( vnlSize ? "forward vs Vnl" : "forward vs DFT", MaximumDifference( forward->GetOutput(), expected.GetPointer() ),
+         std::sqrt( numberOfPixels ) );
+
+  using InverseFilterType = itk::NativeInverseFFTImageFilter< ComplexImageType, RealImageType >;
+  typename InverseFilterType::Pointer inverse = InverseFilterType::New();
+  inverse->SetInput( forward->GetOutput() );
+  inverse->SetNumberOfWorkUnits( NumberOfWorkUnits );
+  inverse->Update();
+  check( "forward / inverse", MaximumDifference( inverse->GetOutput(), input.GetPointer() ), 1.0 );
+
+  // Half Hermitian transforms.
+  using RealToHalfFilterType = itk::NativeRealToHalfHermitianForwardFFTImageFilter< RealImageType, ComplexImageType >;
+  typename RealToHalfFilterType::Pointer realToHalf = RealToHalfFilterType::New();
+  realToHalf->SetInput( input );
+  realToHalf->SetNumberOfWorkUnits( NumberOfWorkUnits );
+  realToHalf->Update();
+  double halfDifference = 0.0;
+  for ( itk::ImageRegionConstIteratorWithIndex< ComplexImageType > it( realToHalf->GetOutput(),
+          realToHalf->GetOutput()->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    halfDifference = std::max( halfDifference,
+                               static_cast< double >( std::abs( it.Get() - expected->GetPixel( it.GetIndex() ) ) ) );
+    }
+  check( "real to half Hermitian", halfDifference, std::sqrt( numberOfPixels ) );
+
+  using HalfToRealFilterType = itk::NativeHalfHermitianToRealInverseFFTImageFilter< ComplexImageType, RealImageType >;
+  typename HalfToRealFilterType::Pointer halfToReal = HalfToRealFilterType::New();
+  halfToReal->SetInput( realToHalf->GetOutput() );
+  halfToReal->SetActualXDimensionIsOdd( size[0] % 2 != 0 );
+  halfToReal->SetNumberOfWorkUnits( NumberOfWorkUnits );
+  halfToReal->Update();
+  check( "half Hermitian round trip", MaximumDifference( halfToReal->GetOutput(), input.GetPointer() ), 1.0 );
+
+  // Complex to complex transforms.
+  using ComplexFilterType = itk::NativeComplexToComplexFFTImageFilter< ComplexImageType >;
+  typename ComplexFilterType::Pointer inverseComplex = ComplexFilterType::New();
+  inverseComplex->SetInput( expected );
+  inverseComplex->SetTransformDirection( ComplexFilterType::INVERSE );
+  inverseComplex->SetNumberOfWorkUnits( NumberOfWorkUnits );
+  inverseComplex->Update();
+  double complexDifference = 0.0;
+  for ( itk::ImageRegionConstIteratorWithIndex< ComplexImageType > it( inverseComplex->GetOutput(),
+          inverseComplex->GetOutput()->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    complexDifference = std::max( complexDifference,
+      static_cast< double >( std::abs( it.Get() - std::complex< TPixel >( input->GetPixel( it.GetIndex() ) ) ) ) );
+    }
+  check( "complex inverse", complexDifference, 1.0 );
+
+  typename ComplexFilterType::Pointer forwardComplex = ComplexFilterType::New();
+  forwardComplex->SetInput( inverseComplex->GetOutput() );
+  forwardComplex->SetTransformDirection( ComplexFilterType::FORWARD );
+  forwardComplex->SetNumberOfWorkUnits( NumberOfWorkUnits );
+  forwardComplex->Update();
+  check( "complex forward", MaximumDifference( forwardComplex->GetOutput(), expected.GetPointer() ),
+         std::sqrt( numberOfPixels ) );
+
+  return pass;
+}
+}
+
+int itkNativeFFTImageFilterTest(int, char * [])
+{
+  bool pass = true;
+
+  // Sizes supported by Vnl.
+  pass &= TestSize< double, 2 >( itk::Size< 2 >{ { 16, 12 } }, 1e-12 );
+  pass &= TestSize< float, 2 >( itk::Size< 2 >{ { 30, 25 } }, 1e-5 );
+  pass &= TestSize< double, 3 >( itk::Size< 3 >{ { 9, 8, 5 } }, 1e-12 );
+  pass &= TestSize< float, 1 >( itk::Size< 1 >{ { 1000 } }, 1e-5 );
+
+  // Other prime factors, with the generic radix and Bluestein's
+  // algorithm.
+  pass &= TestSize< double, 2 >( itk::Size< 2 >{ { 7, 13 } }, 1e-12 );
+  pass &= TestSize< double, 2 >( itk::Size< 2 >{ { 97, 3 } }, 1e-12 );
+  pass &= TestSize< float, 2 >( itk::Size< 2 >{ { 11, 1 } }, 1e-5 );
+  pass &= TestSize< double, 3 >( itk::Size< 3 >{ { 1, 14, 11 } }, 1e-12 );
+  pass &= TestSize< double, 1 >( itk::Size< 1 >{ { 509 } }, 1e-12 );
+
+  // The factory replaces the default implementation.
+  using RealImageType = itk::Image< float, 3 >;
+  using ComplexImageType = itk::Image< std::complex< float >, 3 >;
+  itk::NativeFFTImageFilterFactory::RegisterOneFactory();
+  using ForwardFilterType = itk::ForwardFFTImageFilter< RealImageType, ComplexImageType >;
+  ForwardFilterType::Pointer forward = ForwardFilterType::New();
+  TEST_EXPECT_EQUAL( std::string( forward->GetNameOfClass() ), "NativeForwardFFTImageFilter" );
+  TEST_EXPECT_EQUAL( forward->GetSizeGreatestPrimeFactor(), 5 );
+  using InverseFilterType = itk::InverseFFTImageFilter< ComplexImageType, RealImageType >;
+  TEST_EXPECT_EQUAL( std::string( InverseFilterType::New()->GetNameOfClass() ), "NativeInverseFFTImageFilter" );
+  using RealToHalfFilterType = itk::RealToHalfHermitianForwardFFTImageFilter< RealImageType, ComplexImageType >;
+  TEST_EXPECT_EQUAL( std::string( RealToHalfFilterType::New()->GetNameOfClass() ),
+                     "NativeRealToHalfHermitianForwardFFTImageFilter" );
+  using HalfToRealFilterType = itk::HalfHermitianToRealInverseFFTImageFilter< ComplexImageType, RealImageType >;
+  TEST_EXPECT_EQUAL( std::string( HalfToRealFilterType::New()->GetNameOfClass() ),
+                     "NativeHalfHermitianToRealInverseFFTImageFilter" );
+  using ComplexFilterType = itk::ComplexToComplexFFTImageFilter< ComplexImageType >;
+  TEST_EXPECT_EQUAL( std::string( ComplexFilterType::New()->GetNameOfClass() ),
+                     "NativeComplexToComplexFFTImageFilter" );
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
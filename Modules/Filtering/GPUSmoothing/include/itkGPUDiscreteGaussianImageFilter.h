@@ -40,6 +40,11 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * Only the directly convolved kernels of DiscreteGaussianImageFilter run on
+ * the GPU. When a dimension is smoothed with the RECURSIVE or FFT algorithm
+ * (by default, the large variances whose kernel exceeds MaximumKernelWidth),
+ * the whole image is smoothed by the CPU implementation.
+ *
  * \ingroup ITKGPUSmoothing
  */
 
@@ -122,6 +122,20 @@ GPUDiscreteGaussianImageFilter< TInputImage, TOutputImage >
       }
     return;
     }
+
+  // The GPU filters only convolve with GaussianOperator kernels truncated to
+  // MaximumKernelWidth. When the CPU filter smooths a dimension with its
+  // untruncated RECURSIVE or FFT kernels, run it instead, so that both give
+  // the same output.
+  const typename CPUSuperclass::AlgorithmArrayType algorithms = this->GetKernelAlgorithms( localInput->GetSpacing() );
+  for ( unsigned int d = 0; d < filterDimensionality; ++d )
+    {
+    if ( algorithms[d] != CPUSuperclass::DIRECT )
+      {
+      CPUSuperclass::GenerateData();
+      return;
+      }
+    }
 /*
   // Type of the pixel to use for intermediate results
   using RealOutputPixelType = typename NumericTraits< OutputPixelType >::RealType;
@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkGeneratorImageFilterDetail.h"
 
 
 #include <functional>
@@ -45,6 +46,12 @@ namespace itk
  * the pipeline. The SetConstant() and GetConstant() methods are provided as shortcuts
  * to set or get the constant value without manipulating the decorator.
  *
+ * When all the images have arithmetic pixel types stored in their buffers,
+ * the functor is applied to contiguous runs of pixels through raw pointers,
+ * in fixed size batches which the compiler can vectorize. Other images are
+ * processed pixel by pixel with scanline iterators. Both paths give the
+ * same result.
+ *
  * \sa UnaryGeneratorImageFilter
  * \sa BinaryFunctorImageFilter
  *
@@ -236,6 +243,21 @@ protected:
   void GenerateOutputInformation() override;
 
 private:
+  /** Contiguous buffer implementation of
+   * DynamicThreadedGenerateDataWithFunctor. Returns false, without
+   * processing anything, when the images do not allow it. */
+  template <typename TFunctor>
+  bool DynamicThreadedGenerateDataOnContiguousBuffers(const TFunctor &,
+                                                      const OutputImageRegionType & outputRegionForThread,
+                                                      std::true_type);
+  template <typename TFunctor>
+  bool DynamicThreadedGenerateDataOnContiguousBuffers(const TFunctor &,
+                                                      const OutputImageRegionType &,
+                                                      std::false_type)
+  {
+    return false;
+  }
+
   std::function<void(const OutputImageRegionType &)> m_DynamicThreadedGenerateDataFunction;
 };
 } // end namespace itk
@@ -216,6 +216,15 @@ BinaryGeneratorImageFilter< TInputImage1, TInputImage2, TOutputImage >
     return;
     }
 
+  using ContiguousBuffersType = std::integral_constant< bool,
+    GeneratorImageFilterDetail::HasContiguousScalarPixels< TInputImage1 >::value
+    && GeneratorImageFilterDetail::HasContiguousScalarPixels< TInputImage2 >::value
+    && GeneratorImageFilterDetail::HasContiguousScalarPixels< TOutputImage >::value >;
+  if ( this->DynamicThreadedGenerateDataOnContiguousBuffers( functor, outputRegionForThread, ContiguousBuffersType() ) )
+    {
+    return;
+    }
+
   if( inputPtr1 && inputPtr2 )
     {
     ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
@@ -280,6 +289,85 @@ BinaryGeneratorImageFilter< TInputImage1, TInputImage2, TOutputImage >
     itkGenericExceptionMacro(<<"At most one of the inputs can be a constant.");
     }
 }
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage>
+template< typename TFunctor >
+bool
+BinaryGeneratorImageFilter< TInputImage1, TInputImage2, TOutputImage >
+::DynamicThreadedGenerateDataOnContiguousBuffers(
+    const TFunctor & functor,
+    const OutputImageRegionType & outputRegionForThread,
+    std::true_type)
+{
+  const TInputImage1 *inputPtr1 =
+    dynamic_cast< const TInputImage1 * >( ProcessObject::GetInput(0) );
+  const TInputImage2 *inputPtr2 =
+    dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
+  TOutputImage *outputPtr = this->GetOutput(0);
+  OutputImagePixelType *outputBuffer = outputPtr->GetBufferPointer();
+
+  using IndexType = typename OutputImageRegionType::IndexType;
+
+  if( inputPtr1 && inputPtr2 )
+    {
+    const Input1ImagePixelType *inputBuffer1 = inputPtr1->GetBufferPointer();
+    const Input2ImagePixelType *inputBuffer2 = inputPtr2->GetBufferPointer();
+    GeneratorImageFilterDetail::ForEachContiguousRun(
+      outputRegionForThread,
+      { inputPtr1->GetBufferedRegion(), inputPtr2->GetBufferedRegion(), outputPtr->GetBufferedRegion() },
+      [&](const IndexType & index, SizeValueType length)
+        {
+        GeneratorImageFilterDetail::BinaryRun( functor,
+                                               inputBuffer1 + inputPtr1->ComputeOffset( index ),
+                                               inputBuffer2 + inputPtr2->ComputeOffset( index ),
+                                               outputBuffer + outputPtr->ComputeOffset( index ),
+                                               length );
+        } );
+    return true;
+    }
+  else if( inputPtr1 )
+    {
+    const Input1ImagePixelType *inputBuffer1 = inputPtr1->GetBufferPointer();
+    const Input2ImagePixelType input2Value = this->GetConstant2();
+    auto constantFunctor = [&functor, input2Value](const Input1ImagePixelType & input1Value)
+      {
+      return functor( input1Value, input2Value );
+      };
+    GeneratorImageFilterDetail::ForEachContiguousRun(
+      outputRegionForThread,
+      { inputPtr1->GetBufferedRegion(), outputPtr->GetBufferedRegion() },
+      [&](const IndexType & index, SizeValueType length)
+        {
+        GeneratorImageFilterDetail::UnaryRun( constantFunctor,
+                                              inputBuffer1 + inputPtr1->ComputeOffset( index ),
+                                              outputBuffer + outputPtr->ComputeOffset( index ),
+                                              length );
+        } );
+    return true;
+    }
+  else if( inputPtr2 )
+    {
+    const Input2ImagePixelType *inputBuffer2 = inputPtr2->GetBufferPointer();
+    const Input1ImagePixelType input1Value = this->GetConstant1();
+    auto constantFunctor = [&functor, input1Value](const Input2ImagePixelType & input2Value)
+      {
+      return functor( input1Value, input2Value );
+      };
+    GeneratorImageFilterDetail::ForEachContiguousRun(
+      outputRegionForThread,
+      { inputPtr2->GetBufferedRegion(), outputPtr->GetBufferedRegion() },
+      [&](const IndexType & index, SizeValueType length)
+        {
+        GeneratorImageFilterDetail::UnaryRun( constantFunctor,
+                                              inputBuffer2 + inputPtr2->ComputeOffset( index ),
+                                              outputBuffer + outputPtr->ComputeOffset( index ),
+                                              length );
+        } );
+    return true;
+    }
+  // Let the scanline implementation report the missing inputs.
+  return false;
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkGeneratorImageFilterDetail_h
+#define itkGeneratorImageFilterDetail_h
+
+#include "itkImageRegion.h"
+#include "itkDefaultPixelAccessor.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+
+namespace itk
+{
+/** GeneratorImageFilterDetail namespace to house the buffer level
+ * implementation shared by UnaryGeneratorImageFilter and
+ * BinaryGeneratorImageFilter.
+ *
+ * When the pixels of all the images are arithmetic scalars stored directly
+ * in the image buffers, the filters do not walk the images with scanline
+ * iterators but apply the functor to runs of raw pixel pointers. Each run
+ * is processed in batches of BatchSize pixels which are first computed into
+ * a local array and then stored. The inner loop of a batch has a fixed trip
+ * count and cannot alias the output, so that the compiler emits SIMD
+ * instructions for it whenever the functor can be inlined, as is the case
+ * for the functors of itkArithmeticOpsFunctors.h and for lambdas. Storing
+ * after computing also keeps in-place execution correct.
+ */
+namespace GeneratorImageFilterDetail
+{
+/** \struct HasContiguousScalarPixels
+ * \brief Whether the pixels of TImage can be read and written through
+ * raw pointers to its buffer.
+ *
+ * This is true for images of arithmetic pixels with the default pixel
+ * accessor, and false e.g. for VectorImage and for ImageAdaptor.
+ */
+template< typename TImage >
+struct HasContiguousScalarPixels
+{
+  using PixelType = typename TImage::PixelType;
+  static constexpr bool value =
+    std::is_arithmetic< PixelType >::value
+    && std::is_same< PixelType, typename TImage::InternalPixelType >::value
+    && std::is_same< typename TImage::AccessorType, DefaultPixelAccessor< PixelType > >::value;
+};
+
+/** Number of pixels computed per batch. 16 fills two AVX-512 registers
+ * with floats and keeps the local array small for doubles. */
+constexpr unsigned int BatchSize = 16;
+
+/** output[i] = functor( input[i] ) for i in [0, length). */
+template< typename TFunctor, typename TInput, typename TOutput >
+inline void
+UnaryRun(const TFunctor & functor, const TInput * input, TOutput * output, SizeValueType length)
+{
+  SizeValueType i = 0;
+  for ( ; i + BatchSize <= length; i += BatchSize )
+    {
+    TOutput batch[BatchSize];
+    for ( unsigned int j = 0; j < BatchSize; ++j )
+      {
+      batch[j] = functor( input[i + j] );
+      }
+    std::copy( batch, batch + BatchSize, output + i );
+    }
+  for ( ; i < length; ++i )
+    {
+    output[i] = functor( input[i] );
+    }
+}
+
+/** output[i] = functor( input1[i], input2[i] ) for i in [0, length). */
+template< typename TFunctor, typename TInput1, typename TInput2, typename TOutput >
+inline void
+BinaryRun(const TFunctor & functor, const TInput1 * input1, const TInput2 * input2,
+          TOutput * output, SizeValueType length)
+{
+  SizeValueType i = 0;
+  for ( ; i + BatchSize <= length; i += BatchSize )
+    {
+    TOutput batch[BatchSize];
+    for ( unsigned int j = 0; j < BatchSize; ++j )
+      {
+      batch[j] = functor( input1[i + j], input2[i + j] );
+      }
+    std::copy( batch, batch + BatchSize, output + i );
+    }
+  for ( ; i < length; ++i )
+    {
+    output[i] = functor( input1[i], input2[i] );
+    }
+}
+
+/** Call runFunction( runIndex, runLength ) for each run of pixels of region
+ * which is contiguous in the buffers of all the images, given their
+ * buffered regions. Consecutive scanlines are merged into a single run as
+ * long as region spans the whole buffered region of every image along the
+ * lower dimensions, so that e.g. a region which covers complete slices is
+ * processed as one run per slice or less. */
+template< unsigned int VDimension, typename TRunFunction >
+void
+ForEachContiguousRun(const ImageRegion< VDimension > & region,
+                     std::initializer_list< ImageRegion< VDimension > > bufferedRegions,
+                     const TRunFunction & runFunction)
+{
+  using IndexType = typename ImageRegion< VDimension >::IndexType;
+  using SizeType = typename ImageRegion< VDimension >::SizeType;
+
+  const SizeType & size = region.GetSize();
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    if ( size[d] == 0 )
+      {
+      return;
+      }
+    }
+
+  SizeValueType runLength = size[0];
+  unsigned int  firstOuterDimension = 1;
+  while ( firstOuterDimension < VDimension )
+    {
+    bool spansBuffers = true;
+    for ( const auto & bufferedRegion : bufferedRegions )
+      {
+      spansBuffers = spansBuffers && bufferedRegion.GetSize( firstOuterDimension - 1 ) == size[firstOuterDimension - 1];
+      }
+    if ( !spansBuffers )
+      {
+      break;
+      }
+    runLength *= size[firstOuterDimension];
+    ++firstOuterDimension;
+    }
+
+  const IndexType & startIndex = region.GetIndex();
+  IndexType         index = startIndex;
+  while ( true )
+    {
+    runFunction( index, runLength );
+
+    unsigned int d = firstOuterDimension;
+    for ( ; d < VDimension; ++d )
+      {
+      ++index[d];
+      if ( static_cast< SizeValueType >( index[d] - startIndex[d] ) < size[d] )
+        {
+        break;
+        }
+      index[d] = startIndex[d];
+      }
+    if ( d == VDimension )
+      {
+      return;
+      }
+    }
+}
+} // end namespace GeneratorImageFilterDetail
+} // end namespace itk
+
+#endif
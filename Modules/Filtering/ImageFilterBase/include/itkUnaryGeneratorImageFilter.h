@@ -21,6 +21,7 @@
 #include "itkMath.h"
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkGeneratorImageFilterDetail.h"
 
 #include <functional>
 
@@ -45,6 +46,12 @@ namespace itk
  * UnaryGeneratorImageFilter can be used to promote a 2D image to a 3D
  * image, etc.
  *
+ * When the input and output have the same dimension and arithmetic pixel
+ * types stored in their buffers, the functor is applied to contiguous runs
+ * of pixels through raw pointers, in fixed size batches which the compiler
+ * can vectorize. Other images are processed pixel by pixel with scanline
+ * iterators. Both paths give the same result.
+ *
  * \sa UnaryFunctorImageFilter
  * \sa BinaryGeneratorImageFilter TernaryGeneratormageFilter
  *
@@ -171,6 +178,21 @@ protected:
   void DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
 
 private:
+  /** Contiguous buffer implementation of
+   * DynamicThreadedGenerateDataWithFunctor. Returns false, without
+   * processing anything, when the images do not allow it. */
+  template <typename TFunctor>
+  bool DynamicThreadedGenerateDataOnContiguousBuffers(const TFunctor &,
+                                                      const OutputImageRegionType & outputRegionForThread,
+                                                      std::true_type);
+  template <typename TFunctor>
+  bool DynamicThreadedGenerateDataOnContiguousBuffers(const TFunctor &,
+                                                      const OutputImageRegionType &,
+                                                      std::false_type)
+  {
+    return false;
+  }
+
   std::function<void(const OutputImageRegionType &)> m_DynamicThreadedGenerateDataFunction;
 };
 } // end namespace itk
@@ -100,6 +100,17 @@ UnaryGeneratorImageFilter< TInputImage, TOutputImage >
     {
     return;
     }
+
+  using ContiguousBuffersType = std::integral_constant< bool,
+    GeneratorImageFilterDetail::HasContiguousScalarPixels< TInputImage >::value
+    && GeneratorImageFilterDetail::HasContiguousScalarPixels< TOutputImage >::value
+    && static_cast< unsigned int >( TInputImage::ImageDimension )
+       == static_cast< unsigned int >( TOutputImage::ImageDimension ) >;
+  if ( this->DynamicThreadedGenerateDataOnContiguousBuffers( functor, outputRegionForThread, ContiguousBuffersType() ) )
+    {
+    return;
+    }
+
   const TInputImage *inputPtr = this->GetInput();
   TOutputImage *outputPtr = this->GetOutput(0);
 
@@ -128,6 +139,47 @@ UnaryGeneratorImageFilter< TInputImage, TOutputImage >
     outputIt.NextLine();
     }
 }
+
+
+template< typename TInputImage, typename TOutputImage >
+template< typename TFunctor >
+bool
+UnaryGeneratorImageFilter< TInputImage, TOutputImage >
+::DynamicThreadedGenerateDataOnContiguousBuffers(
+    const TFunctor &functor,
+    const OutputImageRegionType & outputRegionForThread,
+    std::true_type)
+{
+  const TInputImage *inputPtr = this->GetInput();
+  TOutputImage *outputPtr = this->GetOutput(0);
+
+  InputImageRegionType inputRegionForThread;
+  this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
+  if ( inputRegionForThread.GetSize() != outputRegionForThread.GetSize() )
+    {
+    return false;
+    }
+
+  // A subclass may map the output region to an input region at another
+  // location, so the runs are located with the offset between the two.
+  const typename OutputImageRegionType::OffsetType inputOffset =
+    inputRegionForThread.GetIndex() - outputRegionForThread.GetIndex();
+
+  const typename TInputImage::PixelType *inputBuffer = inputPtr->GetBufferPointer();
+  typename TOutputImage::PixelType *outputBuffer = outputPtr->GetBufferPointer();
+
+  GeneratorImageFilterDetail::ForEachContiguousRun(
+    outputRegionForThread,
+    { inputPtr->GetBufferedRegion(), outputPtr->GetBufferedRegion() },
+    [&](const typename OutputImageRegionType::IndexType & index, SizeValueType length)
+      {
+      GeneratorImageFilterDetail::UnaryRun( functor,
+                                            inputBuffer + inputPtr->ComputeOffset( index + inputOffset ),
+                                            outputBuffer + outputPtr->ComputeOffset( index ),
+                                            length );
+      } );
+  return true;
+}
 } // end namespace itk
 
 #endif
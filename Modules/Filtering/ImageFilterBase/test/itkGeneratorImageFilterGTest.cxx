@@ -20,6 +20,8 @@
 #include "itkBinaryGeneratorImageFilter.h"
 #include "itkImage.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkVectorImage.h"
 
 #include "itkGTest.h"
 
@@ -263,3 +265,144 @@ TEST(BinaryGeneratorImageFilter, SetFunctor)
   EXPECT_NEAR(2.0, outputImage->GetPixel(idx), 1e-8);
 
 }
+
+
+namespace
+{
+
+// Compare the output of a filter on requestedRegion with the functor
+// applied pixel by pixel to the inputs.
+template< typename TImage, typename TFunctor >
+void CheckAgainstPerPixel( const TImage *output, const TImage *input1, const TImage *input2,
+                           const typename TImage::RegionType & requestedRegion, const TFunctor &functor )
+{
+  itk::ImageRegionConstIteratorWithIndex<TImage> it( output, requestedRegion );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType & index = it.GetIndex();
+    ASSERT_EQ( functor( input1->GetPixel( index ), input2->GetPixel( index ) ), it.Get() ) << "at " << index;
+    }
+}
+
+template< typename TImage >
+typename TImage::Pointer CreateRampImage( const typename TImage::SizeType & size, unsigned int seed )
+{
+  auto image = TImage::New();
+  image->SetRegions( typename TImage::RegionType( size ) );
+  image->Allocate();
+  itk::ImageRegionIterator<TImage> it( image, image->GetBufferedRegion() );
+  unsigned int value = seed;
+  for (; !it.IsAtEnd(); ++it )
+    {
+    value = value * 1103515245u + 12345u;
+    it.Set( static_cast< typename TImage::PixelType >( ( value >> 16 ) % 200 ) );
+    }
+  return image;
+}
+
+}
+
+
+TEST(BinaryGeneratorImageFilter, ContiguousBuffers)
+{
+  using ImageType = itk::Image<short, 3>;
+  using FilterType = itk::BinaryGeneratorImageFilter<ImageType, ImageType, ImageType>;
+
+  // odd sizes so that runs end with a partial batch
+  ImageType::SizeType size = {{37, 13, 5}};
+  auto image1 = CreateRampImage<ImageType>( size, 1 );
+  auto image2 = CreateRampImage<ImageType>( size, 2 );
+
+  auto functor = [](const short &a, const short &b) { return static_cast<short>( 3 * a - b ); };
+
+  auto filter = FilterType::New();
+  filter->SetInput1( image1 );
+  filter->SetInput2( image2 );
+  filter->SetFunctor( functor );
+  filter->Update();
+  CheckAgainstPerPixel<ImageType>( filter->GetOutput(), image1, image2, image1->GetLargestPossibleRegion(), functor );
+
+  // A requested region which does not span the rows of the input buffers
+  ImageType::RegionType requestedRegion( ImageType::IndexType{{3, 2, 1}}, ImageType::SizeType{{30, 9, 3}} );
+  auto regionFilter = FilterType::New();
+  regionFilter->SetInput1( image1 );
+  regionFilter->SetInput2( image2 );
+  regionFilter->SetFunctor( functor );
+  regionFilter->GetOutput()->SetRequestedRegion( requestedRegion );
+  regionFilter->Update();
+  EXPECT_EQ( requestedRegion, regionFilter->GetOutput()->GetBufferedRegion() );
+  CheckAgainstPerPixel<ImageType>( regionFilter->GetOutput(), image1, image2, requestedRegion, functor );
+
+  // Constant operands
+  auto constantFunctor = [](const short &a, const short &b) { return static_cast<short>( a * b ); };
+  auto constant2Filter = FilterType::New();
+  constant2Filter->SetInput1( image1 );
+  constant2Filter->SetConstant2( 7 );
+  constant2Filter->SetFunctor( constantFunctor );
+  constant2Filter->Update();
+  auto constantImage = CreateRampImage<ImageType>( size, 3 );
+  constantImage->FillBuffer( 7 );
+  CheckAgainstPerPixel<ImageType>( constant2Filter->GetOutput(), image1, constantImage,
+                                   image1->GetLargestPossibleRegion(), constantFunctor );
+
+  auto constant1Filter = FilterType::New();
+  constant1Filter->SetConstant1( 7 );
+  constant1Filter->SetInput2( image2 );
+  constant1Filter->SetFunctor( constantFunctor );
+  constant1Filter->Update();
+  CheckAgainstPerPixel<ImageType>( constant1Filter->GetOutput(), constantImage, image2,
+                                   image2->GetLargestPossibleRegion(), constantFunctor );
+
+  // In place, the output reuses the buffer of the first input
+  auto inputCopy = CreateRampImage<ImageType>( size, 1 );
+  auto inPlaceFilter = FilterType::New();
+  inPlaceFilter->SetInput1( inputCopy );
+  inPlaceFilter->SetInput2( image2 );
+  inPlaceFilter->SetFunctor( functor );
+  inPlaceFilter->InPlaceOn();
+  inPlaceFilter->Update();
+  EXPECT_EQ( inputCopy->GetBufferPointer(), nullptr );
+  CheckAgainstPerPixel<ImageType>( inPlaceFilter->GetOutput(), image1, image2, image1->GetLargestPossibleRegion(), functor );
+}
+
+
+TEST(UnaryGeneratorImageFilter, ContiguousBuffers)
+{
+  using InputImageType = itk::Image<unsigned char, 2>;
+  using OutputImageType = itk::Image<float, 2>;
+  using FilterType = itk::UnaryGeneratorImageFilter<InputImageType, OutputImageType>;
+
+  InputImageType::SizeType size = {{67, 23}};
+  auto image = CreateRampImage<InputImageType>( size, 5 );
+
+  auto filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetFunctor( [](const unsigned char &v) { return 0.5f * v - 1.0f; } );
+
+  OutputImageType::RegionType requestedRegion( OutputImageType::IndexType{{1, 4}}, OutputImageType::SizeType{{50, 17}} );
+  filter->GetOutput()->SetRequestedRegion( requestedRegion );
+  filter->Update();
+
+  itk::ImageRegionConstIteratorWithIndex<OutputImageType> it( filter->GetOutput(), requestedRegion );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    ASSERT_EQ( 0.5f * image->GetPixel( it.GetIndex() ) - 1.0f, it.Get() );
+    }
+
+  // Pixel types which are not scalars take the per-pixel path
+  using VectorImageType = itk::VectorImage<float, 2>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( VectorImageType::RegionType( size ) );
+  vectorImage->SetNumberOfComponentsPerPixel( 2 );
+  vectorImage->Allocate();
+  VectorImageType::PixelType value( 2 );
+  value.Fill( 3.0f );
+  vectorImage->FillBuffer( value );
+
+  using VectorFilterType = itk::UnaryGeneratorImageFilter<VectorImageType, OutputImageType>;
+  auto vectorFilter = VectorFilterType::New();
+  vectorFilter->SetInput( vectorImage );
+  vectorFilter->SetFunctor( [](const VectorImageType::PixelType &v) { return v[0] + v[1]; } );
+  vectorFilter->Update();
+  EXPECT_EQ( 6.0f, vectorFilter->GetOutput()->GetPixel( OutputImageType::IndexType{{66, 22}} ) );
+}
@@ -0,0 +1,216 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAddImageFilter.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkDivideImageFilter.h"
+#include "itkUnaryGeneratorImageFilter.h"
+#include "itkImageScanlineIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTimeProbesCollectorBase.h"
+
+#include <algorithm>
+#include <string>
+
+/**
+ * Compares the generator filters, which process scalar images through
+ * batched raw pointer loops, with the per-pixel scanline iterator loop
+ * which they used before, on a single thread so that only the inner
+ * loops are measured. Both must produce identical images.
+ */
+namespace
+{
+using ImageType = itk::Image< float, 3 >;
+
+template< typename TFunctor >
+void PerPixelBinary(const TFunctor & functor, const ImageType * input1, const ImageType * input2, ImageType * output)
+{
+  const ImageType::RegionType region = output->GetBufferedRegion();
+  itk::ImageScanlineConstIterator< ImageType > inputIt1( input1, region );
+  itk::ImageScanlineConstIterator< ImageType > inputIt2( input2, region );
+  itk::ImageScanlineIterator< ImageType >      outputIt( output, region );
+  while ( !inputIt1.IsAtEnd() )
+    {
+    while ( !inputIt1.IsAtEndOfLine() )
+      {
+      outputIt.Set( functor( inputIt1.Get(), inputIt2.Get() ) );
+      ++inputIt1;
+      ++inputIt2;
+      ++outputIt;
+      }
+    inputIt1.NextLine();
+    inputIt2.NextLine();
+    outputIt.NextLine();
+    }
+}
+
+bool SameImages(const ImageType * image1, const ImageType * image2)
+{
+  itk::ImageRegionConstIterator< ImageType > it1( image1, image1->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< ImageType > it2( image2, image1->GetBufferedRegion() );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if ( it1.Get() != it2.Get() )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TFilter >
+bool ProfileBinaryFilter(const char * name, const ImageType * input1, const ImageType * input2,
+                         unsigned int repetitions, itk::TimeProbesCollectorBase & chronometer)
+{
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetInput1( input1 );
+  filter->SetInput2( input2 );
+  filter->SetNumberOfWorkUnits( 1 );
+
+  ImageType::Pointer reference = ImageType::New();
+  reference->SetRegions( input1->GetLargestPossibleRegion() );
+  reference->Allocate();
+
+  const std::string filterLabel = std::string( name ) + " (generator filter)";
+  const std::string loopLabel = std::string( name ) + " (per-pixel loop)";
+  const typename TFilter::FunctorType functor;
+  for ( unsigned int i = 0; i < repetitions; ++i )
+    {
+    filter->Modified();
+    chronometer.Start( filterLabel.c_str() );
+    filter->Update();
+    chronometer.Stop( filterLabel.c_str() );
+
+    chronometer.Start( loopLabel.c_str() );
+    PerPixelBinary( functor, input1, input2, reference );
+    chronometer.Stop( loopLabel.c_str() );
+    }
+
+  if ( !SameImages( filter->GetOutput(), reference ) )
+    {
+    std::cerr << name << ": generator filter and per-pixel loop differ" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkGeneratorImageFilterProfileTest1(int argc, char *argv[])
+{
+  unsigned int imageSize = 128;
+  if ( argc > 1 )
+    {
+    imageSize = std::stoi( argv[1] );
+    }
+  const unsigned int repetitions = 10;
+
+  ImageType::SizeType size;
+  size.Fill( imageSize );
+  ImageType::Pointer input1 = ImageType::New();
+  input1->SetRegions( size );
+  input1->Allocate();
+  ImageType::Pointer input2 = ImageType::New();
+  input2->SetRegions( size );
+  input2->Allocate();
+
+  itk::ImageScanlineIterator< ImageType > it1( input1, input1->GetBufferedRegion() );
+  itk::ImageScanlineIterator< ImageType > it2( input2, input2->GetBufferedRegion() );
+  unsigned int value = 0;
+  while ( !it1.IsAtEnd() )
+    {
+    while ( !it1.IsAtEndOfLine() )
+      {
+      it1.Set( static_cast< float >( value % 251 ) );
+      it2.Set( static_cast< float >( value % 13 ) );
+      ++value;
+      ++it1;
+      ++it2;
+      }
+    it1.NextLine();
+    it2.NextLine();
+    }
+
+  itk::TimeProbesCollectorBase chronometer;
+  bool success = true;
+
+  success &= ProfileBinaryFilter< itk::AddImageFilter< ImageType > >(
+    "Add", input1, input2, repetitions, chronometer );
+  success &= ProfileBinaryFilter< itk::MultiplyImageFilter< ImageType > >(
+    "Multiply", input1, input2, repetitions, chronometer );
+  success &= ProfileBinaryFilter< itk::DivideImageFilter< ImageType, ImageType, ImageType > >(
+    "Divide", input1, input2, repetitions, chronometer );
+
+  // Clamping cast through a lambda
+  using OutputImageType = itk::Image< unsigned char, 3 >;
+  using UnaryFilterType = itk::UnaryGeneratorImageFilter< ImageType, OutputImageType >;
+  auto clamp = [](const float & v) -> unsigned char
+    {
+    return static_cast< unsigned char >( std::min( std::max( v * 2.0f, 0.0f ), 255.0f ) );
+    };
+  UnaryFilterType::Pointer unaryFilter = UnaryFilterType::New();
+  unaryFilter->SetInput( input1 );
+  unaryFilter->SetFunctor( clamp );
+  unaryFilter->SetNumberOfWorkUnits( 1 );
+  OutputImageType::Pointer unaryReference = OutputImageType::New();
+  unaryReference->SetRegions( size );
+  unaryReference->Allocate();
+  for ( unsigned int i = 0; i < repetitions; ++i )
+    {
+    unaryFilter->Modified();
+    chronometer.Start( "Clamp (generator filter)" );
+    unaryFilter->Update();
+    chronometer.Stop( "Clamp (generator filter)" );
+
+    chronometer.Start( "Clamp (per-pixel loop)" );
+    itk::ImageScanlineConstIterator< ImageType > inputIt( input1, input1->GetBufferedRegion() );
+    itk::ImageScanlineIterator< OutputImageType > outputIt( unaryReference, unaryReference->GetBufferedRegion() );
+    while ( !inputIt.IsAtEnd() )
+      {
+      while ( !inputIt.IsAtEndOfLine() )
+        {
+        outputIt.Set( clamp( inputIt.Get() ) );
+        ++inputIt;
+        ++outputIt;
+        }
+      inputIt.NextLine();
+      outputIt.NextLine();
+      }
+    chronometer.Stop( "Clamp (per-pixel loop)" );
+    }
+  itk::ImageRegionConstIterator< OutputImageType > filterIt( unaryFilter->GetOutput(), unaryReference->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< OutputImageType > referenceIt( unaryReference, unaryReference->GetBufferedRegion() );
+  for ( ; !filterIt.IsAtEnd(); ++filterIt, ++referenceIt )
+    {
+    if ( filterIt.Get() != referenceIt.Get() )
+      {
+      std::cerr << "Clamp: generator filter and per-pixel loop differ" << std::endl;
+      success = false;
+      break;
+      }
+    }
+
+  chronometer.Report( std::cout );
+
+  if ( !success )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
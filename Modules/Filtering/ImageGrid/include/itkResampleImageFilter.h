@@ -28,6 +28,8 @@
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDataObjectDecorator.h"
 
+#include <type_traits>
+
 
 namespace itk
 {
@@ -322,7 +324,11 @@ protected:
   virtual void NonlinearThreadedGenerateData(const OutputImageRegionType & outputRegionForThread);
 
   /** Implementation for resampling that works for with linear
-   *  transformation types. */
+   *  transformation types. When both images are scalar itk::Image's of
+   *  dimension 3 or less, the precision types are double, the interpolator
+   *  is a LinearInterpolateImageFunction and no extrapolator is set, the
+   *  scanlines are computed with SSE2 instructions on processors that
+   *  support them. */
   virtual void LinearThreadedGenerateData(const OutputImageRegionType & outputRegionForThread);
 
   /** Cast pixel from interpolator output to PixelType. */
@@ -332,6 +338,33 @@ protected:
                                                  const ComponentType maxComponent) const);
 
 private:
+  /** Whether the image and precision types allow the scanline kernel. */
+  using LinearScanlineKernelSupportedType = std::integral_constant< bool,
+    std::is_same< TInputImage, Image< InputPixelType, InputImageDimension > >::value
+    && std::is_same< TOutputImage, Image< PixelType, ImageDimension > >::value
+    && std::is_arithmetic< InputPixelType >::value
+    && std::is_arithmetic< PixelType >::value
+    && std::is_same< typename NumericTraits< InputPixelType >::RealType, double >::value
+    && std::is_same< TInterpolatorPrecisionType, double >::value
+    && std::is_same< TTransformPrecisionType, double >::value
+    && InputImageDimension == ImageDimension
+    && ImageDimension <= 3 >;
+
+  /** Compute the output pixels of the scanlines of the region two at a
+   * time with SSE2 instructions: the continuous indices, the floor, the
+   * offsets of the neighbors and the blend are computed for both pixels at
+   * once, and pixels mapped outside of the input buffer are replaced by the
+   * default value through a mask. The result is identical to evaluating
+   * the LinearInterpolateImageFunction at each pixel. Returns false,
+   * without computing anything, if SSE2 is not available, the interpolator
+   * is not exactly a LinearInterpolateImageFunction or an extrapolator is
+   * set. */
+  bool LinearScanlineThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type);
+  bool LinearScanlineThreadedGenerateData(const OutputImageRegionType &, std::false_type)
+  {
+    return false;
+  }
+
   static PixelComponentType CastComponentWithBoundsChecking(const PixelComponentType value);
 
   template <typename TComponent>
@@ -28,6 +28,15 @@
 #include "itkDefaultConvertPixelTraits.h"
 
 #include <type_traits>  // For is_same.
+#include <typeinfo>
+
+#if ( defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) ) \
+  && !defined( ITK_WRAPPING_PARSER )
+#  define ITK_RESAMPLE_USE_SSE2 1
+#  include <emmintrin.h>
+#else
+#  define ITK_RESAMPLE_USE_SSE2 0
+#endif
 
 namespace itk
 {
@@ -402,6 +411,11 @@ void
 ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
 ::LinearThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
 {
+  if ( this->LinearScanlineThreadedGenerateData( outputRegionForThread, LinearScanlineKernelSupportedType() ) )
+    {
+    return;
+    }
+
   OutputImageType *outputPtr = this->GetOutput();
   const InputImageType *inputPtr = this->GetInput();
   const TransformType *transformPtr = this->GetTransform();
@@ -498,6 +512,196 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
     }
 }
 
+template< typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType >
+bool
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::LinearScanlineThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type)
+{
+#if ITK_RESAMPLE_USE_SSE2
+  const auto & interpolator = *m_Interpolator;
+  if ( m_Extrapolator.IsNotNull() || typeid( interpolator ) != typeid( LinearInterpolatorType ) )
+    {
+    return false;
+    }
+
+  using IndexValueType = typename IndexType::IndexValueType;
+  constexpr unsigned int NumberOfCorners = 1u << ImageDimension;
+
+  OutputImageType *outputPtr = this->GetOutput();
+  const InputImageType *inputPtr = this->GetInput();
+  const TransformType *transformPtr = this->GetTransform();
+  const auto & linearInterpolator = static_cast< const LinearInterpolatorType & >( interpolator );
+
+  // The offsets of the buffer are computed in 32 bits.
+  if ( inputPtr->GetBufferedRegion().GetNumberOfPixels()
+       >= static_cast< SizeValueType >( NumericTraits< int32_t >::max() ) )
+    {
+    return false;
+    }
+
+  const InputImageRegionType &largestPossibleRegion = outputPtr->GetLargestPossibleRegion();
+  const IndexValueType        largestPossibleStart = largestPossibleRegion.GetIndex(0);
+  const __m128d               largestPossibleSize = _mm_set1_pd( static_cast< double >( largestPossibleRegion.GetSize(0) ) );
+
+  const InputPixelType * inputBuffer = inputPtr->GetBufferPointer();
+  const PixelType        defaultValue = this->GetDefaultPixelValue();
+  const SizeValueType    lineLength = outputRegionForThread.GetSize(0);
+
+  // Per dimension constants: bounds of the buffer as continuous index and
+  // as index, and the offset of the next voxel. The start index is also
+  // used as a safe position for the pixels outside of the buffer.
+  __m128d startContinuousIndex[ImageDimension];
+  __m128d endContinuousIndex[ImageDimension];
+  __m128d startIndex[ImageDimension];
+  __m128d endIndex[ImageDimension];
+  __m128d stride[ImageDimension];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    startContinuousIndex[d] = _mm_set1_pd( linearInterpolator.GetStartContinuousIndex()[d] );
+    endContinuousIndex[d] = _mm_set1_pd( linearInterpolator.GetEndContinuousIndex()[d] );
+    startIndex[d] = _mm_set1_pd( static_cast< double >( linearInterpolator.GetStartIndex()[d] ) );
+    endIndex[d] = _mm_set1_pd( static_cast< double >( linearInterpolator.GetEndIndex()[d] ) );
+    stride[d] = _mm_set1_pd( static_cast< double >( inputPtr->GetOffsetTable()[d] ) );
+    }
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d one = _mm_set1_pd( 1.0 );
+
+  PointType outputPoint;
+  PointType inputPoint;
+
+  ImageScanlineIterator< TOutputImage > outIt(outputPtr, outputRegionForThread);
+  while ( !outIt.IsAtEnd() )
+    {
+    // Map the ends of the scanline of the largest possible region, as in
+    // the per-pixel path, so that both compute the same indices.
+    IndexType index = outIt.GetIndex();
+    const IndexValueType lineStart = index[0];
+    index[0] = largestPossibleStart;
+
+    ContinuousInputIndexType scanStart;
+    outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
+    inputPoint = transformPtr->TransformPoint(outputPoint);
+    inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, scanStart);
+
+    ContinuousInputIndexType scanEnd;
+    index[0] += largestPossibleRegion.GetSize(0);
+    outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
+    inputPoint = transformPtr->TransformPoint(outputPoint);
+    inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, scanEnd);
+
+    __m128d lineOrigin[ImageDimension];
+    __m128d lineDelta[ImageDimension];
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      lineOrigin[d] = _mm_set1_pd( scanStart[d] );
+      lineDelta[d] = _mm_set1_pd( scanEnd[d] - scanStart[d] );
+      }
+
+    PixelType *out = &outIt.Value();
+    const auto firstScanlineIndex = static_cast< double >( lineStart - largestPossibleStart );
+
+    // Two pixels per step. A pixel past the end of the line is computed
+    // but not stored.
+    for ( SizeValueType x = 0; x < lineLength; x += 2 )
+      {
+      const __m128d scanlineIndex = _mm_set_pd( firstScanlineIndex + static_cast< double >( x + 1 ),
+                                                firstScanlineIndex + static_cast< double >( x ) );
+      const __m128d alpha = _mm_div_pd( scanlineIndex, largestPossibleSize );
+
+      // Continuous index and mask of the pixels inside of the buffer. The
+      // comparisons are false for NaN's.
+      __m128d cindex[ImageDimension];
+      __m128d inside = _mm_cmpeq_pd( zero, zero );
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        cindex[d] = _mm_add_pd( lineOrigin[d], _mm_mul_pd( alpha, lineDelta[d] ) );
+        inside = _mm_and_pd( inside, _mm_and_pd( _mm_cmpge_pd( cindex[d], startContinuousIndex[d] ),
+                                                 _mm_cmplt_pd( cindex[d], endContinuousIndex[d] ) ) );
+        }
+
+      const int insideBits = _mm_movemask_pd( inside );
+      const unsigned int count = ( lineLength - x > 1 ) ? 2 : 1;
+      if ( insideBits == 0 )
+        {
+        for ( unsigned int i = 0; i < count; ++i )
+          {
+          out[x + i] = defaultValue;
+          }
+        continue;
+        }
+
+      // Base voxel, distance to it and whether the next voxel takes part,
+      // along each dimension. Pixels outside of the buffer are moved to its
+      // start so that the gather stays in the buffer. Inside of the buffer
+      // the index fits in 32 bits, so the floor is computed by truncation.
+      __m128d distance[ImageDimension];
+      __m128d hasNext[ImageDimension];
+      __m128d cornerOffsets[NumberOfCorners];
+      cornerOffsets[0] = zero;
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        const __m128d c = _mm_or_pd( _mm_and_pd( inside, cindex[d] ), _mm_andnot_pd( inside, startIndex[d] ) );
+        __m128d base = _mm_cvtepi32_pd( _mm_cvttpd_epi32( c ) );
+        base = _mm_sub_pd( base, _mm_and_pd( _mm_cmpgt_pd( base, c ), one ) );
+        base = _mm_max_pd( base, startIndex[d] );
+        distance[d] = _mm_sub_pd( c, base );
+        hasNext[d] = _mm_and_pd( _mm_cmpgt_pd( distance[d], zero ), _mm_cmplt_pd( base, endIndex[d] ) );
+        cornerOffsets[0] = _mm_add_pd( cornerOffsets[0], _mm_mul_pd( _mm_sub_pd( base, startIndex[d] ), stride[d] ) );
+        }
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        const unsigned int bit = 1u << d;
+        const __m128d      step = _mm_and_pd( hasNext[d], stride[d] );
+        for ( unsigned int corner = bit; corner < 2 * bit; ++corner )
+          {
+          cornerOffsets[corner] = _mm_add_pd( cornerOffsets[corner - bit], step );
+          }
+        }
+
+      // Gather the corners.
+      __m128d values[NumberOfCorners];
+      for ( unsigned int corner = 0; corner < NumberOfCorners; ++corner )
+        {
+        const __m128i offsets = _mm_cvttpd_epi32( cornerOffsets[corner] );
+        const int32_t offset0 = _mm_cvtsi128_si32( offsets );
+        const int32_t offset1 = _mm_cvtsi128_si32( _mm_srli_si128( offsets, 4 ) );
+        values[corner] = _mm_set_pd( static_cast< double >( inputBuffer[offset1] ),
+                                     static_cast< double >( inputBuffer[offset0] ) );
+        }
+
+      // Blend along x, then y, then z, as LinearInterpolateImageFunction
+      // does. Dimensions without a neighbor keep the lower value.
+      for ( unsigned int d = 0, corners = NumberOfCorners / 2; d < ImageDimension; ++d, corners /= 2 )
+        {
+        for ( unsigned int corner = 0; corner < corners; ++corner )
+          {
+          const __m128d lower = values[2 * corner];
+          const __m128d blended =
+            _mm_add_pd( lower, _mm_mul_pd( _mm_sub_pd( values[2 * corner + 1], lower ), distance[d] ) );
+          values[corner] = _mm_or_pd( _mm_and_pd( hasNext[d], blended ), _mm_andnot_pd( hasNext[d], lower ) );
+          }
+        }
+
+      double result[2];
+      _mm_storeu_pd( result, values[0] );
+      for ( unsigned int i = 0; i < count; ++i )
+        {
+        out[x + i] = ( insideBits & ( 1 << i ) ) ?
+          Self::CastPixelWithBoundsChecking( static_cast< ComponentType >( result[i] ) ) : defaultValue;
+        }
+      }
+    outIt.NextLine();
+    }
+  return true;
+#else
+  (void)outputRegionForThread;
+  return false;
+#endif
+}
+
 template< typename TInputImage,
           typename TOutputImage,
           typename TInterpolatorPrecisionType,
@@ -622,4 +826,6 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
 }
 } // end namespace itk
 
+#undef ITK_RESAMPLE_USE_SSE2
+
 #endif
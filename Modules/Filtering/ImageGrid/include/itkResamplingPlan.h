@@ -0,0 +1,248 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkResamplingPlan_h
+#define itkResamplingPlan_h
+
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkTransform.h"
+#include "itkMultiThreaderBase.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class ResamplingPlan
+ * \brief Precomputed sampling positions and weights for repeated resampling.
+ *
+ * ResampleImageFilter maps every output voxel through the transform and
+ * evaluates the interpolator from scratch on each update. When the same
+ * transform, output grid and input grid are applied to many images (the
+ * channels of a multi-modal acquisition, the frames of a time series, or
+ * the labels and intensities of one subject), that geometric work is
+ * identical for every image.
+ *
+ * ResamplingPlan performs it once. Initialize() maps each output voxel
+ * into the input grid and stores the offset of its base input voxel
+ * together with its interpolation weights. Resample() then only gathers
+ * and blends input values, and may be called for any number of inputs that
+ * share the input grid of the plan. For VectorImage inputs the weights of
+ * a voxel are loaded once and reused for all of its components.
+ *
+ * Two interpolation modes are supported, matching the results of
+ * LinearInterpolateImageFunction and NearestNeighborInterpolateImageFunction
+ * respectively. Output voxels that map outside of the input buffer are
+ * assigned the DefaultPixelValue. Values are clamped to the range of the
+ * output component type, as in ResampleImageFilter.
+ *
+ * The plan stores one offset, one neighbor mask and ImageDimension weights
+ * per output voxel. TPrecision is the type of the continuous indices,
+ * weights and interpolated values; it may be set to float to halve the
+ * memory used by the weights.
+ *
+ * The plan is recomputed automatically by Resample() when the plan or its
+ * transform has been modified since the last call to Initialize().
+ *
+ * \sa ResampleImageFilter
+ *
+ * \ingroup GeometricTransform
+ * \ingroup ITKImageGrid
+ */
+template< unsigned int VDimension, typename TPrecision = double >
+class ITK_TEMPLATE_EXPORT ResamplingPlan:
+  public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ResamplingPlan);
+
+  /** Standard class type aliases. */
+  using Self = ResamplingPlan;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ResamplingPlan, Object);
+
+  static constexpr unsigned int ImageDimension = VDimension;
+
+  using PrecisionType = TPrecision;
+
+  /** Geometry type alias. */
+  using ImageBaseType = ImageBase< VDimension >;
+  using SizeType = typename ImageBaseType::SizeType;
+  using IndexType = typename ImageBaseType::IndexType;
+  using IndexValueType = typename ImageBaseType::IndexValueType;
+  using OffsetValueType = typename ImageBaseType::OffsetValueType;
+  using RegionType = typename ImageBaseType::RegionType;
+  using SpacingType = typename ImageBaseType::SpacingType;
+  using PointType = typename ImageBaseType::PointType;
+  using DirectionType = typename ImageBaseType::DirectionType;
+
+  /** Transform type alias. The transform maps output points to input
+   * points. */
+  using TransformType = Transform< SpacePrecisionType, VDimension, VDimension >;
+  using TransformPointer = typename TransformType::ConstPointer;
+
+  /** Interpolation performed by the plan. */
+  enum class InterpolationMode : uint8_t { Linear, NearestNeighbor };
+
+  /** Get/Set the transform mapping output points to input points. */
+  itkSetConstObjectMacro(Transform, TransformType);
+  itkGetConstObjectMacro(Transform, TransformType);
+
+  /** Get/Set the interpolation mode. Defaults to Linear. */
+  itkSetEnumMacro(Interpolation, InterpolationMode);
+  itkGetEnumMacro(Interpolation, InterpolationMode);
+
+  /** Get/Set the value given to output voxels that map outside of the
+   * input buffer. The value is assigned to every component. */
+  itkSetMacro(DefaultPixelValue, double);
+  itkGetConstMacro(DefaultPixelValue, double);
+
+  /** Get/Set the output grid. */
+  itkSetMacro(Size, SizeType);
+  itkGetConstReferenceMacro(Size, SizeType);
+  itkSetMacro(OutputStartIndex, IndexType);
+  itkGetConstReferenceMacro(OutputStartIndex, IndexType);
+  itkSetMacro(OutputSpacing, SpacingType);
+  itkGetConstReferenceMacro(OutputSpacing, SpacingType);
+  itkSetMacro(OutputOrigin, PointType);
+  itkGetConstReferenceMacro(OutputOrigin, PointType);
+  itkSetMacro(OutputDirection, DirectionType);
+  itkGetConstReferenceMacro(OutputDirection, DirectionType);
+
+  /** Copy the output grid from the largest possible region, origin, spacing
+   * and direction of an image. */
+  void SetOutputParametersFromImage(const ImageBaseType *image);
+
+  /** Get/Set the input grid. The region is the buffered region of the
+   * images that will be passed to Resample(). */
+  itkSetMacro(InputRegion, RegionType);
+  itkGetConstReferenceMacro(InputRegion, RegionType);
+  itkSetMacro(InputSpacing, SpacingType);
+  itkGetConstReferenceMacro(InputSpacing, SpacingType);
+  itkSetMacro(InputOrigin, PointType);
+  itkGetConstReferenceMacro(InputOrigin, PointType);
+  itkSetMacro(InputDirection, DirectionType);
+  itkGetConstReferenceMacro(InputDirection, DirectionType);
+
+  /** Copy the input grid from the buffered region, origin, spacing and
+   * direction of an image. */
+  void SetInputParametersFromImage(const ImageBaseType *image);
+
+  /** Get the multithreader used to compute the plan and to resample. */
+  itkGetModifiableObjectMacro(MultiThreader, MultiThreaderBase);
+
+  /** Map every output voxel into the input grid and store its sampling
+   * offset and weights. Throws if no transform has been set. */
+  void Initialize();
+
+  /** Number of output voxels that map inside of the input buffer. Valid
+   * after Initialize(). */
+  itkGetConstMacro(NumberOfInsidePixels, SizeValueType);
+
+  /** Resample a scalar image. The input must have the input grid of the
+   * plan; the output is allocated on the output grid. */
+  template< typename TInputPixel, typename TOutputPixel >
+  void Resample(const Image< TInputPixel, VDimension > *input,
+                Image< TOutputPixel, VDimension > *output);
+
+  /** Resample a vector image. The weights of each voxel are shared by all
+   * of its components. The output has the number of components of the
+   * input. */
+  template< typename TInputPixel, typename TOutputPixel >
+  void Resample(const VectorImage< TInputPixel, VDimension > *input,
+                VectorImage< TOutputPixel, VDimension > *output);
+
+protected:
+  ResamplingPlan();
+  ~ResamplingPlan() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Recompute the plan if it is older than its parameters or transform. */
+  void UpdatePlan();
+
+  /** Throw if the geometry of input does not match the input grid. */
+  void VerifyInputGrid(const ImageBaseType *input) const;
+
+  /** Set the geometry of output to the output grid. */
+  void SetOutputGrid(ImageBaseType *output) const;
+
+  /** Blend the corner values of one component by linear interpolation
+   * along each dimension in turn. */
+  template< typename TInputPixel >
+  static PrecisionType Interpolate(const TInputPixel *input,
+                                   const OffsetValueType *cornerIndices,
+                                   const PrecisionType *weights);
+
+  /** Convert an interpolated value to the output component type. */
+  template< typename TOutputComponent >
+  static TOutputComponent CastWithBoundsChecking(PrecisionType value);
+
+  /** Resample numberOfComponents interleaved components. */
+  template< typename TInputPixel, typename TOutputPixel >
+  void ResampleBuffer(const TInputPixel *input, TOutputPixel *output,
+                      SizeValueType numberOfComponents);
+
+private:
+  static_assert( VDimension <= 8, "The neighbor mask holds at most 8 dimensions." );
+  static constexpr unsigned int NumberOfCorners = 1u << VDimension;
+
+  TransformPointer  m_Transform;
+  InterpolationMode m_Interpolation{ InterpolationMode::Linear };
+  double            m_DefaultPixelValue{ 0.0 };
+
+  SizeType      m_Size;
+  IndexType     m_OutputStartIndex;
+  SpacingType   m_OutputSpacing;
+  PointType     m_OutputOrigin;
+  DirectionType m_OutputDirection;
+
+  RegionType    m_InputRegion;
+  SpacingType   m_InputSpacing;
+  PointType     m_InputOrigin;
+  DirectionType m_InputDirection;
+
+  MultiThreaderBase::Pointer m_MultiThreader;
+
+  /** Per output voxel: offset of the base input voxel in the input buffer
+   * (-1 outside of the buffer), mask of the dimensions in which the next
+   * voxel takes part in the interpolation, and the distance to the base
+   * voxel along each dimension. */
+  std::vector< OffsetValueType > m_Offsets;
+  std::vector< uint8_t >         m_NeighborMasks;
+  std::vector< PrecisionType >   m_Weights;
+
+  /** Offset in the input buffer of each corner, indexed by corner mask. */
+  OffsetValueType m_CornerOffsets[NumberOfCorners];
+
+  SizeValueType m_NumberOfInsidePixels{ 0 };
+  TimeStamp     m_PlanTime;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkResamplingPlan.hxx"
+#endif
+
+#endif
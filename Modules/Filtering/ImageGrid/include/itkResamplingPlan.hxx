@@ -0,0 +1,415 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkResamplingPlan_hxx
+#define itkResamplingPlan_hxx
+
+#include "itkResamplingPlan.h"
+#include "itkMath.h"
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace itk
+{
+template< unsigned int VDimension, typename TPrecision >
+ResamplingPlan< VDimension, TPrecision >
+::ResamplingPlan() :
+  m_MultiThreader( MultiThreaderBase::New() )
+{
+  m_Size.Fill(0);
+  m_OutputStartIndex.Fill(0);
+  m_OutputSpacing.Fill(1.0);
+  m_OutputOrigin.Fill(0.0);
+  m_OutputDirection.SetIdentity();
+
+  m_InputSpacing.Fill(1.0);
+  m_InputOrigin.Fill(0.0);
+  m_InputDirection.SetIdentity();
+
+  std::fill_n(m_CornerOffsets, NumberOfCorners, 0);
+}
+
+template< unsigned int VDimension, typename TPrecision >
+void
+ResamplingPlan< VDimension, TPrecision >
+::SetOutputParametersFromImage(const ImageBaseType *image)
+{
+  itkAssertOrThrowMacro( image != nullptr, "Output reference image is null" );
+  this->SetSize( image->GetLargestPossibleRegion().GetSize() );
+  this->SetOutputStartIndex( image->GetLargestPossibleRegion().GetIndex() );
+  this->SetOutputSpacing( image->GetSpacing() );
+  this->SetOutputOrigin( image->GetOrigin() );
+  this->SetOutputDirection( image->GetDirection() );
+}
+
+template< unsigned int VDimension, typename TPrecision >
+void
+ResamplingPlan< VDimension, TPrecision >
+::SetInputParametersFromImage(const ImageBaseType *image)
+{
+  itkAssertOrThrowMacro( image != nullptr, "Input reference image is null" );
+  this->SetInputRegion( image->GetBufferedRegion() );
+  this->SetInputSpacing( image->GetSpacing() );
+  this->SetInputOrigin( image->GetOrigin() );
+  this->SetInputDirection( image->GetDirection() );
+}
+
+template< unsigned int VDimension, typename TPrecision >
+void
+ResamplingPlan< VDimension, TPrecision >
+::SetOutputGrid(ImageBaseType *output) const
+{
+  const RegionType region( m_OutputStartIndex, m_Size );
+  output->SetRegions( region );
+  output->SetSpacing( m_OutputSpacing );
+  output->SetOrigin( m_OutputOrigin );
+  output->SetDirection( m_OutputDirection );
+}
+
+template< unsigned int VDimension, typename TPrecision >
+void
+ResamplingPlan< VDimension, TPrecision >
+::VerifyInputGrid(const ImageBaseType *input) const
+{
+  if ( input == nullptr )
+    {
+    itkExceptionMacro(<< "Input image is null");
+    }
+  if ( input->GetBufferedRegion() != m_InputRegion
+       || input->GetSpacing() != m_InputSpacing
+       || input->GetOrigin() != m_InputOrigin
+       || input->GetDirection() != m_InputDirection )
+    {
+    itkExceptionMacro(<< "The buffered region, spacing, origin or direction of the input "
+                      << "does not match the input grid of the plan");
+    }
+}
+
+template< unsigned int VDimension, typename TPrecision >
+void
+ResamplingPlan< VDimension, TPrecision >
+::Initialize()
+{
+  if ( m_Transform.IsNull() )
+    {
+    itkExceptionMacro(<< "Transform not set");
+    }
+
+  // Use image objects for the index <-> point conversions so that the plan
+  // maps voxels exactly as ResampleImageFilter does.
+  typename ImageBaseType::Pointer outputGrid = ImageBaseType::New();
+  this->SetOutputGrid( outputGrid );
+
+  typename ImageBaseType::Pointer inputGrid = ImageBaseType::New();
+  inputGrid->SetRegions( m_InputRegion );
+  inputGrid->SetSpacing( m_InputSpacing );
+  inputGrid->SetOrigin( m_InputOrigin );
+  inputGrid->SetDirection( m_InputDirection );
+
+  const bool linear = ( m_Interpolation == InterpolationMode::Linear );
+  const SizeValueType numberOfPixels = outputGrid->GetLargestPossibleRegion().GetNumberOfPixels();
+
+  m_Offsets.assign( numberOfPixels, -1 );
+  m_NeighborMasks.assign( linear ? numberOfPixels : 0, 0 );
+  m_Weights.assign( linear ? numberOfPixels * VDimension : 0, 0 );
+  m_NumberOfInsidePixels = 0;
+
+  const OffsetValueType *offsetTable = inputGrid->GetOffsetTable();
+  for ( unsigned int corner = 0; corner < NumberOfCorners; ++corner )
+    {
+    m_CornerOffsets[corner] = 0;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      if ( corner & ( 1u << d ) )
+        {
+        m_CornerOffsets[corner] += offsetTable[d];
+        }
+      }
+    }
+
+  if ( numberOfPixels > 0 )
+    {
+    const IndexType inputStart = m_InputRegion.GetIndex();
+    IndexType       inputEnd;
+    PrecisionType   startContinuousIndex[VDimension];
+    PrecisionType   endContinuousIndex[VDimension];
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      inputEnd[d] = inputStart[d] + static_cast< OffsetValueType >( m_InputRegion.GetSize(d) ) - 1;
+      startContinuousIndex[d] = static_cast< PrecisionType >( inputStart[d] - 0.5 );
+      endContinuousIndex[d] = static_cast< PrecisionType >( inputEnd[d] + 0.5 );
+      }
+
+    std::atomic< SizeValueType > numberOfInsidePixels( 0 );
+    const SizeValueType          rowLength = m_Size[0];
+
+    // One work unit per output row.
+    m_MultiThreader->ParallelizeArray( 0, numberOfPixels / rowLength,
+      [&]( SizeValueType row )
+      {
+      IndexType     index = m_OutputStartIndex;
+      SizeValueType remainder = row;
+      for ( unsigned int d = 1; d < VDimension; ++d )
+        {
+        index[d] += static_cast< OffsetValueType >( remainder % m_Size[d] );
+        remainder /= m_Size[d];
+        }
+
+      SizeValueType inside = 0;
+      SizeValueType pixel = row * rowLength;
+      for ( SizeValueType x = 0; x < rowLength; ++x, ++pixel )
+        {
+        index[0] = m_OutputStartIndex[0] + static_cast< OffsetValueType >( x );
+
+        PointType outputPoint;
+        outputGrid->TransformIndexToPhysicalPoint( index, outputPoint );
+        const PointType inputPoint = m_Transform->TransformPoint( outputPoint );
+
+        ContinuousIndex< PrecisionType, VDimension > cindex;
+        inputGrid->TransformPhysicalPointToContinuousIndex( inputPoint, cindex );
+
+        bool isInside = true;
+        for ( unsigned int d = 0; d < VDimension; ++d )
+          {
+          // Test for negative of a positive so we can catch NaN's.
+          if ( !( cindex[d] >= startContinuousIndex[d] && cindex[d] < endContinuousIndex[d] ) )
+            {
+            isInside = false;
+            break;
+            }
+          }
+        if ( !isInside )
+          {
+          continue;
+          }
+        ++inside;
+
+        IndexType inputIndex;
+        if ( linear )
+          {
+          uint8_t         mask = 0;
+          PrecisionType * weights = &m_Weights[pixel * VDimension];
+          for ( unsigned int d = 0; d < VDimension; ++d )
+            {
+            inputIndex[d] = std::max( Math::Floor< IndexValueType >( cindex[d] ), inputStart[d] );
+            const PrecisionType distance = cindex[d] - static_cast< PrecisionType >( inputIndex[d] );
+            if ( distance > 0 && inputIndex[d] < inputEnd[d] )
+              {
+              mask |= static_cast< uint8_t >( 1u << d );
+              weights[d] = distance;
+              }
+            }
+          m_NeighborMasks[pixel] = mask;
+          }
+        else
+          {
+          inputIndex.CopyWithRound( cindex );
+          }
+        m_Offsets[pixel] = inputGrid->ComputeOffset( inputIndex );
+        }
+      numberOfInsidePixels += inside;
+      },
+      nullptr );
+
+    m_NumberOfInsidePixels = numberOfInsidePixels;
+    }
+
+  m_PlanTime.Modified();
+}
+
+template< unsigned int VDimension, typename TPrecision >
+void
+ResamplingPlan< VDimension, TPrecision >
+::UpdatePlan()
+{
+  if ( m_PlanTime < this->GetMTime()
+       || ( m_Transform.IsNotNull() && m_PlanTime < m_Transform->GetMTime() ) )
+    {
+    this->Initialize();
+    }
+}
+
+template< unsigned int VDimension, typename TPrecision >
+template< typename TInputPixel >
+auto
+ResamplingPlan< VDimension, TPrecision >
+::Interpolate(const TInputPixel *input,
+              const OffsetValueType *cornerIndices,
+              const PrecisionType *weights) -> PrecisionType
+{
+  PrecisionType values[NumberOfCorners];
+  for ( unsigned int corner = 0; corner < NumberOfCorners; ++corner )
+    {
+    values[corner] = static_cast< PrecisionType >( input[cornerIndices[corner]] );
+    }
+  // Collapse the corners pairwise, first along x, then y, and so on, as
+  // LinearInterpolateImageFunction does. Corners that do not take part in
+  // the interpolation duplicate the base voxel and have a zero weight.
+  for ( unsigned int d = 0, count = NumberOfCorners / 2; d < VDimension; ++d, count /= 2 )
+    {
+    for ( unsigned int corner = 0; corner < count; ++corner )
+      {
+      const PrecisionType lower = values[2 * corner];
+      values[corner] = lower + ( values[2 * corner + 1] - lower ) * weights[d];
+      }
+    }
+  return values[0];
+}
+
+template< unsigned int VDimension, typename TPrecision >
+template< typename TOutputComponent >
+TOutputComponent
+ResamplingPlan< VDimension, TPrecision >
+::CastWithBoundsChecking(PrecisionType value)
+{
+  const auto minComponent = static_cast< PrecisionType >( NumericTraits< TOutputComponent >::NonpositiveMin() );
+  const auto maxComponent = static_cast< PrecisionType >( NumericTraits< TOutputComponent >::max() );
+  if ( value < minComponent )
+    {
+    return NumericTraits< TOutputComponent >::NonpositiveMin();
+    }
+  if ( value > maxComponent )
+    {
+    return NumericTraits< TOutputComponent >::max();
+    }
+  return static_cast< TOutputComponent >( value );
+}
+
+template< unsigned int VDimension, typename TPrecision >
+template< typename TInputPixel, typename TOutputPixel >
+void
+ResamplingPlan< VDimension, TPrecision >
+::ResampleBuffer(const TInputPixel *input, TOutputPixel *output,
+                 SizeValueType numberOfComponents)
+{
+  const SizeValueType numberOfPixels = m_Offsets.size();
+  if ( numberOfPixels == 0 )
+    {
+    return;
+    }
+
+  const TOutputPixel defaultValue =
+    CastWithBoundsChecking< TOutputPixel >( static_cast< PrecisionType >( m_DefaultPixelValue ) );
+  const bool          linear = ( m_Interpolation == InterpolationMode::Linear );
+  const SizeValueType rowLength = m_Size[0];
+  const auto          stride = static_cast< OffsetValueType >( numberOfComponents );
+
+  m_MultiThreader->ParallelizeArray( 0, numberOfPixels / rowLength,
+    [&]( SizeValueType row )
+    {
+    const SizeValueType begin = row * rowLength;
+    const SizeValueType end = begin + rowLength;
+    TOutputPixel *      out = output + begin * numberOfComponents;
+    for ( SizeValueType pixel = begin; pixel < end; ++pixel, out += numberOfComponents )
+      {
+      const OffsetValueType offset = m_Offsets[pixel];
+      if ( offset < 0 )
+        {
+        std::fill_n( out, numberOfComponents, defaultValue );
+        continue;
+        }
+      if ( !linear )
+        {
+        const TInputPixel *in = input + offset * stride;
+        for ( SizeValueType c = 0; c < numberOfComponents; ++c )
+          {
+          out[c] = CastWithBoundsChecking< TOutputPixel >( static_cast< PrecisionType >( in[c] ) );
+          }
+        continue;
+        }
+
+      // The corner indices and weights are shared by all components.
+      const unsigned int mask = m_NeighborMasks[pixel];
+      OffsetValueType    cornerIndices[NumberOfCorners];
+      for ( unsigned int corner = 0; corner < NumberOfCorners; ++corner )
+        {
+        cornerIndices[corner] = ( offset + m_CornerOffsets[corner & mask] ) * stride;
+        }
+      const PrecisionType *weights = &m_Weights[pixel * VDimension];
+      for ( SizeValueType c = 0; c < numberOfComponents; ++c )
+        {
+        out[c] = CastWithBoundsChecking< TOutputPixel >( Interpolate( input + c, cornerIndices, weights ) );
+        }
+      }
+    },
+    nullptr );
+}
+
+template< unsigned int VDimension, typename TPrecision >
+template< typename TInputPixel, typename TOutputPixel >
+void
+ResamplingPlan< VDimension, TPrecision >
+::Resample(const Image< TInputPixel, VDimension > *input,
+           Image< TOutputPixel, VDimension > *output)
+{
+  this->UpdatePlan();
+  this->VerifyInputGrid( input );
+  itkAssertOrThrowMacro( output != nullptr, "Output image is null" );
+
+  this->SetOutputGrid( output );
+  output->Allocate();
+
+  this->ResampleBuffer( input->GetBufferPointer(), output->GetBufferPointer(), 1 );
+}
+
+template< unsigned int VDimension, typename TPrecision >
+template< typename TInputPixel, typename TOutputPixel >
+void
+ResamplingPlan< VDimension, TPrecision >
+::Resample(const VectorImage< TInputPixel, VDimension > *input,
+           VectorImage< TOutputPixel, VDimension > *output)
+{
+  this->UpdatePlan();
+  this->VerifyInputGrid( input );
+  itkAssertOrThrowMacro( output != nullptr, "Output image is null" );
+
+  const unsigned int numberOfComponents = input->GetNumberOfComponentsPerPixel();
+  this->SetOutputGrid( output );
+  output->SetNumberOfComponentsPerPixel( numberOfComponents );
+  output->Allocate();
+
+  this->ResampleBuffer( input->GetBufferPointer(), output->GetBufferPointer(), numberOfComponents );
+}
+
+template< unsigned int VDimension, typename TPrecision >
+void
+ResamplingPlan< VDimension, TPrecision >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Transform: " << m_Transform.GetPointer() << std::endl;
+  os << indent << "Interpolation: "
+     << ( m_Interpolation == InterpolationMode::Linear ? "Linear" : "NearestNeighbor" ) << std::endl;
+  os << indent << "DefaultPixelValue: " << m_DefaultPixelValue << std::endl;
+  os << indent << "Size: " << m_Size << std::endl;
+  os << indent << "OutputStartIndex: " << m_OutputStartIndex << std::endl;
+  os << indent << "OutputSpacing: " << m_OutputSpacing << std::endl;
+  os << indent << "OutputOrigin: " << m_OutputOrigin << std::endl;
+  os << indent << "OutputDirection: " << m_OutputDirection << std::endl;
+  os << indent << "InputRegion: " << m_InputRegion << std::endl;
+  os << indent << "InputSpacing: " << m_InputSpacing << std::endl;
+  os << indent << "InputOrigin: " << m_InputOrigin << std::endl;
+  os << indent << "InputDirection: " << m_InputDirection << std::endl;
+  os << indent << "NumberOfInsidePixels: " << m_NumberOfInsidePixels << std::endl;
+  itkPrintSelfObjectMacro( MultiThreader );
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,193 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAffineTransform.h"
+#include "itkResampleImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+// Compare the scanline kernel used by ResampleImageFilter for
+// linear transforms with the per-pixel evaluation of the interpolator.
+
+namespace
+{
+/** LinearInterpolateImageFunction under another type, which makes
+ * ResampleImageFilter evaluate it pixel by pixel. */
+template< typename TInputImage >
+class PerPixelLinearInterpolateImageFunction:
+  public itk::LinearInterpolateImageFunction< TInputImage, double >
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(PerPixelLinearInterpolateImageFunction);
+
+  using Self = PerPixelLinearInterpolateImageFunction;
+  using Superclass = itk::LinearInterpolateImageFunction< TInputImage, double >;
+  using Pointer = itk::SmartPointer< Self >;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PerPixelLinearInterpolateImageFunction, LinearInterpolateImageFunction);
+
+protected:
+  PerPixelLinearInterpolateImageFunction() = default;
+  ~PerPixelLinearInterpolateImageFunction() override = default;
+};
+
+template< typename TImage >
+typename TImage::Pointer
+MakeInputImage()
+{
+  constexpr unsigned int Dimension = TImage::ImageDimension;
+
+  typename TImage::IndexType start;
+  typename TImage::SizeType  size;
+  typename TImage::SpacingType spacing;
+  typename TImage::PointType origin;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    start[d] = static_cast< itk::IndexValueType >( d ) - 2;
+    size[d] = 11 + 4 * d;
+    spacing[d] = 0.7 + 0.2 * d;
+    origin[d] = -3.0 + d;
+    }
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( typename TImage::RegionType( start, size ) );
+  image->SetSpacing( spacing );
+  image->SetOrigin( origin );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    double value = 0.0;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      value += ( 5.0 + 3.0 * d ) * it.GetIndex()[d] + ( ( it.GetIndex()[d] * ( 7 + d ) ) % 5 ) * 9.0;
+      }
+    it.Set( static_cast< typename TImage::PixelType >( value ) );
+    }
+  return image;
+}
+
+template< typename TInputImage, typename TOutputImage >
+int
+CompareScanlineKernel( unsigned int numberOfWorkUnits )
+{
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+
+  using TransformType = itk::AffineTransform< double, Dimension >;
+  using FilterType = itk::ResampleImageFilter< TInputImage, TOutputImage >;
+
+  const typename TInputImage::Pointer input = MakeInputImage< TInputImage >();
+
+  // Rotate, shear and shift so that part of the output maps outside of the
+  // input.
+  typename TransformType::Pointer transform = TransformType::New();
+  typename TransformType::MatrixType matrix;
+  typename TransformType::OutputVectorType translation;
+  for ( unsigned int i = 0; i < Dimension; ++i )
+    {
+    for ( unsigned int j = 0; j < Dimension; ++j )
+      {
+      matrix[i][j] = ( i == j ) ? 0.95 : 0.13 * ( static_cast< double >( i ) - static_cast< double >( j ) );
+      }
+    translation[i] = 0.9 - 0.45 * i;
+    }
+  transform->SetMatrix( matrix );
+  transform->SetTranslation( translation );
+
+  typename FilterType::SizeType  outputSize;
+  typename FilterType::IndexType outputStart;
+  typename FilterType::SpacingType outputSpacing;
+  typename FilterType::OriginPointType outputOrigin;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    // Line lengths that are not a multiple of the block size.
+    outputSize[d] = 19 + 2 * d;
+    outputStart[d] = 1;
+    outputSpacing[d] = 0.55;
+    outputOrigin[d] = -4.0;
+    }
+
+  typename FilterType::Pointer kernelFilter = FilterType::New();
+  kernelFilter->SetInput( input );
+  kernelFilter->SetTransform( transform );
+  kernelFilter->SetSize( outputSize );
+  kernelFilter->SetOutputStartIndex( outputStart );
+  kernelFilter->SetOutputSpacing( outputSpacing );
+  kernelFilter->SetOutputOrigin( outputOrigin );
+  kernelFilter->SetDefaultPixelValue( 7 );
+  kernelFilter->SetNumberOfWorkUnits( numberOfWorkUnits );
+  TRY_EXPECT_NO_EXCEPTION( kernelFilter->Update() );
+
+  typename FilterType::Pointer perPixelFilter = FilterType::New();
+  perPixelFilter->SetInput( input );
+  perPixelFilter->SetTransform( transform );
+  perPixelFilter->SetInterpolator( PerPixelLinearInterpolateImageFunction< TInputImage >::New() );
+  perPixelFilter->SetSize( outputSize );
+  perPixelFilter->SetOutputStartIndex( outputStart );
+  perPixelFilter->SetOutputSpacing( outputSpacing );
+  perPixelFilter->SetOutputOrigin( outputOrigin );
+  perPixelFilter->SetDefaultPixelValue( 7 );
+  perPixelFilter->SetNumberOfWorkUnits( 1 );
+  TRY_EXPECT_NO_EXCEPTION( perPixelFilter->Update() );
+
+  const TOutputImage *kernelOutput = kernelFilter->GetOutput();
+  const TOutputImage *perPixelOutput = perPixelFilter->GetOutput();
+
+  itk::SizeValueType numberOfDefaultPixels = 0;
+  itk::ImageRegionConstIteratorWithIndex< TOutputImage > it( perPixelOutput, perPixelOutput->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    if ( kernelOutput->GetPixel( it.GetIndex() ) != it.Get() )
+      {
+      std::cerr << "Mismatch at " << it.GetIndex() << " in dimension " << Dimension
+                << ": expected " << static_cast< double >( it.Get() ) << ", got "
+                << static_cast< double >( kernelOutput->GetPixel( it.GetIndex() ) ) << std::endl;
+      return EXIT_FAILURE;
+      }
+    numberOfDefaultPixels += ( it.Get() == 7 );
+    }
+
+  // Both inside and outside pixels must have been exercised.
+  TEST_EXPECT_TRUE( numberOfDefaultPixels > 0 );
+  TEST_EXPECT_TRUE( numberOfDefaultPixels < perPixelOutput->GetBufferedRegion().GetNumberOfPixels() );
+  return EXIT_SUCCESS;
+}
+}
+
+int itkResampleImageLinearScanlineTest( int, char *[] )
+{
+  int status = EXIT_SUCCESS;
+  for ( unsigned int numberOfWorkUnits = 1; numberOfWorkUnits <= 3; numberOfWorkUnits += 2 )
+    {
+    status |= CompareScanlineKernel< itk::Image< float, 1 >, itk::Image< float, 1 > >( numberOfWorkUnits );
+    status |= CompareScanlineKernel< itk::Image< float, 2 >, itk::Image< float, 2 > >( numberOfWorkUnits );
+    status |= CompareScanlineKernel< itk::Image< float, 3 >, itk::Image< float, 3 > >( numberOfWorkUnits );
+    status |= CompareScanlineKernel< itk::Image< short, 2 >, itk::Image< short, 2 > >( numberOfWorkUnits );
+    status |= CompareScanlineKernel< itk::Image< short, 3 >, itk::Image< short, 3 > >( numberOfWorkUnits );
+    status |= CompareScanlineKernel< itk::Image< short, 3 >, itk::Image< unsigned char, 3 > >( numberOfWorkUnits );
+    status |= CompareScanlineKernel< itk::Image< float, 3 >, itk::Image< double, 3 > >( numberOfWorkUnits );
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test finished." << std::endl;
+    }
+  return status;
+}
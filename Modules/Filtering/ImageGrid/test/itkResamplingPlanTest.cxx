@@ -0,0 +1,254 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAffineTransform.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkResampleImageFilter.h"
+#include "itkResamplingPlan.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+
+using PlanType = itk::ResamplingPlan< Dimension >;
+using TransformType = itk::AffineTransform< double, Dimension >;
+
+template< typename TImage >
+typename TImage::Pointer
+MakeInputImage( unsigned int numberOfComponents )
+{
+  typename TImage::Pointer image = TImage::New();
+  typename TImage::IndexType start = {{ 2, -3, 1 }};
+  typename TImage::SizeType  size = {{ 17, 13, 9 }};
+  image->SetRegions( typename TImage::RegionType( start, size ) );
+  typename TImage::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.1;
+  spacing[2] = 1.5;
+  image->SetSpacing( spacing );
+  typename TImage::PointType origin;
+  origin[0] = -4.0;
+  origin[1] = 2.5;
+  origin[2] = 0.25;
+  image->SetOrigin( origin );
+  image->SetNumberOfComponentsPerPixel( numberOfComponents );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    typename TImage::PixelType pixel = it.Get();
+    for ( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      const double value = 7.0 * index[0] - 3.0 * index[1] + 11.0 * index[2] + 5.0 * c
+                           + ( ( index[0] * 31 + index[1] * 17 + index[2] * 7 + c ) % 13 );
+      itk::DefaultConvertPixelTraits< typename TImage::PixelType >::SetNthComponent( c, pixel, value );
+      }
+    it.Set( pixel );
+    }
+  return image;
+}
+
+TransformType::Pointer
+MakeTransform()
+{
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::OutputVectorType axis;
+  axis[0] = 0.3;
+  axis[1] = -0.2;
+  axis[2] = 0.9;
+  transform->Rotate3D( axis, 0.35 );
+  transform->Scale( 0.9 );
+  TransformType::OutputVectorType translation;
+  translation[0] = 1.3;
+  translation[1] = -0.7;
+  translation[2] = 0.4;
+  transform->Translate( translation );
+  return transform;
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename TOutputImage::Pointer
+ResampleWithFilter( const TInputImage *input, const TransformType *transform,
+                    const itk::ImageBase< Dimension > *reference, bool linear, double defaultValue )
+{
+  using FilterType = itk::ResampleImageFilter< TInputImage, TOutputImage >;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( input );
+  filter->SetTransform( transform );
+  filter->SetOutputParametersFromImage( reference );
+  typename TOutputImage::PixelType defaultPixel;
+  itk::NumericTraits< typename TOutputImage::PixelType >::SetLength( defaultPixel,
+    input->GetNumberOfComponentsPerPixel() );
+  defaultPixel = itk::NumericTraits< typename TOutputImage::PixelType >::ZeroValue( defaultPixel );
+  for ( unsigned int c = 0; c < input->GetNumberOfComponentsPerPixel(); ++c )
+    {
+    itk::DefaultConvertPixelTraits< typename TOutputImage::PixelType >::SetNthComponent( c, defaultPixel, defaultValue );
+    }
+  filter->SetDefaultPixelValue( defaultPixel );
+  if ( !linear )
+    {
+    filter->SetInterpolator( itk::NearestNeighborInterpolateImageFunction< TInputImage, double >::New() );
+    }
+  filter->Update();
+  return filter->GetOutput();
+}
+
+template< typename TImage >
+int
+CompareImages( const TImage *expected, const TImage *actual, double tolerance )
+{
+  TEST_EXPECT_EQUAL( expected->GetLargestPossibleRegion(), actual->GetBufferedRegion() );
+  TEST_EXPECT_EQUAL( expected->GetSpacing(), actual->GetSpacing() );
+  TEST_EXPECT_EQUAL( expected->GetOrigin(), actual->GetOrigin() );
+
+  const unsigned int numberOfComponents = expected->GetNumberOfComponentsPerPixel();
+  TEST_EXPECT_EQUAL( numberOfComponents, actual->GetNumberOfComponentsPerPixel() );
+
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( expected, expected->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::PixelType expectedPixel = it.Get();
+    const typename TImage::PixelType actualPixel = actual->GetPixel( it.GetIndex() );
+    for ( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      const double e = itk::DefaultConvertPixelTraits< typename TImage::PixelType >::GetNthComponent( c, expectedPixel );
+      const double a = itk::DefaultConvertPixelTraits< typename TImage::PixelType >::GetNthComponent( c, actualPixel );
+      if ( std::abs( e - a ) > tolerance )
+        {
+        std::cerr << "Mismatch at " << it.GetIndex() << " component " << c
+                  << ": expected " << e << ", got " << a << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkResamplingPlanTest( int, char *[] )
+{
+  using ScalarImageType = itk::Image< float, Dimension >;
+  using CharImageType = itk::Image< unsigned char, Dimension >;
+  using VectorImageType = itk::VectorImage< float, Dimension >;
+
+  const ScalarImageType::Pointer scalarInput = MakeInputImage< ScalarImageType >( 1 );
+  const VectorImageType::Pointer vectorInput = MakeInputImage< VectorImageType >( 3 );
+  const TransformType::Pointer   transform = MakeTransform();
+
+  // The output grid overlaps the input only partially.
+  ScalarImageType::Pointer reference = ScalarImageType::New();
+  ScalarImageType::IndexType outputStart = {{ -1, 0, 2 }};
+  ScalarImageType::SizeType  outputSize = {{ 21, 15, 7 }};
+  reference->SetRegions( ScalarImageType::RegionType( outputStart, outputSize ) );
+  ScalarImageType::SpacingType outputSpacing;
+  outputSpacing.Fill( 0.9 );
+  reference->SetSpacing( outputSpacing );
+  ScalarImageType::PointType outputOrigin;
+  outputOrigin.Fill( -1.5 );
+  reference->SetOrigin( outputOrigin );
+
+  PlanType::Pointer plan = PlanType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( plan, ResamplingPlan, Object );
+
+  // Without a transform the plan cannot be computed.
+  TRY_EXPECT_EXCEPTION( plan->Initialize() );
+
+  plan->SetTransform( transform );
+  TEST_SET_GET_VALUE( transform.GetPointer(), plan->GetTransform() );
+  plan->SetOutputParametersFromImage( reference );
+  TEST_SET_GET_VALUE( outputSize, plan->GetSize() );
+  TEST_SET_GET_VALUE( outputStart, plan->GetOutputStartIndex() );
+  plan->SetInputParametersFromImage( scalarInput );
+  TEST_SET_GET_VALUE( scalarInput->GetBufferedRegion(), plan->GetInputRegion() );
+  plan->SetDefaultPixelValue( -5.0 );
+  TEST_SET_GET_VALUE( -5.0, plan->GetDefaultPixelValue() );
+
+  const PlanType::InterpolationMode modes[] = { PlanType::InterpolationMode::Linear,
+                                                PlanType::InterpolationMode::NearestNeighbor };
+  for ( const auto mode : modes )
+    {
+    const bool linear = ( mode == PlanType::InterpolationMode::Linear );
+    plan->SetInterpolation( mode );
+    TRY_EXPECT_NO_EXCEPTION( plan->Initialize() );
+    std::cout << ( linear ? "Linear" : "NearestNeighbor" ) << ": " << plan->GetNumberOfInsidePixels()
+              << " of " << reference->GetLargestPossibleRegion().GetNumberOfPixels()
+              << " output pixels inside" << std::endl;
+    TEST_EXPECT_TRUE( plan->GetNumberOfInsidePixels() > 0 );
+    TEST_EXPECT_TRUE( plan->GetNumberOfInsidePixels() < reference->GetLargestPossibleRegion().GetNumberOfPixels() );
+
+    // Scalar image.
+    ScalarImageType::Pointer scalarOutput = ScalarImageType::New();
+    plan->Resample( scalarInput.GetPointer(), scalarOutput.GetPointer() );
+    const ScalarImageType::Pointer scalarExpected =
+      ResampleWithFilter< ScalarImageType, ScalarImageType >( scalarInput, transform, reference, linear, -5.0 );
+    if ( CompareImages< ScalarImageType >( scalarExpected, scalarOutput, 1e-3 ) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+
+    // The same plan applied to another input, with clamping to the range
+    // of the output type.
+    CharImageType::Pointer charOutput = CharImageType::New();
+    plan->Resample( scalarInput.GetPointer(), charOutput.GetPointer() );
+    const CharImageType::Pointer charExpected =
+      ResampleWithFilter< ScalarImageType, CharImageType >( scalarInput, transform, reference, linear, 0.0 );
+    if ( CompareImages< CharImageType >( charExpected, charOutput, 1.0 ) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+
+    // Vector image: the weights are shared by the components.
+    VectorImageType::Pointer vectorOutput = VectorImageType::New();
+    plan->Resample( vectorInput.GetPointer(), vectorOutput.GetPointer() );
+    const VectorImageType::Pointer vectorExpected =
+      ResampleWithFilter< VectorImageType, VectorImageType >( vectorInput, transform, reference, linear, -5.0 );
+    if ( CompareImages< VectorImageType >( vectorExpected, vectorOutput, 1e-3 ) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Modifying the transform recomputes the plan on the next Resample().
+  plan->SetInterpolation( PlanType::InterpolationMode::Linear );
+  TransformType::OutputVectorType shift;
+  shift.Fill( 0.6 );
+  transform->Translate( shift );
+  ScalarImageType::Pointer shiftedOutput = ScalarImageType::New();
+  plan->Resample( scalarInput.GetPointer(), shiftedOutput.GetPointer() );
+  const ScalarImageType::Pointer shiftedExpected =
+    ResampleWithFilter< ScalarImageType, ScalarImageType >( scalarInput, transform, reference, true, -5.0 );
+  if ( CompareImages< ScalarImageType >( shiftedExpected, shiftedOutput, 1e-3 ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // An input on a different grid is rejected.
+  ScalarImageType::Pointer otherInput = MakeInputImage< ScalarImageType >( 1 );
+  ScalarImageType::SpacingType otherSpacing;
+  otherSpacing.Fill( 2.0 );
+  otherInput->SetSpacing( otherSpacing );
+  TRY_EXPECT_EXCEPTION( plan->Resample( otherInput.GetPointer(), shiftedOutput.GetPointer() ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
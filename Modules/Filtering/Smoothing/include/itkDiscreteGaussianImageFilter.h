@@ -20,6 +20,11 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
+#include "itkNativeFFTCommon.h"
+#include "itkRecursiveGaussianImageFilter.h"
+
+#include <map>
+#include <memory>
 
 namespace itk
 {
@@ -40,8 +45,41 @@ namespace itk
  * SetUseImageSpacing is on (true, default). The variance can be set
  * independently in each dimension.
  *
- * When the Gaussian kernel is small, this filter tends to run faster than
- * itk::RecursiveGaussianImageFilter.
+ * Each dimension is smoothed with one of the following algorithms:
+ *
+ * - DIRECT convolves the lines with the GaussianOperator, truncated to
+ *   MaximumKernelWidth.
+ * - RECURSIVE filters the lines with the infinite impulse response
+ *   approximation of the Gaussian of RecursiveGaussianImageFilter. Its
+ *   cost does not depend on the variance.
+ * - FFT multiplies the spectrum of the lines by the exact transfer
+ *   function of the discrete Gaussian, exp( variance * ( cos(w) - 1 ) ).
+ *   Its cost grows with the logarithm of the variance.
+ *
+ * By default (AUTOMATIC), the kernel is convolved directly when the
+ * number of coefficients needed to reach MaximumError does not exceed
+ * MaximumKernelWidth, which gives the same result as the GaussianOperator.
+ * Larger kernels, and the kernels of variances for which the
+ * GaussianOperator is not accurate, are not truncated anymore: the
+ * recursive filter is used when the L1 distance between its impulse
+ * response and the discrete Gaussian is lower than MaximumError, the FFT
+ * otherwise.
+ *
+ * The directly convolved dimensions are fused: the output is processed
+ * in tiles small enough to stay in the cache, and each tile of the input
+ * is loaded once and smoothed along all these dimensions before being
+ * written to the output. The recursive and FFT dimensions are first
+ * smoothed in a single intermediate image covering the input requested
+ * region, one full line at a time. The input requested region is padded
+ * by the radius of the kernel in each dimension, so that the filter can
+ * be streamed. The image boundaries are extended with the values of the
+ * nearest pixel (zero flux Neumann boundary condition).
+ *
+ * The output of the DIRECT dimensions does not depend on how the filter
+ * is streamed or split into work units. The RECURSIVE and FFT dimensions
+ * filter lines that end at the padded requested region rather than at
+ * the image boundaries, so their output depends on the requested region:
+ * a streamed output matches the unstreamed one only within MaximumError.
  *
  * \sa GaussianOperator
  * \sa Image
@@ -92,6 +130,11 @@ public:
   using InputPixelValueType = typename NumericTraits<InputPixelType>::ValueType;
   using OutputPixelValueType = typename NumericTraits<OutputPixelType>::ValueType;
 
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using InputSizeType = typename InputImageType::SizeType;
+  using InputSpacingType = typename InputImageType::SpacingType;
+
   /** Extract some information from the image types.  Dimensionality
    * of the two images is assumed to be the same. */
   static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
@@ -99,6 +142,14 @@ public:
   /** Typedef of double containers */
   using ArrayType = FixedArray< double, Self::ImageDimension >;
 
+  /** Algorithms smoothing a dimension of the image. \sa SetAlgorithm */
+  enum AlgorithmType {
+    AUTOMATIC = 0,
+    DIRECT = 1,
+    RECURSIVE = 2,
+    FFT = 3
+    };
+
   /** The variance for the discrete Gaussian kernel.  Sets the variance
    * independently for each dimension, but
    * see also SetVariance(const double v). The default is 0.0 in each
@@ -119,6 +170,28 @@ public:
   itkGetConstMacro(MaximumKernelWidth, int);
   itkSetMacro(MaximumKernelWidth, int);
 
+  /** Set/Get the algorithm smoothing all the filtered dimensions. The
+   * default, AUTOMATIC, chooses the algorithm of each dimension from the
+   * size of its kernel. A null variance is always convolved directly.
+   * \sa AlgorithmType */
+  itkSetMacro(Algorithm, AlgorithmType);
+  itkGetConstMacro(Algorithm, AlgorithmType);
+
+  /** Array of the algorithms of each dimension. */
+  using AlgorithmArrayType = FixedArray< AlgorithmType, Self::ImageDimension >;
+
+  /** Get the radius, in pixels, of the kernel smoothing each dimension of
+   * an input image with the given spacing, with the current parameters.
+   * This is the padding of the input requested region, which is not
+   * limited by MaximumKernelWidth for the RECURSIVE and FFT dimensions.
+   * Zero for the dimensions that are not smoothed. */
+  InputSizeType GetKernelRadius( const InputSpacingType & spacing ) const;
+
+  /** Get the algorithm smoothing each dimension of an input image with the
+   * given spacing, with the current parameters. Never AUTOMATIC; DIRECT for
+   * the dimensions that are not smoothed. */
+  AlgorithmArrayType GetKernelAlgorithms( const InputSpacingType & spacing ) const;
+
   /** Set the number of dimensions to smooth. Defaults to the image
    * dimension. Can be set to less than ImageDimension, smoothing all
    * the dimensions less than FilterDimensionality.  For instance, to
@@ -238,19 +311,130 @@ protected:
     m_MaximumKernelWidth = 32;
     m_UseImageSpacing = true;
     m_FilterDimensionality = ImageDimension;
+    m_Algorithm = AUTOMATIC;
   }
 
   ~DiscreteGaussianImageFilter() override = default;
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
-  /** Standard pipeline method. While this class does not implement a
-   * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
-   * NeighborhoodOperatorImageFilter is multithreaded, this filter is
-   * multithreaded by default. */
-  void GenerateData() override;
+  /** Choose the kernels and smooth the recursive and FFT dimensions of
+   * the input requested region in the intermediate image. */
+  void BeforeThreadedGenerateData() override;
+
+  /** Smooth the directly convolved dimensions, one tile at a time. */
+  void DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+  /** Release the intermediate image. */
+  void AfterThreadedGenerateData() override;
 
 private:
+  /** Type of the computations, and of the values of the intermediate
+   * image. */
+  using RealType = typename NumericTraits< OutputPixelValueType >::RealType;
+  using IntermediateValueType = typename NumericTraits< OutputPixelValueType >::FloatType;
+
+  /** Gives access to the line filter of RecursiveGaussianImageFilter. */
+  class RecursiveLineFilter:
+    public RecursiveGaussianImageFilter< Image< RealType, 1 >, Image< RealType, 1 > >
+  {
+  public:
+    using Self = RecursiveLineFilter;
+    using Superclass = RecursiveGaussianImageFilter< Image< RealType, 1 >, Image< RealType, 1 > >;
+    using Pointer = SmartPointer< Self >;
+
+    itkNewMacro(Self);
+
+    using Superclass::SetUp;
+    using Superclass::FilterDataArray;
+  };
+
+  /** Kernel smoothing one dimension. */
+  struct DimensionKernel
+  {
+    /** Never AUTOMATIC. */
+    AlgorithmType m_Algorithm{ DIRECT };
+    /** Number of input pixels read on each side of an output pixel. */
+    SizeValueType m_Radius{ 0 };
+    /** Variance in pixels. */
+    double m_Variance{ 0.0 };
+    /** Coefficients of the GaussianOperator of DIRECT. */
+    std::vector< RealType > m_Coefficients;
+    typename RecursiveLineFilter::Pointer m_RecursiveFilter;
+  };
+
+  /** Transform and transfer function of the FFT lines of a given size. */
+  struct FFTLineFilter
+  {
+    explicit FFTLineFilter( SizeValueType size ) : m_Plan( size ) {}
+
+    NativeFFTCommon::Plan< RealType > m_Plan;
+    /** Transfer function of the discrete Gaussian, divided by the size. */
+    std::vector< RealType > m_Transfer;
+    std::vector< RealType > m_Re;
+    std::vector< RealType > m_Im;
+    std::vector< RealType > m_Work;
+  };
+
+  /** Buffers of a thread filtering a batch of lines. */
+  struct LineWorkspace
+  {
+    /** The lines to filter, one after the other. */
+    std::vector< RealType > m_Input;
+    std::vector< RealType > m_Output;
+    /** Buffers of the recursive lines. */
+    std::vector< RealType > m_Extended;
+    std::vector< RealType > m_Filtered;
+    std::vector< RealType > m_Scratch;
+    /** Indexed by dimension and transform size. */
+    std::map< std::pair< unsigned int, SizeValueType >, std::unique_ptr< FFTLineFilter > > m_FFTLineFilters;
+  };
+
+  /** Number of lines filtered at once: the RealType lanes of a vector
+   * register for the real and for the imaginary part of the FFT lines. */
+  static constexpr SizeValueType GetLineBatchSize()
+  {
+    return 2 * NativeFFTCommon::GetNumberOfLanes< RealType >();
+  }
+
+  /** Compute m_Kernels and m_Radius from the current parameters and the
+   * spacing of the input image. */
+  void ComputeKernels();
+
+  /** Compute the kernels of the filtered dimensions of an image with the
+   * given spacing. */
+  void ComputeKernels( const InputSpacingType & spacing, std::vector< DimensionKernel > & kernels ) const;
+
+  /** Compute the kernel of a dimension smoothed with the given variance,
+   * in pixels. */
+  void ComputeKernel( unsigned int dimension, double variance, DimensionKernel & kernel ) const;
+
+  /** Coefficients -halfWidth to halfWidth of the discrete Gaussian,
+   * computed from its transfer function. */
+  static std::vector< double > ComputeDiscreteGaussian( double variance, SizeValueType halfWidth );
+
+  /** Smallest size not lower than minimumSize whose prime factors are
+   * not greater than NativeFFTCommon::GREATEST_PRIME_FACTOR. */
+  static SizeValueType ComputeFFTSize( SizeValueType minimumSize );
+
+  /** Smooth along a dimension the numberOfLines lines of inputLength
+   * values of workspace.m_Input, writing the outputLength values starting
+   * at outputOffset to workspace.m_Output. The RECURSIVE and FFT kernels
+   * extend the lines beyond inputLength with their end values, which
+   * differs from the image values when the lines are cut by the
+   * requested region; the result is then accurate within MaximumError. */
+  void FilterLines( unsigned int dimension, LineWorkspace & workspace, SizeValueType numberOfLines,
+                    SizeValueType inputLength, SizeValueType outputOffset, SizeValueType outputLength ) const;
+
+  /** Smooth along a dimension the lines of a buffer starting in a box,
+   * whose size along this dimension is one. The strides are the number of
+   * values between two neighbors along each dimension. The results are
+   * written in place. */
+  template< typename TValue >
+  void FilterBufferLines( unsigned int dimension, LineWorkspace & workspace, TValue * buffer,
+                          const SizeValueType * boxStart, const SizeValueType * boxSize,
+                          const OffsetValueType * strides,
+                          SizeValueType inputLength, SizeValueType outputOffset, SizeValueType outputLength ) const;
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance;
@@ -270,6 +454,21 @@ private:
   /** Flag to indicate whether to use image spacing */
   bool m_UseImageSpacing;
 
+  AlgorithmType m_Algorithm;
+
+  /** Kernels of the filtered dimensions. */
+  std::vector< DimensionKernel > m_Kernels;
+
+  /** Padding of the output requested region in each dimension. */
+  InputSizeType m_Radius;
+
+  /** Input pixels read to compute the output requested region. */
+  InputImageRegionType m_InputRegion;
+
+  /** The input region smoothed along the recursive and FFT dimensions,
+   * one component after the other. Empty if all the dimensions are
+   * directly convolved. */
+  std::vector< IntermediateValueType > m_IntermediateImage;
 };
 } // end namespace itk
 
@@ -19,11 +19,14 @@
 #define itkDiscreteGaussianImageFilter_hxx
 
 #include "itkDiscreteGaussianImageFilter.h"
-#include "itkNeighborhoodOperatorImageFilter.h"
 #include "itkGaussianOperator.h"
-#include "itkImageRegionIterator.h"
-#include "itkProgressAccumulator.h"
 #include "itkImageAlgorithm.h"
+#include "itkImageScanlineIterator.h"
+#include "itkDefaultConvertPixelTraits.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 
 namespace itk
 {
@@ -45,48 +48,16 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     return;
     }
 
-  // Build an operator so that we can determine the kernel size
-  GaussianOperator< OutputPixelValueType, ImageDimension > oper;
-
-  typename TInputImage::SizeType radius;
-
-  for ( unsigned int i = 0; i < TInputImage::ImageDimension; i++ )
-    {
-    // Determine the size of the operator in this dimension.  Note that the
-    // Gaussian is built as a 1D operator in each of the specified directions.
-    oper.SetDirection(i);
-    if ( m_UseImageSpacing == true )
-      {
-      if ( this->GetInput()->GetSpacing()[i] == 0.0 )
-        {
-        itkExceptionMacro(<< "Pixel spacing cannot be zero");
-        }
-      else
-        {
-        // convert the variance from physical units to pixels
-        double s = this->GetInput()->GetSpacing()[i];
-        s = s * s;
-        oper.SetVariance(m_Variance[i] / s);
-        }
-      }
-    else
-      {
-      oper.SetVariance(m_Variance[i]);
-      }
-    oper.SetMaximumError(m_MaximumError[i]);
-    oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper.CreateDirectional();
-
-    radius[i] = oper.GetRadius(i);
-    }
+  // Choose the kernels so that we can determine their radius
+  this->ComputeKernels();
 
   // get a copy of the input requested region (should equal the output
   // requested region)
   typename TInputImage::RegionType inputRequestedRegion;
   inputRequestedRegion = inputPtr->GetRequestedRegion();
 
-  // pad the input requested region by the operator radius
-  inputRequestedRegion.PadByRadius(radius);
+  // pad the input requested region by the kernel radius
+  inputRequestedRegion.PadByRadius(m_Radius);
 
   // crop the input requested region at the input's largest possible region
   if ( inputRequestedRegion.Crop( inputPtr->GetLargestPossibleRegion() ) )
@@ -114,195 +85,756 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
 template< typename TInputImage, typename TOutputImage >
 void
 DiscreteGaussianImageFilter< TInputImage, TOutputImage >
-::GenerateData()
+::ComputeKernels()
 {
-  TOutputImage * output = this->GetOutput();
-
-  output->SetBufferedRegion( output->GetRequestedRegion() );
-  output->Allocate();
+  this->ComputeKernels( this->GetInput()->GetSpacing(), m_Kernels );
 
-  // Create an internal image to protect the input image's metdata
-  // (e.g. RequestedRegion). The StreamingImageFilter changes the
-  // requested region as part of its normal processing.
-  typename TInputImage::Pointer localInput = TInputImage::New();
-  localInput->Graft( this->GetInput() );
+  m_Radius.Fill( 0 );
+  for ( unsigned int i = 0; i < m_Kernels.size(); ++i )
+    {
+    m_Radius[i] = m_Kernels[i].m_Radius;
+    }
+}
 
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ComputeKernels( const InputSpacingType & spacing, std::vector< DimensionKernel > & kernels ) const
+{
   // Determine the dimensionality to filter
   unsigned int filterDimensionality = m_FilterDimensionality;
   if ( filterDimensionality > ImageDimension )
     {
     filterDimensionality = ImageDimension;
     }
-  if ( filterDimensionality == 0 )
+
+  kernels.clear();
+  kernels.resize( filterDimensionality );
+  for ( unsigned int i = 0; i < filterDimensionality; ++i )
     {
-    // no smoothing, copy input to output
-    ImageAlgorithm::Copy( localInput.GetPointer(), output, this->GetOutput()->GetRequestedRegion(), this->GetOutput()->GetRequestedRegion());
-    return;
+    double variance = m_Variance[i];
+    if ( m_UseImageSpacing == true )
+      {
+      if ( spacing[i] == 0.0 )
+        {
+        itkExceptionMacro(<< "Pixel spacing cannot be zero");
+        }
+      else
+        {
+        // convert the variance from physical units to pixels
+        double s = spacing[i];
+        s = s * s;
+        variance /= s;
+        }
+      }
+    this->ComputeKernel( i, variance, kernels[i] );
     }
+}
 
-  // Type of the pixel to use for intermediate results
-  using RealOutputPixelType = typename NumericTraits< OutputPixelType >::RealType;
-  using RealOutputImageType = Image< OutputPixelType, ImageDimension >;
+template< typename TInputImage, typename TOutputImage >
+typename DiscreteGaussianImageFilter< TInputImage, TOutputImage >::InputSizeType
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GetKernelRadius( const InputSpacingType & spacing ) const
+{
+  std::vector< DimensionKernel > kernels;
+  this->ComputeKernels( spacing, kernels );
+
+  InputSizeType radius;
+  radius.Fill( 0 );
+  for ( unsigned int i = 0; i < kernels.size(); ++i )
+    {
+    radius[i] = kernels[i].m_Radius;
+    }
+  return radius;
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename DiscreteGaussianImageFilter< TInputImage, TOutputImage >::AlgorithmArrayType
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GetKernelAlgorithms( const InputSpacingType & spacing ) const
+{
+  std::vector< DimensionKernel > kernels;
+  this->ComputeKernels( spacing, kernels );
 
-  using RealOutputPixelValueType = typename NumericTraits<RealOutputPixelType>::ValueType;
+  AlgorithmArrayType algorithms;
+  algorithms.Fill( DIRECT );
+  for ( unsigned int i = 0; i < kernels.size(); ++i )
+    {
+    algorithms[i] = kernels[i].m_Algorithm;
+    }
+  return algorithms;
+}
 
-  // Type definition for the internal neighborhood filter
-  //
-  // First filter convolves and changes type from input type to real type
-  // Middle filters convolves from real to real
-  // Last filter convolves and changes type from real type to output type
-  // Streaming filter forces the mini-pipeline to run in chunks
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ComputeKernel( unsigned int dimension, double variance, DimensionKernel & kernel ) const
+{
+  kernel = DimensionKernel();
+  kernel.m_Variance = variance;
+  const double maximumError = m_MaximumError[dimension];
+
+  // Radius of the GaussianOperator without maximum width: the
+  // coefficients are summed until the error is reached.
+  const double sigma = std::sqrt( std::max( variance, 0.0 ) );
+  const SizeValueType halfWidth = static_cast< SizeValueType >( std::ceil( 8.0 * sigma ) ) + 16;
+  std::vector< double > gaussian;
+  SizeValueType radius = 1;
+  if ( m_Algorithm != DIRECT && variance > 0.0 )
+    {
+    gaussian = Self::ComputeDiscreteGaussian( variance, halfWidth );
+    double error = 1.0 - gaussian[halfWidth] - gaussian[halfWidth - 1] - gaussian[halfWidth + 1];
+    while ( error > maximumError && radius < halfWidth )
+      {
+      ++radius;
+      error -= gaussian[halfWidth - radius] + gaussian[halfWidth + radius];
+      }
+    }
 
+  if ( gaussian.empty()
+       || ( m_Algorithm == AUTOMATIC && static_cast< OffsetValueType >( radius ) < m_MaximumKernelWidth ) )
+    {
+    GaussianOperator< RealType, 1 > oper;
+    oper.SetVariance( variance );
+    oper.SetMaximumKernelWidth( m_MaximumKernelWidth );
+    oper.SetMaximumError( maximumError );
+    oper.CreateDirectional();
 
-  using FirstFilterType = NeighborhoodOperatorImageFilter< InputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType >;
-  using IntermediateFilterType = NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType >;
-  using LastFilterType = NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           OutputImageType, RealOutputPixelValueType >;
-  using SingleFilterType = NeighborhoodOperatorImageFilter< InputImageType,
-                                           OutputImageType, RealOutputPixelValueType >;
+    // The Bessel functions of the GaussianOperator lose their accuracy for
+    // large variances, and its kernel grows far beyond the radius of the
+    // discrete Gaussian.
+    if ( gaussian.empty() || oper.GetRadius( 0 ) <= radius + 1 )
+      {
+      kernel.m_Radius = oper.GetRadius( 0 );
+      kernel.m_Coefficients.assign( oper.Begin(), oper.End() );
+      return;
+      }
+    }
 
-  using FirstFilterPointer = typename FirstFilterType::Pointer;
-  using IntermediateFilterPointer = typename IntermediateFilterType::Pointer;
-  using LastFilterPointer = typename LastFilterType::Pointer;
-  using SingleFilterPointer = typename SingleFilterType::Pointer;
+  kernel.m_Radius = radius;
+  kernel.m_Algorithm = FFT;
+  if ( m_Algorithm == FFT )
+    {
+    return;
+    }
 
-  // Create a series of operators
-  using OperatorType = GaussianOperator< RealOutputPixelValueType, ImageDimension >;
+  kernel.m_RecursiveFilter = RecursiveLineFilter::New();
+  kernel.m_RecursiveFilter->SetSigma( sigma );
+  kernel.m_RecursiveFilter->SetUp( 1.0 );
+  if ( m_Algorithm == RECURSIVE )
+    {
+    kernel.m_Algorithm = RECURSIVE;
+    return;
+    }
 
-  std::vector< OperatorType > oper;
-  oper.resize(filterDimensionality);
+  // The recursive filter is accurate enough if its impulse response is
+  // within the maximum error of the discrete Gaussian.
+  const SizeValueType length = 2 * halfWidth + 1;
+  std::vector< RealType > impulse( length, NumericTraits< RealType >::ZeroValue() );
+  std::vector< RealType > response( length );
+  std::vector< RealType > scratch( length );
+  impulse[halfWidth] = NumericTraits< RealType >::OneValue();
+  kernel.m_RecursiveFilter->FilterDataArray( response.data(), impulse.data(), scratch.data(), length );
+  double distance = 0.0;
+  for ( SizeValueType j = 0; j < length; ++j )
+    {
+    distance += std::abs( static_cast< double >( response[j] ) - gaussian[j] );
+    }
+  if ( distance <= maximumError )
+    {
+    kernel.m_Algorithm = RECURSIVE;
+    }
+  else
+    {
+    kernel.m_RecursiveFilter = nullptr;
+    }
+}
 
-  // Create a process accumulator for tracking the progress of minipipeline
-  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
-  progress->SetMiniPipelineFilter(this);
+template< typename TInputImage, typename TOutputImage >
+std::vector< double >
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ComputeDiscreteGaussian( double variance, SizeValueType halfWidth )
+{
+  const SizeValueType length = 2 * halfWidth + 1;
+  const SizeValueType size = Self::ComputeFFTSize( length );
+
+  NativeFFTCommon::Plan< double > plan( size );
+  std::vector< double > re( size );
+  std::vector< double > im( size, 0.0 );
+  std::vector< double > work( plan.GetWorkSize( 1 ) );
+  for ( SizeValueType j = 0; j < size; ++j )
+    {
+    const double frequency = Math::twopi * static_cast< double >( j ) / static_cast< double >( size );
+    re[j] = std::exp( variance * ( std::cos( frequency ) - 1.0 ) ) / static_cast< double >( size );
+    }
+  plan.Transform( re.data(), im.data(), 1, NativeFFTCommon::BACKWARD, work.data() );
 
-  // Set up the operators
-  unsigned int i;
-  for ( i = 0; i < filterDimensionality; ++i )
+  std::vector< double > gaussian( length );
+  for ( SizeValueType k = 0; k < length; ++k )
     {
-    // we reverse the direction to minimize computation while, because
-    // the largest dimension will be split slice wise for streaming
-    unsigned int reverse_i = filterDimensionality - i - 1;
+    gaussian[k] = re[( k + size - halfWidth ) % size];
+    }
+  return gaussian;
+}
 
-    // Set up the operator for this dimension
-    oper[reverse_i].SetDirection(i);
-    if ( m_UseImageSpacing == true )
+template< typename TInputImage, typename TOutputImage >
+SizeValueType
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ComputeFFTSize( SizeValueType minimumSize )
+{
+  for ( SizeValueType size = std::max< SizeValueType >( minimumSize, 1 );; ++size )
+    {
+    SizeValueType reduced = size;
+    for ( SizeValueType factor = 2; factor <= NativeFFTCommon::GREATEST_PRIME_FACTOR; ++factor )
       {
-      if ( localInput->GetSpacing()[i] == 0.0 )
+      while ( reduced % factor == 0 )
         {
-        itkExceptionMacro(<< "Pixel spacing cannot be zero");
+        reduced /= factor;
         }
-      else
+      }
+    if ( reduced == 1 )
+      {
+      return size;
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::FilterLines( unsigned int dimension, LineWorkspace & workspace, SizeValueType numberOfLines,
+               SizeValueType inputLength, SizeValueType outputOffset, SizeValueType outputLength ) const
+{
+  const DimensionKernel & kernel = m_Kernels[dimension];
+  const RealType * input = workspace.m_Input.data();
+  RealType * output = workspace.m_Output.data();
+
+  switch ( kernel.m_Algorithm )
+    {
+    case RECURSIVE:
+      {
+      // FilterDataArray needs four values, shorter lines are extended
+      // with their last value like the recursive filter does.
+      const SizeValueType length = std::max< SizeValueType >( inputLength, 4 );
+      workspace.m_Filtered.resize( length );
+      workspace.m_Scratch.resize( length );
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
         {
-        // convert the variance from physical units to pixels
-        double s = localInput->GetSpacing()[i];
-        s = s * s;
-        oper[reverse_i].SetVariance(m_Variance[i] / s);
+        const RealType * line = input + l * inputLength;
+        if ( length > inputLength )
+          {
+          workspace.m_Extended.assign( line, line + inputLength );
+          workspace.m_Extended.resize( length, line[inputLength - 1] );
+          line = workspace.m_Extended.data();
+          }
+        kernel.m_RecursiveFilter->FilterDataArray( workspace.m_Filtered.data(), line,
+                                                   workspace.m_Scratch.data(), length );
+        std::copy( workspace.m_Filtered.begin() + outputOffset,
+                   workspace.m_Filtered.begin() + outputOffset + outputLength,
+                   output + l * outputLength );
         }
+      break;
       }
-    else
+    case FFT:
       {
-      oper[reverse_i].SetVariance(m_Variance[i]);
-      }
+      // The lines are extended by at least the radius on both sides, so
+      // that the circular convolution does not mix their ends.
+      const SizeValueType size = Self::ComputeFFTSize( inputLength + 2 * kernel.m_Radius );
+      const SizeValueType lanes = NativeFFTCommon::GetNumberOfLanes< RealType >();
+      std::unique_ptr< FFTLineFilter > & fftFilter = workspace.m_FFTLineFilters[std::make_pair( dimension, size )];
+      if ( !fftFilter )
+        {
+        fftFilter.reset( new FFTLineFilter( size ) );
+        fftFilter->m_Transfer.resize( size );
+        for ( SizeValueType j = 0; j < size; ++j )
+          {
+          const double frequency = Math::twopi * static_cast< double >( j ) / static_cast< double >( size );
+          fftFilter->m_Transfer[j] = static_cast< RealType >(
+            std::exp( kernel.m_Variance * ( std::cos( frequency ) - 1.0 ) ) / static_cast< double >( size ) );
+          }
+        fftFilter->m_Re.resize( size * lanes );
+        fftFilter->m_Im.resize( size * lanes );
+        fftFilter->m_Work.resize( fftFilter->m_Plan.GetWorkSize( lanes ) );
+        }
 
-    oper[reverse_i].SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper[reverse_i].SetMaximumError(m_MaximumError[i]);
-    oper[reverse_i].CreateDirectional();
+      // The first lines are the real parts of the signals, the next ones
+      // the imaginary parts. The extension takes the value of the
+      // nearest end of the line.
+      RealType * re = fftFilter->m_Re.data();
+      RealType * im = fftFilter->m_Im.data();
+      const SizeValueType middle = inputLength + ( size - inputLength ) / 2;
+      for ( SizeValueType j = 0; j < size; ++j )
+        {
+        const SizeValueType source = j < inputLength ? j : ( j < middle ? inputLength - 1 : 0 );
+        for ( SizeValueType l = 0; l < lanes; ++l )
+          {
+          re[j * lanes + l] = l < numberOfLines ? input[l * inputLength + source] : RealType( 0 );
+          im[j * lanes + l] = lanes + l < numberOfLines ? input[( lanes + l ) * inputLength + source] : RealType( 0 );
+          }
+        }
+      fftFilter->m_Plan.Transform( re, im, lanes, NativeFFTCommon::FORWARD, fftFilter->m_Work.data() );
+      for ( SizeValueType j = 0; j < size; ++j )
+        {
+        const RealType transfer = fftFilter->m_Transfer[j];
+        for ( SizeValueType l = 0; l < lanes; ++l )
+          {
+          re[j * lanes + l] *= transfer;
+          im[j * lanes + l] *= transfer;
+          }
+        }
+      fftFilter->m_Plan.Transform( re, im, lanes, NativeFFTCommon::BACKWARD, fftFilter->m_Work.data() );
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
+        {
+        const RealType * result = l < lanes ? re + l : im + ( l - lanes );
+        for ( SizeValueType i = 0; i < outputLength; ++i )
+          {
+          output[l * outputLength + i] = result[( outputOffset + i ) * lanes];
+          }
+        }
+      break;
+      }
+    default:
+      {
+      const RealType * coefficients = kernel.m_Coefficients.data();
+      const SizeValueType width = kernel.m_Coefficients.size();
+      for ( SizeValueType l = 0; l < numberOfLines; ++l )
+        {
+        const RealType * line = input + l * inputLength + outputOffset - kernel.m_Radius;
+        RealType * result = output + l * outputLength;
+        for ( SizeValueType i = 0; i < outputLength; ++i )
+          {
+          RealType sum = NumericTraits< RealType >::ZeroValue();
+          for ( SizeValueType k = 0; k < width; ++k )
+            {
+            sum += coefficients[k] * line[i + k];
+            }
+          result[i] = sum;
+          }
+        }
+      }
     }
+}
 
-  // Create a chain of filters
-  //
-  //
+template< typename TInputImage, typename TOutputImage >
+template< typename TValue >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::FilterBufferLines( unsigned int dimension, LineWorkspace & workspace, TValue * buffer,
+                     const SizeValueType * boxStart, const SizeValueType * boxSize,
+                     const OffsetValueType * strides,
+                     SizeValueType inputLength, SizeValueType outputOffset, SizeValueType outputLength ) const
+{
+  constexpr SizeValueType batchSize = Self::GetLineBatchSize();
+  workspace.m_Input.resize( batchSize * inputLength );
+  workspace.m_Output.resize( batchSize * outputLength );
+  const OffsetValueType stride = strides[dimension];
+
+  SizeValueType numberOfLines = 1;
+  SizeValueType position[ImageDimension];
+  for ( unsigned int k = 0; k < ImageDimension; ++k )
+    {
+    numberOfLines *= boxSize[k];
+    position[k] = 0;
+    }
 
-  if ( filterDimensionality == 1 )
+  OffsetValueType lineOffsets[batchSize];
+  SizeValueType count = 0;
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
     {
-    // Use just a single filter
-    SingleFilterPointer singleFilter = SingleFilterType::New();
-    singleFilter->SetOperator(oper[0]);
-    singleFilter->SetInput(localInput);
-    progress->RegisterInternalFilter(singleFilter, 1.0f / m_FilterDimensionality);
+    OffsetValueType offset = 0;
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+      offset += static_cast< OffsetValueType >( boxStart[k] + position[k] ) * strides[k];
+      }
+    lineOffsets[count] = offset;
+    const TValue * source = buffer + offset;
+    RealType * destination = workspace.m_Input.data() + count * inputLength;
+    for ( SizeValueType j = 0; j < inputLength; ++j )
+      {
+      destination[j] = static_cast< RealType >( source[j * stride] );
+      }
+    ++count;
 
-    // Graft this filters output onto the mini-pipeline so the mini-pipeline
-    // has the correct region ivars and will write to this filters bulk data
-    // output.
-    singleFilter->GraftOutput(output);
+    if ( count == batchSize || line + 1 == numberOfLines )
+      {
+      this->FilterLines( dimension, workspace, count, inputLength, outputOffset, outputLength );
+      for ( SizeValueType b = 0; b < count; ++b )
+        {
+        TValue * target = buffer + lineOffsets[b] + static_cast< OffsetValueType >( outputOffset ) * stride;
+        const RealType * filtered = workspace.m_Output.data() + b * outputLength;
+        for ( SizeValueType i = 0; i < outputLength; ++i )
+          {
+          target[i * stride] = static_cast< TValue >( filtered[i] );
+          }
+        }
+      count = 0;
+      }
 
-    // Update the filter
-    singleFilter->Update();
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+      if ( ++position[k] < boxSize[k] )
+        {
+        break;
+        }
+      position[k] = 0;
+      }
+    }
+}
 
-    // Graft the last output of the mini-pipeline onto this filters output so
-    // the final output has the correct region ivars and a handle to the final
-    // bulk data
-    this->GraftOutput(output);
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  const InputImageType * input = this->GetInput();
+
+  this->ComputeKernels();
+  m_IntermediateImage.clear();
+
+  m_InputRegion = this->GetOutput()->GetRequestedRegion();
+  m_InputRegion.PadByRadius( m_Radius );
+  m_InputRegion.Crop( input->GetBufferedRegion() );
+
+  bool directOnly = true;
+  for ( const DimensionKernel & kernel : m_Kernels )
+    {
+    directOnly &= kernel.m_Algorithm == DIRECT;
     }
-  else
+  if ( directOnly )
     {
-    // Setup a full mini-pipeline and stream the data through the
-    // pipeline.
-    const unsigned int numberOfStages = filterDimensionality;
+    return;
+    }
 
-    // First filter convolves and changes type from input type to real type
-    FirstFilterPointer firstFilter = FirstFilterType::New();
-    firstFilter->SetOperator(oper[0]);
-    firstFilter->ReleaseDataFlagOn();
-    firstFilter->SetInput(localInput);
-    progress->RegisterInternalFilter(firstFilter, 1.0f / numberOfStages);
+  // Smooth the recursive and FFT dimensions of the whole input region,
+  // one full line at a time.
+  const unsigned int numberOfComponents = input->GetNumberOfComponentsPerPixel();
+  const SizeValueType numberOfPixels = m_InputRegion.GetNumberOfPixels();
+  m_IntermediateImage.resize( numberOfComponents * numberOfPixels );
+  IntermediateValueType * intermediate = m_IntermediateImage.data();
 
-    // Middle filters convolves from real to real
-    std::vector< IntermediateFilterPointer > intermediateFilters;
-    if ( filterDimensionality > 2 )
+  OffsetValueType strides[ImageDimension];
+  strides[0] = 1;
+  for ( unsigned int k = 1; k < ImageDimension; ++k )
+    {
+    strides[k] = strides[k - 1] * static_cast< OffsetValueType >( m_InputRegion.GetSize( k - 1 ) );
+    }
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  multiThreader->template ParallelizeImageRegion< ImageDimension >(
+    m_InputRegion,
+    [&]( const InputImageRegionType & region )
       {
-      for ( i = 1; i < filterDimensionality - 1; ++i )
+      ImageScanlineConstIterator< InputImageType > it( input, region );
+      while ( !it.IsAtEnd() )
         {
-        IntermediateFilterPointer f = IntermediateFilterType::New();
-        f->SetOperator(oper[i]);
-        f->ReleaseDataFlagOn();
-        progress->RegisterInternalFilter(f, 1.0f / numberOfStages);
+        OffsetValueType offset = 0;
+        for ( unsigned int k = 0; k < ImageDimension; ++k )
+          {
+          offset += ( it.GetIndex()[k] - m_InputRegion.GetIndex( k ) ) * strides[k];
+          }
+        while ( !it.IsAtEndOfLine() )
+          {
+          const InputPixelType pixel = it.Get();
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            intermediate[c * numberOfPixels + offset] = static_cast< IntermediateValueType >(
+              DefaultConvertPixelTraits< InputPixelType >::GetNthComponent( c, pixel ) );
+            }
+          ++offset;
+          ++it;
+          }
+        it.NextLine();
+        }
+      },
+    nullptr );
 
-        if ( i == 1 )
+  for ( unsigned int d = static_cast< unsigned int >( m_Kernels.size() ); d-- > 0; )
+    {
+    if ( m_Kernels[d].m_Algorithm == DIRECT )
+      {
+      continue;
+      }
+    const SizeValueType length = m_InputRegion.GetSize( d );
+    multiThreader->template ParallelizeImageRegionRestrictDirection< ImageDimension >(
+      d,
+      m_InputRegion,
+      [&]( const InputImageRegionType & region )
+        {
+        LineWorkspace workspace;
+        SizeValueType boxStart[ImageDimension];
+        SizeValueType boxSize[ImageDimension];
+        for ( unsigned int k = 0; k < ImageDimension; ++k )
           {
-          f->SetInput( firstFilter->GetOutput() );
+          boxStart[k] = static_cast< SizeValueType >( region.GetIndex( k ) - m_InputRegion.GetIndex( k ) );
+          boxSize[k] = region.GetSize( k );
           }
-        else
+        boxSize[d] = 1;
+        for ( unsigned int c = 0; c < numberOfComponents; ++c )
           {
-          // note: first filter in vector (zeroth element) is for i==1
-          f->SetInput( intermediateFilters[i - 2]->GetOutput() );
+          this->FilterBufferLines( d, workspace, intermediate + c * numberOfPixels,
+                                   boxStart, boxSize, strides, length, 0, length );
           }
+        },
+      nullptr );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  const InputImageType * input = this->GetInput();
+  OutputImageType * output = this->GetOutput();
 
-        intermediateFilters.push_back(f);
+  if ( m_Kernels.empty() )
+    {
+    // no smoothing, copy input to output
+    ImageAlgorithm::Copy( input, output, outputRegionForThread, outputRegionForThread );
+    return;
+    }
+
+  const unsigned int numberOfComponents = input->GetNumberOfComponentsPerPixel();
+
+  // Only the directly convolved dimensions need to be padded, the other
+  // ones are read from the intermediate image.
+  SizeValueType radius[ImageDimension];
+  for ( unsigned int k = 0; k < ImageDimension; ++k )
+    {
+    radius[k] = k < m_Kernels.size() && m_Kernels[k].m_Algorithm == DIRECT ? m_Kernels[k].m_Radius : 0;
+    }
+
+  // Halve the largest side of the tiles until their padded values fit in
+  // the cache, but not below the padding, which would mostly be recomputed.
+  constexpr SizeValueType maximumTileSize = 128 * 1024;
+  SizeValueType tileSize[ImageDimension];
+  for ( unsigned int k = 0; k < ImageDimension; ++k )
+    {
+    tileSize[k] = outputRegionForThread.GetSize( k );
+    }
+  for ( ;; )
+    {
+    SizeValueType paddedSize = numberOfComponents;
+    unsigned int largest = ImageDimension;
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+      paddedSize *= tileSize[k] + 2 * radius[k];
+      if ( tileSize[k] > std::max< SizeValueType >( 2 * radius[k], 1 )
+           && ( largest == ImageDimension || tileSize[k] > tileSize[largest] ) )
+        {
+        largest = k;
         }
       }
+    if ( paddedSize <= maximumTileSize || largest == ImageDimension )
+      {
+      break;
+      }
+    tileSize[largest] = ( tileSize[largest] + 1 ) / 2;
+    }
 
-    // Last filter convolves and changes type from real type to output type
-    LastFilterPointer lastFilter = LastFilterType::New();
-    lastFilter->SetOperator(oper[filterDimensionality - 1]);
-    if ( filterDimensionality > 2 )
+  SizeValueType maximumPaddedSize = numberOfComponents;
+  for ( unsigned int k = 0; k < ImageDimension; ++k )
+    {
+    maximumPaddedSize *= tileSize[k] + 2 * radius[k];
+    }
+  std::vector< RealType > tile( maximumPaddedSize );
+  LineWorkspace workspace;
+
+  // The tiles are read from the input, or from the intermediate image.
+  const bool readInput = m_IntermediateImage.empty();
+  const SizeValueType intermediateNumberOfPixels = m_InputRegion.GetNumberOfPixels();
+  OffsetValueType sourceStrides[ImageDimension];
+  typename InputImageType::IndexType sourceIndex;
+  if ( readInput )
+    {
+    const OffsetValueType * offsetTable = input->GetOffsetTable();
+    std::copy( offsetTable, offsetTable + ImageDimension, sourceStrides );
+    sourceIndex = input->GetBufferedRegion().GetIndex();
+    }
+  else
+    {
+    sourceStrides[0] = 1;
+    for ( unsigned int k = 1; k < ImageDimension; ++k )
       {
-      lastFilter->SetInput( intermediateFilters[filterDimensionality - 3]->GetOutput() );
+      sourceStrides[k] = sourceStrides[k - 1] * static_cast< OffsetValueType >( m_InputRegion.GetSize( k - 1 ) );
       }
-    else
+    sourceIndex = m_InputRegion.GetIndex();
+    }
+  typename InputImageType::NeighborhoodAccessorFunctorType accessor = input->GetNeighborhoodAccessor();
+  accessor.SetBegin( input->GetBufferPointer() );
+  const InputInternalPixelType * inputBuffer = input->GetBufferPointer();
+  std::vector< OffsetValueType > clampedOffsets[ImageDimension];
+
+  SizeValueType tilePosition[ImageDimension];
+  for ( unsigned int k = 0; k < ImageDimension; ++k )
+    {
+    tilePosition[k] = 0;
+    }
+  for ( ;; )
+    {
+    OutputImageRegionType tileRegion;
+    SizeValueType paddedSize[ImageDimension];
+    OffsetValueType strides[ImageDimension];
+    SizeValueType numberOfValues = 1;
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
       {
-      lastFilter->SetInput( firstFilter->GetOutput() );
+      const SizeValueType start = tilePosition[k] * tileSize[k];
+      tileRegion.SetIndex( k, outputRegionForThread.GetIndex( k ) + static_cast< IndexValueType >( start ) );
+      tileRegion.SetSize( k, std::min( tileSize[k], outputRegionForThread.GetSize( k ) - start ) );
+      paddedSize[k] = tileRegion.GetSize( k ) + 2 * radius[k];
+      strides[k] = static_cast< OffsetValueType >( numberOfValues );
+      numberOfValues *= paddedSize[k];
       }
-    progress->RegisterInternalFilter(lastFilter, 1.0f / numberOfStages);
 
-    // Graft this filters output onto the mini-pipeline so the mini-pipeline
-    // has the correct region ivars and will write to this filters bulk data
-    // output.
-    lastFilter->GraftOutput(output);
+    // Load the padded tile, with the boundary values of the input region
+    // repeated outside.
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+      const IndexValueType first = m_InputRegion.GetIndex( k );
+      const IndexValueType last = first + static_cast< IndexValueType >( m_InputRegion.GetSize( k ) ) - 1;
+      clampedOffsets[k].resize( paddedSize[k] );
+      for ( SizeValueType j = 0; j < paddedSize[k]; ++j )
+        {
+        const IndexValueType index = tileRegion.GetIndex( k ) - static_cast< IndexValueType >( radius[k] )
+                                     + static_cast< IndexValueType >( j );
+        clampedOffsets[k][j] = ( std::min( std::max( index, first ), last ) - sourceIndex[k] ) * sourceStrides[k];
+        }
+      }
+    const SizeValueType numberOfRows = numberOfValues / paddedSize[0];
+    SizeValueType rowPosition[ImageDimension];
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+      rowPosition[k] = 0;
+      }
+    for ( SizeValueType row = 0; row < numberOfRows; ++row )
+      {
+      OffsetValueType sourceRow = 0;
+      for ( unsigned int k = 1; k < ImageDimension; ++k )
+        {
+        sourceRow += clampedOffsets[k][rowPosition[k]];
+        }
+      RealType * tileRow = tile.data() + row * paddedSize[0];
+      if ( readInput )
+        {
+        for ( SizeValueType x = 0; x < paddedSize[0]; ++x )
+          {
+          const InputPixelType pixel = accessor.Get( inputBuffer + sourceRow + clampedOffsets[0][x] );
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            tileRow[c * numberOfValues + x] = static_cast< RealType >(
+              DefaultConvertPixelTraits< InputPixelType >::GetNthComponent( c, pixel ) );
+            }
+          }
+        }
+      else
+        {
+        for ( unsigned int c = 0; c < numberOfComponents; ++c )
+          {
+          const IntermediateValueType * source = m_IntermediateImage.data() + c * intermediateNumberOfPixels + sourceRow;
+          for ( SizeValueType x = 0; x < paddedSize[0]; ++x )
+            {
+            tileRow[c * numberOfValues + x] = static_cast< RealType >( source[clampedOffsets[0][x]] );
+            }
+          }
+        }
+      for ( unsigned int k = 1; k < ImageDimension; ++k )
+        {
+        if ( ++rowPosition[k] < paddedSize[k] )
+          {
+          break;
+          }
+        rowPosition[k] = 0;
+        }
+      }
 
-    // Update the last filter in the chain
-    lastFilter->Update();
+    // Smooth the directly convolved dimensions, the last one first as the
+    // previous implementation did. The padding of the smoothed dimensions
+    // is not needed anymore. Like the images between the stages of the
+    // previous implementation, the values are converted to the output pixel
+    // type between two directly convolved dimensions, so that the output is
+    // the same.
+    bool convertToOutputType = false;
+    for ( unsigned int d = static_cast< unsigned int >( m_Kernels.size() ); d-- > 0; )
+      {
+      if ( m_Kernels[d].m_Algorithm != DIRECT )
+        {
+        continue;
+        }
+      if ( convertToOutputType && !std::is_same< OutputPixelValueType, RealType >::value )
+        {
+        for ( RealType & value : tile )
+          {
+          value = static_cast< RealType >( static_cast< OutputPixelValueType >( value ) );
+          }
+        }
+      convertToOutputType = true;
+      SizeValueType boxStart[ImageDimension];
+      SizeValueType boxSize[ImageDimension];
+      for ( unsigned int k = 0; k < ImageDimension; ++k )
+        {
+        boxStart[k] = k > d ? radius[k] : 0;
+        boxSize[k] = k > d ? tileRegion.GetSize( k ) : paddedSize[k];
+        }
+      boxSize[d] = 1;
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        this->FilterBufferLines( d, workspace, tile.data() + c * numberOfValues, boxStart, boxSize, strides,
+                                 paddedSize[d], radius[d], tileRegion.GetSize( d ) );
+        }
+      }
+
+    // Write the tile to the output
+    OutputPixelType pixel;
+    NumericTraits< OutputPixelType >::SetLength( pixel, numberOfComponents );
+    ImageScanlineIterator< OutputImageType > it( output, tileRegion );
+    while ( !it.IsAtEnd() )
+      {
+      OffsetValueType offset = 0;
+      for ( unsigned int k = 0; k < ImageDimension; ++k )
+        {
+        offset += ( it.GetIndex()[k] - tileRegion.GetIndex( k ) + static_cast< OffsetValueType >( radius[k] ) )
+                  * strides[k];
+        }
+      while ( !it.IsAtEndOfLine() )
+        {
+        for ( unsigned int c = 0; c < numberOfComponents; ++c )
+          {
+          DefaultConvertPixelTraits< OutputPixelType >::SetNthComponent(
+            c, pixel, static_cast< OutputPixelValueType >( tile[c * numberOfValues + offset] ) );
+          }
+        it.Set( pixel );
+        ++offset;
+        ++it;
+        }
+      it.NextLine();
+      }
 
-    // Graft the last output of the mini-pipeline onto this filters output so
-    // the final output has the correct region ivars and a handle to the final
-    // bulk data
-    this->GraftOutput(output);
+    // Next tile
+    unsigned int k = 0;
+    for ( ; k < ImageDimension; ++k )
+      {
+      if ( ++tilePosition[k] * tileSize[k] < outputRegionForThread.GetSize( k ) )
+        {
+        break;
+        }
+      tilePosition[k] = 0;
+      }
+    if ( k == ImageDimension )
+      {
+      break;
+      }
     }
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  std::vector< IntermediateValueType >().swap( m_IntermediateImage );
+}
+
 #if !defined( ITK_LEGACY_REMOVE )
 template< typename TInputImage, typename TOutputImage >
 unsigned int
@@ -335,6 +867,7 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
   os << indent << "MaximumKernelWidth: " << m_MaximumKernelWidth << std::endl;
   os << indent << "FilterDimensionality: " << m_FilterDimensionality << std::endl;
   os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
+  os << indent << "Algorithm: " << m_Algorithm << std::endl;
 }
 } // end namespace itk
 
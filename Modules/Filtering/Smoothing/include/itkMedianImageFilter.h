@@ -20,6 +20,10 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace itk
 {
@@ -35,6 +39,27 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * The median is computed by one of three methods, chosen from the pixel
+ * type and the size of the neighborhood:
+ * - for scalar pixels and neighborhoods of at most
+ *   MaximumSortingNetworkSize pixels, such as 3x3, 5x5 or 3x3x3, a
+ *   median selection network is applied to blocks of pixels along a row.
+ *   Its compare-exchange steps are branchless loops of min/max which the
+ *   compiler vectorizes;
+ * - for larger neighborhoods of 8 and 16 bit integer pixels, a histogram
+ *   of the neighborhood is slid along each row (Huang's algorithm). Moving
+ *   by one pixel only removes and adds the pixels of two faces of the
+ *   neighborhood, and the median is tracked incrementally in the
+ *   histogram, so that the cost per pixel grows with the size of a face
+ *   instead of the size of the neighborhood;
+ * - otherwise, the neighborhood of every pixel is partially sorted with
+ *   std::nth_element.
+ *
+ * All methods give the same result, except for floating point
+ * neighborhoods which contain NaN: NaN is not ordered, so the median of
+ * such a neighborhood depends on the method, as it depends on the order of
+ * the pixels for std::nth_element.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -83,6 +108,11 @@ public:
   using OutputImageRegionType = typename OutputImageType::RegionType;
 
   using InputSizeType = typename InputImageType::SizeType;
+  using InputIndexType = typename InputImageType::IndexType;
+
+  /** The largest neighborhood, in pixels, for which a median selection
+   * network is used. */
+  static constexpr unsigned int MaximumSortingNetworkSize = 27;
 
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
@@ -111,6 +141,58 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
 
+  /** Choose the method which computes the median, and build the median
+   * selection network if it is used. */
+  void BeforeThreadedGenerateData() override;
+
+  /** Release the histograms. */
+  void AfterThreadedGenerateData() override;
+
+private:
+  /** The methods which compute the median. */
+  enum class MedianMethod { NthElement, SortingNetwork, Histogram };
+
+  /** The fast methods read the pixels of an Image of arithmetic scalars
+   * directly from its buffer. The histogram has a bin for every value. */
+  static constexpr bool InputIsScalarImage =
+    std::is_arithmetic< InputPixelType >::value
+    && !std::is_same< InputPixelType, bool >::value
+    && std::is_same< InputImageType, Image< InputPixelType, InputImageDimension > >::value;
+  static constexpr bool InputHasSmallIntegerPixels =
+    InputIsScalarImage && std::is_integral< InputPixelType >::value && sizeof( InputPixelType ) <= 2;
+
+  /** Compute the median by partially sorting every neighborhood. */
+  void NthElementGenerateData(const OutputImageRegionType & outputRegionForThread);
+
+  /** Compute the median with the median selection network. */
+  void SortingNetworkGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type);
+  void SortingNetworkGenerateData(const OutputImageRegionType &, std::false_type) {}
+
+  /** Compute the median with a histogram slid along the rows. */
+  void HistogramGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type);
+  void HistogramGenerateData(const OutputImageRegionType &, std::false_type) {}
+
+  /** Get the start of the input rows which the neighborhoods of the row
+   * starting at lineIndex span, and the position in them of the columns
+   * from lineIndex[0] - radius[0] to lineIndex[0] + lineLength - 1 +
+   * radius[0]. Rows and columns outside of the buffered region of the input
+   * are clamped to it, as ZeroFluxNeumannBoundaryCondition does. */
+  void ComputeNeighborhoodRowsAndColumns(const InputIndexType & lineIndex, SizeValueType lineLength,
+                                         std::vector< const InputPixelType * > & rows,
+                                         std::vector< OffsetValueType > & columns) const;
+
+  MedianMethod m_MedianMethod{ MedianMethod::NthElement };
+
+  /** The compare-exchange steps of the median selection network, pruned to
+   * those which the median depends on. */
+  std::vector< std::pair< unsigned int, unsigned int > > m_SortingNetwork;
+
+  /** The histograms of the sliding histogram method, allocated once per
+   * update instead of once per work unit. A work unit takes one and gives
+   * it back empty. */
+  using HistogramType = std::vector< SizeValueType >;
+  std::vector< HistogramType > m_Histograms;
+  std::mutex                   m_HistogramsMutex;
 };
 } // end namespace itk
 
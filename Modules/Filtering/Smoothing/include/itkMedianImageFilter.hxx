@@ -22,12 +22,14 @@
 #include "itkConstNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
 
 #include <vector>
 #include <algorithm>
+#include <limits>
 
 namespace itk
 {
@@ -38,10 +40,102 @@ MedianImageFilter< TInputImage, TOutputImage >
   this->DynamicMultiThreadingOn();
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  const InputSizeType & radius = this->GetRadius();
+  unsigned int neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= 2 * static_cast< unsigned int >( radius[d] ) + 1;
+    }
+
+  m_SortingNetwork.clear();
+  if ( InputIsScalarImage && neighborhoodSize <= MaximumSortingNetworkSize )
+    {
+    m_MedianMethod = MedianMethod::SortingNetwork;
+
+    // Batcher's odd-even merge sort, for any number of inputs
+    std::vector< std::pair< unsigned int, unsigned int > > network;
+    for ( unsigned int p = 1; p < neighborhoodSize; p *= 2 )
+      {
+      for ( unsigned int k = p; k >= 1; k /= 2 )
+        {
+        for ( unsigned int j = k % p; j + k < neighborhoodSize; j += 2 * k )
+          {
+          for ( unsigned int i = 0; i < k && i + j + k < neighborhoodSize; ++i )
+            {
+            if ( ( i + j ) / ( 2 * p ) == ( i + j + k ) / ( 2 * p ) )
+              {
+              network.emplace_back( i + j, i + j + k );
+              }
+            }
+          }
+        }
+      }
+
+    // Only keep the steps whose outputs the median depends on
+    std::vector< bool > needed( neighborhoodSize, false );
+    needed[neighborhoodSize / 2] = true;
+    for ( auto step = network.rbegin(); step != network.rend(); ++step )
+      {
+      if ( needed[step->first] || needed[step->second] )
+        {
+        needed[step->first] = true;
+        needed[step->second] = true;
+        m_SortingNetwork.push_back( *step );
+        }
+      }
+    std::reverse( m_SortingNetwork.begin(), m_SortingNetwork.end() );
+    }
+  else if ( InputHasSmallIntegerPixels )
+    {
+    m_MedianMethod = MedianMethod::Histogram;
+    }
+  else
+    {
+    m_MedianMethod = MedianMethod::NthElement;
+    }
+  m_Histograms.clear();
+  itkDebugMacro(<< "Median method: " << static_cast< int >( m_MedianMethod ));
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  m_Histograms.clear();
+  m_Histograms.shrink_to_fit();
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 MedianImageFilter< TInputImage, TOutputImage >
 ::DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  switch ( m_MedianMethod )
+    {
+    case MedianMethod::SortingNetwork:
+      this->SortingNetworkGenerateData( outputRegionForThread,
+                                        std::integral_constant< bool, InputIsScalarImage >() );
+      break;
+    case MedianMethod::Histogram:
+      this->HistogramGenerateData( outputRegionForThread,
+                                   std::integral_constant< bool, InputHasSmallIntegerPixels >() );
+      break;
+    default:
+      this->NthElementGenerateData( outputRegionForThread );
+      break;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::NthElementGenerateData(const OutputImageRegionType & outputRegionForThread)
 {
   // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
@@ -90,6 +184,214 @@ MedianImageFilter< TInputImage, TOutputImage >
       }
     }
 }
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::SortingNetworkGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type)
+{
+  OutputImageType * output = this->GetOutput();
+
+  // The network is applied to blocks of BlockLength pixels of a row at
+  // once: values holds the i-th pixel of their neighborhoods at
+  // [i * BlockLength, (i + 1) * BlockLength), so that every step is a
+  // vectorizable loop
+  constexpr SizeValueType BlockLength = 64;
+  const InputSizeType & radius = this->GetRadius();
+  const SizeValueType   lineLength = outputRegionForThread.GetSize(0);
+  const SizeValueType   rowLength = 2 * radius[0] + 1;
+
+  std::vector< const InputPixelType * > rows;
+  std::vector< OffsetValueType >        columns;
+  std::vector< InputPixelType >         values;
+
+  ImageScanlineIterator< OutputImageType > it( output, outputRegionForThread );
+  while ( !it.IsAtEnd() )
+    {
+    this->ComputeNeighborhoodRowsAndColumns( it.GetIndex(), lineLength, rows, columns );
+    const SizeValueType neighborhoodSize = rows.size() * rowLength;
+    values.resize( neighborhoodSize * BlockLength );
+
+    for ( SizeValueType blockStart = 0; blockStart < lineLength; blockStart += BlockLength )
+      {
+      const SizeValueType blockSize = std::min( BlockLength, lineLength - blockStart );
+
+      InputPixelType *value = values.data();
+      for ( const InputPixelType *row : rows )
+        {
+        for ( SizeValueType k = 0; k < rowLength; ++k, value += BlockLength )
+          {
+          const OffsetValueType *column = columns.data() + blockStart + k;
+          for ( SizeValueType l = 0; l < blockSize; ++l )
+            {
+            value[l] = row[column[l]];
+            }
+          }
+        }
+
+      for ( const auto & step : m_SortingNetwork )
+        {
+        InputPixelType *first = values.data() + step.first * BlockLength;
+        InputPixelType *second = values.data() + step.second * BlockLength;
+        for ( SizeValueType l = 0; l < BlockLength; ++l )
+          {
+          const InputPixelType smaller = std::min( first[l], second[l] );
+          const InputPixelType larger = std::max( first[l], second[l] );
+          first[l] = smaller;
+          second[l] = larger;
+          }
+        }
+
+      const InputPixelType *median = values.data() + ( neighborhoodSize / 2 ) * BlockLength;
+      for ( SizeValueType l = 0; l < blockSize; ++l )
+        {
+        it.Set( static_cast< OutputPixelType >( median[l] ) );
+        ++it;
+        }
+      }
+    it.NextLine();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::HistogramGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type)
+{
+  OutputImageType * output = this->GetOutput();
+
+  const InputSizeType & radius = this->GetRadius();
+  const SizeValueType   lineLength = outputRegionForThread.GetSize(0);
+  const SizeValueType   rowLength = 2 * radius[0] + 1;
+
+  // The histogram has a bin for every value. The median is the value of
+  // the bin medianBin, below which there are numberBelowMedian pixels.
+  const OffsetValueType        lowest = static_cast< OffsetValueType >( std::numeric_limits< InputPixelType >::lowest() );
+  HistogramType histogram;
+    {
+    std::lock_guard< std::mutex > lock( m_HistogramsMutex );
+    if ( !m_Histograms.empty() )
+      {
+      histogram.swap( m_Histograms.back() );
+      m_Histograms.pop_back();
+      }
+    }
+  histogram.resize( SizeValueType( 1 ) << ( 8 * sizeof( InputPixelType ) ), 0 );
+  OffsetValueType medianBin = 0;
+  SizeValueType   numberBelowMedian = 0;
+
+  std::vector< const InputPixelType * > rows;
+  std::vector< OffsetValueType >        columns;
+
+  ImageScanlineIterator< OutputImageType > it( output, outputRegionForThread );
+  while ( !it.IsAtEnd() )
+    {
+    this->ComputeNeighborhoodRowsAndColumns( it.GetIndex(), lineLength, rows, columns );
+    const SizeValueType medianPosition = rows.size() * rowLength / 2;
+
+    // The neighborhood of the first pixel of the row
+    for ( const InputPixelType *row : rows )
+      {
+      for ( SizeValueType k = 0; k < rowLength; ++k )
+        {
+        const OffsetValueType bin = static_cast< OffsetValueType >( row[columns[k]] ) - lowest;
+        ++histogram[bin];
+        numberBelowMedian += ( bin < medianBin );
+        }
+      }
+
+    for ( SizeValueType i = 0; i < lineLength; ++i )
+      {
+      if ( i > 0 )
+        {
+        // Remove the column which leaves the neighborhood, and add the one
+        // which enters it
+        for ( const InputPixelType *row : rows )
+          {
+          const OffsetValueType removedBin = static_cast< OffsetValueType >( row[columns[i - 1]] ) - lowest;
+          --histogram[removedBin];
+          numberBelowMedian -= ( removedBin < medianBin );
+          const OffsetValueType addedBin = static_cast< OffsetValueType >( row[columns[i - 1 + rowLength]] ) - lowest;
+          ++histogram[addedBin];
+          numberBelowMedian += ( addedBin < medianBin );
+          }
+        }
+
+      while ( numberBelowMedian > medianPosition )
+        {
+        --medianBin;
+        numberBelowMedian -= histogram[medianBin];
+        }
+      while ( numberBelowMedian + histogram[medianBin] <= medianPosition )
+        {
+        numberBelowMedian += histogram[medianBin];
+        ++medianBin;
+        }
+
+      it.Set( static_cast< OutputPixelType >( static_cast< InputPixelType >( medianBin + lowest ) ) );
+      ++it;
+      }
+
+    // Empty the histogram for the next row
+    for ( const InputPixelType *row : rows )
+      {
+      for ( SizeValueType k = lineLength - 1; k < lineLength - 1 + rowLength; ++k )
+        {
+        const OffsetValueType bin = static_cast< OffsetValueType >( row[columns[k]] ) - lowest;
+        --histogram[bin];
+        numberBelowMedian -= ( bin < medianBin );
+        }
+      }
+    it.NextLine();
+    }
+
+  // The histogram is empty again, another work unit can reuse it
+  std::lock_guard< std::mutex > lock( m_HistogramsMutex );
+  m_Histograms.push_back( std::move( histogram ) );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ComputeNeighborhoodRowsAndColumns(const InputIndexType & lineIndex, SizeValueType lineLength,
+                                    std::vector< const InputPixelType * > & rows,
+                                    std::vector< OffsetValueType > & columns) const
+{
+  const InputImageType *       input = this->GetInput();
+  const InputImageRegionType & bufferedRegion = input->GetBufferedRegion();
+  const OffsetValueType *      offsetTable = input->GetOffsetTable();
+  const InputSizeType &        radius = this->GetRadius();
+
+  auto clamp = [&bufferedRegion](unsigned int d, IndexValueType index) -> OffsetValueType
+    {
+    const IndexValueType first = bufferedRegion.GetIndex(d);
+    const IndexValueType last = first + static_cast< IndexValueType >( bufferedRegion.GetSize(d) ) - 1;
+    return std::min( std::max( index, first ), last ) - first;
+    };
+
+  rows.assign( 1, input->GetBufferPointer() );
+  std::vector< const InputPixelType * > previousRows;
+  for ( unsigned int d = 1; d < InputImageDimension; ++d )
+    {
+    previousRows.swap( rows );
+    rows.clear();
+    const auto r = static_cast< IndexValueType >( radius[d] );
+    for ( IndexValueType offset = -r; offset <= r; ++offset )
+      {
+      const OffsetValueType step = clamp( d, lineIndex[d] + offset ) * offsetTable[d];
+      for ( const InputPixelType *row : previousRows )
+        {
+        rows.push_back( row + step );
+        }
+      }
+    }
+
+  const auto r = static_cast< IndexValueType >( radius[0] );
+  columns.resize( lineLength + 2 * radius[0] );
+  for ( SizeValueType k = 0; k < columns.size(); ++k )
+    {
+    columns[k] = clamp( 0, lineIndex[0] - r + static_cast< IndexValueType >( k ) );
+    }
+}
 } // end namespace itk
 
 #endif
@@ -5,6 +5,7 @@ interesting to look at the ITKAnisotropicSmoothing group of filters.")
 itk_module(ITKSmoothing
   COMPILE_DEPENDS
     ITKImageFunction
+    ITKFFT
   TEST_DEPENDS
     ITKTestKernel
   DESCRIPTION
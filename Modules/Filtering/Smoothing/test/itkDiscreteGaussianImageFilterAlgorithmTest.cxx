@@ -0,0 +1,298 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image< double, Dimension >;
+using FilterType = itk::DiscreteGaussianImageFilter< ImageType, ImageType >;
+
+ImageType::Pointer
+CreateRandomImage()
+{
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  ImageType::IndexType index = {{ 5, -3, 2 }};
+  ImageType::SizeType size = {{ 45, 38, 27 }};
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( ImageType::RegionType( index, size ) );
+  image->Allocate();
+  for ( itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    it.Set( generator->GetUniformVariate( 0.0, 1.0 ) );
+    }
+  return image;
+}
+
+// Separable convolution with the GaussianOperator, one dimension after
+// the other, the last one first, as the previous implementation of the
+// filter did.
+// Only the first filterDimensionality dimensions are smoothed.
+template< typename TImage >
+typename TImage::Pointer
+ConvolveWithGaussianOperator( const TImage * input, const FilterType::ArrayType & variance, double maximumError,
+                              unsigned int maximumKernelWidth, unsigned int filterDimensionality = Dimension )
+{
+  using ConvolutionFilterType = itk::NeighborhoodOperatorImageFilter< TImage, TImage, double >;
+  typename TImage::Pointer image = const_cast< TImage * >( input );
+  for ( unsigned int d = filterDimensionality; d-- > 0; )
+    {
+    itk::GaussianOperator< double, Dimension > oper;
+    oper.SetDirection( d );
+    oper.SetVariance( variance[d] );
+    oper.SetMaximumError( maximumError );
+    oper.SetMaximumKernelWidth( maximumKernelWidth );
+    oper.CreateDirectional();
+
+    typename ConvolutionFilterType::Pointer convolver = ConvolutionFilterType::New();
+    convolver->SetInput( image );
+    convolver->SetOperator( oper );
+    convolver->Update();
+    image = convolver->GetOutput();
+    image->DisconnectPipeline();
+    }
+  return image;
+}
+
+template< typename TImage >
+typename TImage::Pointer
+ConvolveWithGaussianOperator( const TImage * input, double variance, double maximumError, unsigned int maximumKernelWidth )
+{
+  FilterType::ArrayType varianceArray;
+  varianceArray.Fill( variance );
+  return ConvolveWithGaussianOperator< TImage >( input, varianceArray, maximumError, maximumKernelWidth );
+}
+
+// Radius of the GaussianOperator used as reference for a dimension.
+itk::SizeValueType
+OperatorRadius( double variance, double maximumError, unsigned int maximumKernelWidth )
+{
+  itk::GaussianOperator< double, 1 > oper;
+  oper.SetVariance( variance );
+  oper.SetMaximumError( maximumError );
+  oper.SetMaximumKernelWidth( maximumKernelWidth );
+  oper.CreateDirectional();
+  return oper.GetRadius( 0 );
+}
+
+// The kernels chosen by the filter, which the multi-resolution pyramids
+// use to pad their requested regions.
+bool
+CheckKernels( const FilterType * filter, const ImageType * input, const FilterType::AlgorithmArrayType & algorithms,
+              const FilterType::InputSizeType & radius, itk::SizeValueType radiusTolerance, const char * description )
+{
+  const FilterType::AlgorithmArrayType kernelAlgorithms = filter->GetKernelAlgorithms( input->GetSpacing() );
+  const FilterType::InputSizeType kernelRadius = filter->GetKernelRadius( input->GetSpacing() );
+  bool pass = true;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    const itk::SizeValueType radiusDifference =
+      std::max( kernelRadius[d], radius[d] ) - std::min( kernelRadius[d], radius[d] );
+    if ( kernelAlgorithms[d] != algorithms[d] || radiusDifference > radiusTolerance )
+      {
+      std::cerr << description << ": dimension " << d << " has algorithm " << kernelAlgorithms[d]
+                << " and radius " << kernelRadius[d] << ", expected " << algorithms[d]
+                << " and radius " << radius[d] << std::endl;
+      pass = false;
+      }
+    }
+  return pass;
+}
+
+ImageType::Pointer
+Smooth( FilterType * filter, const ImageType * input, FilterType::AlgorithmType algorithm,
+        itk::ThreadIdType numberOfWorkUnits = 3, unsigned int numberOfStreamDivisions = 1 )
+{
+  filter->SetInput( input );
+  filter->SetAlgorithm( algorithm );
+  filter->SetNumberOfWorkUnits( numberOfWorkUnits );
+
+  using StreamerType = itk::StreamingImageFilter< ImageType, ImageType >;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( filter->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  streamer->UpdateLargestPossibleRegion();
+  ImageType::Pointer output = streamer->GetOutput();
+  output->DisconnectPipeline();
+  return output;
+}
+
+template< typename TImage >
+double
+MaximumDifference( const TImage * image1, const TImage * image2 )
+{
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIterator< TImage > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage > it2( image2, image1->GetLargestPossibleRegion() );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    maximumDifference = std::max( maximumDifference,
+      itk::Math::abs( static_cast< double >( it1.Get() ) - static_cast< double >( it2.Get() ) ) );
+    }
+  return maximumDifference;
+}
+
+template< typename TImage >
+bool
+CheckDifference( const TImage * image1, const TImage * image2, double tolerance, const char * description )
+{
+  const double maximumDifference = MaximumDifference( image1, image2 );
+  std::cout << description << ": maximum difference " << maximumDifference << std::endl;
+  if ( maximumDifference > tolerance )
+    {
+    std::cerr << description << ": the maximum difference is greater than " << tolerance << std::endl;
+    return false;
+    }
+  return true;
+}
+
+// With the default parameters and a small variance, the output must be
+// exactly that of the previous implementation, which chained one
+// NeighborhoodOperatorImageFilter per dimension with images of the output
+// pixel type in between.
+template< typename TPixel >
+bool
+CheckPreviousImplementation( const ImageType * input, double variance, const char * description )
+{
+  using PixelImageType = itk::Image< TPixel, Dimension >;
+  using PixelFilterType = itk::DiscreteGaussianImageFilter< PixelImageType, PixelImageType >;
+
+  typename PixelImageType::Pointer image = PixelImageType::New();
+  image->SetRegions( input->GetLargestPossibleRegion() );
+  image->Allocate();
+  itk::ImageRegionConstIterator< ImageType > inputIt( input, input->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< PixelImageType > imageIt( image, image->GetLargestPossibleRegion() );
+  for ( ; !inputIt.IsAtEnd(); ++inputIt, ++imageIt )
+    {
+    imageIt.Set( static_cast< TPixel >( 100.0 * inputIt.Get() ) );
+    }
+
+  typename PixelFilterType::Pointer filter = PixelFilterType::New();
+  filter->SetInput( image );
+  filter->SetVariance( variance );
+  filter->Update();
+
+  const typename PixelImageType::Pointer expected = ConvolveWithGaussianOperator< PixelImageType >(
+    image, variance, filter->GetMaximumError()[0], filter->GetMaximumKernelWidth() );
+  return CheckDifference< PixelImageType >( expected, filter->GetOutput(), 0.0, description );
+}
+}
+
+int itkDiscreteGaussianImageFilterAlgorithmTest(int, char * [])
+{
+  ImageType::Pointer input = CreateRandomImage();
+
+  FilterType::Pointer filter = FilterType::New();
+  TEST_SET_GET_VALUE( FilterType::AUTOMATIC, filter->GetAlgorithm() );
+  filter->SetAlgorithm( FilterType::FFT );
+  TEST_SET_GET_VALUE( FilterType::FFT, filter->GetAlgorithm() );
+  filter->SetUseImageSpacing( false );
+
+  bool pass = true;
+
+  pass &= CheckPreviousImplementation< double >( input, 2.0, "Previous implementation, double" );
+  pass &= CheckPreviousImplementation< float >( input, 2.0, "Previous implementation, float" );
+  pass &= CheckPreviousImplementation< unsigned char >( input, 1.5, "Previous implementation, unsigned char" );
+
+  // Small kernels are convolved directly, in tiles, like the
+  // GaussianOperator.
+  filter->SetVariance( 2.0 );
+  ImageType::Pointer expected = ConvolveWithGaussianOperator< ImageType >( input, 2.0, 0.01, 32 );
+  ImageType::Pointer direct = Smooth( filter, input, FilterType::DIRECT );
+  pass &= CheckDifference< ImageType >( expected, direct, 1e-12, "Direct" );
+  pass &= CheckDifference< ImageType >( direct, Smooth( filter, input, FilterType::AUTOMATIC ), 0.0,
+    "Automatic, small kernel" );
+  pass &= CheckDifference< ImageType >( direct, Smooth( filter, input, FilterType::AUTOMATIC, 1, 7 ), 0.0,
+                           "Automatic, small kernel, streamed" );
+  FilterType::AlgorithmArrayType algorithms;
+  FilterType::InputSizeType radius;
+  algorithms.Fill( FilterType::DIRECT );
+  radius.Fill( OperatorRadius( 2.0, 0.01, 32 ) );
+  pass &= CheckKernels( filter, input, algorithms, radius, 0, "Automatic kernels, small kernel" );
+
+  // Kernels larger than MaximumKernelWidth are not truncated anymore. For
+  // this variance, the recursive filter is accurate enough.
+  filter->SetVariance( 50.0 );
+  filter->SetMaximumKernelWidth( 8 );
+  expected = ConvolveWithGaussianOperator< ImageType >( input, 50.0, 0.01, 1000 );
+  ImageType::Pointer recursive = Smooth( filter, input, FilterType::RECURSIVE );
+  pass &= CheckDifference< ImageType >( expected, recursive, 0.01, "Recursive" );
+  pass &= CheckDifference< ImageType >( recursive, Smooth( filter, input, FilterType::AUTOMATIC ), 0.0,
+                           "Automatic, recursive kernel" );
+  pass &= CheckDifference< ImageType >( recursive, Smooth( filter, input, FilterType::RECURSIVE, 2, 5 ), 0.01,
+                           "Recursive, streamed" );
+  Smooth( filter, input, FilterType::AUTOMATIC );
+  algorithms.Fill( FilterType::RECURSIVE );
+  radius.Fill( OperatorRadius( 50.0, 0.01, 1000 ) );
+  pass &= CheckKernels( filter, input, algorithms, radius, 1, "Automatic kernels, recursive kernel" );
+
+  // With a lower maximum error, the transfer function of the discrete
+  // Gaussian is applied instead.
+  filter->SetMaximumError( 0.001 );
+  expected = ConvolveWithGaussianOperator< ImageType >( input, 50.0, 0.001, 1000 );
+  ImageType::Pointer fft = Smooth( filter, input, FilterType::FFT );
+  pass &= CheckDifference< ImageType >( expected, fft, 0.002, "FFT" );
+  pass &= CheckDifference< ImageType >( fft, Smooth( filter, input, FilterType::AUTOMATIC ), 0.0,
+    "Automatic, FFT kernel" );
+  pass &= CheckDifference< ImageType >( fft, Smooth( filter, input, FilterType::FFT, 2, 5 ), 0.002, "FFT, streamed" );
+  Smooth( filter, input, FilterType::AUTOMATIC );
+  algorithms.Fill( FilterType::FFT );
+  radius.Fill( OperatorRadius( 50.0, 0.001, 1000 ) );
+  pass &= CheckKernels( filter, input, algorithms, radius, 1, "Automatic kernels, FFT kernel" );
+
+  // Mixed algorithms, and dimensions left unfiltered.
+  FilterType::ArrayType variance;
+  variance[0] = 50.0;
+  variance[1] = 1.0;
+  variance[2] = 3.0;
+  filter->SetVariance( variance );
+  filter->SetMaximumError( 0.01 );
+  filter->SetFilterDimensionality( 2 );
+  ImageType::Pointer mixed = Smooth( filter, input, FilterType::AUTOMATIC );
+  expected = ConvolveWithGaussianOperator< ImageType >( input, variance, 0.01, 1000, 2 );
+  pass &= CheckDifference< ImageType >( expected, mixed, 0.01, "Mixed" );
+  pass &= CheckDifference< ImageType >( mixed, Smooth( filter, input, FilterType::AUTOMATIC, 1, 4 ), 0.01, "Mixed, streamed" );
+  algorithms[0] = FilterType::RECURSIVE;
+  algorithms[1] = FilterType::DIRECT;
+  algorithms[2] = FilterType::DIRECT;
+  radius[0] = OperatorRadius( 50.0, 0.01, 1000 );
+  radius[1] = OperatorRadius( 1.0, 0.01, 8 );
+  radius[2] = 0;
+  pass &= CheckKernels( filter, input, algorithms, radius, 1, "Automatic kernels, mixed" );
+
+  filter->SetFilterDimensionality( 0 );
+  pass &= CheckDifference< ImageType >( input, Smooth( filter, input, FilterType::AUTOMATIC ), 0.0, "No filtered dimension" );
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMedianImageFilter.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+#include <vector>
+
+// Compare the median computed by each method of MedianImageFilter, which
+// is chosen from the pixel type and the radius, to the median of every
+// neighborhood computed by sorting it.
+namespace
+{
+template< typename TImage >
+typename TImage::Pointer MakeRandomImage(const typename TImage::RegionType & region)
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  using PixelType = typename TImage::PixelType;
+  unsigned int state = 12345;
+  itk::ImageRegionIterator< TImage > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    state = state * 1664525u + 1013904223u;
+    // Few distinct values, so that there are ties
+    const int value = static_cast< int >( ( state >> 16 ) % 200 ) - 60;
+    it.Set( static_cast< PixelType >( std::is_signed< PixelType >::value ? value * 0.75 : value + 60 ) );
+    }
+  return image;
+}
+
+template< typename TImage >
+int TestMedian(const typename TImage::RegionType & region, const typename TImage::SizeType & radius)
+{
+  typename TImage::Pointer image = MakeRandomImage< TImage >( region );
+
+  using FilterType = itk::MedianImageFilter< TImage, TImage >;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetRadius( radius );
+  filter->SetNumberOfWorkUnits( 5 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  using PixelType = typename TImage::PixelType;
+  std::vector< PixelType > pixels;
+  itk::ConstNeighborhoodIterator< TImage > nit( radius, image, region );
+  itk::ImageRegionConstIterator< TImage >  it( filter->GetOutput(), region );
+  for ( ; !nit.IsAtEnd(); ++nit, ++it )
+    {
+    pixels.resize( nit.Size() );
+    for ( unsigned int i = 0; i < nit.Size(); ++i )
+      {
+      pixels[i] = nit.GetPixel(i);
+      }
+    std::sort( pixels.begin(), pixels.end() );
+    if ( it.Get() != pixels[pixels.size() / 2] )
+      {
+      std::cerr << "Radius " << radius << ": median at " << it.GetIndex() << " is "
+                << static_cast< double >( it.Get() ) << " instead of "
+                << static_cast< double >( pixels[pixels.size() / 2] ) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkMedianImageFilterMethodsTest(int, char* [] )
+{
+  using UCharImage2DType = itk::Image< unsigned char, 2 >;
+  using SCharImage2DType = itk::Image< signed char, 2 >;
+  using DoubleImage2DType = itk::Image< double, 2 >;
+  using FloatImage3DType = itk::Image< float, 3 >;
+  using ShortImage3DType = itk::Image< short, 3 >;
+  using UCharImage3DType = itk::Image< unsigned char, 3 >;
+
+  UCharImage2DType::RegionType region2D;
+  region2D.SetIndex( { { 5, -3 } } );
+  region2D.SetSize( { { 150, 23 } } );
+  ShortImage3DType::RegionType region3D;
+  region3D.SetIndex( { { -2, 0, 7 } } );
+  region3D.SetSize( { { 37, 12, 9 } } );
+
+  // Median selection network
+  TEST_EXPECT_EQUAL( TestMedian< UCharImage2DType >( region2D, { { 1, 1 } } ), EXIT_SUCCESS );
+  TEST_EXPECT_EQUAL( TestMedian< SCharImage2DType >( region2D, { { 2, 2 } } ), EXIT_SUCCESS );
+  TEST_EXPECT_EQUAL( TestMedian< SCharImage2DType >( region2D, { { 0, 0 } } ), EXIT_SUCCESS );
+  TEST_EXPECT_EQUAL( TestMedian< FloatImage3DType >( region3D, { { 1, 1, 1 } } ), EXIT_SUCCESS );
+
+  // Sliding histogram
+  TEST_EXPECT_EQUAL( TestMedian< ShortImage3DType >( region3D, { { 2, 1, 3 } } ), EXIT_SUCCESS );
+  TEST_EXPECT_EQUAL( TestMedian< UCharImage3DType >( region3D, { { 3, 3, 3 } } ), EXIT_SUCCESS );
+  TEST_EXPECT_EQUAL( TestMedian< UCharImage2DType >( region2D, { { 40, 2 } } ), EXIT_SUCCESS );
+
+  // Partial sort of every neighborhood
+  TEST_EXPECT_EQUAL( TestMedian< DoubleImage2DType >( region2D, { { 3, 2 } } ), EXIT_SUCCESS );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
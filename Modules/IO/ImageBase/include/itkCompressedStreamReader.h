@@ -0,0 +1,155 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkCompressedStreamReader_h
+#define itkCompressedStreamReader_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkImageIORegion.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class CompressedStreamReader
+ * \brief Random access reading of gzip or zlib compressed data.
+ *
+ * Compressed streams can only be decompressed from their beginning, so
+ * reading a region from the end of a large compressed file normally costs
+ * as much as reading the whole file. This class records checkpoints while
+ * it decompresses: at the first deflate block boundary after every
+ * CheckpointSpacing uncompressed bytes it stores the position in the
+ * compressed file and the last 32 KiB of uncompressed data, which is all
+ * the state needed to resume decompression from there. The index is built
+ * during the first pass over the data, and later reads start from the
+ * closest checkpoint before the requested offset, so that each read
+ * decompresses at most CheckpointSpacing bytes more than it returns.
+ * Reads which continue where the previous one stopped do not restart at
+ * all.
+ *
+ * The index costs 32 KiB of memory per checkpoint; with the default
+ * spacing of 16 MiB this is 40 MiB for a 20 GiB image.
+ *
+ * Concatenated gzip members, as written e.g. by BGZF or parallel gzip
+ * tools, are read as one stream.
+ *
+ * This class is not thread safe.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT CompressedStreamReader : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(CompressedStreamReader);
+
+  /** Standard class type aliases. */
+  using Self = CompressedStreamReader;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(CompressedStreamReader, Object);
+
+  /** Set/Get the name of the file and the position in the file at which
+   * the compressed stream starts. The index is discarded when either
+   * changes, or when the modification time or the length of the file are
+   * no longer those it was built for. */
+  void SetFileName(const std::string & fileName);
+  itkGetStringMacro(FileName);
+  void SetDataOffset(SizeValueType offset);
+  itkGetConstMacro(DataOffset, SizeValueType);
+
+  /** Set/Get the minimum number of uncompressed bytes between two
+   * checkpoints. Changing it discards the index. Defaults to 16 MiB. */
+  void SetCheckpointSpacing(SizeValueType spacing);
+  itkGetConstMacro(CheckpointSpacing, SizeValueType);
+
+  /** Copy numberOfBytes uncompressed bytes, starting at
+   * uncompressedOffset, into buffer. Throws an ExceptionObject when the
+   * file cannot be read, is corrupted, or ends before the requested
+   * range. */
+  void Read(void *buffer, SizeValueType uncompressedOffset, SizeValueType numberOfBytes);
+
+  /** Read an N-dimensional region of an uncompressed array of pixels of
+   * pixelSize bytes, stored with the first dimension varying fastest and
+   * starting at uncompressedOffset. The pixels are written to buffer
+   * contiguously in the same order. Runs of consecutive rows are read
+   * with a single call to Read(). */
+  void ReadRegion(void *buffer,
+                  SizeValueType uncompressedOffset,
+                  const std::vector< SizeValueType > & dimensions,
+                  const ImageIORegion & region,
+                  SizeValueType pixelSize);
+
+  /** Number of checkpoints in the index. */
+  SizeValueType GetNumberOfCheckpoints() const;
+
+  /** Total number of bytes decompressed since construction, including
+   * bytes which were decompressed only to reach a requested offset. */
+  itkGetConstMacro(NumberOfDecompressedBytes, SizeValueType);
+
+  /** Whether the data at offset in the file starts with a gzip or a zlib
+   * header. */
+  static bool IsCompressed(const std::string & fileName, SizeValueType offset = 0);
+
+protected:
+  CompressedStreamReader();
+  ~CompressedStreamReader() override;
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  struct Checkpoint;
+  struct Internals;
+
+  /** Discard the index and close the file. */
+  void Reset();
+
+  /** Open the file if needed and check that it did not change. */
+  void OpenFile();
+
+  /** Restart decompression at the beginning of the stream, or at the
+   * given checkpoint. */
+  void RestartAtBeginning();
+  void RestartAt(const Checkpoint & checkpoint);
+
+  /** Decompress until numberOfBytes bytes starting at uncompressedOffset
+   * have been copied to buffer, recording checkpoints on the way. */
+  void Inflate(char *buffer, SizeValueType uncompressedOffset, SizeValueType numberOfBytes);
+
+  /** Make input available to the decompressor. Returns false at the end
+   * of the file. */
+  bool FillInput();
+
+  std::string   m_FileName;
+  SizeValueType m_DataOffset{ 0 };
+  SizeValueType m_CheckpointSpacing{ SizeValueType( 16 ) << 20 };
+  SizeValueType m_NumberOfDecompressedBytes{ 0 };
+
+  std::unique_ptr< Internals > m_Internals;
+};
+} // end namespace itk
+
+#endif // itkCompressedStreamReader_h
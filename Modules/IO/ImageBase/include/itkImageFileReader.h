@@ -118,6 +118,22 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the output buffer is mapped from the file instead of
+   * being read into newly allocated memory. The pixels are then only
+   * read from disk when they are first accessed, and pages which are not
+   * accessed are never read. The mapping is copy-on-write: the output may be
+   * modified, for instance by an in-place filter, without changing the file.
+   * It is released when the pixel container of the output is.
+   *
+   * This is used when the ImageIO can memory map the file (see
+   * ImageIOBase::CanMemoryMapRead()), the pixel type of the file is the
+   * pixel type of the output, and the requested region is a contiguous,
+   * aligned range of the file. Otherwise the file is read as usual.
+   * Off by default. */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
 protected:
   ImageFileReader();
   ~ImageFileReader() override;
@@ -147,6 +163,11 @@ protected:
   /** Does the real work. */
   void GenerateData() override;
 
+  /** Make the output buffer a mapping of the pixels of m_ActualIORegion in
+   * the file. Returns false, leaving the output untouched, when they cannot
+   * be mapped. */
+  bool MemoryMapOutput();
+
   ImageIOBase::Pointer m_ImageIO;
 
   bool m_UserSpecifiedImageIO; // keep track whether the
@@ -154,6 +175,8 @@ protected:
 
   bool m_UseStreaming;
 
+  bool m_UseMemoryMapping;
+
 private:
   std::string m_ExceptionMessage;
 
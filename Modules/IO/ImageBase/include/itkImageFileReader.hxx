@@ -24,6 +24,7 @@
 #include "itkConvertPixelBuffer.h"
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
+#include "itkMemoryMappedFileAllocator.h"
 
 #include "itksys/SystemTools.hxx"
 #include <fstream>
@@ -38,6 +39,7 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   this->SetFileName("");
   m_UserSpecifiedImageIO = false;
   m_UseStreaming = true;
+  m_UseMemoryMapping = false;
 }
 
 template< typename TOutputImage, typename ConvertPixelTraits >
@@ -54,6 +56,7 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "m_UseMemoryMapping: " << m_UseMemoryMapping << "\n";
 }
 
 template< typename TOutputImage, typename ConvertPixelTraits >
@@ -367,6 +370,12 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
                  << "Allocating the buffer with the EnlargedRequestedRegion \n"
                  << output->GetRequestedRegion() << "\n");
 
+  if ( m_UseMemoryMapping && this->MemoryMapOutput() )
+    {
+    this->UpdateProgress( 1.0f );
+    return;
+    }
+
   // allocated the output image to the size of the enlarge requested region
   this->AllocateOutputs();
 
@@ -475,6 +484,90 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
   loadBuffer = nullptr;
 }
 
+template< typename TOutputImage, typename ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::MemoryMapOutput()
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  // The pixels of the file must be those of the output, without conversion
+  const ImageIOBase::IOComponentType ioType =
+    ImageIOBase::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
+  const SizeValueType pixelSize = m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  const SizeValueType numberOfPixels = output->GetRequestedRegion().GetNumberOfPixels();
+  if ( m_ImageIO->GetComponentType() != ioType
+       || m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents()
+       || pixelSize != sizeof( OutputImagePixelType )
+       || m_ActualIORegion.GetNumberOfPixels() != numberOfPixels
+       || numberOfPixels == 0 )
+    {
+    return false;
+    }
+
+  m_ImageIO->SetFileName( this->GetFileName().c_str() );
+  m_ImageIO->SetIORegion( m_ActualIORegion );
+  std::string   dataFileName;
+  SizeValueType dataOffset = 0;
+  if ( !m_ImageIO->CanMemoryMapRead( dataFileName, dataOffset ) )
+    {
+    return false;
+    }
+
+  // The region must be one range of the file: once it is smaller than the
+  // file along a dimension, it must be a single slice along the higher ones
+  SizeValueType startPixel = 0;
+  SizeValueType stride = 1;
+  bool          partial = false;
+  for ( unsigned int i = 0; i < m_ImageIO->GetNumberOfDimensions(); ++i )
+    {
+    const SizeValueType dimension = m_ImageIO->GetDimensions(i);
+    SizeValueType       index = 0;
+    SizeValueType       size = 1;
+    if ( i < m_ActualIORegion.GetImageDimension() )
+      {
+      index = static_cast< SizeValueType >( m_ActualIORegion.GetIndex(i) );
+      size = static_cast< SizeValueType >( m_ActualIORegion.GetSize(i) );
+      }
+    if ( partial && size != 1 )
+      {
+      return false;
+      }
+    partial = partial || size != dimension;
+    startPixel += index * stride;
+    stride *= dimension;
+    }
+
+  const SizeValueType fileOffset = dataOffset + startPixel * pixelSize;
+  if ( fileOffset % alignof( OutputImagePixelType ) != 0 )
+    {
+    return false;
+    }
+
+  MemoryMappedFileAllocator::Pointer allocator = MemoryMappedFileAllocator::New();
+  allocator->SetFileName( dataFileName );
+  allocator->SetFileOffset( fileOffset );
+  void *buffer;
+  try
+    {
+    buffer = allocator->Allocate( numberOfPixels * pixelSize );
+    }
+  catch ( ExceptionObject & err )
+    {
+    itkDebugMacro(<< "Memory mapping failed, reading instead: " << err.GetDescription());
+    return false;
+    }
+
+  itkDebugMacro(<< "Mapping " << numberOfPixels << " pixels of " << dataFileName
+                << " at offset " << fileOffset);
+
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  typename TOutputImage::PixelContainerPointer container = TOutputImage::PixelContainer::New();
+  container->ImportAllocatedBuffer( static_cast< OutputImagePixelType * >( buffer ), numberOfPixels, allocator );
+  output->SetPixelContainer( container );
+  return true;
+}
+
 template< typename TOutputImage, typename ConvertPixelTraits >
 void
 ImageFileReader< TOutputImage, ConvertPixelTraits >
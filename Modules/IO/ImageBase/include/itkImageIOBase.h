@@ -349,6 +349,18 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer) = 0;
 
+  /** Determine if the pixels of the file, whose header has been read,
+   * are stored uncompressed, in the byte order of this machine and in the
+   * layout of an ITK pixel buffer, so that the buffer can be mapped from
+   * the file instead of being read with Read(). If so, return the name of
+   * the file holding the pixels and the position of the first one in it.
+   * Default is false.
+   * \sa ImageFileReader::SetUseMemoryMapping() */
+  virtual bool CanMemoryMapRead(std::string & itkNotUsed(dataFileName), SizeValueType & itkNotUsed(dataOffset))
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
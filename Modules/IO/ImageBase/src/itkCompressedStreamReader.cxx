@@ -0,0 +1,566 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkCompressedStreamReader.h"
+#include "itkInternationalizationIOHelpers.h"
+#include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+/** Largest distance of a deflate back reference. */
+constexpr unsigned int WindowSize = 32768;
+
+/** Size of the buffer of compressed input. */
+constexpr unsigned int InputBufferSize = 65536;
+
+/** windowBits argument of inflateInit2 which accepts a gzip or a zlib
+ * header, and of a raw deflate stream. */
+constexpr int AutomaticHeaderWindowBits = 15 + 32;
+constexpr int RawDeflateWindowBits = -15;
+}
+
+namespace itk
+{
+struct CompressedStreamReader::Checkpoint
+{
+  /** Offset of the first byte decompressed after the checkpoint. */
+  SizeValueType uncompressedOffset;
+
+  /** Number of compressed bytes, counted from the data offset, which were
+   * consumed by the decompressor at the checkpoint. */
+  SizeValueType compressedOffset;
+
+  /** Number of bits of the last consumed byte which belong to the next
+   * deflate block. */
+  int bits;
+
+  /** Whether the member being decompressed has a gzip header, which
+   * determines the size of its trailer. */
+  bool gzip;
+
+  /** Uncompressed data preceding the checkpoint, at most WindowSize bytes. */
+  std::vector< unsigned char > window;
+};
+
+struct CompressedStreamReader::Internals
+{
+  Internals()
+  {
+    std::memset( &stream, 0, sizeof( stream ) );
+  }
+
+  ~Internals()
+  {
+    EndStream();
+  }
+
+  void EndStream()
+  {
+    if ( streamInitialized )
+      {
+      inflateEnd( &stream );
+      streamInitialized = false;
+      }
+  }
+
+  std::vector< Checkpoint > checkpoints;
+
+  std::unique_ptr< i18n::I18nIfstream > file;
+  long                                  modifiedTime{ 0 };
+  unsigned long                         fileLength{ 0 };
+
+  z_stream stream;
+  bool     streamInitialized{ false };
+
+  /** The decompressor was restarted from a checkpoint and decodes raw
+   * deflate data, so that it does not check the trailer of the member. */
+  bool rawDeflate{ false };
+  bool gzip{ false };
+
+  /** No output was produced since the start of the current member. */
+  bool atMemberStart{ false };
+  bool endOfData{ false };
+
+  /** Uncompressed offset of the next byte produced by the decompressor. */
+  SizeValueType position{ 0 };
+
+  /** Number of compressed bytes read from the file, from the data offset. */
+  SizeValueType inputPosition{ 0 };
+
+  std::vector< unsigned char > input = std::vector< unsigned char >( InputBufferSize );
+
+  /** Ring buffer holding the last WindowSize uncompressed bytes. */
+  std::vector< unsigned char > window = std::vector< unsigned char >( WindowSize );
+  SizeValueType                windowPosition{ 0 };
+  SizeValueType                windowFill{ 0 };
+};
+
+CompressedStreamReader
+::CompressedStreamReader() :
+  m_Internals( new Internals )
+{}
+
+CompressedStreamReader
+::~CompressedStreamReader() = default;
+
+void
+CompressedStreamReader
+::SetFileName(const std::string & fileName)
+{
+  const long          modifiedTime = itksys::SystemTools::ModifiedTime( fileName );
+  const unsigned long fileLength = itksys::SystemTools::FileLength( fileName );
+  if ( fileName != m_FileName
+       || modifiedTime != m_Internals->modifiedTime
+       || fileLength != m_Internals->fileLength )
+    {
+    this->Reset();
+    m_FileName = fileName;
+    m_Internals->modifiedTime = modifiedTime;
+    m_Internals->fileLength = fileLength;
+    this->Modified();
+    }
+}
+
+void
+CompressedStreamReader
+::SetDataOffset(SizeValueType offset)
+{
+  if ( offset != m_DataOffset )
+    {
+    this->Reset();
+    m_DataOffset = offset;
+    this->Modified();
+    }
+}
+
+void
+CompressedStreamReader
+::SetCheckpointSpacing(SizeValueType spacing)
+{
+  spacing = std::max( spacing, static_cast< SizeValueType >( WindowSize ) );
+  if ( spacing != m_CheckpointSpacing )
+    {
+    this->Reset();
+    m_CheckpointSpacing = spacing;
+    this->Modified();
+    }
+}
+
+SizeValueType
+CompressedStreamReader
+::GetNumberOfCheckpoints() const
+{
+  return m_Internals->checkpoints.size();
+}
+
+void
+CompressedStreamReader
+::Reset()
+{
+  m_Internals->EndStream();
+  m_Internals->checkpoints.clear();
+  m_Internals->file.reset();
+}
+
+void
+CompressedStreamReader
+::OpenFile()
+{
+  if ( m_Internals->file )
+    {
+    return;
+    }
+  if ( m_FileName.empty() )
+    {
+    itkExceptionMacro( "No file name specified" );
+    }
+  // Reading an index built for another version of the file would silently
+  // return wrong data
+  this->SetFileName( m_FileName );
+
+  m_Internals->file.reset( new i18n::I18nIfstream( m_FileName.c_str(), std::ios::in | std::ios::binary ) );
+  if ( m_Internals->file->fail() )
+    {
+    m_Internals->file.reset();
+    itkExceptionMacro( "Could not open file " << m_FileName << " for reading: "
+                       << itksys::SystemTools::GetLastSystemError() );
+    }
+}
+
+bool
+CompressedStreamReader
+::FillInput()
+{
+  Internals & internals = *m_Internals;
+  internals.file->read( reinterpret_cast< char * >( internals.input.data() ), InputBufferSize );
+  const auto numberOfBytes = static_cast< SizeValueType >( internals.file->gcount() );
+  if ( numberOfBytes == 0 )
+    {
+    return false;
+    }
+  internals.stream.next_in = internals.input.data();
+  internals.stream.avail_in = static_cast< uInt >( numberOfBytes );
+  internals.inputPosition += numberOfBytes;
+  return true;
+}
+
+void
+CompressedStreamReader
+::RestartAtBeginning()
+{
+  Internals & internals = *m_Internals;
+  internals.EndStream();
+  std::memset( &internals.stream, 0, sizeof( internals.stream ) );
+  if ( inflateInit2( &internals.stream, AutomaticHeaderWindowBits ) != Z_OK )
+    {
+    itkExceptionMacro( "Could not initialize zlib: " << internals.stream.msg );
+    }
+  internals.streamInitialized = true;
+  internals.rawDeflate = false;
+  internals.atMemberStart = true;
+  internals.endOfData = false;
+  internals.position = 0;
+  internals.windowPosition = 0;
+  internals.windowFill = 0;
+
+  internals.file->clear();
+  internals.file->seekg( static_cast< std::streamoff >( m_DataOffset ) );
+  internals.inputPosition = 0;
+  if ( !this->FillInput() )
+    {
+    itkExceptionMacro( "No compressed data in " << m_FileName << " at offset " << m_DataOffset );
+    }
+  internals.gzip = internals.stream.avail_in >= 2 && internals.input[0] == 0x1f && internals.input[1] == 0x8b;
+}
+
+void
+CompressedStreamReader
+::RestartAt(const Checkpoint & checkpoint)
+{
+  Internals & internals = *m_Internals;
+  internals.EndStream();
+  std::memset( &internals.stream, 0, sizeof( internals.stream ) );
+  if ( inflateInit2( &internals.stream, RawDeflateWindowBits ) != Z_OK )
+    {
+    itkExceptionMacro( "Could not initialize zlib: " << internals.stream.msg );
+    }
+  internals.streamInitialized = true;
+  internals.rawDeflate = true;
+  internals.gzip = checkpoint.gzip;
+  internals.atMemberStart = false;
+  internals.endOfData = false;
+
+  // The first bits of the next block are the high bits of the last byte
+  // consumed before the checkpoint
+  internals.file->clear();
+  internals.inputPosition = checkpoint.compressedOffset - ( checkpoint.bits ? 1 : 0 );
+  internals.file->seekg( static_cast< std::streamoff >( m_DataOffset + internals.inputPosition ) );
+  if ( !this->FillInput() )
+    {
+    itkExceptionMacro( "Unexpected end of file " << m_FileName );
+    }
+  if ( checkpoint.bits )
+    {
+    const int partialByte = *internals.stream.next_in;
+    ++internals.stream.next_in;
+    --internals.stream.avail_in;
+    inflatePrime( &internals.stream, checkpoint.bits, partialByte >> ( 8 - checkpoint.bits ) );
+    }
+  inflateSetDictionary( &internals.stream, checkpoint.window.data(), static_cast< uInt >( checkpoint.window.size() ) );
+
+  std::copy( checkpoint.window.begin(), checkpoint.window.end(), internals.window.begin() );
+  internals.windowFill = checkpoint.window.size();
+  internals.windowPosition = internals.windowFill % WindowSize;
+  internals.position = checkpoint.uncompressedOffset;
+}
+
+void
+CompressedStreamReader
+::Inflate(char *buffer, SizeValueType uncompressedOffset, SizeValueType numberOfBytes)
+{
+  Internals &         internals = *m_Internals;
+  z_stream &          stream = internals.stream;
+  const SizeValueType end = uncompressedOffset + numberOfBytes;
+
+  while ( internals.position < end )
+    {
+    if ( internals.endOfData )
+      {
+      itkExceptionMacro( "The compressed data of " << m_FileName << " ends at uncompressed offset "
+                         << internals.position << ", before the end of the requested range at " << end );
+      }
+    if ( stream.avail_in == 0 && !this->FillInput() )
+      {
+      itkExceptionMacro( "Unexpected end of file " << m_FileName );
+      }
+
+    // Stop at the end of the requested range, so that a following read of
+    // the next range continues the stream
+    unsigned char * const out = internals.window.data() + internals.windowPosition;
+    const auto            outSize = static_cast< uInt >(
+      std::min( WindowSize - internals.windowPosition, end - internals.position ) );
+    stream.next_out = out;
+    stream.avail_out = outSize;
+
+    // Z_BLOCK returns at each deflate block boundary, where checkpoints can
+    // be taken
+    const int result = inflate( &stream, Z_BLOCK );
+    if ( result == Z_DATA_ERROR && internals.atMemberStart && internals.position > 0 )
+      {
+      // Padding after the last member
+      internals.endOfData = true;
+      continue;
+      }
+    if ( result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR )
+      {
+      itkExceptionMacro( "Corrupted compressed data in " << m_FileName << ": "
+                         << ( stream.msg ? stream.msg : "zlib error" ) );
+      }
+
+    const SizeValueType produced = outSize - stream.avail_out;
+    if ( produced > 0 )
+      {
+      const SizeValueType copyBegin = std::max( internals.position, uncompressedOffset );
+      const SizeValueType copyEnd = std::min( internals.position + produced, end );
+      if ( copyBegin < copyEnd )
+        {
+        std::memcpy( buffer + ( copyBegin - uncompressedOffset ),
+                     out + ( copyBegin - internals.position ),
+                     copyEnd - copyBegin );
+        }
+      internals.atMemberStart = false;
+      internals.position += produced;
+      internals.windowPosition = ( internals.windowPosition + produced ) % WindowSize;
+      internals.windowFill = std::min( internals.windowFill + produced, static_cast< SizeValueType >( WindowSize ) );
+      m_NumberOfDecompressedBytes += produced;
+      }
+
+    if ( result == Z_STREAM_END )
+      {
+      // A gzip or zlib member ends; skip the trailer of members restarted as
+      // raw deflate streams, and continue with the next member if any
+      if ( internals.rawDeflate )
+        {
+        SizeValueType trailerSize = internals.gzip ? 8 : 4;
+        while ( trailerSize > 0 )
+          {
+          if ( stream.avail_in == 0 && !this->FillInput() )
+            {
+            break;
+            }
+          const SizeValueType skipped = std::min( trailerSize, static_cast< SizeValueType >( stream.avail_in ) );
+          stream.next_in += skipped;
+          stream.avail_in -= static_cast< uInt >( skipped );
+          trailerSize -= skipped;
+          }
+        }
+      if ( stream.avail_in == 0 && !this->FillInput() )
+        {
+        internals.endOfData = true;
+        continue;
+        }
+      internals.gzip = stream.avail_in < 2 || ( stream.next_in[0] == 0x1f && stream.next_in[1] == 0x8b );
+      inflateReset2( &stream, AutomaticHeaderWindowBits );
+      internals.rawDeflate = false;
+      internals.atMemberStart = true;
+      continue;
+      }
+
+    // Bit 128 of data_type marks a block boundary, bit 64 the last block of
+    // a member, after which there is no block to restart from
+    const bool atBlockBoundary = ( stream.data_type & 128 ) && !( stream.data_type & 64 );
+    const SizeValueType lastCheckpoint =
+      internals.checkpoints.empty() ? 0 : internals.checkpoints.back().uncompressedOffset;
+    if ( atBlockBoundary && internals.position >= lastCheckpoint + m_CheckpointSpacing )
+      {
+      Checkpoint checkpoint;
+      checkpoint.uncompressedOffset = internals.position;
+      checkpoint.compressedOffset = internals.inputPosition - stream.avail_in;
+      checkpoint.bits = stream.data_type & 7;
+      checkpoint.gzip = internals.gzip;
+      const auto windowBegin = internals.window.begin();
+      if ( internals.windowFill < WindowSize )
+        {
+        checkpoint.window.assign( windowBegin, windowBegin + internals.windowFill );
+        }
+      else
+        {
+        checkpoint.window.assign( windowBegin + internals.windowPosition, internals.window.end() );
+        checkpoint.window.insert( checkpoint.window.end(), windowBegin, windowBegin + internals.windowPosition );
+        }
+      internals.checkpoints.push_back( std::move( checkpoint ) );
+      }
+    }
+}
+
+void
+CompressedStreamReader
+::Read(void *buffer, SizeValueType uncompressedOffset, SizeValueType numberOfBytes)
+{
+  if ( numberOfBytes == 0 )
+    {
+    return;
+    }
+  this->OpenFile();
+  Internals & internals = *m_Internals;
+
+  // Last checkpoint at or before the requested offset
+  const auto next = std::upper_bound( internals.checkpoints.begin(), internals.checkpoints.end(), uncompressedOffset,
+                                      [](SizeValueType offset, const Checkpoint & checkpoint)
+                                      {
+                                        return offset < checkpoint.uncompressedOffset;
+                                      } );
+  const Checkpoint * checkpoint = next == internals.checkpoints.begin() ? nullptr : &*( next - 1 );
+
+  // Continue the current stream unless a checkpoint is closer to the offset
+  const bool canContinue = internals.streamInitialized
+                           && internals.position <= uncompressedOffset
+                           && ( checkpoint == nullptr || checkpoint->uncompressedOffset <= internals.position );
+  if ( !canContinue )
+    {
+    if ( checkpoint )
+      {
+      this->RestartAt( *checkpoint );
+      }
+    else
+      {
+      this->RestartAtBeginning();
+      }
+    }
+
+  this->Inflate( static_cast< char * >( buffer ), uncompressedOffset, numberOfBytes );
+}
+
+void
+CompressedStreamReader
+::ReadRegion(void *buffer,
+             SizeValueType uncompressedOffset,
+             const std::vector< SizeValueType > & dimensions,
+             const ImageIORegion & region,
+             SizeValueType pixelSize)
+{
+  const auto numberOfDimensions = static_cast< unsigned int >( dimensions.size() );
+  if ( region.GetImageDimension() > numberOfDimensions )
+    {
+    itkExceptionMacro( "Region of dimension " << region.GetImageDimension()
+                       << " requested from an array of dimension " << numberOfDimensions );
+    }
+
+  // Dimensions which the region does not have are read at index 0
+  std::vector< SizeValueType > start( numberOfDimensions, 0 );
+  std::vector< SizeValueType > size( numberOfDimensions, 1 );
+  std::vector< SizeValueType > stride( numberOfDimensions );
+  SizeValueType                numberOfPixels = 1;
+  for ( unsigned int d = 0; d < numberOfDimensions; ++d )
+    {
+    if ( d < region.GetImageDimension() )
+      {
+      if ( region.GetIndex( d ) < 0
+           || static_cast< SizeValueType >( region.GetIndex( d ) ) + region.GetSize( d ) > dimensions[d] )
+        {
+        itkExceptionMacro( "Requested region " << region << " is outside of the array" );
+        }
+      start[d] = region.GetIndex( d );
+      size[d] = region.GetSize( d );
+      }
+    stride[d] = d == 0 ? pixelSize : stride[d - 1] * dimensions[d - 1];
+    numberOfPixels *= size[d];
+    }
+  if ( numberOfPixels == 0 )
+    {
+    return;
+    }
+
+  // Rows are merged into runs as long as the region spans the lower
+  // dimensions
+  SizeValueType runLength = pixelSize;
+  unsigned int  firstOuterDimension = 0;
+  while ( firstOuterDimension < numberOfDimensions )
+    {
+    runLength *= size[firstOuterDimension];
+    ++firstOuterDimension;
+    if ( size[firstOuterDimension - 1] != dimensions[firstOuterDimension - 1] )
+      {
+      break;
+      }
+    }
+
+  auto *                       out = static_cast< char * >( buffer );
+  std::vector< SizeValueType > index = start;
+  while ( true )
+    {
+    SizeValueType offset = uncompressedOffset;
+    for ( unsigned int d = 0; d < numberOfDimensions; ++d )
+      {
+      offset += index[d] * stride[d];
+      }
+    this->Read( out, offset, runLength );
+    out += runLength;
+
+    unsigned int d = firstOuterDimension;
+    for ( ; d < numberOfDimensions; ++d )
+      {
+      if ( ++index[d] < start[d] + size[d] )
+        {
+        break;
+        }
+      index[d] = start[d];
+      }
+    if ( d == numberOfDimensions )
+      {
+      return;
+      }
+    }
+}
+
+bool
+CompressedStreamReader
+::IsCompressed(const std::string & fileName, SizeValueType offset)
+{
+  i18n::I18nIfstream file( fileName.c_str(), std::ios::in | std::ios::binary );
+  if ( file.fail() )
+    {
+    return false;
+    }
+  file.seekg( static_cast< std::streamoff >( offset ) );
+  unsigned char header[2];
+  file.read( reinterpret_cast< char * >( header ), 2 );
+  if ( file.gcount() != 2 )
+    {
+    return false;
+    }
+  const bool gzipHeader = header[0] == 0x1f && header[1] == 0x8b;
+  const bool zlibHeader = ( header[0] & 0x0f ) == Z_DEFLATED && ( ( header[0] << 8 ) | header[1] ) % 31 == 0;
+  return gzipHeader || zlibHeader;
+}
+
+void
+CompressedStreamReader
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "DataOffset: " << m_DataOffset << std::endl;
+  os << indent << "CheckpointSpacing: " << m_CheckpointSpacing << std::endl;
+  os << indent << "NumberOfCheckpoints: " << this->GetNumberOfCheckpoints() << std::endl;
+  os << indent << "NumberOfDecompressedBytes: " << m_NumberOfDecompressedBytes << std::endl;
+}
+} // end namespace itk
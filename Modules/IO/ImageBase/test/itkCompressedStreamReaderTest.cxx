@@ -0,0 +1,195 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkCompressedStreamReader.h"
+#include "itkTestingMacros.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+using ByteVector = std::vector< unsigned char >;
+
+/** Compress data as one gzip (windowBits 31) or zlib (windowBits 15)
+ * member. */
+ByteVector Compress(const unsigned char * data, itk::SizeValueType size, int windowBits)
+{
+  z_stream stream{};
+  deflateInit2( &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY );
+  ByteVector compressed( deflateBound( &stream, size ) );
+  stream.next_in = const_cast< unsigned char * >( data );
+  stream.avail_in = static_cast< uInt >( size );
+  stream.next_out = compressed.data();
+  stream.avail_out = static_cast< uInt >( compressed.size() );
+  deflate( &stream, Z_FINISH );
+  compressed.resize( stream.total_out );
+  deflateEnd( &stream );
+  return compressed;
+}
+
+void WriteFile(const std::string & fileName, const ByteVector & header, const ByteVector & data)
+{
+  std::ofstream file( fileName.c_str(), std::ios::binary );
+  file.write( reinterpret_cast< const char * >( header.data() ), header.size() );
+  file.write( reinterpret_cast< const char * >( data.data() ), data.size() );
+}
+
+bool CheckRange(itk::CompressedStreamReader * reader, const ByteVector & data,
+                itk::SizeValueType offset, itk::SizeValueType size)
+{
+  ByteVector buffer( size );
+  reader->Read( buffer.data(), offset, size );
+  if ( !std::equal( buffer.begin(), buffer.end(), data.begin() + offset ) )
+    {
+    std::cerr << "Wrong data read from " << reader->GetFileName() << " at offset " << offset
+              << " with size " << size << std::endl;
+    return false;
+    }
+  return true;
+}
+
+int TestFile(const std::string & fileName, itk::SizeValueType dataOffset, const ByteVector & data)
+{
+  const itk::SizeValueType spacing = 1 << 16;
+
+  TEST_EXPECT_TRUE( itk::CompressedStreamReader::IsCompressed( fileName, dataOffset ) );
+
+  itk::CompressedStreamReader::Pointer reader = itk::CompressedStreamReader::New();
+  reader->SetFileName( fileName );
+  reader->SetDataOffset( dataOffset );
+  reader->SetCheckpointSpacing( spacing );
+
+  // Reading forward continues the stream, and builds the index
+  const itk::SizeValueType half = data.size() / 2;
+  TEST_EXPECT_TRUE( CheckRange( reader, data, 0, 1000 ) );
+  TEST_EXPECT_TRUE( CheckRange( reader, data, 5000, half - 5000 ) );
+  TEST_EXPECT_TRUE( CheckRange( reader, data, half, data.size() - half ) );
+  TEST_EXPECT_EQUAL( reader->GetNumberOfDecompressedBytes(), data.size() );
+  TEST_EXPECT_TRUE( reader->GetNumberOfCheckpoints() >= data.size() / spacing / 2 );
+
+  // Reading backward restarts at a checkpoint close to the offset
+  for ( unsigned int i = 0; i < 7; ++i )
+    {
+    const itk::SizeValueType offset = data.size() - 1000 - i * ( data.size() / 7 );
+    const itk::SizeValueType decompressedBefore = reader->GetNumberOfDecompressedBytes();
+    TEST_EXPECT_TRUE( CheckRange( reader, data, offset, 1000 ) );
+    const itk::SizeValueType decompressed = reader->GetNumberOfDecompressedBytes() - decompressedBefore;
+    if ( decompressed > 3 * spacing + 1000 )
+      {
+      std::cerr << "Decompressed " << decompressed << " bytes to read 1000 bytes at offset " << offset << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A region of a 64 x 64 x n array of 2 byte pixels
+  std::vector< itk::SizeValueType > dimensions = { 64, 64, data.size() / ( 64 * 64 * 2 ) };
+  itk::ImageIORegion                region( 3 );
+  region.SetIndex( { 3, 0, 5 } );
+  region.SetSize( { 50, 64, dimensions[2] - 10 } );
+  ByteVector regionBuffer( region.GetNumberOfPixels() * 2 );
+  reader->ReadRegion( regionBuffer.data(), 0, dimensions, region, 2 );
+  auto regionIt = regionBuffer.begin();
+  for ( itk::SizeValueType z = 5; z < dimensions[2] - 5; ++z )
+    {
+    for ( itk::SizeValueType y = 0; y < 64; ++y )
+      {
+      const auto row = data.begin() + 2 * ( ( z * 64 + y ) * 64 + 3 );
+      if ( !std::equal( row, row + 100, regionIt ) )
+        {
+        std::cerr << "Wrong region data at row " << y << " of slice " << z << std::endl;
+        return false;
+        }
+      regionIt += 100;
+      }
+    }
+
+  // Reading past the end of the data fails
+  ByteVector buffer( 10 );
+  TRY_EXPECT_EXCEPTION( reader->Read( buffer.data(), data.size() - 5, 10 ) );
+  TEST_EXPECT_TRUE( CheckRange( reader, data, data.size() - 100, 100 ) );
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkCompressedStreamReaderTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string outputDirectory = argv[1];
+
+  // Compressible data without long repetitions
+  ByteVector   data( 4 << 20 );
+  unsigned int state = 12345;
+  for ( auto & value : data )
+    {
+    state = state * 1103515245u + 12345u;
+    value = static_cast< unsigned char >( ( state >> 16 ) & 0x1f );
+    }
+
+  itk::CompressedStreamReader::Pointer reader = itk::CompressedStreamReader::New();
+  EXERCISE_BASIC_OBJECT_METHODS( reader, CompressedStreamReader, Object );
+
+  const std::string gzipFileName = outputDirectory + "/itkCompressedStreamReaderTest.gz";
+  WriteFile( gzipFileName, ByteVector(), Compress( data.data(), data.size(), 31 ) );
+  TEST_EXPECT_EQUAL( TestFile( gzipFileName, 0, data ), EXIT_SUCCESS );
+
+  // zlib stream after a header
+  const std::string zlibFileName = outputDirectory + "/itkCompressedStreamReaderTest.zlib";
+  WriteFile( zlibFileName, ByteVector( 348, 'h' ), Compress( data.data(), data.size(), 15 ) );
+  TEST_EXPECT_EQUAL( TestFile( zlibFileName, 348, data ), EXIT_SUCCESS );
+
+  // Concatenated gzip members
+  ByteVector               members;
+  const itk::SizeValueType memberSize = 300000;
+  for ( itk::SizeValueType offset = 0; offset < data.size(); offset += memberSize )
+    {
+    const ByteVector member =
+      Compress( data.data() + offset, std::min( memberSize, data.size() - offset ), 31 );
+    members.insert( members.end(), member.begin(), member.end() );
+    }
+  const std::string membersFileName = outputDirectory + "/itkCompressedStreamReaderTest2.gz";
+  WriteFile( membersFileName, ByteVector( 16, 'h' ), members );
+  TEST_EXPECT_EQUAL( TestFile( membersFileName, 16, data ), EXIT_SUCCESS );
+
+  // Uncompressed data is detected
+  const std::string rawFileName = outputDirectory + "/itkCompressedStreamReaderTest.raw";
+  WriteFile( rawFileName, ByteVector( 16, 0 ), data );
+  TEST_EXPECT_TRUE( !itk::CompressedStreamReader::IsCompressed( rawFileName ) );
+
+  // Rewriting the file discards the index
+  reader->SetFileName( gzipFileName );
+  reader->SetCheckpointSpacing( 1 << 16 );
+  TEST_EXPECT_TRUE( CheckRange( reader, data, data.size() - 1000, 1000 ) );
+  TEST_EXPECT_TRUE( reader->GetNumberOfCheckpoints() > 0 );
+  ByteVector data2( data.rbegin(), data.rend() );
+  WriteFile( gzipFileName, ByteVector( 7, 'h' ), Compress( data2.data(), data2.size(), 31 ) );
+  reader->SetFileName( gzipFileName );
+  TEST_EXPECT_EQUAL( reader->GetNumberOfCheckpoints(), 0u );
+  reader->SetDataOffset( 7 );
+  TEST_EXPECT_TRUE( CheckRange( reader, data2, 100000, 1000 ) );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMemoryMappedFileAllocator.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+
+// Read images with the output buffer mapped from the file, and check that
+// the reader falls back to reading when the file cannot be mapped.
+namespace
+{
+template< typename TImage >
+bool IsMapped(const TImage * image)
+{
+  return dynamic_cast< const itk::MemoryMappedFileAllocator * >(
+    image->GetPixelContainer()->GetImportPointerAllocator() ) != nullptr;
+}
+
+template< typename TImage >
+bool SameImages(const TImage * image1, const TImage * image2, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIterator< TImage > it1( image1, region );
+  itk::ImageRegionConstIterator< TImage > it2( image2, region );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if ( it1.Get() != it2.Get() )
+      {
+      std::cerr << "Pixels differ at " << it1.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TImage >
+typename TImage::Pointer MakeImage()
+{
+  typename TImage::SizeType size = { { 40, 30, 20 } };
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIterator< TImage > it( image, image->GetLargestPossibleRegion() );
+  typename TImage::PixelType value = 0;
+  for ( ; !it.IsAtEnd(); ++it, ++value )
+    {
+    it.Set( value );
+    }
+  return image;
+}
+
+template< typename TImage >
+int MapImage(const TImage * image, const std::string & fileName)
+{
+  using WriterType = itk::ImageFileWriter< TImage >;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetFileName( fileName );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  using ReaderType = itk::ImageFileReader< TImage >;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->SetImageIO( itk::MetaImageIO::New() );
+  TEST_SET_GET_BOOLEAN( reader, UseMemoryMapping, true );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( IsMapped< TImage >( reader->GetOutput() ) );
+  TEST_EXPECT_TRUE( SameImages< TImage >( image, reader->GetOutput(), image->GetLargestPossibleRegion() ) );
+
+  // The mapping is private: writing to the output does not change the file
+  typename TImage::Pointer mapped = reader->GetOutput();
+  mapped->DisconnectPipeline();
+  mapped->FillBuffer( 7 );
+
+  typename ReaderType::Pointer rereader = ReaderType::New();
+  rereader->SetFileName( fileName );
+  TRY_EXPECT_NO_EXCEPTION( rereader->Update() );
+  TEST_EXPECT_TRUE( !IsMapped< TImage >( rereader->GetOutput() ) );
+  TEST_EXPECT_TRUE( SameImages< TImage >( image, rereader->GetOutput(), image->GetLargestPossibleRegion() ) );
+
+  // A slab of slices is a contiguous range of the file
+  typename TImage::RegionType region = image->GetLargestPossibleRegion();
+  region.SetIndex( 2, 5 );
+  region.SetSize( 2, 4 );
+  reader->GetOutput()->SetRequestedRegion( region );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( IsMapped< TImage >( reader->GetOutput() ) );
+  TEST_EXPECT_TRUE( SameImages< TImage >( image, reader->GetOutput(), region ) );
+
+  // A region which does not span the lower dimensions is read instead.
+  // A new reader is used, since the buffer of the previous output would
+  // be reused.
+  region.SetIndex( { { 3, 4, 5 } } );
+  region.SetSize( { { 10, 11, 12 } } );
+  reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->UseMemoryMappingOn();
+  reader->GetOutput()->SetRequestedRegion( region );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( !IsMapped< TImage >( reader->GetOutput() ) );
+  TEST_EXPECT_TRUE( SameImages< TImage >( image, reader->GetOutput(), region ) );
+
+  // Compressed data is read instead
+  writer->UseCompressionOn();
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->UseMemoryMappingOn();
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( !IsMapped< TImage >( reader->GetOutput() ) );
+  TEST_EXPECT_TRUE( SameImages< TImage >( image, reader->GetOutput(), image->GetLargestPossibleRegion() ) );
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkImageFileReaderMemoryMappingTest(int argc, char* argv[])
+{
+  if ( argc != 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string outputDirectory = argv[1];
+
+  // The data of a .mhd file starts at the beginning of the .raw file
+  using ShortImageType = itk::Image< short, 3 >;
+  ShortImageType::Pointer shortImage = MakeImage< ShortImageType >();
+  TEST_EXPECT_EQUAL( MapImage< ShortImageType >( shortImage, outputDirectory + "/itkImageFileReaderMemoryMappingTest.mhd" ),
+                     EXIT_SUCCESS );
+
+  // The data of a .mha file follows the header, at an offset which bytes
+  // are aligned to
+  using CharImageType = itk::Image< unsigned char, 3 >;
+  CharImageType::Pointer charImage = MakeImage< CharImageType >();
+  TEST_EXPECT_EQUAL( MapImage< CharImageType >( charImage, outputDirectory + "/itkImageFileReaderMemoryMappingTest.mha" ),
+                     EXIT_SUCCESS );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 
 #include <fstream>
 #include "itkImageIOBase.h"
+#include "itkCompressedStreamReader.h"
 #include "metaObject.h"
 #include "metaImage.h"
 
@@ -121,17 +122,24 @@ public:
                            const ImageIORegion & largestPossibleRegion) override;
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
-   *  CanRead must be called prior to this function. */
+   *  file. Compressed data can be streamed unless it is split into
+   *  several files or its position in the file is given by a negative
+   *  HeaderSize. CanRead must be called prior to this function. */
   bool CanStreamRead() override
   {
     if ( m_MetaImage.CompressedData() )
       {
-      return false;
+      std::string   dataFileName;
+      SizeValueType dataOffset;
+      return this->GetDataLocation(dataFileName, dataOffset);
       }
     return true;
   }
 
+  /** Uncompressed binary data in the byte order of this machine, in the
+   * header file or in a single separate file, can be memory mapped. */
+  bool CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset) override;
+
   /** Determine if the ImageIO can stream writing to this
    *  file. Only time cannot stream read/write is if compression is used.
    *  Assumes file passes a CanRead call and its pixels are of the same
@@ -172,10 +180,20 @@ protected:
 
 private:
 
+  /** Find the file holding the data and the position at which it starts,
+   * for reading compressed regions through m_CompressedStreamReader and
+   * for memory mapping. Returns false for layouts which only MetaImage
+   * can read: lists of files, subsampling and data at the end of the file. */
+  bool GetDataLocation(std::string & dataFileName, SizeValueType & dataOffset) const;
+
   MetaImage m_MetaImage;
 
   unsigned int m_SubSamplingFactor;
 
+  // Keeps the index of the compressed data between the reads of a
+  // streamed pipeline
+  CompressedStreamReader::Pointer m_CompressedStreamReader;
+
   static unsigned int m_DefaultDoublePrecision;
 };
 } // end namespace itk
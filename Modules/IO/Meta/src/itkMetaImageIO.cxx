@@ -22,6 +22,7 @@
 #include "itkIOCommon.h"
 #include "itksys/SystemTools.hxx"
 #include "itkMath.h"
+#include "itkByteSwapper.h"
 
 namespace itk
 {
@@ -29,6 +30,54 @@ namespace itk
 // better accuracy when writing out floating point number in MetaImage header.
 unsigned int MetaImageIO::m_DefaultDoublePrecision = 17;
 
+namespace
+{
+// Same as MetaImage::ElementByteOrderFix, for data read outside of MetaImage
+void
+SwapBytesToSystemOrder(void *buffer, SizeValueType numberOfComponents, unsigned int componentSize,
+                       bool bigEndianData)
+{
+  switch ( componentSize )
+    {
+    case 2:
+      if ( bigEndianData )
+        {
+        ByteSwapper< uint16_t >::SwapRangeFromSystemToBigEndian(static_cast< uint16_t * >( buffer ), numberOfComponents);
+        }
+      else
+        {
+        ByteSwapper< uint16_t >::SwapRangeFromSystemToLittleEndian(static_cast< uint16_t * >( buffer ),
+                                                                   numberOfComponents);
+        }
+      break;
+    case 4:
+      if ( bigEndianData )
+        {
+        ByteSwapper< uint32_t >::SwapRangeFromSystemToBigEndian(static_cast< uint32_t * >( buffer ), numberOfComponents);
+        }
+      else
+        {
+        ByteSwapper< uint32_t >::SwapRangeFromSystemToLittleEndian(static_cast< uint32_t * >( buffer ),
+                                                                   numberOfComponents);
+        }
+      break;
+    case 8:
+      if ( bigEndianData )
+        {
+        ByteSwapper< uint64_t >::SwapRangeFromSystemToBigEndian(static_cast< uint64_t * >( buffer ), numberOfComponents);
+        }
+      else
+        {
+        ByteSwapper< uint64_t >::SwapRangeFromSystemToLittleEndian(static_cast< uint64_t * >( buffer ),
+                                                                   numberOfComponents);
+        }
+      break;
+    default:
+      break;
+    }
+}
+}
+
 MetaImageIO::MetaImageIO()
 {
   m_FileType = Binary;
@@ -442,7 +491,32 @@ void MetaImageIO::Read(void *buffer)
     largestRegion.SetSize( i, this->GetDimensions(i) );
     }
 
-  if ( largestRegion != m_IORegion )
+  std::string   compressedDataFileName;
+  SizeValueType compressedDataOffset;
+  if ( largestRegion != m_IORegion && m_MetaImage.CompressedData()
+       && this->GetDataLocation(compressedDataFileName, compressedDataOffset) )
+    {
+    // MetaImage::ReadROI decompresses the data from its start for every
+    // region, which makes streaming compressed images quadratic
+    if ( m_CompressedStreamReader.IsNull() )
+      {
+      m_CompressedStreamReader = CompressedStreamReader::New();
+      }
+    m_CompressedStreamReader->SetFileName(compressedDataFileName);
+    m_CompressedStreamReader->SetDataOffset(compressedDataOffset);
+
+    std::vector< SizeValueType > dimensions(nDims);
+    for ( unsigned int i = 0; i < nDims; i++ )
+      {
+      dimensions[i] = this->GetDimensions(i);
+      }
+    m_CompressedStreamReader->ReadRegion(buffer, 0, dimensions, m_IORegion,
+                                         this->GetComponentSize() * this->GetNumberOfComponents());
+
+    SwapBytesToSystemOrder(buffer, m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents(),
+                           this->GetComponentSize(), m_MetaImage.BinaryDataByteOrderMSB());
+    }
+  else if ( largestRegion != m_IORegion )
     {
     auto * indexMin = new int[nDims];
     auto * indexMax = new int[nDims];
@@ -495,6 +569,71 @@ void MetaImageIO::Read(void *buffer)
     }
 }
 
+bool
+MetaImageIO
+::CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset)
+{
+  if ( m_MetaImage.CompressedData() || !m_MetaImage.BinaryData()
+       || ( this->GetComponentSize() > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() ) )
+    {
+    return false;
+    }
+  return this->GetDataLocation(dataFileName, dataOffset);
+}
+
+bool
+MetaImageIO
+::GetDataLocation(std::string & dataFileName, SizeValueType & dataOffset) const
+{
+  if ( m_SubSamplingFactor != 1 || m_MetaImage.HeaderSize() < 0 )
+    {
+    return false;
+    }
+
+  const std::string elementDataFile = m_MetaImage.ElementDataFileName();
+  if ( itksys::SystemTools::Strucmp(elementDataFile.c_str(), "LOCAL") == 0 )
+    {
+    dataFileName = m_FileName;
+    if ( m_MetaImage.HeaderSize() > 0 )
+      {
+      dataOffset = m_MetaImage.HeaderSize();
+      return true;
+      }
+    // The data follows the line of the ElementDataFile field, which ends
+    // the header
+    std::ifstream file(m_FileName.c_str(), std::ios::in | std::ios::binary);
+    std::string   line;
+    while ( std::getline(file, line) )
+      {
+      const std::string::size_type fieldStart = line.find_first_not_of(" \t");
+      if ( fieldStart != std::string::npos && line.compare(fieldStart, 15, "ElementDataFile") == 0 )
+        {
+        dataOffset = static_cast< SizeValueType >( file.tellg() );
+        return file.good();
+        }
+      }
+    return false;
+    }
+
+  // Lists and patterns of slice files
+  if ( elementDataFile.compare(0, 4, "LIST") == 0
+       || elementDataFile.find_first_of("% ") != std::string::npos )
+    {
+    return false;
+    }
+  const std::string headerPath = itksys::SystemTools::GetFilenamePath(m_FileName);
+  if ( itksys::SystemTools::FileIsFullPath(elementDataFile) || headerPath.empty() )
+    {
+    dataFileName = elementDataFile;
+    }
+  else
+    {
+    dataFileName = headerPath + "/" + elementDataFile;
+    }
+  dataOffset = m_MetaImage.HeaderSize();
+  return true;
+}
+
 MetaImage * MetaImageIO::GetMetaImagePointer()
 {
   return &m_MetaImage;
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+
+// Stream compressed images in pieces and read subregions of them, with the
+// data in the header file or in a separate file.
+namespace
+{
+using ImageType = itk::Image< short, 3 >;
+
+bool SameImages(const ImageType * image1, const ImageType * image2, const ImageType::RegionType & region)
+{
+  itk::ImageRegionConstIterator< ImageType > it1( image1, region );
+  itk::ImageRegionConstIterator< ImageType > it2( image2, region );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if ( it1.Get() != it2.Get() )
+      {
+      std::cerr << "Pixels differ at " << it1.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+int StreamCompressedImage(const ImageType * image, const std::string & fileName)
+{
+  using WriterType = itk::ImageFileWriter< ImageType >;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetFileName( fileName );
+  writer->UseCompressionOn();
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  using ReaderType = itk::ImageFileReader< ImageType >;
+  ReaderType::Pointer   reader = ReaderType::New();
+  itk::MetaImageIO::Pointer metaIO = itk::MetaImageIO::New();
+  reader->SetFileName( fileName );
+  reader->SetImageIO( metaIO );
+  reader->SetUseStreaming( true );
+  TRY_EXPECT_NO_EXCEPTION( reader->UpdateOutputInformation() );
+  TEST_EXPECT_TRUE( metaIO->CanStreamRead() );
+
+  using StreamerType = itk::StreamingImageFilter< ImageType, ImageType >;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( reader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 9 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_TRUE( SameImages( image, streamer->GetOutput(), image->GetLargestPossibleRegion() ) );
+
+  // A subregion which does not span the lower dimensions
+  ImageType::RegionType region;
+  region.SetIndex( { { 7, 2, 30 } } );
+  region.SetSize( { { 33, 40, 5 } } );
+  reader->GetOutput()->SetRequestedRegion( region );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( SameImages( image, reader->GetOutput(), region ) );
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkMetaImageCompressedStreamingReadTest(int argc, char* argv[])
+{
+  if ( argc != 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string outputDirectory = argv[1];
+
+  ImageType::SizeType size = { { 60, 50, 45 } };
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( short value = 0; !it.IsAtEnd(); ++it, value += 3 )
+    {
+    it.Set( value );
+    }
+
+  TEST_EXPECT_EQUAL( StreamCompressedImage( image, outputDirectory + "/itkMetaImageCompressedStreamingReadTest.mha" ),
+                     EXIT_SUCCESS );
+  TEST_EXPECT_EQUAL( StreamCompressedImage( image, outputDirectory + "/itkMetaImageCompressedStreamingReadTest.mhd" ),
+                     EXIT_SUCCESS );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -24,6 +24,7 @@
 #include <fstream>
 #include <memory>
 #include "itkImageIOBase.h"
+#include "itkCompressedStreamReader.h"
 
 namespace itk
 {
@@ -92,6 +93,12 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   void Read(void *buffer) override;
 
+  /** Uncompressed files of scalar, complex, RGB or RGBA pixels in the
+   * byte order of this machine can be memory mapped when they do not need
+   * rescaling. Unlike Read(), mapping keeps non-finite floating point
+   * values as they are stored instead of replacing them by zero. */
+  bool CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset) override;
+
   //-------- This part of the interfaces deals with writing data. -----
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -153,6 +160,11 @@ private:
 
   void  SetImageIOMetadataFromNIfTI();
 
+  /** Read a subregion of a compressed image through
+   * m_CompressedStreamReader. Returns a buffer allocated with malloc, as
+   * nifti_read_subregion_image does. */
+  void * ReadCompressedSubregion(const int *origin, const int *size);
+
   //This proxy class provides a nifti_image pointer interface to the internal implementation
   //of itk::NiftiImageIO, while hiding the niftilib interface from the external ITK interface.
   class NiftiImageProxy;
@@ -170,6 +182,10 @@ private:
 
   bool m_LegacyAnalyze75Mode{true};
 
+  // Keeps the index of the compressed data between the reads of a
+  // streamed pipeline
+  CompressedStreamReader::Pointer m_CompressedStreamReader;
+
 };
 } // end namespace itk
 
@@ -20,6 +20,7 @@
 #include "itkMetaDataObject.h"
 #include "itkSpatialOrientationAdapter.h"
 #include <nifti1_io.h>
+#include <cmath>
 
 namespace itk
 {
@@ -487,6 +488,110 @@ CastCopy(float *to, const void *from, size_t pixelcount)
     }
 }
 
+// Internal function to replace non-finite values like nifti_read_buffer
+template< typename TBuffer >
+void
+ReplaceNonFiniteByZero(TBuffer *buffer, size_t size)
+{
+  for ( size_t i = 0; i < size; i++ )
+    {
+    if ( !std::isfinite(buffer[i]) )
+      {
+      buffer[i] = 0;
+      }
+    }
+}
+
+void *
+NiftiImageIO
+::ReadCompressedSubregion(const int *origin, const int *size)
+{
+  const auto numberOfDimensions = static_cast< unsigned int >( this->m_NiftiImage->dim[0] );
+  std::vector< SizeValueType > dimensions(numberOfDimensions);
+  ImageIORegion                region(numberOfDimensions);
+  for ( unsigned int d = 0; d < numberOfDimensions; ++d )
+    {
+    dimensions[d] = this->m_NiftiImage->dim[d + 1];
+    region.SetIndex(d, origin[d]);
+    region.SetSize(d, size[d]);
+    }
+
+  if ( m_CompressedStreamReader.IsNull() )
+    {
+    m_CompressedStreamReader = CompressedStreamReader::New();
+    }
+  m_CompressedStreamReader->SetFileName(this->m_NiftiImage->iname);
+
+  const SizeValueType pixelSize = this->m_NiftiImage->nbyper;
+  const SizeValueType numberOfBytes = region.GetNumberOfPixels() * pixelSize;
+  void *              data = malloc(numberOfBytes);
+  if ( data == nullptr )
+    {
+    itkExceptionMacro( << "Failed to allocate " << numberOfBytes << " bytes for reading " << this->GetFileName() );
+    }
+  try
+    {
+    m_CompressedStreamReader->ReadRegion(data, this->m_NiftiImage->iname_offset, dimensions, region, pixelSize);
+    }
+  catch ( ... )
+    {
+    free(data);
+    throw;
+    }
+
+  // Same fixes as nifti_read_buffer
+  if ( this->m_NiftiImage->swapsize > 1 && this->m_NiftiImage->byteorder != nifti_short_order() )
+    {
+    nifti_swap_Nbytes(numberOfBytes / this->m_NiftiImage->swapsize, this->m_NiftiImage->swapsize, data);
+    }
+  switch ( this->m_NiftiImage->datatype )
+    {
+    case NIFTI_TYPE_FLOAT32:
+    case NIFTI_TYPE_COMPLEX64:
+      ReplaceNonFiniteByZero(static_cast< float * >( data ), numberOfBytes / sizeof( float ));
+      break;
+    case NIFTI_TYPE_FLOAT64:
+    case NIFTI_TYPE_COMPLEX128:
+      ReplaceNonFiniteByZero(static_cast< double * >( data ), numberOfBytes / sizeof( double ));
+      break;
+    default:
+      break;
+    }
+  return data;
+}
+
+bool
+NiftiImageIO
+::CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset)
+{
+  // Vector components are stored in the fifth dimension by NIfTI, and
+  // interleaved by ITK
+  if ( ( this->GetNumberOfComponents() > 1
+         && this->GetPixelType() != COMPLEX
+         && this->GetPixelType() != RGB
+         && this->GetPixelType() != RGBA )
+       || this->MustRescale() )
+    {
+    return false;
+    }
+
+  nifti_image *header = nifti_image_read(this->GetFileName(), false);
+  if ( header == nullptr )
+    {
+    return false;
+    }
+  const bool canMap = !nifti_is_gzfile(header->iname)
+                      && header->iname_offset >= 0
+                      && ( header->swapsize <= 1 || header->byteorder == nifti_short_order() );
+  if ( canMap )
+    {
+    dataFileName = header->iname;
+    dataOffset = static_cast< SizeValueType >( header->iname_offset );
+    }
+  nifti_image_free(header);
+  return canMap;
+}
+
 void NiftiImageIO::Read(void *buffer)
 {
   void *data = nullptr;
@@ -557,6 +662,13 @@ void NiftiImageIO::Read(void *buffer)
       }
     data = this->m_NiftiImage->data;
     }
+  else if ( nifti_is_gzfile(this->m_NiftiImage->iname)
+            && this->m_NiftiImage->iname_offset >= 0 )
+    {
+    // nifti_read_subregion_image decompresses the file from its start for
+    // every subregion, which makes streaming compressed images quadratic
+    data = this->ReadCompressedSubregion(_origin, _size);
+    }
   else
     {
     // read in a subregion
@@ -655,12 +767,14 @@ void NiftiImageIO::Read(void *buffer)
     {
     // otherwise nifti is x y z t vec l m 0, itk is
     // vec x y z t l m o
+    // The data only holds the region which was read, which is smaller
+    // than the image when streaming.
     const auto * niftibuf = (const char *)data;
     auto * itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    const size_t rowdist = _size[0];
+    const size_t slicedist = rowdist * _size[1];
+    const size_t volumedist = slicedist * _size[2];
+    const size_t seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -679,13 +793,13 @@ void NiftiImageIO::Read(void *buffer)
         vecOrder[i] = i;
         }
       }
-    for ( int t = 0; t < this->m_NiftiImage->dim[4]; t++ )
+    for ( int t = 0; t < _size[3]; t++ )
       {
-      for ( int z = 0; z < this->m_NiftiImage->dim[3]; z++ )
+      for ( int z = 0; z < _size[2]; z++ )
         {
-        for ( int y = 0; y < this->m_NiftiImage->dim[2]; y++ )
+        for ( int y = 0; y < _size[1]; y++ )
           {
-          for ( int x = 0; x < this->m_NiftiImage->dim[1]; x++ )
+          for ( int x = 0; x < _size[0]; x++ )
             {
             for ( unsigned int c = 0; c < numComponents; c++ )
               {
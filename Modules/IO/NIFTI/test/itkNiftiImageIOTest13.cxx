@@ -0,0 +1,115 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+
+// Stream compressed images in pieces and read subregions of them, which
+// are decompressed through the index of the compressed data.
+namespace
+{
+template< typename TImage >
+bool SameImages(const TImage * image1, const TImage * image2, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIterator< TImage > it1( image1, region );
+  itk::ImageRegionConstIterator< TImage > it2( image2, region );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if ( it1.Get() != it2.Get() )
+      {
+      std::cerr << "Pixels differ at " << it1.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TImage >
+int StreamCompressedImage(typename TImage::Pointer & image, const std::string & fileName)
+{
+  itk::IOTestHelper::WriteImage< TImage, itk::NiftiImageIO >( image, fileName );
+
+  using ReaderType = itk::ImageFileReader< TImage >;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->SetImageIO( itk::NiftiImageIO::New() );
+
+  using StreamerType = itk::StreamingImageFilter< TImage, TImage >;
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( reader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 7 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_TRUE( SameImages< TImage >( image, streamer->GetOutput(), image->GetLargestPossibleRegion() ) );
+
+  // A subregion which does not span the lower dimensions
+  typename TImage::RegionType region = image->GetLargestPossibleRegion();
+  region.SetIndex( { { 5, 9, 11 } } );
+  region.SetSize( { { 20, 31, 17 } } );
+  reader->GetOutput()->SetRequestedRegion( region );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( SameImages< TImage >( image, reader->GetOutput(), region ) );
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkNiftiImageIOTest13(int ac, char* av[])
+{
+  if ( ac != 2 )
+    {
+    std::cerr << "Usage: " << av[0] << " testDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory( av[1] );
+
+  using ImageType = itk::Image< float, 3 >;
+  ImageType::SizeType size = { { 64, 48, 40 } };
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( float value = 0.0f; !it.IsAtEnd(); ++it, value += 0.25f )
+    {
+    it.Set( value );
+    }
+  TEST_EXPECT_EQUAL( StreamCompressedImage< ImageType >( image, "itkNiftiImageIOTest13.nii.gz" ), EXIT_SUCCESS );
+
+  // Vector components are stored in the fifth dimension
+  using VectorImageType = itk::VectorImage< short, 3 >;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( size );
+  vectorImage->SetNumberOfComponentsPerPixel( 3 );
+  vectorImage->Allocate();
+  VectorImageType::PixelType value( 3 );
+  itk::ImageRegionIterator< VectorImageType > vectorIt( vectorImage, vectorImage->GetLargestPossibleRegion() );
+  for ( ; !vectorIt.IsAtEnd(); ++vectorIt )
+    {
+    const VectorImageType::IndexType index = vectorIt.GetIndex();
+    value[0] = static_cast< short >( index[0] );
+    value[1] = static_cast< short >( index[1] * 100 );
+    value[2] = static_cast< short >( -index[2] );
+    vectorIt.Set( value );
+    }
+  TEST_EXPECT_EQUAL( StreamCompressedImage< VectorImageType >( vectorImage, "itkNiftiImageIOTest13Vector.nii.gz" ),
+                     EXIT_SUCCESS );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
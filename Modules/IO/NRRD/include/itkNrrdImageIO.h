@@ -67,6 +67,11 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   void Read(void *buffer) override;
 
+  /** Raw encoded data, in a single file and in the byte order of this
+   * machine, can be memory mapped when its non-scalar axis, if any, is the
+   * fastest one and is not a masked symmetric matrix. */
+  bool CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset) override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool CanWriteFile(const char *) override;
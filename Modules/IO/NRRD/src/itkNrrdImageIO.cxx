@@ -22,6 +22,7 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itksys/SystemTools.hxx"
 
 namespace itk
 {
@@ -687,6 +688,73 @@ void NrrdImageIO::ReadImageInformation()
     }
 }
 
+bool NrrdImageIO::CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset)
+{
+  Nrrd *       nrrd = nrrdNew();
+  NrrdIoState *nio = nrrdIoStateNew();
+
+  // nrrd causes exceptions on purpose, so mask them
+  bool saveFPEState(false);
+  if ( FloatingPointExceptions::HasFloatingPointExceptionsSupport() )
+    {
+    saveFPEState = FloatingPointExceptions::GetEnabled();
+    FloatingPointExceptions::Disable();
+    }
+
+  // Read the header and skip to the data, leaving the data file open at
+  // its first byte
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+  const bool loaded = ( nrrdLoad(nrrd, this->GetFileName(), nio) == 0 );
+
+  if ( FloatingPointExceptions::HasFloatingPointExceptionsSupport() )
+    {
+    FloatingPointExceptions::SetEnabled(saveFPEState);
+    }
+
+  bool canMap = false;
+  if ( !loaded )
+    {
+    free( biffGetDone(NRRD) );
+    }
+  else if ( nio->dataFile != nullptr
+            && nio->dataFNFormat == nullptr
+            && nio->encoding == nrrdEncodingRaw
+            && ( nrrdElementSize(nrrd) == 1 || nio->endian == airMyEndian() )
+            && nrrd->axis[0].kind != nrrdKind3DMaskedSymMatrix )
+    {
+    unsigned int rangeAxisIdx[NRRD_DIM_MAX];
+    const unsigned int rangeAxisNum = nrrdRangeAxesGet(nrrd, rangeAxisIdx);
+    const long         position = ftell(nio->dataFile);
+    if ( ( rangeAxisNum == 0 || ( rangeAxisNum == 1 && rangeAxisIdx[0] == 0 ) ) && position >= 0 )
+      {
+      canMap = true;
+      dataOffset = static_cast< SizeValueType >( position );
+      if ( nio->dataFNArr->len == 0 )
+        {
+        // attached data
+        dataFileName = this->GetFileName();
+        }
+      else if ( itksys::SystemTools::FileIsFullPath(nio->dataFN[0]) || airStrlen(nio->path) == 0 )
+        {
+        dataFileName = nio->dataFN[0];
+        }
+      else
+        {
+        dataFileName = std::string(nio->path) + "/" + nio->dataFN[0];
+        }
+      }
+    }
+
+  if ( nio->dataFile != nullptr )
+    {
+    airFclose(nio->dataFile);
+    }
+  nrrdNix(nrrd);
+  nrrdIoStateNix(nio);
+  return canMap;
+}
+
 void NrrdImageIO::Read(void *buffer)
 {
   Nrrd *       nrrd = nrrdNew();
@@ -108,6 +108,10 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   void Read(void *buffer) override;
 
+  /** Binary files in the byte order of this machine can be memory
+   * mapped, starting at GetHeaderSize(). */
+  bool CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset) override;
+
   /** Set/Get the Data mask. */
   itkGetConstReferenceMacro(ImageMask, unsigned short);
   void SetImageMask(unsigned long val)
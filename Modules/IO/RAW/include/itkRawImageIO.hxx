@@ -173,6 +173,26 @@ void RawImageIO< TPixel, VImageDimension >
   else if itkReadRawBytesAfterSwappingMacro(double, DOUBLE)
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+bool RawImageIO< TPixel, VImageDimension >
+::CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset)
+{
+  if ( m_FileType != Binary || m_FileName.empty() )
+    {
+    return false;
+    }
+  const bool systemIsBigEndian = ByteSwapper< int >::SystemIsBigEndian();
+  if ( this->GetComponentSize() > 1
+       && ( ( m_ByteOrder == BigEndian && !systemIsBigEndian )
+            || ( m_ByteOrder == LittleEndian && systemIsBigEndian ) ) )
+    {
+    return false;
+    }
+  dataFileName = m_FileName;
+  dataOffset = this->GetHeaderSize();
+  return true;
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 bool RawImageIO< TPixel, VImageDimension >
 ::CanWriteFile(const char *fname)
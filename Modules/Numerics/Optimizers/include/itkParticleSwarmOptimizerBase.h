@@ -22,6 +22,7 @@
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "ITKOptimizersExport.h"
+#include <vector>
 
 namespace itk
 {
@@ -48,6 +49,12 @@ namespace itk
  * The actual optimization procedure, updating the swarm, is performed in the
  * subclasses, required to implement the UpdateSwarm() method.
  *
+ * The particles of a generation are evaluated independently of each other.
+ * When independent, identically configured copies of the cost function are
+ * supplied via SetCostFunctionClones(), the particles are evaluated
+ * concurrently, one thread per cost function instance. The swarm's
+ * trajectory does not depend on the number of instances.
+ *
  * NOTE: This implementation only performs minimization.
  *
  * \ingroup Numerics Optimizers
@@ -87,6 +94,7 @@ public:
   using MeasureType = CostFunctionType::MeasureType;
   using ValueType = ParametersType::ValueType;
   using RandomVariateGeneratorType = Statistics::MersenneTwisterRandomVariateGenerator;
+  using CostFunctionListType = std::vector< CostFunctionType::Pointer >;
 
   /** Specify whether to initialize the particles using a normal distribution
     * centered on the user supplied initial value or a uniform distribution.
@@ -183,6 +191,17 @@ public:
   itkGetMacro( UseSeed, bool )
   itkBooleanMacro( UseSeed)
 
+  /** Set/Get copies of the cost function that can be evaluated concurrently
+   * with it. Each copy must be configured identically to the cost function
+   * and must not share mutable state with it or with the other copies. The
+   * particles are then evaluated by 1 + number of copies threads. Default
+   * is no copies, the particles are evaluated serially. */
+  void SetCostFunctionClones( const CostFunctionListType & clones );
+  const CostFunctionListType & GetCostFunctionClones() const
+    {
+    return this->m_CostFunctionClones;
+    }
+
   /** Get the function value for the current position.
    *  NOTE: This value is only valid during and after the execution of the
    *        StartOptimization() method.*/
@@ -217,6 +236,11 @@ protected:
   void RandomInitialization();
   void FileInitialization();
 
+  /** Evaluate the cost function at the current parameters of all particles
+   * and store the results in their current values. The evaluations are
+   * distributed over the cost function and its clones. */
+  void EvaluateParticles();
+
   bool                                         m_PrintSwarm;
   std::ostringstream                           m_StopConditionDescription;
   bool                                         m_InitializeNormalDistribution;
@@ -234,6 +258,7 @@ protected:
   NumberOfIterationsType                       m_IterationIndex{0};
   RandomVariateGeneratorType::IntegerType      m_Seed;
   bool                                         m_UseSeed;
+  CostFunctionListType                         m_CostFunctionClones;
 };
 } // end namespace itk
 
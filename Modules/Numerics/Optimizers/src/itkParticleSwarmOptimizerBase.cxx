@@ -16,7 +16,10 @@
  *
  *=========================================================================*/
 #include <algorithm>
+#include <exception>
+#include <mutex>
 #include "itkParticleSwarmOptimizerBase.h"
+#include "itkPlatformMultiThreader.h"
 
 namespace itk
 {
@@ -140,6 +143,15 @@ ParticleSwarmOptimizerBase
 }
 
 
+void
+ParticleSwarmOptimizerBase
+::SetCostFunctionClones( const CostFunctionListType & clones )
+{
+  this->m_CostFunctionClones = clones;
+  Modified();
+}
+
+
 ParticleSwarmOptimizerBase::CostFunctionType::MeasureType
 ParticleSwarmOptimizerBase
 ::GetValue() const
@@ -180,6 +192,7 @@ ParticleSwarmOptimizerBase
   os<<indent<<"Function convergence tolerance: "<<this->m_FunctionConvergenceTolerance << std::endl;
   os<<indent<<"UseSeed: " << m_UseSeed << std::endl;
   os<<indent<<"Seed: " << m_Seed << std::endl;
+  os<<indent<<"Number of cost function clones: " << m_CostFunctionClones.size() << std::endl;
 
   os<<"\n";
           //printing the swarm, usually should be avoided (too much information)
@@ -526,12 +539,73 @@ ParticleSwarmOptimizerBase
       }
     }
             //initial function evaluations
+  EvaluateParticles();
   for( i=0; i<this->m_NumberOfParticles; i++ )
     {
-    this->m_Particles[i].m_CurrentValue =
-      this->m_CostFunction->GetValue( m_Particles[i].m_CurrentParameters );
     this->m_Particles[i].m_BestValue = m_Particles[i].m_CurrentValue;
     }
 }
 
+
+void
+ParticleSwarmOptimizerBase
+::EvaluateParticles()
+{
+  const auto numberOfParticles = static_cast<unsigned int>( this->m_Particles.size() );
+  const auto numberOfCostFunctions = static_cast<unsigned int>(
+    std::min<size_t>( this->m_CostFunctionClones.size() + 1, numberOfParticles ) );
+  if( numberOfCostFunctions < 2 )
+    {
+    for( unsigned int i=0; i<numberOfParticles; i++ )
+      {
+      this->m_Particles[i].m_CurrentValue =
+        this->m_CostFunction->GetValue( m_Particles[i].m_CurrentParameters );
+      }
+    return;
+    }
+
+  for( unsigned int c=0; c<numberOfCostFunctions-1; c++ )
+    {
+    if( this->m_CostFunctionClones[c].IsNull() )
+      {
+      itkExceptionMacro(<<"cost function clone " << c << " is null");
+      }
+    }
+
+         //each cost function instance evaluates a contiguous block of
+         //particles, the thread pool stays available to the cost functions
+  std::exception_ptr exception;
+  std::mutex exceptionMutex;
+  PlatformMultiThreader::Pointer threader = PlatformMultiThreader::New();
+  threader->SetNumberOfWorkUnits( numberOfCostFunctions );
+  threader->ParallelizeArray( 0, numberOfCostFunctions,
+    [&]( SizeValueType c )
+      {
+      const CostFunctionType * costFunction = ( c == 0 ) ?
+        this->m_CostFunction.GetPointer() : this->m_CostFunctionClones[c-1].GetPointer();
+      const SizeValueType begin = c * numberOfParticles / numberOfCostFunctions;
+      const SizeValueType end = ( c + 1 ) * numberOfParticles / numberOfCostFunctions;
+      try
+        {
+        for( SizeValueType i=begin; i<end; i++ )
+          {
+          this->m_Particles[i].m_CurrentValue =
+            costFunction->GetValue( m_Particles[i].m_CurrentParameters );
+          }
+        }
+      catch( ... )
+        {
+        std::lock_guard< std::mutex > lock( exceptionMutex );
+        if( !exception )
+          {
+          exception = std::current_exception();
+          }
+        }
+      }, nullptr );
+  if( exception )
+    {
+    std::rethrow_exception( exception );
+    }
+}
+
 }
@@ -45,6 +45,12 @@ int PSOTest2();
  */
 int PSOTest3();
 
+/**
+ * Test that evaluating the particles concurrently, using clones of the
+ * cost function, does not change the optimization result.
+ */
+int PSOTest4();
+
 bool verboseFlag = false;
 
 /**
@@ -82,6 +88,12 @@ int itkParticleSwarmOptimizerTest(int argc, char* argv[] )
       }
     }
 
+  if( EXIT_SUCCESS != PSOTest4() )
+    {
+    std::cout<<"[FAILURE]\n";
+    return EXIT_FAILURE;
+    }
+
   std::cout<< "All Tests Completed."<< std::endl;
 
   if( static_cast<double>(success1)/ static_cast<double>(allIterations) <= threshold ||
@@ -485,3 +497,71 @@ int PSOTest3()
   std::cout << "[Test 3 SUCCESS]" << std::endl;
   return EXIT_SUCCESS;
 }
+
+
+int PSOTest4()
+{
+  std::cout << "Particle Swarm Optimizer Test 4 [concurrent particle evaluation]\n";
+  std::cout << "----------------------------------\n";
+
+  OptimizerType::ParameterBoundsType bounds;
+  bounds.push_back( std::make_pair( -10, 10 ) );
+  bounds.push_back( std::make_pair( -10, 10 ) );
+  OptimizerType::ParametersType initialParameters( 2 );
+  initialParameters[0] =  9;
+  initialParameters[1] = -9;
+
+  OptimizerType::ParametersType finalParameters[2];
+  OptimizerType::MeasureType finalValue[2];
+  for( unsigned int run = 0; run < 2; run++ )
+    {
+    itk::ParticleSwarmTestF2::Pointer costFunction =
+      itk::ParticleSwarmTestF2::New();
+    OptimizerType::CostFunctionListType clones;
+    if( run == 1 )
+      {
+      clones.push_back( itk::ParticleSwarmTestF2::New().GetPointer() );
+      clones.push_back( itk::ParticleSwarmTestF2::New().GetPointer() );
+      }
+
+    OptimizerType::Pointer  itkOptimizer = OptimizerType::New();
+    itkOptimizer->UseSeedOn();
+    itkOptimizer->SetSeed( 8775070 );
+    itkOptimizer->SetParameterBounds( bounds );
+    itkOptimizer->SetNumberOfParticles( 10 );
+    itkOptimizer->SetMaximalNumberOfIterations( 100 );
+    itkOptimizer->SetParametersConvergenceTolerance( 0.1,
+                                                     costFunction->GetNumberOfParameters() );
+    itkOptimizer->SetFunctionConvergenceTolerance( 0.001 );
+    itkOptimizer->SetCostFunction( costFunction );
+    itkOptimizer->SetCostFunctionClones( clones );
+    if( itkOptimizer->GetCostFunctionClones().size() != clones.size() )
+      {
+      std::cout << "[Test 4 FAILURE] SetCostFunctionClones" << std::endl;
+      return EXIT_FAILURE;
+      }
+    itkOptimizer->SetInitialPosition( initialParameters );
+    try
+      {
+      itkOptimizer->StartOptimization();
+      }
+    catch( itk::ExceptionObject & e )
+      {
+      std::cout << "[Test 4 FAILURE]" << std::endl;
+      std::cout << "Exception thrown ! " << e << std::endl;
+      return EXIT_FAILURE;
+      }
+    finalParameters[run] = itkOptimizer->GetCurrentPosition();
+    finalValue[run] = itkOptimizer->GetValue();
+    std::cout << "Estimated parameters with " << clones.size() << " clones = "
+              << finalParameters[run] << std::endl;
+    }
+  if( finalParameters[0] != finalParameters[1] ||
+      itk::Math::NotExactlyEquals( finalValue[0], finalValue[1] ) )
+    {
+    std::cout << "[Test 4 FAILURE] concurrent evaluation changed the result" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "[Test 4 SUCCESS]" << std::endl;
+  return EXIT_SUCCESS;
+}
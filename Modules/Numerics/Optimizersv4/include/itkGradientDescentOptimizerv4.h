@@ -214,6 +214,11 @@ protected:
   /** Destructor */
   ~GradientDescentOptimizerv4Template() override;
 
+  /** Clone method will clone the existing instance of this type, including
+   * its settings. The metric and the scales estimator are shared with the
+   * clone. Observers are not copied. */
+  typename LightObject::Pointer InternalClone() const override;
+
   void PrintSelf( std::ostream & os, Indent indent ) const override;
 
 
@@ -272,6 +272,40 @@ GradientDescentOptimizerv4Template<TInternalComputationValueType>
     }
 }
 
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+GradientDescentOptimizerv4Template<TInternalComputationValueType>
+::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+
+  rval->m_Metric = this->m_Metric;
+  rval->m_NumberOfWorkUnits = this->m_NumberOfWorkUnits;
+  rval->m_NumberOfIterations = this->m_NumberOfIterations;
+  rval->m_Scales = this->m_Scales;
+  rval->m_Weights = this->m_Weights;
+  rval->m_ScalesEstimator = this->m_ScalesEstimator;
+  rval->m_DoEstimateScales = this->m_DoEstimateScales;
+
+  rval->m_DoEstimateLearningRateAtEachIteration = this->m_DoEstimateLearningRateAtEachIteration;
+  rval->m_DoEstimateLearningRateOnce = this->m_DoEstimateLearningRateOnce;
+  rval->m_MaximumStepSizeInPhysicalUnits = this->m_MaximumStepSizeInPhysicalUnits;
+  rval->m_UseConvergenceMonitoring = this->m_UseConvergenceMonitoring;
+  rval->m_ConvergenceWindowSize = this->m_ConvergenceWindowSize;
+
+  rval->m_LearningRate = this->m_LearningRate;
+  rval->m_MinimumConvergenceValue = this->m_MinimumConvergenceValue;
+  rval->m_ReturnBestParametersAndValue = this->m_ReturnBestParametersAndValue;
+
+  return loPtr;
+}
+
 template<typename TInternalComputationValueType>
 void
 GradientDescentOptimizerv4Template<TInternalComputationValueType>
@@ -34,6 +34,16 @@ namespace itk
    *   focus modifying the parameter sample space.  This is why we place the burden on the user to provide
    *   the parameter samples over which to optimize.
    *
+   *   With OptimizeStartPointsConcurrently on (off by default) and a metric
+   *   that supports cloning, the start points are optimized concurrently,
+   *   each work unit using its own clone of the metric and of the local
+   *   optimizer. The NumberOfWorkUnits of this optimizer is shared between
+   *   the concurrent start points and the metric clones. This requires the
+   *   local optimizer, if any, to be a LocalOptimizerType; otherwise, or when
+   *   its scales estimator cannot be cloned, the start points are optimized
+   *   one after another with the metric itself. The observers of the local
+   *   optimizer are not called for the clones.
+   *
    * \ingroup ITKOptimizersv4
    */
 template<typename TInternalComputationValueType>
@@ -133,6 +143,14 @@ public:
 
   inline ParameterListSizeType GetBestParametersIndex( ) { return this->m_BestParametersIndex; }
 
+  /** Set/Get whether the start points are optimized concurrently on clones
+   * of the metric and of the local optimizer, when possible. Defaults to
+   * false, which optimizes them one after another with the metric and local
+   * optimizer themselves. */
+  itkSetMacro( OptimizeStartPointsConcurrently, bool );
+  itkGetConstMacro( OptimizeStartPointsConcurrently, bool );
+  itkBooleanMacro( OptimizeStartPointsConcurrently );
+
 protected:
   /** Default constructor */
   MultiStartOptimizerv4Template();
@@ -140,6 +158,16 @@ protected:
 
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Optimize the start points from m_CurrentIteration on concurrently, on
+   * clones of the metric and of the local optimizer. The optimized start
+   * points replace those in m_ParametersList, and their metric values are
+   * returned in \c metricValues. \c evaluated flags the start points whose
+   * optimization did not throw. Returns false, without evaluating anything,
+   * if OptimizeStartPointsConcurrently is off or the start points cannot be
+   * optimized concurrently. */
+  bool OptimizeStartPointsOnClones( MetricValuesListType & metricValues,
+                                    std::vector< char > & evaluated );
+
   /* Common variables for optimization control and reporting */
   bool                          m_Stop{false};
   StopConditionType             m_StopCondition;
@@ -150,6 +178,7 @@ protected:
   MeasureType                   m_MaximumMetricValue;
   ParameterListSizeType         m_BestParametersIndex;
   OptimizerPointer              m_LocalOptimizer;
+  bool                          m_OptimizeStartPointsConcurrently{false};
 };
 
 /** This helps to meet backward compatibility */
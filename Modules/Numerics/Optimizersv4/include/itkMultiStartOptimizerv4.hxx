@@ -19,6 +19,7 @@
 #define itkMultiStartOptimizerv4_hxx
 
 #include "itkMultiStartOptimizerv4.h"
+#include <typeinfo>
 
 namespace itk
 {
@@ -53,6 +54,7 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   Superclass::PrintSelf(os, indent);
   os << indent << "Stop condition:"<< this->m_StopCondition << std::endl;
   os << indent << "Stop condition description: " << this->m_StopConditionDescription.str()  << std::endl;
+  os << indent << "OptimizeStartPointsConcurrently: " << ( this->m_OptimizeStartPointsConcurrently ? "On" : "Off" ) << std::endl;
 }
 
 //-------------------------------------------------------------------
@@ -164,6 +166,85 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
     }
 }
 
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+bool
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::OptimizeStartPointsOnClones( MetricValuesListType & metricValues, std::vector< char > & evaluated )
+{
+  if( !this->m_OptimizeStartPointsConcurrently )
+    {
+    return false;
+    }
+  if( this->m_LocalOptimizer )
+    {
+    const OptimizerType & localOptimizer = *this->m_LocalOptimizer;
+    if( typeid( localOptimizer ) != typeid( LocalOptimizerType ) )
+      {
+      return false;
+      }
+    }
+
+  const SizeValueType firstIteration = this->m_CurrentIteration;
+  const SizeValueType numberOfStartPoints = this->m_NumberOfIterations - firstIteration;
+  const typename Superclass::MetricListType metrics = this->CreateConcurrentMetrics( numberOfStartPoints );
+  if( metrics.empty() )
+    {
+    return false;
+    }
+
+  std::vector< LocalOptimizerPointer > localOptimizers;
+  if( this->m_LocalOptimizer )
+    {
+    for( const auto & metric : metrics )
+      {
+      LocalOptimizerPointer localOptimizer =
+        dynamic_cast< LocalOptimizerType * >( this->m_LocalOptimizer->Clone().GetPointer() );
+      if( localOptimizer.IsNull() )
+        {
+        return false;
+        }
+      localOptimizer->SetMetric( metric );
+      localOptimizer->SetNumberOfWorkUnits( metric->GetMaximumNumberOfWorkUnits() );
+      if( localOptimizer->GetModifiableScalesEstimator() )
+        {
+        typename Superclass::ScalesEstimatorType::Pointer scalesEstimator =
+          localOptimizer->GetModifiableScalesEstimator()->CloneForMetric( metric );
+        if( scalesEstimator.IsNull() )
+          {
+          return false;
+          }
+        localOptimizer->SetScalesEstimator( scalesEstimator );
+        }
+      localOptimizers.push_back( localOptimizer );
+      }
+    }
+
+  metricValues.assign( numberOfStartPoints, this->m_MaximumMetricValue );
+  evaluated.assign( numberOfStartPoints, 0 );
+  this->EvaluateConcurrently( metrics, numberOfStartPoints,
+    [&]( SizeValueType m, SizeValueType s )
+      {
+      ParametersType & parameters = this->m_ParametersList[ firstIteration + s ];
+      try
+        {
+        metrics[m]->SetParameters( parameters );
+        if( !localOptimizers.empty() )
+          {
+          localOptimizers[m]->StartOptimization();
+          parameters = metrics[m]->GetParameters();
+          }
+        metricValues[s] = metrics[m]->GetValue();
+        evaluated[s] = 1;
+        }
+      catch ( ExceptionObject & )
+        {
+        /* Reported when the results are collected. */
+        }
+      } );
+  return true;
+}
+
 /**
 * Resume optimization.
 */
@@ -176,20 +257,39 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   this->m_StopConditionDescription << this->GetNameOfClass() << ": ";
   this->InvokeEvent( StartEvent() );
 
+  /* When possible, optimize all the remaining start points at once. The
+   * loop below then only collects their results. */
+  MetricValuesListType concurrentMetricValues;
+  std::vector< char >  concurrentlyEvaluated;
+  const SizeValueType  firstIteration = this->m_CurrentIteration;
+  const bool concurrent = this->OptimizeStartPointsOnClones( concurrentMetricValues, concurrentlyEvaluated );
+
   this->m_Stop = false;
   while( ! this->m_Stop )
     {
     /* Compute metric value */
     try
       {
-      this->m_Metric->SetParameters( this->m_ParametersList[ this->m_CurrentIteration ] );
-      if (  this->m_LocalOptimizer )
+      if( concurrent )
+        {
+        const SizeValueType offset = this->m_CurrentIteration - firstIteration;
+        if( !concurrentlyEvaluated[offset] )
+          {
+          itkExceptionMacro("The optimization of start point " << this->m_CurrentIteration << " failed.");
+          }
+        this->m_CurrentMetricValue = concurrentMetricValues[offset];
+        }
+      else
         {
-        this->m_LocalOptimizer->SetMetric( this->m_Metric );
-        this->m_LocalOptimizer->StartOptimization();
-        this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+        this->m_Metric->SetParameters( this->m_ParametersList[ this->m_CurrentIteration ] );
+        if (  this->m_LocalOptimizer )
+          {
+          this->m_LocalOptimizer->SetMetric( this->m_Metric );
+          this->m_LocalOptimizer->StartOptimization();
+          this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+          }
+        this->m_CurrentMetricValue = this->m_Metric->GetValue();
         }
-      this->m_CurrentMetricValue = this->m_Metric->GetValue();
       this->m_MetricValuesList.push_back(this->m_CurrentMetricValue);
       }
     catch ( ExceptionObject & )
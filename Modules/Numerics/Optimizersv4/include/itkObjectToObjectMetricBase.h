@@ -157,6 +157,24 @@ public:
    * e.g. whether it is dense/high-dimensional. */
   virtual bool HasLocalSupport() const = 0;
 
+  /** Return whether Clone() returns a fully configured copy of the metric
+   * that, once initialized, can be evaluated independently of this one.
+   * The copy shares the fixed and moving objects but owns a copy of the
+   * active transform. Optimizers use such copies to evaluate several
+   * parameter candidates concurrently. Defaults to false. */
+  virtual bool SupportsCloning() const
+    {
+    return false;
+    }
+
+  /** Set/Get the maximum number of work units the metric uses to evaluate
+   * itself. Metrics that do not use threads ignore this setting. */
+  virtual void SetMaximumNumberOfWorkUnits( const ThreadIdType itkNotUsed( workUnits ) ) {}
+  virtual ThreadIdType GetMaximumNumberOfWorkUnits() const
+    {
+    return 1;
+    }
+
   /** Update the parameters of the metric's active transform.
    * Typically this call is passed through directly to the transform.
    * \c factor is a scalar multiplier for each value in update, and
@@ -24,6 +24,7 @@
 #include "itkOptimizerParameterScalesEstimator.h"
 #include "itkObjectToObjectMetricBase.h"
 #include "itkIntTypes.h"
+#include <vector>
 
 namespace itk
 {
@@ -172,6 +173,7 @@ public:
    * \sa SetDoEstimateScales()
    */
   itkSetObjectMacro(ScalesEstimator, ScalesEstimatorType);
+  itkGetModifiableObjectMacro(ScalesEstimator, ScalesEstimatorType);
 
   /** Option to use ScalesEstimator for scales estimation.
    * The estimation is performed once at begin of
@@ -236,6 +238,28 @@ protected:
   ObjectToObjectOptimizerBaseTemplate();
   ~ObjectToObjectOptimizerBaseTemplate() override;
 
+  using MetricListType = std::vector< MetricTypePointer >;
+
+  /** Create initialized clones of the metric to evaluate up to
+   * \c numberOfCandidates parameter candidates concurrently, one clone per
+   * work unit. NumberOfWorkUnits is the thread budget of the whole
+   * evaluation: it bounds the number of clones, and each clone is given an
+   * equal share of it to evaluate itself. The list is empty when the metric
+   * does not support cloning or the budget allows a single evaluation at a
+   * time, in which case the candidates are evaluated with m_Metric. */
+  MetricListType CreateConcurrentMetrics( SizeValueType numberOfCandidates ) const;
+
+  /** Call function( m, candidate ) for each candidate in
+   * [0, numberOfCandidates), in parallel over \c metrics, where m is the
+   * index of the metric to evaluate the candidate with. Each metric is
+   * used by a single thread, for a contiguous block of candidates. The
+   * threads are not taken from the pool, which is left to the metrics. The
+   * first exception thrown by \c function is rethrown when all the threads
+   * are done. */
+  template< typename TFunction >
+  void EvaluateConcurrently( const MetricListType & metrics, SizeValueType numberOfCandidates,
+                             const TFunction & function ) const;
+
   MetricTypePointer             m_Metric;
   ThreadIdType                  m_NumberOfWorkUnits;
   SizeValueType                 m_CurrentIteration;
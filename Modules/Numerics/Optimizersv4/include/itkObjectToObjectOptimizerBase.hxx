@@ -20,6 +20,10 @@
 
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkMultiThreaderBase.h"
+#include "itkPlatformMultiThreader.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
 
 namespace itk
 {
@@ -104,6 +108,85 @@ ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>
     }
 }
 
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+typename ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::MetricListType
+ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>
+::CreateConcurrentMetrics( SizeValueType numberOfCandidates ) const
+{
+  MetricListType metrics;
+
+  const auto numberOfMetrics = static_cast< ThreadIdType >(
+    std::min( static_cast< SizeValueType >( this->m_NumberOfWorkUnits ), numberOfCandidates ) );
+  if( numberOfMetrics < 2 || this->m_Metric.IsNull() || !this->m_Metric->SupportsCloning() )
+    {
+    return metrics;
+    }
+  const ThreadIdType workUnitsPerMetric = std::max( this->m_NumberOfWorkUnits / numberOfMetrics,
+                                                    static_cast< ThreadIdType >( 1 ) );
+
+  for( ThreadIdType m = 0; m < numberOfMetrics; ++m )
+    {
+    MetricTypePointer metric = dynamic_cast< MetricType * >( this->m_Metric->Clone().GetPointer() );
+    if( metric.IsNull() )
+      {
+      itkExceptionMacro("The metric clone is nullptr.");
+      }
+    metric->SetMaximumNumberOfWorkUnits( workUnitsPerMetric );
+    metric->Initialize();
+    metrics.push_back( metric );
+    }
+  return metrics;
+}
+
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+template< typename TFunction >
+void
+ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>
+::EvaluateConcurrently( const MetricListType & metrics, SizeValueType numberOfCandidates,
+                        const TFunction & function ) const
+{
+  const SizeValueType numberOfMetrics = metrics.size();
+  if( numberOfMetrics == 0 || numberOfCandidates == 0 )
+    {
+    return;
+    }
+
+  std::exception_ptr exception;
+  std::mutex         exceptionMutex;
+
+  PlatformMultiThreader::Pointer threader = PlatformMultiThreader::New();
+  threader->SetNumberOfWorkUnits( static_cast< ThreadIdType >( numberOfMetrics ) );
+  threader->ParallelizeArray( 0, numberOfMetrics,
+    [&]( SizeValueType m )
+      {
+      const SizeValueType begin = m * numberOfCandidates / numberOfMetrics;
+      const SizeValueType end = ( m + 1 ) * numberOfCandidates / numberOfMetrics;
+      try
+        {
+        for( SizeValueType candidate = begin; candidate < end; ++candidate )
+          {
+          function( m, candidate );
+          }
+        }
+      catch( ... )
+        {
+        std::lock_guard< std::mutex > lock( exceptionMutex );
+        if( !exception )
+          {
+          exception = std::current_exception();
+          }
+        }
+      },
+    nullptr );
+
+  if( exception )
+    {
+    std::rethrow_exception( exception );
+    }
+}
+
 //-------------------------------------------------------------------
 template<typename TInternalComputationValueType>
 void
@@ -38,6 +38,14 @@ namespace itk
  * Users should plug-in the random unit normal variate generator using
  * SetNormalVariateGenerator method.
  *
+ * SetNumberOfOffspring turns the strategy into a (1+lambda) one: each
+ * iteration draws that many offspring around the parent, and the best of
+ * them competes with the parent. When the metric supports cloning, the
+ * offspring are evaluated concurrently on clones of the metric, sharing the
+ * NumberOfWorkUnits of the optimizer. The offspring are drawn serially, so
+ * the search does not depend on the number of work units. The default, a
+ * single offspring, is the original 1+1 strategy.
+ *
  * The SetEpsilon method is the minimum value for the frobenius_norm of
  * the covariance matrix. If the fnorm is smaller than this value,
  * the optimization process will stop even before it hits the maximum
@@ -114,6 +122,11 @@ public:
   itkSetMacro(InitialRadius, double);
   itkGetConstReferenceMacro(InitialRadius, double);
 
+  /** Set/Get the number of offspring drawn at each iteration. Defaults
+   * to 1. */
+  itkSetClampMacro(NumberOfOffspring, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstReferenceMacro(NumberOfOffspring, unsigned int);
+
   /** Set/Get the minimal size of search radius
    * (frobenius_norm of covariance matrix). */
   itkSetMacro(Epsilon, double);
@@ -172,6 +185,9 @@ private:
   /** Maximum iteration limit. */
   unsigned int m_MaximumIteration;
 
+  /** Number of offspring drawn at each iteration. */
+  unsigned int m_NumberOfOffspring;
+
   bool   m_CatchGetValueException;
   double m_MetricWorstPossibleValue;
 
@@ -21,6 +21,7 @@
 #include "itkMath.h"
 #include "itkOnePlusOneEvolutionaryOptimizerv4.h"
 #include "vnl/vnl_matrix.h"
+#include <vector>
 namespace itk
 {
 template<typename TInternalComputationValueType>
@@ -38,6 +39,7 @@ OnePlusOneEvolutionaryOptimizerv4<TInternalComputationValueType>
   m_ShrinkFactor = std::pow(m_GrowthFactor, -0.25);
   m_InitialRadius = 1.01;
   m_MaximumIteration = 100;
+  m_NumberOfOffspring = 1;
   m_Stop = false;
   m_StopConditionDescription.str("");
   m_CurrentCost = 0;
@@ -155,6 +157,41 @@ OnePlusOneEvolutionaryOptimizerv4<TInternalComputationValueType>
     A(i, i) = m_InitialRadius / scales[i];
     }
 
+  std::vector< vnl_vector< double > > offspringNorms( m_NumberOfOffspring, vnl_vector< double >( spaceDimension ) );
+  std::vector< double >               offspringValues( m_NumberOfOffspring );
+
+  // Evaluate an offspring, given by its random vector, with a metric.
+  auto evaluateOffspring = [&]( typename Superclass::MetricType * metric, unsigned int o ) -> double
+    {
+    const vnl_vector< double > offspring = parent + A * offspringNorms[o];
+    ParametersType             offspringPosition( spaceDimension );
+    for ( unsigned int i = 0; i < spaceDimension; i++ )
+      {
+      offspringPosition[i] = offspring[i];
+      }
+    // Update the metric so we can check the metric value in offspringPosition
+    metric->SetParameters( offspringPosition );
+
+    double value = m_MetricWorstPossibleValue;
+    try
+      {
+      value = metric->GetValue();
+      }
+    catch ( ... )
+      {
+      if ( !m_CatchGetValueException )
+        {
+        throw;
+        }
+      }
+    return value;
+    };
+
+  // Clones of the metric to evaluate the offspring concurrently, if any.
+  const typename Superclass::MetricListType metrics =
+    m_NumberOfOffspring > 1 ? this->CreateConcurrentMetrics( m_NumberOfOffspring )
+                            : typename Superclass::MetricListType();
+
   for ( this->m_CurrentIteration = 0;
         this->m_CurrentIteration < m_MaximumIteration;
         this->m_CurrentIteration++ )
@@ -167,44 +204,56 @@ OnePlusOneEvolutionaryOptimizerv4<TInternalComputationValueType>
       break;
       }
 
-    for ( unsigned int i = 0; i < spaceDimension; i++ )
+    // Draw all the offspring first, so that the random sequence does not
+    // depend on how they are evaluated.
+    for ( unsigned int o = 0; o < m_NumberOfOffspring; o++ )
       {
-      if ( !m_RandomGenerator )
+      for ( unsigned int i = 0; i < spaceDimension; i++ )
         {
-        itkExceptionMacro(<< "Random Generator is not set!");
+        if ( !m_RandomGenerator )
+          {
+          itkExceptionMacro(<< "Random Generator is not set!");
+          }
+        offspringNorms[o][i] = m_RandomGenerator->GetVariate();
         }
-      f_norm[i] = m_RandomGenerator->GetVariate();
-      }
-
-    delta  = A * f_norm;
-    child  = parent + delta;
-
-    for ( unsigned int i = 0; i < spaceDimension; i++ )
-      {
-      childPosition[i] = child[i];
       }
-    // Update the metric so we can check the metric value in childPosition
-    this->m_Metric->SetParameters( childPosition );
 
-    double cvalue = m_MetricWorstPossibleValue;
-    try
+    if ( metrics.empty() )
       {
-      cvalue = this->m_Metric->GetValue();
-      // While we got the metric value in childPosition,
+      for ( unsigned int o = 0; o < m_NumberOfOffspring; o++ )
+        {
+        offspringValues[o] = evaluateOffspring( this->m_Metric, o );
+        }
+      // While we got the metric values of the offspring,
       // the metric parameteres are set back to parentPosition
       this->m_Metric->SetParameters( parentPosition );
       }
-    catch ( ... )
+    else
       {
-      if ( m_CatchGetValueException )
-        {
-        cvalue = m_MetricWorstPossibleValue;
-        }
-      else
+      this->EvaluateConcurrently( metrics, m_NumberOfOffspring,
+        [&]( SizeValueType m, SizeValueType o )
+          {
+          offspringValues[o] = evaluateOffspring( metrics[m], static_cast< unsigned int >( o ) );
+          } );
+      }
+
+    // The best offspring competes with the parent.
+    unsigned int bestOffspring = 0;
+    for ( unsigned int o = 1; o < m_NumberOfOffspring; o++ )
+      {
+      if ( offspringValues[o] < offspringValues[bestOffspring] )
         {
-        throw;
+        bestOffspring = o;
         }
       }
+    f_norm = offspringNorms[bestOffspring];
+    delta  = A * f_norm;
+    child  = parent + delta;
+    for ( unsigned int i = 0; i < spaceDimension; i++ )
+      {
+      childPosition[i] = child[i];
+      }
+    const double cvalue = offspringValues[bestOffspring];
 
     itkDebugMacro(<< "iter: " << this->m_CurrentIteration << ": parent position: "
                   << parentPosition);
@@ -320,6 +369,7 @@ OnePlusOneEvolutionaryOptimizerv4<TInternalComputationValueType>
     os << indent << "Random Generator  " << "(none)" << std::endl;
     }
   os << indent << "Maximum Iteration " << GetMaximumIteration() << std::endl;
+  os << indent << "Number Of Offspring " << GetNumberOfOffspring() << std::endl;
   os << indent << "Epsilon           " << GetEpsilon()          << std::endl;
   os << indent << "Initial Radius    " << GetInitialRadius()    << std::endl;
   os << indent << "Growth Fractor    " << GetGrowthFactor()     << std::endl;
@@ -21,6 +21,7 @@
 #include "itkObject.h"
 #include "itkObjectFactory.h"
 #include "itkOptimizerParameters.h"
+#include "itkObjectToObjectMetricBase.h"
 
 namespace itk
 {
@@ -57,6 +58,9 @@ public:
   /** Type of float */
   using FloatType = TInternalComputationValueType;
 
+  /** Type of the metrics an estimator can be used with. */
+  using MetricBaseType = ObjectToObjectMetricBaseTemplate<TInternalComputationValueType>;
+
   /** Estimate parameter scales. */
   virtual void EstimateScales(ScalesType &scales) = 0;
 
@@ -70,6 +74,16 @@ public:
   /** Estimate the maximum size for steps. */
   virtual FloatType EstimateMaximumStepSize() = 0;
 
+  /** Return a copy of this estimator, with the same settings, that
+   * estimates the scales for \c metric instead. Optimizers that evaluate
+   * clones of their metric concurrently use this to give each clone its
+   * own estimator. Returns nullptr if the estimator cannot be used with
+   * \c metric, which is the default. */
+  virtual Pointer CloneForMetric( MetricBaseType * itkNotUsed( metric ) ) const
+    {
+    return nullptr;
+    }
+
 protected:
   OptimizerParameterScalesEstimatorTemplate()= default;
   ~OptimizerParameterScalesEstimatorTemplate() override = default;
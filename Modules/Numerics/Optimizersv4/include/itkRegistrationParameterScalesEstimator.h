@@ -134,6 +134,13 @@ public:
   /** the radius of the central region for sampling. */
   itkSetMacro(CentralRegionRadius, IndexValueType);
 
+  /** Set/Get the number of work units used to process the sample points.
+   * The samples are split into chunks of fixed size, so that the
+   * estimates do not depend on the number of work units. Defaults to the
+   * global default number of threads. */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+
   /** Estimate parameter scales */
   void EstimateScales(ScalesType &scales) override = 0;
 
@@ -146,6 +153,10 @@ public:
   /** Estimate the trusted scale for steps. It returns the voxel spacing. */
   FloatType EstimateMaximumStepSize() override;
 
+  /** Return a clone of this estimator that uses \c metric, which must be
+   * of type TMetric. */
+  typename Superclass::Pointer CloneForMetric( typename Superclass::MetricBaseType * metric ) const override;
+
   /** Set the sampling strategy automatically for scales estimation. */
   virtual void SetScalesSamplingStrategy();
 
@@ -156,6 +167,10 @@ protected:
   RegistrationParameterScalesEstimator();
   ~RegistrationParameterScalesEstimator() override = default;
 
+  /** Clone method will clone the existing instance of this type,
+   *  including its settings. The clone uses the same metric. */
+  typename LightObject::Pointer InternalClone() const override;
+
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
   /** Check the metric and the transforms. */
@@ -238,6 +253,22 @@ protected:
   /** Get the dimension of the target transformed to. */
   SizeValueType GetDimension();
 
+  /** Get the number of chunks the sample points are split into for
+   * parallel processing. */
+  SizeValueType GetNumberOfSampleChunks() const;
+
+  /** Call function(chunk, begin, end) for each chunk of sample points,
+   * where [begin, end) is the range of sample indices of the chunk. The
+   * chunks are processed in parallel and the function must only write
+   * to data owned by its chunk. */
+  template< typename TFunction >
+  void ParallelizeOverSampleChunks(const TFunction & function);
+
+  /** Get the offsets of the sample points in the virtual image, i.e.
+   * the local parameter offsets divided by the number of local
+   * parameters. They are computed once per sampling. */
+  const std::vector< OffsetValueType > & GetSampleVirtualOffsets();
+
   /** Get the current sampling strategy. Note that this is changed
    * internally as the class is used for scale or step estimation. */
   itkGetMacro( SamplingStrategy, SamplingStrategyType )
@@ -262,6 +293,9 @@ protected:
   // the threadhold to decide if the number of random samples uses logarithm
   static constexpr SizeValueType    SizeOfSmallDomain = 1000;
 
+  // the number of sample points processed by a work unit at a time
+  static constexpr SizeValueType    SizeOfSampleChunk = 256;
+
 private:
   /** m_TransformForward specifies which transform scales to be estimated.
    * m_TransformForward = true (default) for the moving transform parameters.
@@ -272,6 +306,13 @@ private:
   // sampling stategy
   SamplingStrategyType          m_SamplingStrategy;
 
+  ThreadIdType                  m_NumberOfWorkUnits;
+
+  /** Virtual image offsets of the samples, and the sampling time they
+   * were computed for. */
+  std::vector< OffsetValueType > m_SampleVirtualOffsets;
+  ModifiedTimeType               m_SampleVirtualOffsetsTime{ 0 };
+
 }; //class RegistrationParameterScalesEstimator
 
 
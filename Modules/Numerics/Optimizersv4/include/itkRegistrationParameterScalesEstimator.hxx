@@ -23,6 +23,7 @@
 #include "itkCompositeTransform.h"
 #include "itkPointSet.h"
 #include "itkObjectToObjectMetric.h"
+#include "itkMultiThreaderBase.h"
 
 namespace itk
 {
@@ -43,6 +44,8 @@ RegistrationParameterScalesEstimator< TMetric >
   // the default radius of the central region for sampling
   this->m_CentralRegionRadius = 5;
 
+  this->m_NumberOfWorkUnits = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+
   // the metric object must be set before EstimateScales()
 }
 
@@ -71,6 +74,44 @@ RegistrationParameterScalesEstimator< TMetric >
   return minSpacing;
 }
 
+template< typename TMetric >
+typename RegistrationParameterScalesEstimator< TMetric >::Superclass::Pointer
+RegistrationParameterScalesEstimator< TMetric >
+::CloneForMetric( typename Superclass::MetricBaseType * metric ) const
+{
+  auto * typedMetric = dynamic_cast< MetricType * >( metric );
+  if( typedMetric == nullptr )
+    {
+    return nullptr;
+    }
+  typename Self::Pointer clone = dynamic_cast< Self * >( this->Clone().GetPointer() );
+  clone->SetMetric( typedMetric );
+  return clone.GetPointer();
+}
+
+template< typename TMetric >
+typename LightObject::Pointer
+RegistrationParameterScalesEstimator< TMetric >
+::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast< Self * >( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->m_Metric = this->m_Metric;
+  rval->m_TransformForward = this->m_TransformForward;
+  rval->m_SamplingStrategy = this->m_SamplingStrategy;
+  rval->m_NumberOfRandomSamples = this->m_NumberOfRandomSamples;
+  rval->m_CentralRegionRadius = this->m_CentralRegionRadius;
+  rval->m_VirtualDomainPointSet = this->m_VirtualDomainPointSet;
+  rval->m_NumberOfWorkUnits = this->m_NumberOfWorkUnits;
+
+  return loPtr;
+}
+
 /** Validate and set metric and its transforms. */
 template< typename TMetric >
 bool
@@ -702,6 +743,64 @@ RegistrationParameterScalesEstimator< TMetric >
   this->SampleVirtualDomainWithRegion(region);
 }
 
+template< typename TMetric >
+SizeValueType
+RegistrationParameterScalesEstimator< TMetric >
+::GetNumberOfSampleChunks() const
+{
+  return ( static_cast< SizeValueType >( this->m_SamplePoints.size() ) + SizeOfSampleChunk - 1 ) / SizeOfSampleChunk;
+}
+
+template< typename TMetric >
+template< typename TFunction >
+void
+RegistrationParameterScalesEstimator< TMetric >
+::ParallelizeOverSampleChunks(const TFunction & function)
+{
+  const auto numSamples = static_cast< SizeValueType >( this->m_SamplePoints.size() );
+  const SizeValueType numChunks = this->GetNumberOfSampleChunks();
+
+  auto processChunk = [&]( SizeValueType chunk )
+    {
+    const SizeValueType begin = chunk * SizeOfSampleChunk;
+    const SizeValueType end = std::min( begin + SizeOfSampleChunk, numSamples );
+    function( chunk, begin, end );
+    };
+
+  if ( numChunks < 2 || this->m_NumberOfWorkUnits < 2 )
+    {
+    for ( SizeValueType chunk = 0; chunk < numChunks; ++chunk )
+      {
+      processChunk( chunk );
+      }
+    return;
+    }
+
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits( this->m_NumberOfWorkUnits );
+  multiThreader->ParallelizeArray( 0, numChunks, processChunk, nullptr );
+}
+
+template< typename TMetric >
+const std::vector< OffsetValueType > &
+RegistrationParameterScalesEstimator< TMetric >
+::GetSampleVirtualOffsets()
+{
+  if ( this->m_SampleVirtualOffsetsTime != this->m_SamplingTime.GetMTime()
+       || this->m_SampleVirtualOffsets.size() != this->m_SamplePoints.size() )
+    {
+    const auto numSamples = static_cast< SizeValueType >( this->m_SamplePoints.size() );
+    this->m_SampleVirtualOffsets.resize( numSamples );
+    for ( SizeValueType c = 0; c < numSamples; c++ )
+      {
+      this->m_SampleVirtualOffsets[c] = this->m_Metric->ComputeParameterOffsetFromVirtualPoint(
+        this->m_SamplePoints[c], NumericTraits< SizeValueType >::OneValue() );
+      }
+    this->m_SampleVirtualOffsetsTime = this->m_SamplingTime.GetMTime();
+    }
+  return this->m_SampleVirtualOffsets;
+}
+
 /**
  * Print the information about this class.
  */
@@ -720,6 +819,7 @@ RegistrationParameterScalesEstimator< TMetric >
 
   os << indent << "m_TransformForward = " << this->m_TransformForward << std::endl;
   os << indent << "m_SamplingStrategy = " << this->m_SamplingStrategy << std::endl;
+  os << indent << "m_NumberOfWorkUnits = " << this->m_NumberOfWorkUnits << std::endl;
 
   os << indent << "m_VirtualDomainPointSet = " << this->m_VirtualDomainPointSet.GetPointer() << std::endl;
 }
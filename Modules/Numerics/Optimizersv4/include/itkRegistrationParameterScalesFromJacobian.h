@@ -19,6 +19,10 @@
 #define itkRegistrationParameterScalesFromJacobian_h
 
 #include "itkRegistrationParameterScalesEstimator.h"
+#include "itkAffineTransform.h"
+#include "itkScaleTransform.h"
+
+#include <typeinfo>
 
 namespace itk
 {
@@ -107,6 +111,38 @@ protected:
    *  voxel from a change on the transform.
    */
   void ComputeSampleStepScales(const ParametersType &step, ScalesType &sampleScales);
+
+  /** Compute the transform Jacobian at the sample point c, or retrieve it
+   * from the cache when it is valid. */
+  void ComputeSampleJacobian(SizeValueType c, JacobianType & jacobian, JacobianType & jacobianCache);
+
+  /** Fill the cache of the transform Jacobians at the sample points if
+   * it is not valid anymore. The cache is only used for transforms
+   * without local support, whose Jacobians at a few thousand samples are
+   * small. It stays valid across calls as long as the samples, the
+   * fixed parameters and, unless the Jacobian does not depend on them,
+   * the parameters of the transform are unchanged. */
+  void UpdateSampleJacobianCache();
+
+  /** Check whether the Jacobian of the transform with respect to its
+   * parameters is independent of the parameter values. */
+  bool TransformJacobianIsParameterIndependent();
+
+  /** The templated version of TransformJacobianIsParameterIndependent. */
+  template< typename TTransform > bool TransformJacobianIsParameterIndependentTemplated();
+
+private:
+  // the largest number of Jacobian entries kept in the cache
+  static constexpr SizeValueType MaximumSizeOfSampleJacobianCache = 1 << 24;
+
+  using TransformBaseType = TransformBaseTemplate< typename TMetric::MeasureType >;
+
+  std::vector< JacobianType >                        m_SampleJacobians;
+  bool                                               m_SampleJacobiansValid{ false };
+  ModifiedTimeType                                   m_SampleJacobiansSamplingTime{ 0 };
+  const void *                                       m_SampleJacobiansTransform{ nullptr };
+  typename TransformBaseType::ParametersType         m_SampleJacobiansParameters;
+  typename TransformBaseType::FixedParametersType    m_SampleJacobiansFixedParameters;
 }; //class RegistrationParameterScalesFromJacobian
 
 
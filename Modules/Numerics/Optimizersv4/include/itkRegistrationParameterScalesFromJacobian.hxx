@@ -47,21 +47,55 @@ RegistrationParameterScalesFromJacobian< TMetric >
 
   ParametersType norms(numPara);
 
-  const auto numSamples = static_cast<const SizeValueType>( this->m_SamplePoints.size() );
-
   norms.Fill( NumericTraits< typename ParametersType::ValueType >::ZeroValue() );
   parameterScales.Fill( NumericTraits< typename ScalesType::ValueType >::OneValue() );
 
-  // checking each sample point
-  for (SizeValueType c=0; c<numSamples; c++)
-    {
-    const VirtualPointType point = this->m_SamplePoints[c];
+  const auto numSamples = static_cast<const SizeValueType>( this->m_SamplePoints.size() );
+  const SizeValueType dim = this->GetDimension();
+  this->UpdateSampleJacobianCache();
+  const bool useCache = this->m_SampleJacobiansValid;
+
+  // Each chunk of samples accumulates its own norms, which are then
+  // summed in a fixed order.
+  std::vector< ParametersType > chunkNorms( this->GetNumberOfSampleChunks() );
+
+  this->ParallelizeOverSampleChunks(
+    [&]( SizeValueType chunk, SizeValueType begin, SizeValueType end )
+      {
+      ParametersType & localNorms = chunkNorms[chunk];
+      localNorms.SetSize(numPara);
+      localNorms.Fill( NumericTraits< typename ParametersType::ValueType >::ZeroValue() );
+
+      ParametersType squaredNorms(numPara);
+      JacobianType   jacobian;
+      JacobianType   jacobianCache;
 
-    ParametersType squaredNorms(numPara);
-    this->ComputeSquaredJacobianNorms( point, squaredNorms );
+      for (SizeValueType c=begin; c<end; c++)
+        {
+        if ( useCache )
+          {
+          this->ComputeSampleJacobian( c, jacobian, jacobianCache );
+          for (SizeValueType p=0; p<numPara; p++)
+            {
+            squaredNorms[p] = NumericTraits< typename ParametersType::ValueType >::ZeroValue();
+            for (SizeValueType d=0; d<dim; d++)
+              {
+              squaredNorms[p] += jacobian[d][p] * jacobian[d][p];
+              }
+            }
+          }
+        else
+          {
+          this->ComputeSquaredJacobianNorms( this->m_SamplePoints[c], squaredNorms );
+          }
+        localNorms += squaredNorms;
+        }
+      } );
 
-    norms = norms + squaredNorms;
-    } //for numSamples
+  for ( const auto & localNorms : chunkNorms )
+    {
+    norms += localNorms;
+    }
 
   if (numSamples > 0)
     {
@@ -122,7 +156,6 @@ RegistrationParameterScalesFromJacobian< TMetric >
   ScalesType sampleScales;
   this->ComputeSampleStepScales(step, sampleScales);
 
-  const auto numSamples = static_cast<const SizeValueType>( this->m_SamplePoints.size() );
   const SizeValueType numPara = this->GetNumberOfLocalParameters();
   const SizeValueType numAllPara = this->GetTransform()->GetNumberOfParameters();
   const SizeValueType numLocals = numAllPara / numPara;
@@ -130,12 +163,14 @@ RegistrationParameterScalesFromJacobian< TMetric >
   localStepScales.SetSize(numLocals);
   localStepScales.Fill(NumericTraits<typename ScalesType::ValueType>::ZeroValue());
 
+  // the offsets of the samples are cached along with the samples
+  const std::vector< OffsetValueType > & sampleOffsets = this->GetSampleVirtualOffsets();
+  const auto numSamples = static_cast<const SizeValueType>( sampleOffsets.size() );
+
   // checking each sample point
   for (SizeValueType c=0; c<numSamples; c++)
     {
-    VirtualPointType &point = this->m_SamplePoints[c];
-    IndexValueType localId = this->m_Metric->ComputeParameterOffsetFromVirtualPoint( point, NumericTraits<SizeValueType>::OneValue());
-    localStepScales[localId] = sampleScales[c];
+    localStepScales[sampleOffsets[c]] = sampleScales[c];
     }
 
 }
@@ -152,57 +187,198 @@ RegistrationParameterScalesFromJacobian< TMetric >
   const auto numSamples = static_cast<const SizeValueType>( this->m_SamplePoints.size() );
   const SizeValueType dim = this->GetDimension();
   const SizeValueType numPara = this->GetNumberOfLocalParameters();
+  const bool isDisplacementFieldTransform = this->IsDisplacementFieldTransform();
 
   sampleScales.SetSize(numSamples);
 
-  itk::Array<FloatType> dTdt(dim);
+  this->UpdateSampleJacobianCache();
 
-  JacobianType jacobianCache;
-  JacobianType jacobian(dim,
-                        (this->GetTransformForward() ?
-                         this->m_Metric->GetMovingTransform()->GetNumberOfParameters()
-                         : this->m_Metric->GetFixedTransform()->GetNumberOfParameters()));
+  const std::vector< OffsetValueType > * sampleOffsets = nullptr;
+  if ( isDisplacementFieldTransform )
+    {
+    sampleOffsets = &this->GetSampleVirtualOffsets();
+    }
 
+  this->ParallelizeOverSampleChunks(
+    [&]( SizeValueType, SizeValueType begin, SizeValueType end )
+      {
+      itk::Array<FloatType> dTdt(dim);
+      ParametersType        localStep(numPara);
 
-  // checking each sample point
-  for (SizeValueType c=0; c<numSamples; c++)
+      JacobianType jacobianCache;
+      JacobianType jacobian(dim,
+                            (this->GetTransformForward() ?
+                             this->m_Metric->GetMovingTransform()->GetNumberOfParameters()
+                             : this->m_Metric->GetFixedTransform()->GetNumberOfParameters()));
+
+      // checking each sample point
+      for (SizeValueType c=begin; c<end; c++)
+        {
+        this->ComputeSampleJacobian( c, jacobian, jacobianCache );
+
+        if( !isDisplacementFieldTransform )
+          {
+          dTdt = jacobian * step;
+          }
+        else
+          {
+          const SizeValueType offset = ( *sampleOffsets )[c] * numPara;
+          for (SizeValueType p=0; p<numPara; p++)
+            {
+            localStep[p] = step[offset + p];
+            }
+          dTdt = jacobian * localStep;
+          }
+
+        sampleScales[c] = dTdt.two_norm();
+        }
+      } );
+}
+
+/**
+ * Compute the transform Jacobian at a sample point, using the cache
+ * when it is valid.
+ */
+template< typename TMetric >
+void
+RegistrationParameterScalesFromJacobian< TMetric >
+::ComputeSampleJacobian(SizeValueType c, JacobianType & jacobian, JacobianType & jacobianCache)
+{
+  if ( this->m_SampleJacobiansValid )
     {
-    const VirtualPointType &point = this->m_SamplePoints[c];
+    jacobian = this->m_SampleJacobians[c];
+    return;
+    }
 
-    if (this->GetTransformForward())
-      {
-      this->m_Metric->GetMovingTransform()->
-        ComputeJacobianWithRespectToParametersCachedTemporaries(point,
-                                                                jacobian,
-                                                                jacobianCache);
-      }
-    else
-      {
-      this->m_Metric->GetFixedTransform()->
-        ComputeJacobianWithRespectToParametersCachedTemporaries(point,
-                                                                jacobian,
-                                                                jacobianCache);
-      }
+  const VirtualPointType &point = this->m_SamplePoints[c];
+  if (this->GetTransformForward())
+    {
+    this->m_Metric->GetMovingTransform()->
+      ComputeJacobianWithRespectToParametersCachedTemporaries(point,
+                                                              jacobian,
+                                                              jacobianCache);
+    }
+  else
+    {
+    this->m_Metric->GetFixedTransform()->
+      ComputeJacobianWithRespectToParametersCachedTemporaries(point,
+                                                              jacobian,
+                                                              jacobianCache);
+    }
+}
 
-    if( !this->IsDisplacementFieldTransform() )
-      {
-      dTdt = jacobian * step;
-      }
-    else
-      {
-      SizeValueType offset = this->m_Metric->ComputeParameterOffsetFromVirtualPoint(point, numPara);
+/**
+ * Compute the transform Jacobians at all sample points, unless the
+ * cached ones are still valid.
+ */
+template< typename TMetric >
+void
+RegistrationParameterScalesFromJacobian< TMetric >
+::UpdateSampleJacobianCache()
+{
+  const TransformBaseType * transform = this->GetTransform();
+  const auto numSamples = static_cast< SizeValueType >( this->m_SamplePoints.size() );
+  const SizeValueType dim = this->GetDimension();
+  const SizeValueType numAllPara = transform->GetNumberOfParameters();
+
+  // The Jacobians of transforms with local support are not cached:
+  // they are large and sampled over the full domain.
+  if ( this->TransformHasLocalSupportForScalesEstimation()
+       || numSamples * dim * numAllPara > MaximumSizeOfSampleJacobianCache )
+    {
+    this->m_SampleJacobiansValid = false;
+    this->m_SampleJacobians.clear();
+    return;
+    }
+
+  const bool parameterIndependent = this->TransformJacobianIsParameterIndependent();
+
+  if ( this->m_SampleJacobiansValid
+       && this->m_SampleJacobiansSamplingTime == this->m_SamplingTime.GetMTime()
+       && this->m_SampleJacobiansTransform == transform
+       && this->m_SampleJacobians.size() == this->m_SamplePoints.size()
+       && this->m_SampleJacobiansFixedParameters == transform->GetFixedParameters()
+       && ( parameterIndependent || this->m_SampleJacobiansParameters == transform->GetParameters() ) )
+    {
+    return;
+    }
+
+  this->m_SampleJacobiansValid = false;
+  this->m_SampleJacobians.resize( numSamples );
 
-      ParametersType localStep(numPara);
-      for (SizeValueType p=0; p<numPara; p++)
+  this->ParallelizeOverSampleChunks(
+    [&]( SizeValueType, SizeValueType begin, SizeValueType end )
+      {
+      JacobianType jacobianCache;
+      for (SizeValueType c=begin; c<end; c++)
         {
-        localStep[p] = step[offset + p];
+        this->m_SampleJacobians[c].SetSize( dim, numAllPara );
+        this->ComputeSampleJacobian( c, this->m_SampleJacobians[c], jacobianCache );
         }
-      dTdt = jacobian * localStep;
-      }
+      } );
 
-    sampleScales[c] = dTdt.two_norm();
+  this->m_SampleJacobiansSamplingTime = this->m_SamplingTime.GetMTime();
+  this->m_SampleJacobiansTransform = transform;
+  this->m_SampleJacobiansFixedParameters = transform->GetFixedParameters();
+  if ( parameterIndependent )
+    {
+    this->m_SampleJacobiansParameters.SetSize( 0 );
+    }
+  else
+    {
+    this->m_SampleJacobiansParameters = transform->GetParameters();
     }
+  this->m_SampleJacobiansValid = true;
+}
+
+/**
+ * Check whether the Jacobian of the transform with respect to its
+ * parameters only depends on the point and on the fixed parameters.
+ */
+template< typename TMetric >
+bool
+RegistrationParameterScalesFromJacobian< TMetric >
+::TransformJacobianIsParameterIndependent()
+{
+  if (this->GetTransformForward())
+    {
+    return this->TransformJacobianIsParameterIndependentTemplated<MovingTransformType>();
+    }
+  else
+    {
+    return this->TransformJacobianIsParameterIndependentTemplated<FixedTransformType>();
+    }
+}
+
+/**
+ * The templated version of TransformJacobianIsParameterIndependent.
+ *
+ * Only the exact types of AffineTransform, TranslationTransform,
+ * ScaleTransform and IdentityTransform qualify. Their subclasses are
+ * excluded since they may change the parameterization, e.g.
+ * ScaleLogarithmicTransform or CenteredAffineTransform, whose Jacobians
+ * depend on the parameters.
+ */
+template< typename TMetric >
+template< typename TTransform >
+bool
+RegistrationParameterScalesFromJacobian< TMetric >
+::TransformJacobianIsParameterIndependentTemplated()
+{
+  using ScalarType = typename TTransform::ScalarType;
+  const SizeValueType InputSpaceDimension = TTransform::InputSpaceDimension;
+
+  using AffineTransformType = AffineTransform<ScalarType, InputSpaceDimension>;
+  using TranslationTransformType = TranslationTransform<ScalarType, InputSpaceDimension>;
+  using ScaleTransformType = ScaleTransform<ScalarType, InputSpaceDimension>;
+  using IdentityTransformType = IdentityTransform<ScalarType, InputSpaceDimension>;
+
+  const std::type_info & transformType = typeid( *this->GetTransform() );
 
+  return transformType == typeid( AffineTransformType )
+    || transformType == typeid( TranslationTransformType )
+    || transformType == typeid( ScaleTransformType )
+    || transformType == typeid( IdentityTransformType );
 }
 
 /** Print the information about this class */
@@ -75,6 +75,21 @@ private:
   template <typename TTransform>
   void ComputeSampleShiftsInternal(const ParametersType &deltaParameters, ScalesType &localShifts);
 
+  /** Map the sample points with the current transform, in parallel, into
+   * a flat array of coordinates. */
+  template <typename TTransform>
+  void MapSamplePoints(std::vector< FloatType > & mappedPoints);
+
+  using TransformBaseType = TransformBaseTemplate< typename TMetric::MeasureType >;
+
+  /** The sample points mapped by the unmodified transform. They are
+   * reused by successive calls as long as the samples and the transform
+   * are unchanged, e.g. by the per-parameter shifts of EstimateScales(). */
+  std::vector< FloatType > m_MappedSamplePoints;
+  ModifiedTimeType         m_MappedSamplePointsSamplingTime{ 0 };
+  const void *             m_MappedSamplePointsTransform{ nullptr };
+  ModifiedTimeType         m_MappedSamplePointsTransformTime{ 0 };
+
 }; //class RegistrationParameterScalesFromPhysicalShift
 
 }  // namespace itk
@@ -48,44 +48,76 @@ void
 RegistrationParameterScalesFromPhysicalShift< TMetric >
 ::ComputeSampleShiftsInternal(const ParametersType &deltaParameters, ScalesType &sampleShifts)
 {
-  using TransformOutputType = typename TTransform::OutputPointType;
-
   // We save the old parameters and apply the delta parameters to calculate the
   // voxel shift. After it is done, we will reset to the old parameters.
-  auto * transform = const_cast<TransformBaseTemplate<typename TMetric::MeasureType> *>(this->GetTransform());
+  auto * transform = const_cast<TransformBaseType *>(this->GetTransform());
   const ParametersType oldParameters = transform->GetParameters();
 
   const auto numSamples = static_cast<const SizeValueType>( this->m_SamplePoints.size() );
-
-  VirtualPointType point;
-  TransformOutputType newMappedVoxel;
-
-  // store the old mapped indices to reduce calls to Transform::SetParameters()
-  std::vector<TransformOutputType> oldMappedVoxels(numSamples);
-  sampleShifts.SetSize(numSamples);
-
-  // compute the indices mapped by the old transform
-  for (SizeValueType c=0; c<numSamples; c++)
+  const SizeValueType dim = this->GetDimension();
+
+  // The points mapped by the old transform are kept between calls, as
+  // long as the transform has not been modified since it was restored at
+  // the end of the previous call.
+  if ( this->m_MappedSamplePointsSamplingTime != this->m_SamplingTime.GetMTime()
+       || this->m_MappedSamplePointsTransform != transform
+       || this->m_MappedSamplePointsTransformTime != transform->GetMTime()
+       || this->m_MappedSamplePoints.size() != numSamples * dim )
     {
-    point = this->m_SamplePoints[c];
-    this->template TransformPoint<TransformOutputType>(point, oldMappedVoxels[c]);
+    this->template MapSamplePoints<TTransform>( this->m_MappedSamplePoints );
+    this->m_MappedSamplePointsSamplingTime = this->m_SamplingTime.GetMTime();
+    this->m_MappedSamplePointsTransform = transform;
     }
 
   // Apply the delta parameters to the transform
   this->UpdateTransformParameters(deltaParameters);
 
-  // compute the indices mapped by the new transform
+  // compute the points mapped by the new transform
+  std::vector< FloatType > newMappedPoints;
+  this->template MapSamplePoints<TTransform>( newMappedPoints );
+
+  // find the local shift for each sample point
+  sampleShifts.SetSize(numSamples);
   for (SizeValueType c=0; c<numSamples; c++)
     {
-    point = this->m_SamplePoints[c];
-    this->template TransformPoint<TransformOutputType>(point, newMappedVoxel);
-
-    // find the local shift for each sample point
-    sampleShifts[c] = newMappedVoxel.EuclideanDistanceTo(oldMappedVoxels[c]);
-  }
+    FloatType squaredDistance = NumericTraits< FloatType >::ZeroValue();
+    for (SizeValueType d=0; d<dim; d++)
+      {
+      squaredDistance += itk::Math::sqr( newMappedPoints[c * dim + d] - this->m_MappedSamplePoints[c * dim + d] );
+      }
+    sampleShifts[c] = std::sqrt( squaredDistance );
+    }
 
   // restore the parameters in the transform
   transform->SetParameters(oldParameters);
+  this->m_MappedSamplePointsTransformTime = transform->GetMTime();
+}
+
+template< typename TMetric >
+template< typename TTransform >
+void
+RegistrationParameterScalesFromPhysicalShift< TMetric >
+::MapSamplePoints(std::vector< FloatType > & mappedPoints)
+{
+  using TransformOutputType = typename TTransform::OutputPointType;
+
+  const auto numSamples = static_cast<const SizeValueType>( this->m_SamplePoints.size() );
+  const SizeValueType dim = this->GetDimension();
+  mappedPoints.resize( numSamples * dim );
+
+  this->ParallelizeOverSampleChunks(
+    [&]( SizeValueType, SizeValueType begin, SizeValueType end )
+      {
+      TransformOutputType mappedPoint;
+      for (SizeValueType c=begin; c<end; c++)
+        {
+        this->template TransformPoint<TransformOutputType>( this->m_SamplePoints[c], mappedPoint );
+        for (SizeValueType d=0; d<dim; d++)
+          {
+          mappedPoints[c * dim + d] = mappedPoint[d];
+          }
+        }
+      } );
 }
 
 /** Print the information about this class */
@@ -88,6 +88,10 @@ protected:
   RegistrationParameterScalesFromShiftBase();
   ~RegistrationParameterScalesFromShiftBase() override = default;
 
+  /** Clone method will clone the existing instance of this type,
+   *  including its settings. */
+  typename LightObject::Pointer InternalClone() const override;
+
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
   /** Compute the shift in voxels when deltaParameters is applied onto the
@@ -188,12 +188,12 @@ RegistrationParameterScalesFromShiftBase< TMetric >
   localStepScales.SetSize(numLocals);
   localStepScales.Fill(NumericTraits<typename ScalesType::ValueType>::ZeroValue());
 
-  const auto numSamples = static_cast< const SizeValueType >( this->m_SamplePoints.size() );
+  // the offsets of the samples are cached along with the samples
+  const std::vector< OffsetValueType > & sampleOffsets = this->GetSampleVirtualOffsets();
+  const auto numSamples = static_cast< const SizeValueType >( sampleOffsets.size() );
   for (SizeValueType c=0; c<numSamples; c++)
     {
-    VirtualPointType &point = this->m_SamplePoints[c];
-    IndexValueType localId = this->m_Metric->ComputeParameterOffsetFromVirtualPoint( point, numPara) / numPara;
-    localStepScales[localId] = sampleShifts[c];
+    localStepScales[sampleOffsets[c]] = sampleShifts[c];
     }
 }
 
@@ -222,6 +222,23 @@ RegistrationParameterScalesFromShiftBase< TMetric >
 }
 
 /** Print the information about this class */
+template< typename TMetric >
+typename LightObject::Pointer
+RegistrationParameterScalesFromShiftBase< TMetric >
+::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast< Self * >( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->SetSmallParameterVariation( this->m_SmallParameterVariation );
+
+  return loPtr;
+}
+
 template< typename TMetric >
 void
 RegistrationParameterScalesFromShiftBase< TMetric >
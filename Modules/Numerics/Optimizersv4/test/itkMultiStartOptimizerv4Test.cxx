@@ -117,6 +117,11 @@ public:
     return false;
     }
 
+  bool SupportsCloning() const override
+    {
+    return true;
+    }
+
   unsigned int GetNumberOfLocalParameters() const override
   {
     return SpaceDimension;
@@ -134,6 +139,15 @@ public:
     return m_Parameters;
   }
 
+protected:
+
+  typename itk::LightObject::Pointer InternalClone() const override
+  {
+    typename itk::LightObject::Pointer loPtr = Superclass::InternalClone();
+    dynamic_cast< Self * >( loPtr.GetPointer() )->m_Parameters = m_Parameters;
+    return loPtr;
+  }
+
 private:
 
   ParametersType m_Parameters;
@@ -285,6 +299,53 @@ int itkMultiStartOptimizerv4Test(int, char* [] )
     return EXIT_FAILURE;
     }
   std::cout << "Test 3 passed." << std::endl;
+
+  /*
+   * Test 4
+   */
+  std::cout << "Test optimization 4: concurrent start points" << std::endl;
+  parametersList.clear();
+  for (  int i = -99; i < 103; i+=50 )
+    {
+    for (  int j = -103; j < 99; j+=50 )
+      {
+      ParametersType  testPosition( spaceDimension );
+      testPosition[0]=(double)i;
+      testPosition[1]=(double)j;
+      parametersList.push_back( testPosition );
+      }
+    }
+  const OptimizerType::ParametersListType startPoints = parametersList;
+  itkOptimizer->SetNumberOfWorkUnits( 1 );
+  itkOptimizer->SetParametersList( parametersList );
+  if( MultiStartOptimizerv4RunTest( itkOptimizer ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  const OptimizerType::MetricValuesListType serialMetricValues = itkOptimizer->GetMetricValuesList();
+  const OptimizerType::ParameterListSizeType serialBestIndex = itkOptimizer->GetBestParametersIndex();
+
+  parametersList = startPoints;
+  if( itkOptimizer->GetOptimizeStartPointsConcurrently() )
+    {
+    std::cerr << "The start points are optimized concurrently by default." << std::endl;
+    return EXIT_FAILURE;
+    }
+  itkOptimizer->SetNumberOfWorkUnits( 3 );
+  itkOptimizer->OptimizeStartPointsConcurrentlyOn();
+  itkOptimizer->SetParametersList( parametersList );
+  if( MultiStartOptimizerv4RunTest( itkOptimizer ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  if( itkOptimizer->GetMetricValuesList() != serialMetricValues
+    || itkOptimizer->GetBestParametersIndex() != serialBestIndex )
+    {
+    std::cerr << "The concurrent start points do not give the serial results." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test 4 passed." << std::endl;
+
   return EXIT_SUCCESS;
 
 }
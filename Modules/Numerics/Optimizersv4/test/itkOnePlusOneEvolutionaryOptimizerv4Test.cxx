@@ -130,6 +130,21 @@ public:
   {
   }
 
+  bool SupportsCloning() const override
+  {
+    return true;
+  }
+
+protected:
+  itk::LightObject::Pointer InternalClone() const override
+  {
+    itk::LightObject::Pointer loPtr = Superclass::InternalClone();
+    auto * clone = dynamic_cast< Self * >( loPtr.GetPointer() );
+    clone->m_Parameters = m_Parameters;
+    clone->m_HasLocalSupport = m_HasLocalSupport;
+    return loPtr;
+  }
+
 private:
   ParametersType  m_Parameters;
   bool            m_HasLocalSupport;
@@ -263,6 +278,50 @@ int itkOnePlusOneEvolutionaryOptimizerv4Test(int, char* [] )
     return EXIT_FAILURE;
     }
 
+  // Run a (1+lambda) strategy serially and with concurrently evaluated
+  // offspring. Both runs draw the same offspring and must agree.
+  itkOptimizer->RemoveAllObservers();
+  itkOptimizer->SetNumberOfOffspring( 4 );
+  if( itkOptimizer->GetNumberOfOffspring() != 4 )
+    {
+    std::cout << "SetNumberOfOffspring failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  ParametersType lambdaPositions[2];
+  const itk::ThreadIdType numberOfWorkUnits[2] = { 1, 3 };
+  for( unsigned int run = 0; run < 2; ++run )
+    {
+    std::cout << "(1+4) strategy with " << numberOfWorkUnits[run] << " work units." << std::endl;
+    itkOptimizer->SetNumberOfWorkUnits( numberOfWorkUnits[run] );
+    itkOptimizer->Initialize( 10 );
+    generator->Initialize( 12345 );
+    metric->SetParameters( initialPosition );
+    try
+      {
+      itkOptimizer->StartOptimization();
+      }
+    catch( itk::ExceptionObject & e )
+      {
+      std::cout << "Exception thrown ! " << e << std::endl;
+      return EXIT_FAILURE;
+      }
+    lambdaPositions[run] = itkOptimizer->GetCurrentPosition();
+    std::cout << "Solution        = " << lambdaPositions[run] << std::endl;
+    for( unsigned int j = 0; j < 2; j++ )
+      {
+      if( itk::Math::abs( lambdaPositions[run][j] - trueParameters[j] ) > 0.01 )
+        {
+        std::cout << "Test failed: the (1+4) strategy did not converge." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  if( lambdaPositions[0] != lambdaPositions[1] )
+    {
+    std::cout << "Test failed: concurrent offspring evaluation changed the result." << std::endl;
+    return EXIT_FAILURE;
+    }
+
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
 
@@ -19,6 +19,7 @@
 #include "itkImageToImageMetricv4.h"
 
 #include "itkAffineTransform.h"
+#include "itkCenteredAffineTransform.h"
 #include "itkDisplacementFieldTransform.h"
 #include "itkMath.h"
 
@@ -248,6 +249,70 @@ int itkRegistrationParameterScalesFromJacobianTest(int , char* [])
     std::cout << "Passed: the step scale for the affine transform is correct." << std::endl;
     }
 
+  // The Jacobians at the samples are cached between calls. Check that the
+  // cached estimates match those of a new estimator after the parameters,
+  // then the fixed parameters, of the transform have changed.
+  RegistrationParameterScalesFromJacobianType::Pointer freshScaleEstimator
+    = RegistrationParameterScalesFromJacobianType::New();
+  freshScaleEstimator->SetMetric(metric);
+
+  MovingTransformType::ParametersType changedParameters = movingTransform->GetParameters();
+  changedParameters[0] += 0.25;
+  changedParameters[ImageDimension * ImageDimension] += 2.0;
+  movingTransform->SetParameters(changedParameters);
+  bool cachePass = itk::Math::FloatAlmostEqual( jacobianScaleEstimator->EstimateStepScale(movingStep),
+                                                freshScaleEstimator->EstimateStepScale(movingStep) );
+
+  MovingTransformType::InputPointType center;
+  center.Fill(3.0);
+  movingTransform->SetCenter(center);
+  freshScaleEstimator = RegistrationParameterScalesFromJacobianType::New();
+  freshScaleEstimator->SetMetric(metric);
+  cachePass = cachePass && itk::Math::FloatAlmostEqual( jacobianScaleEstimator->EstimateStepScale(movingStep),
+                                                        freshScaleEstimator->EstimateStepScale(movingStep) );
+  center.Fill(0.0);
+  movingTransform->SetCenter(center);
+  movingTransform->SetIdentity();
+
+  if (!cachePass)
+    {
+    std::cout << "Failed: the cached step scale for the affine transform is not correct." << std::endl;
+    }
+  else
+    {
+    std::cout << "Passed: the cached step scale for the affine transform is correct." << std::endl;
+    }
+
+  // The Jacobian of a subclass of AffineTransform may depend on its
+  // parameters, e.g. the Jacobian with respect to the center of a
+  // CenteredAffineTransform depends on the matrix.
+  using CenteredAffineTransformType = itk::CenteredAffineTransform<double, ImageDimension>;
+  CenteredAffineTransformType::Pointer centeredAffineTransform = CenteredAffineTransformType::New();
+  centeredAffineTransform->SetIdentity();
+  metric->SetMovingTransform( centeredAffineTransform );
+
+  CenteredAffineTransformType::ParametersType centeredStep( centeredAffineTransform->GetNumberOfParameters() );
+  centeredStep.Fill(1.0);
+  jacobianScaleEstimator->EstimateStepScale(centeredStep);
+
+  CenteredAffineTransformType::ParametersType centeredParameters = centeredAffineTransform->GetParameters();
+  centeredParameters[0] += 0.5;
+  centeredAffineTransform->SetParameters(centeredParameters);
+  freshScaleEstimator = RegistrationParameterScalesFromJacobianType::New();
+  freshScaleEstimator->SetMetric(metric);
+  bool centeredCachePass = itk::Math::FloatAlmostEqual( jacobianScaleEstimator->EstimateStepScale(centeredStep),
+                                                        freshScaleEstimator->EstimateStepScale(centeredStep) );
+  metric->SetMovingTransform( movingTransform );
+
+  if (!centeredCachePass)
+    {
+    std::cout << "Failed: the cached step scale for the centered affine transform is not correct." << std::endl;
+    }
+  else
+    {
+    std::cout << "Passed: the cached step scale for the centered affine transform is correct." << std::endl;
+    }
+
   // Testing local scales for a transform with local support, ex. DisplacementFieldTransform
   using DisplacementTransformType =
       itk::DisplacementFieldTransform<double, ImageDimension>;
@@ -325,10 +390,40 @@ int itkRegistrationParameterScalesFromJacobianTest(int , char* [])
     }
   // Testing the step scale with local support done
 
+  // The local step scales do not depend on the number of work units.
+  for (itk::SizeValueType p = 0; p < displacementStep.GetSize(); p++)
+    {
+    displacementStep[p] = static_cast<double>( p % 7 );
+    }
+  RegistrationParameterScalesFromJacobianType::ScalesType localStepScales;
+  RegistrationParameterScalesFromJacobianType::ScalesType serialLocalStepScales;
+  jacobianScaleEstimator->SetNumberOfWorkUnits(3);
+  jacobianScaleEstimator->EstimateLocalStepScales(displacementStep, localStepScales);
+  jacobianScaleEstimator->SetNumberOfWorkUnits(1);
+  jacobianScaleEstimator->EstimateLocalStepScales(displacementStep, serialLocalStepScales);
+
+  bool workUnitsPass = localStepScales.GetSize() == field->GetLargestPossibleRegion().GetNumberOfPixels();
+  for (itk::SizeValueType p = 0; workUnitsPass && p < localStepScales.GetSize(); p++)
+    {
+    const itk::SizeValueType offset = p * ImageDimension;
+    const FloatType expected = std::sqrt( itk::Math::sqr( displacementStep[offset] )
+                                          + itk::Math::sqr( displacementStep[offset + 1] ) );
+    workUnitsPass = itk::Math::ExactlyEquals( localStepScales[p], serialLocalStepScales[p] )
+      && std::abs( localStepScales[p] - expected ) < 1e-10;
+    }
+  if (!workUnitsPass)
+    {
+    std::cout << "Failed: the local step scales depend on the number of work units." << std::endl;
+    }
+  else
+    {
+    std::cout << "Passed: the local step scales do not depend on the number of work units." << std::endl;
+    }
+
   // Check the correctness of all cases above
   std::cout << std::endl;
   if (jacobianPass && nonUniformForJacobian
-    && stepScalePass && displacementPass && localStepScalePass)
+    && stepScalePass && cachePass && centeredCachePass && displacementPass && localStepScalePass && workUnitsPass)
     {
     std::cout << "Test passed" << std::endl;
     return EXIT_SUCCESS;
@@ -19,7 +19,6 @@
 #define itkMultiResolutionPyramidImageFilter_hxx
 
 #include "itkMultiResolutionPyramidImageFilter.h"
-#include "itkGaussianOperator.h"
 #include "itkCastImageFilter.h"
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkMacro.h"
@@ -557,27 +556,24 @@ MultiResolutionPyramidImageFilter< TInputImage, TOutputImage >
   baseRegion.SetIndex(baseIndex);
   baseRegion.SetSize(baseSize);
 
-  // compute requirements for the smoothing part
-  using OutputPixelType = typename TOutputImage::PixelType;
-  using OperatorType = GaussianOperator< OutputPixelType, ImageDimension >;
-
-  auto * oper = new OperatorType;
-
-  typename TInputImage::SizeType radius;
+  // compute requirements for the smoothing part, with the kernels of the
+  // smoother of GenerateData()
+  using SmootherType = DiscreteGaussianImageFilter< TOutputImage, TOutputImage >;
+  typename SmootherType::Pointer smoother = SmootherType::New();
+  smoother->SetUseImageSpacing(false);
+  smoother->SetMaximumError(m_MaximumError);
 
   RegionType inputRequestedRegion = baseRegion;
   refLevel = 0;
 
+  typename SmootherType::ArrayType variance;
   for ( idim = 0; idim < TInputImage::ImageDimension; idim++ )
     {
-    oper->SetDirection(idim);
-    oper->SetVariance( itk::Math::sqr( 0.5 * static_cast< float >(
-                                       m_Schedule[refLevel][idim] ) ) );
-    oper->SetMaximumError(m_MaximumError);
-    oper->CreateDirectional();
-    radius[idim] = oper->GetRadius()[idim];
+    variance[idim] = itk::Math::sqr( 0.5 * static_cast< float >(
+                                       m_Schedule[refLevel][idim] ) );
     }
-  delete oper;
+  smoother->SetVariance(variance);
+  const typename SmootherType::InputSizeType radius = smoother->GetKernelRadius( inputPtr->GetSpacing() );
 
   inputRequestedRegion.PadByRadius(radius);
 
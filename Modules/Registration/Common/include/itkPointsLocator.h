@@ -27,6 +27,9 @@
 #include "itkVectorContainer.h"
 #include "itkVectorContainerToListSampleAdaptor.h"
 
+#include <utility>
+#include <vector>
+
 namespace itk
 {
 
@@ -36,6 +39,18 @@ namespace itk
  * This class accelerates the search for the closest point to a user-provided
  * point, by using constructing a Kd-Tree structure for the PointSetContainer.
  *
+ * The kd-tree is stored flat: the points are copied into one contiguous
+ * array, ordered so that every node covers a consecutive range of it, and
+ * each node keeps the bounding box of its points.  Since the searches prune
+ * with these bounding boxes rather than with the splitting planes, the tree
+ * stays exact when the points move: UpdatePointLocations() refreshes the
+ * copied points and the bounding boxes in linear time, keeping the topology,
+ * which suits points that move a little between two searches (e.g. under the
+ * transform being optimized in a registration).
+ *
+ * The searches are const and can be called concurrently.  The batched
+ * versions search for several query points in parallel.
+ *
  * \ingroup ITKRegistrationCommon
  */
 template<
@@ -72,7 +87,8 @@ public:
   using PointsContainerConstIterator = typename PointsContainer::ConstIterator;
   using PointsContainerIterator = typename PointsContainer::Iterator;
 
-  /** Type of the PointsContainer to List Adaptor. */
+  /** Types of the former Statistics::KdTree based implementation, kept for
+   * backward compatibility. */
   using SampleAdaptorType = Statistics::VectorContainerToListSampleAdaptor<PointsContainer>;
   using SampleAdaptorPointer = typename SampleAdaptorType::Pointer;
 
@@ -92,6 +108,23 @@ public:
   /** Compute the kd-tree that will facilitate the querying the points. */
   void Initialize();
 
+  /** Update the kd-tree after the points, same in number, moved.  The tree
+   * topology is kept unless the leaves have grown by more than
+   * MaximumRefitGrowth since the last Initialize(), in which case the tree
+   * is rebuilt.  Calls Initialize() if the tree was never built or the
+   * number of points changed. */
+  void UpdatePointLocations();
+
+  /** Set/Get the growth of the summed extents of the leaves, relative to
+   * the last Initialize(), above which UpdatePointLocations() rebuilds the
+   * tree.  Defaults to 2. */
+  itkSetMacro( MaximumRefitGrowth, double );
+  itkGetConstMacro( MaximumRefitGrowth, double );
+
+  /** Set/Get the maximum number of points in a leaf.  Defaults to 16. */
+  itkSetClampMacro( BucketSize, unsigned int, 1, NumericTraits<unsigned int>::max() );
+  itkGetConstMacro( BucketSize, unsigned int );
+
   /** Find the closest point */
   PointIdentifier FindClosestPoint( const PointType &query ) const;
 
@@ -110,16 +143,65 @@ public:
   void FindPointsWithinRadius( const PointType &, double,
     NeighborsIdentifierType & ) const;
 
+  /** Find the closest point of each point of a container, in parallel.
+   * The ids are returned in the order of the container. */
+  void FindClosestPoints( const PointsContainer *,
+    std::vector<PointIdentifier> & ) const;
+
+  /** Find the closest N points of each point of a container, in parallel.
+   * The ids are returned in the order of the container. */
+  void FindClosestNPoints( const PointsContainer *, unsigned int,
+    std::vector<NeighborsIdentifierType> & ) const;
+
 protected:
   PointsLocator();
   ~PointsLocator() override;
   void PrintSelf(std::ostream& os, Indent indent) const override;
 
 private:
-  PointsContainerPointer   m_Points;
-  SampleAdaptorPointer     m_SampleAdaptor;
-  TreeGeneratorPointer     m_KdTreeGenerator;
-  TreeConstPointer         m_Tree;
+  using BoundType = FixedArray<double, PointDimension>;
+
+  /** A node covers the points [Begin, End) of m_NodePoints.  Internal nodes
+   * have two children, leaves none (child index 0, the root). */
+  struct NodeType
+    {
+    SizeValueType Begin;
+    SizeValueType End;
+    SizeValueType Left;
+    SizeValueType Right;
+    BoundType     LowerBound;
+    BoundType     UpperBound;
+    };
+  using NodeContainerType = std::vector<NodeType>;
+
+  /** Neighbor candidates: squared distance and position in m_NodePoints. */
+  using CandidateType = std::pair<double, SizeValueType>;
+  using CandidateContainerType = std::vector<CandidateType>;
+
+  SizeValueType BuildNode( SizeValueType begin, SizeValueType end,
+    std::vector<SizeValueType> & order );
+  void ComputeNodeBounds( NodeType & node ) const;
+  double ComputeLeafExtents() const;
+  static double SquaredDistanceToNode( const NodeType &, const PointType & );
+  static double SquaredDistance( const PointType &, const PointType & );
+
+  void SearchNearest( const PointType &, unsigned int,
+    CandidateContainerType & ) const;
+  void SearchNearest( SizeValueType nodeId, const PointType &, unsigned int,
+    CandidateContainerType & ) const;
+  void SearchRadius( SizeValueType nodeId, const PointType &, double,
+    NeighborsIdentifierType & ) const;
+
+  unsigned int NumberOfSearchedNeighbors( unsigned int ) const;
+  void VerifyInitialized() const;
+
+  PointsContainerPointer           m_Points;
+  NodeContainerType                m_Nodes;
+  std::vector<PointType>           m_NodePoints;
+  std::vector<PointIdentifier>     m_NodePointIdentifiers;
+  unsigned int                     m_BucketSize;
+  double                           m_MaximumRefitGrowth;
+  double                           m_InitialLeafExtents;
 };
 
 } // end namespace itk
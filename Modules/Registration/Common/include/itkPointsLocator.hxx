@@ -19,15 +19,20 @@
 #define itkPointsLocator_hxx
 #include "itkPointsLocator.h"
 
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+
 namespace itk
 {
 
 template<typename TPointsContainer>
 PointsLocator<TPointsContainer>
-::PointsLocator()
+::PointsLocator() :
+  m_BucketSize( 16 ),
+  m_MaximumRefitGrowth( 2.0 ),
+  m_InitialLeafExtents( 0.0 )
 {
-  this->m_SampleAdaptor = SampleAdaptorType::New();
-  this->m_KdTreeGenerator = TreeGeneratorType::New();
 }
 
 template<typename TPointsContainer>
@@ -48,21 +53,327 @@ PointsLocator<TPointsContainer>
     itkExceptionMacro( "The number of points is 0." );
     }
 
-  this->m_SampleAdaptor = SampleAdaptorType::New();
-  this->m_KdTreeGenerator = TreeGeneratorType::New();
+  std::vector<PointType> points;
+  std::vector<PointIdentifier> identifiers;
+  points.reserve( this->m_Points->Size() );
+  identifiers.reserve( this->m_Points->Size() );
+  for( PointsContainerConstIterator it = this->m_Points->Begin(); it != this->m_Points->End(); ++it )
+    {
+    points.push_back( it.Value() );
+    identifiers.push_back( it.Index() );
+    }
+
+  // Build the tree over a permutation of the points, then store the points
+  // in the order of the tree so that every node covers a consecutive range.
+  std::vector<SizeValueType> order( points.size() );
+  for( SizeValueType i = 0; i < order.size(); i++ )
+    {
+    order[i] = i;
+    }
+  this->m_NodePoints.swap( points );
+  this->m_Nodes.clear();
+  this->m_Nodes.reserve( 2 * ( order.size() / this->m_BucketSize ) + 1 );
+  this->BuildNode( 0, order.size(), order );
+
+  points.resize( order.size() );
+  this->m_NodePointIdentifiers.resize( order.size() );
+  for( SizeValueType i = 0; i < order.size(); i++ )
+    {
+    points[i] = this->m_NodePoints[order[i]];
+    this->m_NodePointIdentifiers[i] = identifiers[order[i]];
+    }
+  this->m_NodePoints.swap( points );
+
+  this->m_InitialLeafExtents = this->ComputeLeafExtents();
+}
+
+template<typename TPointsContainer>
+SizeValueType
+PointsLocator<TPointsContainer>
+::BuildNode( SizeValueType begin, SizeValueType end, std::vector<SizeValueType> & order )
+{
+  // m_NodePoints is still in the input order here, addressed through order.
+  const SizeValueType nodeId = this->m_Nodes.size();
+  this->m_Nodes.push_back( NodeType() );
+
+  NodeType node;
+  node.Begin = begin;
+  node.End = end;
+  node.Left = 0;
+  node.Right = 0;
+  node.LowerBound.Fill( NumericTraits<double>::max() );
+  node.UpperBound.Fill( NumericTraits<double>::NonpositiveMin() );
+  for( SizeValueType i = begin; i < end; i++ )
+    {
+    const PointType & point = this->m_NodePoints[order[i]];
+    for( unsigned int d = 0; d < PointDimension; d++ )
+      {
+      node.LowerBound[d] = std::min( node.LowerBound[d], static_cast<double>( point[d] ) );
+      node.UpperBound[d] = std::max( node.UpperBound[d], static_cast<double>( point[d] ) );
+      }
+    }
+
+  if( end - begin > this->m_BucketSize )
+    {
+    // Split at the median of the widest dimension.
+    unsigned int splitDimension = 0;
+    for( unsigned int d = 1; d < PointDimension; d++ )
+      {
+      if( node.UpperBound[d] - node.LowerBound[d] > node.UpperBound[splitDimension] - node.LowerBound[splitDimension] )
+        {
+        splitDimension = d;
+        }
+      }
+    const SizeValueType middle = begin + ( end - begin ) / 2;
+    const std::vector<PointType> & points = this->m_NodePoints;
+    std::nth_element( order.begin() + begin, order.begin() + middle, order.begin() + end,
+      [&points, splitDimension]( SizeValueType a, SizeValueType b )
+        {
+        return points[a][splitDimension] < points[b][splitDimension];
+        } );
 
-  // Lack of const-correctness in the PointSetAdaptor should be fixed.
-  this->m_SampleAdaptor->SetVectorContainer(
-    const_cast<PointsContainer *>( this->m_Points.GetPointer() ) );
+    node.Left = this->BuildNode( begin, middle, order );
+    node.Right = this->BuildNode( middle, end, order );
+    }
 
-  this->m_SampleAdaptor->SetMeasurementVectorSize( PointDimension );
+  this->m_Nodes[nodeId] = node;
+  return nodeId;
+}
 
-  this->m_KdTreeGenerator->SetSample( this->m_SampleAdaptor );
-  this->m_KdTreeGenerator->SetBucketSize( 16 );
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::ComputeNodeBounds( NodeType & node ) const
+{
+  if( node.Left != 0 )
+    {
+    const NodeType & left = this->m_Nodes[node.Left];
+    const NodeType & right = this->m_Nodes[node.Right];
+    for( unsigned int d = 0; d < PointDimension; d++ )
+      {
+      node.LowerBound[d] = std::min( left.LowerBound[d], right.LowerBound[d] );
+      node.UpperBound[d] = std::max( left.UpperBound[d], right.UpperBound[d] );
+      }
+    return;
+    }
 
-  this->m_KdTreeGenerator->Update();
+  node.LowerBound.Fill( NumericTraits<double>::max() );
+  node.UpperBound.Fill( NumericTraits<double>::NonpositiveMin() );
+  for( SizeValueType i = node.Begin; i < node.End; i++ )
+    {
+    const PointType & point = this->m_NodePoints[i];
+    for( unsigned int d = 0; d < PointDimension; d++ )
+      {
+      node.LowerBound[d] = std::min( node.LowerBound[d], static_cast<double>( point[d] ) );
+      node.UpperBound[d] = std::max( node.UpperBound[d], static_cast<double>( point[d] ) );
+      }
+    }
+}
 
-  this->m_Tree = this->m_KdTreeGenerator->GetOutput();
+template<typename TPointsContainer>
+double
+PointsLocator<TPointsContainer>
+::ComputeLeafExtents() const
+{
+  double extents = 0.0;
+  for( const NodeType & node : this->m_Nodes )
+    {
+    if( node.Left == 0 )
+      {
+      for( unsigned int d = 0; d < PointDimension; d++ )
+        {
+        extents += node.UpperBound[d] - node.LowerBound[d];
+        }
+      }
+    }
+  return extents;
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::UpdatePointLocations()
+{
+  if( !this->m_Points )
+    {
+    itkExceptionMacro( "The points have not been set (m_Points == nullptr)" );
+    }
+  if( this->m_Nodes.empty() || this->m_Points->Size() != this->m_NodePoints.size() )
+    {
+    this->Initialize();
+    return;
+    }
+
+  for( SizeValueType i = 0; i < this->m_NodePoints.size(); i++ )
+    {
+    this->m_NodePoints[i] = this->m_Points->ElementAt( this->m_NodePointIdentifiers[i] );
+    }
+
+  // The children follow their parent in m_Nodes, so a reverse sweep updates
+  // the children before their parent.
+  for( auto it = this->m_Nodes.rbegin(); it != this->m_Nodes.rend(); ++it )
+    {
+    this->ComputeNodeBounds( *it );
+    }
+
+  if( this->ComputeLeafExtents() > this->m_MaximumRefitGrowth * this->m_InitialLeafExtents )
+    {
+    this->Initialize();
+    }
+}
+
+template<typename TPointsContainer>
+double
+PointsLocator<TPointsContainer>
+::SquaredDistance( const PointType & point1, const PointType & point2 )
+{
+  double distance = 0.0;
+  for( unsigned int d = 0; d < PointDimension; d++ )
+    {
+    const double difference = static_cast<double>( point1[d] ) - static_cast<double>( point2[d] );
+    distance += difference * difference;
+    }
+  return distance;
+}
+
+template<typename TPointsContainer>
+double
+PointsLocator<TPointsContainer>
+::SquaredDistanceToNode( const NodeType & node, const PointType & point )
+{
+  double distance = 0.0;
+  for( unsigned int d = 0; d < PointDimension; d++ )
+    {
+    const double coordinate = static_cast<double>( point[d] );
+    double difference = 0.0;
+    if( coordinate < node.LowerBound[d] )
+      {
+      difference = node.LowerBound[d] - coordinate;
+      }
+    else if( coordinate > node.UpperBound[d] )
+      {
+      difference = coordinate - node.UpperBound[d];
+      }
+    distance += difference * difference;
+    }
+  return distance;
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SearchNearest( const PointType & query, unsigned int numberOfNeighbors,
+  CandidateContainerType & candidates ) const
+{
+  candidates.clear();
+  if( numberOfNeighbors == 0 || this->m_Nodes.empty() )
+    {
+    return;
+    }
+  candidates.reserve( numberOfNeighbors + 1 );
+  this->SearchNearest( 0, query, numberOfNeighbors, candidates );
+  std::sort_heap( candidates.begin(), candidates.end() );
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SearchNearest( SizeValueType nodeId, const PointType & query, unsigned int numberOfNeighbors,
+  CandidateContainerType & candidates ) const
+{
+  // candidates is a max-heap of the closest points found so far.
+  const NodeType & node = this->m_Nodes[nodeId];
+  if( node.Left == 0 )
+    {
+    for( SizeValueType i = node.Begin; i < node.End; i++ )
+      {
+      const CandidateType candidate( Self::SquaredDistance( this->m_NodePoints[i], query ), i );
+      if( candidates.size() < numberOfNeighbors )
+        {
+        candidates.push_back( candidate );
+        std::push_heap( candidates.begin(), candidates.end() );
+        }
+      else if( candidate < candidates.front() )
+        {
+        std::pop_heap( candidates.begin(), candidates.end() );
+        candidates.back() = candidate;
+        std::push_heap( candidates.begin(), candidates.end() );
+        }
+      }
+    return;
+    }
+
+  double nearDistance = Self::SquaredDistanceToNode( this->m_Nodes[node.Left], query );
+  double farDistance = Self::SquaredDistanceToNode( this->m_Nodes[node.Right], query );
+  SizeValueType nearNode = node.Left;
+  SizeValueType farNode = node.Right;
+  if( farDistance < nearDistance )
+    {
+    std::swap( nearDistance, farDistance );
+    std::swap( nearNode, farNode );
+    }
+
+  if( candidates.size() < numberOfNeighbors || nearDistance <= candidates.front().first )
+    {
+    this->SearchNearest( nearNode, query, numberOfNeighbors, candidates );
+    }
+  if( candidates.size() < numberOfNeighbors || farDistance <= candidates.front().first )
+    {
+    this->SearchNearest( farNode, query, numberOfNeighbors, candidates );
+    }
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SearchRadius( SizeValueType nodeId, const PointType & query, double squaredRadius,
+  NeighborsIdentifierType & identifiers ) const
+{
+  const NodeType & node = this->m_Nodes[nodeId];
+  if( Self::SquaredDistanceToNode( node, query ) > squaredRadius )
+    {
+    return;
+    }
+  if( node.Left == 0 )
+    {
+    for( SizeValueType i = node.Begin; i < node.End; i++ )
+      {
+      if( Self::SquaredDistance( this->m_NodePoints[i], query ) <= squaredRadius )
+        {
+        identifiers.push_back( this->m_NodePointIdentifiers[i] );
+        }
+      }
+    return;
+    }
+  this->SearchRadius( node.Left, query, squaredRadius, identifiers );
+  this->SearchRadius( node.Right, query, squaredRadius, identifiers );
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::VerifyInitialized() const
+{
+  if( this->m_Nodes.empty() )
+    {
+    itkExceptionMacro( "The points locator has not been initialized." );
+    }
+}
+
+template<typename TPointsContainer>
+unsigned int
+PointsLocator<TPointsContainer>
+::NumberOfSearchedNeighbors( unsigned int numberOfNeighborsRequested ) const
+{
+  unsigned int N = numberOfNeighborsRequested;
+  if( N > this->m_NodePoints.size() )
+    {
+    N = this->m_NodePoints.size();
+
+    itkWarningMacro( "The number of requested neighbors is greater than the "
+     << "total number of points.  Only returning " << N << " points." );
+    }
+  return N;
 }
 
 template<typename TPointsContainer>
@@ -71,10 +382,12 @@ typename PointsLocator<TPointsContainer>
 PointsLocator<TPointsContainer>
 ::FindClosestPoint( const PointType &query ) const
 {
-  NeighborsIdentifierType identifiers;
-  this->m_Tree->Search( query, 1u, identifiers );
+  this->VerifyInitialized();
+
+  CandidateContainerType candidates;
+  this->SearchNearest( query, 1u, candidates );
 
-  return identifiers[0];
+  return this->m_NodePointIdentifiers[candidates[0].second];
 }
 
 template<
@@ -84,15 +397,7 @@ PointsLocator<TPointsContainer>
 ::Search( const PointType &query, unsigned int numberOfNeighborsRequested,
   NeighborsIdentifierType &identifiers ) const
 {
-  unsigned int N = numberOfNeighborsRequested;
-  if( N > this->m_Points->Size() )
-    {
-    N = this->m_Points->Size();
-
-    itkWarningMacro( "The number of requested neighbors is greater than the "
-     << "total number of points.  Only returning " << N << " points." );
-    }
-  this->m_Tree->Search( query, N, identifiers );
+  this->FindClosestNPoints( query, numberOfNeighborsRequested, identifiers );
 }
 
 template<
@@ -102,15 +407,16 @@ PointsLocator<TPointsContainer>
 ::FindClosestNPoints( const PointType &query, unsigned int
   numberOfNeighborsRequested, NeighborsIdentifierType &identifiers ) const
 {
-  unsigned int N = numberOfNeighborsRequested;
-  if( N > this->m_Points->Size() )
-    {
-    N = this->m_Points->Size();
+  this->VerifyInitialized();
 
-    itkWarningMacro( "The number of requested neighbors is greater than the "
-     << "total number of points.  Only returning " << N << " points." );
+  CandidateContainerType candidates;
+  this->SearchNearest( query, this->NumberOfSearchedNeighbors( numberOfNeighborsRequested ), candidates );
+
+  identifiers.resize( candidates.size() );
+  for( SizeValueType i = 0; i < candidates.size(); i++ )
+    {
+    identifiers[i] = this->m_NodePointIdentifiers[candidates[i].second];
     }
-  this->m_Tree->Search( query, N, identifiers );
 }
 
 template<
@@ -120,7 +426,7 @@ PointsLocator<TPointsContainer>
 ::Search( const PointType &query, double radius,
   NeighborsIdentifierType &identifiers ) const
 {
-  this->m_Tree->Search( query, radius, identifiers );
+  this->FindPointsWithinRadius( query, radius, identifiers );
 }
 
 template<
@@ -130,7 +436,80 @@ PointsLocator<TPointsContainer>
 ::FindPointsWithinRadius( const PointType &query, double radius,
   NeighborsIdentifierType &identifiers ) const
 {
-  this->m_Tree->Search( query, radius, identifiers );
+  this->VerifyInitialized();
+
+  identifiers.clear();
+  this->SearchRadius( 0, query, radius * radius, identifiers );
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::FindClosestPoints( const PointsContainer *queries,
+  std::vector<PointIdentifier> &identifiers ) const
+{
+  this->VerifyInitialized();
+
+  std::vector<PointType> queryPoints;
+  queryPoints.reserve( queries->Size() );
+  for( PointsContainerConstIterator it = queries->Begin(); it != queries->End(); ++it )
+    {
+    queryPoints.push_back( it.Value() );
+    }
+  identifiers.resize( queryPoints.size() );
+
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  multiThreader->ParallelizeArray( 0, queryPoints.size(),
+    [&]( SizeValueType i )
+      {
+      CandidateContainerType candidates;
+      this->SearchNearest( queryPoints[i], 1u, candidates );
+      identifiers[i] = this->m_NodePointIdentifiers[candidates[0].second];
+      },
+    nullptr );
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::FindClosestNPoints( const PointsContainer *queries, unsigned int
+  numberOfNeighborsRequested, std::vector<NeighborsIdentifierType> &identifiers ) const
+{
+  this->VerifyInitialized();
+
+  const unsigned int numberOfNeighbors = this->NumberOfSearchedNeighbors( numberOfNeighborsRequested );
+
+  std::vector<PointType> queryPoints;
+  queryPoints.reserve( queries->Size() );
+  for( PointsContainerConstIterator it = queries->Begin(); it != queries->End(); ++it )
+    {
+    queryPoints.push_back( it.Value() );
+    }
+  identifiers.resize( queryPoints.size() );
+  if( numberOfNeighbors == 0 )
+    {
+    for( NeighborsIdentifierType & neighbors : identifiers )
+      {
+      neighbors.clear();
+      }
+    return;
+    }
+
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  multiThreader->ParallelizeArray( 0, queryPoints.size(),
+    [&]( SizeValueType i )
+      {
+      CandidateContainerType candidates;
+      this->SearchNearest( queryPoints[i], numberOfNeighbors, candidates );
+      identifiers[i].resize( candidates.size() );
+      for( SizeValueType j = 0; j < candidates.size(); j++ )
+        {
+        identifiers[i][j] = this->m_NodePointIdentifiers[candidates[j].second];
+        }
+      },
+    nullptr );
 }
 
 /**
@@ -143,6 +522,11 @@ PointsLocator<TPointsContainer>
 ::PrintSelf( std::ostream& os, Indent indent ) const
 {
   Superclass::PrintSelf( os, indent );
+
+  os << indent << "NumberOfPoints: " << this->m_NodePoints.size() << std::endl;
+  os << indent << "NumberOfNodes: " << this->m_Nodes.size() << std::endl;
+  os << indent << "BucketSize: " << this->m_BucketSize << std::endl;
+  os << indent << "MaximumRefitGrowth: " << this->m_MaximumRefitGrowth << std::endl;
 }
 
 } // end namespace itk
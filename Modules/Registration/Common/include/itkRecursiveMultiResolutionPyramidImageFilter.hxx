@@ -19,7 +19,6 @@
 #define itkRecursiveMultiResolutionPyramidImageFilter_hxx
 
 #include "itkRecursiveMultiResolutionPyramidImageFilter.h"
-#include "itkGaussianOperator.h"
 #include "itkCastImageFilter.h"
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkMacro.h"
@@ -258,11 +257,13 @@ RecursiveMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >
   unsigned int refLevel;
   refLevel = static_cast<unsigned int>( refOutputPtr->GetSourceOutputIndex() );
 
-  using OutputPixelType = typename TOutputImage::PixelType;
-  using OperatorType = GaussianOperator< OutputPixelType, ImageDimension >;
-
-  auto * oper = new OperatorType;
-  oper->SetMaximumError( this->GetMaximumError() );
+  // The padding for the smoothing component is the kernel radius of the
+  // smoother of GenerateData()
+  using SmootherType = DiscreteGaussianImageFilter< TOutputImage, TOutputImage >;
+  typename SmootherType::Pointer smoother = SmootherType::New();
+  smoother->SetUseImageSpacing(false);
+  smoother->SetMaximumError( this->GetMaximumError() );
+  typename SmootherType::ArrayType variance;
 
   using SizeType = typename OutputImageType::SizeType;
   using IndexType = typename OutputImageType::IndexType;
@@ -296,11 +297,10 @@ RecursiveMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >
       // take into account smoothing component
       if ( factors[idim] > 1 )
         {
-        oper->SetDirection(idim);
-        oper->SetVariance( itk::Math::sqr( 0.5
-                                         * static_cast< float >( factors[idim] ) ) );
-        oper->CreateDirectional();
-        radius[idim] = oper->GetRadius()[idim];
+        variance.Fill( 0.0 );
+        variance[idim] = itk::Math::sqr( 0.5 * static_cast< float >( factors[idim] ) );
+        smoother->SetVariance(variance);
+        radius[idim] = smoother->GetKernelRadius( this->GetOutput(ilevel)->GetSpacing() )[idim];
         }
       else
         {
@@ -331,11 +331,10 @@ RecursiveMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >
       // take into account smoothing component
       if ( factors[idim] > 1 )
         {
-        oper->SetDirection(idim);
-        oper->SetVariance( itk::Math::sqr( 0.5
-                                         * static_cast< float >( factors[idim] ) ) );
-        oper->CreateDirectional();
-        radius[idim] = oper->GetRadius()[idim];
+        variance.Fill( 0.0 );
+        variance[idim] = itk::Math::sqr( 0.5 * static_cast< float >( factors[idim] ) );
+        smoother->SetVariance(variance);
+        radius[idim] = smoother->GetKernelRadius( this->GetOutput(ilevel)->GetSpacing() )[idim];
         }
       else
         {
@@ -367,8 +366,6 @@ RecursiveMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >
     this->GetOutput(ilevel)->SetRequestedRegion(requestedRegion);
     }
 
-  // clean up
-  delete oper;
 }
 
 /**
@@ -410,31 +407,31 @@ RecursiveMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >
   baseRegion.SetIndex(baseIndex);
   baseRegion.SetSize(baseSize);
 
-  // compute requirements for the smoothing part
-  using OutputPixelType = typename TOutputImage::PixelType;
-  using OperatorType = GaussianOperator< OutputPixelType, ImageDimension >;
-
-  auto * oper = new OperatorType;
-
-  typename TInputImage::SizeType radius;
+  // compute requirements for the smoothing part, with the kernels of the
+  // smoother of GenerateData()
+  using SmootherType = DiscreteGaussianImageFilter< TOutputImage, TOutputImage >;
+  typename SmootherType::Pointer smoother = SmootherType::New();
+  smoother->SetUseImageSpacing(false);
+  smoother->SetMaximumError( this->GetMaximumError() );
 
   RegionType inputRequestedRegion = baseRegion;
   refLevel = 0;
 
+  typename SmootherType::ArrayType variance;
+  for ( idim = 0; idim < TInputImage::ImageDimension; idim++ )
+    {
+    variance[idim] = itk::Math::sqr( 0.5 * static_cast< float >(
+                                       this->GetSchedule()[refLevel][idim] ) );
+    }
+  smoother->SetVariance(variance);
+  typename SmootherType::InputSizeType radius = smoother->GetKernelRadius( inputPtr->GetSpacing() );
   for ( idim = 0; idim < TInputImage::ImageDimension; idim++ )
     {
-    oper->SetDirection(idim);
-    oper->SetVariance( itk::Math::sqr( 0.5 * static_cast< float >(
-                                       this->GetSchedule()[refLevel][idim] ) ) );
-    oper->SetMaximumError( this->GetMaximumError() );
-    oper->CreateDirectional();
-    radius[idim] = oper->GetRadius()[idim];
     if ( this->GetSchedule()[refLevel][idim] <= 1 )
       {
       radius[idim] = 0;
       }
     }
-  delete oper;
 
   inputRequestedRegion.PadByRadius(radius);
 
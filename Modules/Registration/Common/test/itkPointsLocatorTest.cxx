@@ -18,6 +18,132 @@
 
 #include "itkPointsLocator.h"
 #include "itkMapContainer.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <algorithm>
+
+/**
+ * Compare the searches with a brute force search over random points,
+ * after building the tree, after moving the points a little (the tree is
+ * refitted) and after moving them a lot (the tree is rebuilt).
+ */
+template< typename TPointsContainer >
+int testPointsLocatorMovingPoints()
+{
+  constexpr unsigned int PointDimension = 3;
+  constexpr unsigned int NumberOfPoints = 2000;
+  constexpr unsigned int NumberOfNeighbors = 8;
+
+  using PointType = itk::Point<float, PointDimension>;
+  using PointsContainerType = TPointsContainer;
+  using PointsLocatorType = itk::PointsLocator<PointsContainerType>;
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+
+  typename PointsContainerType::Pointer points = PointsContainerType::New();
+  for( unsigned int i = 0; i < NumberOfPoints; ++i )
+    {
+    PointType point;
+    for( unsigned int d = 0; d < PointDimension; ++d )
+      {
+      point[d] = static_cast<float>( generator->GetUniformVariate( 0.0, 100.0 ) );
+      }
+    points->InsertElement( i, point );
+    }
+
+  typename PointsContainerType::Pointer queries = PointsContainerType::New();
+  for( unsigned int i = 0; i < 200; ++i )
+    {
+    PointType point;
+    for( unsigned int d = 0; d < PointDimension; ++d )
+      {
+      point[d] = static_cast<float>( generator->GetUniformVariate( -10.0, 110.0 ) );
+      }
+    queries->InsertElement( i, point );
+    }
+
+  typename PointsLocatorType::Pointer pointsLocator = PointsLocatorType::New();
+  pointsLocator->SetPoints( points );
+  pointsLocator->Initialize();
+
+  const double moves[] = { 0.0, 0.5, 40.0 };
+  for( double move : moves )
+    {
+    if( move > 0.0 )
+      {
+      for( unsigned int i = 0; i < NumberOfPoints; ++i )
+        {
+        PointType point = points->ElementAt( i );
+        for( unsigned int d = 0; d < PointDimension; ++d )
+          {
+          point[d] += static_cast<float>( generator->GetUniformVariate( -move, move ) );
+          }
+        points->SetElement( i, point );
+        }
+      pointsLocator->UpdatePointLocations();
+      }
+
+    std::vector<typename PointsLocatorType::PointIdentifier> closestPoints;
+    pointsLocator->FindClosestPoints( queries, closestPoints );
+    std::vector<typename PointsLocatorType::NeighborsIdentifierType> closestNPoints;
+    pointsLocator->FindClosestNPoints( queries, NumberOfNeighbors, closestNPoints );
+
+    for( unsigned int q = 0; q < queries->Size(); ++q )
+      {
+      const PointType & query = queries->ElementAt( q );
+
+      std::vector<std::pair<double, unsigned int> > distances;
+      for( unsigned int i = 0; i < NumberOfPoints; ++i )
+        {
+        distances.emplace_back( query.SquaredEuclideanDistanceTo( points->ElementAt( i ) ), i );
+        }
+      std::sort( distances.begin(), distances.end() );
+
+      typename PointsLocatorType::NeighborsIdentifierType neighborhood;
+      pointsLocator->FindClosestNPoints( query, NumberOfNeighbors, neighborhood );
+      if( neighborhood.size() != NumberOfNeighbors || closestNPoints[q] != neighborhood )
+        {
+        std::cerr << "Error with the batched FindClosestNPoints() after moving the points by " << move << std::endl;
+        return EXIT_FAILURE;
+        }
+      for( unsigned int k = 0; k < NumberOfNeighbors; ++k )
+        {
+        const double distance = query.SquaredEuclideanDistanceTo( points->ElementAt( neighborhood[k] ) );
+        if( std::fabs( distance - distances[k].first ) > 1e-6 * ( 1.0 + distances[k].first ) )
+          {
+          std::cerr << "Error with FindClosestNPoints() after moving the points by " << move << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      const typename PointsLocatorType::PointIdentifier pointId = pointsLocator->FindClosestPoint( query );
+      if( pointId != closestPoints[q] ||
+        query.SquaredEuclideanDistanceTo( points->ElementAt( pointId ) ) != distances[0].first )
+        {
+        std::cerr << "Error with FindClosestPoint() after moving the points by " << move << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      const double radius = 8.0;
+      unsigned int numberOfPointsWithinRadius = 0;
+      while( numberOfPointsWithinRadius < NumberOfPoints &&
+        distances[numberOfPointsWithinRadius].first <= radius * radius )
+        {
+        ++numberOfPointsWithinRadius;
+        }
+      pointsLocator->FindPointsWithinRadius( query, radius, neighborhood );
+      if( neighborhood.size() != numberOfPointsWithinRadius )
+        {
+        std::cerr << "Error with FindPointsWithinRadius() after moving the points by " << move << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
 
 template< typename TPointsContainer >
 int testPointsLocatorTest()
@@ -90,6 +216,27 @@ int testPointsLocatorTest()
     return EXIT_FAILURE;
     }
 
+  std::cout << "Test:  FindClosestNPoints() with 0 neighbors" << std::endl;
+
+  pointsLocator->FindClosestNPoints( coords, 0u, neighborhood );
+  if( !neighborhood.empty() )
+    {
+    std::cerr << "Error with FindClosestNPoints() with 0 neighbors" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typename TPointsContainer::Pointer queries = TPointsContainer::New();
+  queries->InsertElement( 0, coords );
+  queries->InsertElement( 1, coords );
+  std::vector<typename PointsLocatorType::NeighborsIdentifierType> neighborhoods( 1, neighborhood );
+  neighborhoods[0].push_back( 0 );
+  pointsLocator->FindClosestNPoints( queries, 0u, neighborhoods );
+  if( neighborhoods.size() != 2 || !neighborhoods[0].empty() || !neighborhoods[1].empty() )
+    {
+    std::cerr << "Error with the batched FindClosestNPoints() with 0 neighbors" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   double radius = std::sqrt( 3 * itk::Math::sqr( 5.1 ) );
 
   std::cout << "Test:  FindPointsWithinRadius()" << std::endl;
@@ -110,7 +257,7 @@ int testPointsLocatorTest()
     return EXIT_FAILURE;
     }
 
-  return EXIT_SUCCESS;
+  return testPointsLocatorMovingPoints< TPointsContainer >();
 }
 
 int itkPointsLocatorTest( int, char* [] )
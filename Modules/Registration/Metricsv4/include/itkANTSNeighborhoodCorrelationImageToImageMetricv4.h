@@ -20,6 +20,7 @@
 
 #include "itkImageToImageMetricv4.h"
 #include "itkANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include <typeinfo>
 
 namespace itk {
 
@@ -166,6 +167,13 @@ public:
 
   void Initialize() override;
 
+  /** Clone() returns a configured copy of the metric, see InternalClone.
+   * Derived classes do not inherit this and must opt in themselves. */
+  bool SupportsCloning() const override
+  {
+    return typeid( *this ) == typeid( Self );
+  }
+
 protected:
   ANTSNeighborhoodCorrelationImageToImageMetricv4();
   ~ANTSNeighborhoodCorrelationImageToImageMetricv4() override;
@@ -178,6 +186,10 @@ protected:
   using ANTSNeighborhoodCorrelationImageToImageMetricv4SparseGetValueAndDerivativeThreaderType =
       ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >;
 
+  /** Clone method will clone the existing instance of this type,
+   *  including its internal member variables. */
+  typename LightObject::Pointer InternalClone() const override;
+
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
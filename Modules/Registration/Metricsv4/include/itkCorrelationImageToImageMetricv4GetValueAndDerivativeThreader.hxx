@@ -181,13 +181,10 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
     {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue );
-    if( pointIsValid &&
-        this->m_CorrelationAssociate->GetComputeDerivative() &&
-        this->m_CorrelationAssociate->GetGradientSourceIncludesFixed() )
-      {
-      this->m_CorrelationAssociate->ComputeFixedImageGradientAtPoint( mappedFixedPoint, mappedFixedImageGradient );
-      }
+    const bool computeFixedImageGradient = this->m_CorrelationAssociate->GetComputeDerivative() &&
+                                           this->m_CorrelationAssociate->GetGradientSourceIncludesFixed();
+    pointIsValid = this->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue,
+      computeFixedImageGradient ? &mappedFixedImageGradient : nullptr, threadId );
     }
   catch( ExceptionObject & exc )
     {
@@ -117,7 +117,7 @@ TImageToImageMetric, TCorrelationMetric>
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
     {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue );
+    pointIsValid = this->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue, nullptr, threadId );
     }
   catch( ExceptionObject & exc )
     {
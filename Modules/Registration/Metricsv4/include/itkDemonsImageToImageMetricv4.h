@@ -21,6 +21,7 @@
 #include "itkImageToImageMetricv4.h"
 
 #include "itkDemonsImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include <typeinfo>
 
 namespace itk
 {
@@ -114,6 +115,13 @@ public:
   /** Get the denominator threshold used in derivative calculation. */
   itkGetConstMacro(DenominatorThreshold, TInternalComputationValueType);
 
+  /** Clone() returns a configured copy of the metric, see InternalClone.
+   * Derived classes do not inherit this and must opt in themselves. */
+  bool SupportsCloning() const override
+  {
+    return typeid( *this ) == typeid( Self );
+  }
+
 protected:
   itkGetConstMacro(Normalizer, TInternalComputationValueType);
 
@@ -127,6 +135,10 @@ protected:
   using DemonsSparseGetValueAndDerivativeThreaderType =
       DemonsImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >;
 
+  /** Clone method will clone the existing instance of this type,
+   *  including its internal member variables. */
+  typename LightObject::Pointer InternalClone() const override;
+
   void PrintSelf(std::ostream& os, Indent indent) const override;
 
 private:
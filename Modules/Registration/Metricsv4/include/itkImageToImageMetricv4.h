@@ -100,13 +100,10 @@ namespace itk
  * SetFixedSampledPointSet is called or SetVirtualSampledPointSet
  * along with SetUseVirtualSampledPointSet.
  * \note If the point set is sparse, the option SetUse[Fixed|Moving]ImageGradientFilter
- * typically should be disabled to avoid excessive computation. However,
- * the gradient values of the fixed image are not cached
- * when using a point set (there are plans for this in the future), so
- * depending on the number of iterations (when used during optimization)
- * and the level of sparsity, it may be more efficient to
- * use a gradient image filter for it because it will only be
- * calculated once.
+ * typically should be disabled to avoid excessive computation. The fixed
+ * image values and gradients at the sampled points can then be computed once
+ * during \c Initialize by enabling \c UseFixedImageSampleCache, instead of
+ * at each iteration.
  *
  * Vector Images
  *
@@ -431,6 +428,16 @@ public:
   itkGetConstReferenceMacro(UseVirtualSampledPointSet, bool);
   itkBooleanMacro(UseVirtualSampledPointSet);
 
+  /** Set/Get flag to cache, for each point of the sampled point set, the
+   * mapped fixed point, the fixed image value and gradient, and whether the
+   * point is valid in the fixed domain. The cache is filled in Initialize()
+   * and used by the sparse evaluation as long as the sampled point set, the
+   * fixed image and the fixed transform are not modified, so that the fixed
+   * image is not interpolated again at each iteration. False by default. */
+  itkSetMacro(UseFixedImageSampleCache, bool);
+  itkGetConstReferenceMacro(UseFixedImageSampleCache, bool);
+  itkBooleanMacro(UseFixedImageSampleCache);
+
 #if !defined(ITK_LEGACY_REMOVE)
   /** UseFixedSampledPointSet is deprecated and has been replaced
   * with UseSampledPointsSet. */
@@ -472,8 +479,8 @@ public:
   /** Set number of work units to use. This the maximum number of work units to use
    * when multithreaded.  The actual number of work units used (may be less than
    * this value) can be obtained with \c GetNumberOfWorkUnitsUsed. */
-  virtual void SetMaximumNumberOfWorkUnits( const ThreadIdType workUnits );
-  virtual ThreadIdType GetMaximumNumberOfWorkUnits() const;
+  void SetMaximumNumberOfWorkUnits( const ThreadIdType workUnits ) override;
+  ThreadIdType GetMaximumNumberOfWorkUnits() const override;
 
 #if !defined ( ITK_LEGACY_REMOVE )
   /** Get number of threads to used in the the most recent
@@ -638,6 +645,12 @@ protected:
                          MovingImagePointType & mappedMovingPoint,
                          MovingImagePixelType & mappedMovingPixelValue ) const;
 
+  /** Evaluate a point already mapped into the MovingImage domain. This
+   * performs the mask and buffer checks of \c TransformAndEvaluateMovingPoint. */
+  bool EvaluateMappedMovingPoint(
+                         const MovingImagePointType & mappedMovingPoint,
+                         MovingImagePixelType & mappedMovingPixelValue ) const;
+
   /** Compute image derivatives for a Fixed point. */
   virtual void ComputeFixedImageGradientAtPoint( const FixedImagePointType & mappedPoint, FixedImageGradientType & gradient ) const;
 
@@ -670,6 +683,29 @@ protected:
   /** Get accessor for flag to calculate derivative. */
   itkGetConstMacro( ComputeDerivative, bool );
 
+  /** Fixed domain values at the points of the virtual sampled point set,
+   * stored as one array per quantity and indexed by point identifier. The
+   * gradients are only stored when the gradient source includes the fixed
+   * image. */
+  struct FixedImageSampleCacheType
+    {
+    std::vector<VirtualPointType>       VirtualPoints;
+    std::vector<VirtualIndexType>       VirtualIndices;
+    std::vector<FixedImagePointType>    MappedFixedPoints;
+    std::vector<FixedImagePixelType>    FixedPixelValues;
+    std::vector<FixedImageGradientType> FixedImageGradients;
+    std::vector<unsigned char>          FixedPointIsValid;
+    };
+
+  /** Fill \c m_FixedImageSampleCache from the virtual sampled point set.
+   * Called by Initialize() when \c UseFixedImageSampleCache is set. */
+  virtual void ComputeFixedImageSampleCache();
+
+  /** Return true if \c m_FixedImageSampleCache was computed from the
+   * current sampled point set, fixed image, fixed transform and gradient
+   * source. */
+  bool IsFixedImageSampleCacheCurrent() const;
+
   FixedImageConstPointer  m_FixedImage;
   MovingImageConstPointer m_MovingImage;
 
@@ -733,9 +769,27 @@ protected:
   FixedSampledPointSet */
   bool                                    m_UseVirtualSampledPointSet;
 
+  /** Fixed domain values of the sampled points, see
+   * SetUseFixedImageSampleCache. */
+  bool                                    m_UseFixedImageSampleCache;
+  FixedImageSampleCacheType               m_FixedImageSampleCache;
+  TimeStamp                               m_FixedImageSampleCacheTime;
+
   ImageToImageMetricv4();
   ~ImageToImageMetricv4() override;
 
+  /** Clone method will clone the existing instance of this type, including
+   * its settings. The images, interpolators, masks, sampled point sets,
+   * user-supplied gradient filters and calculators and the fixed transform
+   * are shared with the clone, which gets its own copy of the moving
+   * transform. Derived classes that add settings must override this method
+   * and copy them, and override SupportsCloning() to return true. Since a
+   * clone only copies the settings known to the class that implements this
+   * method, SupportsCloning() must return true only for that exact type,
+   * i.e. typeid( *this ) == typeid( Self ), so that further derived classes
+   * have to opt in again. The clone must be initialized before it is used. */
+  typename LightObject::Pointer InternalClone() const override;
+
   void PrintSelf(std::ostream& os, Indent indent) const override;
 
 private:
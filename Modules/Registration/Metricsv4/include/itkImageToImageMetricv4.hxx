@@ -65,6 +65,7 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   this->m_UseMovingImageGradientFilter = true;
   this->m_UseSampledPointSet      = false;
   this->m_UseVirtualSampledPointSet      = false;
+  this->m_UseFixedImageSampleCache       = false;
 
   this->m_FloatingPointCorrectionResolution = 1e6;
   this->m_UseFloatingPointCorrection = false;
@@ -190,6 +191,15 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     itkDebugMacro("Initialize: ComputeMovingImageGradientFilterImage");
     this->ComputeMovingImageGradientFilterImage();
     }
+
+  /* Cache the fixed domain values of the sampled points. This requires the
+   * interpolators and gradient images set up above. */
+  this->m_FixedImageSampleCache = FixedImageSampleCacheType();
+  if( this->m_UseSampledPointSet && this->m_UseFixedImageSampleCache )
+    {
+    itkDebugMacro("Initialize: ComputeFixedImageSampleCache");
+    this->ComputeFixedImageSampleCache();
+    }
 }
 
 template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
@@ -325,9 +335,6 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
                          MovingImagePointType & mappedMovingPoint,
                          MovingImagePixelType & mappedMovingPixelValue ) const
 {
-  bool pointIsValid = true;
-  mappedMovingPixelValue = NumericTraits<MovingImagePixelType>::ZeroValue();
-
   // map the point into moving space
 
   // Before transforming points, we should convert their types from the ImagePointType (aka Point<double, dim>)
@@ -341,6 +348,19 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   localMappedMovingPoint = this->m_MovingTransform->TransformPoint( localVirtualPoint );
   mappedMovingPoint.CastFrom(localMappedMovingPoint);
 
+  return this->EvaluateMappedMovingPoint( mappedMovingPoint, mappedMovingPixelValue );
+}
+
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::EvaluateMappedMovingPoint(
+                         const MovingImagePointType & mappedMovingPoint,
+                         MovingImagePixelType & mappedMovingPixelValue ) const
+{
+  bool pointIsValid = true;
+  mappedMovingPixelValue = NumericTraits<MovingImagePixelType>::ZeroValue();
+
   // check against the mask if one is assigned
   if ( this->m_MovingImageMask )
     {
@@ -565,6 +585,61 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     }
 }
 
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::ComputeFixedImageSampleCache()
+{
+  using PointsContainer = typename VirtualPointSetType::PointsContainer;
+  const PointsContainer * points = this->m_VirtualSampledPointSet->GetPoints();
+  const SizeValueType numberOfPoints = this->m_VirtualSampledPointSet->GetNumberOfPoints();
+  const bool computeGradients = this->GetGradientSourceIncludesFixed();
+
+  FixedImageSampleCacheType & cache = this->m_FixedImageSampleCache;
+  cache.VirtualPoints.resize( numberOfPoints );
+  cache.VirtualIndices.resize( numberOfPoints );
+  cache.MappedFixedPoints.resize( numberOfPoints );
+  cache.FixedPixelValues.resize( numberOfPoints );
+  cache.FixedImageGradients.resize( computeGradients ? numberOfPoints : 0 );
+  cache.FixedPointIsValid.resize( numberOfPoints );
+
+  auto cachePoint = [&]( SizeValueType i )
+    {
+    cache.VirtualPoints[i] = points->ElementAt( i );
+    this->m_VirtualImage->TransformPhysicalPointToIndex( cache.VirtualPoints[i], cache.VirtualIndices[i] );
+    bool pointIsValid = this->TransformAndEvaluateFixedPoint( cache.VirtualPoints[i],
+                                                              cache.MappedFixedPoints[i],
+                                                              cache.FixedPixelValues[i] );
+    if( pointIsValid && computeGradients )
+      {
+      this->ComputeFixedImageGradientAtPoint( cache.MappedFixedPoints[i], cache.FixedImageGradients[i] );
+      }
+    cache.FixedPointIsValid[i] = pointIsValid;
+    };
+  this->m_SparseGetValueAndDerivativeThreader->GetMultiThreader()->ParallelizeArray( 0, numberOfPoints, cachePoint, nullptr );
+
+  this->m_FixedImageSampleCacheTime.Modified();
+}
+
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::IsFixedImageSampleCacheCurrent() const
+{
+  if( !this->m_UseSampledPointSet || !this->m_UseFixedImageSampleCache
+      || this->m_VirtualSampledPointSet.IsNull() )
+    {
+    return false;
+    }
+  const ModifiedTimeType cacheTime = this->m_FixedImageSampleCacheTime.GetMTime();
+  const FixedImageSampleCacheType & cache = this->m_FixedImageSampleCache;
+  return cache.FixedPointIsValid.size() == this->m_VirtualSampledPointSet->GetNumberOfPoints()
+    && ( !this->GetGradientSourceIncludesFixed() || cache.FixedImageGradients.size() == cache.FixedPointIsValid.size() )
+    && this->m_VirtualSampledPointSet->GetMTime() < cacheTime
+    && this->m_FixedImage->GetMTime() < cacheTime
+    && this->m_FixedTransform->GetMTime() < cacheTime;
+}
+
 template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
 SizeValueType
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
@@ -583,6 +658,75 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     }
 }
 
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+typename LightObject::Pointer
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+
+  rval->SetFixedImage( this->m_FixedImage );
+  rval->SetMovingImage( this->m_MovingImage );
+  rval->SetFixedInterpolator( this->m_FixedInterpolator );
+  rval->SetMovingInterpolator( this->m_MovingInterpolator );
+  rval->SetFixedImageMask( this->m_FixedImageMask );
+  rval->SetMovingImageMask( this->m_MovingImageMask );
+  rval->SetGradientSource( this->GetGradientSource() );
+
+  rval->SetFixedTransform( this->m_FixedTransform );
+  if( this->m_MovingTransform.IsNotNull() )
+    {
+    typename MovingTransformType::Pointer movingTransform = this->m_MovingTransform->Clone();
+    rval->SetMovingTransform( movingTransform );
+    }
+  if( this->m_UserHasSetVirtualDomain )
+    {
+    rval->SetVirtualDomainFromImage( this->m_VirtualImage );
+    }
+
+  rval->SetFixedSampledPointSet( this->m_FixedSampledPointSet );
+  rval->SetUseSampledPointSet( this->m_UseSampledPointSet );
+  if( this->m_UseVirtualSampledPointSet )
+    {
+    rval->SetVirtualSampledPointSet( this->m_VirtualSampledPointSet );
+    }
+  rval->SetUseVirtualSampledPointSet( this->m_UseVirtualSampledPointSet );
+  rval->SetUseFixedImageSampleCache( this->m_UseFixedImageSampleCache );
+
+  /* Gradient filters and calculators set by the user are shared, the
+   * default ones are owned by each metric. */
+  if( this->m_FixedImageGradientFilter != this->m_DefaultFixedImageGradientFilter )
+    {
+    rval->SetFixedImageGradientFilter( this->m_FixedImageGradientFilter );
+    }
+  if( this->m_MovingImageGradientFilter != this->m_DefaultMovingImageGradientFilter )
+    {
+    rval->SetMovingImageGradientFilter( this->m_MovingImageGradientFilter );
+    }
+  if( this->m_FixedImageGradientCalculator != this->m_DefaultFixedImageGradientCalculator )
+    {
+    rval->SetFixedImageGradientCalculator( this->m_FixedImageGradientCalculator );
+    }
+  if( this->m_MovingImageGradientCalculator != this->m_DefaultMovingImageGradientCalculator )
+    {
+    rval->SetMovingImageGradientCalculator( this->m_MovingImageGradientCalculator );
+    }
+  rval->SetUseFixedImageGradientFilter( this->m_UseFixedImageGradientFilter );
+  rval->SetUseMovingImageGradientFilter( this->m_UseMovingImageGradientFilter );
+
+  rval->SetUseFloatingPointCorrection( this->m_UseFloatingPointCorrection );
+  rval->SetFloatingPointCorrectionResolution( this->m_FloatingPointCorrectionResolution );
+  rval->SetMaximumNumberOfWorkUnits( this->GetMaximumNumberOfWorkUnits() );
+
+  return loPtr;
+}
+
 template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
 void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
@@ -593,6 +737,7 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   os << indent << "ImageToImageMetricv4: " << std::endl
      << indent << "GetUseFixedImageGradientFilter: " << this->GetUseFixedImageGradientFilter() << std::endl
      << indent << "GetUseMovingImageGradientFilter: " << this->GetUseMovingImageGradientFilter() << std::endl
+     << indent << "UseFixedImageSampleCache: " << this->GetUseFixedImageSampleCache() << std::endl
      << indent << "UseFloatingPointCorrection: " << this->GetUseFloatingPointCorrection() << std::endl
      << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl;
 
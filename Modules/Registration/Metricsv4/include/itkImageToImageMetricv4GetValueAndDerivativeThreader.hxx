@@ -20,6 +20,7 @@
 
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -32,13 +33,20 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedImageRegionPartitione
 {
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
   using IteratorType = ImageRegionConstIteratorWithIndex< VirtualImageType >;
-  VirtualPointType virtualPoint;
+  VirtualIndexType virtualIndices[Superclass::VirtualPointBlockSize];
+  VirtualPointType virtualPoints[Superclass::VirtualPointBlockSize];
+  SizeValueType    numberOfPoints = 0;
   for( IteratorType it( virtualImage, imageSubRegion ); !it.IsAtEnd(); ++it )
     {
-    const VirtualIndexType & virtualIndex = it.GetIndex();
-    virtualImage->TransformIndexToPhysicalPoint( virtualIndex, virtualPoint );
-    this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
+    virtualIndices[numberOfPoints] = it.GetIndex();
+    virtualImage->TransformIndexToPhysicalPoint( virtualIndices[numberOfPoints], virtualPoints[numberOfPoints] );
+    if( ++numberOfPoints == Superclass::VirtualPointBlockSize )
+      {
+      this->ProcessVirtualPoints( virtualIndices, virtualPoints, numberOfPoints, threadId );
+      numberOfPoints = 0;
+      }
     }
+  this->ProcessVirtualPoints( virtualIndices, virtualPoints, numberOfPoints, threadId );
   //Finalize per thread actions
   this->m_Associate->FinalizeThread( threadId );
 }
@@ -53,14 +61,35 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerParti
   using ElementIdentifierType = typename TImageToImageMetricv4::VirtualPointSetType::MeshTraits::PointIdentifier;
   const ElementIdentifierType begin = indexSubRange[0];
   const ElementIdentifierType end   = indexSubRange[1];
-  VirtualIndexType virtualIndex;
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
+
+  /* The fixed image sample cache also holds the virtual points and indices. */
+  if( this->m_UseFixedImageSampleCache )
+    {
+    const typename TImageToImageMetricv4::FixedImageSampleCacheType & cache = this->m_Associate->m_FixedImageSampleCache;
+    for( ElementIdentifierType i = begin; i <= end; i += Superclass::VirtualPointBlockSize )
+      {
+      const SizeValueType numberOfPoints = std::min( static_cast< SizeValueType >( end - i + 1 ), Superclass::VirtualPointBlockSize );
+      this->ProcessVirtualPoints( &cache.VirtualIndices[i], &cache.VirtualPoints[i], numberOfPoints, threadId, i );
+      }
+    this->m_Associate->FinalizeThread( threadId );
+    return;
+    }
+
+  VirtualIndexType virtualIndices[Superclass::VirtualPointBlockSize];
+  VirtualPointType virtualPoints[Superclass::VirtualPointBlockSize];
+  SizeValueType    numberOfPoints = 0;
   for( ElementIdentifierType i = begin; i <= end; ++i )
     {
-    const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint( i );
-    virtualImage->TransformPhysicalPointToIndex( virtualPoint, virtualIndex );
-    this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
+    virtualPoints[numberOfPoints] = virtualSampledPointSet->GetPoint( i );
+    virtualImage->TransformPhysicalPointToIndex( virtualPoints[numberOfPoints], virtualIndices[numberOfPoints] );
+    if( ++numberOfPoints == Superclass::VirtualPointBlockSize )
+      {
+      this->ProcessVirtualPoints( virtualIndices, virtualPoints, numberOfPoints, threadId );
+      numberOfPoints = 0;
+      }
     }
+  this->ProcessVirtualPoints( virtualIndices, virtualPoints, numberOfPoints, threadId );
   //Finalize per thread actions
   this->m_Associate->FinalizeThread( threadId );
 }
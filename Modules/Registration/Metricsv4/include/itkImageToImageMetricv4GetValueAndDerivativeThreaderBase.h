@@ -20,6 +20,7 @@
 
 #include "itkDomainThreader.h"
 #include "itkCompensatedSummation.h"
+#include "itkBSplineBaseTransform.h"
 
 namespace itk
 {
@@ -39,6 +40,14 @@ namespace itk
  *  ProcessVirtualPoint on every point in the virtual image domain.  \c
  *  ProcessVirtualPoint calls \c ProcessPoint on each point.
  *
+ *  Derived threaders that return true from \c SupportsSparseBSplineJacobian
+ *  evaluate a cubic B-spline moving transform in blocks of virtual points
+ *  with BSplineBaseTransform::TransformPointsAndJacobians. The moving
+ *  transform Jacobian returned by \c ComputeMovingTransformJacobian and the
+ *  local derivative filled by \c ProcessPoint then only cover the
+ *  parameters in the support of the point, and \c GetCachedNumberOfLocalParameters
+ *  returns the size of that support.
+ *
  * \ingroup ITKMetricsv4 */
 template < typename TDomainPartitioner, typename TImageToImageMetricv4 >
 class ITK_TEMPLATE_EXPORT ImageToImageMetricv4GetValueAndDerivativeThreaderBase
@@ -89,6 +98,15 @@ public:
   using CompensatedDerivativeValueType = CompensatedSummation<DerivativeValueType>;
   using CompensatedDerivativeType = std::vector<CompensatedDerivativeValueType>;
 
+  /** Moving transform type evaluated in blocks with sparse Jacobians. */
+  using MovingBSplineTransformType = BSplineBaseTransform< typename MovingTransformType::ScalarType,
+                                                           ImageToImageMetricv4Type::MovingImageDimension, 3 >;
+  using SparseJacobianBlockType = typename MovingBSplineTransformType::SparseJacobianBlockType;
+
+  /** Number of virtual points mapped at once through a B-spline moving
+   * transform. */
+  static constexpr SizeValueType VirtualPointBlockSize = 64;
+
   /** Access the GetValueAndDerivative() accesor in image metric base. */
   virtual bool GetComputeDerivative() const;
 
@@ -116,6 +134,45 @@ protected:
                                     const VirtualPointType & virtualPoint,
                                     const ThreadIdType threadId );
 
+  /** Call \c ProcessVirtualPoint on each of the given points. When sparse
+   * B-spline Jacobians are used, the points are first mapped through the
+   * moving transform together. \c firstSampleId is the identifier of the
+   * first point in the virtual sampled point set, it is only used to look
+   * up the fixed image sample cache. */
+  void ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                             const VirtualPointType * virtualPoints,
+                             SizeValueType numberOfPoints,
+                             const ThreadIdType threadId,
+                             SizeValueType firstSampleId = 0 );
+
+  /** Map \c virtualPoint into the fixed domain and evaluate the fixed image
+   * there, as \c TransformAndEvaluateFixedPoint of the metric does. The
+   * fixed image gradient is also computed when \c mappedFixedImageGradient
+   * is not nullptr. The values are taken from the fixed image sample cache
+   * of the metric when it is current. */
+  bool TransformAndEvaluateFixedPoint( const VirtualPointType & virtualPoint,
+                                       FixedImagePointType & mappedFixedPoint,
+                                       FixedImagePixelType & mappedFixedPixelValue,
+                                       FixedImageGradientType * mappedFixedImageGradient,
+                                       const ThreadIdType threadId ) const;
+
+  /** Return true when \c ProcessPoint gets the moving transform Jacobian from
+   * \c ComputeMovingTransformJacobian and only uses the first
+   * \c GetCachedNumberOfLocalParameters entries of the Jacobian and local
+   * derivative, so that cubic B-spline moving transforms can be evaluated
+   * sparsely. The default is false. */
+  virtual bool SupportsSparseBSplineJacobian() const
+  {
+    return false;
+  }
+
+  /** Compute the Jacobian of the moving transform with respect to the local
+   * parameters at \c virtualPoint into the per-thread MovingTransformJacobian
+   * and return it. With sparse B-spline Jacobians the Jacobian is taken from
+   * the block of the point being processed. */
+  const JacobianType & ComputeMovingTransformJacobian( const VirtualPointType & virtualPoint,
+                                                       const ThreadIdType threadId ) const;
+
   /** Method to calculate the metric value and derivative
    * given a point, value and image derivative for both fixed and moving
    * spaces. The provided values have been calculated from \c virtualPoint,
@@ -180,6 +237,14 @@ protected:
      * classes for efficiency. */
     JacobianType                 MovingTransformJacobian;
     JacobianType                 MovingTransformJacobianPositional;
+    /** Mapped points and sparse Jacobians of the block of points being
+     * processed, and the position of the current point in the block. Only
+     * used with sparse B-spline Jacobians. */
+    SparseJacobianBlockType      MovingTransformSparseJacobianBlock;
+    SizeValueType                PointInSparseJacobianBlock;
+    /** Identifier of the point being processed in the virtual sampled point
+     * set. Only used with the fixed image sample cache. */
+    SizeValueType                SampleId;
     };
   itkPadStruct( ITK_CACHE_LINE_ALIGNMENT, GetValueAndDerivativePerThreadStruct,
                                             PaddedGetValueAndDerivativePerThreadStruct);
@@ -191,6 +256,21 @@ protected:
    *  These will only be set once threading has been started. */
   mutable NumberOfParametersType                      m_CachedNumberOfParameters;
   mutable NumberOfParametersType                      m_CachedNumberOfLocalParameters;
+
+  /** The moving transform when it is evaluated with sparse B-spline
+   * Jacobians, otherwise nullptr. Set in \c BeforeThreadedExecution. */
+  const MovingBSplineTransformType *                  m_SparseJacobianMovingTransform;
+
+  /** Whether the fixed image sample cache of the metric is used. Set in
+   * \c BeforeThreadedExecution. */
+  bool                                                m_UseFixedImageSampleCache;
+
+private:
+  /** Return the cubic B-spline moving transform if it can be evaluated with
+   * sparse Jacobians: either the moving transform itself, or the only
+   * transform of a CompositeTransform as set up by the v4 registration
+   * methods. */
+  const MovingBSplineTransformType * GetSparseJacobianMovingTransform() const;
 };
 
 } // end namespace itk
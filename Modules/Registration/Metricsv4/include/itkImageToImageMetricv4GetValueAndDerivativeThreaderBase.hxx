@@ -19,6 +19,7 @@
 #define itkImageToImageMetricv4GetValueAndDerivativeThreaderBase_hxx
 
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreaderBase.h"
+#include "itkCompositeTransform.h"
 #include "itkNumericTraits.h"
 
 namespace itk
@@ -29,7 +30,9 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
 ::ImageToImageMetricv4GetValueAndDerivativeThreaderBase():
   m_GetValueAndDerivativePerThreadVariables( nullptr ),
   m_CachedNumberOfParameters( 0 ),
-  m_CachedNumberOfLocalParameters( 0 )
+  m_CachedNumberOfLocalParameters( 0 ),
+  m_SparseJacobianMovingTransform( nullptr ),
+  m_UseFixedImageSampleCache( false )
 {
 }
 
@@ -52,6 +55,21 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
   this->m_CachedNumberOfParameters      = this->m_Associate->GetNumberOfParameters();
   this->m_CachedNumberOfLocalParameters = this->m_Associate->GetNumberOfLocalParameters();
 
+  // With sparse B-spline Jacobians the local parameters of a point are the
+  // coefficients in its support.
+  this->m_SparseJacobianMovingTransform = nullptr;
+  if( this->SupportsSparseBSplineJacobian() )
+    {
+    this->m_SparseJacobianMovingTransform = this->GetSparseJacobianMovingTransform();
+    }
+  if( this->m_SparseJacobianMovingTransform != nullptr )
+    {
+    this->m_CachedNumberOfLocalParameters =
+      this->m_SparseJacobianMovingTransform->GetNumberOfWeights() * ImageToImageMetricv4Type::MovingImageDimension;
+    }
+
+  this->m_UseFixedImageSampleCache = this->m_Associate->IsFixedImageSampleCacheCurrent();
+
   /* Per-thread results */
   const ThreadIdType numThreadsUsed = this->GetNumberOfWorkUnitsUsed();
   delete[] m_GetValueAndDerivativePerThreadVariables;
@@ -66,6 +84,11 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
       this->m_GetValueAndDerivativePerThreadVariables[i].LocalDerivatives.SetSize( this->m_CachedNumberOfLocalParameters );
       this->m_GetValueAndDerivativePerThreadVariables[i].MovingTransformJacobian.SetSize(
         this->m_Associate->VirtualImageDimension, this->m_CachedNumberOfLocalParameters );
+      if( this->m_SparseJacobianMovingTransform != nullptr )
+        {
+        // Only the weights are set per point, see ComputeMovingTransformJacobian.
+        this->m_GetValueAndDerivativePerThreadVariables[i].MovingTransformJacobian.Fill( NumericTraits< typename JacobianType::ValueType >::ZeroValue() );
+        }
       // Not pre-allocated since it may not be used
       //this->m_GetValueAndDerivativePerThreadVariables[i].MovingTransformJacobianPositional
       if ( this->m_Associate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField )
@@ -194,13 +217,10 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
     {
-    pointIsValid = this->m_Associate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
-    if( pointIsValid &&
-        this->m_Associate->GetComputeDerivative() &&
-        this->m_Associate->GetGradientSourceIncludesFixed() )
-      {
-      this->m_Associate->ComputeFixedImageGradientAtPoint( mappedFixedPoint, mappedFixedImageGradient );
-      }
+    const bool computeFixedImageGradient = this->m_Associate->GetComputeDerivative() &&
+                                           this->m_Associate->GetGradientSourceIncludesFixed();
+    pointIsValid = this->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue,
+      computeFixedImageGradient ? &mappedFixedImageGradient : nullptr, threadId );
     }
   catch( ExceptionObject & exc )
     {
@@ -217,7 +237,17 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
 
   try
     {
-    pointIsValid = this->m_Associate->TransformAndEvaluateMovingPoint( virtualPoint, mappedMovingPoint, mappedMovingPixelValue );
+    if( this->m_SparseJacobianMovingTransform != nullptr )
+      {
+      const AlignedGetValueAndDerivativePerThreadStruct & threadVariables = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+      mappedMovingPoint.CastFrom(
+        threadVariables.MovingTransformSparseJacobianBlock.OutputPoints[threadVariables.PointInSparseJacobianBlock] );
+      pointIsValid = this->m_Associate->EvaluateMappedMovingPoint( mappedMovingPoint, mappedMovingPixelValue );
+      }
+    else
+      {
+      pointIsValid = this->m_Associate->TransformAndEvaluateMovingPoint( virtualPoint, mappedMovingPoint, mappedMovingPixelValue );
+      }
     if( pointIsValid &&
         this->m_Associate->GetComputeDerivative() &&
         this->m_Associate->GetGradientSourceIncludesMoving() )
@@ -278,7 +308,40 @@ void
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
 ::StorePointDerivativeResult( const VirtualIndexType & virtualIndex, const ThreadIdType threadId )
 {
-  if ( this->m_Associate->m_MovingTransform->GetTransformCategory() != MovingTransformType::DisplacementField )
+  if ( this->m_SparseJacobianMovingTransform != nullptr )
+    {
+    /* Sparse B-spline Jacobian: the local derivatives are ordered as the
+     * columns of the compact Jacobian, see ComputeMovingTransformJacobian. */
+    AlignedGetValueAndDerivativePerThreadStruct & threadVariables = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+    const SparseJacobianBlockType & block = threadVariables.MovingTransformSparseJacobianBlock;
+    const SizeValueType pointInBlock = threadVariables.PointInSparseJacobianBlock;
+    if ( !block.Inside[pointInBlock] )
+      {
+      return;
+      }
+    if ( this->m_Associate->GetUseFloatingPointCorrection() )
+      {
+      DerivativeValueType correctionResolution = this->m_Associate->GetFloatingPointCorrectionResolution();
+      for (NumberOfParametersType p = 0; p < this->m_CachedNumberOfLocalParameters; p++ )
+        {
+        auto test = static_cast< intmax_t >( threadVariables.LocalDerivatives[p] * correctionResolution );
+        threadVariables.LocalDerivatives[p] = static_cast<DerivativeValueType>( test / correctionResolution );
+        }
+      }
+    const unsigned int numberOfWeights = block.NumberOfWeights;
+    const NumberOfParametersType numberOfParametersPerDimension =
+      this->m_SparseJacobianMovingTransform->GetNumberOfParametersPerDimension();
+    const auto * parameterIndices = &block.ParameterIndices[pointInBlock * numberOfWeights];
+    for ( unsigned int d = 0; d < ImageToImageMetricv4Type::MovingImageDimension; d++ )
+      {
+      for ( unsigned int k = 0; k < numberOfWeights; k++ )
+        {
+        threadVariables.CompensatedDerivatives[parameterIndices[k] + d * numberOfParametersPerDimension] +=
+          threadVariables.LocalDerivatives[k + d * numberOfWeights];
+        }
+      }
+    }
+  else if ( this->m_Associate->m_MovingTransform->GetTransformCategory() != MovingTransformType::DisplacementField )
     {
     /* Global support */
     if ( this->m_Associate->GetUseFloatingPointCorrection() )
@@ -323,6 +386,146 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
     }
 }
 
+template< typename TDomainPartitioner, typename TImageToImageMetricv4 >
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
+::ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                        const VirtualPointType * virtualPoints,
+                        SizeValueType numberOfPoints,
+                        const ThreadIdType threadId,
+                        SizeValueType firstSampleId )
+{
+  AlignedGetValueAndDerivativePerThreadStruct & threadVariables = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  if( this->m_SparseJacobianMovingTransform == nullptr )
+    {
+    for( SizeValueType i = 0; i < numberOfPoints; ++i )
+      {
+      threadVariables.SampleId = firstSampleId + i;
+      this->ProcessVirtualPoint( virtualIndices[i], virtualPoints[i], threadId );
+      }
+    return;
+    }
+
+  typename MovingBSplineTransformType::InputPointType inputPoints[VirtualPointBlockSize];
+  for( SizeValueType blockStart = 0; blockStart < numberOfPoints; blockStart += VirtualPointBlockSize )
+    {
+    const SizeValueType blockSize = std::min( VirtualPointBlockSize, numberOfPoints - blockStart );
+    for( SizeValueType i = 0; i < blockSize; ++i )
+      {
+      inputPoints[i].CastFrom( virtualPoints[blockStart + i] );
+      }
+    try
+      {
+      this->m_SparseJacobianMovingTransform->TransformPointsAndJacobians( inputPoints, blockSize,
+        threadVariables.MovingTransformSparseJacobianBlock );
+      }
+    catch( ExceptionObject & exc )
+      {
+      std::string msg("Caught exception: \n");
+      msg += exc.what();
+      ExceptionObject err(__FILE__, __LINE__, msg);
+      throw err;
+      }
+    for( SizeValueType i = 0; i < blockSize; ++i )
+      {
+      threadVariables.PointInSparseJacobianBlock = i;
+      threadVariables.SampleId = firstSampleId + blockStart + i;
+      this->ProcessVirtualPoint( virtualIndices[blockStart + i], virtualPoints[blockStart + i], threadId );
+      }
+    }
+}
+
+template< typename TDomainPartitioner, typename TImageToImageMetricv4 >
+bool
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
+::TransformAndEvaluateFixedPoint( const VirtualPointType & virtualPoint,
+                                  FixedImagePointType & mappedFixedPoint,
+                                  FixedImagePixelType & mappedFixedPixelValue,
+                                  FixedImageGradientType * mappedFixedImageGradient,
+                                  const ThreadIdType threadId ) const
+{
+  if( this->m_UseFixedImageSampleCache )
+    {
+    const typename ImageToImageMetricv4Type::FixedImageSampleCacheType & cache = this->m_Associate->m_FixedImageSampleCache;
+    const SizeValueType sampleId = this->m_GetValueAndDerivativePerThreadVariables[threadId].SampleId;
+    if( !cache.FixedPointIsValid[sampleId] )
+      {
+      return false;
+      }
+    mappedFixedPoint = cache.MappedFixedPoints[sampleId];
+    mappedFixedPixelValue = cache.FixedPixelValues[sampleId];
+    if( mappedFixedImageGradient != nullptr )
+      {
+      *mappedFixedImageGradient = cache.FixedImageGradients[sampleId];
+      }
+    return true;
+    }
+
+  const bool pointIsValid = this->m_Associate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue );
+  if( pointIsValid && mappedFixedImageGradient != nullptr )
+    {
+    this->m_Associate->ComputeFixedImageGradientAtPoint( mappedFixedPoint, *mappedFixedImageGradient );
+    }
+  return pointIsValid;
+}
+
+template< typename TDomainPartitioner, typename TImageToImageMetricv4 >
+const typename ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >::JacobianType &
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
+::ComputeMovingTransformJacobian( const VirtualPointType & virtualPoint, const ThreadIdType threadId ) const
+{
+  AlignedGetValueAndDerivativePerThreadStruct & threadVariables = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+  JacobianType & jacobian = threadVariables.MovingTransformJacobian;
+
+  if( this->m_SparseJacobianMovingTransform == nullptr )
+    {
+    /** For dense transforms, this returns identity */
+    this->m_Associate->GetMovingTransform()->
+      ComputeJacobianWithRespectToParametersCachedTemporaries( virtualPoint,
+                                                               jacobian,
+                                                               threadVariables.MovingTransformJacobianPositional );
+    return jacobian;
+    }
+
+  // Column k + d * numberOfWeights of the compact Jacobian corresponds to
+  // the k-th coefficient of the support in dimension d. Only its row d is
+  // nonzero, the other entries stay zero from BeforeThreadedExecution.
+  const SparseJacobianBlockType & block = threadVariables.MovingTransformSparseJacobianBlock;
+  const SizeValueType pointInBlock = threadVariables.PointInSparseJacobianBlock;
+  const unsigned int numberOfWeights = block.NumberOfWeights;
+  const bool inside = block.Inside[pointInBlock] != 0;
+  const auto * weights = &block.Weights[pointInBlock * numberOfWeights];
+  for( unsigned int d = 0; d < ImageToImageMetricv4Type::MovingImageDimension; ++d )
+    {
+    for( unsigned int k = 0; k < numberOfWeights; ++k )
+      {
+      jacobian( d, k + d * numberOfWeights ) = inside ? weights[k] : 0.0;
+      }
+    }
+  return jacobian;
+}
+
+template< typename TDomainPartitioner, typename TImageToImageMetricv4 >
+const typename ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >::MovingBSplineTransformType *
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
+::GetSparseJacobianMovingTransform() const
+{
+  const MovingTransformType * movingTransform = this->m_Associate->GetMovingTransform();
+
+  using CompositeTransformType = CompositeTransform< typename MovingTransformType::ScalarType,
+                                                     ImageToImageMetricv4Type::MovingImageDimension >;
+  const auto * compositeTransform = dynamic_cast< const CompositeTransformType * >( movingTransform );
+  if( compositeTransform != nullptr )
+    {
+    if( compositeTransform->GetNumberOfTransforms() != 1 || !compositeTransform->GetNthTransformToOptimize( 0 ) )
+      {
+      return nullptr;
+      }
+    return dynamic_cast< const MovingBSplineTransformType * >( compositeTransform->GetNthTransformConstPointer( 0 ) );
+    }
+  return dynamic_cast< const MovingBSplineTransformType * >( movingTransform );
+}
+
 template< typename TDomainPartitioner, typename TImageToImageMetricv4 >
 bool
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
@@ -87,6 +87,13 @@ protected:
 
   void AfterThreadedExecution() override;
 
+  /** The derivative only uses the moving transform Jacobian through
+   * ComputeMovingTransformJacobian. */
+  bool SupportsSparseBSplineJacobian() const override
+  {
+    return true;
+  }
+
   bool ProcessPoint(
         const VirtualIndexType &          virtualIndex,
         const VirtualPointType &          virtualPoint,
@@ -152,16 +152,8 @@ JointHistogramMutualInformationGetValueAndDerivativeThreader< TDomainPartitioner
     scalingfactor = NumericTraits< InternalComputationValueType >::ZeroValue();
     }
 
-  /* Use a pre-allocated jacobian object for efficiency */
-  using JacobianReferenceType = JacobianType &;
-  JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
-  JacobianReferenceType jacobianPositional = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
-
   /** For dense transforms, this returns identity */
-  this->m_JointAssociate->GetMovingTransform()->
-    ComputeJacobianWithRespectToParametersCachedTemporaries(virtualPoint,
-                                                            jacobian,
-                                                            jacobianPositional);
+  const JacobianType & jacobian = this->ComputeMovingTransformJacobian( virtualPoint, threadId );
 
   for ( NumberOfParametersType par = 0; par < this->GetCachedNumberOfLocalParameters(); par++ )
     {
@@ -25,6 +25,7 @@
 
 #include "itkJointHistogramMutualInformationComputeJointPDFThreader.h"
 #include "itkJointHistogramMutualInformationGetValueAndDerivativeThreader.h"
+#include <typeinfo>
 
 namespace itk
 {
@@ -145,6 +146,13 @@ public:
 
   MeasureType GetValue() const override;
 
+  /** Clone() returns a configured copy of the metric, see InternalClone.
+   * Derived classes do not inherit this and must opt in themselves. */
+  bool SupportsCloning() const override
+  {
+    return typeid( *this ) == typeid( Self );
+  }
+
 protected:
   JointHistogramMutualInformationImageToImageMetricv4();
   ~JointHistogramMutualInformationImageToImageMetricv4() override;
@@ -182,6 +190,10 @@ protected:
   using JointHistogramMutualInformationSparseGetValueAndDerivativeThreaderType =
       JointHistogramMutualInformationGetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >;
 
+  /** Clone method will clone the existing instance of this type,
+   *  including its internal member variables. */
+  typename LightObject::Pointer InternalClone() const override;
+
   /** Standard PrintSelf method. */
   void PrintSelf(std::ostream & os, Indent indent) const override;
 
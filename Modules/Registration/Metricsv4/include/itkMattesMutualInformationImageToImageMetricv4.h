@@ -26,6 +26,7 @@
 #include "itkArray2D.h"
 #include "itkThreadedIndexedContainerPartitioner.h"
 #include <mutex>
+#include <typeinfo>
 
 namespace itk
 {
@@ -64,8 +65,12 @@ namespace itk
  * \warning Local-support transforms are not yet supported. If used,
  * an exception is thrown during Initialize().
  *
- * \note The per-iteration post-processing code is not multi-threaded, but could be
- * readily be made so for a small performance gain.
+ * \note Each work unit fills its own joint PDF. With global-support
+ * transforms it also fills its own joint PDF derivatives, as long as the
+ * squared number of histogram bins does not exceed
+ * MaximumDerivativeBufferSize. The per-thread buffers are summed in
+ * parallel lanes after the threaded execution, see ReduceThreaderBuffers().
+ * The rest of the per-iteration post-processing code is not multi-threaded.
  * See GetValueCommonAfterThreadedExecution(), GetValueAndDerivative()
  * and threader::AfterThreadedExecution().
  *
@@ -192,6 +197,13 @@ public:
 
   void FinalizeThread( const ThreadIdType threadId ) override;
 
+  /** Clone() returns a configured copy of the metric, see InternalClone.
+   * Derived classes do not inherit this and must opt in themselves. */
+  bool SupportsCloning() const override
+  {
+    return typeid( *this ) == typeid( Self );
+  }
+
 protected:
   MattesMutualInformationImageToImageMetricv4();
   ~MattesMutualInformationImageToImageMetricv4() override;
@@ -203,6 +215,10 @@ protected:
   using MattesMutualInformationSparseGetValueAndDerivativeThreaderType =
       MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >;
 
+  /** Clone method will clone the existing instance of this type,
+   *  including its internal member variables. */
+  typename LightObject::Pointer InternalClone() const override;
+
   void PrintSelf(std::ostream& os, Indent indent) const override;
 
   using JointPDFIndexType = typename JointPDFType::IndexType;
@@ -224,6 +240,17 @@ protected:
 
   OffsetValueType ComputeSingleFixedImageParzenWindowIndex( const FixedImagePixelType & value ) const;
 
+  /** Sum the first \c numberOfElements values of the \c numberOfBuffers
+   * per-thread buffers into the first buffer and multiply the result by
+   * \c scale. Each element is summed in work unit order, so the result
+   * does not depend on the partitioning. Lanes of consecutive elements
+   * are reduced in parallel without locking. */
+  void ReduceThreaderBuffers( PDFValueType * const * buffers, ThreadIdType numberOfBuffers,
+                              SizeValueType numberOfElements, PDFValueType scale ) const;
+
+  /** Number of rows at which a DerivativeBufferManager stops growing. */
+  static constexpr SizeValueType MaximumDerivativeBufferSize = 5000;
+
   /** Variables to define the marginal and joint histograms. */
   SizeValueType m_NumberOfHistogramBins{50};
   PDFValueType  m_MovingImageNormalizedMin;
@@ -339,6 +366,16 @@ private:
   std::mutex                                m_JointPDFDerivativesLock;
   typename JointPDFDerivativesType::Pointer m_JointPDFDerivatives;
 
+  /** With global-support transforms, each work unit accumulates into its
+   * own copy of the joint PDF derivatives instead of going through a
+   * DerivativeBufferManager when a copy has no more rows than a fully grown
+   * buffer, i.e. when the number of histogram bins squared is at most
+   * MaximumDerivativeBufferSize. The first work unit uses
+   * m_JointPDFDerivatives directly, the copies of the others are summed
+   * into it after the threaded execution. */
+  bool                                      m_UseThreaderJointPDFDerivatives{false};
+  std::vector<std::vector<PDFValueType> >   m_ThreaderJointPDFDerivatives;
+
   PDFValueType m_JointPDFSum;
 
   /** Store the per-point local derivative result by parzen window bin.
@@ -20,6 +20,7 @@
 
 #include "itkMattesMutualInformationImageToImageMetricv4.h"
 #include "itkCompensatedSummation.h"
+#include <algorithm>
 #include <mutex>
 
 namespace itk
@@ -180,7 +181,7 @@ void
 MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
 ::FinalizeThread( const ThreadIdType threadId )
 {
-  if( this->GetComputeDerivative() && ( !this->HasLocalSupport() ) )
+  if( this->GetComputeDerivative() && ( !this->HasLocalSupport() ) && !this->m_UseThreaderJointPDFDerivatives )
     {
     this->m_ThreaderDerivativeManager[threadId].BlockAndReduce();
     }
@@ -335,15 +336,15 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
   const SizeValueType numberOfVoxels = this->m_NumberOfHistogramBins* this->m_NumberOfHistogramBins;
   JointPDFValueType * const pdfPtrStart = this->m_ThreaderJointPDF[0]->GetBufferPointer();
 
+  std::vector< JointPDFValueType * > threaderJointPDFPtrs( localNumberOfWorkUnitsUsed );
+  for( unsigned int t = 0; t < localNumberOfWorkUnitsUsed; ++t )
+    {
+    threaderJointPDFPtrs[t] = this->m_ThreaderJointPDF[t]->GetBufferPointer();
+    }
+  this->ReduceThreaderBuffers( threaderJointPDFPtrs.data(), localNumberOfWorkUnitsUsed, numberOfVoxels, 1.0 );
+
   for( unsigned int t = 1; t < localNumberOfWorkUnitsUsed; ++t )
     {
-    JointPDFValueType *             pdfPtr = pdfPtrStart;
-    JointPDFValueType const *       tPdfPtr = this->m_ThreaderJointPDF[t]->GetBufferPointer();
-    JointPDFValueType const * const tPdfPtrEnd = tPdfPtr + numberOfVoxels;
-    while( tPdfPtr < tPdfPtrEnd )
-      {
-      *( pdfPtr++ ) += *( tPdfPtr++ );
-      }
     for( SizeValueType i = 0; i < this->m_NumberOfHistogramBins; ++i )
       {
       this->m_ThreaderFixedImageMarginalPDF[0][i] += this->m_ThreaderFixedImageMarginalPDF[t][i];
@@ -361,6 +362,59 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
 }
 
 
+template <typename TFixedImage, typename TMovingImage, typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::ReduceThreaderBuffers( PDFValueType * const * buffers, ThreadIdType numberOfBuffers,
+                         SizeValueType numberOfElements, PDFValueType scale ) const
+{
+  // A lane is small enough for its part of every per-thread buffer to be
+  // streamed through the cache once.
+  constexpr SizeValueType laneSize = 4096;
+  const SizeValueType numberOfLanes = ( numberOfElements + laneSize - 1 ) / laneSize;
+
+  auto reduceLane = [buffers, numberOfBuffers, numberOfElements, scale]( SizeValueType lane )
+    {
+    const SizeValueType begin = lane * laneSize;
+    const SizeValueType end = std::min( begin + laneSize, numberOfElements );
+    PDFValueType * const accumulator = buffers[0];
+    for( ThreadIdType t = 1; t < numberOfBuffers; ++t )
+      {
+      PDFValueType const * const threadBuffer = buffers[t];
+      for( SizeValueType i = begin; i < end; ++i )
+        {
+        accumulator[i] += threadBuffer[i];
+        }
+      }
+    for( SizeValueType i = begin; i < end; ++i )
+      {
+      accumulator[i] *= scale;
+      }
+    };
+
+  MultiThreaderBase * multiThreader = this->m_UseSampledPointSet
+    ? this->m_SparseGetValueAndDerivativeThreader->GetMultiThreader()
+    : this->m_DenseGetValueAndDerivativeThreader->GetMultiThreader();
+  multiThreader->ParallelizeArray( 0, numberOfLanes, reduceLane, nullptr );
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+typename LightObject::Pointer
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->SetNumberOfHistogramBins( this->m_NumberOfHistogramBins );
+
+  return loPtr;
+}
+
 template <typename TFixedImage, typename TMovingImage, typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
 void
 MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
@@ -457,7 +511,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
       {
       ReduceBuffer();
       }
-    else if (m_MaxBufferSize<5000)
+    else if (m_MaxBufferSize<MaximumDerivativeBufferSize)
       {
       DoubleBufferSize();
       //Attempt to acquire the lock a second time
@@ -212,25 +212,49 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       // Initialize to zero for accumulation
       this->m_MattesAssociate->m_JointPDFDerivatives->FillBuffer(0.0F);
       }
-    if( ( this->m_MattesAssociate->m_ThreaderDerivativeManager.size() != localNumberOfWorkUnitsUsed ) )
+
+    const SizeValueType numberOfHistogramBins = this->m_MattesAssociate->m_NumberOfHistogramBins;
+    this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives =
+      ( numberOfHistogramBins * numberOfHistogramBins <= TMattesMutualInformationMetric::MaximumDerivativeBufferSize );
+    if( this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives )
       {
-      this->m_MattesAssociate->m_ThreaderDerivativeManager.resize(localNumberOfWorkUnitsUsed);
+      // Work unit 0 accumulates into m_JointPDFDerivatives, the others into
+      // their own copy. The copies are cleared in parallel.
+      this->m_MattesAssociate->m_ThreaderDerivativeManager.clear();
+      std::vector< std::vector< PDFValueType > > & threaderJointPDFDerivatives =
+        this->m_MattesAssociate->m_ThreaderJointPDFDerivatives;
+      threaderJointPDFDerivatives.resize( localNumberOfWorkUnitsUsed - 1 );
+      const SizeValueType jointPDFDerivativesSize = jointPDFDerivativesRegion.GetNumberOfPixels();
+      this->GetMultiThreader()->ParallelizeArray( 0, threaderJointPDFDerivatives.size(),
+        [&threaderJointPDFDerivatives, jointPDFDerivativesSize]( SizeValueType t )
+          {
+          threaderJointPDFDerivatives[t].assign( jointPDFDerivativesSize, 0.0 );
+          },
+        nullptr );
       }
-    for( ThreadIdType threadId = 0; threadId < localNumberOfWorkUnitsUsed; ++threadId )
+    else
       {
-      this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].Initialize(
-        // A heuristic that assumues memory for 2x size of
-        // m_JointPDFDerivati efficient and easy to make, so
-        // split it accross all the threads.  A work unit of at least 400 is needed
-        // when the thread size approaches the number of histograms so that the
-        // there is enough work to be done between thread lockings.
-        std::max<size_t>(500,
-        this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins / localNumberOfWorkUnitsUsed),
-        this->GetCachedNumberOfLocalParameters(),
-        // Need address of the lock
-        &this->m_MattesAssociate->m_JointPDFDerivativesLock,
-        this->m_MattesAssociate->m_JointPDFDerivatives
-        );
+      this->m_MattesAssociate->m_ThreaderJointPDFDerivatives.clear();
+      if( ( this->m_MattesAssociate->m_ThreaderDerivativeManager.size() != localNumberOfWorkUnitsUsed ) )
+        {
+        this->m_MattesAssociate->m_ThreaderDerivativeManager.resize(localNumberOfWorkUnitsUsed);
+        }
+      for( ThreadIdType threadId = 0; threadId < localNumberOfWorkUnitsUsed; ++threadId )
+        {
+        this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].Initialize(
+          // A heuristic that assumues memory for 2x size of
+          // m_JointPDFDerivati efficient and easy to make, so
+          // split it accross all the threads.  A work unit of at least 400 is needed
+          // when the thread size approaches the number of histograms so that the
+          // there is enough work to be done between thread lockings.
+          std::max<size_t>(500,
+          this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins / localNumberOfWorkUnitsUsed),
+          this->GetCachedNumberOfLocalParameters(),
+          // Need address of the lock
+          &this->m_MattesAssociate->m_JointPDFDerivativesLock,
+          this->m_MattesAssociate->m_JointPDFDerivatives
+          );
+        }
       }
     }
 }
@@ -247,7 +271,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
                 const MovingImagePixelType &       movingImageValue,
                 const MovingImageGradientType &    movingImageGradient,
                 MeasureType &,
-                DerivativeType &,
+                DerivativeType &                   localDerivativeReturn,
                 const ThreadIdType                 threadId) const
 {
   const bool doComputeDerivative = this->m_MattesAssociate->GetComputeDerivative();
@@ -328,6 +352,8 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   // Compute the transform Jacobian.
   using JacobianReferenceType = JacobianType &;
   JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobian;
+  const bool transformIsDisplacement = this->m_MattesAssociate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField;
+  PDFValueType * threaderJointPDFDerivativesPtr = nullptr;
   if( doComputeDerivative )
     {
     JacobianReferenceType jacobianPositional = this->m_GetValueAndDerivativePerThreadVariables[threadId].MovingTransformJacobianPositional;
@@ -335,11 +361,31 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       ComputeJacobianWithRespectToParametersCachedTemporaries(virtualPoint,
                                                               jacobian,
                                                               jacobianPositional);
+    if( !transformIsDisplacement )
+      {
+      // The inner products of the Jacobian with the moving image gradient
+      // are the same for the four Parzen window bins. Compute them once,
+      // in the local derivative that is not used otherwise by this metric.
+      for( NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement; ++mu )
+        {
+        PDFValueType innerProduct = 0.0;
+        for( SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim )
+          {
+          innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+          }
+        localDerivativeReturn[mu] = innerProduct;
+        }
+      if( this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives )
+        {
+        threaderJointPDFDerivativesPtr = ( threadId == 0 )
+          ? this->m_MattesAssociate->m_JointPDFDerivatives->GetBufferPointer()
+          : this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadId - 1].data();
+        }
+      }
     }
 
   SizeValueType movingParzenBin = 0;
 
-  const bool transformIsDisplacement = this->m_MattesAssociate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField;
   while( pdfMovingIndex <= pdfMovingIndexMax )
     {
     const auto val = static_cast<PDFValueType>(
@@ -374,21 +420,29 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
           ( fixedImageParzenWindowIndex  * this->m_MattesAssociate->m_JointPDFDerivatives->GetOffsetTable()[2] )
           + ( pdfMovingIndex * this->m_MattesAssociate->m_JointPDFDerivatives->GetOffsetTable()[1] );
 
-        PDFValueType * derivativeContributionPtr =
-          this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextElementAndAddOffset(ThisIndexOffset);
-        for( NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement;
-             ++mu )
+        const NumberOfParametersType numberOfLocalParameters = this->GetCachedNumberOfLocalParameters();
+        const DerivativeValueType * const innerProducts = localDerivativeReturn.data_block();
+        if( threaderJointPDFDerivativesPtr != nullptr )
           {
-          PDFValueType innerProduct = 0.0;
-          for( SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim )
+          // The four bins of this point are consecutive rows of the
+          // work unit's own joint PDF derivatives.
+          PDFValueType * const derivativeContributionPtr = threaderJointPDFDerivativesPtr + ThisIndexOffset;
+          for( NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu )
             {
-            innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+            derivativeContributionPtr[mu] += innerProducts[mu] * cubicBSplineDerivativeValue;
             }
-
-          *(derivativeContributionPtr) = innerProduct * cubicBSplineDerivativeValue;
-          ++derivativeContributionPtr;
           }
-        this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].CheckAndReduceIfNecessary();
+        else
+          {
+          PDFValueType * derivativeContributionPtr =
+            this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].GetNextElementAndAddOffset(ThisIndexOffset);
+          for( NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu )
+            {
+            *(derivativeContributionPtr) = innerProducts[mu] * cubicBSplineDerivativeValue;
+            ++derivativeContributionPtr;
+            }
+          this->m_MattesAssociate->m_ThreaderDerivativeManager[threadId].CheckAndReduceIfNecessary();
+          }
         }
       }
 
@@ -463,12 +517,27 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
 
     JointPDFDerivativesValueType *const accumulatorPdfDPtrStart =
       this->m_MattesAssociate->m_JointPDFDerivatives->GetBufferPointer();
-    JointPDFDerivativesValueType *             accumulatorPdfDPtr = accumulatorPdfDPtrStart;
-    JointPDFDerivativesValueType const * const tempThreadPdfDPtrEnd = accumulatorPdfDPtrStart
-      + histogramTotalElementsSize;
-    while( accumulatorPdfDPtr < tempThreadPdfDPtrEnd )
+    if( this->m_MattesAssociate->m_UseThreaderJointPDFDerivatives )
       {
-      *( accumulatorPdfDPtr++ ) *= nFactor;
+      // Sum the per work unit copies and scale in one parallel pass.
+      std::vector< PDFValueType * > threaderJointPDFDerivativesPtrs( 1, accumulatorPdfDPtrStart );
+      for( auto & threaderJointPDFDerivatives : this->m_MattesAssociate->m_ThreaderJointPDFDerivatives )
+        {
+        threaderJointPDFDerivativesPtrs.push_back( threaderJointPDFDerivatives.data() );
+        }
+      this->m_MattesAssociate->ReduceThreaderBuffers( threaderJointPDFDerivativesPtrs.data(),
+                                                      threaderJointPDFDerivativesPtrs.size(),
+                                                      histogramTotalElementsSize, nFactor );
+      }
+    else
+      {
+      JointPDFDerivativesValueType *             accumulatorPdfDPtr = accumulatorPdfDPtrStart;
+      JointPDFDerivativesValueType const * const tempThreadPdfDPtrEnd = accumulatorPdfDPtrStart
+        + histogramTotalElementsSize;
+      while( accumulatorPdfDPtr < tempThreadPdfDPtrEnd )
+        {
+        *( accumulatorPdfDPtr++ ) *= nFactor;
+        }
       }
     }
 
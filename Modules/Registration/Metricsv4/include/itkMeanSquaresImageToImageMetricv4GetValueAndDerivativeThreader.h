@@ -62,10 +62,18 @@ public:
   using DerivativeType = typename Superclass::DerivativeType;
   using DerivativeValueType = typename Superclass::DerivativeValueType;
   using NumberOfParametersType = typename Superclass::NumberOfParametersType;
+  using JacobianType = typename Superclass::JacobianType;
 
 protected:
   MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader() = default;
 
+  /** The derivative only uses the moving transform Jacobian through
+   * ComputeMovingTransformJacobian. */
+  bool SupportsSparseBSplineJacobian() const override
+  {
+    return true;
+  }
+
   /** This function computes the local voxel-wise contribution of
    *  the metric to the global integral of the metric/derivative.
    */
@@ -388,13 +388,18 @@ protected:
    * Warp the moving point set based on the moving transform.  Note that the
    * warped moving point set is of type FixedPointSetType since the transform
    * takes the points from the moving to the fixed domain.
+   * Unless the value and derivative are calculated in tangent space, the
+   * moving points are not transformed, so a change of the moving transform
+   * alone does not update them.
    * FIXME: needs update.
    */
   void TransformMovingPointSet() const;
 
   /**
    * Build point locators for the fixed and moving point sets to speed up
-   * derivative and value calculations.
+   * derivative and value calculations.  When only the transforms changed
+   * since the last call, the locators are updated with the new point
+   * locations instead of being rebuilt.
    */
   void InitializePointsLocators() const;
 
@@ -417,6 +422,11 @@ private:
   mutable bool m_MovingTransformPointLocatorsNeedInitialization;
   mutable bool m_FixedTransformPointLocatorsNeedInitialization;
 
+  // Flags to keep track of whether the transformed point sets were updated in
+  // place, with the same points, so that their locators can be refitted.
+  mutable bool m_MovingTransformPointLocatorsCanBeUpdated;
+  mutable bool m_FixedTransformPointLocatorsCanBeUpdated;
+
   // Flag to keep track of whether a warning has already been issued
   // regarding the number of valid points.
   mutable bool m_HaveWarnedAboutNumberOfValidPoints;
@@ -42,6 +42,8 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 
   this->m_MovingTransformPointLocatorsNeedInitialization = false;
   this->m_FixedTransformPointLocatorsNeedInitialization = false;
+  this->m_MovingTransformPointLocatorsCanBeUpdated = false;
+  this->m_FixedTransformPointLocatorsCanBeUpdated = false;
 
   this->m_MovingTransformedPointSetTime = this->GetMTime();
   this->m_FixedTransformedPointSetTime = this->GetMTime();
@@ -433,11 +435,20 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 {
   // Transform the moving point set with the moving transform.
   // We calculate the value and derivatives in the moving space.
-  if( ( this->GetMTime() > this->m_MovingTransformedPointSetTime ) || ( this->m_MovingTransform->GetMTime() > this->GetMTime() ) || !this->m_MovingTransformedPointSet )
+  const bool movingPointSetIsCurrent = ( this->GetMTime() <= this->m_MovingTransformedPointSetTime ) &&
+    this->m_MovingTransformedPointSet &&
+    this->m_MovingTransformedPointSet->GetNumberOfPoints() == this->m_MovingPointSet->GetNumberOfPoints();
+  if( !movingPointSetIsCurrent ||
+      ( this->m_CalculateValueAndDerivativeInTangentSpace && this->m_MovingTransform->GetMTime() > this->GetMTime() ) )
     {
     this->m_MovingTransformPointLocatorsNeedInitialization = true;
-    this->m_MovingTransformedPointSet = MovingTransformedPointSetType::New();
-    this->m_MovingTransformedPointSet->Initialize();
+    // Only the transform changed: overwrite the points in place.
+    this->m_MovingTransformPointLocatorsCanBeUpdated = movingPointSetIsCurrent;
+    if( !movingPointSetIsCurrent )
+      {
+      this->m_MovingTransformedPointSet = MovingTransformedPointSetType::New();
+      this->m_MovingTransformedPointSet->Initialize();
+      }
 
     typename MovingTransformType::InverseTransformBasePointer inverseTransform =
       this->m_MovingTransform->GetInverseTransform();
@@ -467,17 +478,23 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 ::TransformFixedAndCreateVirtualPointSet() const
 {
   // Transform the fixed point set through the virtual domain, and into the moving domain
-  if( ( this->GetMTime() > this->m_FixedTransformedPointSetTime )
+  const bool fixedPointSetIsCurrent = ( this->GetMTime() <= this->m_FixedTransformedPointSetTime ) &&
+    this->m_FixedTransformedPointSet && this->m_VirtualTransformedPointSet &&
+    this->m_FixedTransformedPointSet->GetNumberOfPoints() == this->m_FixedPointSet->GetNumberOfPoints();
+  if( !fixedPointSetIsCurrent
       || ( this->m_FixedTransform->GetMTime() > this->GetMTime() )
-      || ! this->m_FixedTransformedPointSet
-      || ! this->m_VirtualTransformedPointSet
       || ( this->m_MovingTransform->GetMTime() > this->GetMTime() ) )
     {
     this->m_FixedTransformPointLocatorsNeedInitialization = true;
-    this->m_FixedTransformedPointSet = FixedTransformedPointSetType::New();
-    this->m_FixedTransformedPointSet->Initialize();
-    this->m_VirtualTransformedPointSet = VirtualPointSetType::New();
-    this->m_VirtualTransformedPointSet->Initialize();
+    // Only the transforms changed: overwrite the points in place.
+    this->m_FixedTransformPointLocatorsCanBeUpdated = fixedPointSetIsCurrent;
+    if( !fixedPointSetIsCurrent )
+      {
+      this->m_FixedTransformedPointSet = FixedTransformedPointSetType::New();
+      this->m_FixedTransformedPointSet->Initialize();
+      this->m_VirtualTransformedPointSet = VirtualPointSetType::New();
+      this->m_VirtualTransformedPointSet->Initialize();
+      }
 
     typename FixedTransformType::InverseTransformBasePointer inverseTransform = this->m_FixedTransform->GetInverseTransform();
 
@@ -531,8 +548,17 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
       {
       this->m_FixedTransformedPointsLocator = PointsLocatorType::New();
       }
-    this->m_FixedTransformedPointsLocator->SetPoints( this->m_FixedTransformedPointSet->GetPoints() );
-    this->m_FixedTransformedPointsLocator->Initialize();
+    if( this->m_FixedTransformPointLocatorsCanBeUpdated &&
+        this->m_FixedTransformedPointsLocator->GetPoints() == this->m_FixedTransformedPointSet->GetPoints() )
+      {
+      this->m_FixedTransformedPointsLocator->UpdatePointLocations();
+      }
+    else
+      {
+      this->m_FixedTransformedPointsLocator->SetPoints( this->m_FixedTransformedPointSet->GetPoints() );
+      this->m_FixedTransformedPointsLocator->Initialize();
+      }
+    this->m_FixedTransformPointLocatorsNeedInitialization = false;
     }
 
   if( this->m_MovingTransformPointLocatorsNeedInitialization )
@@ -545,8 +571,17 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
       {
       this->m_MovingTransformedPointsLocator = PointsLocatorType::New();
       }
-    this->m_MovingTransformedPointsLocator->SetPoints( this->m_MovingTransformedPointSet->GetPoints() );
-    this->m_MovingTransformedPointsLocator->Initialize();
+    if( this->m_MovingTransformPointLocatorsCanBeUpdated &&
+        this->m_MovingTransformedPointsLocator->GetPoints() == this->m_MovingTransformedPointSet->GetPoints() )
+      {
+      this->m_MovingTransformedPointsLocator->UpdatePointLocations();
+      }
+    else
+      {
+      this->m_MovingTransformedPointsLocator->SetPoints( this->m_MovingTransformedPointSet->GetPoints() );
+      this->m_MovingTransformedPointsLocator->Initialize();
+      }
+    this->m_MovingTransformPointLocatorsNeedInitialization = false;
     }
 }
 
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkJointHistogramMutualInformationImageToImageMetricv4.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkIdentityTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkImageToImageMetricv4TestImage.h"
+#include "itkMath.h"
+
+/* Verify that the v4 metrics that evaluate a cubic B-spline moving transform
+ * with sparse Jacobians give the same value and derivative as the dense
+ * per-point Jacobian evaluation. The dense path is forced by wrapping the
+ * B-spline transform in a CompositeTransform behind a fixed identity
+ * transform. Both the dense-region and the sampled point set paths are
+ * checked. */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image< double, Dimension >;
+using BSplineTransformType = itk::BSplineTransform< double, Dimension, 3 >;
+using CompositeTransformType = itk::CompositeTransform< double, Dimension >;
+
+BSplineTransformType::Pointer
+CreateBSplineTransform( const ImageType * image )
+{
+  BSplineTransformType::Pointer transform = BSplineTransformType::New();
+
+  BSplineTransformType::PhysicalDimensionsType physicalDimensions;
+  BSplineTransformType::MeshSizeType meshSize;
+  for( unsigned int d = 0; d < Dimension; ++d )
+    {
+    physicalDimensions[d] = image->GetSpacing()[d] * ( image->GetLargestPossibleRegion().GetSize()[d] - 1 );
+    }
+  meshSize[0] = 5;
+  meshSize[1] = 4;
+  transform->SetTransformDomainOrigin( image->GetOrigin() );
+  transform->SetTransformDomainPhysicalDimensions( physicalDimensions );
+  transform->SetTransformDomainMeshSize( meshSize );
+  transform->SetTransformDomainDirection( image->GetDirection() );
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+  BSplineTransformType::ParametersType parameters( transform->GetNumberOfParameters() );
+  for( unsigned int p = 0; p < parameters.Size(); ++p )
+    {
+    parameters[p] = generator->GetUniformVariate( -1.5, 1.5 );
+    }
+  transform->SetParameters( parameters );
+  return transform;
+}
+
+template< typename TMetric >
+bool
+CompareSparseAndDense( const char * name, bool useSampledPointSet )
+{
+  ImageType::Pointer fixedImage = CreateImageToImageMetricv4TestImage< ImageType >( 37, 0.75, -2.0, 0.0 );
+  ImageType::Pointer movingImage = CreateImageToImageMetricv4TestImage< ImageType >( 37, 0.75, -2.0, 1.3 );
+
+  BSplineTransformType::Pointer bsplineTransform = CreateBSplineTransform( fixedImage );
+
+  /* A composite with a single optimized B-spline transform uses the
+   * sparse path as well, adding a fixed identity forces the dense one. */
+  using IdentityTransformType = itk::IdentityTransform< double, Dimension >;
+  CompositeTransformType::Pointer denseTransform = CompositeTransformType::New();
+  denseTransform->AddTransform( IdentityTransformType::New() );
+  denseTransform->AddTransform( bsplineTransform );
+  denseTransform->SetOnlyMostRecentTransformToOptimizeOn();
+
+  typename TMetric::MeasureType values[2];
+  typename TMetric::DerivativeType derivatives[2];
+  for( unsigned int dense = 0; dense < 2; ++dense )
+    {
+    typename TMetric::Pointer metric = TMetric::New();
+    metric->SetFixedImage( fixedImage );
+    metric->SetMovingImage( movingImage );
+    if( dense )
+      {
+      metric->SetMovingTransform( denseTransform );
+      }
+    else
+      {
+      metric->SetMovingTransform( bsplineTransform );
+      }
+    if( useSampledPointSet )
+      {
+      using PointSetType = typename TMetric::FixedSampledPointSetType;
+      typename PointSetType::Pointer pointSet = PointSetType::New();
+      typename PointSetType::PointIdentifier id = 0;
+      itk::ImageRegionConstIteratorWithIndex< ImageType > it( fixedImage, fixedImage->GetLargestPossibleRegion() );
+      unsigned int count = 0;
+      for( it.GoToBegin(); !it.IsAtEnd(); ++it, ++count )
+        {
+        if( count % 3 == 0 )
+          {
+          typename PointSetType::PointType point;
+          fixedImage->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+          pointSet->SetPoint( id++, point );
+          }
+        }
+      metric->SetFixedSampledPointSet( pointSet );
+      metric->SetUseSampledPointSet( true );
+      }
+    metric->Initialize();
+    metric->GetValueAndDerivative( values[dense], derivatives[dense] );
+    }
+
+  if( derivatives[0].Size() != bsplineTransform->GetNumberOfParameters()
+      || derivatives[1].Size() != derivatives[0].Size() )
+    {
+    std::cerr << name << ": unexpected derivative size " << derivatives[0].Size()
+              << " and " << derivatives[1].Size() << std::endl;
+    return false;
+    }
+
+  const double tolerance = 1e-10;
+  bool passed = true;
+  if( std::abs( values[0] - values[1] ) > tolerance * std::max( 1.0, std::abs( values[1] ) ) )
+    {
+    std::cerr << name << ": sparse value " << values[0] << " != dense value " << values[1] << std::endl;
+    passed = false;
+    }
+  double maximumDerivative = 0.0;
+  for( unsigned int p = 0; p < derivatives[1].Size(); ++p )
+    {
+    maximumDerivative = std::max( maximumDerivative, std::abs( derivatives[1][p] ) );
+    }
+  if( maximumDerivative == 0.0 )
+    {
+    std::cerr << name << ": dense derivative is zero" << std::endl;
+    passed = false;
+    }
+  for( unsigned int p = 0; p < derivatives[1].Size(); ++p )
+    {
+    if( std::abs( derivatives[0][p] - derivatives[1][p] ) > tolerance * maximumDerivative )
+      {
+      std::cerr << name << ": derivative[" << p << "] sparse " << derivatives[0][p]
+                << " != dense " << derivatives[1][p] << std::endl;
+      passed = false;
+      }
+    }
+  std::cout << name << ( useSampledPointSet ? " (sampled)" : " (dense region)" )
+            << ( passed ? " passed" : " FAILED" ) << std::endl;
+  return passed;
+}
+
+} // end anonymous namespace
+
+int itkImageToImageMetricv4BSplineSparseJacobianTest( int, char * [] )
+{
+  using MeanSquaresMetricType = itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType >;
+  using JointHistogramMetricType = itk::JointHistogramMutualInformationImageToImageMetricv4< ImageType, ImageType >;
+
+  bool passed = true;
+  for( unsigned int sampled = 0; sampled < 2; ++sampled )
+    {
+    passed &= CompareSparseAndDense< MeanSquaresMetricType >( "MeanSquares", sampled != 0 );
+    passed &= CompareSparseAndDense< JointHistogramMetricType >( "JointHistogramMutualInformation", sampled != 0 );
+    }
+
+  if( !passed )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkTranslationTransform.h"
+#include "itkImageMaskSpatialObject.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageToImageMetricv4TestImage.h"
+
+/* Verify that the v4 metrics give the same value and derivative with and
+ * without the fixed image sample cache, that the cache is used between
+ * Initialize() calls, and that it is ignored once the fixed transform is
+ * modified. */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image< double, Dimension >;
+using MaskType = itk::ImageMaskSpatialObject< Dimension >;
+using AffineTransformType = itk::AffineTransform< double, Dimension >;
+using TranslationTransformType = itk::TranslationTransform< double, Dimension >;
+
+bool
+Compare( const char * name, const char * step,
+         double value, const itk::Array< double > & derivative,
+         double referenceValue, const itk::Array< double > & referenceDerivative )
+{
+  const double tolerance = 1e-10;
+  bool passed = std::abs( value - referenceValue ) <= tolerance * std::max( 1.0, std::abs( referenceValue ) );
+  for( unsigned int p = 0; p < referenceDerivative.Size(); ++p )
+    {
+    passed = passed && std::abs( derivative[p] - referenceDerivative[p] )
+                       <= tolerance * std::max( 1.0, std::abs( referenceDerivative[p] ) );
+    }
+  if( !passed )
+    {
+    std::cerr << name << ", " << step << ": cached value " << value << " derivative " << derivative
+              << " != reference value " << referenceValue << " derivative " << referenceDerivative << std::endl;
+    }
+  return passed;
+}
+
+template< typename TMetric >
+bool
+TestFixedImageSampleCache( const char * name, typename TMetric::GradientSourceType gradientSource )
+{
+  ImageType::Pointer fixedImage = CreateImageToImageMetricv4TestImage< ImageType >( 40, 0.8, 0.0, 0.0 );
+  ImageType::Pointer movingImage = CreateImageToImageMetricv4TestImage< ImageType >( 40, 0.8, 0.0, 1.3 );
+
+  // Part of the sampled points fall outside of the mask.
+  MaskType::ImageType::Pointer maskImage = MaskType::ImageType::New();
+  maskImage->CopyInformation( fixedImage );
+  maskImage->SetRegions( fixedImage->GetLargestPossibleRegion() );
+  maskImage->Allocate();
+  itk::ImageRegionIteratorWithIndex< MaskType::ImageType > maskIt( maskImage, maskImage->GetLargestPossibleRegion() );
+  for( maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt )
+    {
+    maskIt.Set( maskIt.GetIndex()[1] < 32 ? 1 : 0 );
+    }
+  MaskType::Pointer mask = MaskType::New();
+  mask->SetImage( maskImage );
+
+  using PointSetType = typename TMetric::FixedSampledPointSetType;
+  typename PointSetType::Pointer pointSet = PointSetType::New();
+  typename PointSetType::PointIdentifier id = 0;
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( fixedImage, fixedImage->GetLargestPossibleRegion() );
+  unsigned int count = 0;
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it, ++count )
+    {
+    if( count % 3 == 0 )
+      {
+      typename PointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+      pointSet->SetPoint( id++, point );
+      }
+    }
+
+  // The reference metric evaluates the fixed image at each call.
+  typename TMetric::Pointer metrics[2];
+  AffineTransformType::Pointer movingTransforms[2];
+  TranslationTransformType::Pointer fixedTransforms[2];
+  for( unsigned int cached = 0; cached < 2; ++cached )
+    {
+    movingTransforms[cached] = AffineTransformType::New();
+    movingTransforms[cached]->SetIdentity();
+    fixedTransforms[cached] = TranslationTransformType::New();
+    TranslationTransformType::OutputVectorType translation;
+    translation[0] = 0.3;
+    translation[1] = -0.2;
+    fixedTransforms[cached]->Translate( translation );
+
+    metrics[cached] = TMetric::New();
+    metrics[cached]->SetFixedImage( fixedImage );
+    metrics[cached]->SetMovingImage( movingImage );
+    metrics[cached]->SetFixedTransform( fixedTransforms[cached] );
+    metrics[cached]->SetMovingTransform( movingTransforms[cached] );
+    metrics[cached]->SetFixedImageMask( mask );
+    metrics[cached]->SetGradientSource( gradientSource );
+    metrics[cached]->SetUseFixedImageGradientFilter( false );
+    metrics[cached]->SetUseMovingImageGradientFilter( false );
+    metrics[cached]->SetFixedSampledPointSet( pointSet );
+    metrics[cached]->SetUseSampledPointSet( true );
+    metrics[cached]->SetUseFixedImageSampleCache( cached == 1 );
+    metrics[cached]->Initialize();
+    }
+
+  typename TMetric::MeasureType values[2];
+  typename TMetric::DerivativeType derivatives[2];
+  auto evaluate = [&]()
+    {
+    for( unsigned int cached = 0; cached < 2; ++cached )
+      {
+      metrics[cached]->GetValueAndDerivative( values[cached], derivatives[cached] );
+      }
+    };
+
+  bool passed = true;
+  evaluate();
+  passed &= Compare( name, "first evaluation", values[1], derivatives[1], values[0], derivatives[0] );
+
+  // The cache does not depend on the moving transform.
+  AffineTransformType::ParametersType parameters = movingTransforms[0]->GetParameters();
+  parameters[0] = 1.05;
+  parameters[3] = 0.97;
+  parameters[4] = 0.4;
+  parameters[5] = -0.3;
+  movingTransforms[0]->SetParameters( parameters );
+  movingTransforms[1]->SetParameters( parameters );
+  evaluate();
+  passed &= Compare( name, "moving transform update", values[1], derivatives[1], values[0], derivatives[0] );
+
+  // A modified fixed transform makes the cache stale.
+  TranslationTransformType::OutputVectorType translation;
+  translation[0] = -0.5;
+  translation[1] = 0.25;
+  fixedTransforms[0]->Translate( translation );
+  fixedTransforms[1]->Translate( translation );
+  evaluate();
+  passed &= Compare( name, "fixed transform update", values[1], derivatives[1], values[0], derivatives[0] );
+
+  // Once computed again, the cache holds the fixed image values: changing the
+  // pixels without modifying the image only affects the reference metric.
+  metrics[0]->Initialize();
+  metrics[1]->Initialize();
+  evaluate();
+  passed &= Compare( name, "second initialization", values[1], derivatives[1], values[0], derivatives[0] );
+  const typename TMetric::MeasureType cachedValue = values[1];
+  const typename TMetric::DerivativeType cachedDerivative = derivatives[1];
+  itk::ImageRegionIteratorWithIndex< ImageType > fixedIt( fixedImage, fixedImage->GetLargestPossibleRegion() );
+  for( fixedIt.GoToBegin(); !fixedIt.IsAtEnd(); ++fixedIt )
+    {
+    fixedIt.Set( fixedIt.Get() + 5.0 * std::cos( 0.7 * fixedIt.GetIndex()[0] ) );
+    }
+  evaluate();
+  passed &= Compare( name, "unmodified fixed image", values[1], derivatives[1], cachedValue, cachedDerivative );
+  if( std::abs( values[0] - cachedValue ) <= 1e-6 * std::abs( cachedValue ) )
+    {
+    std::cerr << name << ": the reference metric did not see the new fixed image values" << std::endl;
+    passed = false;
+    }
+
+  std::cout << name << ( passed ? " passed" : " FAILED" ) << std::endl;
+  return passed;
+}
+
+} // end anonymous namespace
+
+int itkImageToImageMetricv4FixedImageSampleCacheTest( int, char * [] )
+{
+  using MeanSquaresMetricType = itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType >;
+  using CorrelationMetricType = itk::CorrelationImageToImageMetricv4< ImageType, ImageType >;
+  using MattesMetricType = itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType >;
+
+  bool passed = true;
+  passed &= TestFixedImageSampleCache< MeanSquaresMetricType >( "MeanSquares", MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  passed &= TestFixedImageSampleCache< CorrelationMetricType >( "Correlation", CorrelationMetricType::GRADIENT_SOURCE_BOTH );
+  // Mattes only supports moving image gradients.
+  passed &= TestFixedImageSampleCache< MattesMetricType >( "MattesMutualInformation", MattesMetricType::GRADIENT_SOURCE_MOVING );
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,62 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkImageToImageMetricv4TestImage_h
+#define itkImageToImageMetricv4TestImage_h
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+
+/* Square 2D test image of the v4 metrics: a Gaussian blob on a sinusoidal
+ * background, with a smooth but not symmetric intensity. The pattern is
+ * defined relative to the physical extent of the image and moved by
+ * ( shift, -shift / 2 ) in physical units. */
+template< typename TImage >
+typename TImage::Pointer
+CreateImageToImageMetricv4TestImage( itk::SizeValueType size, double spacing, double origin, double shift )
+{
+  using ImageType = TImage;
+
+  typename ImageType::SizeType imageSize;
+  imageSize.Fill( size );
+  typename ImageType::SpacingType imageSpacing;
+  imageSpacing.Fill( spacing );
+  typename ImageType::PointType imageOrigin;
+  imageOrigin.Fill( origin );
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions( imageSize );
+  image->SetSpacing( imageSpacing );
+  image->SetOrigin( imageOrigin );
+  image->Allocate();
+
+  const double extent = spacing * static_cast< double >( size );
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    typename ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+    const double x = ( point[0] - origin - shift ) / extent;
+    const double y = ( point[1] - origin + 0.5 * shift ) / extent;
+    it.Set( 100.0 * std::exp( -( x - 0.5 ) * ( x - 0.5 ) / 0.035 - ( y - 0.42 ) * ( y - 0.42 ) / 0.05 )
+            + 20.0 * std::sin( 10.0 * x ) * std::cos( 7.0 * y ) );
+    }
+  return image;
+}
+
+#endif
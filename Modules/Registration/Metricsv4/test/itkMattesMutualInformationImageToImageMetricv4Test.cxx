@@ -31,6 +31,29 @@
  * This test was copied for v4 metric from itkMattesMutualInformationImageToMetricTest
  */
 
+namespace
+{
+// A derived metric must opt in to cloning, since the clone would only
+// have the settings of its superclass.
+template< typename TFixedImage, typename TMovingImage >
+class DerivedMattesMetric :
+  public itk::MattesMutualInformationImageToImageMetricv4< TFixedImage, TMovingImage >
+{
+public:
+  using Self = DerivedMattesMetric;
+  using Superclass = itk::MattesMutualInformationImageToImageMetricv4< TFixedImage, TMovingImage >;
+  using Pointer = itk::SmartPointer< Self >;
+  using ConstPointer = itk::SmartPointer< const Self >;
+
+  itkNewMacro( Self );
+  itkTypeMacro( DerivedMattesMetric, MattesMutualInformationImageToImageMetricv4 );
+
+protected:
+  DerivedMattesMetric() = default;
+  ~DerivedMattesMetric() override = default;
+};
+}
+
 /**
  * TODO: check this text:
  *
@@ -334,6 +357,42 @@ int TestMattesMetricWithAffineTransform(
 
   std::cout << "NumberOfValidPoints: " << metric->GetNumberOfValidPoints() << " of " << metric->GetVirtualRegion().GetNumberOfPixels() << std::endl;
 
+//---------------------------------------------------------
+// A clone must evaluate like the original metric while owning
+// its own copy of the moving transform.
+//---------------------------------------------------------
+  if( !metric->SupportsCloning() )
+    {
+    std::cout << "[FAILED] the metric does not support cloning." << std::endl;
+    testFailed = true;
+    }
+  typename MetricType::Pointer clonedMetric = metric->Clone();
+  clonedMetric->Initialize();
+  if( clonedMetric->GetMovingTransform() == metric->GetMovingTransform()
+    || clonedMetric->GetNumberOfHistogramBins() != metric->GetNumberOfHistogramBins() )
+    {
+    std::cout << "[FAILED] the cloned metric is not configured like the original." << std::endl;
+    testFailed = true;
+    }
+  typename MetricType::MeasureType clonedValue;
+  typename MetricType::DerivativeType clonedDerivative( numberOfParameters );
+  metric->GetValueAndDerivative( metricValueWithDerivative, derivative );
+  clonedMetric->GetValueAndDerivative( clonedValue, clonedDerivative );
+  if( ! itk::Math::FloatAlmostEqual( metricValueWithDerivative, clonedValue, 8 ) )
+    {
+    std::cout << "[FAILED] the cloned metric value differs: " << clonedValue
+              << " != " << metricValueWithDerivative << std::endl;
+    testFailed = true;
+    }
+  parameters[4] = 5;
+  clonedMetric->SetParameters( parameters );
+  if( itk::Math::NotExactlyEquals( metric->GetParameters()[4], transformer->GetParameters()[4] )
+    || itk::Math::NotExactlyEquals( clonedMetric->GetParameters()[4], 5.0 ) )
+    {
+    std::cout << "[FAILED] the cloned metric shares the moving transform parameters." << std::endl;
+    testFailed = true;
+    }
+
 //---------------------------------------------------------
 // Check output gradients for numerical accuracy
 //---------------------------------------------------------
@@ -467,6 +526,12 @@ int itkMattesMutualInformationImageToImageMetricv4Test(int, char *[] )
     return EXIT_FAILURE;
     }
 
+  if ( DerivedMattesMetric< ImageType, ImageType >::New()->SupportsCloning() )
+    {
+    std::cout << "Test failed - a derived metric supports cloning without opting in" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   std::cout << "Test passed" << std::endl;
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkImageToImageMetricv4TestImage.h"
+#include "itkMath.h"
+
+/* Verify that the Mattes metric value and derivative do not depend on the
+ * number of work units, both when every work unit accumulates its own joint
+ * PDF derivatives and when the derivative buffer managers are used (more
+ * histogram bins), for an affine and a B-spline transform. */
+
+namespace
+{
+
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image< double, Dimension >;
+
+bool
+CompareWorkUnits( const char * name, itk::Transform< double, Dimension, Dimension > * transform,
+                  unsigned int numberOfHistogramBins )
+{
+  using MetricType = itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType >;
+
+  ImageType::Pointer fixedImage = CreateImageToImageMetricv4TestImage< ImageType >( 48, 1.0, 0.0, 0.0 );
+  ImageType::Pointer movingImage = CreateImageToImageMetricv4TestImage< ImageType >( 48, 1.0, 0.0, 1.7 );
+
+  // The number of work units of the metric threaders follows the global
+  // default number of threads at construction.
+  const itk::ThreadIdType defaultNumberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 3 };
+  itk::ThreadIdType workUnits[2];
+  MetricType::MeasureType values[2];
+  MetricType::DerivativeType derivatives[2];
+  for( unsigned int n = 0; n < 2; ++n )
+    {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( numberOfThreads[n] );
+    MetricType::Pointer metric = MetricType::New();
+    metric->SetFixedImage( fixedImage );
+    metric->SetMovingImage( movingImage );
+    metric->SetMovingTransform( transform );
+    metric->SetNumberOfHistogramBins( numberOfHistogramBins );
+    metric->Initialize();
+    metric->GetValueAndDerivative( values[n], derivatives[n] );
+    workUnits[n] = metric->GetNumberOfWorkUnitsUsed();
+    }
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( defaultNumberOfThreads );
+
+  if( workUnits[0] == workUnits[1] )
+    {
+    std::cerr << name << ": both evaluations used " << workUnits[0] << " work units" << std::endl;
+    return false;
+    }
+
+  bool passed = true;
+  const double tolerance = 1e-10;
+  if( std::abs( values[0] - values[1] ) > tolerance * std::abs( values[0] ) )
+    {
+    std::cerr << name << ": value " << values[1] << " with " << workUnits[1] << " work units != "
+              << values[0] << " with " << workUnits[0] << std::endl;
+    passed = false;
+    }
+  double maximumDerivative = 0.0;
+  for( unsigned int p = 0; p < derivatives[0].Size(); ++p )
+    {
+    maximumDerivative = std::max( maximumDerivative, std::abs( derivatives[0][p] ) );
+    }
+  if( maximumDerivative == 0.0 || derivatives[1].Size() != derivatives[0].Size() )
+    {
+    std::cerr << name << ": unexpected derivative" << std::endl;
+    return false;
+    }
+  for( unsigned int p = 0; p < derivatives[0].Size(); ++p )
+    {
+    if( std::abs( derivatives[0][p] - derivatives[1][p] ) > tolerance * maximumDerivative )
+      {
+      std::cerr << name << ": derivative[" << p << "] " << derivatives[1][p] << " with " << workUnits[1]
+                << " work units != " << derivatives[0][p] << " with " << workUnits[0] << std::endl;
+      passed = false;
+      }
+    }
+  std::cout << name << " with " << numberOfHistogramBins << " bins" << ( passed ? " passed" : " FAILED" ) << std::endl;
+  return passed;
+}
+
+} // end anonymous namespace
+
+int itkMattesMutualInformationImageToImageMetricv4ThreadingTest( int, char * [] )
+{
+  using AffineTransformType = itk::AffineTransform< double, Dimension >;
+  AffineTransformType::Pointer affineTransform = AffineTransformType::New();
+  AffineTransformType::OutputVectorType translation;
+  translation[0] = 0.8;
+  translation[1] = -0.4;
+  affineTransform->Translate( translation );
+  affineTransform->Rotate2D( 0.05 );
+
+  using BSplineTransformType = itk::BSplineTransform< double, Dimension, 3 >;
+  BSplineTransformType::Pointer bsplineTransform = BSplineTransformType::New();
+  BSplineTransformType::PhysicalDimensionsType physicalDimensions;
+  physicalDimensions.Fill( 47.0 );
+  BSplineTransformType::MeshSizeType meshSize;
+  meshSize.Fill( 4 );
+  bsplineTransform->SetTransformDomainPhysicalDimensions( physicalDimensions );
+  bsplineTransform->SetTransformDomainMeshSize( meshSize );
+  BSplineTransformType::ParametersType parameters( bsplineTransform->GetNumberOfParameters() );
+  for( unsigned int p = 0; p < parameters.Size(); ++p )
+    {
+    parameters[p] = 0.7 * std::sin( 1.3 * p );
+    }
+  bsplineTransform->SetParameters( parameters );
+
+  bool passed = true;
+  // 50 bins use per work unit joint PDF derivatives, 80 bins the buffer managers.
+  const unsigned int numberOfHistogramBins[2] = { 50, 80 };
+  for( unsigned int bins : numberOfHistogramBins )
+    {
+    passed &= CompareWorkUnits( "AffineTransform", affineTransform, bins );
+    passed &= CompareWorkUnits( "BSplineTransform", bsplineTransform, bins );
+    }
+
+  if( !passed )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -198,6 +198,19 @@ public:
   itkSetMacro(MaximumKernelWidth, unsigned int);
   itkGetConstMacro(MaximumKernelWidth, unsigned int);
 
+  /** Set/Get whether the displacement and update fields are smoothed
+   * in place with a recursive (IIR) Gaussian instead of a truncated
+   * GaussianOperator. The recursive filter has a cost independent of
+   * the standard deviation and does not allocate a temporary field at
+   * each iteration, at the price of a slightly different approximation
+   * of the Gaussian near the field boundaries. MaximumError and
+   * MaximumKernelWidth are ignored in this mode. Fields with fewer than
+   * four pixels along a smoothed dimension fall back to the
+   * GaussianOperator. Default is off. */
+  itkSetMacro(UseRecursiveGaussianSmoothing, bool);
+  itkGetConstMacro(UseRecursiveGaussianSmoothing, bool);
+  itkBooleanMacro(UseRecursiveGaussianSmoothing);
+
 protected:
   PDEDeformableRegistrationFilter();
   ~PDEDeformableRegistrationFilter() override = default;
@@ -233,6 +246,14 @@ protected:
    * UpdateFieldStandardDeviations. */
   virtual void SmoothUpdateField();
 
+  /** Smooth a field in place with a separable recursive Gaussian. The
+   * standard deviations are given in pixel units; dimensions with a
+   * non-positive standard deviation are left untouched. Returns false,
+   * without modifying the field, if a smoothed dimension is too short
+   * for the recursive filter. */
+  bool SmoothFieldWithRecursiveGaussian(DisplacementFieldType *field,
+                                        const StandardDeviationsType & standardDeviations);
+
   /** This method is called after the solution has been generated. In this case,
    * the filter release the memory of the internal buffers. */
   void PostProcessOutput() override;
@@ -274,6 +295,9 @@ private:
   /** Limits of Gaussian kernel width. */
   unsigned int m_MaximumKernelWidth;
 
+  /** Use an in-place recursive Gaussian to smooth the fields. */
+  bool m_UseRecursiveGaussianSmoothing;
+
   /** Flag to indicate user stop registration request. */
   bool m_StopRegistrationFlag;
 };
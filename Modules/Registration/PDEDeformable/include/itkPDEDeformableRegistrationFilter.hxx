@@ -26,6 +26,7 @@
 
 #include "itkGaussianOperator.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkRecursiveGaussianImageFilter.h"
 
 #include "itkMath.h"
 #include "itkMath.h"
@@ -62,6 +63,7 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
   m_TempField = DisplacementFieldType::New();
   m_MaximumError = 0.1;
   m_MaximumKernelWidth = 30;
+  m_UseRecursiveGaussianSmoothing = false;
   m_StopRegistrationFlag = false;
 
   m_SmoothDisplacementField = true;
@@ -180,6 +182,8 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
   os << m_MaximumError << std::endl;
   os << indent << "MaximumKernelWidth: ";
   os << m_MaximumKernelWidth << std::endl;
+  os << indent << "UseRecursiveGaussianSmoothing: ";
+  os << m_UseRecursiveGaussianSmoothing << std::endl;
 }
 
 /*
@@ -347,6 +351,12 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 {
   DisplacementFieldPointer field = this->GetOutput();
 
+  if ( m_UseRecursiveGaussianSmoothing
+       && this->SmoothFieldWithRecursiveGaussian(field, m_StandardDeviations) )
+    {
+    return;
+    }
+
   // copy field to TempField
   m_TempField->SetOrigin( field->GetOrigin() );
   m_TempField->SetSpacing( field->GetSpacing() );
@@ -417,6 +427,12 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
   // The update buffer will be overwritten with new data.
   DisplacementFieldPointer field = this->GetUpdateBuffer();
 
+  if ( m_UseRecursiveGaussianSmoothing
+       && this->SmoothFieldWithRecursiveGaussian(field, m_UpdateFieldStandardDeviations) )
+    {
+    return;
+    }
+
   using VectorType = typename DisplacementFieldType::PixelType;
   using ScalarType = typename VectorType::ValueType;
   using OperatorType = GaussianOperator< ScalarType, ImageDimension >;
@@ -464,6 +480,74 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
                                    ->GetLargestPossibleRegion() );
   field->CopyInformation( smoothers[ImageDimension - 1]->GetOutput() );
 }
+
+/*
+ * Smooth a field in place using a separable recursive Gaussian
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+bool
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SmoothFieldWithRecursiveGaussian(DisplacementFieldType *field,
+                                   const StandardDeviationsType & standardDeviations)
+{
+  using SmootherType = RecursiveGaussianImageFilter< DisplacementFieldType, DisplacementFieldType >;
+
+  const typename DisplacementFieldType::RegionType region = field->GetBufferedRegion();
+
+  for ( unsigned int j = 0; j < ImageDimension; j++ )
+    {
+    if ( standardDeviations[j] > 0.0 && region.GetSize(j) < 4 )
+      {
+      return false;
+      }
+    }
+
+  // The smoothers run in place on an image sharing the pixel container
+  // of the field, so that the result is written directly into the
+  // field buffer and the field itself stays out of the mini-pipeline.
+  DisplacementFieldPointer shared = DisplacementFieldType::New();
+  shared->Graft(field);
+  shared->SetLargestPossibleRegion(region);
+  shared->SetRequestedRegion(region);
+
+  typename SmootherType::Pointer smoothers[ImageDimension];
+  DisplacementFieldType *        input = shared;
+  typename SmootherType::Pointer last;
+
+  for ( unsigned int j = 0; j < ImageDimension; j++ )
+    {
+    if ( !( standardDeviations[j] > 0.0 ) )
+      {
+      continue;
+      }
+    smoothers[j] = SmootherType::New();
+    smoothers[j]->SetDirection(j);
+    // the standard deviations are specified in pixel units
+    smoothers[j]->SetSigma( standardDeviations[j] * field->GetSpacing()[j] );
+    smoothers[j]->SetOrder(SmootherType::ZeroOrder);
+    smoothers[j]->SetNormalizeAcrossScale(false);
+    smoothers[j]->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+    smoothers[j]->InPlaceOn();
+    smoothers[j]->SetInput(input);
+    input = smoothers[j]->GetOutput();
+    last = smoothers[j];
+    }
+
+  if ( last.IsNotNull() )
+    {
+    last->GetOutput()->SetRequestedRegion(region);
+    last->Update();
+
+    if ( last->GetOutput()->GetPixelContainer() != field->GetPixelContainer() )
+      {
+      // the smoothers could not run in place
+      field->SetPixelContainer( last->GetOutput()->GetPixelContainer() );
+      }
+    }
+
+  field->Modified();
+  return true;
+}
 } // end namespace itk
 
 #endif
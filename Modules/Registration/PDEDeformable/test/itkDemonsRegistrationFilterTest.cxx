@@ -23,6 +23,8 @@
 #include "itkCommand.h"
 #include "itkVectorCastImageFilter.h"
 
+#include <algorithm>
+
 
 namespace{
 // The following class is used to support callbacks
@@ -265,6 +267,99 @@ int itkDemonsRegistrationFilterTest(int, char* [] )
 
   registrator->Print( std::cout );
 
+  // -----------------------------------------------------------
+  std::cout << "Test smoothing the fields with a recursive Gaussian." << std::endl;
+
+  std::vector< VectorType > operatorField;
+  itk::ImageRegionConstIterator<FieldType> operatorIter( registrator->GetOutput(),
+      registrator->GetOutput()->GetBufferedRegion() );
+  for ( ; !operatorIter.IsAtEnd(); ++operatorIter )
+    {
+    operatorField.push_back( operatorIter.Get() );
+    }
+
+  registrator->UseRecursiveGaussianSmoothingOn();
+  if ( !registrator->GetUseRecursiveGaussianSmoothing() )
+    {
+    std::cout << "Test failed - UseRecursiveGaussianSmoothing not set." << std::endl;
+    return EXIT_FAILURE;
+    }
+  warper->Update();
+
+  double maxFieldDifference = 0.0;
+  itk::ImageRegionConstIterator<FieldType> recursiveIter( registrator->GetOutput(),
+      registrator->GetOutput()->GetBufferedRegion() );
+  for ( auto operatorIt = operatorField.begin(); !recursiveIter.IsAtEnd(); ++recursiveIter, ++operatorIt )
+    {
+    maxFieldDifference = std::max( maxFieldDifference,
+                                   ( recursiveIter.Get() - *operatorIt ).GetNorm() );
+    }
+
+  itk::ImageRegionIterator<ImageType> recursiveWarpedIter( warper->GetOutput(),
+      fixed->GetBufferedRegion() );
+  numPixelsDifferent = 0;
+  for ( fixedIter.GoToBegin(); !fixedIter.IsAtEnd(); ++fixedIter, ++recursiveWarpedIter )
+    {
+    if( fixedIter.Get() != recursiveWarpedIter.Get() )
+      {
+      numPixelsDifferent++;
+      }
+    }
+
+  std::cout << "Number of pixels different: " << numPixelsDifferent << std::endl;
+  std::cout << "Maximum difference to the GaussianOperator field: " << maxFieldDifference << std::endl;
+
+  if( numPixelsDifferent > 10 || maxFieldDifference > 0.5 )
+    {
+    std::cout << "Test failed - recursive smoothing differs too much." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // -----------------------------------------------------------
+  std::cout << "Test smoothing the update field with a recursive Gaussian." << std::endl;
+
+  registrator->SmoothDisplacementFieldOff();
+  registrator->SmoothUpdateFieldOn();
+  registrator->SetUpdateFieldStandardDeviations( 1.0 );
+  registrator->SetNumberOfIterations( 5 );
+  registrator->UseRecursiveGaussianSmoothingOff();
+  registrator->Update();
+
+  std::vector< VectorType > operatorUpdateField;
+  itk::ImageRegionConstIterator<FieldType> operatorUpdateIter( registrator->GetOutput(),
+      registrator->GetOutput()->GetBufferedRegion() );
+  for ( ; !operatorUpdateIter.IsAtEnd(); ++operatorUpdateIter )
+    {
+    operatorUpdateField.push_back( operatorUpdateIter.Get() );
+    }
+
+  registrator->UseRecursiveGaussianSmoothingOn();
+  registrator->Update();
+
+  maxFieldDifference = 0.0;
+  itk::ImageRegionConstIterator<FieldType> recursiveUpdateIter( registrator->GetOutput(),
+      registrator->GetOutput()->GetBufferedRegion() );
+  for ( auto operatorIt = operatorUpdateField.begin(); !recursiveUpdateIter.IsAtEnd();
+        ++recursiveUpdateIter, ++operatorIt )
+    {
+    maxFieldDifference = std::max( maxFieldDifference,
+                                   ( recursiveUpdateIter.Get() - *operatorIt ).GetNorm() );
+    }
+
+  std::cout << "Maximum difference to the GaussianOperator update field: " << maxFieldDifference << std::endl;
+
+  if( operatorUpdateField.size() != registrator->GetOutput()->GetBufferedRegion().GetNumberOfPixels()
+      || maxFieldDifference > 0.5 )
+    {
+    std::cout << "Test failed - recursive update field smoothing differs too much." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  registrator->SmoothUpdateFieldOff();
+  registrator->SmoothDisplacementFieldOn();
+  registrator->UseRecursiveGaussianSmoothingOff();
+  registrator->SetNumberOfIterations( 200 );
+
   // -----------------------------------------------------------
   std::cout << "Test running registrator without initial deformation field.";
   std::cout << std::endl;
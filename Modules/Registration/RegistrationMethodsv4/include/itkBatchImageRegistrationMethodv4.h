@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBatchImageRegistrationMethodv4_h
+#define itkBatchImageRegistrationMethodv4_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMultiThreaderBase.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** \class BatchImageRegistrationMethodv4
+ * \brief Run many registrations of moving images to the same fixed image.
+ *
+ * Each registration is a fully configured ImageRegistrationMethodv4 (or
+ * subclass) with its own moving image, metric, optimizer and transform.  All
+ * registrations must share the fixed images, the virtual domain and the level
+ * settings (number of levels, shrink factors and smoothing sigmas).  Update()
+ * then
+ *
+ *   \li computes the fixed side images of every level (smoothed fixed images
+ *       and shrunk virtual domain) once, from the first registration, and
+ *       hands them read-only to all registrations, see
+ *       ImageRegistrationMethodv4::SetSharedFixedLevelImages(),
+ *   \li runs up to NumberOfConcurrentRegistrations registrations at a time,
+ *       each worker taking the next pending registration as soon as it is
+ *       done with the previous one.
+ *
+ * The global default number of threads is split between the concurrent
+ * registrations: during Update(), the NumberOfWorkUnits of each registration
+ * (used by its smoothing and shrinking filters), of its optimizer and the
+ * MaximumNumberOfWorkUnits of its metrics are set to the global default
+ * divided by the number of concurrent registrations.  Fixed image masks are
+ * shared by setting the same mask object on every metric; the fixed image
+ * gradients are computed by each metric from the shared smoothed fixed
+ * images.
+ *
+ * The registrations run in worker threads, so their observers must be thread
+ * safe.  To keep concurrent pipeline updates from writing to the same data
+ * object, the fixed image inputs of each registration are replaced by grafts
+ * of themselves, which share the pixel buffer.  The virtual domain, when set
+ * on the metrics, is not checked and is taken from the first registration.
+ * Once the batch is done, also when it throws, the original fixed image
+ * inputs and work unit settings are restored and the shared fixed level
+ * images are removed from the registrations.
+ *
+ * An exception thrown by one registration does not stop the others; once all
+ * registrations are done, Update() throws an exception listing the failed
+ * registrations and GetRegistrationFailed() tells which ones they are.
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template<typename TRegistration>
+class ITK_TEMPLATE_EXPORT BatchImageRegistrationMethodv4
+:public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(BatchImageRegistrationMethodv4);
+
+  /** Standard class type aliases. */
+  using Self = BatchImageRegistrationMethodv4;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( BatchImageRegistrationMethodv4, Object );
+
+  using RegistrationType = TRegistration;
+  using RegistrationPointer = typename RegistrationType::Pointer;
+  using RegistrationsContainerType = std::vector<RegistrationPointer>;
+  using FixedImageType = typename RegistrationType::FixedImageType;
+  using FixedImageConstPointer = typename FixedImageType::ConstPointer;
+  using FixedLevelImagesContainerType = typename RegistrationType::FixedLevelImagesContainerType;
+  using MetricType = typename RegistrationType::MetricType;
+  using MultiMetricType = typename RegistrationType::MultiMetricType;
+  using OptimizerType = typename RegistrationType::OptimizerType;
+
+  /** Add a registration to the batch. */
+  void AddRegistration( RegistrationType * );
+
+  /** Remove all the registrations. */
+  void ClearRegistrations();
+
+  /** Get the number of registrations. */
+  SizeValueType GetNumberOfRegistrations() const
+    {
+    return static_cast<SizeValueType>( this->m_Registrations.size() );
+    }
+
+  /** Get the i-th registration. */
+  RegistrationType * GetRegistration( SizeValueType ) const;
+
+  /** Set/Get the maximum number of registrations running at the same time.
+   * Defaults to the global default number of threads. */
+  itkSetClampMacro( NumberOfConcurrentRegistrations, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfConcurrentRegistrations, ThreadIdType );
+
+  /** Set/Get whether the fixed side images of every level are computed once
+   * and shared by all the registrations (default).  When off, each
+   * registration computes its own. */
+  itkSetMacro( ShareFixedLevelImages, bool );
+  itkGetConstMacro( ShareFixedLevelImages, bool );
+  itkBooleanMacro( ShareFixedLevelImages );
+
+  /** Get the shared fixed level images of the last Update(). */
+  const FixedLevelImagesContainerType & GetSharedFixedLevelImages() const
+    {
+    return this->m_SharedFixedLevelImages;
+    }
+
+  /** Whether the i-th registration threw an exception during the last
+   * Update(). */
+  bool GetRegistrationFailed( SizeValueType ) const;
+
+  /** Run all the registrations. */
+  virtual void Update();
+
+protected:
+  BatchImageRegistrationMethodv4();
+  ~BatchImageRegistrationMethodv4() override = default;
+  void PrintSelf( std::ostream & os, Indent indent ) const override;
+
+  /** Check that every registration has the same fixed side settings as the
+   * first one, so that the shared fixed level images are valid for all. */
+  virtual void VerifyFixedLevelSettings() const;
+
+private:
+  /** Settings of a registration changed for the duration of Update(). */
+  struct RegistrationStateType
+    {
+    bool                                Saved{ false };
+    ThreadIdType                        NumberOfWorkUnits{ 1 };
+    ThreadIdType                        OptimizerNumberOfWorkUnits{ 1 };
+    std::vector<ThreadIdType>           MetricMaximumNumberOfWorkUnits;
+    std::vector<FixedImageConstPointer> FixedImages;
+    };
+
+  /** Whether both images describe the same pixel data. */
+  static bool IsSameFixedImage( const FixedImageType *, const FixedImageType * );
+
+  /** Get the metric of the registration and, for a multi metric, the metrics
+   * of its queue. */
+  static void CollectMetrics( RegistrationType *, std::vector<MetricType *> & );
+
+  /** Save the settings of every registration, then set the work units, the
+   * fixed image grafts and the shared fixed level images for the batch. */
+  void PrepareRegistrations( const ThreadIdType workUnitsPerRegistration );
+
+  /** Restore the settings saved by PrepareRegistrations(). */
+  void RestoreRegistrations();
+
+  RegistrationsContainerType                                      m_Registrations;
+  ThreadIdType                                                    m_NumberOfConcurrentRegistrations;
+  bool                                                            m_ShareFixedLevelImages;
+  FixedLevelImagesContainerType                                   m_SharedFixedLevelImages;
+  std::vector<std::string>                                        m_RegistrationErrors;
+  std::vector<RegistrationStateType>                              m_SavedRegistrationStates;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBatchImageRegistrationMethodv4.hxx"
+#endif
+
+#endif
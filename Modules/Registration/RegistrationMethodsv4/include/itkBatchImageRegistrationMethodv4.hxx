@@ -0,0 +1,367 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBatchImageRegistrationMethodv4_hxx
+#define itkBatchImageRegistrationMethodv4_hxx
+
+#include "itkBatchImageRegistrationMethodv4.h"
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+namespace itk
+{
+
+template<typename TRegistration>
+BatchImageRegistrationMethodv4<TRegistration>
+::BatchImageRegistrationMethodv4() :
+  m_NumberOfConcurrentRegistrations( MultiThreaderBase::GetGlobalDefaultNumberOfThreads() ),
+  m_ShareFixedLevelImages( true )
+{
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::AddRegistration( RegistrationType * registration )
+{
+  if( registration == nullptr )
+    {
+    itkExceptionMacro( "The registration is not present." );
+    }
+  this->m_Registrations.push_back( registration );
+  this->Modified();
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::ClearRegistrations()
+{
+  this->m_Registrations.clear();
+  this->m_RegistrationErrors.clear();
+  this->m_SharedFixedLevelImages.clear();
+  this->Modified();
+}
+
+template<typename TRegistration>
+typename BatchImageRegistrationMethodv4<TRegistration>::RegistrationType *
+BatchImageRegistrationMethodv4<TRegistration>
+::GetRegistration( SizeValueType i ) const
+{
+  if( i >= this->m_Registrations.size() )
+    {
+    itkExceptionMacro( "Requesting registration " << i << " of " << this->m_Registrations.size() << "." );
+    }
+  return this->m_Registrations[i];
+}
+
+template<typename TRegistration>
+bool
+BatchImageRegistrationMethodv4<TRegistration>
+::GetRegistrationFailed( SizeValueType i ) const
+{
+  return i < this->m_RegistrationErrors.size() && !this->m_RegistrationErrors[i].empty();
+}
+
+template<typename TRegistration>
+bool
+BatchImageRegistrationMethodv4<TRegistration>
+::IsSameFixedImage( const FixedImageType * image1, const FixedImageType * image2 )
+{
+  if( image1 == image2 )
+    {
+    return true;
+    }
+  if( image1 == nullptr || image2 == nullptr )
+    {
+    return false;
+    }
+  return image1->GetPixelContainer() == image2->GetPixelContainer() &&
+    image1->GetBufferedRegion() == image2->GetBufferedRegion() &&
+    image1->GetLargestPossibleRegion() == image2->GetLargestPossibleRegion() &&
+    image1->GetOrigin() == image2->GetOrigin() &&
+    image1->GetSpacing() == image2->GetSpacing() &&
+    image1->GetDirection() == image2->GetDirection();
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::VerifyFixedLevelSettings() const
+{
+  const RegistrationType * reference = this->m_Registrations[0];
+  const SizeValueType numberOfLevels = reference->GetNumberOfLevels();
+  const SizeValueType numberOfObjectPairs = reference->GetNumberOfIndexedInputs() / 2;
+
+  for( SizeValueType i = 1; i < this->m_Registrations.size(); i++ )
+    {
+    const RegistrationType * registration = this->m_Registrations[i];
+
+    if( registration->GetNumberOfIndexedInputs() / 2 != numberOfObjectPairs )
+      {
+      itkExceptionMacro( "Registration " << i << " does not have the same number of inputs as registration 0." );
+      }
+    for( SizeValueType n = 0; n < numberOfObjectPairs; n++ )
+      {
+      if( !Self::IsSameFixedImage( reference->GetFixedImage( n ), registration->GetFixedImage( n ) ) )
+        {
+        itkExceptionMacro( "Fixed image " << n << " of registration " << i << " differs from that of registration 0." );
+        }
+      }
+
+    if( registration->GetNumberOfLevels() != numberOfLevels ||
+        registration->GetSmoothingSigmasPerLevel() != reference->GetSmoothingSigmasPerLevel() ||
+        registration->GetSmoothingSigmasAreSpecifiedInPhysicalUnits() != reference->GetSmoothingSigmasAreSpecifiedInPhysicalUnits() )
+      {
+      itkExceptionMacro( "The levels or smoothing sigmas of registration " << i << " differ from those of registration 0." );
+      }
+    for( SizeValueType level = 0; level < numberOfLevels; level++ )
+      {
+      if( registration->GetShrinkFactorsPerDimension( level ) != reference->GetShrinkFactorsPerDimension( level ) )
+        {
+        itkExceptionMacro( "The shrink factors of registration " << i << " differ from those of registration 0." );
+        }
+      }
+    }
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::CollectMetrics( RegistrationType * registration, std::vector<MetricType *> & metrics )
+{
+  metrics.clear();
+  MetricType * metric = registration->GetModifiableMetric();
+  if( metric == nullptr )
+    {
+    return;
+    }
+  metrics.push_back( metric );
+  if( metric->GetMetricCategory() == MetricType::MULTI_METRIC )
+    {
+    auto * multiMetric = dynamic_cast<MultiMetricType *>( metric );
+    if( multiMetric != nullptr )
+      {
+      for( auto & queuedMetric : multiMetric->GetMetricQueue() )
+        {
+        metrics.push_back( queuedMetric.GetPointer() );
+        }
+      }
+    }
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::PrepareRegistrations( const ThreadIdType workUnitsPerRegistration )
+{
+  this->m_SavedRegistrationStates.resize( this->m_Registrations.size() );
+  for( SizeValueType i = 0; i < this->m_Registrations.size(); i++ )
+    {
+    RegistrationType * registration = this->m_Registrations[i];
+    RegistrationStateType & state = this->m_SavedRegistrationStates[i];
+
+    state.Saved = true;
+    state.NumberOfWorkUnits = registration->GetNumberOfWorkUnits();
+    registration->SetNumberOfWorkUnits( workUnitsPerRegistration );
+
+    OptimizerType * optimizer = registration->GetModifiableOptimizer();
+    if( optimizer != nullptr )
+      {
+      state.OptimizerNumberOfWorkUnits = optimizer->GetNumberOfWorkUnits();
+      optimizer->SetNumberOfWorkUnits( workUnitsPerRegistration );
+      }
+
+    std::vector<MetricType *> metrics;
+    Self::CollectMetrics( registration, metrics );
+    state.MetricMaximumNumberOfWorkUnits.clear();
+    for( auto & metric : metrics )
+      {
+      state.MetricMaximumNumberOfWorkUnits.push_back( metric->GetMaximumNumberOfWorkUnits() );
+      metric->SetMaximumNumberOfWorkUnits( workUnitsPerRegistration );
+      }
+
+    state.FixedImages.clear();
+    for( SizeValueType n = 0; n < registration->GetNumberOfIndexedInputs() / 2; n++ )
+      {
+      const FixedImageType * fixedImage = registration->GetFixedImage( n );
+      state.FixedImages.push_back( fixedImage );
+      if( fixedImage != nullptr )
+        {
+        typename FixedImageType::Pointer fixedImageGraft = FixedImageType::New();
+        fixedImageGraft->Graft( fixedImage );
+        registration->SetFixedImage( n, fixedImageGraft );
+        }
+      }
+    registration->SetSharedFixedLevelImages( this->m_SharedFixedLevelImages );
+    }
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::RestoreRegistrations()
+{
+  const FixedLevelImagesContainerType noFixedLevelImages;
+  for( SizeValueType i = 0; i < this->m_SavedRegistrationStates.size(); i++ )
+    {
+    RegistrationType * registration = this->m_Registrations[i];
+    const RegistrationStateType & state = this->m_SavedRegistrationStates[i];
+    if( !state.Saved )
+      {
+      continue;
+      }
+
+    registration->SetNumberOfWorkUnits( state.NumberOfWorkUnits );
+
+    OptimizerType * optimizer = registration->GetModifiableOptimizer();
+    if( optimizer != nullptr )
+      {
+      optimizer->SetNumberOfWorkUnits( state.OptimizerNumberOfWorkUnits );
+      }
+
+    std::vector<MetricType *> metrics;
+    Self::CollectMetrics( registration, metrics );
+    for( SizeValueType m = 0; m < metrics.size() && m < state.MetricMaximumNumberOfWorkUnits.size(); m++ )
+      {
+      metrics[m]->SetMaximumNumberOfWorkUnits( state.MetricMaximumNumberOfWorkUnits[m] );
+      }
+
+    for( SizeValueType n = 0; n < state.FixedImages.size(); n++ )
+      {
+      if( state.FixedImages[n].IsNotNull() )
+        {
+        registration->SetFixedImage( n, state.FixedImages[n] );
+        }
+      }
+    registration->SetSharedFixedLevelImages( noFixedLevelImages );
+    }
+  this->m_SavedRegistrationStates.clear();
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::Update()
+{
+  const SizeValueType numberOfRegistrations = this->m_Registrations.size();
+  this->m_RegistrationErrors.assign( numberOfRegistrations, std::string() );
+  this->m_SharedFixedLevelImages.clear();
+  if( numberOfRegistrations == 0 )
+    {
+    return;
+    }
+
+  this->InvokeEvent( StartEvent() );
+
+  if( this->m_ShareFixedLevelImages )
+    {
+    this->VerifyFixedLevelSettings();
+    this->m_SharedFixedLevelImages = this->m_Registrations[0]->ComputeFixedLevelImages();
+    }
+
+  // Split the global thread budget between the registrations running at the
+  // same time rather than letting each of them use all the threads.
+  const SizeValueType numberOfWorkers =
+    std::min( static_cast<SizeValueType>( this->m_NumberOfConcurrentRegistrations ), numberOfRegistrations );
+  const ThreadIdType workUnitsPerRegistration = std::max( static_cast<ThreadIdType>( 1 ),
+    static_cast<ThreadIdType>( MultiThreaderBase::GetGlobalDefaultNumberOfThreads() / numberOfWorkers ) );
+
+  // Each worker takes the next pending registration until none is left.
+  // The workers are plain threads rather than jobs of the global thread pool,
+  // which the filters inside the registrations use and could otherwise wait
+  // on themselves.
+  std::atomic<SizeValueType> nextRegistration( 0 );
+  auto worker = [this, &nextRegistration, numberOfRegistrations]()
+    {
+    for( SizeValueType i = nextRegistration++; i < numberOfRegistrations; i = nextRegistration++ )
+      {
+      try
+        {
+        this->m_Registrations[i]->Update();
+        }
+      catch( std::exception & exc )
+        {
+        const char * description = exc.what();
+        this->m_RegistrationErrors[i] = ( description != nullptr && *description != '\0' ) ? description : "Unknown exception.";
+        }
+      catch( ... )
+        {
+        this->m_RegistrationErrors[i] = "Unknown exception.";
+        }
+      }
+    };
+
+  // The registrations are handed back to the caller as they were, so that a
+  // later standalone Update() of one of them does not run on the shared fixed
+  // level images or on the reduced thread budget of this batch.
+  try
+    {
+    this->PrepareRegistrations( workUnitsPerRegistration );
+
+    std::vector<std::thread> workers;
+    for( SizeValueType w = 1; w < numberOfWorkers; w++ )
+      {
+      workers.emplace_back( worker );
+      }
+    worker();
+    for( auto & thread : workers )
+      {
+      thread.join();
+      }
+    }
+  catch( ... )
+    {
+    this->RestoreRegistrations();
+    throw;
+    }
+  this->RestoreRegistrations();
+
+  this->InvokeEvent( EndEvent() );
+
+  std::ostringstream errors;
+  for( SizeValueType i = 0; i < numberOfRegistrations; i++ )
+    {
+    if( !this->m_RegistrationErrors[i].empty() )
+      {
+      errors << std::endl << "Registration " << i << ": " << this->m_RegistrationErrors[i];
+      }
+    }
+  if( !errors.str().empty() )
+    {
+    itkExceptionMacro( "Some registrations failed." << errors.str() );
+    }
+}
+
+template<typename TRegistration>
+void
+BatchImageRegistrationMethodv4<TRegistration>
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "NumberOfRegistrations: " << this->m_Registrations.size() << std::endl;
+  os << indent << "NumberOfConcurrentRegistrations: " << this->m_NumberOfConcurrentRegistrations << std::endl;
+  os << indent << "ShareFixedLevelImages: " << ( this->m_ShareFixedLevelImages ? "On" : "Off" ) << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -189,10 +189,44 @@ public:
   /** Weights type for the optimizer. */
   using OptimizerWeightsType = typename OptimizerType::ScalesType;
 
-  /** enum type for metric sampling strategy */
-  enum MetricSamplingStrategyType { NONE, REGULAR, RANDOM };
+  /** enum type for metric sampling strategy
+   *
+   * - NONE: all virtual domain voxels are used.
+   * - REGULAR: every 1/percentage-th voxel, jittered within the voxel.
+   * - RANDOM: voxels drawn uniformly at random, jittered within the voxel.
+   * - STRATIFIED: the virtual domain is split in blocks of about
+   *   1/percentage voxels and one uniformly distributed point is drawn per
+   *   block. Points outside the fixed image mask are redrawn a few times,
+   *   so that blocks on the mask border are still represented.
+   * - HALTON: percentage times the number of virtual domain voxels points of
+   *   a randomly shifted Halton low-discrepancy sequence over the virtual
+   *   domain.
+   * - GRADIENT_WEIGHTED: voxels are selected with a probability that
+   *   increases with the gradient magnitude of the current level fixed
+   *   image, by systematic sampling of the cumulative weights. Note that
+   *   the metrics do not reweight the samples, so the metric is biased
+   *   towards the image edges.
+   *
+   * With a fixed image mask, REGULAR, RANDOM and HALTON draw their points
+   * over the whole virtual domain and drop the ones outside the mask, so
+   * that the number of sample points is about percentage times the number
+   * of voxels inside the mask.  STRATIFIED keeps one point for every block
+   * that overlaps the mask, which over-represents the mask border when the
+   * blocks are large.  GRADIENT_WEIGHTED selects exactly percentage times
+   * the number of voxels inside the mask and the fixed image.
+   *
+   * The STRATIFIED and HALTON sample points carry over from one level to the
+   * next: STRATIFIED keeps each point of the previous level that is inside
+   * the current virtual domain and mask for the block that contains it, and
+   * only draws points for the other blocks; HALTON keeps the shift of the
+   * sequence, so the points of a level start with those of the previous
+   * level when both cover the same physical domain.  The sample points are
+   * computed once per level and used for all its iterations.
+   */
+  enum MetricSamplingStrategyType { NONE, REGULAR, RANDOM, STRATIFIED, HALTON, GRADIENT_WEIGHTED };
 
   using MetricSamplePointSetType = typename ImageMetricType::FixedSampledPointSetType;
+  using MetricSamplePointSetPointer = typename MetricSamplePointSetType::Pointer;
 
   /** Set/get the fixed images. */
   virtual void SetFixedImage( const FixedImageType *image )
@@ -381,6 +415,33 @@ public:
   itkGetConstMacro( SmoothingSigmasAreSpecifiedInPhysicalUnits, bool );
   itkBooleanMacro( SmoothingSigmasAreSpecifiedInPhysicalUnits );
 
+  /** Fixed side images of one level: the smoothed fixed image of each image
+   * metric (nullptr for the point set metrics) and the shrunk virtual domain
+   * image. */
+  struct FixedLevelImagesType
+    {
+    FixedImagesContainerType FixedSmoothImages;
+    VirtualImagePointer      VirtualDomainImage;
+    };
+  using FixedLevelImagesContainerType = std::vector<FixedLevelImagesType>;
+
+  /**
+   * Compute the fixed side images of every level from the current fixed
+   * images, metric, shrink factors and smoothing sigmas.
+   */
+  virtual FixedLevelImagesContainerType ComputeFixedLevelImages();
+
+  /**
+   * Set/Get fixed side images, one entry per level, used instead of
+   * smoothing the fixed images and shrinking the virtual domain at each
+   * level.  The images are only read, so the same container can be shared by
+   * several registrations with identical fixed images, virtual domain and
+   * level settings (see \c BatchImageRegistrationMethodv4).  An empty
+   * container (default) restores the computation at each level.
+   */
+  void SetSharedFixedLevelImages( const FixedLevelImagesContainerType & );
+  const FixedLevelImagesContainerType & GetSharedFixedLevelImages() const;
+
   /** Make a DataObject of the correct type to be used as the specified output. */
   using DataObjectPointerArraySizeType = ProcessObject::DataObjectPointerArraySizeType;
   using Superclass::MakeOutput;
@@ -460,6 +521,18 @@ protected:
   /** Get metric samples. */
   virtual void SetMetricSamplePoints();
 
+  /** Shrink the full resolution virtual domain image to the given level. */
+  VirtualImagePointer ShrinkVirtualDomainImage( const VirtualImageType *, const SizeValueType level ) const;
+
+  /** Smooth the n-th fixed image with the sigma of the given level. */
+  FixedImageConstPointer SmoothFixedImage( const SizeValueType n, const SizeValueType level ) const;
+
+  /** Compute the sample points of the n-th metric with the current
+   * sampling strategy, from those of the previous level when the strategy
+   * carries them over. */
+  virtual MetricSamplePointSetPointer ComputeMetricSamplePointSet( SizeValueType n,
+    const VirtualImageType * virtualImage, const FixedImageMaskType * fixedMaskImage );
+
   SizeValueType                                                   m_CurrentLevel;
   SizeValueType                                                   m_NumberOfLevels;
   SizeValueType                                                   m_CurrentIteration;
@@ -494,6 +567,13 @@ protected:
   int                                                             m_RandomSeed;
   int                                                             m_CurrentRandomSeed;
 
+  /** Sample point sets per metric of the last level and Halton sequence
+   * shifts per metric, see MetricSamplingStrategyType. */
+  std::vector<MetricSamplePointSetPointer>                        m_MetricSamplePointSets;
+  std::vector<std::vector<RealType> >                             m_MetricSampleHaltonShifts;
+
+  FixedLevelImagesContainerType                                   m_SharedFixedLevelImages;
+
 
   TransformParametersAdaptorsContainerType                        m_TransformParametersAdaptorsPerLevel;
 
@@ -28,6 +28,7 @@
 #include "itkIterationReporter.h"
 #include "itkMattesMutualInformationImageToImageMetricv4.h"
 #include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkDefaultConvertPixelTraits.h"
 #include "itkRegistrationParameterScalesFromPhysicalShift.h"
 
 namespace itk
@@ -408,18 +409,37 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
         }
       }
 
-    {
-    VirtualImageBaseConstPointer virtualDomainBaseImage = this->GetCurrentLevelVirtualDomainImage();
-
-    if( virtualDomainBaseImage.IsNull() && this->m_FirstImageMetricIndex >= 0 )
+    if( !this->m_SharedFixedLevelImages.empty() )
       {
-      virtualDomainBaseImage =  this->GetFixedImage( this->m_FirstImageMetricIndex );
+      // The shared fixed level images replace the full resolution virtual
+      // domain image, which is then not allocated.
+      if( this->m_SharedFixedLevelImages.size() != this->m_NumberOfLevels )
+        {
+        itkExceptionMacro( "Mismatch between the number of shared fixed level images and the number of levels." );
+        }
+      for( SizeValueType n = 0; n < this->m_NumberOfLevels; n++ )
+        {
+        if( this->m_SharedFixedLevelImages[n].FixedSmoothImages.size() != this->m_NumberOfMetrics ||
+            this->m_SharedFixedLevelImages[n].VirtualDomainImage.IsNull() )
+          {
+          itkExceptionMacro( "The shared fixed level images of level " << n << " are incomplete." );
+          }
+        }
+      this->m_VirtualDomainImage = nullptr;
+      }
+    else
+      {
+      VirtualImageBaseConstPointer virtualDomainBaseImage = this->GetCurrentLevelVirtualDomainImage();
+
+      if( virtualDomainBaseImage.IsNull() && this->m_FirstImageMetricIndex >= 0 )
+        {
+        virtualDomainBaseImage =  this->GetFixedImage( this->m_FirstImageMetricIndex );
+        }
+      this->m_VirtualDomainImage = VirtualImageType::New();
+      this->m_VirtualDomainImage->CopyInformation( virtualDomainBaseImage );
+      this->m_VirtualDomainImage->SetRegions( virtualDomainBaseImage->GetLargestPossibleRegion() );
+      this->m_VirtualDomainImage->Allocate();
       }
-    this->m_VirtualDomainImage = VirtualImageType::New();
-    this->m_VirtualDomainImage->CopyInformation( virtualDomainBaseImage );
-    this->m_VirtualDomainImage->SetRegions( virtualDomainBaseImage->GetLargestPossibleRegion() );
-    this->m_VirtualDomainImage->Allocate();
-    }
 
     this->m_FixedImageMasks.clear();
     this->m_FixedImageMasks.resize( this->m_NumberOfMetrics );
@@ -460,14 +480,16 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   //   2. smooth the fixed and moving images.
 
   typename VirtualImageType::Pointer currentLevelVirtualDomainImage = nullptr;
-  if( this->m_VirtualDomainImage.IsNotNull() )
+  if( !this->m_SharedFixedLevelImages.empty() )
     {
-    typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
-    shrinkFilter->SetShrinkFactors( this->m_ShrinkFactorsPerLevel[level] );
-    shrinkFilter->SetInput( this->m_VirtualDomainImage );
-
-    currentLevelVirtualDomainImage = shrinkFilter->GetOutput();
-    currentLevelVirtualDomainImage->Update();
+    // Graft the shared image so that the pipeline updates of this
+    // registration never write to a data object used by another one.
+    currentLevelVirtualDomainImage = VirtualImageType::New();
+    currentLevelVirtualDomainImage->Graft( this->m_SharedFixedLevelImages[level].VirtualDomainImage );
+    }
+  else if( this->m_VirtualDomainImage.IsNotNull() )
+    {
+    currentLevelVirtualDomainImage = this->ShrinkVirtualDomainImage( this->m_VirtualDomainImage, level );
     }
   else
     {
@@ -514,6 +536,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
           using CasterType = CastImageFilter<VirtualImageType, typename PointSetMetricType::VirtualImageType>;
           typename CasterType::Pointer caster = CasterType::New();
+          caster->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
           caster->SetInput( currentLevelVirtualDomainImage );
           caster->Update();
 
@@ -563,6 +586,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
       using CasterType = CastImageFilter<VirtualImageType, typename PointSetMetricType::VirtualImageType>;
       typename CasterType::Pointer caster = CasterType::New();
+      caster->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
       caster->SetInput( currentLevelVirtualDomainImage );
       caster->Update();
 
@@ -600,27 +624,19 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
         ( this->m_Metric->GetMetricCategory() == MetricType::MULTI_METRIC &&
           multiMetric->GetMetricQueue()[n]->GetMetricCategory() == MetricType::IMAGE_METRIC ) )
       {
-      if ( this->m_SmoothingSigmasPerLevel[level] > 0 )
+      if( !this->m_SharedFixedLevelImages.empty() )
         {
-        using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
-        typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
-        typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray( this->m_SmoothingSigmasPerLevel[level] );
-
-        if( !this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits  )
-          {
-          auto & fixedSpacing  = this->GetFixedImage( n )->GetSpacing();
-          for ( unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i )
-            {
-            fixedImageSigmaArray[i] *= fixedSpacing[i];
-            }
-          }
-        fixedImageSmoothingFilter->SetSigmaArray( fixedImageSigmaArray );
-        fixedImageSmoothingFilter->SetInput( this->GetFixedImage( n ) );
-
-        this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
-        fixedImageSmoothingFilter->Update();
-        fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+        FixedImagePointer fixedSmoothImage = FixedImageType::New();
+        fixedSmoothImage->Graft( this->m_SharedFixedLevelImages[level].FixedSmoothImages[n] );
+        this->m_FixedSmoothImages[n] = fixedSmoothImage;
+        }
+      else
+        {
+        this->m_FixedSmoothImages[n] = this->SmoothFixedImage( n, level );
+        }
 
+      if ( this->m_SmoothingSigmasPerLevel[level] > 0 )
+        {
         using MovingImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<MovingImageType, MovingImageType>;
         typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
         typename MovingImageSmoothingFilterType::SigmaArrayType movingImageSigmaArray( this->m_SmoothingSigmasPerLevel[level] );
@@ -634,6 +650,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
             }
           }
         movingImageSmoothingFilter->SetSigmaArray( movingImageSigmaArray );
+        movingImageSmoothingFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
         movingImageSmoothingFilter->SetInput( this->GetMovingImage( n ) );
 
         this->m_MovingSmoothImages[n] = movingImageSmoothingFilter->GetOutput();
@@ -643,7 +660,6 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
       else
         {
         this->m_MovingSmoothImages[n] = this->GetMovingImage( n );
-        this->m_FixedSmoothImages[n] = this->GetFixedImage( n );
         }
 
       // Update the image metric
@@ -892,7 +908,6 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 ::SetMetricSamplePoints()
 {
   using VirtualDomainImageType = typename ImageMetricType::VirtualImageType;
-  using VirtualDomainRegionType = typename VirtualDomainImageType::RegionType;
 
   const VirtualDomainImageType * virtualImage = nullptr;
   const FixedImageMaskType * fixedMaskImage = nullptr;
@@ -935,84 +950,411 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
       }
     }
 
-  const VirtualDomainRegionType & virtualDomainRegion = virtualImage->GetRequestedRegion();
-  const typename VirtualDomainImageType::SpacingType oneThirdVirtualSpacing = virtualImage->GetSpacing() / 3.0;
+  // The sample points of the previous level are kept for the STRATIFIED and
+  // HALTON strategies, see ComputeMetricSamplePointSet().
+  if( this->m_CurrentLevel == 0 || this->m_MetricSamplePointSets.size() != numberOfLocalMetrics )
+    {
+    this->m_MetricSamplePointSets.assign( numberOfLocalMetrics, nullptr );
+    this->m_MetricSampleHaltonShifts.assign( numberOfLocalMetrics, std::vector<RealType>() );
+    }
 
   for( SizeValueType n = 0; n < numberOfLocalMetrics; n++ )
     {
-    typename MetricSamplePointSetType::Pointer samplePointSet = MetricSamplePointSetType::New();
-    samplePointSet->Initialize();
+    MetricSamplePointSetPointer samplePointSet = this->ComputeMetricSamplePointSet( n, virtualImage, fixedMaskImage );
+    this->m_MetricSamplePointSets[n] = samplePointSet;
 
-    using SamplePointType = typename MetricSamplePointSetType::PointType;
-
-    using RandomizerType = Statistics::MersenneTwisterRandomVariateGenerator;
-    typename RandomizerType::Pointer randomizer = RandomizerType::New();
-    if (m_ReseedIterator)
+    if( multiMetric )
       {
-      randomizer->SetSeed( );
+      dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->SetVirtualSampledPointSet( samplePointSet );
+      dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->UseSampledPointSetOn();
+      dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->UseVirtualSampledPointSetOn();
       }
     else
       {
-      randomizer->SetSeed( m_CurrentRandomSeed++ );
+      dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->SetVirtualSampledPointSet( samplePointSet );
+      dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->UseSampledPointSetOn();
+      dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->UseVirtualSampledPointSetOn();
       }
+    }
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::MetricSamplePointSetPointer
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>
+::ComputeMetricSamplePointSet( SizeValueType n, const VirtualImageType * virtualImage,
+                               const FixedImageMaskType * fixedMaskImage )
+{
+  using VirtualDomainRegionType = typename VirtualImageType::RegionType;
+  using SamplePointType = typename MetricSamplePointSetType::PointType;
+  using ContinuousIndexType = ContinuousIndex<RealType, ImageDimension>;
 
+  const VirtualDomainRegionType & virtualDomainRegion = virtualImage->GetRequestedRegion();
+  const typename VirtualImageType::SpacingType oneThirdVirtualSpacing = virtualImage->GetSpacing() / 3.0;
+  const RealType samplingPercentage = this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel];
+
+  MetricSamplePointSetPointer samplePointSet = MetricSamplePointSetType::New();
+  samplePointSet->Initialize();
+
+  using RandomizerType = Statistics::MersenneTwisterRandomVariateGenerator;
+  typename RandomizerType::Pointer randomizer = RandomizerType::New();
+  if (m_ReseedIterator)
+    {
+    randomizer->SetSeed( );
+    }
+  else
+    {
+    randomizer->SetSeed( m_CurrentRandomSeed++ );
+    }
 
-    unsigned long index = 0;
+  unsigned long index = 0;
 
-    switch( this->m_MetricSamplingStrategy )
+  switch( this->m_MetricSamplingStrategy )
+    {
+    case REGULAR:
       {
-      case REGULAR:
+      const auto sampleCount = static_cast<unsigned long>( std::ceil( 1.0 / samplingPercentage ) );
+      unsigned long count = sampleCount; //Start at sampleCount to keep behavior backwards identical, using first element.
+      ImageRegionConstIteratorWithIndex<VirtualImageType> It( virtualImage, virtualDomainRegion );
+      for( It.GoToBegin(); !It.IsAtEnd(); ++It )
         {
-        const auto sampleCount = static_cast<unsigned long>(
-          std::ceil( 1.0 / this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel] ) );
-        unsigned long count = sampleCount; //Start at sampleCount to keep behavior backwards identical, using first element.
-        ImageRegionConstIteratorWithIndex<VirtualDomainImageType> It( virtualImage, virtualDomainRegion );
-        for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+        if( count == sampleCount )
           {
-          if( count == sampleCount )
+          count=0; //Reset counter
+          SamplePointType point;
+          virtualImage->TransformIndexToPhysicalPoint( It.GetIndex(), point );
+
+          // randomly perturb the point within a voxel (approximately)
+          for( SizeValueType d = 0; d < ImageDimension; d++ )
+            {
+            point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
+            }
+          if( !fixedMaskImage || fixedMaskImage->IsInside( point ) )
             {
-            count=0; //Reset counter
-            SamplePointType point;
-            virtualImage->TransformIndexToPhysicalPoint( It.GetIndex(), point );
+            samplePointSet->SetPoint( index, point );
+            ++index;
+            }
+          }
+        ++count;
+        }
+      break;
+      }
+    case RANDOM:
+      {
+      const unsigned long totalVirtualDomainVoxels = virtualDomainRegion.GetNumberOfPixels();
+      const auto sampleCount = static_cast<unsigned long>(
+       static_cast<float>( totalVirtualDomainVoxels ) * samplingPercentage );
+      ImageRandomConstIteratorWithIndex<VirtualImageType> ItR( virtualImage, virtualDomainRegion );
+      if (m_ReseedIterator)
+        {
+        ItR.ReinitializeSeed();
+        }
+      else
+        {
+        ItR.ReinitializeSeed( m_CurrentRandomSeed++ );
+        }
+      ItR.SetNumberOfSamples( sampleCount );
+      for( ItR.GoToBegin(); !ItR.IsAtEnd(); ++ItR )
+        {
+        SamplePointType point;
+        virtualImage->TransformIndexToPhysicalPoint( ItR.GetIndex(), point );
+
+        // randomly perturb the point within a voxel (approximately)
+        for ( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
+          }
+        if( !fixedMaskImage || fixedMaskImage->IsInside( point ) )
+          {
+          samplePointSet->SetPoint( index, point );
+          ++index;
+          }
+        }
+      break;
+      }
+    case STRATIFIED:
+      {
+      // Blocks of about 1/samplingPercentage voxels, one point per block.
+      const RealType blockSize = std::pow( 1.0 / samplingPercentage, 1.0 / ImageDimension );
+      SizeValueType numberOfBlocks[ImageDimension];
+      RealType blockExtent[ImageDimension];
+      SizeValueType totalNumberOfBlocks = 1;
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        const RealType size = virtualDomainRegion.GetSize( d );
+        numberOfBlocks[d] = std::max( Math::Round<SizeValueType>( size / blockSize ),
+                                      NumericTraits<SizeValueType>::OneValue() );
+        blockExtent[d] = size / numberOfBlocks[d];
+        totalNumberOfBlocks *= numberOfBlocks[d];
+        }
 
-            // randomly perturb the point within a voxel (approximately)
-            for( SizeValueType d = 0; d < ImageDimension; d++ )
+      // A sample point of the previous level is kept for the block that
+      // contains it, if it is inside the fixed image mask, so that the finer
+      // levels refine the sample set of the coarser ones.
+      std::vector<SamplePointType> blockPoints( totalNumberOfBlocks );
+      std::vector<char> blockHasPoint( totalNumberOfBlocks, 0 );
+      const MetricSamplePointSetType * previousPointSet =
+        ( n < this->m_MetricSamplePointSets.size() ) ? this->m_MetricSamplePointSets[n].GetPointer() : nullptr;
+      if( previousPointSet != nullptr && this->m_CurrentLevel > 0 )
+        {
+        for( auto it = previousPointSet->GetPoints()->Begin(); it != previousPointSet->GetPoints()->End(); ++it )
+          {
+          const SamplePointType & point = it.Value();
+          ContinuousIndexType continuousIndex;
+          virtualImage->TransformPhysicalPointToContinuousIndex( point, continuousIndex );
+          SizeValueType block = 0;
+          SizeValueType blockStride = 1;
+          bool isInsideDomain = true;
+          for( unsigned int d = 0; d < ImageDimension; d++ )
+            {
+            const RealType blockCoordinate = std::floor(
+              ( continuousIndex[d] - virtualDomainRegion.GetIndex( d ) + 0.5 ) / blockExtent[d] );
+            if( blockCoordinate < 0.0 || blockCoordinate >= numberOfBlocks[d] )
               {
-              point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
+              isInsideDomain = false;
+              break;
               }
-            if( !fixedMaskImage || fixedMaskImage->IsInside( point ) )
+            block += static_cast<SizeValueType>( blockCoordinate ) * blockStride;
+            blockStride *= numberOfBlocks[d];
+            }
+          if( isInsideDomain && !blockHasPoint[block] && ( !fixedMaskImage || fixedMaskImage->IsInside( point ) ) )
+            {
+            blockPoints[block] = point;
+            blockHasPoint[block] = 1;
+            }
+          }
+        }
+
+      // Points outside the mask are redrawn within their block, so that
+      // blocks partially covered by the mask keep their sample.
+      constexpr unsigned int maximumNumberOfDraws = 4;
+      for( SizeValueType block = 0; block < totalNumberOfBlocks; block++ )
+        {
+        if( blockHasPoint[block] )
+          {
+          samplePointSet->SetPoint( index, blockPoints[block] );
+          ++index;
+          continue;
+          }
+        SizeValueType blockIndex[ImageDimension];
+        SizeValueType remainder = block;
+        for( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          blockIndex[d] = remainder % numberOfBlocks[d];
+          remainder /= numberOfBlocks[d];
+          }
+        for( unsigned int draw = 0; draw < maximumNumberOfDraws; draw++ )
+          {
+          ContinuousIndexType continuousIndex;
+          for( unsigned int d = 0; d < ImageDimension; d++ )
+            {
+            continuousIndex[d] = virtualDomainRegion.GetIndex( d ) - 0.5
+              + ( blockIndex[d] + randomizer->GetVariateWithOpenUpperRange() ) * blockExtent[d];
+            }
+          SamplePointType point;
+          virtualImage->TransformContinuousIndexToPhysicalPoint( continuousIndex, point );
+          if( !fixedMaskImage || fixedMaskImage->IsInside( point ) )
+            {
+            samplePointSet->SetPoint( index, point );
+            ++index;
+            break;
+            }
+          }
+        }
+      break;
+      }
+    case HALTON:
+      {
+      const unsigned long totalVirtualDomainVoxels = virtualDomainRegion.GetNumberOfPixels();
+      const auto sampleCount = static_cast<unsigned long>(
+       static_cast<float>( totalVirtualDomainVoxels ) * samplingPercentage );
+
+      // The first ImageDimension primes are the bases of the sequence, a
+      // random shift per dimension (Cranley-Patterson rotation) makes it
+      // depend on the seed.  The shifts are kept for the following levels,
+      // so that the points of a level, which cover the same physical domain,
+      // start with those of the previous one.
+      if( this->m_MetricSampleHaltonShifts.size() <= n )
+        {
+        this->m_MetricSampleHaltonShifts.resize( n + 1 );
+        }
+      std::vector<RealType> & shifts = this->m_MetricSampleHaltonShifts[n];
+      const bool drawShifts = ( shifts.size() != ImageDimension );
+      if( drawShifts )
+        {
+        shifts.resize( ImageDimension );
+        }
+      unsigned int bases[ImageDimension];
+      unsigned int candidate = 2;
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        bool isPrime = false;
+        while( !isPrime )
+          {
+          isPrime = true;
+          for( unsigned int divisor = 2; divisor * divisor <= candidate; divisor++ )
+            {
+            if( candidate % divisor == 0 )
               {
-              samplePointSet->SetPoint( index, point );
-              ++index;
+              isPrime = false;
+              break;
               }
             }
-          ++count;
+          if( !isPrime )
+            {
+            candidate++;
+            }
+          }
+        bases[d] = candidate++;
+        if( drawShifts )
+          {
+          shifts[d] = randomizer->GetVariateWithOpenUpperRange();
           }
-        break;
         }
-      case RANDOM:
+
+      // As for the RANDOM strategy, points outside the mask are dropped.
+      for( unsigned long i = 1; i <= sampleCount; i++ )
         {
-        const unsigned long totalVirtualDomainVoxels = virtualDomainRegion.GetNumberOfPixels();
-        const auto sampleCount = static_cast<unsigned long>(
-         static_cast<float>( totalVirtualDomainVoxels )
-               * this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel] );
-        ImageRandomConstIteratorWithIndex<VirtualDomainImageType> ItR( virtualImage, virtualDomainRegion );
-        if (m_ReseedIterator)
+        ContinuousIndexType continuousIndex;
+        for( unsigned int d = 0; d < ImageDimension; d++ )
           {
-          ItR.ReinitializeSeed();
+          // Radical inverse of i in base bases[d]
+          RealType radicalInverse = 0.0;
+          RealType digitWeight = 1.0 / bases[d];
+          for( unsigned long remainder = i; remainder > 0; remainder /= bases[d] )
+            {
+            radicalInverse += ( remainder % bases[d] ) * digitWeight;
+            digitWeight /= bases[d];
+            }
+          radicalInverse += shifts[d];
+          if( radicalInverse >= 1.0 )
+            {
+            radicalInverse -= 1.0;
+            }
+          continuousIndex[d] = virtualDomainRegion.GetIndex( d ) - 0.5
+            + radicalInverse * virtualDomainRegion.GetSize( d );
           }
-        else
+        SamplePointType point;
+        virtualImage->TransformContinuousIndexToPhysicalPoint( continuousIndex, point );
+        if( !fixedMaskImage || fixedMaskImage->IsInside( point ) )
           {
-          ItR.ReinitializeSeed( m_CurrentRandomSeed++ );
+          samplePointSet->SetPoint( index, point );
+          ++index;
           }
-        ItR.SetNumberOfSamples( sampleCount );
-        for( ItR.GoToBegin(); !ItR.IsAtEnd(); ++ItR )
+        }
+      break;
+      }
+    case GRADIENT_WEIGHTED:
+      {
+      const FixedImageType * fixedImage = this->m_FixedSmoothImages[n];
+      if( fixedImage == nullptr )
+        {
+        itkExceptionMacro( "GRADIENT_WEIGHTED sampling requires an image metric." );
+        }
+      const InitialTransformType * fixedInitialTransform = this->GetFixedInitialTransform();
+      using FixedPixelType = typename FixedImageType::PixelType;
+      using FixedPixelTraits = DefaultConvertPixelTraits<FixedPixelType>;
+      const typename FixedImageType::RegionType & fixedRegion = fixedImage->GetBufferedRegion();
+      const typename FixedImageType::SpacingType & fixedSpacing = fixedImage->GetSpacing();
+
+      // Gradient magnitude of the fixed image at the virtual voxels, by
+      // central differences at the nearest fixed voxel. Voxels outside the
+      // fixed image or the mask get a negative weight and are not sampled.
+      std::vector<RealType> weights( virtualDomainRegion.GetNumberOfPixels() );
+      RealType sumOfGradientMagnitudes = 0.0;
+      SizeValueType numberOfSampledVoxels = 0;
+      SizeValueType voxel = 0;
+      ImageRegionConstIteratorWithIndex<VirtualImageType> It( virtualImage, virtualDomainRegion );
+      for( It.GoToBegin(); !It.IsAtEnd(); ++It, ++voxel )
+        {
+        weights[voxel] = -1.0;
+        SamplePointType point;
+        virtualImage->TransformIndexToPhysicalPoint( It.GetIndex(), point );
+        if( fixedMaskImage && !fixedMaskImage->IsInside( point ) )
+          {
+          continue;
+          }
+        typename InitialTransformType::InputPointType fixedPoint;
+        fixedPoint.CastFrom( point );
+        if( fixedInitialTransform )
           {
+          fixedPoint = fixedInitialTransform->TransformPoint( fixedPoint );
+          }
+        typename FixedImageType::IndexType fixedIndex;
+        if( !fixedImage->TransformPhysicalPointToIndex( fixedPoint, fixedIndex ) )
+          {
+          continue;
+          }
+        RealType squaredGradientMagnitude = 0.0;
+        for( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          typename FixedImageType::IndexType previousIndex = fixedIndex;
+          typename FixedImageType::IndexType nextIndex = fixedIndex;
+          if( previousIndex[d] > fixedRegion.GetIndex( d ) )
+            {
+            --previousIndex[d];
+            }
+          if( nextIndex[d] < fixedRegion.GetUpperIndex()[d] )
+            {
+            ++nextIndex[d];
+            }
+          if( previousIndex[d] == nextIndex[d] )
+            {
+            continue;
+            }
+          const FixedPixelType & previousValue = fixedImage->GetPixel( previousIndex );
+          const FixedPixelType & nextValue = fixedImage->GetPixel( nextIndex );
+          const RealType distance = ( nextIndex[d] - previousIndex[d] ) * fixedSpacing[d];
+          for( unsigned int c = 0; c < FixedPixelTraits::GetNumberOfComponents( previousValue ); c++ )
+            {
+            const RealType derivative = ( static_cast<RealType>( FixedPixelTraits::GetNthComponent( c, nextValue ) )
+              - static_cast<RealType>( FixedPixelTraits::GetNthComponent( c, previousValue ) ) ) / distance;
+            squaredGradientMagnitude += derivative * derivative;
+            }
+          }
+        weights[voxel] = std::sqrt( squaredGradientMagnitude );
+        sumOfGradientMagnitudes += weights[voxel];
+        ++numberOfSampledVoxels;
+        }
+      if( numberOfSampledVoxels == 0 )
+        {
+        break;
+        }
+
+      // A tenth of the mean gradient magnitude is added to all the weights
+      // so that homogeneous regions are still sampled.
+      const RealType weightOffset = ( sumOfGradientMagnitudes > 0.0 )
+        ? 0.1 * sumOfGradientMagnitudes / numberOfSampledVoxels : 1.0;
+      const RealType sumOfWeights = sumOfGradientMagnitudes + weightOffset * numberOfSampledVoxels;
+
+      // The sampling percentage applies to the voxels that can be sampled.
+      const auto sampleCount = static_cast<unsigned long>(
+       static_cast<float>( numberOfSampledVoxels ) * samplingPercentage );
+      if( sampleCount == 0 )
+        {
+        break;
+        }
+
+      // Systematic sampling: a voxel is selected once for each multiple of
+      // the step, shifted by a random fraction of it, within its weight.
+      const RealType step = sumOfWeights / sampleCount;
+      RealType nextSample = randomizer->GetVariateWithOpenUpperRange() * step;
+      RealType cumulativeWeight = 0.0;
+      voxel = 0;
+      for( It.GoToBegin(); !It.IsAtEnd(); ++It, ++voxel )
+        {
+        if( weights[voxel] < 0.0 )
+          {
+          continue;
+          }
+        cumulativeWeight += weights[voxel] + weightOffset;
+        while( nextSample < cumulativeWeight )
+          {
+          nextSample += step;
           SamplePointType point;
-          virtualImage->TransformIndexToPhysicalPoint( ItR.GetIndex(), point );
+          virtualImage->TransformIndexToPhysicalPoint( It.GetIndex(), point );
 
           // randomly perturb the point within a voxel (approximately)
-          for ( unsigned int d = 0; d < ImageDimension; d++ )
+          for( unsigned int d = 0; d < ImageDimension; d++ )
             {
             point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
             }
@@ -1022,27 +1364,16 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
             ++index;
             }
           }
-        break;
-        }
-      default:
-        {
-        itkExceptionMacro( "Invalid sampling strategy requested." );
         }
+      break;
       }
-
-    if( multiMetric )
-      {
-      dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->SetVirtualSampledPointSet( samplePointSet );
-      dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->UseSampledPointSetOn();
-      dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->UseVirtualSampledPointSetOn();
-      }
-    else
+    default:
       {
-      dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->SetVirtualSampledPointSet( samplePointSet );
-      dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->UseSampledPointSetOn();
-      dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->UseVirtualSampledPointSetOn();
+      itkExceptionMacro( "Invalid sampling strategy requested." );
       }
     }
+
+  return samplePointSet;
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
@@ -1125,6 +1456,133 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   return currentLevelVirtualDomainImage;
 }
 
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::VirtualImagePointer
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>
+::ShrinkVirtualDomainImage( const VirtualImageType * virtualDomainImage, const SizeValueType level ) const
+{
+  typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+  shrinkFilter->SetShrinkFactors( this->m_ShrinkFactorsPerLevel[level] );
+  shrinkFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  shrinkFilter->SetInput( virtualDomainImage );
+
+  VirtualImagePointer shrunkVirtualDomainImage = shrinkFilter->GetOutput();
+  shrunkVirtualDomainImage->Update();
+  shrunkVirtualDomainImage->DisconnectPipeline();
+
+  return shrunkVirtualDomainImage;
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::FixedImageConstPointer
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>
+::SmoothFixedImage( const SizeValueType n, const SizeValueType level ) const
+{
+  if( this->m_SmoothingSigmasPerLevel[level] <= 0 )
+    {
+    return this->GetFixedImage( n );
+    }
+
+  using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
+  typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
+  typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray( this->m_SmoothingSigmasPerLevel[level] );
+
+  if( !this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits  )
+    {
+    auto & fixedSpacing  = this->GetFixedImage( n )->GetSpacing();
+    for ( unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i )
+      {
+      fixedImageSigmaArray[i] *= fixedSpacing[i];
+      }
+    }
+  fixedImageSmoothingFilter->SetSigmaArray( fixedImageSigmaArray );
+  fixedImageSmoothingFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  fixedImageSmoothingFilter->SetInput( this->GetFixedImage( n ) );
+
+  FixedImagePointer fixedSmoothImage = fixedImageSmoothingFilter->GetOutput();
+  fixedImageSmoothingFilter->Update();
+  fixedSmoothImage->DisconnectPipeline();
+
+  return fixedSmoothImage.GetPointer();
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::FixedLevelImagesContainerType
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>
+::ComputeFixedLevelImages()
+{
+  if( !this->m_Metric )
+    {
+    itkExceptionMacro( "The metric is not present." );
+    }
+
+  // Find the image metrics as in InitializeRegistrationAtEachLevel()
+  typename MultiMetricType::Pointer multiMetric = dynamic_cast<MultiMetricType *>( this->m_Metric.GetPointer() );
+
+  std::vector<bool> isImageMetric;
+  if( this->m_Metric->GetMetricCategory() == MetricType::MULTI_METRIC )
+    {
+    for( SizeValueType n = 0; n < multiMetric->GetNumberOfMetrics(); n++ )
+      {
+      isImageMetric.push_back( multiMetric->GetMetricQueue()[n]->GetMetricCategory() == MetricType::IMAGE_METRIC );
+      }
+    }
+  else
+    {
+    isImageMetric.push_back( this->m_Metric->GetMetricCategory() == MetricType::IMAGE_METRIC );
+    }
+
+  VirtualImageBaseConstPointer virtualDomainBaseImage = this->GetCurrentLevelVirtualDomainImage();
+  for( SizeValueType n = 0; n < isImageMetric.size() && virtualDomainBaseImage.IsNull(); n++ )
+    {
+    if( isImageMetric[n] )
+      {
+      virtualDomainBaseImage = this->GetFixedImage( n );
+      }
+    }
+  if( virtualDomainBaseImage.IsNull() )
+    {
+    itkExceptionMacro( "A virtual domain image is not found.  It should be specified in one of the metrics." );
+    }
+
+  VirtualImagePointer virtualDomainImage = VirtualImageType::New();
+  virtualDomainImage->CopyInformation( virtualDomainBaseImage );
+  virtualDomainImage->SetRegions( virtualDomainBaseImage->GetLargestPossibleRegion() );
+  virtualDomainImage->Allocate();
+
+  FixedLevelImagesContainerType fixedLevelImages( this->m_NumberOfLevels );
+  for( SizeValueType level = 0; level < this->m_NumberOfLevels; level++ )
+    {
+    fixedLevelImages[level].VirtualDomainImage = this->ShrinkVirtualDomainImage( virtualDomainImage, level );
+    fixedLevelImages[level].FixedSmoothImages.resize( isImageMetric.size() );
+    for( SizeValueType n = 0; n < isImageMetric.size(); n++ )
+      {
+      if( isImageMetric[n] )
+        {
+        fixedLevelImages[level].FixedSmoothImages[n] = this->SmoothFixedImage( n, level );
+        }
+      }
+    }
+  return fixedLevelImages;
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>
+::SetSharedFixedLevelImages( const FixedLevelImagesContainerType & fixedLevelImages )
+{
+  this->m_SharedFixedLevelImages = fixedLevelImages;
+  this->Modified();
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+const typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::FixedLevelImagesContainerType &
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>
+::GetSharedFixedLevelImages() const
+{
+  return this->m_SharedFixedLevelImages;
+}
+
 /*
  * PrintSelf
  */
@@ -1172,6 +1630,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   os << indent << "RandomSeed: " << m_RandomSeed << std::endl;
   os << indent << "CurrentRandomSeed: " << m_CurrentRandomSeed << std::endl;
 
+  os << indent << "NumberOfSharedFixedLevelImages: " << this->m_SharedFixedLevelImages.size() << std::endl;
   os << indent << "InPlace: " << ( this->m_InPlace ? "On" : "Off" ) << std::endl;
 
   os << indent << "InitializeCenterOfLinearOutputTransform: "
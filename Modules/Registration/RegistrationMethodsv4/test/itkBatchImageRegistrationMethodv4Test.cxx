@@ -0,0 +1,254 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkBatchImageRegistrationMethodv4.h"
+#include "itkImageRegistrationMethodv4.h"
+#include "itkImageMaskSpatialObject.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegistrationMethodv4TestImage.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkTestingMacros.h"
+#include "itkTranslationTransform.h"
+
+/*
+ * Register several moving images to the same fixed image with
+ * BatchImageRegistrationMethodv4 and compare the results with those of
+ * the same registrations run one after the other.  Also check the shared
+ * fixed level images, the verification of the level settings and that a
+ * failing registration does not stop the others.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using PixelType = double;
+using ImageType = itk::Image<PixelType, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+using BatchRegistrationType = itk::BatchImageRegistrationMethodv4<RegistrationType>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using MaskType = itk::ImageMaskSpatialObject<Dimension>;
+
+constexpr unsigned int NumberOfMovingImages = 6;
+const double Shifts[NumberOfMovingImages][Dimension] =
+  { { 3.0, -2.0 }, { -2.5, 1.0 }, { 1.5, 2.5 }, { -3.0, -1.5 }, { 0.5, -3.0 }, { 2.0, 2.0 } };
+
+class ThrowingCommand : public itk::Command
+{
+public:
+  using Self = ThrowingCommand;
+  using Superclass = itk::Command;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro( Self );
+
+  void Execute( itk::Object *caller, const itk::EventObject & event ) override
+    {
+    Execute( (const itk::Object *) caller, event );
+    }
+
+  void Execute( const itk::Object *, const itk::EventObject & ) override
+    {
+    itkGenericExceptionMacro( "Registration aborted by the test." );
+    }
+
+protected:
+  ThrowingCommand() = default;
+};
+
+RegistrationType::Pointer
+CreateRegistration( const ImageType * fixedImage, const ImageType * movingImage, MaskType * mask )
+{
+  MetricType::Pointer metric = MetricType::New();
+  metric->SetFixedImageMask( mask );
+
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetMetric( metric );
+  registration->SetNumberOfLevels( 2 );
+
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors;
+  shrinkFactors.SetSize( 2 );
+  shrinkFactors[0] = 2;
+  shrinkFactors[1] = 1;
+  registration->SetShrinkFactorsPerLevel( shrinkFactors );
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas;
+  smoothingSigmas.SetSize( 2 );
+  smoothingSigmas[0] = 1.0;
+  smoothingSigmas[1] = 0.5;
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmas );
+  registration->SetSmoothingSigmasAreSpecifiedInPhysicalUnits( false );
+
+  itk::GradientDescentOptimizerv4::Pointer optimizer = itk::GradientDescentOptimizerv4::New();
+  optimizer->SetNumberOfIterations( 100 );
+  optimizer->SetLearningRate( 0.02 );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+  optimizer->SetDoEstimateLearningRateAtEachIteration( false );
+  registration->SetOptimizer( optimizer );
+
+  return registration;
+}
+}
+
+int itkBatchImageRegistrationMethodv4Test( int, char *[] )
+{
+  ImageType::Pointer fixedImage = CreateBlobImage<ImageType>( 30.0, 32.0 );
+
+  std::vector<ImageType::Pointer> movingImages;
+  for( const auto & shift : Shifts )
+    {
+    movingImages.push_back( CreateBlobImage<ImageType>( 30.0 + shift[0], 32.0 + shift[1] ) );
+    }
+
+  // Only the voxels with x < 48 are inside the mask, which is shared by all
+  // the metrics.
+  MaskType::ImageType::Pointer maskImage = MaskType::ImageType::New();
+  maskImage->CopyInformation( fixedImage );
+  maskImage->SetRegions( fixedImage->GetLargestPossibleRegion() );
+  maskImage->Allocate();
+  itk::ImageRegionIteratorWithIndex<MaskType::ImageType> It( maskImage, maskImage->GetLargestPossibleRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    It.Set( It.GetIndex()[0] < 48 ? 1 : 0 );
+    }
+  MaskType::Pointer mask = MaskType::New();
+  mask->SetImage( maskImage );
+
+  // Reference: the registrations run one after the other.
+  std::vector<TransformType::ParametersType> expectedParameters;
+  for( const auto & movingImage : movingImages )
+    {
+    RegistrationType::Pointer registration = CreateRegistration( fixedImage, movingImage, mask );
+    try
+      {
+      registration->Update();
+      }
+    catch( itk::ExceptionObject & e )
+      {
+      std::cerr << "Exception caught: " << e << std::endl;
+      return EXIT_FAILURE;
+      }
+    expectedParameters.push_back( registration->GetOutput()->Get()->GetParameters() );
+    }
+
+  BatchRegistrationType::Pointer batch = BatchRegistrationType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( batch, BatchImageRegistrationMethodv4, Object );
+  for( const auto & movingImage : movingImages )
+    {
+    batch->AddRegistration( CreateRegistration( fixedImage, movingImage, mask ) );
+    }
+  batch->SetNumberOfConcurrentRegistrations( 3 );
+  TEST_SET_GET_VALUE( 3, batch->GetNumberOfConcurrentRegistrations() );
+  TEST_SET_GET_VALUE( NumberOfMovingImages, batch->GetNumberOfRegistrations() );
+  TRY_EXPECT_NO_EXCEPTION( batch->Update() );
+
+  int result = EXIT_SUCCESS;
+
+  const BatchRegistrationType::FixedLevelImagesContainerType & sharedImages = batch->GetSharedFixedLevelImages();
+  if( sharedImages.size() != 2 ||
+      sharedImages[0].VirtualDomainImage->GetLargestPossibleRegion().GetSize()[0] != 32 ||
+      sharedImages[1].VirtualDomainImage->GetLargestPossibleRegion().GetSize()[0] != 64 ||
+      sharedImages[0].FixedSmoothImages.size() != 1 ||
+      sharedImages[0].FixedSmoothImages[0]->GetPixelContainer() == fixedImage->GetPixelContainer() ||
+      sharedImages[1].FixedSmoothImages[0]->GetPixelContainer() == fixedImage->GetPixelContainer() )
+    {
+    std::cerr << "Unexpected shared fixed level images." << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  for( unsigned int i = 0; i < NumberOfMovingImages; i++ )
+    {
+    const TransformType::ParametersType parameters = batch->GetRegistration( i )->GetOutput()->Get()->GetParameters();
+    std::cout << "Registration " << i << ": " << parameters << " (sequential " << expectedParameters[i] << ")" << std::endl;
+    for( unsigned int d = 0; d < Dimension; d++ )
+      {
+      if( std::fabs( parameters[d] - expectedParameters[i][d] ) > 1e-6 )
+        {
+        std::cerr << "Registration " << i << " differs from the sequential registration." << std::endl;
+        result = EXIT_FAILURE;
+        }
+      if( std::fabs( parameters[d] - Shifts[i][d] ) > 0.25 )
+        {
+        std::cerr << "Registration " << i << " did not recover the translation." << std::endl;
+        result = EXIT_FAILURE;
+        }
+      }
+    const auto * metric = dynamic_cast<const MetricType *>( batch->GetRegistration( i )->GetMetric() );
+    if( metric->GetFixedImage()->GetPixelContainer() != sharedImages[1].FixedSmoothImages[0]->GetPixelContainer() )
+      {
+      std::cerr << "Registration " << i << " does not use the shared fixed level images." << std::endl;
+      result = EXIT_FAILURE;
+      }
+    if( batch->GetRegistrationFailed( i ) )
+      {
+      std::cerr << "Registration " << i << " is reported as failed." << std::endl;
+      result = EXIT_FAILURE;
+      }
+
+    // The batch hands the registrations back as they were.
+    const RegistrationType * registration = batch->GetRegistration( i );
+    if( registration->GetFixedImage() != fixedImage.GetPointer() ||
+        !registration->GetSharedFixedLevelImages().empty() ||
+        registration->GetNumberOfWorkUnits() != itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() ||
+        registration->GetOptimizer()->GetNumberOfWorkUnits() != itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() ||
+        metric->GetMaximumNumberOfWorkUnits() != MetricType::New()->GetMaximumNumberOfWorkUnits() )
+      {
+      std::cerr << "Registration " << i << " was not restored after the batch." << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+
+  // A failing registration is reported once the others are done.
+  BatchRegistrationType::Pointer failingBatch = BatchRegistrationType::New();
+  for( const auto & movingImage : movingImages )
+    {
+    failingBatch->AddRegistration( CreateRegistration( fixedImage, movingImage, mask ) );
+    }
+  failingBatch->GetRegistration( 1 )->GetOptimizer()->AddObserver( itk::IterationEvent(), ThrowingCommand::New() );
+  TRY_EXPECT_EXCEPTION( failingBatch->Update() );
+  for( unsigned int i = 0; i < NumberOfMovingImages; i++ )
+    {
+    const TransformType::ParametersType parameters = failingBatch->GetRegistration( i )->GetOutput()->Get()->GetParameters();
+    if( failingBatch->GetRegistrationFailed( i ) != ( i == 1 ) ||
+        ( i != 1 && std::fabs( parameters[0] - expectedParameters[i][0] ) > 1e-6 ) )
+      {
+      std::cerr << "Unexpected state of registration " << i << " in the failing batch." << std::endl;
+      result = EXIT_FAILURE;
+      }
+    if( failingBatch->GetRegistration( i )->GetFixedImage() != fixedImage.GetPointer() ||
+        !failingBatch->GetRegistration( i )->GetSharedFixedLevelImages().empty() )
+      {
+      std::cerr << "Registration " << i << " of the failing batch was not restored." << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+
+  // Registrations with different level settings cannot share the fixed
+  // level images.
+  BatchRegistrationType::Pointer mismatchedBatch = BatchRegistrationType::New();
+  mismatchedBatch->AddRegistration( CreateRegistration( fixedImage, movingImages[0], mask ) );
+  RegistrationType::Pointer mismatchedRegistration = CreateRegistration( fixedImage, movingImages[1], mask );
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors;
+  shrinkFactors.SetSize( 2 );
+  shrinkFactors.Fill( 1 );
+  mismatchedRegistration->SetShrinkFactorsPerLevel( shrinkFactors );
+  mismatchedBatch->AddRegistration( mismatchedRegistration );
+  TRY_EXPECT_EXCEPTION( mismatchedBatch->Update() );
+  mismatchedBatch->ShareFixedLevelImagesOff();
+  TRY_EXPECT_NO_EXCEPTION( mismatchedBatch->Update() );
+
+  return result;
+}
@@ -0,0 +1,50 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkImageRegistrationMethodv4TestImage_h
+#define itkImageRegistrationMethodv4TestImage_h
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+
+/*
+ * 64x64 test image of the registration methods: a Gaussian blob with a
+ * standard deviation of 8 pixels, centered on ( centerX, centerY ).
+ */
+template< typename TImage >
+typename TImage::Pointer
+CreateBlobImage( double centerX, double centerY )
+{
+  typename TImage::RegionType region;
+  region.SetSize( 0, 64 );
+  region.SetSize( 1, 64 );
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<TImage> It( image, region );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const double dx = It.GetIndex()[0] - centerX;
+    const double dy = It.GetIndex()[1] - centerY;
+    It.Set( 100.0 * std::exp( -( dx * dx + dy * dy ) / ( 2.0 * 8.0 * 8.0 ) ) );
+    }
+  return image;
+}
+
+#endif
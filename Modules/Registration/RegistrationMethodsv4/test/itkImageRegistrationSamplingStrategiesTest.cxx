@@ -0,0 +1,221 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkImageMaskSpatialObject.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegistrationMethodv4TestImage.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkTranslationTransform.h"
+
+/*
+ * Test the STRATIFIED, HALTON and GRADIENT_WEIGHTED metric sampling
+ * strategies: the number of samples, the fixed image mask, the reuse of
+ * the sample points by levels with identical settings and the recovery
+ * of a known translation.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using PixelType = double;
+using ImageType = itk::Image<PixelType, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using MaskType = itk::ImageMaskSpatialObject<Dimension>;
+
+class SamplePointSetObserver : public itk::Command
+{
+public:
+  using Self = SamplePointSetObserver;
+  using Superclass = itk::Command;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro( Self );
+
+  void Execute( itk::Object *caller, const itk::EventObject & event ) override
+    {
+    Execute( (const itk::Object *) caller, event );
+    }
+
+  void Execute( const itk::Object * object, const itk::EventObject & event ) override
+    {
+    if( typeid( event ) != typeid( itk::MultiResolutionIterationEvent ) )
+      {
+      return;
+      }
+    // The sample points of the previous level are still set on the metric.
+    const auto * registration = static_cast<const RegistrationType *>( object );
+    const auto * metric = dynamic_cast<const MetricType *>( registration->GetMetric() );
+    m_PreviousLevelPointSets.push_back( metric->GetVirtualSampledPointSet() );
+    }
+
+  std::vector<MetricType::VirtualPointSetType::ConstPointer> m_PreviousLevelPointSets;
+
+protected:
+  SamplePointSetObserver() = default;
+};
+
+int
+RunSamplingStrategy( RegistrationType::MetricSamplingStrategyType strategy, unsigned int coarseShrinkFactor )
+{
+  constexpr double samplingPercentage = 0.2;
+
+  ImageType::Pointer fixedImage = CreateBlobImage<ImageType>( 30.0, 32.0 );
+  ImageType::Pointer movingImage = CreateBlobImage<ImageType>( 33.0, 30.0 );
+
+  // Only the voxels with x < 48 are inside the mask.
+  MaskType::ImageType::Pointer maskImage = MaskType::ImageType::New();
+  maskImage->CopyInformation( fixedImage );
+  maskImage->SetRegions( fixedImage->GetLargestPossibleRegion() );
+  maskImage->Allocate();
+  itk::SizeValueType numberOfMaskVoxels = 0;
+  itk::ImageRegionIteratorWithIndex<MaskType::ImageType> It( maskImage, maskImage->GetLargestPossibleRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const bool inside = It.GetIndex()[0] < 48;
+    It.Set( inside ? 1 : 0 );
+    numberOfMaskVoxels += inside ? 1 : 0;
+    }
+  MaskType::Pointer mask = MaskType::New();
+  mask->SetImage( maskImage );
+
+  MetricType::Pointer metric = MetricType::New();
+  metric->SetFixedImageMask( mask );
+
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetMetric( metric );
+  registration->SetMetricSamplingStrategy( strategy );
+  registration->SetNumberOfLevels( 2 );
+  registration->SetMetricSamplingPercentage( samplingPercentage );
+  registration->MetricSamplingReinitializeSeed( 1234 );
+
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors;
+  shrinkFactors.SetSize( 2 );
+  shrinkFactors[0] = coarseShrinkFactor;
+  shrinkFactors[1] = 1;
+  registration->SetShrinkFactorsPerLevel( shrinkFactors );
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas;
+  smoothingSigmas.SetSize( 2 );
+  smoothingSigmas.Fill( 0.0 );
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmas );
+
+  itk::GradientDescentOptimizerv4::Pointer optimizer = itk::GradientDescentOptimizerv4::New();
+  optimizer->SetNumberOfIterations( 100 );
+  optimizer->SetLearningRate( 0.02 );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+  optimizer->SetDoEstimateLearningRateAtEachIteration( false );
+  registration->SetOptimizer( optimizer );
+
+  SamplePointSetObserver::Pointer observer = SamplePointSetObserver::New();
+  registration->AddObserver( itk::MultiResolutionIterationEvent(), observer );
+
+  try
+    {
+    registration->Update();
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cerr << "Exception caught: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const MetricType::VirtualPointSetType * pointSet = metric->GetVirtualSampledPointSet();
+  const itk::SizeValueType numberOfPoints = pointSet->GetNumberOfPoints();
+  const double expectedNumberOfPoints = samplingPercentage * numberOfMaskVoxels;
+  std::cout << "Strategy " << strategy << ": " << numberOfPoints << " sample points (expected about "
+            << expectedNumberOfPoints << ")" << std::endl;
+  if( numberOfPoints < 0.75 * expectedNumberOfPoints || numberOfPoints > 1.1 * expectedNumberOfPoints )
+    {
+    std::cerr << "Unexpected number of sample points: " << numberOfPoints << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for( auto it = pointSet->GetPoints()->Begin(); it != pointSet->GetPoints()->End(); ++it )
+    {
+    MaskType::PointType point;
+    point.CastFrom( it.Value() );
+    if( !mask->IsInside( point ) )
+      {
+      std::cerr << "Sample point " << point << " is outside of the fixed image mask." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The STRATIFIED and HALTON sample points of the first level are carried
+  // over to the second one.
+  if( observer->m_PreviousLevelPointSets.size() != 2 )
+    {
+    std::cerr << "Expected two multi-resolution iteration events." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( strategy == RegistrationType::STRATIFIED || strategy == RegistrationType::HALTON )
+    {
+    const MetricType::VirtualPointSetType * firstLevelPointSet = observer->m_PreviousLevelPointSets[1];
+    for( auto it = firstLevelPointSet->GetPoints()->Begin(); it != firstLevelPointSet->GetPoints()->End(); ++it )
+      {
+      bool found = false;
+      for( auto jt = pointSet->GetPoints()->Begin(); jt != pointSet->GetPoints()->End() && !found; ++jt )
+        {
+        found = ( it.Value().EuclideanDistanceTo( jt.Value() ) < 1e-9 );
+        }
+      if( !found )
+        {
+        std::cerr << "Sample point " << it.Value() << " of the first level is not used by the second one." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    if( coarseShrinkFactor == 1 && firstLevelPointSet->GetNumberOfPoints() != numberOfPoints )
+      {
+      std::cerr << "Levels sampled in the same way do not use the same sample points." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  const TransformType::ParametersType parameters = registration->GetOutput()->Get()->GetParameters();
+  std::cout << "  translation: " << parameters << std::endl;
+  if( std::fabs( parameters[0] - 3.0 ) > 0.25 || std::fabs( parameters[1] + 2.0 ) > 0.25 )
+    {
+    std::cerr << "The translation (3, -2) was not recovered." << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkImageRegistrationSamplingStrategiesTest( int, char *[] )
+{
+  int result = EXIT_SUCCESS;
+
+  const RegistrationType::MetricSamplingStrategyType strategies[] =
+    { RegistrationType::STRATIFIED, RegistrationType::HALTON, RegistrationType::GRADIENT_WEIGHTED };
+  for( auto strategy : strategies )
+    {
+    if( RunSamplingStrategy( strategy, 1 ) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+    if( RunSamplingStrategy( strategy, 2 ) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+    }
+
+  return result;
+}
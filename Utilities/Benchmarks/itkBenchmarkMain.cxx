@@ -0,0 +1,47 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkVersion.h"
+#include "itkMultiThreaderBase.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+/** Shared entry point of the benchmark executables. The ITK configuration is
+ * added to the context block so that results written with
+ * --benchmark_out=<file> --benchmark_out_format=json can be compared
+ * between builds and releases. */
+int main( int argc, char * argv[] )
+{
+  ::benchmark::Initialize( &argc, argv );
+  if ( ::benchmark::ReportUnrecognizedArguments( argc, argv ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  ::benchmark::AddCustomContext( "itk_version", itk::Version::GetITKVersion() );
+  ::benchmark::AddCustomContext( "itk_multithreader",
+    itk::MultiThreaderBase::ThreaderTypeToString( itk::MultiThreaderBase::GetGlobalDefaultThreader() ) );
+  ::benchmark::AddCustomContext( "itk_default_number_of_threads",
+    std::to_string( itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() ) );
+
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return EXIT_SUCCESS;
+}
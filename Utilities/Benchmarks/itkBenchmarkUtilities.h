@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBenchmarkUtilities_h
+#define itkBenchmarkUtilities_h
+
+#include "itkImage.h"
+#include "itkImageBufferRange.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMultiThreaderBase.h"
+#include "itkProcessObject.h"
+
+#include <benchmark/benchmark.h>
+
+namespace itk
+{
+namespace Benchmark
+{
+/** Image sizes, in pixels along each axis, used by the benchmarks. */
+constexpr int SmallImageSize = 32;
+constexpr int MediumImageSize = 96;
+constexpr int LargeImageSize = 192;
+
+/** Create a cubic image of the given size filled with reproducible uniform
+ * noise in [minimum, maximum]. */
+template< typename TImage >
+typename TImage::Pointer
+MakeRandomImage( SizeValueType size, double minimum = 0.0, double maximum = 255.0 )
+{
+  typename TImage::SizeType imageSize;
+  imageSize.Fill( size );
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( imageSize );
+  image->Allocate();
+
+  using GeneratorType = Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+  for ( auto & pixel : Experimental::MakeImageBufferRange( image.GetPointer() ) )
+    {
+    pixel = static_cast< typename TImage::PixelType >( generator->GetUniformVariate( minimum, maximum ) );
+    }
+  return image;
+}
+
+/** Restrict a filter to the given number of threads, with one work unit per
+ * thread. */
+inline void
+SetNumberOfThreads( ProcessObject * filter, ThreadIdType numberOfThreads )
+{
+  filter->GetMultiThreader()->SetMaximumNumberOfThreads( numberOfThreads );
+  filter->SetNumberOfWorkUnits( numberOfThreads );
+}
+
+/** Report the throughput of a benchmark: items_per_second is the number of
+ * voxels processed per second and bytes_per_second counts every byte read
+ * and written per voxel. */
+inline void
+SetThroughputCounters( ::benchmark::State & state, SizeValueType numberOfPixels, SizeValueType bytesPerPixel )
+{
+  const auto iterations = static_cast< int64_t >( state.iterations() );
+  state.SetItemsProcessed( iterations * static_cast< int64_t >( numberOfPixels ) );
+  state.SetBytesProcessed( iterations * static_cast< int64_t >( numberOfPixels * bytesPerPixel ) );
+}
+
+/** Arguments of the form {image size, number of threads} over the standard
+ * image sizes and 1, 2, 4 ... up to the number of available threads. */
+inline void
+ImageSizeAndThreadArguments( ::benchmark::internal::Benchmark * benchmark )
+{
+  const int maximumNumberOfThreads =
+    static_cast< int >( MultiThreaderBase::GetGlobalDefaultNumberOfThreads() );
+  for ( int size : { SmallImageSize, MediumImageSize, LargeImageSize } )
+    {
+    for ( int threads = 1; threads < maximumNumberOfThreads; threads *= 2 )
+      {
+      benchmark->Args( { size, threads } );
+      }
+    benchmark->Args( { size, maximumNumberOfThreads } );
+    }
+  benchmark->ArgNames( { "size", "threads" } );
+  benchmark->UseRealTime();
+  benchmark->Unit( ::benchmark::kMillisecond );
+}
+
+} // end namespace Benchmark
+} // end namespace itk
+
+#endif
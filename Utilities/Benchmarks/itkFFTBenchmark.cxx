@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBenchmarkUtilities.h"
+#include "itkNativeComplexToComplexFFTImageFilter.h"
+#include "itkNativeForwardFFTImageFilter.h"
+#include "itkNativeRealToHalfHermitianForwardFFTImageFilter.h"
+#include "itkVnlComplexToComplexFFTImageFilter.h"
+#include "itkVnlForwardFFTImageFilter.h"
+#include "itkVnlRealToHalfHermitianForwardFFTImageFilter.h"
+
+// Native against Vnl Fourier transforms over {image size, number of
+// threads}. The standard image sizes only have 2 and 3 as prime factors,
+// as Vnl requires; the *PrimeSize benchmarks transform images one pixel
+// larger, which only the Native filters support. The bytes per pixel count
+// one real input read and one complex output write.
+
+namespace
+{
+using PixelType = float;
+using ImageType = itk::Image< PixelType, 3 >;
+using ComplexImageType = itk::Image< std::complex< PixelType >, 3 >;
+
+template< typename TFilter >
+void
+RunFFT( ::benchmark::State & state, const typename TFilter::InputImageType * input )
+{
+  typename TFilter::Pointer filter = TFilter::New();
+  itk::Benchmark::SetNumberOfThreads( filter, static_cast< itk::ThreadIdType >( state.range( 1 ) ) );
+  filter->SetInput( input );
+  for ( auto _ : state )
+    {
+    filter->Modified();
+    filter->Update();
+    }
+  itk::Benchmark::SetThroughputCounters( state, input->GetBufferedRegion().GetNumberOfPixels(),
+                                         sizeof( PixelType ) + sizeof( std::complex< PixelType > ) );
+}
+
+template< typename TFilter >
+void
+BM_ForwardFFT( ::benchmark::State & state )
+{
+  const ImageType::Pointer input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+  RunFFT< TFilter >( state, input );
+}
+BENCHMARK_TEMPLATE( BM_ForwardFFT, itk::VnlForwardFFTImageFilter< ImageType, ComplexImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ForwardFFT, itk::NativeForwardFFTImageFilter< ImageType, ComplexImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ForwardFFT, itk::VnlRealToHalfHermitianForwardFFTImageFilter< ImageType, ComplexImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ForwardFFT, itk::NativeRealToHalfHermitianForwardFFTImageFilter< ImageType, ComplexImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+template< typename TFilter >
+void
+BM_ComplexToComplexFFT( ::benchmark::State & state )
+{
+  const ComplexImageType::Pointer input = itk::Benchmark::MakeRandomImage< ComplexImageType >( state.range( 0 ) );
+  RunFFT< TFilter >( state, input );
+}
+BENCHMARK_TEMPLATE( BM_ComplexToComplexFFT, itk::VnlComplexToComplexFFTImageFilter< ComplexImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ComplexToComplexFFT, itk::NativeComplexToComplexFFTImageFilter< ComplexImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+void
+BM_NativeForwardFFTPrimeSize( ::benchmark::State & state )
+{
+  const ImageType::Pointer input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) + 1 );
+  RunFFT< itk::NativeForwardFFTImageFilter< ImageType, ComplexImageType > >( state, input );
+}
+BENCHMARK( BM_NativeForwardFFTPrimeSize )->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+} // end namespace
@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBenchmarkUtilities.h"
+#include "itkBinaryBallStructuringElement.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkEuler3DTransform.h"
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkResampleImageFilter.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+
+// Whole-filter throughput over {image size, number of threads}. Each
+// iteration re-executes the filter on the same input; the bytes per pixel
+// count one input read and one output write.
+
+namespace
+{
+using PixelType = float;
+using ImageType = itk::Image< PixelType, 3 >;
+
+template< typename TFilter >
+void
+RunFilter( ::benchmark::State & state, TFilter * filter, const ImageType * input )
+{
+  itk::Benchmark::SetNumberOfThreads( filter, static_cast< itk::ThreadIdType >( state.range( 1 ) ) );
+  filter->SetInput( input );
+  for ( auto _ : state )
+    {
+    filter->Modified();
+    filter->Update();
+    }
+  itk::Benchmark::SetThroughputCounters( state, input->GetBufferedRegion().GetNumberOfPixels(),
+                                         2 * sizeof( PixelType ) );
+}
+
+template< typename TInterpolator >
+void
+BM_ResampleImageFilter( ::benchmark::State & state )
+{
+  const ImageType::Pointer input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+
+  using TransformType = itk::Euler3DTransform< double >;
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::InputPointType center;
+  center.Fill( 0.5 * state.range( 0 ) );
+  transform->SetCenter( center );
+  transform->SetRotation( 0.1, -0.05, 0.2 );
+
+  using FilterType = itk::ResampleImageFilter< ImageType, ImageType >;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetTransform( transform );
+  filter->SetInterpolator( TInterpolator::New() );
+  filter->SetOutputParametersFromImage( input );
+  RunFilter( state, filter.GetPointer(), input );
+}
+BENCHMARK_TEMPLATE( BM_ResampleImageFilter, itk::LinearInterpolateImageFunction< ImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ResampleImageFilter, itk::NearestNeighborInterpolateImageFunction< ImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+void
+BM_DiscreteGaussianImageFilter( ::benchmark::State & state )
+{
+  const ImageType::Pointer input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+
+  using FilterType = itk::DiscreteGaussianImageFilter< ImageType, ImageType >;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetVariance( 4.0 );
+  filter->SetMaximumKernelWidth( 32 );
+  RunFilter( state, filter.GetPointer(), input );
+}
+BENCHMARK( BM_DiscreteGaussianImageFilter )->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+void
+BM_SmoothingRecursiveGaussianImageFilter( ::benchmark::State & state )
+{
+  const ImageType::Pointer input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+
+  using FilterType = itk::SmoothingRecursiveGaussianImageFilter< ImageType, ImageType >;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetSigma( 2.0 );
+  RunFilter( state, filter.GetPointer(), input );
+}
+BENCHMARK( BM_SmoothingRecursiveGaussianImageFilter )->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+void
+BM_FFTConvolutionImageFilter( ::benchmark::State & state )
+{
+  const ImageType::Pointer input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+  const ImageType::Pointer kernel = itk::Benchmark::MakeRandomImage< ImageType >( 7, 0.0, 1.0 );
+
+  using FilterType = itk::FFTConvolutionImageFilter< ImageType, ImageType, ImageType >;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetKernelImage( kernel );
+  filter->NormalizeOn();
+  RunFilter( state, filter.GetPointer(), input );
+}
+BENCHMARK( BM_FFTConvolutionImageFilter )->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+void
+BM_GrayscaleDilateImageFilter( ::benchmark::State & state )
+{
+  const ImageType::Pointer input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+
+  using KernelType = itk::BinaryBallStructuringElement< PixelType, 3 >;
+  KernelType           ball;
+  KernelType::SizeType radius;
+  radius.Fill( 2 );
+  ball.SetRadius( radius );
+  ball.CreateStructuringElement();
+
+  using FilterType = itk::GrayscaleDilateImageFilter< ImageType, ImageType, KernelType >;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetKernel( ball );
+  RunFilter( state, filter.GetPointer(), input );
+}
+BENCHMARK( BM_GrayscaleDilateImageFilter )->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+} // end namespace
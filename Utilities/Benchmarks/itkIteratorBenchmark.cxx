@@ -0,0 +1,210 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBenchmarkUtilities.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageNeighborhoodOffsets.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
+#include "itkShapedImageNeighborhoodRange.h"
+
+// Single threaded pixel traversal. Each benchmark computes
+// output = input + 1 over the whole buffer, so the bytes per pixel are one
+// read and one write.
+
+namespace
+{
+using PixelType = float;
+using ImageType = itk::Image< PixelType, 3 >;
+
+void
+IteratorSizeArguments( ::benchmark::internal::Benchmark * benchmark )
+{
+  for ( int size : { itk::Benchmark::SmallImageSize, itk::Benchmark::MediumImageSize, itk::Benchmark::LargeImageSize } )
+    {
+    benchmark->Arg( size );
+    }
+  benchmark->ArgName( "size" );
+  benchmark->Unit( ::benchmark::kMillisecond );
+}
+
+struct IteratorImages
+{
+  explicit IteratorImages( const ::benchmark::State & state )
+  {
+    Input = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+    Output = ImageType::New();
+    Output->CopyInformation( Input );
+    Output->SetRegions( Input->GetLargestPossibleRegion() );
+    Output->Allocate();
+  }
+
+  ImageType::Pointer Input;
+  ImageType::Pointer Output;
+};
+
+void
+BM_ImageRegionIterator( ::benchmark::State & state )
+{
+  const IteratorImages images( state );
+  const ImageType::RegionType region = images.Input->GetBufferedRegion();
+  for ( auto _ : state )
+    {
+    itk::ImageRegionConstIterator< ImageType > inputIt( images.Input, region );
+    itk::ImageRegionIterator< ImageType >      outputIt( images.Output, region );
+    for ( ; !inputIt.IsAtEnd(); ++inputIt, ++outputIt )
+      {
+      outputIt.Set( inputIt.Get() + 1 );
+      }
+    ::benchmark::ClobberMemory();
+    }
+  itk::Benchmark::SetThroughputCounters( state, region.GetNumberOfPixels(), 2 * sizeof( PixelType ) );
+}
+BENCHMARK( BM_ImageRegionIterator )->Apply( IteratorSizeArguments );
+
+void
+BM_ImageRegionIteratorWithIndex( ::benchmark::State & state )
+{
+  const IteratorImages images( state );
+  const ImageType::RegionType region = images.Input->GetBufferedRegion();
+  for ( auto _ : state )
+    {
+    itk::ImageRegionConstIterator< ImageType > inputIt( images.Input, region );
+    itk::ImageRegionIteratorWithIndex< ImageType > outputIt( images.Output, region );
+    for ( ; !inputIt.IsAtEnd(); ++inputIt, ++outputIt )
+      {
+      outputIt.Set( inputIt.Get() + 1 );
+      }
+    ::benchmark::ClobberMemory();
+    }
+  itk::Benchmark::SetThroughputCounters( state, region.GetNumberOfPixels(), 2 * sizeof( PixelType ) );
+}
+BENCHMARK( BM_ImageRegionIteratorWithIndex )->Apply( IteratorSizeArguments );
+
+void
+BM_ImageScanlineIterator( ::benchmark::State & state )
+{
+  const IteratorImages images( state );
+  const ImageType::RegionType region = images.Input->GetBufferedRegion();
+  for ( auto _ : state )
+    {
+    itk::ImageScanlineConstIterator< ImageType > inputIt( images.Input, region );
+    itk::ImageScanlineIterator< ImageType >      outputIt( images.Output, region );
+    while ( !inputIt.IsAtEnd() )
+      {
+      while ( !inputIt.IsAtEndOfLine() )
+        {
+        outputIt.Set( inputIt.Get() + 1 );
+        ++inputIt;
+        ++outputIt;
+        }
+      inputIt.NextLine();
+      outputIt.NextLine();
+      }
+    ::benchmark::ClobberMemory();
+    }
+  itk::Benchmark::SetThroughputCounters( state, region.GetNumberOfPixels(), 2 * sizeof( PixelType ) );
+}
+BENCHMARK( BM_ImageScanlineIterator )->Apply( IteratorSizeArguments );
+
+void
+BM_ImageBufferRange( ::benchmark::State & state )
+{
+  const IteratorImages images( state );
+  for ( auto _ : state )
+    {
+    const auto inputRange = itk::Experimental::MakeImageBufferRange( images.Input.GetPointer() );
+    auto       outputRange = itk::Experimental::MakeImageBufferRange( images.Output.GetPointer() );
+    auto       outputIt = outputRange.begin();
+    for ( const PixelType pixel : inputRange )
+      {
+      *outputIt = pixel + 1;
+      ++outputIt;
+      }
+    ::benchmark::ClobberMemory();
+    }
+  itk::Benchmark::SetThroughputCounters( state, images.Input->GetBufferedRegion().GetNumberOfPixels(),
+                                         2 * sizeof( PixelType ) );
+}
+BENCHMARK( BM_ImageBufferRange )->Apply( IteratorSizeArguments );
+
+// Neighborhood traversal: output = mean of the 3x3x3 input neighborhood.
+// The bytes per pixel count the 27 neighborhood reads and one write.
+
+constexpr unsigned int NeighborhoodSize = 27;
+
+void
+BM_ConstNeighborhoodIterator( ::benchmark::State & state )
+{
+  const IteratorImages images( state );
+  const ImageType::RegionType region = images.Input->GetBufferedRegion();
+  itk::Size< 3 > radius;
+  radius.Fill( 1 );
+  for ( auto _ : state )
+    {
+    itk::ConstNeighborhoodIterator< ImageType > inputIt( radius, images.Input, region );
+    itk::ImageRegionIterator< ImageType >       outputIt( images.Output, region );
+    for ( ; !inputIt.IsAtEnd(); ++inputIt, ++outputIt )
+      {
+      PixelType sum = 0;
+      for ( unsigned int i = 0; i < NeighborhoodSize; ++i )
+        {
+        sum += inputIt.GetPixel( i );
+        }
+      outputIt.Set( sum / NeighborhoodSize );
+      }
+    ::benchmark::ClobberMemory();
+    }
+  itk::Benchmark::SetThroughputCounters( state, region.GetNumberOfPixels(),
+                                         ( NeighborhoodSize + 1 ) * sizeof( PixelType ) );
+}
+BENCHMARK( BM_ConstNeighborhoodIterator )->Apply( IteratorSizeArguments );
+
+void
+BM_ShapedImageNeighborhoodRange( ::benchmark::State & state )
+{
+  const IteratorImages images( state );
+  const ImageType::RegionType region = images.Input->GetBufferedRegion();
+  itk::Size< 3 > radius;
+  radius.Fill( 1 );
+  const std::vector< itk::Offset< 3 > > offsets = itk::Experimental::GenerateRectangularImageNeighborhoodOffsets( radius );
+  for ( auto _ : state )
+    {
+    itk::Experimental::ShapedImageNeighborhoodRange< const ImageType > neighborhood(
+      *images.Input, region.GetIndex(), offsets );
+    itk::ImageRegionIteratorWithIndex< ImageType > outputIt( images.Output, region );
+    for ( ; !outputIt.IsAtEnd(); ++outputIt )
+      {
+      neighborhood.SetLocation( outputIt.GetIndex() );
+      PixelType sum = 0;
+      for ( const PixelType pixel : neighborhood )
+        {
+        sum += pixel;
+        }
+      outputIt.Set( sum / NeighborhoodSize );
+      }
+    ::benchmark::ClobberMemory();
+    }
+  itk::Benchmark::SetThroughputCounters( state, region.GetNumberOfPixels(),
+                                         ( NeighborhoodSize + 1 ) * sizeof( PixelType ) );
+}
+BENCHMARK( BM_ShapedImageNeighborhoodRange )->Apply( IteratorSizeArguments );
+
+} // end namespace
@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAffineTransform.h"
+#include "itkBenchmarkUtilities.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkJointHistogramMutualInformationImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+
+// Dense GetValueAndDerivative() throughput of the v4 image metrics over
+// {image size, number of threads}, with an affine moving transform. The
+// items are virtual domain points and the bytes per point count one fixed
+// and one moving image read.
+
+namespace
+{
+using PixelType = float;
+using ImageType = itk::Image< PixelType, 3 >;
+
+template< typename TMetric >
+void
+BM_ImageToImageMetricv4( ::benchmark::State & state )
+{
+  const ImageType::Pointer fixedImage = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+  const ImageType::Pointer movingImage = itk::Benchmark::MakeRandomImage< ImageType >( state.range( 0 ) );
+
+  using TransformType = itk::AffineTransform< double, 3 >;
+  TransformType::Pointer transform = TransformType::New();
+  TransformType::OutputVectorType translation;
+  translation.Fill( 0.5 );
+  transform->Translate( translation );
+
+  typename TMetric::Pointer metric = TMetric::New();
+  metric->SetFixedImage( fixedImage );
+  metric->SetMovingImage( movingImage );
+  metric->SetMovingTransform( transform );
+  metric->SetMaximumNumberOfWorkUnits( static_cast< itk::ThreadIdType >( state.range( 1 ) ) );
+  metric->Initialize();
+
+  typename TMetric::MeasureType    value;
+  typename TMetric::DerivativeType derivative;
+  for ( auto _ : state )
+    {
+    metric->GetValueAndDerivative( value, derivative );
+    ::benchmark::DoNotOptimize( value );
+    }
+  itk::Benchmark::SetThroughputCounters( state, fixedImage->GetBufferedRegion().GetNumberOfPixels(),
+                                         2 * sizeof( PixelType ) );
+}
+
+BENCHMARK_TEMPLATE( BM_ImageToImageMetricv4, itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ImageToImageMetricv4, itk::CorrelationImageToImageMetricv4< ImageType, ImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ImageToImageMetricv4, itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+BENCHMARK_TEMPLATE( BM_ImageToImageMetricv4,
+                    itk::JointHistogramMutualInformationImageToImageMetricv4< ImageType, ImageType > )
+  ->Apply( itk::Benchmark::ImageSizeAndThreadArguments );
+
+} // end namespace
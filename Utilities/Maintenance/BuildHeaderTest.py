@@ -38,6 +38,7 @@ BANNED_HEADERS = set(('itkDynamicLoader.h', # This cannot be included when ITK_D
     'itkFFTWRealToHalfHermitianForwardFFTImageFilter.h',
     'itkFFTWHalfHermitianToRealInverseFFTImageFilter.h',
     'itkFFTWComplexToComplexFFTImageFilter.h',
+    'itkFFTWComplexToComplexBatchFFTImageFilter.h',
     'itkFFTWCommon.h',
     'itkPyBuffer.h', # needs Python.h, etc
     'itkPyVnl.h', # needs Python.h, etc